@@ -0,0 +1,185 @@
+#include "ast.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NLONG 3000
+#define NSET 100
+
+static int CheckC( AstObject *, const char *, const char *, const char * );
+static int CheckUnknown( AstObject *, const char * );
+
+int main(){
+   AstFrame *f1;
+   AstFrame *f2;
+   AstFrameSet *fs;
+   AstPlot *plot;
+   AstSkyFrame *sf;
+   char label[ 40 ];
+   char title[ NLONG + 1 ];
+   char unit[ 40 ];
+   float gbox[ 4 ] = { 0.0, 0.0, 1.0, 1.0 };
+   double bbox[ 4 ] = { 0.0, 0.0, 100.0, 100.0 };
+   int i;
+   int j;
+   int ok;
+   int pass;
+
+   ok = 1;
+   astBegin;
+
+/* Attribute settings that are longer than the internal buffers used by
+   astSet once any format specifiers have been replaced. */
+   f1 = astFrame( 2, " " );
+   for( i = 0; i < NLONG; i++ ) title[ i ] = 'a' + ( i % 26 );
+   title[ NLONG ] = 0;
+
+   astSet( f1, "Title=%s", title );
+   if( !CheckC( (AstObject *) f1, "Title", title, "long formatted Title" ) ) ok = 0;
+
+   title[ 1500 ] = 0;
+   astSet( f1, "Title=%s,Domain=%s,Label(2)=%d", title, "LONG", 2 );
+   if( !CheckC( (AstObject *) f1, "Title", title, "second long Title" ) ||
+       !CheckC( (AstObject *) f1, "Domain", "LONG", "Domain" ) ||
+       !CheckC( (AstObject *) f1, "Label(2)", "2", "Label(2)" ) ) ok = 0;
+
+/* Settings that are re-used are taken from a cache of parsed setting
+   strings. Use more distinct settings than the cache can hold, several
+   times over, and check each is applied correctly. Also use the same
+   setting string with different Objects. */
+   f2 = astFrame( 2, " " );
+   for( pass = 0; pass < 3 && ok; pass++ ) {
+      for( i = 0; i < NSET && ok; i++ ) {
+         sprintf( label, "Label %d", i );
+         sprintf( unit, "u%d", i % 7 );
+         astSet( f1, "Label(1)=%s, Unit(2)=%s", label, unit );
+         astSet( f2, "Label(1)=%s, Unit(2)=%s", label, unit );
+         if( !CheckC( (AstObject *) f1, "Label(1)", label, "cached Label" ) ||
+             !CheckC( (AstObject *) f1, "Unit(2)", unit, "cached Unit" ) ||
+             !CheckC( (AstObject *) f2, "Label(1)", label, "cached Label" ) ||
+             !CheckC( (AstObject *) f2, "Unit(2)", unit, "cached Unit" ) ) ok = 0;
+      }
+   }
+
+/* Cached settings with quoted commas and upper case names. */
+   for( j = 0; j < 3 && ok; j++ ) {
+      astSet( f1, "TITLE=\"a, b\", Domain = X%d", j );
+      astSet( f1, " Title=\"a, b\" " );
+      sprintf( label, "X%d", j );
+      if( !CheckC( (AstObject *) f1, "Title", "a, b", "quoted Title" ) ||
+          !CheckC( (AstObject *) f1, "Domain", label, "Domain" ) ) ok = 0;
+   }
+
+/* SkyFrame and Plot use a table of attribute names to decide whether to
+   pass an attribute on to the parent class. Check that attributes
+   defined by the class itself and by each ancestor class can be set,
+   tested, got and cleared, and that unknown attributes are rejected. */
+   if( ok ) {
+      sf = astSkyFrame( " " );
+      astSet( sf, "System=FK4,Equinox=1950,SkyRef(2)=0.5,AlignOffset=1,"
+              "Title=Sky,Label(1)=RA,Digits=9,ID=sky,Invert=0" );
+      if( !CheckC( (AstObject *) sf, "System", "FK4", "SkyFrame System" ) ||
+          !CheckC( (AstObject *) sf, "Equinox", "1950.0", "SkyFrame Equinox" ) ||
+          !CheckC( (AstObject *) sf, "AlignOffset", "1", "SkyFrame AlignOffset" ) ||
+          !CheckC( (AstObject *) sf, "Title", "Sky", "SkyFrame Title" ) ||
+          !CheckC( (AstObject *) sf, "Label(1)", "RA", "SkyFrame Label(1)" ) ||
+          !CheckC( (AstObject *) sf, "Digits", "9", "SkyFrame Digits" ) ||
+          !CheckC( (AstObject *) sf, "ID", "sky", "SkyFrame ID" ) ||
+          !CheckC( (AstObject *) sf, "Invert", "0", "SkyFrame Invert" ) ) {
+         ok = 0;
+      } else if( !astTest( sf, "SkyRef(2)" ) || !astTest( sf, "Digits" ) ||
+                 astTest( sf, "SkyRef(1)" ) || astTest( sf, "Domain" ) ) {
+         printf( "Wrong result from astTest for a SkyFrame\n" );
+         ok = 0;
+      } else {
+         astClear( sf, "SkyRef(2),Digits,Title" );
+         if( astTest( sf, "SkyRef(2)" ) || astTest( sf, "Digits" ) ||
+             astTest( sf, "Title" ) ) {
+            printf( "astClear failed for a SkyFrame\n" );
+            ok = 0;
+         } else if( !CheckUnknown( (AstObject *) sf, "Junk" ) ||
+                    !CheckUnknown( (AstObject *) sf, "Skyrefx(1)" ) ) {
+            ok = 0;
+         }
+      }
+   }
+
+   if( ok ) {
+      fs = astFrameSet( astFrame( 2, "Domain=GRAPHICS" ), " " );
+      astAddFrame( fs, AST__BASE, astUnitMap( 2, " " ), astFrame( 2, " " ) );
+      plot = astPlot( fs, gbox, bbox, " " );
+      astSet( plot, "Colour(border)=3,Width(axes)=2,Gap(1)=0.5,Title=P,"
+              "Tol=0.02" );
+      if( !CheckC( (AstObject *) plot, "Colour(border)", "3", "Plot Colour" ) ||
+          !CheckC( (AstObject *) plot, "Width(axes)", "2", "Plot Width" ) ||
+          !CheckC( (AstObject *) plot, "Gap(1)", "0.5", "Plot Gap(1)" ) ||
+          !CheckC( (AstObject *) plot, "Title", "P", "Plot Title" ) ||
+          !CheckC( (AstObject *) plot, "Tol", "0.02", "Plot Tol" ) ) {
+         ok = 0;
+      } else if( !astTest( plot, "Colour(border)" ) ||
+                 astTest( plot, "Colour(grid)" ) ) {
+         printf( "Wrong result from astTest for a Plot\n" );
+         ok = 0;
+      } else {
+         astClear( plot, "Colour(border),Tol" );
+         if( astTest( plot, "Colour(border)" ) || astTest( plot, "Tol" ) ) {
+            printf( "astClear failed for a Plot\n" );
+            ok = 0;
+         } else if( !CheckUnknown( (AstObject *) plot, "Junk" ) ||
+                    !CheckUnknown( (AstObject *) plot, "Tolx" ) ) {
+            ok = 0;
+         }
+      }
+   }
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All attribute tests passed\n");
+   } else {
+      printf("Attribute tests failed\n");
+   }
+}
+
+static int CheckC( AstObject *obj, const char *attrib, const char *value,
+                   const char *text ){
+   const char *cval;
+
+   if( !astOK ) return 0;
+
+   cval = astGetC( obj, attrib );
+   if( !cval || strcmp( cval, value ) ) {
+      printf( "%s: got '%.40s' (should be '%.40s')\n", text,
+              cval ? cval : "NULL", value );
+      return 0;
+   }
+
+   return astOK;
+}
+
+static int CheckUnknown( AstObject *obj, const char *attrib ){
+   int result;
+
+   if( !astOK ) return 0;
+
+/* Setting an unknown attribute should give an AST__BADAT error. */
+   astSet( obj, "%s=1", attrib );
+   result = ( astStatus == AST__BADAT );
+   astClearStatus;
+   if( !result ) {
+      printf( "Setting unknown %s attribute '%s' did not give "
+              "AST__BADAT\n", astGetC( obj, "Class" ), attrib );
+   }
+
+/* So should getting it. */
+   if( result ) {
+      astGetC( obj, attrib );
+      result = ( astStatus == AST__BADAT );
+      astClearStatus;
+      if( !result ) {
+         printf( "Getting unknown %s attribute '%s' did not give "
+                 "AST__BADAT\n", astGetC( obj, "Class" ), attrib );
+      }
+   }
+
+   return result;
+}
@@ -0,0 +1,221 @@
+#include "ast.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NOBJ 3
+#define NTRUNC 8
+
+static AstObject *ReadNative( const char * );
+static AstObject *MakeKeyMap( void );
+static AstObject *MakeTable( void );
+static int CheckObjects( AstChannel *, AstObject **, const char * );
+
+int main(){
+   AstChannel *ch;
+   AstObject *obj;
+   AstObject *objs[ NOBJ ];
+   char *data;
+   int i;
+   int ok;
+   size_t size0;
+   size_t size;
+   size_t trunc;
+
+   ok = 1;
+   astBegin;
+
+/* A FrameSet, a Table and a KeyMap. */
+   objs[ 0 ] = ReadNative( "tanSipWcs.txt" );
+   objs[ 1 ] = MakeTable();
+   objs[ 2 ] = MakeKeyMap();
+
+/* Write them all to a memory buffer using the binary encoding. */
+   ch = astChannel( NULL, NULL, "Binary=1" );
+   for( i = 0; i < NOBJ && astOK; i++ ) {
+      if( astWrite( ch, objs[ i ] ) != 1 ) {
+         printf( "Failed to write %s using Binary=1\n",
+                 astGetC( objs[ i ], "Class" ) );
+         ok = 0;
+      }
+   }
+   data = astGetBinaryOutput( ch, &size );
+   ch = astAnnul( ch );
+   if( ok && ( !data || !size ) ) {
+      printf( "No binary output returned\n" );
+      ok = 0;
+   }
+
+/* Read them back from the buffer and check they are equal to the
+   originals. */
+   if( ok ) {
+      ch = astChannel( NULL, NULL, " " );
+      astPutBinaryInput( ch, data, size );
+      if( !CheckObjects( ch, objs, "memory buffer" ) ) ok = 0;
+      ch = astAnnul( ch );
+   }
+
+/* Do the same using a binary file. */
+   if( ok ) {
+      ch = astChannel( NULL, NULL, "Binary=1,SinkFile=testbinary.dat" );
+      for( i = 0; i < NOBJ && astOK; i++ ) astWrite( ch, objs[ i ] );
+      ch = astAnnul( ch );
+      ch = astChannel( NULL, NULL, "SourceFile=testbinary.dat" );
+      if( !CheckObjects( ch, objs, "binary file" ) ) ok = 0;
+      ch = astAnnul( ch );
+      remove( "testbinary.dat" );
+   }
+
+/* Find the number of bytes used to hold the FrameSet. */
+   if( ok ) {
+      ch = astChannel( NULL, NULL, "Binary=1" );
+      astWrite( ch, objs[ 0 ] );
+      astFree( astGetBinaryOutput( ch, &size0 ) );
+      ch = astAnnul( ch );
+   }
+
+/* Reading a truncated buffer should report an error and return no
+   Object, whether the data end within the signature, within a record
+   header or within a record. */
+   for( i = 0; i < NTRUNC && ok; i++ ) {
+      trunc = ( i < 2 ) ? (size_t) ( 2 + i*7 ) : ( i*size0 )/NTRUNC + i;
+      ch = astChannel( NULL, NULL, " " );
+      astPutBinaryInput( ch, data, trunc );
+      obj = astRead( ch );
+      if( obj || astOK ) {
+         printf( "No error reading binary data truncated to %zu bytes (of "
+                 "%zu)\n", trunc, size0 );
+         ok = 0;
+      }
+      astClearStatus;
+      ch = astAnnul( ch );
+   }
+
+/* If the data end within the second Object, the first should still be
+   read successfully. */
+   if( ok ) {
+      ch = astChannel( NULL, NULL, " " );
+      astPutBinaryInput( ch, data, size0 + ( size - size0 )/4 );
+      obj = astRead( ch );
+      if( !obj || !astEqual( obj, objs[ 0 ] ) ) {
+         printf( "Failed to read FrameSet before truncated Table\n" );
+         ok = 0;
+      } else {
+         obj = astAnnul( obj );
+         obj = astRead( ch );
+         if( obj || astOK ) {
+            printf( "No error reading truncated Table\n" );
+            ok = 0;
+         }
+         astClearStatus;
+      }
+      ch = astAnnul( ch );
+   }
+
+   data = astFree( data );
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All binary Channel tests passed\n");
+   } else {
+      printf("Binary Channel tests failed\n");
+   }
+}
+
+static int CheckObjects( AstChannel *ch, AstObject **objs, const char *text ){
+   AstObject *obj;
+   int i;
+
+   if( !astOK ) return 0;
+
+   for( i = 0; i < NOBJ; i++ ) {
+      obj = astRead( ch );
+      if( !obj ) {
+         printf( "%s: failed to read %s\n", text,
+                 astGetC( objs[ i ], "Class" ) );
+         return 0;
+      } else if( !astEqual( obj, objs[ i ] ) ) {
+         printf( "%s: %s read back is different\n", text,
+                 astGetC( objs[ i ], "Class" ) );
+         return 0;
+      }
+      obj = astAnnul( obj );
+   }
+
+   return astOK;
+}
+
+static AstObject *MakeKeyMap( void ){
+   AstKeyMap *km;
+   AstKeyMap *sub;
+   double dvec[ 4 ] = { 0.1, -1.0E-300, 1.7976931348623157E308, 5.0E-324 };
+   int ivec[ 3 ] = { 1, -2, 2147483647 };
+   const char *cvec[ 2 ] = { "first string", "" };
+
+/* A KeyMap containing each data type, vectors, undefined values, and
+   a nested KeyMap and Object. */
+   km = astKeyMap( "SortBy=KeyUp" );
+   astMapPut0D( km, "Double", 0.1, "A comment" );
+   astMapPut0I( km, "Int", -123456, NULL );
+   astMapPut0S( km, "Short", 32767, NULL );
+   astMapPut0B( km, "Byte", 255, NULL );
+   astMapPut0F( km, "Float", 1.5E-7, NULL );
+   astMapPut0C( km, "String", "Text with \"quotes\", commas and\nnewlines",
+                NULL );
+   astMapPut1D( km, "DVec", 4, dvec, NULL );
+   astMapPut1I( km, "IVec", 3, ivec, NULL );
+   astMapPut1C( km, "CVec", 2, cvec, NULL );
+   astMapPutU( km, "Undef", NULL );
+
+   sub = astKeyMap( " " );
+   astMapPut0D( sub, "Inner", AST__BAD, NULL );
+   astMapPut0A( sub, "Frame", astFrame( 2, "Domain=INNER" ), NULL );
+   astMapPut0A( km, "Sub", sub, NULL );
+
+   return (AstObject *) km;
+}
+
+static AstObject *MakeTable( void ){
+   AstTable *table;
+   char key[ 20 ];
+   double dval[ 2 ];
+   int dims[ 1 ] = { 2 };
+   int i;
+
+/* A Table with numerical and string columns, a parameter and some
+   missing cells. */
+   table = astTable( " " );
+   astAddColumn( table, "X", AST__DOUBLETYPE, 0, NULL, "m" );
+   astAddColumn( table, "Pos", AST__DOUBLETYPE, 1, dims, "deg" );
+   astAddColumn( table, "Name", AST__STRINGTYPE, 0, NULL, " " );
+   astAddColumn( table, "N", AST__INTTYPE, 0, NULL, " " );
+   astAddParameter( table, "Epoch" );
+   astMapPut0D( table, "Epoch", 2000.0, NULL );
+
+   for( i = 1; i <= 20; i++ ) {
+      dval[ 0 ] = i*0.1;
+      dval[ 1 ] = -i*1.0E10;
+      sprintf( key, "X(%d)", i );
+      astMapPut0D( table, key, i*0.3, NULL );
+      sprintf( key, "Pos(%d)", i );
+      astMapPut1D( table, key, 2, dval, NULL );
+      if( i % 3 ) {
+         sprintf( key, "Name(%d)", i );
+         astMapPut0C( table, key, "Row name", NULL );
+      }
+      sprintf( key, "N(%d)", i );
+      astMapPut0I( table, key, i*i, NULL );
+   }
+
+   return (AstObject *) table;
+}
+
+static AstObject *ReadNative( const char *file ){
+   AstChannel *ch;
+   AstObject *result;
+
+   ch = astChannel( NULL, NULL, "SourceFile=%s", file );
+   result = astRead( ch );
+   ch = astAnnul( ch );
+   return result;
+}
@@ -0,0 +1,190 @@
+#include "ast.h"
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NPREC 4
+#define NRANDOM 20000
+
+static int Check( double, int );
+static int CheckValue( double );
+static void Expected( double, int, char * );
+
+int main(){
+   const double special[] = { 0.0, 0.1, 0.2, 0.3, 1.0/3.0, 2.0/3.0,
+                              3.141592653589793, 5.0E-324, 1.0E-320,
+                              2.2250738585072009E-308, DBL_MIN, DBL_MAX,
+                              DBL_EPSILON, 1.0E22, 1.0E23, 9007199254740993.0,
+                              123456789012345678.0, 1.0E16, 1.0E17,
+                              0.0001, 0.00001, 1.5, 100.0, 1.0E-5 };
+   char text[ 30 ];
+   double value;
+   int i;
+   int ok;
+   uint64_t bits;
+
+   ok = 1;
+   astBegin;
+
+/* Special values, including the smallest and largest subnormal and
+   normalised values. */
+   for( i = 0; i < (int) ( sizeof( special )/sizeof( double ) ) && ok; i++ ) {
+      if( !CheckValue( special[ i ] ) ) ok = 0;
+   }
+
+/* Each power of ten that can be represented, and its neighbours. */
+   for( i = -323; i <= 308 && ok; i++ ) {
+      sprintf( text, "1E%d", i );
+      value = strtod( text, NULL );
+      if( !CheckValue( value ) ||
+          !CheckValue( nextafter( value, 0.0 ) ) ||
+          !CheckValue( nextafter( value, HUGE_VAL ) ) ) ok = 0;
+   }
+
+/* Integers and powers of two. */
+   for( i = 0; i < 1000 && ok; i++ ) {
+      if( !CheckValue( (double) i ) || !CheckValue( ldexp( 1.0, i - 1074 ) ) ) {
+         ok = 0;
+      }
+   }
+
+/* Random bit patterns, which include subnormal values. */
+   bits = 12345;
+   for( i = 0; i < NRANDOM && ok; i++ ) {
+      bits = bits*6364136223846793005ULL + 1442695040888963407ULL;
+      memcpy( &value, &bits, sizeof( value ) );
+      if( !isnan( value ) && !CheckValue( value ) ) ok = 0;
+   }
+
+/* Infinite and NaN values should be formatted by "%g". */
+   if( ok && ( !Check( HUGE_VAL, 17 ) || !Check( -HUGE_VAL, 6 ) ||
+               !Check( nan( "" ), 17 ) ) ) ok = 0;
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All astDouble2Chr tests passed\n");
+   } else {
+      printf("astDouble2Chr tests failed\n");
+   }
+}
+
+static int Check( double value, int prec ){
+   char buf[ 40 ];
+   char expected[ 40 ];
+   double result;
+   int nc;
+
+   if( !astOK ) return 0;
+
+/* Format the value and compare it with the string found by searching for
+   the smallest number of significant digits that reads back exactly. */
+   nc = astDouble2Chr( value, prec, buf );
+   Expected( value, prec, expected );
+   if( strcmp( buf, expected ) || nc != (int) strlen( buf ) ) {
+      printf( "astDouble2Chr( %.17g, %d ) gave \"%s\" (should be \"%s\")\n",
+              value, prec, buf, expected );
+      return 0;
+   }
+
+/* With 17 digits, the string should always read back exactly, including
+   the sign of zero. */
+   if( prec >= 17 && !isnan( value ) ) {
+      result = astChr2Double( buf );
+      if( memcmp( &result, &value, sizeof( value ) ) ) {
+         printf( "astChr2Double( \"%s\" ) gave %.17g (should be %.17g)\n",
+                 buf, result, value );
+         return 0;
+      }
+   }
+
+   return astOK;
+}
+
+static int CheckValue( double value ){
+   int i;
+   const int precs[ NPREC ] = { 17, 15, 10, 6 };
+
+   for( i = 0; i < NPREC; i++ ) {
+      if( !Check( value, precs[ i ] ) || !Check( -value, precs[ i ] ) ) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+static void Expected( double value, int prec, char *buf ){
+   char digits[ 30 ];
+   char *p;
+   int i;
+   int j;
+   int ndig;
+   int xexp;
+   long long int mant;
+
+/* Infinite and NaN values are formatted by "%g". */
+   if( !isfinite( value ) ) {
+      sprintf( buf, "%.*g", prec, value );
+      return;
+   }
+
+/* Find the smallest number of significant digits that reads back
+   exactly. The correctly rounded value with that number of digits may
+   not read back, in which case one of its neighbours will. If no
+   number of digits up to the precision reads back, the value should be
+   formatted by "%g". */
+   mant = 0;
+   xexp = 0;
+   for( ndig = 1; ndig <= prec && value != 0.0; ndig++ ) {
+      sprintf( buf, "%.*e", ndig - 1, fabs( value ) );
+      xexp = atoi( strchr( buf, 'e' ) + 1 );
+      for( p = buf, mant = 0; *p != 'e'; p++ ) {
+         if( *p != '.' ) mant = 10*mant + ( *p - '0' );
+      }
+      for( j = 0; j < 3; j++ ) {
+         sprintf( digits, "%llde%d", mant + ( j ? 2*j - 3 : 0 ),
+                  xexp - ndig + 1 );
+         if( strtod( digits, NULL ) == fabs( value ) ) break;
+      }
+      if( j < 3 ) {
+         mant += j ? 2*j - 3 : 0;
+         break;
+      }
+   }
+
+   if( ndig > prec ) {
+      sprintf( buf, "%.*g", prec, value );
+      return;
+   }
+
+/* Get the significant digits. */
+   if( value == 0.0 ) {
+      strcpy( digits, "0" );
+      ndig = 1;
+   } else {
+      sprintf( digits, "%lld", mant );
+   }
+
+/* Choose between fixed and exponential notation as "%.*g" would for the
+   full precision. */
+   p = buf;
+   if( signbit( value ) ) *( p++ ) = '-';
+   if( xexp < -4 || xexp >= prec ) {
+      *( p++ ) = digits[ 0 ];
+      if( ndig > 1 ) p += sprintf( p, ".%s", digits + 1 );
+      sprintf( p, "e%c%02d", ( xexp < 0 ) ? '-' : '+', abs( xexp ) );
+   } else if( xexp < 0 ) {
+      p += sprintf( p, "0." );
+      for( i = xexp + 1; i < 0; i++ ) *( p++ ) = '0';
+      strcpy( p, digits );
+   } else {
+      for( i = 0; i < ndig || i <= xexp; i++ ) {
+         if( i == xexp + 1 ) *( p++ ) = '.';
+         *( p++ ) = ( i < ndig ) ? digits[ i ] : '0';
+      }
+      *p = 0;
+   }
+}
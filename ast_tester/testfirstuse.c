@@ -0,0 +1,205 @@
+#include "ast.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NTHREAD 2
+#define NUNIT 12
+#define NRESULT ( 2*NUNIT + 6 )
+
+typedef struct Data {
+   double results[ NRESULT ];
+   int ok;
+} Data;
+
+static void Run( double * );
+static void *Worker( void * );
+static int Check( const double *, const char * );
+
+static pthread_barrier_t barrier;
+
+/* Pairs of units to convert between. */
+static const char *units[ NUNIT ][ 2 ] = {
+   { "Hz", "GHz" }, { "km/s", "m/s" }, { "Jy", "W/m**2/Hz" },
+   { "deg", "rad" }, { "erg/s/cm**2/Angstrom", "W/m**2/nm" },
+   { "pc", "m" }, { "yr", "min" }, { "log(Hz)", "Hz" },
+   { "mJy/beam", "uJy/beam" }, { "K.km/s", "K.m/s" },
+   { "arcsec**2", "sr" }, { "kg.m**2/s**2", "erg" }
+};
+
+/* A FITS-WCS header with an MJD-OBS value in the TAI timescale, which
+   must be converted to TDB when the header is read. */
+static const char *cards[] = {
+   "CTYPE1  = 'RA---TAN'", "CTYPE2  = 'DEC--TAN'",
+   "CRVAL1  = 150.0", "CRVAL2  = 30.0", "CRPIX1  = 10.0", "CRPIX2  = 20.0",
+   "CDELT1  = -0.001", "CDELT2  = 0.001", "RADESYS = 'FK5'",
+   "EQUINOX = 2000.0", "MJD-OBS = 55000.25", "TIMESYS = 'TAI'", NULL
+};
+
+/* The results given when everything was initialised at start-up. */
+static const double expected[ NRESULT ] = {
+   2.5000000000000001e-09, -3e-10,
+   2500.0, -300.0,
+   2.5000000000000004e-26, -3.0000000000000005e-27,
+   0.043633231299858237, -0.0052359877559829881,
+   0.025000000000000005, -0.0030000000000000005,
+   77167500000000016.0, -9260100000000000.0,
+   1314900.0, -157788.0,
+   316.22776601683825, 0.50118723362727224,
+   2500.0000000000005, -300.0,
+   2500.0, -300.0,
+   5.8761076347744713e-11, -7.0513291617293653e-12,
+   25000000.0, -3000000.0,
+   3.0905438423822438, -0.5612210090733879,
+   2.6038801528876694, 0.34881412141984908,
+   2009.461328877496, 55000.25
+};
+
+int main(){
+   Data data[ NTHREAD ];
+   double results[ NRESULT ];
+   int i;
+   int ok;
+   pthread_t thread[ NTHREAD ];
+
+   ok = 1;
+
+/* Units, sky conversions and FitsChan timescales are initialised when
+   they are first used, so the first uses must be made by several threads
+   at the same time, before any other AST calls are made. */
+   if( !AST__THREADSAFE ) {
+      Run( results );
+      ok = Check( results, "first use" );
+
+   } else {
+      pthread_barrier_init( &barrier, NULL, NTHREAD );
+      for( i = 0; i < NTHREAD && ok; i++ ) {
+         if( pthread_create( thread + i, NULL, Worker, data + i ) ) {
+            printf( "Error creating thread %d\n", i );
+            ok = 0;
+         }
+      }
+
+      for( i = 0; i < NTHREAD && ok; i++ ) {
+         if( pthread_join( thread[ i ], NULL ) ) {
+            printf( "Error joining thread %d\n", i );
+            ok = 0;
+         } else if( !data[ i ].ok ) {
+            ok = 0;
+         }
+      }
+      pthread_barrier_destroy( &barrier );
+   }
+
+/* Later uses should give the same results. */
+   if( ok ) {
+      Run( results );
+      ok = Check( results, "later use" );
+   }
+
+   if( astOK && ok ) {
+      printf(" All first use tests passed\n");
+   } else {
+      printf("First use tests failed\n");
+   }
+}
+
+static int Check( const double *results, const char *text ){
+   int i;
+
+   if( !astOK ) return 0;
+
+   for( i = 0; i < NRESULT; i++ ) {
+      if( results[ i ] != expected[ i ] ) {
+         printf( "%s: result %d is %.17g (should be %.17g)\n", text, i,
+                 results[ i ], expected[ i ] );
+         return 0;
+      }
+   }
+   return 1;
+}
+
+static void Run( double *results ){
+   AstFitsChan *fc;
+   AstFrame *from;
+   AstFrame *to;
+   AstFrameSet *cvt;
+   AstFrameSet *fs;
+   double *r;
+   double in[ 2 ] = { 2.5, -0.3 };
+   double out[ 2 ];
+   double x[ 2 ] = { 1.0, 0.5 };
+   double y[ 2 ] = { 0.2, -0.7 };
+   int i;
+
+   astBegin;
+
+/* Convert two values between each pair of units. The Frames must use
+   their units when aligning, so that the units are converted. */
+   r = results;
+   for( i = 0; i < NUNIT; i++ ) {
+      from = astFrame( 1, "Unit(1)=%s", units[ i ][ 0 ] );
+      to = astFrame( 1, "Unit(1)=%s", units[ i ][ 1 ] );
+      astSetActiveUnit( from, 1 );
+      astSetActiveUnit( to, 1 );
+      cvt = astConvert( from, to, "" );
+      if( cvt ) {
+         astTran1( cvt, 2, in, 1, out );
+      } else {
+         out[ 0 ] = out[ 1 ] = AST__BAD;
+      }
+      *( r++ ) = out[ 0 ];
+      *( r++ ) = out[ 1 ];
+   }
+
+/* Convert a position from FK5 to Galactic, which does not need the local
+   sidereal time, and then to AzEl, which does. */
+   from = (AstFrame *) astSkyFrame( "System=FK5,Epoch=2010.5" );
+   to = (AstFrame *) astSkyFrame( "System=Galactic,Epoch=2010.5" );
+   cvt = astConvert( from, to, "" );
+   astTran2( cvt, 1, x, y, 1, out, out + 1 );
+   *( r++ ) = out[ 0 ];
+   *( r++ ) = out[ 1 ];
+
+   to = (AstFrame *) astSkyFrame( "System=AzEl,Epoch=2010.5,ObsLon=-155.47,"
+                     "ObsLat=19.82" );
+   cvt = astConvert( from, to, "" );
+   astTran2( cvt, 1, x + 1, y + 1, 1, out, out + 1 );
+   *( r++ ) = out[ 0 ];
+   *( r++ ) = out[ 1 ];
+
+/* Read a FrameSet from a header that uses the TAI timescale. The Epoch
+   of the SkyFrame is in TDB. */
+   fc = astFitsChan( NULL, NULL, " " );
+   for( i = 0; cards[ i ]; i++ ) astPutFits( fc, cards[ i ], 0 );
+   astClear( fc, "Card" );
+   fs = astRead( fc );
+   *( r++ ) = fs ? astGetD( fs, "Epoch" ) : AST__BAD;
+
+/* Write it out again with the TAI timescale, which converts the Epoch
+   back from TDB to give the original MJD-OBS value. */
+   if( fs ) {
+      astEmptyFits( fc );
+      astPutFits( fc, "TIMESYS = 'TAI'", 0 );
+      astSet( fc, "Encoding=FITS-WCS" );
+      astWrite( fc, fs );
+      astClear( fc, "Card" );
+      if( !astGetFitsF( fc, "MJD-OBS", r ) ) *r = AST__BAD;
+   } else {
+      *r = AST__BAD;
+   }
+
+   astEnd;
+}
+
+static void *Worker( void *arg ){
+   Data *data;
+
+/* Wait until all threads are ready, so that they all make their first
+   calls at the same time. */
+   data = (Data *) arg;
+   pthread_barrier_wait( &barrier );
+   Run( data->results );
+   data->ok = Check( data->results, "first use in thread" );
+   return NULL;
+}
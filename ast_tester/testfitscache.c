@@ -0,0 +1,172 @@
+#include "ast.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MXCARD 400
+#define NCACHE 20
+#define NHEAD 11
+
+typedef struct Result {
+   AstObject *obj;
+   AstKeyMap *warnings;
+   char cards[ MXCARD ][ 81 ];
+   int ncard;
+} Result;
+
+static FILE *fd;
+
+static const char *Source( void );
+static int Compare( Result *, Result *, const char *, const char * );
+static int Read( const char *, const char *, Result * );
+
+int main(){
+   Result *cached;
+   Result *ref;
+   const char *attrs[ 2 ] = { " ", "Iwc=1" };
+   const char *files[ NHEAD ] = { "car1.head", "cobe.head", "tnx.head",
+                                  "zpx.head", "sip.head", "polco.head",
+                                  "specflux.head", "dss.fits-dss",
+                                  "timj.fits-aips", "timj.fits-iraf",
+                                  "longslit.fits-pc" };
+   int i;
+   int iattr;
+   int ihead;
+   int ndiff;
+   int ok;
+
+   ok = 1;
+   ndiff = 0;
+   ref = astMalloc( sizeof( Result )*NHEAD*2 );
+   cached = astMalloc( sizeof( Result ) );
+
+   astBegin;
+
+/* Read each header with the cache disabled, with and without an
+   attribute that changes the FrameSet. */
+   astTune( "FitsWcsCache", 0 );
+   for( ihead = 0; ihead < NHEAD && ok; ihead++ ) {
+      for( iattr = 0; iattr < 2 && ok; iattr++ ) {
+         if( !Read( files[ ihead ], attrs[ iattr ], ref + 2*ihead + iattr ) ) {
+            printf( "%s: failed to read header\n", files[ ihead ] );
+            ok = 0;
+         }
+      }
+      if( ok && !astEqual( ref[ 2*ihead ].obj, ref[ 2*ihead + 1 ].obj ) ) {
+         ndiff++;
+      }
+   }
+   if( ok && ndiff == 0 ) {
+      printf( "Setting %s made no difference to any header\n", attrs[ 1 ] );
+      ok = 0;
+   }
+
+/* Enable the cache and read each header several times. The first read
+   creates the FrameSet and later reads re-use it. Each read should give
+   an equal Object, the same warnings, and should leave the same unused
+   cards in the FitsChan, as when the cache is disabled. The attribute
+   should change the FrameSet whether or not it is cached. */
+   astTune( "FitsWcsCache", NCACHE );
+   for( i = 0; i < 3 && ok; i++ ) {
+      for( ihead = 0; ihead < NHEAD && ok; ihead++ ) {
+         for( iattr = 0; iattr < 2 && ok; iattr++ ) {
+            if( !Read( files[ ihead ], attrs[ iattr ], cached ) ||
+                !Compare( ref + 2*ihead + iattr, cached, files[ ihead ],
+                          attrs[ iattr ] ) ) ok = 0;
+         }
+      }
+   }
+
+/* Check that astTune returns the current size of the cache, and disable
+   it. */
+   if( ok && astTune( "FitsWcsCache", 0 ) != NCACHE ) {
+      printf( "astTune returned the wrong FitsWcsCache value\n" );
+      ok = 0;
+   }
+
+/* A read should still give the same result once the cache has been
+   emptied. */
+   if( ok ) {
+      if( !Read( files[ 0 ], attrs[ 0 ], cached ) ||
+          !Compare( ref, cached, files[ 0 ], "emptied cache" ) ) ok = 0;
+   }
+
+   astEnd;
+
+   ref = astFree( ref );
+   cached = astFree( cached );
+
+   if( astOK && ok ) {
+      printf(" All FitsChan WCS cache tests passed\n");
+   } else {
+      printf("FitsChan WCS cache tests failed\n");
+   }
+}
+
+static int Compare( Result *ref, Result *test, const char *file,
+                    const char *text ){
+   int i;
+
+   if( !astOK ) return 0;
+
+   if( !astEqual( ref->obj, test->obj ) ) {
+      printf( "%s (%s): %s read is different\n", file, text,
+              astGetC( ref->obj, "Class" ) );
+      return 0;
+   }
+
+   if( ( ref->warnings != NULL ) != ( test->warnings != NULL ) ||
+       ( ref->warnings && !astEqual( ref->warnings, test->warnings ) ) ) {
+      printf( "%s (%s): different warnings issued\n", file, text );
+      return 0;
+   }
+
+   if( ref->ncard != test->ncard ) {
+      printf( "%s (%s): %d cards left unused (should be %d)\n", file, text,
+              test->ncard, ref->ncard );
+      return 0;
+   }
+
+   for( i = 0; i < ref->ncard; i++ ) {
+      if( strcmp( ref->cards[ i ], test->cards[ i ] ) ) {
+         printf( "%s (%s): unused card %d is different\n", file, text,
+                 i + 1 );
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+static int Read( const char *file, const char *attrs, Result *result ){
+   AstFitsChan *fc;
+
+   if( !astOK ) return 0;
+
+/* Read an Object from the header, issuing all possible warnings. */
+   fd = fopen( file, "r" );
+   if( !fd ) return 0;
+   fc = astFitsChan( Source, NULL, "%s", attrs );
+   astSetC( fc, "Warnings", astGetC( fc, "AllWarnings" ) );
+   result->obj = astRead( fc );
+   fclose( fd );
+
+/* Get the warnings, and the cards that were not used. */
+   result->warnings = astWarnings( fc );
+   result->ncard = 0;
+   astClear( fc, "Card" );
+   while( result->ncard < MXCARD &&
+          astFindFits( fc, "%f", result->cards[ result->ncard ], 1 ) ) {
+      result->ncard++;
+   }
+   fc = astAnnul( fc );
+
+   return result->obj && astOK;
+}
+
+static const char *Source( void ){
+   static char line[ 200 ];
+
+   if( !fgets( line, sizeof( line ), fd ) ) return NULL;
+   line[ strcspn( line, "\n" ) ] = 0;
+   return line;
+}
@@ -0,0 +1,454 @@
+#include "ast.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MXCARD 2000
+#define NKEY 50
+
+typedef struct Card {
+   int type;
+   const char *text;
+} Card;
+
+static char cards[ MXCARD ][ 81 ];
+static int iinput;
+static int ncard;
+
+/* Header cards of each type, including illegal values and duplicated
+   keywords, and the cards that should be stored for them. */
+static const char *input[] = {
+   "INT1    = 42 / an integer",
+   "FLT1    = 1.5D3",
+   "FLT2    = -.5E-3 / comment",
+   "FLT3    = 1.0E400",
+   "FLT4    = 1.",
+   "FLT5    = 3.0e+2",
+   "CPX1    = (1, 2)",
+   "CPX2    = 1.5 -2.5E1 / complex",
+   "CPX3    = 3 -4",
+   "LOG1    = T",
+   "LOG2    =                    F / false",
+   "STR1    = 'O''Hara'",
+   "STR2    = 'unterminated",
+   "STR3    = ''",
+   "STR4    = 'trailing   ' / c",
+   "UNDEF   =      / undefined",
+   "COMMENT hello",
+   "HISTORY  duplicate",
+   "HISTORY  duplicate",
+   "        blank keyword comment",
+   "BAD     = 12abc",
+   "BIGINT  = 12345678901234",
+   "NEGINT  = -7",
+   "PLUS    = +7",
+   "YESVAL  = YES",
+   "INT1    = 43 / duplicate",
+   "lower   = 1",
+   "NOEQ    1",
+   "DATE-OBS= '2000-01-01'",
+   "SPACEVAL=    3.0   ",
+   "SLASH   = 'a/b' / c/d",
+   "NAN     = NaN",
+   "E       = 1E5",
+   "DOT     = .",
+   "WIDE    = 1.234567890123456789012345",
+   NULL
+};
+
+static const Card expected[] = {
+   { AST__INT, "INT1    =                   42 / an integer" },
+   { AST__FLOAT, "FLT1    =               1500.0" },
+   { AST__FLOAT, "FLT2    =              -5.0E-4 / comment" },
+   { AST__FLOAT, "FLT3    =                  0.0" },
+   { AST__FLOAT, "FLT4    =                  1.0" },
+   { AST__FLOAT, "FLT5    =                300.0" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__STRING, "ASTWARN = 'The keyword value is illegal in ''CPX1    = (1, 2)'''" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__COMMENT, "CPX1" },
+   { AST__COMPLEXF, "CPX2    =                  1.5               -25.0 / complex" },
+   { AST__COMPLEXI, "CPX3    =                    3                   -4" },
+   { AST__LOGICAL, "LOG1    =                    T" },
+   { AST__LOGICAL, "LOG2    =                    F / false" },
+   { AST__STRING, "STR1    = 'O''Hara '" },
+   { AST__STRING, "STR2    = 'unterminated'" },
+   { AST__STRING, "STR3    = '        '" },
+   { AST__STRING, "STR4    = 'trailing   '        / c" },
+   { AST__UNDEF, "UNDEF   =                      / undefined" },
+   { AST__COMMENT, "COMMENT hello" },
+   { AST__COMMENT, "HISTORY  duplicate" },
+   { AST__COMMENT, "HISTORY  duplicate" },
+   { AST__COMMENT, "        blank keyword comment" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__STRING, "ASTWARN = 'The keyword value is illegal in ''BAD     = 12abc'''" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__COMMENT, "BAD" },
+   { AST__FLOAT, "BIGINT  =     12345678901234.0" },
+   { AST__INT, "NEGINT  =                   -7" },
+   { AST__INT, "PLUS    =                    7" },
+   { AST__LOGICAL, "YESVAL  =                    T" },
+   { AST__INT, "INT1    =                   43 / duplicate" },
+   { AST__INT, "LOWER   =                    1" },
+   { AST__COMMENT, "NOEQ    1" },
+   { AST__STRING, "DATE-OBS= '2000-01-01'" },
+   { AST__FLOAT, "SPACEVAL=                  3.0" },
+   { AST__STRING, "SLASH   = 'a/b     '           / c/d" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__STRING, "ASTWARN = 'The keyword value is illegal in ''NAN     = NaN'''" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__COMMENT, "NAN" },
+   { AST__FLOAT, "E       =             100000.0" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__STRING, "ASTWARN = 'The keyword value is illegal in ''DOT     = .'''" },
+   { AST__STRING, "ASTWARN = '        '" },
+   { AST__COMMENT, "DOT" },
+   { AST__FLOAT, "WIDE    =   1.2345678901234567" },
+   { AST__NOTYPE, NULL }
+};
+
+/* The cards that should result from overwriting and inserting cards with
+   duplicated keywords. */
+static const Card replaced[] = {
+   { AST__INT, "INT1    =                   45 / an integer" },
+   { AST__INT, "INT1    =                   46" },
+   { AST__INT, "X       =                    1" },
+   { AST__INT, "INT1    =                   44 / replaced" },
+   { AST__NOTYPE, NULL }
+};
+
+static AstFitsChan *MakeFitsChan( void );
+static int CheckCards( AstFitsChan *, const Card *, const char * );
+static int CheckKeys( AstFitsChan *, const char * );
+static int Find( AstFitsChan *, const char *, char * );
+static int Parse( void );
+static void List( AstFitsChan * );
+static const char *Source( void );
+
+int main(){
+   AstFitsChan *fc;
+   char card[ 81 ];
+   char name[ 9 ];
+   int i;
+   int ok;
+   int there;
+
+   ok = 1;
+   astBegin;
+
+/* A FitsChan containing many cards, in which each keyword name appears
+   many times. Check that astFindFits finds every occurrence of each
+   keyword in the order they are stored. */
+   fc = MakeFitsChan();
+   if( !CheckKeys( fc, "initial header" ) ) ok = 0;
+
+/* Delete the first occurrence of some keywords, and all occurrences of
+   others, then check that the remaining occurrences are still found,
+   and that the deleted ones are not. */
+   for( i = 0; i < NKEY && ok; i += 3 ) {
+      sprintf( name, "KEY%02d", i );
+      astClear( fc, "Card" );
+      while( astFindFits( fc, name, NULL, 0 ) ) {
+         astDelFits( fc );
+         if( i % 2 ) break;
+      }
+   }
+   if( ok && !CheckKeys( fc, "header after deleting cards" ) ) ok = 0;
+
+   for( i = 0; i < NKEY && ok; i += 3 ) {
+      sprintf( name, "KEY%02d", i );
+      astClear( fc, "Card" );
+      astTestFits( fc, name, &there );
+      if( there != ( i % 2 ) ) {
+         printf( "astTestFits says %s is %spresent after deletion\n", name,
+                 there ? "" : "not " );
+         ok = 0;
+      }
+   }
+
+/* Insert new cards in front of existing occurrences of a keyword, both
+   at the start and in the middle of the header, and check that they are
+   found first. */
+   if( ok ) {
+      astClear( fc, "Card" );
+      astPutFits( fc, "KEY01   = 1", 0 );
+      astSetI( fc, "Card", ncard/2 );
+      astPutFits( fc, "KEY01   = 51", 0 );
+      if( !CheckKeys( fc, "header after inserting cards" ) ) ok = 0;
+   }
+
+/* Delete every card, checking at each step. */
+   if( ok ) {
+      astClear( fc, "Card" );
+      for( i = 0; astOK && astGetI( fc, "Ncard" ) > 0; i++ ) {
+         astSetI( fc, "Card", ( i*7 ) % astGetI( fc, "Ncard" ) + 1 );
+         astDelFits( fc );
+         if( i % 97 == 0 && !CheckKeys( fc, "partially deleted header" ) ) {
+            ok = 0;
+            break;
+         }
+      }
+      if( ok && Find( fc, "KEY01", card ) ) {
+         printf( "KEY01 found in empty FitsChan\n" );
+         ok = 0;
+      }
+   }
+
+/* Check the cards stored for headers containing values of each type. */
+   if( ok && !Parse() ) ok = 0;
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All FitsChan keyword tests passed\n");
+   } else {
+      printf("FitsChan keyword tests failed\n");
+   }
+}
+
+static int CheckCards( AstFitsChan *fc, const Card *cardlist,
+                       const char *text ){
+   char *p;
+   int i;
+   int type;
+
+   if( !astOK ) return 0;
+
+/* Compare each card in the FitsChan, excluding trailing spaces, with the
+   expected text, and check its data type. */
+   List( fc );
+   for( i = 0; i < ncard && cardlist[ i ].text; i++ ) {
+      p = cards[ i ] + strlen( cards[ i ] );
+      while( p > cards[ i ] && p[ -1 ] == ' ' ) *( --p ) = 0;
+
+      astSetI( fc, "Card", i + 1 );
+      type = astGetI( fc, "CardType" );
+      if( strcmp( cards[ i ], cardlist[ i ].text ) ) {
+         printf( "%s: card %d is \"%s\" (should be \"%s\")\n", text, i + 1,
+                 cards[ i ], cardlist[ i ].text );
+         return 0;
+      } else if( type != cardlist[ i ].type ) {
+         printf( "%s: card %d has type %d (should be %d)\n", text, i + 1,
+                 type, cardlist[ i ].type );
+         return 0;
+      }
+   }
+
+   if( i < ncard || cardlist[ i ].text ) {
+      printf( "%s: wrong number of cards (%d) stored\n", text, ncard );
+      return 0;
+   }
+
+   return astOK;
+}
+
+static int CheckKeys( AstFitsChan *fc, const char *text ){
+   char card[ 81 ];
+   char name[ 9 ];
+   int first;
+   int i;
+   int icard;
+   int ikey;
+   int ival;
+   int nfound;
+
+   if( !astOK ) return 0;
+
+/* Get a copy of all the cards in the FitsChan. */
+   List( fc );
+
+/* For each keyword, use astFindFits to find each occurrence in turn, and
+   compare it with the next occurrence in the list. */
+   for( ikey = -1; ikey < NKEY; ikey++ ) {
+      if( ikey < 0 ) {
+         strcpy( name, "HISTORY" );
+      } else {
+         sprintf( name, "KEY%02d", ikey );
+      }
+
+      astClear( fc, "Card" );
+      nfound = 0;
+      first = 0;
+      for( i = 0; i < ncard; i++ ) {
+         if( strncmp( cards[ i ], name, strlen( name ) ) ||
+             cards[ i ][ strlen( name ) ] != ' ' ) continue;
+
+         if( !astFindFits( fc, name, card, 0 ) ) {
+            printf( "%s: occurrence %d of %s not found\n", text, nfound + 1,
+                    name );
+            return 0;
+         }
+
+         icard = astGetI( fc, "Card" );
+         if( icard != i + 1 || strcmp( card, cards[ i ] ) ) {
+            printf( "%s: occurrence %d of %s found at card %d (should be %d)\n",
+                    text, nfound + 1, name, icard, i + 1 );
+            return 0;
+         }
+
+/* The current card should be the one found. */
+         if( ikey >= 0 ) {
+            if( !astGetFitsI( fc, NULL, &ival ) ||
+                ival % NKEY != ikey ) {
+               printf( "%s: wrong value for current %s card\n", text, name );
+               return 0;
+            }
+         }
+
+         if( nfound++ == 0 ) sscanf( cards[ i ] + 10, "%d", &first );
+         astSetI( fc, "Card", icard + 1 );
+      }
+
+/* Searching for the keyword by name from the start should give the
+   value of the first occurrence. */
+      if( nfound > 0 && ikey >= 0 ) {
+         astClear( fc, "Card" );
+         if( !astGetFitsI( fc, name, &ival ) || ival != first ) {
+            printf( "%s: astGetFitsI gives the wrong value for %s\n", text,
+                    name );
+            return 0;
+         }
+         astSetI( fc, "Card", ncard + 1 );
+      }
+
+/* There should be no further occurrences. */
+      if( astFindFits( fc, name, card, 0 ) ) {
+         printf( "%s: extra occurrence of %s found at card %d\n", text,
+                 name, astGetI( fc, "Card" ) );
+         return 0;
+      }
+   }
+
+   return astOK;
+}
+
+static int Find( AstFitsChan *fc, const char *name, char *card ){
+   astClear( fc, "Card" );
+   return astFindFits( fc, name, card, 0 );
+}
+
+static int Parse( void ){
+   AstFitsChan *fc;
+   char *header;
+   char *p;
+   char card[ 81 ];
+   int i;
+   int icard[ 3 ];
+   int ok;
+   static Card paddedlist[ MXCARD + 1 ];
+   static char padded[ MXCARD ][ 81 ];
+
+   ok = 1;
+   astBegin;
+
+/* Store the cards using astPutFits. */
+   fc = astFitsChan( NULL, NULL, " " );
+   for( i = 0; input[ i ]; i++ ) astPutFits( fc, input[ i ], 0 );
+   if( !CheckCards( fc, expected, "astPutFits" ) ) ok = 0;
+
+/* Store them using astPutCards, with each card padded to 80 characters.
+   The padding is included in the text of any warnings, so compare them
+   with the cards stored by astPutFits for the padded cards. */
+   if( ok ) {
+      header = astMalloc( 80*MXCARD + 1 );
+      fc = astFitsChan( NULL, NULL, " " );
+      for( i = 0; input[ i ]; i++ ) {
+         sprintf( header + 80*i, "%-80s", input[ i ] );
+         astPutFits( fc, header + 80*i, 0 );
+      }
+      List( fc );
+      for( i = 0; i < ncard; i++ ) {
+         strcpy( padded[ i ], cards[ i ] );
+         p = padded[ i ] + strlen( padded[ i ] );
+         while( p > padded[ i ] && p[ -1 ] == ' ' ) *( --p ) = 0;
+         astSetI( fc, "Card", i + 1 );
+         paddedlist[ i ].type = astGetI( fc, "CardType" );
+         paddedlist[ i ].text = padded[ i ];
+      }
+      paddedlist[ i ].type = AST__NOTYPE;
+      paddedlist[ i ].text = NULL;
+
+      fc = astFitsChan( NULL, NULL, " " );
+      astPutCards( fc, header );
+      if( !CheckCards( fc, paddedlist, "astPutCards" ) ) ok = 0;
+      header = astFree( header );
+   }
+
+/* Read them using a source function. */
+   if( ok ) {
+      iinput = 0;
+      fc = astFitsChan( Source, NULL, " " );
+      if( !CheckCards( fc, expected, "source function" ) ) ok = 0;
+   }
+
+/* Overwrite the second of two cards with the same keyword, then the
+   first, and insert a third. A NULL comment should retain the comment of
+   the card being overwritten. */
+   if( ok ) {
+      fc = astFitsChan( NULL, NULL, " " );
+      astPutFits( fc, "INT1    = 42 / an integer", 0 );
+      astPutFits( fc, "X       = 1", 0 );
+      astPutFits( fc, "INT1    = 43 / duplicate", 0 );
+
+      astClear( fc, "Card" );
+      astFindFits( fc, "INT1", card, 1 );
+      astFindFits( fc, "INT1", card, 0 );
+      astPutFits( fc, "INT1    = 44 / replaced", 1 );
+
+      astClear( fc, "Card" );
+      astFindFits( fc, "INT1", card, 0 );
+      astSetFitsI( fc, "INT1", 45, NULL, 1 );
+
+      astSetI( fc, "Card", 2 );
+      astSetFitsI( fc, "INT1", 46, NULL, 0 );
+      if( !CheckCards( fc, replaced, "replaced cards" ) ) ok = 0;
+   }
+
+/* The keyword should be found at the new positions. */
+   if( ok ) {
+      astClear( fc, "Card" );
+      for( i = 0; i < 3 && astFindFits( fc, "INT1", card, 1 ); i++ ) {
+         icard[ i ] = astGetI( fc, "Card" ) - 1;
+      }
+      if( i != 3 || icard[ 0 ] != 1 || icard[ 1 ] != 2 || icard[ 2 ] != 4 ||
+          astFindFits( fc, "INT1", card, 1 ) ) {
+         printf( "Replaced INT1 cards found at the wrong positions\n" );
+         ok = 0;
+      }
+   }
+
+   astEnd;
+   return ok && astOK;
+}
+
+static const char *Source( void ){
+   return input[ iinput ] ? input[ iinput++ ] : NULL;
+}
+
+static void List( AstFitsChan *fc ){
+   ncard = 0;
+   astClear( fc, "Card" );
+   while( ncard < MXCARD && astFindFits( fc, "%f", cards[ ncard ], 1 ) ) {
+      ncard++;
+   }
+   astClear( fc, "Card" );
+}
+
+static AstFitsChan *MakeFitsChan( void ){
+   AstFitsChan *result;
+   char card[ 81 ];
+   int i;
+
+/* Each keyword name appears many times, with values that identify each
+   occurrence. History cards are mixed in with them. */
+   result = astFitsChan( NULL, NULL, " " );
+   for( i = 0; i < MXCARD - 100; i++ ) {
+      if( i % 11 == 0 ) {
+         sprintf( card, "HISTORY Card %d", i );
+      } else {
+         sprintf( card, "KEY%02d   = %d", ( i*7 ) % NKEY,
+                  i*NKEY + ( i*7 ) % NKEY );
+      }
+      astPutFits( result, card, 0 );
+   }
+   return result;
+}
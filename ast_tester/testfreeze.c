@@ -0,0 +1,286 @@
+#include "ast.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NTHREAD 4
+#define NLOOP 20
+#define NROW 100
+#define MXTEXT 200000
+
+typedef struct Text {
+   char *buf;
+   int len;
+} Text;
+
+typedef struct Data {
+   AstKeyMap *table;
+   const char *ref;
+   int size;
+   int ok;
+} Data;
+
+static AstKeyMap *MakeTable( void );
+static int CheckCells( AstKeyMap *, int, const char * );
+static void *Worker( void * );
+static void Write( AstObject *, Text * );
+static void Sink( const char * );
+
+int main(){
+   AstKeyMap *table;
+   Data data[ NTHREAD ];
+   Text ref;
+   Text text;
+   int i;
+   int ok;
+   pthread_t thread[ NTHREAD ];
+
+   ok = 1;
+
+/* Frozen Objects can only be shared between threads in thread-safe builds
+   of AST. */
+   if( !AST__THREADSAFE ) {
+      printf(" All Freeze tests passed (AST is not thread-safe)\n");
+      return 0;
+   }
+
+   ref.buf = malloc( MXTEXT );
+   text.buf = malloc( MXTEXT );
+
+   astBegin;
+
+/* Create a Table in which the cells of the numerical columns are held in
+   column arrays, and then freeze it. */
+   table = MakeTable();
+   astFreeze( table );
+   if( !astGetI( table, "Frozen" ) ) {
+      printf( "Table is not frozen\n" );
+      ok = 0;
+   }
+
+/* Get the text produced by writing the frozen Table to a Channel. This
+   should not change as the Table is used. */
+   Write( (AstObject *) table, &ref );
+
+/* Use the frozen Table in several threads at the same time, without
+   locking it. Each thread copies it, copies its entries into a KeyMap,
+   writes it to a Channel and reads its cells. */
+   for( i = 0; i < NTHREAD && ok; i++ ) {
+      data[ i ].table = table;
+      data[ i ].ref = ref.buf;
+      data[ i ].size = astMapSize( table );
+      data[ i ].ok = 1;
+      if( pthread_create( thread + i, NULL, Worker, data + i ) ) {
+         printf( "Error creating thread %d\n", i );
+         ok = 0;
+      }
+   }
+
+   for( i = 0; i < NTHREAD && ok; i++ ) {
+      if( pthread_join( thread[ i ], NULL ) ) {
+         printf( "Error joining thread %d\n", i );
+         ok = 0;
+      } else if( !data[ i ].ok ) {
+         ok = 0;
+      }
+   }
+
+/* Check the Table has not changed. */
+   if( ok ) {
+      Write( (AstObject *) table, &text );
+      if( strcmp( text.buf, ref.buf ) ) {
+         printf( "Frozen Table changed whilst being used\n" );
+         ok = 0;
+      } else if( !CheckCells( table, 1, "main thread" ) ) {
+         ok = 0;
+      }
+   }
+
+   astEnd;
+
+   free( ref.buf );
+   free( text.buf );
+
+   if( astOK && ok ) {
+      printf(" All Freeze tests passed\n");
+   } else {
+      printf("Freeze tests failed\n");
+   }
+}
+
+static AstKeyMap *MakeTable( void ){
+   AstTable *result;
+   char key[ 20 ];
+   char val[ 20 ];
+   int dims[ 1 ] = { 3 };
+   int ivec[ 3 ];
+   int irow;
+
+   result = astTable( "SortBy=AgeUp" );
+   astAddColumn( result, "A", AST__DOUBLETYPE, 0, NULL, "m" );
+   astAddColumn( result, "B", AST__INTTYPE, 1, dims, " " );
+   astAddColumn( result, "S", AST__STRINGTYPE, 0, NULL, " " );
+   astAddParameter( result, "P" );
+   astMapPut0I( result, "P", 42, "A parameter" );
+
+   for( irow = 1; irow <= NROW; irow++ ) {
+      sprintf( key, "A(%d)", irow );
+      astMapPut0D( result, key, 0.5*irow, ( irow % 10 ) ? NULL : "A comment" );
+      sprintf( key, "B(%d)", irow );
+      ivec[ 0 ] = irow;
+      ivec[ 1 ] = irow + 1;
+      ivec[ 2 ] = irow + 2;
+      astMapPut1I( result, key, 3, ivec, NULL );
+      sprintf( key, "S(%d)", irow );
+      sprintf( val, "row %d", irow );
+      astMapPut0C( result, key, val, NULL );
+   }
+
+   return (AstKeyMap *) result;
+}
+
+static int CheckCells( AstKeyMap *table, int step, const char *where ){
+   char key[ 20 ];
+   char val[ 20 ];
+   const char *cval;
+   double dval;
+   int irow;
+   int ival;
+   int ivec[ 3 ];
+   int nval;
+
+   for( irow = 1; irow <= NROW && astOK; irow += step ) {
+      sprintf( key, "A(%d)", irow );
+      if( !astMapGet0D( table, key, &dval ) || dval != 0.5*irow ) {
+         printf( "%s: bad value for %s\n", where, key );
+         return 0;
+      }
+
+/* Get the same cell with type conversion, and its formatted length. */
+      if( !astMapGet0I( table, key, &ival ) || ival != (int)( 0.5*irow + 0.5 ) ||
+          astMapLenC( table, key ) <= 0 ) {
+         printf( "%s: bad converted value for %s\n", where, key );
+         return 0;
+      }
+
+      sprintf( key, "B(%d)", irow );
+      if( !astMapGet1I( table, key, 3, &nval, ivec ) || nval != 3 ||
+          ivec[ 0 ] != irow || ivec[ 2 ] != irow + 2 ||
+          astMapLength( table, key ) != 3 ||
+          !astMapGetElemI( table, key, 1, &ival ) || ival != irow + 1 ) {
+         printf( "%s: bad value for %s\n", where, key );
+         return 0;
+      }
+
+      sprintf( key, "S(%d)", irow );
+      sprintf( val, "row %d", irow );
+      if( !astMapGet0C( table, key, &cval ) || strcmp( cval, val ) ) {
+         printf( "%s: bad value for %s\n", where, key );
+         return 0;
+      }
+   }
+
+   if( !astMapGet0I( table, "P", &ival ) || ival != 42 ) {
+      printf( "%s: bad value for parameter P\n", where );
+      return 0;
+   }
+
+   return astOK;
+}
+
+static void *Worker( void *ptr ){
+   AstKeyMap *copy;
+   AstKeyMap *km;
+   Data *data;
+   Text text;
+   const char *key;
+   double dval;
+   int i;
+   int iloop;
+
+   data = (Data *) ptr;
+   text.buf = malloc( MXTEXT );
+
+   astBegin;
+
+   for( iloop = 0; iloop < NLOOP && data->ok; iloop++ ) {
+
+/* Read the cells. */
+      if( !CheckCells( data->table, 7, "worker" ) ) data->ok = 0;
+
+/* Access the cells by index. */
+      for( i = 0; i < data->size && data->ok; i += 13 ) {
+         key = astMapKey( data->table, i );
+         if( !key || !astMapHasKey( data->table, key ) ) {
+            printf( "worker: bad key %d\n", i );
+            data->ok = 0;
+         }
+      }
+
+/* Write the Table to a Channel. */
+      Write( (AstObject *) data->table, &text );
+      if( data->ok && strcmp( text.buf, data->ref ) ) {
+         printf( "worker: frozen Table written differently\n" );
+         data->ok = 0;
+      }
+
+/* Copy the Table, and change the copy. */
+      copy = astCopy( data->table );
+      if( astGetI( copy, "Frozen" ) || astMapSize( copy ) != data->size ) {
+         printf( "worker: bad copy of frozen Table\n" );
+         data->ok = 0;
+      }
+      astMapPut0D( copy, "A(1)", -1.0, NULL );
+      astMapPut0D( copy, "A(2)", -2.0, NULL );
+      if( !astMapGet0D( copy, "A(2)", &dval ) || dval != -2.0 ||
+          !astMapGet0D( data->table, "A(2)", &dval ) || dval != 1.0 ) {
+         printf( "worker: changing a copy of a frozen Table failed\n" );
+         data->ok = 0;
+      }
+      copy = astAnnul( copy );
+
+/* Copy the entries into a KeyMap. */
+      km = astKeyMap( " " );
+      astMapCopy( km, data->table );
+      astMapCopyEntry( km, "A(2)", data->table, 0 );
+      if( astMapSize( km ) != data->size ) {
+         printf( "worker: astMapCopy copied %d entries (should be %d)\n",
+                 astMapSize( km ), data->size );
+         data->ok = 0;
+      }
+      km = astAnnul( km );
+
+      if( !astOK ) data->ok = 0;
+   }
+
+   astEnd;
+
+   free( text.buf );
+   return NULL;
+}
+
+static void Write( AstObject *obj, Text *text ){
+   AstChannel *ch;
+
+   text->len = 0;
+   text->buf[ 0 ] = 0;
+   ch = astChannel( NULL, Sink, " " );
+   astPutChannelData( ch, text );
+   astWrite( ch, obj );
+   ch = astAnnul( ch );
+}
+
+static void Sink( const char *line ){
+   Text *text;
+   int len;
+
+   text = (Text *) astChannelData;
+   len = strlen( line );
+   if( text->len + len + 2 < MXTEXT ) {
+      strcpy( text->buf + text->len, line );
+      text->len += len;
+      text->buf[ text->len++ ] = '\n';
+      text->buf[ text->len ] = 0;
+   }
+}
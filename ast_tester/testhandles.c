@@ -0,0 +1,252 @@
+#include "ast.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define NOBJ 1300
+#define NTHREAD 4
+#define STRIDE 257
+
+static int CheckId( AstObject *, int, const char * );
+static int CheckInvalid( AstObject *, const char * );
+static int Stale( void );
+static int ManySlabs( void );
+static int Threads( void );
+static void *Worker( void * );
+
+int main(){
+   int ok;
+
+   ok = 1;
+   astBegin;
+
+   if( !Stale() ) ok = 0;
+   if( ok && !ManySlabs() ) ok = 0;
+   if( ok && !Threads() ) ok = 0;
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All Object handle tests passed\n");
+   } else {
+      printf("Object handle tests failed\n");
+   }
+}
+
+static int CheckId( AstObject *obj, int value, const char *text ){
+   int id;
+
+   if( !astOK ) return 0;
+
+/* Each Object used by these tests has its ID attribute set to an
+   integer value that identifies it. */
+   id = astGetI( obj, "ID" );
+   if( !astOK || id != value ) {
+      printf( "%s: Object has ID %d (should be %d)\n", text, id, value );
+      return 0;
+   }
+   return 1;
+}
+
+static int CheckInvalid( AstObject *obj, const char *text ){
+   int result;
+
+   if( !astOK ) return 0;
+
+/* Using an identifier that has been annulled, or whose Object has been
+   deleted, should give an AST__OBJIN error. */
+   (void) astGetI( obj, "ID" );
+   result = ( astStatus == AST__OBJIN );
+   astClearStatus;
+   if( !result ) printf( "%s: no AST__OBJIN error\n", text );
+   return result;
+}
+
+static int Stale( void ){
+   AstObject *new;
+   AstObject *obj;
+   AstObject *stale;
+   int ok;
+
+   ok = 1;
+   astBegin;
+
+/* Annul an identifier and then create a new Object, which will re-use
+   the Handle. The new identifier should be different, and the old one
+   should be rejected. */
+   obj = (AstObject *) astUnitMap( 1, "ID=1" );
+   stale = obj;
+   obj = astAnnul( obj );
+   new = (AstObject *) astUnitMap( 1, "ID=2" );
+   if( new == stale ) {
+      printf( "Re-used Handle has the same identifier\n" );
+      ok = 0;
+   } else if( !CheckInvalid( stale, "annulled identifier" ) ||
+              !CheckId( new, 2, "re-used Handle" ) ) {
+      ok = 0;
+   }
+
+/* The same for an identifier annulled by astEnd. */
+   if( ok ) {
+      astBegin;
+      stale = (AstObject *) astUnitMap( 1, "ID=3" );
+      astEnd;
+      new = (AstObject *) astUnitMap( 1, "ID=4" );
+      if( !CheckInvalid( stale, "identifier annulled by astEnd" ) ||
+          !CheckId( new, 4, "Handle re-used after astEnd" ) ) ok = 0;
+   }
+
+/* A cloned identifier should remain valid after the original is annulled,
+   but not after the Object is deleted. */
+   if( ok ) {
+      obj = (AstObject *) astUnitMap( 1, "ID=5" );
+      stale = astClone( obj );
+      obj = astAnnul( obj );
+      new = (AstObject *) astUnitMap( 1, "ID=6" );
+      if( !CheckId( stale, 5, "clone" ) ) {
+         ok = 0;
+      } else {
+         obj = stale;
+         astDelete( obj );
+         new = (AstObject *) astUnitMap( 1, "ID=7" );
+         if( !CheckInvalid( stale, "identifier of deleted Object" ) ||
+             !CheckId( new, 7, "Handle re-used after astDelete" ) ) ok = 0;
+      }
+   }
+
+   astEnd;
+   return ok && astOK;
+}
+
+static int ManySlabs( void ){
+   AstObject *objs[ NOBJ ];
+   int i;
+   int ok;
+
+   ok = 1;
+   astBegin;
+
+/* Create enough Objects to need more than one slab of Handles, and check
+   each identifier refers to the correct Object. */
+   for( i = 0; i < NOBJ && astOK; i++ ) {
+      objs[ i ] = (AstObject *) astUnitMap( 1, "ID=%d", i );
+   }
+   for( i = 0; i < NOBJ && ok; i++ ) {
+      if( !CheckId( objs[ i ], i, "many Handles" ) ) ok = 0;
+   }
+
+/* Annul every other identifier, then create new Objects to re-use the
+   Handles. */
+   if( ok ) {
+      for( i = 0; i < NOBJ; i += 2 ) objs[ i ] = astAnnul( objs[ i ] );
+      for( i = 0; i < NOBJ && astOK; i += 2 ) {
+         objs[ i ] = (AstObject *) astUnitMap( 1, "ID=%d", NOBJ + i );
+      }
+      for( i = 0; i < NOBJ && ok; i++ ) {
+         if( !CheckId( objs[ i ], ( i % 2 ) ? i : NOBJ + i,
+                       "re-used Handles" ) ) ok = 0;
+      }
+   }
+
+/* Export one Object to the enclosing context. */
+   if( ok ) astExport( objs[ 1 ] );
+
+   astEnd;
+
+/* All the other identifiers should now be invalid. Check a sample of
+   them, and the exported one. */
+   if( ok ) {
+      if( !CheckId( objs[ 1 ], 1, "exported Object" ) ) ok = 0;
+      for( i = 0; i < NOBJ && ok; i += STRIDE ) {
+         if( !CheckInvalid( objs[ i ], "identifier after astEnd" ) ) ok = 0;
+      }
+      objs[ 1 ] = astAnnul( objs[ 1 ] );
+   }
+
+   return ok && astOK;
+}
+
+static int Threads( void ){
+   AstObject *objs[ NTHREAD ];
+   int i;
+   int ok;
+   pthread_t threads[ NTHREAD ];
+   void *result;
+
+   ok = 1;
+
+/* Create and annul Objects in several threads at once. Each thread
+   exports one Object from its context, unlocks it, and returns its
+   identifier. */
+   for( i = 0; i < NTHREAD; i++ ) {
+      if( pthread_create( threads + i, NULL, Worker, (void *) (size_t) i ) ) {
+         printf( "Error creating thread\n" );
+         ok = 0;
+         break;
+      }
+   }
+   while( i-- > 0 ) {
+      if( pthread_join( threads[ i ], &result ) || !result ) {
+         ok = 0;
+      } else {
+         objs[ i ] = result;
+      }
+   }
+
+/* The exported Objects can be used in this thread once they are locked. */
+   for( i = 0; i < NTHREAD && ok; i++ ) {
+      astLock( objs[ i ], 0 );
+      if( !CheckId( objs[ i ], i, "Object exported by thread" ) ) ok = 0;
+      objs[ i ] = astAnnul( objs[ i ] );
+   }
+
+   return ok && astOK;
+}
+
+static void *Worker( void *data ){
+   AstObject *objs[ NOBJ ];
+   AstObject *result;
+   int i;
+   int j;
+   int ok;
+   int value;
+
+   ok = 1;
+   value = (int) (size_t) data;
+   result = NULL;
+
+/* Repeatedly create and delete more Objects than fit in one slab. */
+   for( j = 0; j < 3 && ok; j++ ) {
+      astBegin;
+      for( i = 0; i < NOBJ && astOK; i++ ) {
+         objs[ i ] = (AstObject *) astUnitMap( 1, "ID=%d", i + value*NOBJ );
+      }
+      for( i = 0; i < NOBJ && ok; i++ ) {
+         if( !CheckId( objs[ i ], i + value*NOBJ, "Object in thread" ) ) ok = 0;
+      }
+
+/* On the last pass, export an Object from the context. */
+      if( ok && j == 2 ) {
+         result = astCopy( objs[ 0 ] );
+         astSetI( result, "ID", value );
+         astExport( result );
+      }
+      astEnd;
+
+      for( i = value; i < NOBJ && ok; i += NTHREAD*STRIDE ) {
+         if( !CheckInvalid( objs[ i ], "identifier after astEnd in thread" ) ) {
+            ok = 0;
+         }
+      }
+   }
+
+/* Unlock the exported Object so that the main thread can use it. */
+   if( ok && result ) {
+      if( !CheckId( result, value, "exported Object in thread" ) ) {
+         ok = 0;
+      } else {
+         astUnlock( result, 1 );
+      }
+   }
+
+   return ( ok && astOK ) ? (void *) result : NULL;
+}
@@ -0,0 +1,492 @@
+#include "ast.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NBLOCK 400
+#define NCALL 200
+#define NPOINT 20
+#define NSHARE 100
+#define NTHREAD 4
+
+static AstMapping *MakeMapping( void );
+static int Depot( void );
+static void *DepotWorker( void * );
+static int Transform( AstMapping *, int );
+static int Scratch( const char * );
+static void *ScratchWorker( void * );
+static int Share( void );
+static void *ShareWorker( void * );
+static int SharePolyMap( void );
+static int SameTransform( AstMapping *, AstMapping *, int, const char * );
+
+int main(){
+   int ok;
+   pthread_t thread;
+   void *result;
+
+   ok = 1;
+   astBegin;
+
+/* Each public astTran<X> function uses a scratch memory context, within
+   which freed memory blocks are cached even if the MemoryCaching tuning
+   parameter is zero. Check that the cache is emptied, and nothing is
+   left in the shared depot, when the context ends. */
+   if( !Scratch( "main thread" ) ) ok = 0;
+
+/* Do the same in a separate thread, which exits afterwards. */
+   if( ok ) {
+      if( pthread_create( &thread, NULL, ScratchWorker, NULL ) ||
+          pthread_join( thread, &result ) ) {
+         printf( "Error running scratch memory thread\n" );
+         ok = 0;
+      } else if( !result ) {
+         ok = 0;
+      }
+   }
+
+/* Memory blocks freed by one thread should be re-usable by another. */
+   if( ok && !Depot() ) ok = 0;
+
+/* Memory that is shared between owners using astShare. */
+   if( ok && !Share() ) ok = 0;
+   if( ok && !SharePolyMap() ) ok = 0;
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All memory tests passed\n");
+   } else {
+      printf("Memory tests failed\n");
+   }
+}
+
+static AstMapping *MakeMapping( void ){
+   AstMapping *result;
+   double shift[ 2 ] = { 10.0, -5.0 };
+   double ina[ 2 ] = { 0.0, 0.0 };
+   double inb[ 2 ] = { 1.0, 1.0 };
+   double outa[ 2 ] = { 1.0, 2.0 };
+   double outb[ 2 ] = { 3.0, 5.0 };
+   int i;
+
+/* A CmpMap containing several Mappings in series. Each astTran2 call
+   creates and annuls temporary PointSets for each component. */
+   result = (AstMapping *) astZoomMap( 2, 2.0, " " );
+   for( i = 0; i < 4; i++ ) {
+      result = (AstMapping *) astCmpMap( result, astShiftMap( 2, shift, " " ),
+                                         1, " " );
+      result = (AstMapping *) astCmpMap( result, astWinMap( 2, ina, inb, outa,
+                                                            outb, " " ),
+                                         1, " " );
+   }
+   return result;
+}
+
+static int Transform( AstMapping *map, int ncall ){
+   double xin[ NPOINT ];
+   double xout[ NPOINT ];
+   double yin[ NPOINT ];
+   double yout[ NPOINT ];
+   int i;
+
+   for( i = 0; i < NPOINT; i++ ) {
+      xin[ i ] = i;
+      yin[ i ] = 2*i;
+   }
+
+   for( i = 0; i < ncall && astOK; i++ ) {
+      astTran2( map, NPOINT, xin, yin, 1, xout, yout );
+   }
+
+   return astOK;
+}
+
+static int Scratch( const char *text ){
+   AstMapping *map;
+   size_t ndepot0;
+   size_t ndepot;
+   size_t nbyte;
+   size_t nhit;
+
+   if( !astOK ) return 0;
+
+   astBegin;
+   map = MakeMapping();
+
+/* Get the amount of memory in the cache and depot before transforming
+   any points. */
+   if( astMemCaching( AST__TUNULL ) ) {
+      printf( "%s: memory caching is on by default\n", text );
+      return 0;
+   }
+   astMemoryCacheStats( 1, NULL, NULL, &nbyte, &ndepot0 );
+   if( nbyte ) {
+      printf( "%s: memory cache contains %zu bytes at the start\n", text,
+              nbyte );
+      return 0;
+   }
+
+/* Transform points many times. Memory freed within each call should be
+   re-used within the same call. */
+   if( !Transform( map, NCALL ) ) return 0;
+   astMemoryCacheStats( 1, &nhit, NULL, &nbyte, &ndepot );
+   if( nhit == 0 ) {
+      printf( "%s: no memory was re-used within astTran2\n", text );
+      return 0;
+   }
+
+/* The cache and depot should hold the same as before. */
+   if( nbyte ) {
+      printf( "%s: memory cache retains %zu bytes after astTran2\n", text,
+              nbyte );
+      return 0;
+   }
+   if( ndepot != ndepot0 ) {
+      printf( "%s: depot holds %zu bytes after astTran2 (should be %zu)\n",
+              text, ndepot, ndepot0 );
+      return 0;
+   }
+
+/* If caching is switched on, freed memory should be retained in the cache
+   after each call, but discarded when caching is switched off again. */
+   astMemCaching( 1 );
+   if( !Transform( map, NCALL ) ) return 0;
+   astMemoryCacheStats( 1, NULL, NULL, &nbyte, NULL );
+   if( !nbyte ) {
+      printf( "%s: memory cache is empty when caching is on\n", text );
+      return 0;
+   }
+   astMemCaching( 0 );
+   astMemoryCacheStats( 1, NULL, NULL, &nbyte, &ndepot );
+   if( nbyte || ndepot ) {
+      printf( "%s: memory cache (%zu bytes) or depot (%zu bytes) not "
+              "emptied when caching is switched off\n", text, nbyte,
+              ndepot );
+      return 0;
+   }
+
+   astEnd;
+   return astOK;
+}
+
+static void *ScratchWorker( void *data ){
+   return Scratch( "worker thread" ) ? (void *) 1 : NULL;
+}
+
+static int Depot( void ){
+   int ok;
+   pthread_t thread;
+   size_t stats[ 5 ];
+   size_t ndepot0;
+   void *result;
+
+   if( !astOK ) return 0;
+   ok = 1;
+
+/* In one thread, allocate and then free more memory blocks of the same
+   size than the thread's cache can hold. The excess should be passed to
+   the shared depot. */
+   stats[ 0 ] = 0;
+   if( pthread_create( &thread, NULL, DepotWorker, stats ) ||
+       pthread_join( thread, &result ) || !result ) {
+      printf( "Error running memory depot thread\n" );
+      return 0;
+   }
+   if( stats[ 3 ] <= stats[ 4 ] ) {
+      printf( "No memory passed to the depot by the first thread\n" );
+      return 0;
+   }
+   astMemoryCacheStats( 0, NULL, NULL, NULL, &ndepot0 );
+
+/* In a second thread, allocate blocks of the same size. Some of them
+   should be taken from the depot, and so be counted as cache hits. */
+   stats[ 0 ] = 1;
+   if( pthread_create( &thread, NULL, DepotWorker, stats ) ||
+       pthread_join( thread, &result ) || !result ) {
+      printf( "Error running memory depot thread\n" );
+      return 0;
+   }
+   if( stats[ 1 ] == 0 || stats[ 1 ] + stats[ 2 ] != NBLOCK ) {
+      printf( "Second thread had %zu cache hits and %zu misses for %d "
+              "allocations\n", stats[ 1 ], stats[ 2 ], NBLOCK );
+      ok = 0;
+/* The depot should have shrunk by the size of the blocks taken from it,
+   each of which is at least as big as requested. */
+   } else if( stats[ 3 ] >= ndepot0 ||
+              ( ndepot0 - stats[ 3 ] ) % stats[ 1 ] ||
+              ( ndepot0 - stats[ 3 ] )/stats[ 1 ] < 100 ) {
+      printf( "Depot went from %zu to %zu bytes after %zu cache hits in the "
+              "second thread\n", ndepot0, stats[ 3 ], stats[ 1 ] );
+      ok = 0;
+
+/* Switching caching off in the second thread should have emptied the
+   depot. */
+   } else if( stats[ 4 ] != 0 ) {
+      printf( "Depot holds %zu bytes after caching was switched off\n",
+              stats[ 4 ] );
+      ok = 0;
+   }
+
+   return ok && astOK;
+}
+
+static void *DepotWorker( void *data ){
+   char *blocks[ NBLOCK ];
+   int i;
+   size_t *stats;
+
+/* Switch caching on in this thread, get the number of bytes in the
+   depot, and allocate the blocks. */
+   stats = (size_t *) data;
+   astMemCaching( 1 );
+   astMemoryCacheStats( 1, NULL, NULL, NULL, stats + 4 );
+   for( i = 0; i < NBLOCK; i++ ) blocks[ i ] = astMalloc( 100 );
+
+/* In the first thread, free the blocks and return the number of bytes
+   in the depot afterwards. */
+   if( stats[ 0 ] == 0 ) {
+      for( i = 0; i < NBLOCK; i++ ) blocks[ i ] = astFree( blocks[ i ] );
+      astMemoryCacheStats( 1, NULL, NULL, NULL, stats + 3 );
+
+/* In the second thread, return the numbers of hits and misses, and the
+   number of bytes in the depot after the blocks were allocated. Then
+   free them and switch caching off. */
+   } else {
+      astMemoryCacheStats( 1, stats + 1, stats + 2, NULL, stats + 3 );
+      for( i = 0; i < NBLOCK; i++ ) blocks[ i ] = astFree( blocks[ i ] );
+      astMemCaching( 0 );
+      astMemoryCacheStats( 1, NULL, NULL, NULL, stats + 4 );
+   }
+
+   return astOK ? (void *) 1 : NULL;
+}
+
+static int Share( void ){
+   int *p;
+   int *q;
+   int *r;
+   int i;
+   int ok;
+   pthread_t threads[ NTHREAD ];
+   void *result;
+
+   if( !astOK ) return 0;
+   ok = 1;
+
+   p = astMalloc( NSHARE*sizeof( *p ) );
+   if( !p ) return 0;
+   for( i = 0; i < NSHARE; i++ ) p[ i ] = i;
+
+/* astShare returns the supplied pointer. astUnshare then returns a private
+   copy, which can be modified without changing the original. */
+   q = astShare( p );
+   r = astUnshare( q );
+   if( q != p || r == p ) {
+      printf( "astShare or astUnshare returned the wrong pointer\n" );
+      ok = 0;
+   } else {
+      r[ 0 ] = -1;
+      for( i = 1; i < NSHARE && r[ i ] == i; i++ );
+      if( p[ 0 ] != 0 || i < NSHARE ) {
+         printf( "Wrong values in shared memory after astUnshare\n" );
+         ok = 0;
+      }
+   }
+   r = astFree( r );
+
+/* The original now has a single owner, so astUnshare should return it
+   without copying it. */
+   if( ok && astUnshare( p ) != p ) {
+      printf( "astUnshare copied memory that is not shared\n" );
+      ok = 0;
+   }
+
+/* Freeing shared memory leaves it available to its other owners. */
+   if( ok ) {
+      q = astShare( p );
+      p = astFree( p );
+      for( i = 0; i < NSHARE && q[ i ] == i; i++ );
+      if( i < NSHARE ) {
+         printf( "Shared memory changed when one owner freed it\n" );
+         ok = 0;
+      }
+      p = q;
+   }
+
+/* astRealloc returns private memory if the supplied memory is shared. */
+   if( ok ) {
+      q = astShare( p );
+      q = astRealloc( q, 2*NSHARE*sizeof( *q ) );
+      if( q == p ) {
+         printf( "astRealloc did not copy shared memory\n" );
+         ok = 0;
+      } else {
+         for( i = 0; i < NSHARE; i++ ) q[ i ] = -i;
+         for( i = 1; i < NSHARE && p[ i ] == i; i++ );
+         if( i < NSHARE ) {
+            printf( "Shared memory changed by astRealloc\n" );
+            ok = 0;
+         }
+      }
+      q = astFree( q );
+   }
+
+/* Share the memory with several threads at once. Each thread modifies and
+   frees its own copy. */
+   if( ok ) {
+      for( i = 0; i < NTHREAD; i++ ) {
+         if( pthread_create( threads + i, NULL, ShareWorker, astShare( p ) ) ) {
+            printf( "Error creating shared memory thread\n" );
+            ok = 0;
+            break;
+         }
+      }
+      while( i-- > 0 ) {
+         if( pthread_join( threads[ i ], &result ) || !result ) ok = 0;
+      }
+      if( ok ) {
+         for( i = 0; i < NSHARE && p[ i ] == i; i++ );
+         if( i < NSHARE ) {
+            printf( "Shared memory changed by another thread\n" );
+            ok = 0;
+         } else if( astUnshare( p ) != p ) {
+            printf( "Memory still shared after all threads have freed it\n" );
+            ok = 0;
+         }
+      }
+   }
+
+   p = astFree( p );
+   return ok && astOK;
+}
+
+static void *ShareWorker( void *data ){
+   int *p;
+   int i;
+   int j;
+   int ok;
+
+   ok = 1;
+   for( j = 0; j < NCALL && ok; j++ ) {
+      p = astShare( data );
+      p = astUnshare( p );
+      for( i = 0; i < NSHARE; i++ ) p[ i ] = -p[ i ];
+      p = astFree( p );
+      if( !astOK ) ok = 0;
+   }
+   data = astFree( data );
+   return ( ok && astOK ) ? (void *) 1 : NULL;
+}
+
+static int SharePolyMap( void ){
+   AstMapping *pm;
+   AstMapping *pm2;
+   AstMapping *pm3;
+   AstMapping *pm4;
+   double coeff[ 5*4 ] = { 1.0, 1, 0, 0,     /* X = 1 + x + 0.01*x*y */
+                           1.0, 1, 1, 0,
+                           0.01, 1, 1, 1,
+                           2.0, 2, 0, 1,     /* Y = 2*y - 0.002*x*x */
+                           -0.002, 2, 2, 0 };
+   double lbnd[ 2 ] = { 0.0, 0.0 };
+   double ubnd[ 2 ] = { 10.0, 10.0 };
+   int ok;
+
+   if( !astOK ) return 0;
+
+   ok = 1;
+   astBegin;
+
+/* A copy of a PolyMap shares its coefficient arrays with the original. */
+   pm = (AstMapping *) astPolyMap( 2, 2, 5, coeff, 0, NULL, " " );
+   pm2 = astCopy( pm );
+   if( !astEqual( pm, pm2 ) ) {
+      printf( "Copied PolyMap differs from the original\n" );
+      ok = 0;
+   }
+
+/* Fit an inverse transformation to the copy. This replaces the inverse
+   coefficients in a new PolyMap, and should leave the original and the
+   copy unchanged. */
+   if( ok ) {
+      pm3 = (AstMapping *) astPolyTran( pm2, 0, 1.0E-8, 1.0E-6, 6, lbnd,
+                                        ubnd );
+      if( !pm3 ) {
+         printf( "astPolyTran failed to create an inverse\n" );
+         ok = 0;
+      } else if( !astEqual( pm, pm2 ) || astEqual( pm2, pm3 ) ) {
+         printf( "astPolyTran changed the PolyMap it was given\n" );
+         ok = 0;
+      } else if( !SameTransform( pm, pm2, 0, "copied PolyMap" ) ||
+                 !SameTransform( pm, pm3, 1, "PolyMap from astPolyTran" ) ) {
+         ok = 0;
+      }
+   }
+
+/* Do the same with the original, then annul it. The copy should be
+   unaffected. */
+   if( ok ) {
+      pm4 = (AstMapping *) astPolyTran( pm, 0, 1.0E-8, 1.0E-6, 6, lbnd,
+                                        ubnd );
+      if( !astEqual( pm3, pm4 ) ) {
+         printf( "Different inverse fitted to the original PolyMap\n" );
+         ok = 0;
+      } else {
+         pm = astAnnul( pm );
+         pm = (AstMapping *) astPolyMap( 2, 2, 5, coeff, 0, NULL, " " );
+         if( !astEqual( pm, pm2 ) ||
+             !SameTransform( pm, pm2, 0, "copy of annulled PolyMap" ) ||
+             !SameTransform( pm, pm3, 1, "inverse of annulled PolyMap" ) ) {
+            ok = 0;
+         }
+      }
+   }
+
+   astEnd;
+   return ok && astOK;
+}
+
+static int SameTransform( AstMapping *map1, AstMapping *map2, int inverse,
+                          const char *text ){
+   double xin[ NPOINT ];
+   double xout1[ NPOINT ];
+   double xout2[ NPOINT ];
+   double yin[ NPOINT ];
+   double yout1[ NPOINT ];
+   double yout2[ NPOINT ];
+   int i;
+
+   if( !astOK ) return 0;
+
+   for( i = 0; i < NPOINT; i++ ) {
+      xin[ i ] = 0.5*i;
+      yin[ i ] = 10.0 - 0.4*i;
+   }
+   astTran2( map1, NPOINT, xin, yin, 1, xout1, yout1 );
+   astTran2( map2, NPOINT, xin, yin, 1, xout2, yout2 );
+   for( i = 0; i < NPOINT && astOK; i++ ) {
+      if( xout1[ i ] != xout2[ i ] || yout1[ i ] != yout2[ i ] ) {
+         printf( "%s: forward transformation differs at point %d\n", text,
+                 i + 1 );
+         return 0;
+      }
+   }
+
+/* If required, check the inverse transformation of the second Mapping
+   reverses the forward transformation. */
+   if( inverse ) {
+      astTran2( map2, NPOINT, xout2, yout2, 0, xout1, yout1 );
+      for( i = 0; i < NPOINT && astOK; i++ ) {
+         if( fabs( xout1[ i ] - xin[ i ] ) > 1.0E-5 ||
+             fabs( yout1[ i ] - yin[ i ] ) > 1.0E-5 ) {
+            printf( "%s: inverse transformation wrong at point %d\n", text,
+                    i + 1 );
+            return 0;
+         }
+      }
+   }
+
+   return astOK;
+}
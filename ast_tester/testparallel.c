@@ -0,0 +1,256 @@
+#define astCLASS testparallel
+#define THREAD_SAFE 1
+
+#include "ast_err.h"
+#include "error.h"
+#include "memory.h"
+#include "object.h"
+#include "parallel.h"
+#include "mapping.h"
+#include "cmpmap.h"
+#include "mathmap.h"
+#include "polymap.h"
+#include "winmap.h"
+#include <stdio.h>
+#include <string.h>
+
+#define GRAIN 256
+#define MXMSG 2000
+#define NPOINT 100000
+#define NTHREAD 4
+
+/* Data passed to Chunk by astParallelFor. */
+typedef struct JobData {
+   AstMapping **maps;
+   AstDim bad;
+   double *xin;
+   double *xout;
+   double *yin;
+   double *yout;
+   int *nvisit;
+} JobData;
+
+static char messages[ MXMSG ];
+
+static AstMapping *MakeMapping( int * );
+static int Run( AstMapping *, JobData *, int, AstDim, int * );
+static void Chunk( int, AstDim, AstDim, void *, int * );
+static void PutErr( int, const char * );
+
+int main(){
+   int status_value = 0;
+   int *status = &status_value;
+   AstMapping *map;
+   JobData job;
+   AstDim i;
+   char *serial_messages;
+   double *x;
+   double *y;
+   int serial_status;
+   int status2;
+   int threads;
+
+   astSetPutErr( PutErr );
+
+/* A Mapping with a forward transformation that takes a significant time,
+   and some input positions. */
+   map = MakeMapping( status );
+   job.xin = astMalloc( sizeof( double )*NPOINT );
+   job.yin = astMalloc( sizeof( double )*NPOINT );
+   job.xout = astMalloc( sizeof( double )*NPOINT );
+   job.yout = astMalloc( sizeof( double )*NPOINT );
+   job.nvisit = astMalloc( sizeof( int )*NPOINT );
+   x = astMalloc( sizeof( double )*NPOINT );
+   y = astMalloc( sizeof( double )*NPOINT );
+   serial_messages = astMalloc( MXMSG );
+   if( astOK ) {
+      for( i = 0; i < NPOINT; i++ ) {
+         job.xin[ i ] = ( i % 1000 )*0.01 - 5.0;
+         job.yin[ i ] = ( i / 1000 )*0.1 - 5.0;
+      }
+   }
+
+/* Transform all points in a single call. */
+   astTran2( map, NPOINT, job.xin, job.yin, 1, x, y );
+
+/* Transform them using astParallelFor with the "Threads" tuning
+   parameter set to one, and then with several threads. Both should give
+   exactly the same results as the single call. */
+   threads = astTune( "Threads", 1 );
+   if( !Run( map, &job, 1, -1, status ) ||
+       memcmp( job.xout, x, sizeof( double )*NPOINT ) ||
+       memcmp( job.yout, y, sizeof( double )*NPOINT ) ) {
+      astError( AST__INTER, "Error 1\n", status );
+   }
+
+   if( !Run( map, &job, NTHREAD, -1, status ) ||
+       memcmp( job.xout, x, sizeof( double )*NPOINT ) ||
+       memcmp( job.yout, y, sizeof( double )*NPOINT ) ) {
+      astError( AST__INTER, "Error 2\n", status );
+   }
+
+/* Report an error when processing one point, first in the calling
+   thread, and then using several threads. The same status and messages
+   should be returned in the calling thread in both cases. */
+   if( astOK ) {
+      Run( map, &job, 1, NPOINT/2 + 17, status );
+      serial_status = *status;
+      strcpy( serial_messages, messages );
+      astClearStatus;
+
+      Run( map, &job, NTHREAD, NPOINT/2 + 17, status );
+      status2 = *status;
+      astClearStatus;
+
+      if( serial_status != AST__BADIN ) {
+         astError( AST__INTER, "Error 3\n", status );
+      } else if( status2 != serial_status ) {
+         astError( AST__INTER, "Error 4\n", status );
+      } else if( !messages[ 0 ] || strcmp( messages, serial_messages ) ) {
+         astError( AST__INTER, "Error 5\n", status );
+      }
+   }
+
+/* The pool should still be usable after a failure. */
+   if( astOK ) {
+      if( !Run( map, &job, NTHREAD, -1, status ) ||
+          memcmp( job.xout, x, sizeof( double )*NPOINT ) ||
+          memcmp( job.yout, y, sizeof( double )*NPOINT ) ) {
+         astError( AST__INTER, "Error 6\n", status );
+      }
+   }
+
+   astTune( "Threads", threads );
+   map = astAnnul( map );
+   job.xin = astFree( job.xin );
+   job.yin = astFree( job.yin );
+   job.xout = astFree( job.xout );
+   job.yout = astFree( job.yout );
+   job.nvisit = astFree( job.nvisit );
+   x = astFree( x );
+   y = astFree( y );
+   serial_messages = astFree( serial_messages );
+
+   if( astOK ) {
+      printf(" All astParallelFor tests passed\n");
+   } else {
+      printf("astParallelFor tests failed\n");
+   }
+}
+
+static void Chunk( int ithread, AstDim lo, AstDim hi, void *data,
+                   int *status ){
+   AstMapping *map;
+   JobData *job;
+   AstDim i;
+
+   if( !astOK ) return;
+
+/* Worker threads use their own copy of the Mapping, which must be locked
+   while it is used. */
+   job = (JobData *) data;
+   map = job->maps[ ithread ];
+   if( ithread > 0 ) astManageLock( map, AST__LOCK, 1, NULL );
+
+   astTran2( map, hi - lo, job->xin + lo, job->yin + lo, 1, job->xout + lo,
+             job->yout + lo );
+   for( i = lo; i < hi; i++ ) job->nvisit[ i ]++;
+
+/* Report an error if the chunk contains the point that is to fail. */
+   if( job->bad >= lo && job->bad < hi ) {
+      astError( AST__BADIN, "Chunk: Failed to transform point %d.", status,
+                (int) job->bad );
+   }
+
+   if( ithread > 0 ) astManageLock( map, AST__UNLOCK, 1, NULL );
+}
+
+static AstMapping *MakeMapping( int *status ){
+   AstMapping *result;
+   const char *fwd[ 2 ] = { "r = sqrt( x*x + y*y )",
+                            "t = atan2( y, x )*exp( -0.1*x )" };
+   const char *inv[ 2 ] = { "x", "y" };
+   double coeff[ 16 ] = { 1.0, 1, 1, 0,  0.01, 1, 2, 1,
+                          1.0, 2, 0, 1,  0.02, 2, 1, 2 };
+   double ina[ 2 ] = { -5.0, -5.0 };
+   double inb[ 2 ] = { 5.0, 5.0 };
+   double outa[ 2 ] = { 0.0, 0.0 };
+   double outb[ 2 ] = { 1.0, 2.0 };
+
+   result = (AstMapping *) astCmpMap(
+               astWinMap( 2, ina, inb, outa, outb, " ", status ),
+               astCmpMap( astPolyMap( 2, 2, 4, coeff, 0, NULL, " ", status ),
+                          astMathMap( 2, 2, 2, fwd, 2, inv, " ", status ),
+                          1, " ", status ),
+               1, " ", status );
+   return result;
+}
+
+static void PutErr( int status_value, const char *message ){
+   size_t len;
+
+/* Append each error message to the buffer. */
+   len = strlen( messages );
+   if( len + strlen( message ) + 2 < MXMSG ) {
+      sprintf( messages + len, "%s\n", message );
+   }
+}
+
+static int Run( AstMapping *map, JobData *job, int threads, AstDim bad,
+                int *status ){
+   AstDim i;
+   AstDim nbad;
+   int ithread;
+   int nthread;
+
+   if( !astOK ) return 0;
+
+/* Find the number of threads to use, as the library does. */
+   astTune( "Threads", threads );
+   nthread = astParallelSize( NPOINT, GRAIN );
+   if( nthread != threads ) return 0;
+
+/* Clear the results and messages. */
+   for( i = 0; i < NPOINT; i++ ) {
+      job->xout[ i ] = AST__BAD;
+      job->yout[ i ] = AST__BAD;
+      job->nvisit[ i ] = 0;
+   }
+   messages[ 0 ] = 0;
+
+/* Create an unlocked copy of the Mapping for each worker thread. */
+   job->maps = astMalloc( sizeof( AstMapping * )*nthread );
+   if( astOK ) {
+      job->maps[ 0 ] = map;
+      for( ithread = 1; ithread < nthread; ithread++ ) {
+         job->maps[ ithread ] = astCopy( map );
+         astManageLock( job->maps[ ithread ], AST__UNLOCK, 1, NULL );
+      }
+   }
+
+/* Process all the points. */
+   job->bad = bad;
+   astParallelFor( nthread, NPOINT, GRAIN, Chunk, job );
+
+/* Lock and annul the copies. */
+   if( job->maps ) {
+      for( ithread = 1; ithread < nthread; ithread++ ) {
+         astManageLock( job->maps[ ithread ], AST__LOCK, 1, NULL );
+         job->maps[ ithread ] = astAnnul( job->maps[ ithread ] );
+      }
+      job->maps = astFree( job->maps );
+   }
+
+/* If no error was reported, each point should have been transformed
+   exactly once. If an error was reported, points may have been left
+   untransformed, but none more than once, and the failed point must
+   have been transformed. */
+   nbad = 0;
+   for( i = 0; i < NPOINT; i++ ) {
+      if( job->nvisit[ i ] != 1 ) nbad++;
+      if( job->nvisit[ i ] > 1 ) nbad = NPOINT + 1;
+   }
+
+   if( bad < 0 ) return ( nbad == 0 && astOK );
+   return ( nbad <= NPOINT && job->nvisit[ bad ] == 1 );
+}
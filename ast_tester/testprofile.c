@@ -0,0 +1,201 @@
+#include "ast.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MXLINE 200
+#define NPOINT 1000
+
+typedef struct Line {
+   const char *text;
+   unsigned long ncall;
+   double npoint;
+} Line;
+
+static int Find( const char *, const char *, unsigned long, double, int );
+static int ReadReport( const char *, char [][ 200 ], int );
+
+static char lines[ MXLINE ][ 200 ];
+static int nline;
+
+int main(){
+   AstChannel *ch;
+   AstMapping *map;
+   AstObject *obj;
+   const Line tree[] = { { "Transform(CmpMap)", 2, 2*NPOINT },
+                         { "  Transform(ZoomMap)", 2, 2*NPOINT },
+                         { "  Transform(PolyMap)", 2, 2*NPOINT },
+                         { "Write(Channel)", 1, 0 },
+                         { "  Write(Channel)", 2, 0 },
+                         { "Read(Channel)", 1, 0 },
+                         { "  Read(Channel)", 2, 0 },
+                         { NULL, 0, 0 } };
+   const Line totals[] = { { "Transform(CmpMap)", 2, 2*NPOINT },
+                           { "Transform(ZoomMap)", 2, 2*NPOINT },
+                           { "Transform(PolyMap)", 2, 2*NPOINT },
+                           { "Write(Channel)", 3, 0 },
+                           { "Read(Channel)", 3, 0 },
+                           { NULL, 0, 0 } };
+   double coeff[ 8 ] = { 1.0, 1, 1, 0,  0.5, 2, 0, 2 };
+   double xin[ NPOINT ];
+   double xout[ NPOINT ];
+   double yin[ NPOINT ];
+   double yout[ NPOINT ];
+   int i;
+   int itot;
+   int ok;
+   int profile;
+
+   ok = 1;
+   astBegin;
+
+/* A CmpMap that is not simplified when it is used. */
+   map = (AstMapping *) astCmpMap( astZoomMap( 2, 2.0, " " ),
+                                   astPolyMap( 2, 2, 2, coeff, 0, NULL, " " ),
+                                   1, " " );
+   for( i = 0; i < NPOINT; i++ ) {
+      xin[ i ] = i;
+      yin[ i ] = -i;
+   }
+
+/* Enable profiling, transform the points twice, and write the CmpMap
+   to a Channel and read it back. */
+   profile = astTune( "Profile", 1 );
+   astTran2( map, NPOINT, xin, yin, 1, xout, yout );
+   astTran2( map, NPOINT, xin, yin, 1, xout, yout );
+   ch = astChannel( NULL, NULL, "SinkFile=testprofile.ast" );
+   astWrite( ch, map );
+   ch = astAnnul( ch );
+   ch = astChannel( NULL, NULL, "SourceFile=testprofile.ast" );
+   obj = astRead( ch );
+   ch = astAnnul( ch );
+   remove( "testprofile.ast" );
+   if( !obj || !astEqual( obj, map ) ) {
+      printf( "CmpMap was not read back correctly\n" );
+      ok = 0;
+   }
+
+/* Calls made after profiling is disabled should not be recorded. */
+   astTune( "Profile", 0 );
+   astTran2( map, NPOINT, xin, yin, 1, xout, yout );
+
+/* The text report should contain the tree of calls, with the calls for
+   the component Mappings indented beneath the call for the CmpMap, and
+   then the totals for each function and class. */
+   astProfileReport( "testprofile.txt", 0 );
+   nline = ReadReport( "testprofile.txt", lines, MXLINE );
+   for( itot = 0; itot < nline; itot++ ) {
+      if( strstr( lines[ itot ], "Totals" ) ) break;
+   }
+   if( itot == nline ) {
+      printf( "No totals in the profile report\n" );
+      ok = 0;
+   }
+
+   for( i = 0; tree[ i ].text && ok; i++ ) {
+      if( !Find( tree[ i ].text, "tree", tree[ i ].ncall, tree[ i ].npoint,
+                 0 ) ) ok = 0;
+   }
+   for( i = 0; totals[ i ].text && ok; i++ ) {
+      if( !Find( totals[ i ].text, "totals", totals[ i ].ncall,
+                 totals[ i ].npoint, itot ) ) ok = 0;
+   }
+
+/* The JSON report should contain an event for each node in the tree. */
+   if( ok ) {
+      astProfileReport( "testprofile.json", 1 );
+      nline = ReadReport( "testprofile.json", lines, MXLINE );
+      if( nline < 1 || strncmp( lines[ 0 ], "{\"traceEvents\":[", 16 ) ) {
+         printf( "JSON profile report has the wrong format\n" );
+         ok = 0;
+      }
+      for( i = 0; tree[ i ].text && ok; i++ ) {
+         if( !Find( tree[ i ].text + strspn( tree[ i ].text, " " ), "JSON",
+                    0, 0.0, 0 ) ) ok = 0;
+      }
+   }
+
+/* Enabling profiling again should discard the previous results. */
+   if( ok ) {
+      astTune( "Profile", 1 );
+      astTune( "Profile", 0 );
+      astProfileReport( "testprofile.txt", 0 );
+      nline = ReadReport( "testprofile.txt", lines, MXLINE );
+      for( i = 0; i < nline && ok; i++ ) {
+         if( strstr( lines[ i ], "Transform" ) ) {
+            printf( "Profile results were not discarded\n" );
+            ok = 0;
+         }
+      }
+   }
+   remove( "testprofile.txt" );
+   remove( "testprofile.json" );
+
+/* A report that cannot be written should give an error. */
+   if( ok && astOK ) {
+      astProfileReport( "no-such-directory/testprofile.txt", 0 );
+      if( astStatus != AST__WRERR ) {
+         printf( "No error writing profile report to a bad file\n" );
+         ok = 0;
+      }
+      astClearStatus;
+   }
+
+   astTune( "Profile", profile );
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All profiling tests passed\n");
+   } else {
+      printf("Profiling tests failed\n");
+   }
+}
+
+static int Find( const char *text, const char *section, unsigned long ncall,
+                 double npoint, int ifirst ){
+   double npnt;
+   double time;
+   int i;
+   int nc;
+   unsigned long nalloc;
+   unsigned long ncl;
+
+/* Find the first line at or after "ifirst" that contains the given
+   function and class. In a text report, each line contains the numbers
+   of calls, points, times and allocations, followed by two spaces and
+   then the function and class, indented to show their depth. */
+   for( i = ifirst; i < nline; i++ ) {
+      if( section[ 0 ] == 'J' ) {
+         if( strstr( lines[ i ], text ) ) return 1;
+
+      } else if( sscanf( lines[ i ], "%lu %lf %lf %lf %lu%n", &ncl, &npnt,
+                         &time, &time, &nalloc, &nc ) == 5 &&
+                 !strncmp( lines[ i ] + nc, "  ", 2 ) &&
+                 !strcmp( lines[ i ] + nc + 2, text ) ) {
+         if( ncl != ncall || npnt != npoint ) {
+            printf( "Profile %s: wrong counts for %s: %s\n", section,
+                    text, lines[ i ] );
+            return 0;
+         }
+         return 1;
+      }
+   }
+
+   printf( "Profile %s: %s not found\n", section, text );
+   return 0;
+}
+
+static int ReadReport( const char *file, char lines[][ 200 ], int mxline ){
+   FILE *fd;
+   int n;
+
+   n = 0;
+   fd = fopen( file, "r" );
+   if( fd ) {
+      while( n < mxline && fgets( lines[ n ], 200, fd ) ) {
+         lines[ n ][ strcspn( lines[ n ], "\n" ) ] = 0;
+         n++;
+      }
+      fclose( fd );
+   }
+   return n;
+}
@@ -0,0 +1,831 @@
+#include "ast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define NX 100
+#define NY 100
+#define NRAND 70001
+#define NPLIST 500
+#define NBIG 400
+
+static double Random( void );
+static int CheckPoints( AstRegion *, int, int, const double *, int );
+static int CheckMask( AstRegion *, int );
+static int CheckThreads( AstRegion *, int );
+static int CheckOverlap( AstRegion *, AstRegion *, int, int );
+static int CheckPointList( AstFrame *, int, const double *, int, int,
+                           const double *, int );
+static int CheckMapCache( int, int, const double *, int );
+static AstRegion *MakeRegion( AstFrame *, int );
+
+int main(){
+   AstCmpFrame *cfrm;
+   AstFrame *frm1;
+   AstFrame *frm;
+   AstMatrixMap *rot;
+   AstRegion *circ;
+   AstRegion *ell;
+   AstRegion *ell2;
+   AstRegion *reg[ 8 ];
+   AstRegion *tmp;
+   double a[ 2 ];
+   double b[ 2 ];
+   double poly[ 2 ][ 5 ] = { { 10.3, 80.6, 90.2, 45.5, 5.1 },
+                             { 12.4, 8.7, 60.3, 95.8, 70.2 } };
+   double pl[ 2 ][ 4 ] = { { 20.0, 50.0, AST__BAD, 70.0 },
+                           { 30.0, AST__BAD, AST__BAD, 40.0 } };
+   double *grid;
+   double *rand;
+   double ang;
+   double mat[ 4 ];
+   double r;
+   double ratio[ 4 ] = { 1.0, 1.0 + 1.0E-10, 1.0 + 1.0E-6, 1.5 };
+   double ovtest[ 4 ][ 13 ] = {
+      { 11.523754186663449, 5.1087576681748033, 1.6466109473258257,
+        1.8667632956057787, 1.9684355990029871, -9.2665816377848387,
+        3.517552874982357, 4.8435284215956926, -0.66589673575550368,
+        1.2137158277076145, -1.2137158277076145, -0.66589673575550368, 4 },
+      { 4.3379213223883948, 3.8256716839969158, -1.9462948478758335,
+        0.19363904744386673, 0.62437110207974911, 2.3048177361488342,
+        1.2991124857217073, 9.1567138461396098, 0.68310209341084238,
+        0.6954340561630501, -0.6954340561630501, 0.68310209341084238, 2 },
+      { 4.7002549289258946, 2.3754762411117554, -0.63445344381034374,
+        -0.45526516810059547, 4.1224418156780303, -4.5426866877824068,
+        1.0810189321637154, 8.7557594310492277, 0.044165476407602239,
+        1.4898591547083939, -1.4898591547083939, 0.044165476407602239, 2 },
+      { 6.4833912919282364, 4.8503799289464951, -1.473724564537406,
+        0.11688960529863834, 3.8571615633554757, 3.9315104577690363,
+        -3.8379252888262272, 1.4773789206519723, -1.0345942734773315,
+        -1.0725476035279793, 1.0725476035279793, -1.0345942734773315, 1 } };
+   int i;
+   int iang;
+   int iratio;
+   int itest;
+   int ireg;
+   int nreg;
+
+   frm = astFrame( 2, " " );
+
+/* Create a Region of each class that has its own astPointsInRegion
+   implementation. */
+   nreg = 0;
+   a[ 0 ] = 40.3;
+   a[ 1 ] = 55.7;
+   b[ 0 ] = 75.9;
+   b[ 1 ] = 20.1;
+   reg[ nreg++ ] = (AstRegion *) astBox( frm, 1, a, b, NULL, " " );
+
+   a[ 0 ] = 50.2;
+   a[ 1 ] = 48.9;
+   r = 30.35;
+   reg[ nreg++ ] = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+
+   a[ 0 ] = 45.1;
+   a[ 1 ] = 52.3;
+   b[ 0 ] = 35.2;
+   b[ 1 ] = 15.7;
+   r = 0.6;
+   reg[ nreg++ ] = (AstRegion *) astEllipse( frm, 1, a, b, &r, NULL, " " );
+
+   reg[ nreg++ ] = (AstRegion *) astPolygon( frm, 5, 5, (double *) poly,
+                                             NULL, " " );
+
+   a[ 0 ] = 10.5;
+   a[ 1 ] = AST__BAD;
+   b[ 0 ] = 60.5;
+   b[ 1 ] = 70.5;
+   reg[ nreg++ ] = (AstRegion *) astInterval( frm, a, b, NULL, " " );
+
+   tmp = astCopy( reg[ 3 ] );
+   astNegate( tmp );
+   reg[ nreg++ ] = (AstRegion *) astCmpRegion( reg[ 1 ], tmp, AST__AND,
+                                               " " );
+   tmp = astAnnul( tmp );
+
+   reg[ nreg ] = astCopy( reg[ 0 ] );
+   astNegate( reg[ nreg++ ] );
+
+   a[ 0 ] = 5.0;
+   a[ 1 ] = 5.0;
+   b[ 0 ] = 0.0;
+   b[ 1 ] = 0.0;
+   tmp = (AstRegion *) astBox( frm, 1, b, a, NULL, " " );
+   reg[ nreg++ ] = (AstRegion *) astPointList( frm, 4, 2, 4, (double *) pl,
+                                               tmp, " " );
+   tmp = astAnnul( tmp );
+
+/* Create the coordinates of the centres of a grid of pixels, and a set of
+   random positions, some of which have a bad value on one or both axes. */
+   grid = astMalloc( sizeof( double )*2*NX*NY );
+   rand = astMalloc( sizeof( double )*2*NRAND );
+   if( astOK ) {
+      for( i = 0; i < NX*NY; i++ ) {
+         grid[ i ] = 1 + i % NX;
+         grid[ i + NX*NY ] = 1 + i / NX;
+      }
+      for( i = 0; i < 2*NRAND; i++ ) {
+         rand[ i ] = -10.0 + 120.0*Random();
+         if( Random() < 0.03 ) rand[ i ] = AST__BAD;
+      }
+   }
+
+/* Check each Region. */
+   for( ireg = 0; ireg < nreg && astOK; ireg++ ) {
+      if( !CheckPoints( reg[ ireg ], NX*NY, NX*NY, grid, 100 + 10*ireg ) ) {
+         break;
+      }
+      if( !CheckPoints( reg[ ireg ], NRAND, NRAND, rand, 200 + 10*ireg ) ) {
+         break;
+      }
+      if( !CheckPoints( reg[ ireg ], NRAND - 3, NRAND, rand, 300 + 10*ireg ) ) {
+         break;
+      }
+
+/* astMask<X> cannot be used with PointLists, since the mask would be
+   empty. */
+      if( !astIsAPointList( reg[ ireg ] ) ) {
+         if( !CheckMask( reg[ ireg ], 400 + 10*ireg ) ) break;
+      }
+
+/* Points tested and pixels masked by several threads should give the
+   same results as a single thread. */
+      if( !CheckThreads( reg[ ireg ], 1500 + 10*ireg ) ) break;
+   }
+
+/* Check bad argument values are reported. */
+   if( astOK ) {
+      unsigned char mask[ 1 ];
+      astPointsInRegion( reg[ 0 ], 2, 2, 1, grid, 0, mask );
+      if( astStatus != AST__DIMIN ) {
+         if( astOK ) astError( AST__INTER, "Error 1\n" );
+      } else {
+         astClearStatus;
+      }
+      astPointsInRegion( reg[ 0 ], 2, 2, 1, grid, AST__INTERLEAVED, mask );
+      if( astStatus != AST__DIMIN ) {
+         if( astOK ) astError( AST__INTER, "Error 2\n" );
+      } else {
+         astClearStatus;
+      }
+   }
+
+/* Check PointLists that do and do not use a KD-tree to find the list
+   positions close to each test point give the expected results. The
+   KD-tree is used only for PointLists containing at least 8 positions
+   within a basic Frame. Some of the list positions have bad values. */
+   if( astOK ) {
+      double *plist = astMalloc( sizeof( double )*2*NPLIST );
+      if( astOK ) {
+         for( i = 0; i < 2*NPLIST; i++ ) {
+            plist[ i ] = 100.0*Random();
+            if( Random() < 0.05 ) plist[ i ] = AST__BAD;
+         }
+         frm1 = astFrame( 1, " " );
+         cfrm = astCmpFrame( frm1, frm1, " " );
+         CheckPointList( frm, NPLIST, plist, NRAND, NRAND, rand, 600 );
+         CheckPointList( (AstFrame *) cfrm, NPLIST, plist, NRAND, NRAND, rand,
+                         610 );
+         CheckPointList( frm, 5, plist, NRAND, NRAND, rand, 620 );
+         CheckPointList( frm, NPLIST, plist, NX*NY, NX*NY, grid, 630 );
+         cfrm = astAnnul( cfrm );
+         frm1 = astAnnul( frm1 );
+      }
+      plist = astFree( plist );
+   }
+
+/* Check that Regions created by astMapRegion give the same results
+   whether or not the base Frame mesh and grid were already cached in the
+   Region being mapped. */
+   for( ireg = 0; ireg < 6 && astOK; ireg++ ) {
+      if( !CheckMapCache( ireg, NRAND, rand, 700 + 10*ireg ) ) break;
+   }
+
+   grid = astFree( grid );
+   rand = astFree( rand );
+
+/* Check the overlap between rotated and nearly circular ellipses, and
+   circles that have been rotated using astMapRegion. Each test is
+   performed with the Regions in both orders. */
+   for( iratio = 0; iratio < 4 && astOK; iratio++ ) {
+      for( iang = 0; iang < 12 && astOK; iang++ ) {
+         ang = iang*AST__DPI/12.0;
+         a[ 0 ] = 0.0;
+         a[ 1 ] = 0.0;
+         b[ 0 ] = 10.0*ratio[ iratio ];
+         b[ 1 ] = 10.0;
+         ell = (AstRegion *) astEllipse( frm, 1, a, b, &ang, NULL, " " );
+
+         mat[ 0 ] = cos( ang + 0.3 );
+         mat[ 1 ] = -sin( ang + 0.3 );
+         mat[ 2 ] = -mat[ 1 ];
+         mat[ 3 ] = mat[ 0 ];
+         rot = astMatrixMap( 2, 2, 0, mat, " " );
+
+/* A circle inside the ellipse. */
+         a[ 0 ] = 1.0;
+         a[ 1 ] = 1.0;
+         r = 5.0;
+         tmp = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+         circ = astMapRegion( tmp, rot, frm );
+         CheckOverlap( ell, circ, 3, 500 + 10*iang + 200*iratio );
+         tmp = astAnnul( tmp );
+         circ = astAnnul( circ );
+
+/* A circle enclosing the ellipse. */
+         r = 20.0;
+         tmp = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+         circ = astMapRegion( tmp, rot, frm );
+         CheckOverlap( ell, circ, 2, 502 + 10*iang + 200*iratio );
+         tmp = astAnnul( tmp );
+         circ = astAnnul( circ );
+
+/* A circle that does not touch the ellipse. */
+         a[ 0 ] = 30.0;
+         a[ 1 ] = 0.0;
+         r = 3.0;
+         tmp = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+         circ = astMapRegion( tmp, rot, frm );
+         CheckOverlap( ell, circ, 1, 504 + 10*iang + 200*iratio );
+         tmp = astAnnul( tmp );
+         circ = astAnnul( circ );
+
+/* A circle that crosses the boundary of the ellipse. */
+         a[ 0 ] = 10.0;
+         r = 5.0;
+         tmp = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+         circ = astMapRegion( tmp, rot, frm );
+         CheckOverlap( ell, circ, 4, 506 + 10*iang + 200*iratio );
+         tmp = astAnnul( tmp );
+         circ = astAnnul( circ );
+
+/* A smaller, differently rotated, ellipse inside the first. */
+         a[ 0 ] = 0.5;
+         a[ 1 ] = -0.5;
+         b[ 0 ] = 6.0*ratio[ iratio ];
+         b[ 1 ] = 4.0;
+         r = ang + 1.0;
+         ell2 = (AstRegion *) astEllipse( frm, 1, a, b, &r, NULL, " " );
+         CheckOverlap( ell, ell2, 3, 508 + 10*iang + 200*iratio );
+         ell2 = astAnnul( ell2 );
+
+         rot = astAnnul( rot );
+         ell = astAnnul( ell );
+      }
+   }
+
+/* Some specific ellipses and circles, each rotated, scaled and shifted
+   using astMapRegion, for which the two argument orders previously gave
+   inconsistent results. Each row of "ovtest" holds the ellipse axes,
+   centre and orientation, the circle centre and radius, the matrix used
+   to map the circle, and the expected astOverlap value. */
+   for( itest = 0; itest < 4 && astOK; itest++ ) {
+      ell = (AstRegion *) astEllipse( frm, 1, ovtest[ itest ] + 2,
+                                      ovtest[ itest ],
+                                      ovtest[ itest ] + 4, NULL, " " );
+      tmp = (AstRegion *) astCircle( frm, 1, ovtest[ itest ] + 5,
+                                     ovtest[ itest ] + 7, NULL, " " );
+      rot = astMatrixMap( 2, 2, 0, ovtest[ itest ] + 8, " " );
+      circ = astMapRegion( tmp, rot, frm );
+      CheckOverlap( ell, circ, (int) ovtest[ itest ][ 12 ], 1400 + 10*itest );
+      circ = astAnnul( circ );
+      rot = astAnnul( rot );
+      tmp = astAnnul( tmp );
+      ell = astAnnul( ell );
+   }
+
+   if( astOK ) {
+      printf(" All Region tests passed\n");
+   } else {
+      printf("Region tests failed\n");
+   }
+}
+
+static double Random( void ) {
+/* Return a pseudo-random number in the range [0,1), the same on all
+   platforms. */
+   static unsigned int seed = 12345;
+   seed = seed*1103515245 + 12345;
+   return ( ( seed >> 8 ) & 0xFFFFFF )/16777216.0;
+}
+
+static int CheckPoints( AstRegion *reg, int npoint, int indim,
+                        const double *in, int ierr ){
+/* Check astPointsInRegion gives the same results as astTranN for the
+   supplied axis-major array of positions, with each combination of
+   flags. Returns zero if an error has occurred. */
+
+   double *inter;
+   double *out;
+   int expect;
+   int flags;
+   int i;
+   int icoord;
+   int nin;
+   int result;
+   int set;
+   unsigned char *mask;
+   unsigned char *expect_mask;
+
+   if( !astOK ) return 0;
+
+   out = astMalloc( sizeof( double )*2*npoint );
+   inter = astMalloc( sizeof( double )*3*npoint );
+   expect_mask = astMalloc( npoint );
+   mask = astMalloc( npoint + 1 );
+   if( astOK ) {
+
+/* Get the expected results using astTranN. */
+      astTranN( reg, npoint, 2, indim, in, 1, 2, npoint, out );
+      nin = 0;
+      for( i = 0; i < npoint; i++ ) {
+         expect_mask[ i ] = ( out[ i ] != AST__BAD &&
+                              out[ i + npoint ] != AST__BAD );
+         if( expect_mask[ i ] ) nin++;
+      }
+
+/* Store the positions with the coordinates of each point together, with
+   one unused element after each point. */
+      for( i = 0; i < npoint; i++ ) {
+         for( icoord = 0; icoord < 2; icoord++ ) {
+            inter[ 3*i + icoord ] = in[ i + icoord*indim ];
+         }
+         inter[ 3*i + 2 ] = 0.0;
+      }
+
+/* Test each combination of flags. */
+      for( flags = 0; flags < 4 && astOK; flags++ ) {
+         memset( mask, 0xff, npoint + 1 );
+         if( flags & AST__INTERLEAVED ) {
+            result = astPointsInRegion( reg, npoint, 2, 3, inter, flags,
+                                        mask );
+         } else {
+            result = astPointsInRegion( reg, npoint, 2, indim, in, flags,
+                                        mask );
+         }
+
+         if( result != nin && astOK ) {
+            astError( AST__INTER, "Error %d (%s, flags %d: %d != %d)\n",
+                      ierr + 1, astGetC( reg, "Class" ), flags, result, nin );
+         }
+
+         for( i = 0; i < npoint && astOK; i++ ) {
+            if( flags & AST__BYTEMASK ) {
+               set = mask[ i ];
+            } else {
+               set = ( mask[ i/8 ] >> ( i%8 ) ) & 1;
+            }
+            if( set != expect_mask[ i ] ) {
+               astError( AST__INTER, "Error %d (%s, flags %d, point %d)\n",
+                         ierr + 2, astGetC( reg, "Class" ), flags, i );
+            }
+         }
+
+/* Unused bits in the last element of a bit mask should be cleared, and
+   no elements beyond the end of the mask should be changed. */
+         if( astOK ) {
+            if( flags & AST__BYTEMASK ) {
+               expect = ( mask[ npoint ] == 0xff );
+            } else {
+               expect = ( npoint % 8 == 0 ||
+                          ( mask[ npoint/8 ] >> ( npoint%8 ) ) == 0 ) &&
+                        mask[ ( npoint + 7 )/8 ] == 0xff;
+            }
+            if( !expect ) {
+               astError( AST__INTER, "Error %d (%s, flags %d)\n",
+                         ierr + 3, astGetC( reg, "Class" ), flags );
+            }
+         }
+      }
+   }
+
+   out = astFree( out );
+   inter = astFree( inter );
+   expect_mask = astFree( expect_mask );
+   mask = astFree( mask );
+
+   return astOK;
+}
+
+static int CheckMask( AstRegion *reg, int ierr ){
+/* Check astPointsInRegion gives the same results as astMaskUB for the
+   centres of a grid of pixels. Returns zero if an error has occurred. */
+
+   double *in;
+   int i;
+   int lbnd[ 2 ] = { 1, 1 };
+   int nmask;
+   int nin;
+   int ubnd[ 2 ] = { NX, NY };
+   unsigned char *data;
+   unsigned char *mask;
+
+   if( !astOK ) return 0;
+
+   in = astMalloc( sizeof( double )*2*NX*NY );
+   data = astMalloc( NX*NY );
+   mask = astMalloc( NX*NY );
+   if( astOK ) {
+      for( i = 0; i < NX*NY; i++ ) {
+         in[ 2*i ] = 1 + i % NX;
+         in[ 2*i + 1 ] = 1 + i / NX;
+         data[ i ] = 0;
+      }
+
+      nmask = astMaskUB( reg, NULL, 1, 2, lbnd, ubnd, data, 1 );
+      nin = astPointsInRegion( reg, NX*NY, 2, 2, in,
+                               AST__INTERLEAVED | AST__BYTEMASK, mask );
+
+      if( nmask != nin && astOK ) {
+         astError( AST__INTER, "Error %d (%s: %d != %d)\n", ierr + 1,
+                   astGetC( reg, "Class" ), nmask, nin );
+      }
+      if( astOK && memcmp( data, mask, NX*NY ) ) {
+         astError( AST__INTER, "Error %d (%s)\n", ierr + 2,
+                   astGetC( reg, "Class" ) );
+      }
+   }
+
+   in = astFree( in );
+   data = astFree( data );
+   mask = astFree( mask );
+
+   return astOK;
+}
+
+static int CheckThreads( AstRegion *reg, int ierr ){
+/* Check astPointsInRegion and astMaskUB give the same results using one
+   thread and several threads, for a grid that is large enough to be
+   divided between the threads. Returns zero if an error has occurred. */
+
+   AstMapping *map;
+   double *in;
+   double ina[ 2 ] = { -10.0, -10.0 };
+   double inb[ 2 ] = { 110.0, 110.0 };
+   double outa[ 2 ] = { 0.0, 0.0 };
+   double outb[ 2 ] = { NBIG, NBIG };
+   int flags;
+   int i;
+   int ipass;
+   int lbnd[ 2 ] = { 1, 1 };
+   int nin[ 2 ];
+   int nmask[ 2 ];
+   int npoint;
+   int threads;
+   int ubnd[ 2 ] = { NBIG, NBIG };
+   unsigned char *data[ 2 ];
+   unsigned char *mask[ 2 ];
+
+   if( !astOK ) return 0;
+
+   npoint = NBIG*NBIG;
+   in = astMalloc( sizeof( double )*2*npoint );
+   for( ipass = 0; ipass < 2; ipass++ ) {
+      data[ ipass ] = astMalloc( npoint );
+      mask[ ipass ] = astMalloc( npoint );
+   }
+
+/* The Mapping from the Region's coordinates to the pixel coordinates of
+   the grid. */
+   map = (AstMapping *) astWinMap( 2, ina, inb, outa, outb, " " );
+
+/* The coordinates at the centre of each pixel in the grid. Some points
+   have a bad value on one axis. */
+   if( astOK ) {
+      for( i = 0; i < npoint; i++ ) {
+         in[ i ] = -10.0 + 120.0*( i % NBIG + 0.5 )/NBIG;
+         in[ i + npoint ] = -10.0 + 120.0*( i / NBIG + 0.5 )/NBIG;
+         if( i % 997 == 0 ) in[ i + ( i % 2 )*npoint ] = AST__BAD;
+      }
+   }
+
+/* Test each combination of flags, and mask the grid, first using one
+   thread and then using several. */
+   threads = astTune( "Threads", 1 );
+   for( flags = 0; flags < 2 && astOK; flags++ ) {
+      for( ipass = 0; ipass < 2 && astOK; ipass++ ) {
+         astTune( "Threads", ipass ? 4 : 1 );
+         memset( mask[ ipass ], 0, npoint );
+         nin[ ipass ] = astPointsInRegion( reg, npoint, 2, npoint, in,
+                                           flags ? AST__BYTEMASK : 0,
+                                           mask[ ipass ] );
+
+/* astMask<X> cannot be used with PointLists (see main). */
+         memset( data[ ipass ], 0, npoint );
+         nmask[ ipass ] = 0;
+         if( !astIsAPointList( reg ) ) {
+            nmask[ ipass ] = astMaskUB( reg, map, flags, 2, lbnd, ubnd,
+                                        data[ ipass ], 1 );
+         }
+      }
+
+      if( !astOK ) {
+      } else if( nin[ 0 ] != nin[ 1 ] ) {
+         astError( AST__INTER, "Error %d (%s, flags %d: %d != %d)\n",
+                   ierr + 1, astGetC( reg, "Class" ), flags, nin[ 1 ],
+                   nin[ 0 ] );
+      } else if( memcmp( mask[ 0 ], mask[ 1 ], npoint ) ) {
+         astError( AST__INTER, "Error %d (%s, flags %d)\n", ierr + 2,
+                   astGetC( reg, "Class" ), flags );
+      } else if( nmask[ 0 ] != nmask[ 1 ] ) {
+         astError( AST__INTER, "Error %d (%s, inside %d: %d != %d)\n",
+                   ierr + 3, astGetC( reg, "Class" ), flags, nmask[ 1 ],
+                   nmask[ 0 ] );
+      } else if( memcmp( data[ 0 ], data[ 1 ], npoint ) ) {
+         astError( AST__INTER, "Error %d (%s, inside %d)\n", ierr + 4,
+                   astGetC( reg, "Class" ), flags );
+      }
+   }
+   astTune( "Threads", threads );
+
+   map = astAnnul( map );
+   in = astFree( in );
+   for( ipass = 0; ipass < 2; ipass++ ) {
+      data[ ipass ] = astFree( data[ ipass ] );
+      mask[ ipass ] = astFree( mask[ ipass ] );
+   }
+
+   return astOK;
+}
+
+static int CheckOverlap( AstRegion *reg1, AstRegion *reg2, int expect,
+                         int ierr ){
+/* Check astOverlap gives the expected value for two Regions, and the
+   corresponding value when the order of the Regions is reversed.
+   Returns zero if an error has occurred. */
+
+   int result;
+   int swapped[ 7 ] = { 0, 1, 3, 2, 4, 5, 6 };
+
+   if( !astOK ) return 0;
+
+   result = astOverlap( reg1, reg2 );
+   if( result != expect && astOK ) {
+      astError( AST__INTER, "Error %d (%d != %d)\n", ierr, result, expect );
+   }
+
+   result = astOverlap( reg2, reg1 );
+   if( result != swapped[ expect ] && astOK ) {
+      astError( AST__INTER, "Error %d (%d != %d)\n", ierr + 1, result,
+                swapped[ expect ] );
+   }
+
+   return astOK;
+}
+
+static int CheckPointList( AstFrame *frm, int nlist, const double *list,
+                           int npoint, int indim, const double *in,
+                           int ierr ){
+/* Check astPointsInRegion and astTranN give the expected results for
+   a PointList containing the supplied positions, with a Box uncertainty
+   Region. A point is expected to be inside the PointList if it is
+   inside the uncertainty Box centred on any list position that has no
+   bad axis values. Returns zero if an error has occurred. */
+
+   AstPointList *pl;
+   AstRegion *unc;
+   double *lpos;
+   double *out;
+   double a[ 2 ] = { 0.0, 0.0 };
+   double b[ 2 ] = { 1.5, 0.8 };
+   int expect;
+   int i;
+   int j;
+   int nin;
+   int result;
+   unsigned char *mask;
+
+   if( !astOK ) return 0;
+
+   lpos = astMalloc( sizeof( double )*2*nlist );
+   out = astMalloc( sizeof( double )*2*npoint );
+   mask = astMalloc( npoint );
+   if( astOK ) {
+      for( i = 0; i < nlist; i++ ) {
+         lpos[ i ] = list[ i ];
+         lpos[ i + nlist ] = list[ i + NPLIST ];
+      }
+
+      unc = (AstRegion *) astBox( frm, 0, a, b, NULL, " " );
+      pl = astPointList( frm, nlist, 2, nlist, lpos, unc, " " );
+
+      nin = astPointsInRegion( pl, npoint, 2, indim, in, AST__BYTEMASK,
+                               mask );
+      astTranN( pl, npoint, 2, indim, in, 1, 2, npoint, out );
+
+      result = 0;
+      for( i = 0; i < npoint && astOK; i++ ) {
+         expect = 0;
+         if( in[ i ] != AST__BAD && in[ i + indim ] != AST__BAD ) {
+            for( j = 0; j < nlist && !expect; j++ ) {
+               if( lpos[ j ] != AST__BAD && lpos[ j + nlist ] != AST__BAD &&
+                   fabs( in[ i ] - lpos[ j ] ) < b[ 0 ] &&
+                   fabs( in[ i + indim ] - lpos[ j + nlist ] ) < b[ 1 ] ) {
+                  expect = 1;
+               }
+            }
+         }
+         if( expect ) result++;
+
+         if( mask[ i ] != expect ) {
+            astError( AST__INTER, "Error %d (%s, point %d: %d != %d)\n",
+                      ierr + 1, astGetC( frm, "Class" ), i, mask[ i ],
+                      expect );
+         } else if( expect != ( out[ i ] != AST__BAD &&
+                                out[ i + npoint ] != AST__BAD ) ) {
+            astError( AST__INTER, "Error %d (%s, point %d)\n", ierr + 2,
+                      astGetC( frm, "Class" ), i );
+         }
+      }
+
+      if( result != nin && astOK ) {
+         astError( AST__INTER, "Error %d (%s: %d != %d)\n", ierr + 3,
+                   astGetC( frm, "Class" ), nin, result );
+      }
+
+      pl = astAnnul( pl );
+      unc = astAnnul( unc );
+   }
+
+   lpos = astFree( lpos );
+   out = astFree( out );
+   mask = astFree( mask );
+
+   return astOK;
+}
+
+static AstRegion *MakeRegion( AstFrame *frm, int type ){
+/* Create a new Region of the requested type. A new Region is created on
+   each invocation, so no meshes will have been cached in it. */
+
+   AstRegion *circ;
+   AstRegion *poly;
+   AstRegion *result;
+   AstRegion *unc;
+   double a[ 2 ];
+   double b[ 2 ];
+   double r;
+   double vert[ 2 ][ 5 ] = { { 10.3, 80.6, 90.2, 45.5, 5.1 },
+                             { 12.4, 8.7, 60.3, 95.8, 70.2 } };
+   double pl[ 2 ][ 3 ] = { { 20.0, 50.0, 70.0 },
+                           { 30.0, 60.0, 40.0 } };
+
+   result = NULL;
+   a[ 0 ] = 50.2;
+   a[ 1 ] = 48.9;
+   r = 30.35;
+
+   if( type == 0 ) {
+      b[ 0 ] = 75.9;
+      b[ 1 ] = 20.1;
+      result = (AstRegion *) astBox( frm, 1, a, b, NULL, " " );
+
+   } else if( type == 1 ) {
+      result = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+
+   } else if( type == 2 ) {
+      b[ 0 ] = 35.2;
+      b[ 1 ] = 15.7;
+      r = 0.6;
+      result = (AstRegion *) astEllipse( frm, 1, a, b, &r, NULL, " " );
+
+   } else if( type == 3 ) {
+      result = (AstRegion *) astPolygon( frm, 5, 5, (double *) vert, NULL,
+                                         " " );
+
+   } else if( type == 4 ) {
+      circ = (AstRegion *) astCircle( frm, 1, a, &r, NULL, " " );
+      poly = (AstRegion *) astPolygon( frm, 5, 5, (double *) vert, NULL,
+                                       " " );
+      result = (AstRegion *) astCmpRegion( circ, poly, AST__OR, " " );
+      circ = astAnnul( circ );
+      poly = astAnnul( poly );
+
+   } else {
+      a[ 0 ] = 0.0;
+      a[ 1 ] = 0.0;
+      b[ 0 ] = 4.0;
+      b[ 1 ] = 3.0;
+      unc = (AstRegion *) astBox( frm, 0, a, b, NULL, " " );
+      result = (AstRegion *) astPointList( frm, 3, 2, 3, (double *) pl, unc,
+                                           " " );
+      unc = astAnnul( unc );
+   }
+
+   return result;
+}
+
+static int CheckMapCache( int type, int npoint, const double *in,
+                          int ierr ){
+/* Map two identical Regions into a new Frame using astMapRegion, after
+   first creating the base Frame mesh and grid in one of them, but not the
+   other. Check the two mapped Regions have the same mesh and grid, and
+   the same points inside them, both before and after a second call to
+   astMapRegion. Returns zero if an error has occurred. */
+
+   AstFrame *frm;
+   AstMapping *map;
+   AstMapping *map2;
+   AstMatrixMap *mmap;
+   AstRegion *mapped[ 2 ];
+   AstRegion *reg[ 2 ];
+   AstRegion *tmp;
+   AstShiftMap *smap;
+   double *mesh[ 2 ];
+   double mat[ 4 ] = { 0.8, -0.3, 0.4, 1.1 };
+   double shift[ 2 ] = { -20.0, 35.0 };
+   int i;
+   int imap;
+   int isurf;
+   int j;
+   int nin[ 2 ];
+   int npmesh[ 2 ];
+   int ncoord;
+   int nmesh[ 2 ];
+   unsigned char *mask[ 2 ];
+
+   if( !astOK ) return 0;
+
+   frm = astFrame( 2, " " );
+   mmap = astMatrixMap( 2, 2, 0, mat, " " );
+   smap = astShiftMap( 2, shift, " " );
+   map = (AstMapping *) astCmpMap( mmap, smap, 1, " " );
+   map2 = (AstMapping *) astZoomMap( 2, 0.5, " " );
+
+   mask[ 0 ] = astMalloc( npoint );
+   mask[ 1 ] = astMalloc( npoint );
+
+/* Create two identical Regions, and cache the mesh and grid in the
+   first by getting its mesh. */
+   reg[ 0 ] = MakeRegion( frm, type );
+   reg[ 1 ] = MakeRegion( frm, type );
+   for( isurf = 0; isurf < 2; isurf++ ) {
+      astGetRegionMesh( reg[ 0 ], isurf, 0, 2, &npmesh[ 0 ], NULL );
+   }
+
+/* Map both Regions into a new Frame, and then map the results again. */
+   for( i = 0; i < 2; i++ ) mapped[ i ] = astMapRegion( reg[ i ], map, frm );
+
+   for( imap = 0; imap < 2 && astOK; imap++ ) {
+
+/* Compare the meshes and grids. */
+      for( isurf = 0; isurf < 2 && astOK; isurf++ ) {
+         for( i = 0; i < 2; i++ ) {
+            astGetRegionMesh( mapped[ i ], isurf, 0, 2, &nmesh[ i ], NULL );
+            mesh[ i ] = astMalloc( sizeof( double )*2*nmesh[ i ] );
+            astGetRegionMesh( mapped[ i ], isurf, nmesh[ i ], 2, &nmesh[ i ],
+                              mesh[ i ] );
+         }
+
+         if( nmesh[ 0 ] != nmesh[ 1 ] && astOK ) {
+            astError( AST__INTER, "Error %d (%s: %d != %d)\n",
+                      ierr + 1 + imap*4, astGetC( reg[ 0 ], "Class" ),
+                      nmesh[ 0 ], nmesh[ 1 ] );
+         }
+
+         ncoord = 2*nmesh[ 0 ];
+         for( j = 0; j < ncoord && astOK; j++ ) {
+            if( mesh[ 0 ][ j ] != mesh[ 1 ][ j ] ) {
+               astError( AST__INTER, "Error %d (%s, %s value %d)\n",
+                         ierr + 2 + imap*4, astGetC( reg[ 0 ], "Class" ),
+                         isurf ? "mesh" : "grid", j );
+            }
+         }
+
+         for( i = 0; i < 2; i++ ) mesh[ i ] = astFree( mesh[ i ] );
+      }
+
+/* Compare the points inside each mapped Region. */
+      for( i = 0; i < 2; i++ ) {
+         nin[ i ] = astPointsInRegion( mapped[ i ], npoint, 2, npoint, in,
+                                       AST__BYTEMASK, mask[ i ] );
+      }
+      if( astOK && ( nin[ 0 ] != nin[ 1 ] ||
+                     memcmp( mask[ 0 ], mask[ 1 ], npoint ) ) ) {
+         astError( AST__INTER, "Error %d (%s: %d != %d)\n",
+                   ierr + 3 + imap*4, astGetC( reg[ 0 ], "Class" ), nin[ 0 ],
+                   nin[ 1 ] );
+      }
+
+/* Map the mapped Regions again. */
+      for( i = 0; i < 2; i++ ) {
+         tmp = astMapRegion( mapped[ i ], map2, frm );
+         (void) astAnnul( mapped[ i ] );
+         mapped[ i ] = tmp;
+      }
+   }
+
+   for( i = 0; i < 2; i++ ) {
+      mapped[ i ] = astAnnul( mapped[ i ] );
+      reg[ i ] = astAnnul( reg[ i ] );
+      mask[ i ] = astFree( mask[ i ] );
+   }
+   map = astAnnul( map );
+   map2 = astAnnul( map2 );
+   mmap = astAnnul( mmap );
+   smap = astAnnul( smap );
+   frm = astAnnul( frm );
+
+   return astOK;
+}
@@ -0,0 +1,235 @@
+#include "ast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MXTEXT 100000
+#define NCHAN 3
+
+static char text[ MXTEXT ];
+static int ntext;
+static int itext;
+
+static AstChannel *MakeChannel( int, int );
+static AstObject *Read( int );
+static int CheckShared( AstObject *, int, const char * );
+static int Count( const char *, const char * );
+static int Write( int, AstObject *, int, char * );
+static const char *Source( void );
+static void Sink( const char * );
+
+int main(){
+   AstKeyMap *km;
+   AstMapping *cmp;
+   AstMapping *zm;
+   AstObject *copy;
+   AstObject *obj;
+   char *text0;
+   char *text1;
+   char *text2;
+   const char *names[ NCHAN ] = { "Channel", "XmlChan", "YamlChan" };
+   int ichan;
+   int ok;
+
+   ok = 1;
+   text0 = malloc( MXTEXT );
+   text1 = malloc( MXTEXT );
+   text2 = malloc( MXTEXT );
+
+   astBegin;
+
+/* A KeyMap holding a ZoomMap, and a CmpMap that uses the same ZoomMap
+   twice. */
+   zm = (AstMapping *) astZoomMap( 2, 3.0, "Ident=Shared" );
+   cmp = (AstMapping *) astCmpMap( zm, zm, 1, " " );
+   km = astKeyMap( "SortBy=KeyUp" );
+   astMapPut0A( km, "A", cmp, NULL );
+   astMapPut0A( km, "B", zm, NULL );
+
+/* A deep copy of the KeyMap, in which nothing is shared. */
+   copy = astCopy( km );
+
+   for( ichan = 0; ichan < NCHAN && ok; ichan++ ) {
+
+/* With ShareObjects=1, the ZoomMap should be written out once. */
+      if( !Write( ichan, (AstObject *) km, 1, text1 ) ) {
+         printf( "%s: failed to write with ShareObjects=1\n", names[ ichan ] );
+         ok = 0;
+      } else if( Count( text1, "Shared" ) != 1 ) {
+         printf( "%s: shared ZoomMap written %d times with "
+                 "ShareObjects=1\n", names[ ichan ],
+                 Count( text1, "Shared" ) );
+         ok = 0;
+
+/* When read back, the three uses of the ZoomMap should refer to the same
+   Object. */
+      } else {
+         obj = Read( ichan );
+         if( !obj ) {
+            printf( "%s: failed to read ShareObjects=1 output\n",
+                    names[ ichan ] );
+            ok = 0;
+         } else if( !astEqual( obj, km ) ) {
+            printf( "%s: KeyMap read back from ShareObjects=1 output is "
+                    "different\n", names[ ichan ] );
+            ok = 0;
+         } else if( !CheckShared( obj, 1, names[ ichan ] ) ) {
+            ok = 0;
+         }
+      }
+
+/* With ShareObjects=0, the ZoomMap should be written out three times,
+   and the output should be the same as for the copy, in which nothing is
+   shared. When read back, the uses of the ZoomMap should refer to
+   different Objects. */
+      if( ok ) {
+         if( !Write( ichan, (AstObject *) km, 0, text0 ) ||
+             !Write( ichan, copy, 0, text2 ) ) {
+            printf( "%s: failed to write with ShareObjects=0\n",
+                    names[ ichan ] );
+            ok = 0;
+         } else if( Count( text0, "Shared" ) != 3 ) {
+            printf( "%s: shared ZoomMap written %d times with "
+                    "ShareObjects=0\n", names[ ichan ],
+                    Count( text0, "Shared" ) );
+            ok = 0;
+         } else if( strcmp( text0, text2 ) ) {
+            printf( "%s: ShareObjects=0 output differs from the output for "
+                    "unshared Objects\n", names[ ichan ] );
+            ok = 0;
+         } else {
+            obj = Read( ichan );
+            if( !obj || !astEqual( obj, km ) ) {
+               printf( "%s: KeyMap read back from ShareObjects=0 output is "
+                       "different\n", names[ ichan ] );
+               ok = 0;
+            } else if( !CheckShared( obj, 0, names[ ichan ] ) ) {
+               ok = 0;
+            }
+         }
+      }
+   }
+
+   astEnd;
+
+   free( text0 );
+   free( text1 );
+   free( text2 );
+
+   if( astOK && ok ) {
+      printf(" All ShareObjects tests passed\n");
+   } else {
+      printf("ShareObjects tests failed\n");
+   }
+}
+
+static int CheckShared( AstObject *obj, int shared, const char *text ){
+   AstMapping *cmp;
+   AstMapping *map1;
+   AstMapping *map2;
+   AstMapping *zm;
+   int inv1;
+   int inv2;
+   int result;
+   int series;
+
+   if( !astOK ) return 0;
+
+/* Get the two components of the CmpMap, and the separate ZoomMap. */
+   result = 0;
+   if( !astMapGet0A( (AstKeyMap *) obj, "A", &cmp ) ||
+       !astMapGet0A( (AstKeyMap *) obj, "B", &zm ) ) {
+      printf( "%s: Mappings missing from KeyMap read back\n", text );
+   } else {
+      astDecompose( cmp, &map1, &map2, &series, &inv1, &inv2 );
+
+/* They should all be the same Object if, and only if, they were shared. */
+      if( shared ) {
+         result = astSame( map1, map2 ) && astSame( map1, zm );
+      } else {
+         result = !astSame( map1, map2 ) && !astSame( map1, zm ) &&
+                  !astSame( map2, zm );
+      }
+      if( !result ) {
+         printf( "%s: Mappings read back are %sthe same Object\n", text,
+                 shared ? "not " : "" );
+      }
+   }
+
+   return result && astOK;
+}
+
+static int Count( const char *buf, const char *word ){
+   const char *p;
+   int result;
+
+   result = 0;
+   for( p = strstr( buf, word ); p; p = strstr( p + 1, word ) ) result++;
+   return result;
+}
+
+static AstChannel *MakeChannel( int ichan, int share ){
+   AstChannel *result;
+
+   if( ichan == 0 ) {
+      result = astChannel( Source, Sink, "ShareObjects=%d", share );
+   } else if( ichan == 1 ) {
+      result = (AstChannel *) astXmlChan( Source, Sink, "ShareObjects=%d",
+                                          share );
+   } else {
+      result = (AstChannel *) astYamlChan( Source, Sink,
+                                           "YamlEncoding=NATIVE,"
+                                           "ShareObjects=%d", share );
+   }
+   return result;
+}
+
+static AstObject *Read( int ichan ){
+   AstChannel *ch;
+   AstObject *result;
+
+   itext = 0;
+   ch = MakeChannel( ichan, 0 );
+   result = astRead( ch );
+   ch = astAnnul( ch );
+   return result;
+}
+
+static int Write( int ichan, AstObject *obj, int share, char *buf ){
+   AstChannel *ch;
+   int result;
+
+   ntext = 0;
+   text[ 0 ] = 0;
+   ch = MakeChannel( ichan, share );
+   result = astWrite( ch, obj );
+   ch = astAnnul( ch );
+   strcpy( buf, text );
+   return result == 1 && astOK;
+}
+
+static const char *Source( void ){
+   static char line[ MXTEXT ];
+   char *nl;
+   size_t len;
+
+   if( itext >= ntext ) return NULL;
+   nl = strchr( text + itext, '\n' );
+   len = nl - ( text + itext );
+   memcpy( line, text + itext, len );
+   line[ len ] = 0;
+   itext += len + 1;
+   return line;
+}
+
+static void Sink( const char *line ){
+   size_t len;
+
+   len = strlen( line );
+   if( ntext + len + 2 < MXTEXT ) {
+      strcpy( text + ntext, line );
+      ntext += len;
+      text[ ntext++ ] = '\n';
+      text[ ntext ] = 0;
+   }
+}
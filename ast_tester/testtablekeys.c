@@ -0,0 +1,294 @@
+#include "ast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MXTEXT 20000
+
+static char text[ MXTEXT ];
+static int ntext;
+static int itext;
+
+static AstKeyMap *MakeTable( void );
+static void Fill( AstKeyMap *, int );
+static void Fill2( AstKeyMap *, int );
+static int CheckOrder( AstKeyMap *, AstKeyMap *, const char * );
+static int Write( AstObject *, char *, int );
+static AstObject *Read( const char * );
+static int MemCnt( const char * );
+static void Sink( const char * );
+static const char *Source( void );
+
+int main(){
+   AstKeyMap *km;
+   AstKeyMap *t2;
+   AstKeyMap *t;
+   char *text1;
+   char *text2;
+   char *text3;
+   const char *key;
+   const char *sortby[ 4 ] = { "AgeUp", "AgeDown", "KeyAgeUp", "KeyAgeDown" };
+   const char *v1;
+   const char *v2;
+   int i;
+   int ok;
+   int reads;
+   int size;
+
+   ok = 1;
+   text1 = malloc( MXTEXT );
+   text2 = malloc( MXTEXT );
+   text3 = malloc( MXTEXT );
+
+   astBegin;
+
+/* Cells in numerical columns are held in column arrays, but cells with
+   comments, string cells and parameters are held in the parent KeyMap.
+   Apply the same sequence of changes to a Table and a plain KeyMap, and
+   check that every sorting scheme gives the same order of keys. Do it
+   with and without reading the Table in between the changes, since reads
+   should not change the Table. */
+   for( reads = 0; reads < 2 && ok; reads++ ) {
+      for( i = 0; i < 4 && ok; i++ ) {
+         t = MakeTable();
+         km = astKeyMap( "KeyCase=0" );
+         astSet( t, "SortBy=%s", sortby[ i ] );
+         astSet( km, "SortBy=%s", sortby[ i ] );
+
+         Fill( t, reads );
+         Fill( km, 0 );
+         if( !CheckOrder( t, km, sortby[ i ] ) ) ok = 0;
+
+/* Make more changes after the cells have been accessed by index. */
+         Fill2( t, reads );
+         Fill2( km, 0 );
+         if( ok && !CheckOrder( t, km, sortby[ i ] ) ) ok = 0;
+
+         t = astAnnul( t );
+         km = astAnnul( km );
+      }
+   }
+
+/* Writing a Table to a Channel should not change it, so writing it twice
+   should give the same text. */
+   if( ok ) {
+      t = MakeTable();
+      Fill( t, 0 );
+      Write( (AstObject *) t, text1, MXTEXT );
+      Write( (AstObject *) t, text2, MXTEXT );
+      if( strcmp( text1, text2 ) ) {
+         printf( "Writing a Table twice gives different text\n" );
+         ok = 0;
+      }
+   }
+
+/* Read it back, and check the copy has the same member count and the
+   same cell values. */
+   if( ok ) {
+      t2 = (AstKeyMap *) Read( text1 );
+      Write( (AstObject *) t2, text3, MXTEXT );
+      if( MemCnt( text3 ) != MemCnt( text1 ) ) {
+         printf( "MemCnt changes from %d to %d when a Table is re-read\n",
+                 MemCnt( text1 ), MemCnt( text3 ) );
+         ok = 0;
+      }
+
+      size = astMapSize( t );
+      if( astMapSize( t2 ) != size ) {
+         printf( "Re-read Table has %d entries (should be %d)\n",
+                 astMapSize( t2 ), size );
+         ok = 0;
+      }
+
+      for( i = 0; i < size && ok; i++ ) {
+         key = astMapKey( t, i );
+         if( !astMapGet0C( t, key, &v1 ) ) {
+            printf( "Cannot get %s from original Table\n", key );
+            ok = 0;
+         } else {
+            v1 = astStore( NULL, v1, strlen( v1 ) + 1 );
+            if( !astMapGet0C( t2, key, &v2 ) ) {
+               printf( "Cannot get %s from re-read Table\n", key );
+               ok = 0;
+            } else if( strcmp( v1, v2 ) ) {
+               printf( "%s is '%s' in re-read Table (should be '%s')\n",
+                       key, v2, v1 );
+               ok = 0;
+            }
+            v1 = astFree( (void *) v1 );
+         }
+      }
+   }
+
+/* Copying a Table into a KeyMap should not change the Table. */
+   if( ok ) {
+      t = astAnnul( t );
+      t = MakeTable();
+      Fill( t, 0 );
+      Write( (AstObject *) t, text1, MXTEXT );
+      km = astKeyMap( " " );
+      astMapCopy( km, t );
+      astMapCopyEntry( km, "A(4)", t, 0 );
+      Write( (AstObject *) t, text2, MXTEXT );
+      if( strcmp( text1, text2 ) ) {
+         printf( "astMapCopy changes the source Table\n" );
+         ok = 0;
+      } else if( astMapSize( km ) != astMapSize( t ) ) {
+         printf( "astMapCopy copies %d entries from a Table (should be "
+                 "%d)\n", astMapSize( km ), astMapSize( t ) );
+         ok = 0;
+      }
+   }
+
+   astEnd;
+
+   free( text1 );
+   free( text2 );
+   free( text3 );
+
+   if( astOK && ok ) {
+      printf(" All Table key tests passed\n");
+   } else {
+      printf("Table key tests failed\n");
+   }
+}
+
+static AstKeyMap *MakeTable( void ){
+   AstTable *result;
+
+   result = astTable( " " );
+   astAddColumn( result, "A", AST__DOUBLETYPE, 0, NULL, " " );
+   astAddColumn( result, "S", AST__STRINGTYPE, 0, NULL, " " );
+   astAddParameter( result, "P" );
+   return (AstKeyMap *) result;
+}
+
+static void Fill( AstKeyMap *km, int reads ){
+   int ival;
+   AstObject *obj;
+
+   astMapPut0D( km, "A(1)", 1.0, NULL );
+   astMapPut0C( km, "S(1)", "x", NULL );
+   astMapPut0D( km, "A(2)", 2.0, NULL );
+   if( reads ) astMapGet0I( km, "A(1)", &ival );
+   astMapPut0D( km, "A(1)", 3.0, NULL );
+   astMapPut0D( km, "A(3)", 4.0, "A comment" );
+   if( reads ) astMapLenC( km, "A(2)" );
+   astMapPut0C( km, "S(2)", "y", NULL );
+   astMapPut0D( km, "A(2)", 5.0, "Another comment" );
+   astMapPut0D( km, "A(4)", 6.0, NULL );
+   if( reads ) {
+      obj = astCopy( km );
+      obj = astAnnul( obj );
+      Write( (AstObject *) km, text, MXTEXT );
+   }
+   astMapPut0I( km, "P", 7, NULL );
+   astMapPut0D( km, "A(3)", 8.0, NULL );
+   astMapRemove( km, "A(4)" );
+   astMapPut0D( km, "A(5)", 9.0, NULL );
+   astMapPut0D( km, "A(4)", 10.0, NULL );
+}
+
+static void Fill2( AstKeyMap *km, int reads ){
+   int ival;
+
+   astMapPut0D( km, "A(2)", 11.0, NULL );
+   astMapPut0D( km, "A(6)", 12.0, NULL );
+   if( reads ) astMapGet0I( km, "A(6)", &ival );
+   astMapPut0C( km, "S(1)", "z", NULL );
+   astMapPut0D( km, "A(1)", 13.0, NULL );
+}
+
+static int CheckOrder( AstKeyMap *t, AstKeyMap *km, const char *sortby ){
+   const char *key1;
+   const char *key2;
+   int i;
+   int size;
+
+   if( !astOK ) return 0;
+
+   size = astMapSize( km );
+   if( astMapSize( t ) != size ) {
+      printf( "SortBy=%s: Table has %d entries (should be %d)\n",
+              sortby, astMapSize( t ), size );
+      return 0;
+   }
+
+   for( i = 0; i < size; i++ ) {
+      key1 = astMapKey( t, i );
+      key2 = astMapKey( km, i );
+      if( !key1 || !key2 || strcmp( key1, key2 ) ) {
+         printf( "SortBy=%s: key %d is %s (should be %s)\n", sortby, i,
+                 key1 ? key1 : "NULL", key2 ? key2 : "NULL" );
+         return 0;
+      }
+   }
+
+   return astOK;
+}
+
+static int Write( AstObject *obj, char *buf, int mxlen ){
+   AstChannel *ch;
+   int result;
+
+   ntext = 0;
+   text[ 0 ] = 0;
+   ch = astChannel( NULL, Sink, " " );
+   result = astWrite( ch, obj );
+   ch = astAnnul( ch );
+   if( buf != text ) {
+      strncpy( buf, text, mxlen - 1 );
+      buf[ mxlen - 1 ] = 0;
+   }
+   return result;
+}
+
+static AstObject *Read( const char *buf ){
+   AstChannel *ch;
+   AstObject *result;
+
+   strcpy( text, buf );
+   itext = 0;
+   ch = astChannel( Source, NULL, " " );
+   result = astRead( ch );
+   ch = astAnnul( ch );
+   return result;
+}
+
+static int MemCnt( const char *buf ){
+   const char *c;
+   int result;
+
+   result = -1;
+   c = strstr( buf, "MemCnt =" );
+   if( c ) sscanf( c + 8, "%d", &result );
+   return result;
+}
+
+static void Sink( const char *line ){
+   int len;
+
+   len = strlen( line );
+   if( ntext + len + 2 < MXTEXT ) {
+      strcpy( text + ntext, line );
+      ntext += len;
+      text[ ntext++ ] = '\n';
+      text[ ntext ] = 0;
+   }
+}
+
+static const char *Source( void ){
+   static char line[ 200 ];
+   char *eol;
+   int len;
+   int nc;
+
+   if( !text[ itext ] ) return NULL;
+   eol = strchr( text + itext, '\n' );
+   len = eol ? eol - text - itext : (int) strlen( text + itext );
+   nc = ( len > 199 ) ? 199 : len;
+   strncpy( line, text + itext, nc );
+   line[ nc ] = 0;
+   itext += eol ? len + 1 : len;
+   return line;
+}
@@ -0,0 +1,182 @@
+#include "ast.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NCOEFF 2000
+#define NOBJ 6
+
+static int iline;
+static const char **lines;
+
+static AstObject *MakeExpected( int );
+static AstObject *MakePolyMap( void );
+static AstObject *ReadNative( const char * );
+static const char *Source( void );
+
+/* A document holding several AST Objects, some of which contain nested
+   elements with the same names and labels. The third and fourth Objects
+   contain duplicated elements, which should result in an error. */
+static const char *doc[] = {
+   "<CmpMap xmlns=\"http://www.starlink.ac.uk/ast/xml/\">",
+   "  <_attribute name=\"Nin\" value=\"2\"/>",
+   "  <_isa class=\"Mapping\"/>",
+   "  <ZoomMap label=\"MapA\"><_attribute name=\"Nin\" value=\"2\"/><_isa class=\"Mapping\"/><_attribute name=\"Zoom\" value=\"2\"/></ZoomMap>",
+   "  <CmpMap label=\"MapB\">",
+   "    <_attribute name=\"Nin\" value=\"2\"/><_isa class=\"Mapping\"/>",
+   "    <ZoomMap label=\"MapA\"><_attribute name=\"Nin\" value=\"2\"/><_isa class=\"Mapping\"/><_attribute name=\"Zoom\" value=\"3\"/></ZoomMap>",
+   "    <ShiftMap label=\"MapB\"><_attribute name=\"Nin\" value=\"2\"/><_isa class=\"Mapping\"/><_attribute name=\"Sft1\" value=\"1\"/><_attribute name=\"Sft2\" value=\"2\"/></ShiftMap>",
+   "  </CmpMap>",
+   "</CmpMap>",
+   "<KeyMap xmlns=\"http://www.starlink.ac.uk/ast/xml/\">",
+   "  <_attribute name=\"MapSz\" value=\"16\"/><_attribute name=\"MemCnt\" value=\"4\"/>",
+   "  <_attribute name=\"Key1\" value=\"A\"/><_attribute name=\"Typ1\" value=\"4\"/>",
+   "  <KeyMap label=\"Val1\"><_attribute name=\"MapSz\" value=\"16\"/><_attribute name=\"MemCnt\" value=\"2\"/><_attribute name=\"Key1\" value=\"A\"/><_attribute name=\"Typ1\" value=\"1\"/><_attribute name=\"Val1\" value=\"1\"/></KeyMap>",
+   "  <_attribute name=\"Key2\" value=\"B\"/><_attribute name=\"Typ2\" value=\"1\"/><_attribute name=\"Val2\" value=\"2\"/>",
+   "</KeyMap>",
+   "<ZoomMap xmlns=\"http://www.starlink.ac.uk/ast/xml/\"><_attribute name=\"Nin\" value=\"2\"/><_isa class=\"Mapping\"/><_attribute name=\"Zoom\" value=\"4\"/><_attribute name=\"Zoom\" value=\"5\"/></ZoomMap>",
+   "<CmpMap xmlns=\"http://www.starlink.ac.uk/ast/xml/\">",
+   "  <_attribute name=\"Nin\" value=\"1\"/><_isa class=\"Mapping\"/>",
+   "  <ZoomMap label=\"MapA\"><_attribute name=\"Nin\" value=\"1\"/><_isa class=\"Mapping\"/><_attribute name=\"Zoom\" value=\"6\"/></ZoomMap>",
+   "  <ZoomMap label=\"MapA\"><_attribute name=\"Nin\" value=\"1\"/><_isa class=\"Mapping\"/><_attribute name=\"Zoom\" value=\"7\"/></ZoomMap>",
+   "  <UnitMap label=\"MapB\"><_attribute name=\"Nin\" value=\"1\"/><_isa class=\"Mapping\"/></UnitMap>",
+   "</CmpMap>",
+   "<ZoomMap xmlns=\"http://www.starlink.ac.uk/ast/xml/\"><_attribute name=\"Nin\" value=\"3\"/><_isa class=\"Mapping\"/><_attribute name=\"Zoom\" value=\"8\"/></ZoomMap>",
+   "<ShiftMap xmlns=\"http://www.starlink.ac.uk/ast/xml/\"><_attribute name=\"Nin\" value=\"2\"/><_isa class=\"Mapping\"/><_attribute name=\"Sft2\" value=\"5\"/><_attribute name=\"Sft1\" value=\"4\"/></ShiftMap>",
+   NULL
+};
+
+int main(){
+   AstObject *expected;
+   AstObject *obj;
+   AstObject *objs[ 2 ];
+   AstXmlChan *ch;
+   int i;
+   int ok;
+   int status;
+
+   ok = 1;
+   astBegin;
+
+/* Read each Object in the document and compare it with the expected
+   Object. The Objects containing duplicated elements should give an
+   AST__BADIN error, since the second element is not used. */
+   lines = doc;
+   iline = 0;
+   ch = astXmlChan( Source, NULL, " " );
+   for( i = 0; i < NOBJ && ok; i++ ) {
+      obj = astRead( ch );
+      expected = MakeExpected( i );
+      status = astStatus;
+      astClearStatus;
+
+      if( !expected ) {
+         if( obj || status != AST__BADIN ) {
+            printf( "Object %d: no AST__BADIN error for duplicated "
+                    "elements\n", i + 1 );
+            ok = 0;
+         }
+      } else if( status != 0 ) {
+         printf( "Object %d: error %d reading Object\n", i + 1, status );
+         ok = 0;
+      } else if( !obj || !astEqual( obj, expected ) ) {
+         printf( "Object %d: %s read is wrong\n", i + 1,
+                 astGetC( expected, "Class" ) );
+         ok = 0;
+      }
+   }
+
+/* There should be nothing else in the document. */
+   if( ok && astRead( ch ) ) {
+      printf( "Too many Objects read from XML document\n" );
+      ok = 0;
+   }
+   ch = astAnnul( ch );
+
+/* Write a FrameSet and a large PolyMap to a single XML file and read
+   them back. */
+   if( ok ) {
+      objs[ 0 ] = ReadNative( "tanSipWcs.txt" );
+      objs[ 1 ] = MakePolyMap();
+      ch = astXmlChan( NULL, NULL, "SinkFile=testxmlread.xml" );
+      for( i = 0; i < 2; i++ ) astWrite( ch, objs[ i ] );
+      ch = astAnnul( ch );
+
+      ch = astXmlChan( NULL, NULL, "SourceFile=testxmlread.xml" );
+      for( i = 0; i < 2 && ok; i++ ) {
+         obj = astRead( ch );
+         if( !obj || !astEqual( obj, objs[ i ] ) ) {
+            printf( "%s read back from XML is wrong\n",
+                    astGetC( objs[ i ], "Class" ) );
+            ok = 0;
+         }
+      }
+      ch = astAnnul( ch );
+      remove( "testxmlread.xml" );
+   }
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All XmlChan read tests passed\n");
+   } else {
+      printf("XmlChan read tests failed\n");
+   }
+}
+
+static AstObject *MakeExpected( int i ){
+   AstKeyMap *km;
+   AstObject *result;
+   double shift[ 2 ];
+
+   result = NULL;
+   if( i == 0 ) {
+      shift[ 0 ] = 1.0;
+      shift[ 1 ] = 2.0;
+      result = (AstObject *) astCmpMap( astZoomMap( 2, 2.0, " " ),
+                                        astCmpMap( astZoomMap( 2, 3.0, " " ),
+                                                   astShiftMap( 2, shift, " " ),
+                                                   1, " " ),
+                                        1, " " );
+   } else if( i == 1 ) {
+      km = astKeyMap( " " );
+      astMapPut0I( km, "A", 1, NULL );
+      result = (AstObject *) astKeyMap( " " );
+      astMapPut0A( result, "A", km, NULL );
+      astMapPut0I( result, "B", 2, NULL );
+   } else if( i == 4 ) {
+      result = (AstObject *) astZoomMap( 3, 8.0, " " );
+   } else if( i == 5 ) {
+      shift[ 0 ] = 4.0;
+      shift[ 1 ] = 5.0;
+      result = (AstObject *) astShiftMap( 2, shift, " " );
+   }
+   return result;
+}
+
+static AstObject *MakePolyMap( void ){
+   double coeff[ 3*NCOEFF ];
+   int i;
+
+/* A 1-dimensional PolyMap with many coefficients, each of which is held
+   in a separate XML element. */
+   for( i = 0; i < NCOEFF; i++ ) {
+      coeff[ 3*i ] = 1.0/( i + 1 );
+      coeff[ 3*i + 1 ] = 1;
+      coeff[ 3*i + 2 ] = i;
+   }
+   return (AstObject *) astPolyMap( 1, 1, NCOEFF, coeff, 0, NULL, " " );
+}
+
+static AstObject *ReadNative( const char *file ){
+   AstChannel *ch;
+   AstObject *result;
+
+   ch = astChannel( NULL, NULL, "SourceFile=%s", file );
+   result = astRead( ch );
+   ch = astAnnul( ch );
+   return result;
+}
+
+static const char *Source( void ){
+   return lines[ iline ] ? lines[ iline++ ] : NULL;
+}
@@ -0,0 +1,167 @@
+#include "ast.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NPOINT 5
+#define MXTEXT 100000
+
+static AstFrameSet *ReadFile( const char * );
+static AstFrameSet *ReadNative( const char * );
+static int Compare( AstFrameSet *, AstFrameSet *, const char * );
+static int Equal( double, double );
+static int HasBlocks( const char * );
+static int WriteFile( AstFrameSet *, const char *, int );
+
+int main(){
+   AstFrameSet *fs2;
+   AstFrameSet *fs3;
+   AstFrameSet *fs;
+   const char *files[ 2 ] = { "tanSipWcs.txt", "lsst_wcs.txt" };
+   int i;
+   int ok;
+
+   ok = 1;
+   astBegin;
+
+/* Test two FrameSets that include MatrixMaps and PolyMaps. */
+   for( i = 0; i < 2 && ok; i++ ) {
+      fs = ReadNative( files[ i ] );
+
+/* Write it out as ASDF with every array held in a binary block, and check
+   that the file contains binary blocks. */
+      if( !WriteFile( fs, "testyamlblocks.asdf", 2 ) ) {
+         printf( "Failed to write %s using binary blocks\n", files[ i ] );
+         ok = 0;
+      } else if( !HasBlocks( "testyamlblocks.asdf" ) ) {
+         printf( "No binary blocks written for %s\n", files[ i ] );
+         ok = 0;
+      }
+
+/* Read it back and check it transforms positions in the same way as the
+   original FrameSet. */
+      if( ok ) {
+         fs2 = ReadFile( "testyamlblocks.asdf" );
+         if( !Compare( fs, fs2, "binary blocks" ) ) ok = 0;
+      }
+
+/* Do the same with all arrays written inline. The file should contain no
+   binary blocks, and the FrameSet read back should be the same as that
+   read from the binary blocks. */
+      if( ok ) {
+         if( !WriteFile( fs, "testyamlblocks.asdf", 0 ) ) {
+            printf( "Failed to write %s using inline arrays\n", files[ i ] );
+            ok = 0;
+         } else if( HasBlocks( "testyamlblocks.asdf" ) ) {
+            printf( "Binary blocks written when BlockThreshold=0\n" );
+            ok = 0;
+         } else {
+            fs3 = ReadFile( "testyamlblocks.asdf" );
+            if( !Compare( fs, fs3, "inline arrays" ) ) {
+               ok = 0;
+            } else if( !astEqual( fs2, fs3 ) ) {
+               printf( "%s: FrameSets read from inline arrays and binary "
+                       "blocks differ\n", files[ i ] );
+               ok = 0;
+            }
+         }
+      }
+   }
+
+   remove( "testyamlblocks.asdf" );
+
+   astEnd;
+
+   if( astOK && ok ) {
+      printf(" All YamlChan binary block tests passed\n");
+   } else {
+      printf("YamlChan binary block tests failed\n");
+   }
+}
+
+static AstFrameSet *ReadNative( const char *file ){
+   AstChannel *ch;
+   AstFrameSet *result;
+
+   ch = astChannel( NULL, NULL, "SourceFile=%s", file );
+   result = astRead( ch );
+   ch = astAnnul( ch );
+   return result;
+}
+
+static int Compare( AstFrameSet *fs1, AstFrameSet *fs2, const char *text ){
+   double in[ 2 ][ NPOINT ] = { { 1.0, 100.0, 1000.0, 2000.0, 3500.0 },
+                                { 1.0, 200.0, 1500.0, 300.0, 4000.0 } };
+   double out1[ 2 ][ NPOINT ];
+   double out2[ 2 ][ NPOINT ];
+   int i;
+   int j;
+
+   if( !astOK ) return 0;
+
+   if( !fs2 ) {
+      printf( "%s: no FrameSet read\n", text );
+      return 0;
+   }
+
+   astTran2( fs1, NPOINT, in[ 0 ], in[ 1 ], 1, out1[ 0 ], out1[ 1 ] );
+   astTran2( fs2, NPOINT, in[ 0 ], in[ 1 ], 1, out2[ 0 ], out2[ 1 ] );
+
+   for( i = 0; i < NPOINT && astOK; i++ ) {
+      for( j = 0; j < 2; j++ ) {
+         if( !Equal( out1[ j ][ i ], out2[ j ][ i ] ) ) {
+            printf( "%s: axis %d of point %d transformed to %.15g "
+                    "(should be %.15g)\n", text, j + 1, i + 1,
+                    out2[ j ][ i ], out1[ j ][ i ] );
+            return 0;
+         }
+      }
+   }
+
+   return astOK;
+}
+
+static int Equal( double a, double b ){
+   return fabs( a - b ) <= 1.0E-10*( fabs( a ) + fabs( b ) + 1.0 );
+}
+
+static int HasBlocks( const char *file ){
+   FILE *fd;
+   char buf[ MXTEXT ];
+   int result;
+   size_t i;
+   size_t n;
+
+/* Look for the magic bytes at the start of an ASDF binary block. */
+   result = 0;
+   fd = fopen( file, "rb" );
+   if( fd ) {
+      n = fread( buf, 1, MXTEXT, fd );
+      fclose( fd );
+      for( i = 0; i + 4 <= n && !result; i++ ) {
+         if( !memcmp( buf + i, "\323BLK", 4 ) ) result = 1;
+      }
+   }
+   return result;
+}
+
+static AstFrameSet *ReadFile( const char *file ){
+   AstFrameSet *result;
+   AstYamlChan *ch;
+
+   ch = astYamlChan( NULL, NULL, "SourceFile=%s", file );
+   result = astRead( ch );
+   ch = astAnnul( ch );
+   return result;
+}
+
+static int WriteFile( AstFrameSet *fs, const char *file, int threshold ){
+   AstYamlChan *ch;
+   int result;
+
+   ch = astYamlChan( NULL, NULL, "YamlEncoding=ASDF,BlockThreshold=%d,"
+                     "SinkFile=%s", threshold, file );
+   result = astWrite( ch, fs );
+   ch = astAnnul( ch );
+   return result;
+}
@@ -57,6 +57,7 @@ f     The Box class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     22-MAR-2004 (DSB):
@@ -107,6 +108,16 @@ f     The Box class does not define any new routines beyond those
 *        Remove the unused box shrinking facility (a hang over from the
 *        days when the RegBaseGrid function operated by creating multiple
 *        meshes on the surface of the box, shrinking the box each time).
+*     18-OCT-2026 (AGT):
+*        - Override the astRegPointsIn, astRegShape and astRegFixedMesh
+*        methods.
+*        - Use astRegParallel to share the testing of large numbers of
+*        points between several threads in astTransform and
+*        astRegPointsIn.
+*     19-OCT-2026 (AGT):
+*        In TestPoints, ensure that points with a bad value on any axis
+*        are always outside a negated Box, even if an earlier axis value
+*        is outside the box limits.
 *class--
 */
 
@@ -154,6 +165,22 @@ f     The Box class does not define any new routines beyond those
 #include <stdio.h>
 #include <string.h>
 
+/* Type definitions. */
+/* ================= */
+
+/* A structure that describes a set of base Frame positions to be tested
+   by the TestPoints function, and the arrays in which to store the
+   results. */
+typedef struct PointsData {
+   double **ptr_in;     /* Pointers to input base Frame axis values */
+   int ncoord_in;       /* No. of base Frame axes */
+   double **ptr_out;    /* Pointers to output axis values (or NULL) */
+   int ncoord_out;      /* No. of output axes */
+   unsigned char *mask; /* Packed bit mask to receive results (or NULL) */
+   int closed;          /* Is the boundary part of the Region? */
+   int neg;             /* Has the Region been negated? */
+} PointsData;
+
 /* Module Variables. */
 /* ================= */
 
@@ -222,7 +249,11 @@ static double *RegCentre( AstRegion *this, double *, double **, int, int, int *
 static size_t GetObjSize( AstObject *, int * );
 static int MakeGrid( int, double **, int, double *, double *, int *, int, int, double, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
+static AstDim TestPoints( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static int RegShape( AstRegion *, double[2], double[4], double **, int *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void BoxPoints( AstBox *, double *, double *, int *);
 static void Cache( AstBox *, int, int * );
@@ -1243,9 +1274,12 @@ void astInitBoxVtab_(  AstBoxVtab *vtab, const char *name, int *status ) {
    new member functions implemented here. */
    region->RegBaseGrid = RegBaseGrid;
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegBasePick = RegBasePick;
    region->RegBaseBox = RegBaseBox;
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
+   region->RegShape = RegShape;
    region->RegTrace = RegTrace;
    region->RegCentre = RegCentre;
 
@@ -2945,6 +2979,44 @@ static double *RegCentre( AstRegion *this_region, double *cen, double **ptr,
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "box.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Box member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh and grid cached in the Box depend only on the corner
+*     positions and the base Frame, and so can be retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -3209,6 +3281,197 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a Box.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "box.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     Box member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Box, and sets the corresponding bit in the
+*     supplied packed bit mask. The tests are the same as those performed
+*     by the astTransform method, but the axis values are tested directly
+*     without creating any output PointSet.
+
+*  Parameters:
+*     this
+*        Pointer to the Box.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the Box.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the Box.
+
+*/
+
+/* Local Variables: */
+   AstDim npoint;                /* No. of points */
+   AstDim result;                /* Returned number of inside points */
+   AstFrame *frm;                /* Pointer to base Frame in FrameSet */
+   AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
+   PointsData pdata;             /* Description of the points to test */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet. The returned PointSet will usually be a clone
+   of "pset" and so must not be modified. */
+   pset_tmp = astRegTransform( this_region, pset, 0, NULL, &frm );
+   npoint = astGetNpoint( pset_tmp );
+
+/* Ensure the cached information is up to date. */
+   Cache( (AstBox *) this_region, 1, status );
+
+/* Clear the returned mask. */
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+/* Describe the points to be tested, and the mask to receive the results. */
+   pdata.ptr_in = astGetPoints( pset_tmp );
+   pdata.ncoord_in = astGetNcoord( pset_tmp );
+   pdata.ptr_out = NULL;
+   pdata.ncoord_out = 0;
+   pdata.mask = mask;
+   pdata.closed = astGetClosed( this_region );
+   pdata.neg = astGetNegated( this_region );
+
+/* Test the points in the same way as the Transform function, possibly
+   using several threads. */
+   if( astOK ) result = astRegParallel( this_region, frm, npoint,
+                                        TestPoints, &pdata );
+
+/* Free resources */
+   pset_tmp = astAnnul( pset_tmp );
+   frm = astAnnul( frm );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static int RegShape( AstRegion *this_region, double centre[2],
+                     double matrix[4], double **vert, int *nvert,
+                     int *status ){
+/*
+*  Name:
+*     RegShape
+
+*  Purpose:
+*     Return an analytic description of a 2-dimensional Box.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "box.h"
+*     int RegShape( AstRegion *this, double centre[2], double matrix[4],
+*                   double **vert, int *nvert, int *status )
+
+*  Class Membership:
+*     Box member function (over-rides the astRegShape protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns the four corners of an un-negated 2-dimensional
+*     Box, as a polygon within the base Frame of the Box. See astRegShape
+*     for details.
+
+*  Parameters:
+*     this
+*        Pointer to the Box.
+*     centre
+*        Not used.
+*     matrix
+*        Not used.
+*     vert
+*        Returned holding a pointer to a newly allocated array holding the
+*        corner coordinates.
+*     nvert
+*        Returned holding the number of corners (4).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     AST__POLYSHAPE, or AST__NOSHAPE if the Box is negated or is not
+*     2-dimensional.
+
+*/
+
+/* Local Variables: */
+   AstBox *this;             /* Pointer to Box structure */
+   double lo[ 2 ];           /* Lower axis limits */
+   double hi[ 2 ];           /* Upper axis limits */
+   int i;                    /* Axis index */
+
+/* Initialise */
+   *vert = NULL;
+   *nvert = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return AST__NOSHAPE;
+
+/* Get a pointer to the Box structure. */
+   this = (AstBox *) this_region;
+
+/* Only un-negated 2-dimensional Boxes can be described. */
+   if( astGetNegated( this ) ||
+       astGetNin( this_region->frameset ) != 2 ) return AST__NOSHAPE;
+
+/* Ensure cached information is available. Use the centre and half-widths
+   rather than the "lo" and "hi" arrays, since the latter may have been
+   widened to allow for uncertainty. */
+   Cache( this, 0, status );
+   if( !astOK ) return AST__NOSHAPE;
+   for( i = 0; i < 2; i++ ) {
+      lo[ i ] = this->centre[ i ] - this->extent[ i ];
+      hi[ i ] = this->centre[ i ] + this->extent[ i ];
+   }
+
+/* Store the corners in anti-clockwise order. */
+   *vert = astMalloc( 8*sizeof( double ) );
+   if( astOK ) {
+      (*vert)[ 0 ] = lo[ 0 ];
+      (*vert)[ 1 ] = hi[ 0 ];
+      (*vert)[ 2 ] = hi[ 0 ];
+      (*vert)[ 3 ] = lo[ 0 ];
+      (*vert)[ 4 ] = lo[ 1 ];
+      (*vert)[ 5 ] = lo[ 1 ];
+      (*vert)[ 6 ] = hi[ 1 ];
+      (*vert)[ 7 ] = hi[ 1 ];
+      *nvert = 4;
+   }
+
+/* Return the result. */
+   return astOK ? AST__POLYSHAPE : AST__NOSHAPE;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -4040,6 +4303,135 @@ static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
    return result;
 }
 
+static AstDim TestPoints( AstRegion *this_region, AstFrame *frm,
+                          AstDim lo, AstDim hi, void *data, int *status ){
+/*
+*  Name:
+*     TestPoints
+
+*  Purpose:
+*     Test if each of a range of points is inside a Box.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "box.h"
+*     AstDim TestPoints( AstRegion *this, AstFrame *frm, AstDim lo,
+*                        AstDim hi, void *data, int *status )
+
+*  Class Membership:
+*     Box member function
+
+*  Description:
+*     This function tests each of a contiguous range of base Frame
+*     positions to see if it is inside the Box. A bit is set in the
+*     supplied mask for each inside position, and/or the corresponding
+*     output axis values are set bad for each outside position. It is
+*     invoked via astRegParallel, possibly in a worker thread that does
+*     not have a lock on the Box, and so uses only the cached limits in
+*     the Box structure (which must be up to date) and the supplied Frame.
+
+*  Parameters:
+*     this
+*        Pointer to the Box.
+*     frm
+*        Pointer to a Frame equivalent to the base Frame of the Box.
+*     lo
+*        Index of the first point to test.
+*     hi
+*        Index of the point following the last point to test.
+*     data
+*        Pointer to a PointsData structure describing the points to
+*        test and the arrays to receive the results.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of tested points that are inside the Box.
+
+*/
+
+/* Local Variables: */
+   AstBox *box;                  /* Pointer to Box */
+   AstDim point;                 /* Loop counter for points */
+   AstDim result;                /* Returned number of inside points */
+   PointsData *pdata;            /* Description of the points to test */
+   double axval;                 /* Input axis value */
+   int coord;                    /* Zero-based index for coordinates */
+   int ok;                       /* Is the point inside the Region? */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get pointers to the Box and the description of the points. */
+   box = (AstBox *) this_region;
+   pdata = (PointsData *) data;
+
+/* Loop round each point */
+   for ( point = lo; point < hi; point++ ) {
+
+/* The logic used to combine axis values for negated and un-negated boxes
+   is different. For negated boxes, a position is in the region if *any
+   one* axis is not "close" to the box centre. So assume the point is
+   outside the Region (since the Region is negated, this means assuming
+   it is within the box). For un-negated boxes, a position is in the
+   region if *all* axes are "close" to the box centre. So assume the point
+   is within the Region (i.e. inside the box). */
+      ok = !pdata->neg;
+
+/* Loop round each axis value at this point. We break as soon as we find
+   a bad axis value or (for un-negated boxes) an axis value which is
+   outside the box. */
+      for ( coord = 0; coord < pdata->ncoord_in; coord++ ) {
+
+/* The point is not in the Region if any input axis value is bad. */
+         axval = pdata->ptr_in[ coord ][ point ];
+         if( axval == AST__BAD ) {
+            ok = 0;
+            break;
+
+/* Otherwise check the current axis value, depending on whether the
+   boundary is included in the Region or not. For negated boxes, the
+   remaining axis values must still be checked for bad values once an
+   axis value is found which is outside the box limits. For un-negated
+   boxes, break as soon as such an axis value is found. */
+         } else if( pdata->neg ) {
+            if( !astAxIn( frm, coord, box->lo[ coord ], box->hi[ coord ],
+                          axval, !pdata->closed ) ) ok = 1;
+
+         } else if( !astAxIn( frm, coord, box->lo[ coord ], box->hi[ coord ],
+                              axval, pdata->closed ) ) {
+            ok = 0;
+            break;
+         }
+      }
+
+/* Record the result. If this point is not inside the Region store bad
+   output axis values. */
+      if( ok ) {
+         if( pdata->mask ) {
+            pdata->mask[ point/8 ] |= (unsigned char)( 1 << ( point % 8 ) );
+         }
+         result++;
+
+      } else if( pdata->ptr_out ) {
+         for ( coord = 0; coord < pdata->ncoord_out; coord++ ) {
+            pdata->ptr_out[ coord ][ point ] = AST__BAD;
+         }
+      }
+   }
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -4099,30 +4491,17 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 */
 
 /* Local Variables: */
-   AstBox *box;                  /* Pointer to Box */
    AstFrame *frm;                /* Pointer to base Frame in FrameSet */
    AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
    AstPointSet *result;          /* Pointer to output PointSet */
    AstRegion *reg;               /* Pointer to Region */
-   double **ptr_out;             /* Pointer to output coordinate data */
-   double **ptr_tmp;             /* Pointer to base Frame coordinate data */
-   double axval;                 /* Input axis value */
-   int closed;                   /* Is the boundary part of the Region? */
-   int coord;                    /* Zero-based index for coordinates */
-   int ncoord_out;               /* No. of coordinates per output point */
-   int ncoord_tmp;               /* No. of coordinates per base Frame point */
-   int neg;                      /* Is the Box negated?*/
-   int npoint;                   /* No. of points */
-   int ok;                       /* Is the point inside the Region? */
-   int point;                    /* Loop counter for points */
-
+   PointsData pdata;             /* Description of the points to test */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
 
-/* Obtain pointers to the Regionand to the Box. */
+/* Obtain a pointer to the Region. */
    reg = (AstRegion *) this;
-   box = (AstBox *) this;
 
 /* Apply the parent mapping using the stored pointer to the Transform member
    function inherited from the parent Region class. This function validates
@@ -4142,106 +4521,27 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    contents of the returned PointSet. */
    pset_tmp = astRegTransform( reg, in, 0, NULL, &frm );
 
-/* Determine the numbers of points and coordinates per point from the base
-   Frame PointSet and obtain pointers for accessing the base Frame and output
-   coordinate values. */
-   npoint = astGetNpoint( pset_tmp );
-   ncoord_tmp = astGetNcoord( pset_tmp );
-   ptr_tmp = astGetPoints( pset_tmp );
-   ncoord_out = astGetNcoord( result );
-   ptr_out = astGetPoints( result );
-
-/* See if the boundary is part of the Region. */
-   closed = astGetClosed( reg );
-
-/* See if the Box is negated */
-   neg = astGetNegated( reg );
-
-/* Ensire the cached information is up to date. */
-   Cache( box, 1, status );
-
-/* Perform coordinate arithmetic. */
-/* ------------------------------ */
-   if ( astOK ) {
-
-/* The logic used to combine axis values for negated and un-negated boxes
-   is different. For negated boxes, a position is in the region if *any
-   one* axis is not "close" to the box centre. */
-      if( neg ) {
-
-/* Loop round each point */
-         for ( point = 0; point < npoint; point++ ) {
-
-/* Assume the point is outside the Region (since the Region is
-   negated, this means assuming it is within the box). */
-            ok = 0;
-
-/* Loop round each axis value at this point. We break as soon as we find
-   a bad axis value or an axis value which is outside the box. */
-            for ( coord = 0; coord < ncoord_tmp; coord++ ) {
-
-/* The point is definiately not in the Region if any input axis value is bad. */
-               axval = ptr_tmp[ coord ][ point ];
-               if( axval == AST__BAD ) {
-                  break;
-
-/* Otherwise check the current axis value, depending on whether the
-   boundary is included in the Region or not. Break as soon as an axis
-   value is found which is outside the box limits (i.e. in the Region). */
-               } else if( !astAxIn( frm, coord, box->lo[ coord ], box->hi[ coord ],
-                                    axval, !closed ) ) {
-                  ok = 1;
-                  break;
-               }
-            }
-
-/* If this point is not inside the Region store bad output axis values. */
-            if( !ok ) {
-               for ( coord = 0; coord < ncoord_out; coord++ ) {
-                  ptr_out[ coord ][ point ] = AST__BAD;
-               }
-            }
-         }
-
-/* For un-negated boxes, a position is in the region if *all* axes are "close"
-   to the box centre. */
-      } else {
-
-/* Loop round each point */
-         for ( point = 0; point < npoint; point++ ) {
-
-/* Assume the point is within the Region (i.e.inside the box). */
-            ok = 1;
-
-/* Loop round each axis value at this point. We break when we find a bad
-   input point or if any axis value is outside the box. */
-            for ( coord = 0; coord < ncoord_tmp; coord++ ) {
-
-/* The point is not in the Region if any input axis value is bad. */
-               axval = ptr_tmp[ coord ][ point ];
-               if( axval == AST__BAD ) {
-                  ok = 0;
-                  break;
-
-/* Otherwise check the current axis value, depending on whether the
-   boundary is included in the Region or not. Break as soon as an axis
-   value is found which is outside the box limits (i.e. outside the Region). */
-               } else if( !astAxIn( frm, coord, box->lo[ coord ], box->hi[ coord ],
-                                    axval, closed ) ) {
-                  ok = 0;
-                  break;
-               }
-            }
-
-/* If this point is outside the Region store bad output axis values. */
-            if( !ok ) {
-               for ( coord = 0; coord < ncoord_out; coord++ ) {
-                  ptr_out[ coord ][ point ] = AST__BAD;
-               }
-            }
-         }
-      }
-   }
+/* Ensire the cached information is up to date. This must be done before
+   testing any points, since the testing may be shared between several
+   threads. */
+   Cache( (AstBox *) this, 1, status );
+
+/* Describe the points to be tested: the numbers of coordinates per point
+   and pointers for accessing the base Frame and output coordinate values,
+   whether the boundary is part of the Region, and whether the Box is
+   negated. */
+   pdata.ptr_in = astGetPoints( pset_tmp );
+   pdata.ncoord_in = astGetNcoord( pset_tmp );
+   pdata.ptr_out = astGetPoints( result );
+   pdata.ncoord_out = astGetNcoord( result );
+   pdata.mask = NULL;
+   pdata.closed = astGetClosed( reg );
+   pdata.neg = astGetNegated( reg );
+
+/* Perform coordinate arithmetic, possibly using several threads. Points
+   that are not inside the Region are set bad in the output PointSet. */
+   if ( astOK ) (void) astRegParallel( reg, frm, astGetNpoint( pset_tmp ),
+                                       TestPoints, &pdata );
 
 /* Free resources */
    pset_tmp = astAnnul( pset_tmp );
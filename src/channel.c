@@ -24,6 +24,20 @@ f     and "sink" routines which connect it to an external data store
 *     output. Alternatively, a Channel can be told to read or write from
 *     specific text files using the SinkFile and SourceFile attributes,
 *     in which case no sink or source function need be supplied.
+*
+*     If the Binary attribute is set, a Channel will instead write a
+*     compact binary encoding of each Object to its SinkFile, or to an
+*     internal memory buffer. Binary data are recognised automatically
+*     when read back from a SourceFile or from a memory buffer supplied
+c     using astPutBinaryInput.
+f     using the C interface.
+*
+*     If the ShareObjects attribute is set, an Object that is referred
+*     to more than once within the Object being written (for instance,
+*     a Frame that is used in several places within a FrameSet) is
+*     written out in full only once. Later occurrences are written as
+*     references to the first, and are re-created as references to a
+*     single shared Object when read back.
 
 *  Inheritance:
 *     The Channel class inherits from the Object class.
@@ -32,10 +46,12 @@ f     and "sink" routines which connect it to an external data store
 *     In addition to those attributes common to all Objects, every
 *     Channel also has the following attributes:
 *
+*     - Binary: Write Objects using a compact binary encoding?
 *     - Comment: Include textual comments in output?
 *     - Full: Set level of output detail
 *     - Indent: Indentation increment between objects
 *     - ReportLevel: Selects the level of error reporting
+*     - ShareObjects: Write shared Objects only once?
 *     - SinkFile: The path to a file to which the Channel should write
 *     - Skip: Skip irrelevant data?
 *     - SourceFile: The path to a file from which the Channel should read
@@ -48,6 +64,8 @@ f     In addition to those routines applicable to all Objects, the
 f     following routines may also be applied to all Channels:
 *
 c     - astWarnings: Return warnings from the previous read or write
+c     - astGetBinaryOutput: Return binary data held in a memory buffer
+c     - astPutBinaryInput: Read binary data from a memory buffer
 c     - astPutChannelData: Store data to pass to source or sink functions
 c     - astRead: Read an Object from a Channel
 c     - astWrite: Write an Object to a Channel
@@ -79,6 +97,7 @@ f     - AST_WRITE: Write an Object to a Channel
 
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
+*     AGT: Agent
 
 *  History:
 *     12-AUG-1996 (RFWS):
@@ -123,6 +142,20 @@ f     - AST_WRITE: Write an Object to a Channel
 *        Speed up the reading of large objects (such as MOCs) by using
 *        multiple linked lists accessed via a hash table to store the values
 *        at each nesting level, rather than a single linked list.
+*     18-OCT-2026 (AGT):
+*        - Write floating point values using the fewest digits that read
+*        back exactly (see astDouble2Chr), and use astChr2Double to read
+*        them.
+*        - Added the Binary attribute and the astGetBinaryOutput and
+*        astPutBinaryInput functions, which allow Objects to be written
+*        and read using a compact binary encoding.
+*        - Added the ShareObjects attribute, which causes Objects that are
+*        referred to more than once to be written out only once.
+*        - Added protected methods astGetNextBytes and astPutNextBytes,
+*        which allow derived classes to mix raw binary data with text in
+*        the SourceFile and SinkFile.
+*        - Calls to astRead and astWrite are recorded when profiling is
+*        enabled (see the Profile tuning parameter).
 *class--
 */
 
@@ -149,6 +182,30 @@ f     - AST_WRITE: Write an Object to a Channel
    for a specified value name. */
 #define HASHMAP_SIZE 128
 
+/* The signature written at the start of binary output. The first byte
+   cannot occur at the start of the textual encoding, and so is used to
+   recognise binary input. */
+#define BINARY_MAGIC "\211ASTBIN\n"
+#define BINARY_MAGIC_LEN 8
+
+/* The number of bytes in the header at the start of each binary record
+   (a one byte type code followed by a four byte payload length). */
+#define BINARY_HEAD_LEN 5
+
+/* The type codes used to identify binary records. */
+#define BINARY_BEGIN 'B'
+#define BINARY_ISA 'I'
+#define BINARY_END 'E'
+#define BINARY_OBJECT 'O'
+#define BINARY_STRING 'S'
+#define BINARY_DOUBLE 'D'
+#define BINARY_INT64 'L'
+#define BINARY_REF 'R'
+
+/* The size of the buffer used to format numerical values read from
+   binary input. */
+#define VALUE_BUFF_LEN 50
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -332,6 +389,18 @@ static AstChannelValue *LookupValue( const char *, int * );
 static AstKeyMap *Warnings( AstChannel *, int * );
 static char *GetNextText( AstChannel *, int * );
 static char *InputTextItem( AstChannel *, int * );
+static const char *FormatValue( AstChannelValue *, char *, int * );
+static int GetBinaryItem( AstChannel *, int, char **, char **, double *, int64_t *, int * );
+static int IntegerValue( AstChannelValue *, int64_t *, int * );
+static size_t GetBinaryData( AstChannel *, void *, size_t, int * );
+static size_t GetNextBytes( AstChannel *, void *, size_t, int * );
+static void *GetBinaryOutput( AstChannel *, size_t *, int * );
+static void OpenSinkFile( AstChannel *, int * );
+static void OpenSourceFile( AstChannel *, int * );
+static void PutBinaryData( AstChannel *, const void *, size_t, int * );
+static void PutBinaryInput( AstChannel *, const void *, size_t, int * );
+static void PutBinaryItem( AstChannel *, int, const char *, const void *, size_t, int * );
+static void PutBinaryNumber( AstChannel *, int, const char *, uint64_t, int * );
 static char *ReadString( AstChannel *, const char *, const char *, int * );
 static char *SourceWrap( const char *(*)( void ), int * );
 static const char *GetAttrib( AstObject *, const char *, int * );
@@ -342,6 +411,7 @@ static int GetSkip( AstChannel *, int * );
 static int GetStrict( AstChannel *, int * );
 static int HashFun( const char *, int, unsigned long * );
 static int ReadInt( AstChannel *, const char *, int, int * );
+static int ShareObject( AstChannel *, AstObject *, int *, int * );
 static int64_t ReadInt64( AstChannel *, const char *, int64_t, int * );
 static int TestAttrib( AstObject *, const char *, int * );
 static int TestComment( AstChannel *, int * );
@@ -364,9 +434,12 @@ static void Dump( AstObject *, AstChannel *, int * );
 static void GetNextData( AstChannel *, int, char **, char **, int * );
 static void OutputTextItem( AstChannel *, const char *, int * );
 static void PutChannelData( AstChannel *, void *, int * );
+static void PutNextBytes( AstChannel *, const void *, size_t, int * );
 static void PutNextText( AstChannel *, const char *, int * );
 static void ReadClassData( AstChannel *, const char *, int * );
 static void RemoveValue( AstChannelValue *, AstChannelValue **, int * );
+static void ResetSharedInput( AstChannel *, int * );
+static void ResetSharedObjects( AstChannel *, int * );
 static void SetAttrib( AstObject *, const char *, int * );
 static void SetComment( AstChannel *, int, int * );
 static void SetFull( AstChannel *, int, int * );
@@ -381,6 +454,7 @@ static void WriteInt( AstChannel *, const char *, int, int, int, const char *, i
 static void WriteInt64( AstChannel *, const char *, int, int, int64_t, const char *, int * );
 static void WriteIsA( AstChannel *, const char *, const char *, int * );
 static void WriteObject( AstChannel *, const char *, int, int, AstObject *, const char *, int * );
+static void WriteRef( AstChannel *, int, int * );
 static void WriteString( AstChannel *, const char *, int, int, const char *, const char *, int * );
 static void WriteFlush( AstChannel *, int * );
 
@@ -404,6 +478,16 @@ static int TestSinkFile( AstChannel *, int * );
 static void ClearSinkFile( AstChannel *, int * );
 static void SetSinkFile( AstChannel *, const char *, int * );
 
+static int GetBinary( AstChannel *, int * );
+static int TestBinary( AstChannel *, int * );
+static void ClearBinary( AstChannel *, int * );
+static void SetBinary( AstChannel *, int, int * );
+
+static int GetShareObjects( AstChannel *, int * );
+static int TestShareObjects( AstChannel *, int * );
+static void ClearShareObjects( AstChannel *, int * );
+static void SetShareObjects( AstChannel *, int, int * );
+
 /* Member functions. */
 /* ================= */
 static void AddWarning( AstChannel *this, int level, const char *msg,
@@ -664,9 +748,14 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
 
 /* Check the attribute name and clear the appropriate attribute. */
 
+/* Binary. */
+/* ------- */
+   if ( !strcmp( attrib, "binary" ) ) {
+      astClearBinary( this );
+
 /* Comment. */
 /* -------- */
-   if ( !strcmp( attrib, "comment" ) ) {
+   } else if ( !strcmp( attrib, "comment" ) ) {
       astClearComment( this );
 
 /* Full. */
@@ -684,6 +773,11 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
    } else if ( !strcmp( attrib, "reportlevel" ) ) {
       astClearReportLevel( this );
 
+/* ShareObjects. */
+/* ------------- */
+   } else if ( !strcmp( attrib, "shareobjects" ) ) {
+      astClearShareObjects( this );
+
 /* Skip. */
 /* ----- */
    } else if ( !strcmp( attrib, "skip" ) ) {
@@ -760,6 +854,7 @@ static void ClearValues( AstChannel *this, int *status ) {
    astDECLARE_GLOBALS            /* Declare the thread specific global data */
    AstChannelValue **head;       /* Address of pointer to values list */
    AstChannelValue *value;       /* Pointer to value list element */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
    int indx;                     /* Index into hash map */
 
 /* Get a pointer to the structure holding thread-specific global data. */
@@ -809,7 +904,7 @@ static void ClearValues( AstChannel *this, int *status ) {
          } else {
             astAddWarning( this, 1, "The value \"%s = %s\" was not "
                            "recognised as valid input.", "astRead", status,
-                           value->name, value->ptr.string );
+                           value->name, FormatValue( value, buff, status ) );
          }
 
 /* Remove the Value structure from the list (which updates the head of
@@ -820,6 +915,77 @@ static void ClearValues( AstChannel *this, int *status ) {
    }
 }
 
+static const char *FormatValue( AstChannelValue *value, char *buff, int *status ) {
+/*
+*  Name:
+*     FormatValue
+
+*  Purpose:
+*     Obtain the textual form of a non-Object value.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     const char *FormatValue( AstChannelValue *value, char *buff, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function returns a pointer to a string holding the value
+*     described by a Value structure. Values read from textual input
+*     are returned directly. Numerical values read from binary input
+*     are formatted into the supplied buffer in the same way that they
+*     would appear in textual output.
+
+*  Parameters:
+*     value
+*        Pointer to the Value structure. This should not describe an
+*        Object.
+*     buff
+*        A buffer of at least VALUE_BUFF_LEN characters in which to
+*        format numerical values.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Pointer to the null-terminated value string.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set, so that it may be used when reporting errors.
+*/
+
+/* Local Variables: */
+   int local_status;             /* Local status value */
+
+/* Values read from textual input are held as strings. */
+   if ( !value->bintype ) return value->ptr.string;
+
+/* Format integer values in decimal. */
+   buff[ 0 ] = '\0';
+   if ( value->bintype == BINARY_INT64 ) {
+      (void) sprintf( buff, "%" PRId64, value->ival );
+
+/* Use the magic string to represent bad floating point values. Format
+   others using the fewest digits that will read back exactly, avoiding
+   "-0". Use a local status value so that this works even if an error
+   has already been reported. */
+   } else if ( value->dval == AST__BAD ) {
+      strcpy( buff, BAD_STRING );
+
+   } else {
+      local_status = 0;
+      (void) astDouble2Chr_( value->dval, AST__DBL_DIG, buff, &local_status );
+      if ( !strcmp( buff, "-0" ) ) strcpy( buff, "0" );
+   }
+
+/* Return the buffer. */
+   return buff;
+}
+
 static AstChannelValue *FreeValue( AstChannelValue *value, int *status ) {
 /*
 *  Name:
@@ -939,10 +1105,12 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    astDECLARE_GLOBALS            /* Declare the thread specific global data */
    AstChannel *this;             /* Pointer to the Channel structure */
    const char *result;           /* Pointer value to return */
+   int binary;                   /* Binary attribute value */
    int comment;                  /* Comment attribute value */
    int full;                     /* Full attribute value */
    int indent;                   /* Indent attribute value */
    int report_level;             /* ReportLevel attribute value */
+   int shareobjects;             /* ShareObjects attribute value */
    int skip;                     /* Skip attribute value */
    int strict;                   /* Report errors insead of warnings? */
 
@@ -963,9 +1131,18 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    the value into "getattrib_buff" as a null terminated string in an appropriate
    format.  Set "result" to point at the result string. */
 
+/* Binary. */
+/* ------- */
+   if ( !strcmp( attrib, "binary" ) ) {
+      binary = astGetBinary( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", binary );
+         result = getattrib_buff;
+      }
+
 /* Comment. */
 /* -------- */
-   if ( !strcmp( attrib, "comment" ) ) {
+   } else if ( !strcmp( attrib, "comment" ) ) {
       comment = astGetComment( this );
       if ( astOK ) {
          (void) sprintf( getattrib_buff, "%d", comment );
@@ -999,6 +1176,15 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
          result = getattrib_buff;
       }
 
+/* ShareObjects. */
+/* ------------- */
+   } else if ( !strcmp( attrib, "shareobjects" ) ) {
+      shareobjects = astGetShareObjects( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", shareobjects );
+         result = getattrib_buff;
+      }
+
 /* Skip. */
 /* ----- */
    } else if ( !strcmp( attrib, "skip" ) ) {
@@ -1038,177 +1224,678 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
 
 }
 
-static void GetNextData( AstChannel *this, int skip, char **name,
-                         char **val, int *status ) {
+static size_t GetBinaryData( AstChannel *this, void *data, size_t size,
+                             int *status ) {
 /*
-*+
 *  Name:
-*     astGetNextData
+*     GetBinaryData
 
 *  Purpose:
-*     Read the next item of data from a data source.
+*     Read bytes from a binary data source.
 
 *  Type:
-*     Protected virtual function.
+*     Private function.
 
 *  Synopsis:
 *     #include "channel.h"
-*     void astGetNextData( AstChannel *this, int skip, char **name,
-*                          char **val )
+*     size_t GetBinaryData( AstChannel *this, void *data, size_t size,
+*                           int *status )
 
 *  Class Membership:
-*     Channel method.
+*     Channel member function.
 
 *  Description:
-*     This function reads the next item of input data from a data
-*     source associated with a Channel and returns the result.
+*     This function reads the requested number of bytes from the memory
+*     buffer supplied using astPutBinaryInput or, if no memory buffer
+*     has been supplied, from the input SourceFile. Fewer bytes are
+*     returned only if the end of the input is reached.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     data
+*        Pointer to the buffer to receive the bytes.
+*     size
+*        The number of bytes to read.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of bytes read.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*/
+
+/* Local Variables: */
+   size_t result;                /* Number of bytes read */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Copy bytes from the memory buffer, if one has been supplied. */
+   if ( this->mem_in ) {
+      result = this->nmem_in - this->imem_in;
+      if ( result > size ) result = size;
+      memcpy( data, this->mem_in + this->imem_in, result );
+      this->imem_in += result;
+
+/* Otherwise read them from the input file, and report an error if the
+   file could not be read. */
+   } else {
+      result = fread( data, 1, size, this->fd_in );
+      if ( result < size && ferror( this->fd_in ) ) {
+         astError( AST__RDERR, "astRead(%s): Read error on input "
+                   "SourceFile '%s'.", status, astGetClass( this ),
+                   astGetSourceFile( this ) );
+         result = 0;
+      }
+   }
+
+/* Return the number of bytes read. */
+   return result;
+}
+
+static int GetBinaryItem( AstChannel *this, int skip, char **name,
+                          char **val, double *dval, int64_t *ival,
+                          int *status ) {
+/*
+*  Name:
+*     GetBinaryItem
+
+*  Purpose:
+*     Read the next item of data from a binary data source.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     int GetBinaryItem( AstChannel *this, int skip, char **name,
+*                        char **val, double *dval, int64_t *ival,
+*                        int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function reads the next binary record from the data source
+*     associated with a Channel and decodes it into the same name/value
+*     form as is returned by astGetNextData. Numerical values are
+*     returned directly rather than as strings.
 *
-*     It is layered conceptually on the astGetNextText method, but
-*     instead of returning the raw input text, it decodes it and
-*     returns name/value pairs ready for use. Note that in some
-*     derived classes, where the data are not stored as text, this
-*     function may not actually use astGetNextText, but will access
-*     the data directly.
+*     Each binary record consists of a one byte type code, followed by
+*     the number of bytes in the rest of the record stored as a four
+*     byte little-endian unsigned integer. For "Begin", "IsA" and "End"
+*     items, the rest of the record holds the class name, and for "Ref"
+*     items it holds the decimal index of the referenced Object. For other
+*     items, it holds the null-terminated item name followed by the
+*     value: the characters of a string value, nothing for an Object
+*     value, or eight bytes holding a little-endian IEEE double or
+*     two's complement integer.
 
 *  Parameters:
 *     this
 *        Pointer to the Channel.
 *     skip
-*        A non-zero value indicates that a new Object is to be read,
-*        and that all input data up to the next "Begin" item are to be
-*        skipped in order to locate it. This is useful if the data
-*        source contains AST objects interspersed with other data (but
-*        note that these other data cannot appear inside AST Objects,
-*        only between them).
-*
-*        A zero value indicates that all input data are significant
-*        and the next item will therefore be read and an attempt made
-*        to interpret it whatever it contains. Any other data
-*        inter-mixed with AST Objects will then result in an error.
+*        If non-zero, all records up to the next "Begin" item are
+*        skipped.
 *     name
 *        An address at which to store a pointer to a null-terminated
-*        dynamically allocated string containing the name of the next
-*        item in the input data stream. This name will be in lower
-*        case with no surrounding white space.  It is the callers
-*        responsibilty to free the memory holding this string (using
-*        astFree) when it is no longer required.
-*
-*        A NULL pointer value will be returned (without error) to
-*        indicate when there are no further input data items to be
-*        read.
+*        dynamically allocated string containing the lower case name of
+*        the item, as for astGetNextData. A NULL pointer is returned if
+*        the end of the input data has been reached.
 *     val
 *        An address at which to store a pointer to a null-terminated
-*        dynamically allocated string containing the value associated
-*        with the next item in the input data stream. No case
-*        conversion is performed on this string and all white space is
-*        potentially significant.  It is the callers responsibilty to
-*        free the memory holding this string (using astFree) when it
-*        is no longer required.
-*
-*        The returned pointer will be NULL if an Object data item is
-*        read (see the "Data Representation" section).
+*        dynamically allocated string containing the value of the item,
+*        as for astGetNextData. A NULL pointer is returned for
+*        numerical items and Object items.
+*     dval
+*        Address at which to return the value of a floating point item.
+*     ival
+*        Address at which to return the value of an integer item.
+*     status
+*        Pointer to the inherited status variable.
 
-*  Data Representation:
-*     The returned data items fall into the following categories:
-*
-*     - Begin: Identified by the name string "begin", this indicates
-*     the start of an Object definition. The associated value string
-*     gives the class name of the Object being defined.
-*
-*     - IsA: Identified by the name string "isa", this indicates the
-*     end of the data associated with a particular class structure
-*     within the definiton of a larger Object. The associated value
-*     string gives the name of the class whose data have just been
-*     read.
-*
-*     - End: Identified by the name string "end", this indicates the
-*     end of the data associated with a complete Object
-*     definition. The associated value string gives the class name of
-*     the Object whose definition is being ended.
-*
-*     - Non-Object: Identified by any other name string plus a
-*     non-NULL "val" pointer, this gives the value of a non-Object
-*     structure component (instance variable). The name identifies
-*     which instance variable it is (within the context of the class
-*     whose data are being read) and the value is encoded as a string.
-*
-*     - Object: Identified by any other name string plus a NULL "val"
-*     pointer, this identifies the value of an Object structure
-*     component (instance variable).  The name identifies which
-*     instance variable it is (within the context of the class whose
-*     data are being read) and the value is given by subsequent data
-*     items (so the next item should be a "Begin" item).
+*  Returned Value:
+*     The type code of the record that was read (one of the BINARY_...
+*     macros), or zero if the end of the input data was reached.
 
 *  Notes:
-*     - NULL pointer values will be returned if this function is
+*     - Zero and NULL pointers will be returned if this function is
 *     invoked with the global error status set, or if it should fail
 *     for any reason.
-*     - This method is provided primarily so that derived classes may
-*     over-ride it in order to read from alternative data sources. It
-*     provides a higher-level interface than astGetNextText, so is
-*     suitable for classes that either need to read textual data in a
-*     different format, or to read from non-textual data sources.
-*-
 */
 
 /* Local Variables: */
-   char *line;                   /* Pointer to input text line */
-   int done;                     /* Data item read? */
-   int i;                        /* Loop counter for string characters */
-   int len;                      /* Length of input text line */
-   int nc1;                      /* Offset to start of first field */
-   int nc2;                      /* Offset to end of first field */
-   int nc3;                      /* Offset to start of second field */
-   int nc;                       /* Number of charaters read by "astSscanf" */
+   char *data;                   /* Record contents */
+   int i;                        /* Byte index */
+   int result;                   /* Returned type code */
+   size_t len;                   /* Number of bytes following the header */
+   size_t nc;                    /* Length of item name */
+   uint64_t bits;                /* Bits of a numerical value */
+   unsigned char head[ BINARY_HEAD_LEN ]; /* Record header */
 
-/* Initialise the returned values. */
+/* Initialise. */
    *name = NULL;
    *val = NULL;
+   result = 0;
 
 /* Check the global error status. */
-   if ( !astOK ) return;
+   if ( !astOK ) return result;
 
-/* Read the next input line as text (the loop is needed to allow
-   initial lines to be skipped if the "skip" flag is set). */
-   done = 0;
-   while ( !done && ( line = InputTextItem( this, status ) ) && astOK ) {
+/* Loop until a record has been decoded (records are only rejected if
+   they are being skipped), the end of input is reached, or an error
+   occurs. */
+   while ( !result && astOK ) {
+
+/* Read the record header, quitting if there are no more records. Then
+   read the rest of the record into dynamic memory, appending a
+   terminating null. */
+      nc = GetBinaryData( this, head, BINARY_HEAD_LEN, status );
+      if ( !nc || !astOK ) break;
+
+      len = (size_t) head[ 1 ] | ( (size_t) head[ 2 ] << 8 ) |
+            ( (size_t) head[ 3 ] << 16 ) | ( (size_t) head[ 4 ] << 24 );
+      data = ( nc == BINARY_HEAD_LEN ) ? astMalloc( len + 1 ) : NULL;
+      if ( data && GetBinaryData( this, data, len, status ) == len ) {
+         data[ len ] = '\0';
+         result = head[ 0 ];
+      } else {
+         data = astFree( data );
+         if ( astOK ) {
+            astError( AST__BADIN, "astRead(%s): Unexpected end of binary "
+                      "input data.", status, astGetClass( this ) );
+         }
+      }
 
-/* If OK, determine the line length. */
-      len = strlen( line );
+/* If all items other than "Begin" items are being skipped, skip this
+   item if necessary. */
+      if ( skip && result && result != BINARY_BEGIN ) {
+         data = astFree( data );
+         result = 0;
 
-/* Non-Object value. */
-/* ----------------- */
-/* Test for lines of the form " name = value" (or similar), where the
-   name is no more than MAX_NAME characters long (the presence of a
-   value on the right hand side indicates that this is a non-Object
-   value, encoded as a string). Ignore these lines if the "skip" flag
-   is set. */
-      if ( nc = 0,
-           ( !skip
-             && ( 0 == astSscanf( line,
-                               " %n%*" MAX_NAME "[^ \t=]%n = %n%*[^\n]%n",
-                               &nc1, &nc2, &nc3, &nc ) )
-             && ( nc >= len ) ) ) {
+/* "Begin", "IsA" and "End" items. The record contents give the class
+   name. */
+      } else if ( result == BINARY_BEGIN ) {
+         *name = astString( "begin", 5 );
+         *val = data;
 
-/* Note we have found a data item. */
-         done = 1;
+      } else if ( result == BINARY_ISA ) {
+         *name = astString( "isa", 3 );
+         *val = data;
 
-/* Extract the name and value fields. */
-         *name = astString( line + nc1, nc2 - nc1 );
-         *val = astString( line + nc3, len - nc3 );
+      } else if ( result == BINARY_END ) {
+         *name = astString( "end", 3 );
+         *val = data;
+
+/* "Ref" items. The record contents give the index of the referenced
+   Object, formatted as a decimal integer. */
+      } else if ( result == BINARY_REF ) {
+         *name = astString( "ref", 3 );
+         *val = data;
+
+/* Named values. The record starts with the null-terminated name, which
+   is converted to lower case for consistency with textual input. */
+      } else if ( result ) {
+         *name = data;
+         nc = strlen( data );
+         for ( i = 0; i < (int) nc; i++ ) data[ i ] = tolower( (unsigned char) data[ i ] );
+
+/* Check that the name is followed by a valid value. */
+         if ( nc == len || ( ( result == BINARY_DOUBLE ||
+                               result == BINARY_INT64 ) &&
+                             len - nc - 1 != 8 ) ||
+              ( result == BINARY_OBJECT && len - nc - 1 != 0 ) ||
+              ( result != BINARY_DOUBLE && result != BINARY_INT64 &&
+                result != BINARY_OBJECT && result != BINARY_STRING ) ) {
+            astError( AST__BADIN, "astRead(%s): Invalid binary input data "
+                      "(record type %d of length %d).", status,
+                      astGetClass( this ), result, (int) len );
+
+/* Extract string values into a new string. */
+         } else if ( result == BINARY_STRING ) {
+            *val = astString( data + nc + 1, len - nc - 1 );
+
+/* Assemble numerical values from their little-endian bytes. */
+         } else if ( result != BINARY_OBJECT ) {
+            bits = 0;
+            for ( i = 7; i >= 0; i-- ) {
+               bits = ( bits << 8 ) | (unsigned char) data[ nc + 1 + i ];
+            }
+            if ( result == BINARY_DOUBLE ) {
+               memcpy( dval, &bits, sizeof( double ) );
+            } else {
+               *ival = (int64_t) bits;
+            }
+         }
+      }
+   }
 
-/* If OK, truncate the value to remove any trailing white space. */
-         if ( astOK ) {
-            i = len - nc3 - 1;
-            while ( ( i >= 0 ) && isspace( ( *val )[ i ] ) ) i--;
-            ( *val )[ i + 1 ] = '\0';
+/* If an error occurred, ensure that any memory allocated is freed and
+   that NULL pointer values are returned. */
+   if ( !astOK ) {
+      *name = astFree( *name );
+      *val = astFree( *val );
+      result = 0;
+   }
 
-/* Also remove any quotes from the string. */
-            Unquote( this, *val, status );
-         }
+/* Return the type code. */
+   return result;
+}
 
-/* Object value. */
-/* ------------- */
+static void *GetBinaryOutput( AstChannel *this, size_t *size, int *status ) {
+/*
+c++
+*  Name:
+*     astGetBinaryOutput
+
+*  Purpose:
+*     Return the binary data written to a Channel's memory buffer.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void *astGetBinaryOutput( AstChannel *this, size_t *size )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function returns the binary data accumulated in the memory
+*     buffer of a Channel by previous invocations of astWrite, and
+*     leaves the Channel with an empty buffer. Binary data are written
+*     to this buffer if the Binary attribute is non-zero and the
+*     SinkFile attribute is not set.
+*
+*     The returned data may be read back (using astRead) by supplying
+*     them to another Channel using astPutBinaryInput.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     size
+*        Address of a variable in which to return the number of bytes
+*        of binary data.
+
+*  Returned Value:
+*     astGetBinaryOutput()
+*        A pointer to dynamically allocated memory holding the binary
+*        data, or NULL if no binary data have been written. The pointer
+*        should be freed using astFree when it is no longer needed.
+
+*  Applicability:
+*     Channel
+*        All Channels have this function.
+
+*  Notes:
+*     - A NULL pointer and a zero size will be returned if this
+*     function is invoked with the AST error status set, or if it
+*     should fail for any reason.
+*     - This routine is not available in the Fortran 77 interface to
+*     the AST library.
+c--
+*/
+
+/* Local Variables: */
+   void *result;                 /* Pointer to returned data */
+
+/* Initialise. */
+   *size = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* Transfer ownership of the memory buffer to the caller. */
+   result = this->mem_out;
+   *size = this->nmem_out;
+   this->mem_out = NULL;
+   this->nmem_out = 0;
+
+/* Return the pointer. */
+   return result;
+}
+
+static size_t GetNextBytes( AstChannel *this, void *data, size_t size,
+                            int *status ) {
+/*
+*+
+*  Name:
+*     astGetNextBytes
+
+*  Purpose:
+*     Read raw bytes from the input SourceFile.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     size_t astGetNextBytes( AstChannel *this, void *data, size_t size )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function reads the requested number of bytes from the file
+*     specified by the SourceFile attribute, starting immediately after
+*     the last line of text read using astGetNextText. It allows derived
+*     classes to read external formats in which binary data follows a
+*     textual header. Fewer bytes are returned only if the end of the
+*     file is reached.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     data
+*        Pointer to the buffer to receive the bytes.
+*     size
+*        The number of bytes to read.
+
+*  Returned Value:
+*     The number of bytes read.
+
+*  Notes:
+*     - An error is reported if no SourceFile has been specified, since
+*     source functions can only supply lines of text.
+*     - A value of zero will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*-
+*/
+
+/* Local Variables: */
+   size_t result;                /* Number of bytes read */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* If the SourceFile attribute of the Channel specifies an input file,
+   but no input file has yet been opened, open it now. */
+   if( astTestSourceFile( this ) && !this->fd_in ) OpenSourceFile( this, status );
+   if ( !astOK ) return 0;
+
+/* Report an error if there is no input file. */
+   result = 0;
+   if( !this->fd_in ) {
+      astError( AST__RDERR, "astRead(%s): Binary data can only be read "
+                "from a file specified by the SourceFile attribute.",
+                status, astGetClass( this ) );
+
+/* Otherwise read the bytes, and report an error if the file could not
+   be read. */
+   } else {
+      result = fread( data, 1, size, this->fd_in );
+      if ( result < size && ferror( this->fd_in ) ) {
+         astError( AST__RDERR, "astRead(%s): Read error on input "
+                   "SourceFile '%s'.", status, astGetClass( this ),
+                   astGetSourceFile( this ) );
+         result = 0;
+      }
+   }
+
+/* Return the number of bytes read. */
+   return result;
+}
+
+static void GetNextData( AstChannel *this, int skip, char **name,
+                         char **val, int *status ) {
+/*
+*+
+*  Name:
+*     astGetNextData
+
+*  Purpose:
+*     Read the next item of data from a data source.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void astGetNextData( AstChannel *this, int skip, char **name,
+*                          char **val )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function reads the next item of input data from a data
+*     source associated with a Channel and returns the result.
+*
+*     It is layered conceptually on the astGetNextText method, but
+*     instead of returning the raw input text, it decodes it and
+*     returns name/value pairs ready for use. Note that in some
+*     derived classes, where the data are not stored as text, this
+*     function may not actually use astGetNextText, but will access
+*     the data directly.
+*
+*     If the data source holds binary data (see the Binary attribute),
+*     this function decodes the binary records directly, without using
+*     astGetNextText.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     skip
+*        A non-zero value indicates that a new Object is to be read,
+*        and that all input data up to the next "Begin" item are to be
+*        skipped in order to locate it. This is useful if the data
+*        source contains AST objects interspersed with other data (but
+*        note that these other data cannot appear inside AST Objects,
+*        only between them).
+*
+*        A zero value indicates that all input data are significant
+*        and the next item will therefore be read and an attempt made
+*        to interpret it whatever it contains. Any other data
+*        inter-mixed with AST Objects will then result in an error.
+*     name
+*        An address at which to store a pointer to a null-terminated
+*        dynamically allocated string containing the name of the next
+*        item in the input data stream. This name will be in lower
+*        case with no surrounding white space.  It is the callers
+*        responsibilty to free the memory holding this string (using
+*        astFree) when it is no longer required.
+*
+*        A NULL pointer value will be returned (without error) to
+*        indicate when there are no further input data items to be
+*        read.
+*     val
+*        An address at which to store a pointer to a null-terminated
+*        dynamically allocated string containing the value associated
+*        with the next item in the input data stream. No case
+*        conversion is performed on this string and all white space is
+*        potentially significant.  It is the callers responsibilty to
+*        free the memory holding this string (using astFree) when it
+*        is no longer required.
+*
+*        The returned pointer will be NULL if an Object data item is
+*        read (see the "Data Representation" section).
+
+*  Data Representation:
+*     The returned data items fall into the following categories:
+*
+*     - Begin: Identified by the name string "begin", this indicates
+*     the start of an Object definition. The associated value string
+*     gives the class name of the Object being defined.
+*
+*     - IsA: Identified by the name string "isa", this indicates the
+*     end of the data associated with a particular class structure
+*     within the definiton of a larger Object. The associated value
+*     string gives the name of the class whose data have just been
+*     read.
+*
+*     - End: Identified by the name string "end", this indicates the
+*     end of the data associated with a complete Object
+*     definition. The associated value string gives the class name of
+*     the Object whose definition is being ended.
+*
+*     - Ref: Identified by the name string "ref", this may be used in
+*     place of a complete Object definition to refer to an Object
+*     that has already been read as part of the same top-level Object
+*     (see the ShareObjects attribute). The associated value string
+*     gives the zero-based index of the referenced Object, counting
+*     the Objects nested within the top-level Object in the order in
+*     which their "Begin" items were read.
+*
+*     - Non-Object: Identified by any other name string plus a
+*     non-NULL "val" pointer, this gives the value of a non-Object
+*     structure component (instance variable). The name identifies
+*     which instance variable it is (within the context of the class
+*     whose data are being read) and the value is encoded as a string.
+*
+*     - Object: Identified by any other name string plus a NULL "val"
+*     pointer, this identifies the value of an Object structure
+*     component (instance variable).  The name identifies which
+*     instance variable it is (within the context of the class whose
+*     data are being read) and the value is given by subsequent data
+*     items (so the next item should be a "Begin" or "Ref" item).
+
+*  Notes:
+*     - NULL pointer values will be returned if this function is
+*     invoked with the global error status set, or if it should fail
+*     for any reason.
+*     - This method is provided primarily so that derived classes may
+*     over-ride it in order to read from alternative data sources. It
+*     provides a higher-level interface than astGetNextText, so is
+*     suitable for classes that either need to read textual data in a
+*     different format, or to read from non-textual data sources.
+*-
+*/
+
+/* Local Variables: */
+   AstChannelValue value;        /* Describes a binary numerical value */
+   char *line;                   /* Pointer to input text line */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
+   char magic[ BINARY_MAGIC_LEN ]; /* Binary signature read from input */
+   double dval;                  /* Binary floating point value */
+   int c;                        /* First character in input file */
+   int done;                     /* Data item read? */
+   int i;                        /* Loop counter for string characters */
+   int64_t ival;                 /* Binary integer value */
+   int len;                      /* Length of input text line */
+   int type;                     /* Type of binary record */
+   int nc1;                      /* Offset to start of first field */
+   int nc2;                      /* Offset to end of first field */
+   int nc3;                      /* Offset to start of second field */
+   int nc;                       /* Number of charaters read by "astSscanf" */
+
+/* Initialise the returned values. */
+   *name = NULL;
+   *val = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Binary input. */
+/* ------------- */
+/* Data read from a memory buffer supplied using astPutBinaryInput are
+   always binary, and must start with the binary signature. */
+   if ( this->mem_in ) {
+      if ( !this->imem_in ) {
+         if ( GetBinaryData( this, magic, BINARY_MAGIC_LEN, status ) <
+              BINARY_MAGIC_LEN ||
+              memcmp( magic, BINARY_MAGIC, BINARY_MAGIC_LEN ) ) {
+            if ( astOK ) {
+               astError( AST__BADIN, "astRead(%s): The supplied memory "
+                         "buffer does not contain AST binary data.", status,
+                         astGetClass( this ) );
+            }
+         }
+      }
+      this->binary_in = 1;
+
+/* If the SourceFile attribute specifies an input file that has not yet
+   been opened, open it now and determine if it holds binary data by
+   looking for the first character of the binary signature (which
+   cannot start the textual format). */
+   } else if ( !this->fd_in ) {
+      this->binary_in = 0;
+      if ( astTestSourceFile( this ) ) {
+         OpenSourceFile( this, status );
+         if ( astOK ) {
+            c = getc( this->fd_in );
+            if ( c == (unsigned char) BINARY_MAGIC[ 0 ] ) {
+               this->binary_in = 1;
+               magic[ 0 ] = c;
+               if ( GetBinaryData( this, magic + 1, BINARY_MAGIC_LEN - 1,
+                                   status ) < BINARY_MAGIC_LEN - 1 ||
+                    memcmp( magic, BINARY_MAGIC, BINARY_MAGIC_LEN ) ) {
+                  if ( astOK ) {
+                     astError( AST__BADIN, "astRead(%s): The SourceFile "
+                               "'%s' does not contain valid AST binary "
+                               "data.", status, astGetClass( this ),
+                               astGetSourceFile( this ) );
+                  }
+               }
+            } else if ( c != EOF ) {
+               (void) ungetc( c, this->fd_in );
+            }
+         }
+      }
+   }
+
+/* If the input is binary, read the next binary record. Numerical values
+   are returned as strings in the same form as the textual format. */
+   if ( this->binary_in ) {
+      type = GetBinaryItem( this, skip, name, val, &dval, &ival, status );
+      if ( type == BINARY_DOUBLE || type == BINARY_INT64 ) {
+         value.bintype = type;
+         value.dval = dval;
+         value.ival = ival;
+         *val = astString( FormatValue( &value, buff, status ),
+                           strlen( buff ) );
+      }
+      return;
+   }
+
+/* Textual input. */
+/* -------------- */
+/* Read the next input line as text (the loop is needed to allow
+   initial lines to be skipped if the "skip" flag is set). */
+   done = 0;
+   while ( !done && ( line = InputTextItem( this, status ) ) && astOK ) {
+
+/* If OK, determine the line length. */
+      len = strlen( line );
+
+/* Non-Object value. */
+/* ----------------- */
+/* Test for lines of the form " name = value" (or similar), where the
+   name is no more than MAX_NAME characters long (the presence of a
+   value on the right hand side indicates that this is a non-Object
+   value, encoded as a string). Ignore these lines if the "skip" flag
+   is set. */
+      if ( nc = 0,
+           ( !skip
+             && ( 0 == astSscanf( line,
+                               " %n%*" MAX_NAME "[^ \t=]%n = %n%*[^\n]%n",
+                               &nc1, &nc2, &nc3, &nc ) )
+             && ( nc >= len ) ) ) {
+
+/* Note we have found a data item. */
+         done = 1;
+
+/* Extract the name and value fields. */
+         *name = astString( line + nc1, nc2 - nc1 );
+         *val = astString( line + nc3, len - nc3 );
+
+/* If OK, truncate the value to remove any trailing white space. */
+         if ( astOK ) {
+            i = len - nc3 - 1;
+            while ( ( i >= 0 ) && isspace( ( *val )[ i ] ) ) i--;
+            ( *val )[ i + 1 ] = '\0';
+
+/* Also remove any quotes from the string. */
+            Unquote( this, *val, status );
+         }
+
+/* Object value. */
+/* ------------- */
 /* Test for lines of the form " name = " (or similar), where the name
    is no more than MAX_NAME characters long (the absence of a value on
    the right hand side indicates that this is an Object, whose
@@ -1283,6 +1970,26 @@ static void GetNextData( AstChannel *this, int skip, char **name,
          *name = astString( "end", 3 );
          *val = astString( line + nc1, nc2 - nc1 );
 
+/* Ref. */
+/* ---- */
+/* Test for lines of the form " Ref Index " (or similar), which refer to
+   an Object read previously. Ignore these lines if the "skip" flag is
+   set. */
+      } else if ( nc = 0,
+                  ( !skip
+                    && ( 0 == astSscanf( line,
+                                      " %*1[Rr]%*1[Ee]%*1[Ff] %n%*[0-9]%n %n",
+                                      &nc1, &nc2, &nc ) )
+                    && ( nc >= len ) ) ) {
+
+/* Note we have found a data item. */
+         done = 1;
+
+/* If found, set the returned name to "ref" and extract the associated
+   index. */
+         *name = astString( "ref", 3 );
+         *val = astString( line + nc1, nc2 - nc1 );
+
 /* If the input line didn't match any of the above and the "skip" flag
    is not set, then report an error. Truncate long lines for display. */
       } else if ( !skip ) {
@@ -1423,8 +2130,6 @@ static char *GetNextText( AstChannel *this, int *status ) {
    char *errstat;                /* Pointer for system error message */
    char *line;                   /* Pointer to line data to be returned */
    char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
-   const char *sink_file;        /* Path to output sink file */
-   const char *source_file;      /* Path to source file */
    int c;                        /* Input character */
    int len;                      /* Length of input line */
    int readstat;                 /* "errno" value set by "getchar" */
@@ -1437,43 +2142,8 @@ static char *GetNextText( AstChannel *this, int *status ) {
    if ( !astOK ) return line;
 
 /* If the SourceFile attribute of the Channel specifies an input file,
-   but no input file has yet been opened, open it now. Report an error if
-   it is the same as the sink file. */
-   if( astTestSourceFile( this ) && !this->fd_in ) {
-      source_file = astGetSourceFile( this );
-
-      if( this->fd_out ) {
-         sink_file = astGetSinkFile( this );
-         if( astOK && !strcmp( sink_file, source_file ) ) {
-            astError( AST__RDERR, "astRead(%s): Failed to open input "
-                      "SourceFile '%s' - the file is currently being used "
-                      "as the output SinkFile.", status, astGetClass( this ),
-                      source_file );
-         }
-      }
-
-      if( astOK ) {
-         this->fd_in = fopen( source_file, "r" );
-         if( !this->fd_in ) {
-            if ( errno ) {
-#if HAVE_STRERROR_R
-               strerror_r( errno, errbuf, ERRBUF_LEN );
-               errstat = errbuf;
-#else
-               errstat = strerror( errno );
-#endif
-               astError( AST__RDERR, "astRead(%s): Failed to open input "
-                         "SourceFile '%s' - %s.", status, astGetClass( this ),
-                         source_file, errstat );
-            } else {
-               astError( AST__RDERR, "astRead(%s): Failed to open input "
-                         "SourceFile '%s'.", status, astGetClass( this ),
-                         source_file );
-            }
-         }
-
-      }
-   }
+   but no input file has yet been opened, open it now. */
+   if( astTestSourceFile( this ) && !this->fd_in ) OpenSourceFile( this, status );
 
 /* Source function defined, but no input file. */
 /* ------------------------------------------- */
@@ -1877,7 +2547,26 @@ AstChannel *astInitChannel_( void *mem, size_t size, int init,
       new->fd_out = NULL;
       new->fn_out = NULL;
 
+/* Indicate no binary data have been read or written, and no memory
+   buffers are in use. */
+      new->binary_in = 0;
+      new->binary_out = 0;
+      new->mem_in = NULL;
+      new->nmem_in = 0;
+      new->imem_in = 0;
+      new->mem_out = NULL;
+      new->nmem_out = 0;
+
+/* Indicate no shared Objects have been read or written. */
+      new->write_depth = 0;
+      new->shared_out = NULL;
+      new->nshared_out = 0;
+      new->shared_in = NULL;
+      new->nshared_in = 0;
+
 /* Set all attributes to their undefined values. */
+      new->binary = -INT_MAX;
+      new->shareobjects = -INT_MAX;
       new->comment = -INT_MAX;
       new->full = -INT_MAX;
       new->indent = -INT_MAX;
@@ -1958,17 +2647,23 @@ void astInitChannelVtab_(  AstChannelVtab *vtab, const char *name, int *status )
 /* Store pointers to the member functions (implemented here) that
    provide virtual methods for this class. */
    vtab->AddWarning = AddWarning;
+   vtab->ClearBinary = ClearBinary;
    vtab->ClearComment = ClearComment;
    vtab->ClearFull = ClearFull;
    vtab->ClearSkip = ClearSkip;
    vtab->ClearStrict = ClearStrict;
+   vtab->GetBinary = GetBinary;
+   vtab->GetBinaryOutput = GetBinaryOutput;
    vtab->GetComment = GetComment;
    vtab->GetFull = GetFull;
+   vtab->GetNextBytes = GetNextBytes;
    vtab->GetNextData = GetNextData;
    vtab->GetNextText = GetNextText;
    vtab->GetSkip = GetSkip;
    vtab->GetStrict = GetStrict;
    vtab->Warnings = Warnings;
+   vtab->PutBinaryInput = PutBinaryInput;
+   vtab->PutNextBytes = PutNextBytes;
    vtab->PutNextText = PutNextText;
    vtab->Read = Read;
    vtab->ReadClassData = ReadClassData;
@@ -1977,10 +2672,14 @@ void astInitChannelVtab_(  AstChannelVtab *vtab, const char *name, int *status )
    vtab->ReadInt64 = ReadInt64;
    vtab->ReadObject = ReadObject;
    vtab->ReadString = ReadString;
+   vtab->ResetSharedObjects = ResetSharedObjects;
+   vtab->SetBinary = SetBinary;
    vtab->SetComment = SetComment;
    vtab->SetFull = SetFull;
    vtab->SetSkip = SetSkip;
    vtab->SetStrict = SetStrict;
+   vtab->ShareObject = ShareObject;
+   vtab->TestBinary = TestBinary;
    vtab->TestComment = TestComment;
    vtab->TestFull = TestFull;
    vtab->TestSkip = TestSkip;
@@ -2017,6 +2716,11 @@ void astInitChannelVtab_(  AstChannelVtab *vtab, const char *name, int *status )
    vtab->SetSinkFile = SetSinkFile;
    vtab->TestSinkFile = TestSinkFile;
 
+   vtab->ClearShareObjects = ClearShareObjects;
+   vtab->GetShareObjects = GetShareObjects;
+   vtab->SetShareObjects = SetShareObjects;
+   vtab->TestShareObjects = TestShareObjects;
+
 /* Save the inherited pointers to methods that will be extended, and
    replace them with pointers to the new member functions. */
    object = (AstObjectVtab *) vtab;
@@ -2141,18 +2845,74 @@ static char *InputTextItem( AstChannel *this, int *status ) {
      if ( len ) {
         line[ len ] = '\0';
 
-/* Otherwise, free the memory used for the string so that another
-   input line will be read. */
-      } else {
-         line = astFree( line );
-      }
+/* Otherwise, free the memory used for the string so that another
+   input line will be read. */
+      } else {
+         line = astFree( line );
+      }
+   }
+
+/* Return the result pointer. */
+   return line;
+
+/* Undefine macros local to this function. */
+#undef MIN_CHARS
+}
+
+static int IntegerValue( AstChannelValue *value, int64_t *result,
+                         int *status ) {
+/*
+*  Name:
+*     IntegerValue
+
+*  Purpose:
+*     Obtain an integer from a binary numerical value.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     int IntegerValue( AstChannelValue *value, int64_t *result,
+*                       int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function returns the value of a numerical Value structure
+*     read from binary input as a 64 bit integer. Floating point values
+*     are accepted only if they have an exact integer value, in the same
+*     way that a textual floating point value is rejected when an
+*     integer is required.
+
+*  Parameters:
+*     value
+*        Pointer to the Value structure, which should describe a binary
+*        numerical value.
+*     result
+*        Address at which to return the integer value.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the value could be represented as a 64 bit integer.
+*/
+
+/* Integer values are returned directly. */
+   if ( value->bintype == BINARY_INT64 ) {
+      *result = value->ival;
+      return 1;
    }
 
-/* Return the result pointer. */
-   return line;
-
-/* Undefine macros local to this function. */
-#undef MIN_CHARS
+/* Floating point values must be integral and within the range of a
+   64 bit integer (this test also rejects NaN values). */
+   if ( value->dval >= -9223372036854775808.0 &&
+        value->dval < 9223372036854775808.0 ) {
+      *result = (int64_t) value->dval;
+      return ( (double) *result == value->dval );
+   }
+   return 0;
 }
 
 static AstChannelValue *LookupValue( const char *name, int *status ) {
@@ -2258,46 +3018,416 @@ static AstChannelValue *LookupValue( const char *name, int *status ) {
       }
    }
 
-/* Return the result. */
-   return result;
+/* Return the result. */
+   return result;
+}
+
+static void OpenSinkFile( AstChannel *this, int *status ) {
+/*
+*  Name:
+*     OpenSinkFile
+
+*  Purpose:
+*     Open the output file specified by the SinkFile attribute.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void OpenSinkFile( AstChannel *this, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function opens the file specified by the SinkFile attribute
+*     for writing, and stores its descriptor in the Channel. An error
+*     is reported if it is the same as the source file.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Constants: */
+#define ERRBUF_LEN 80
+
+/* Local Variables: */
+   char *errstat;                /* Pointer for system error message */
+   char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
+   const char *sink_file;        /* Path to output sink file */
+   const char *source_file;      /* Path to output source file */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get the path to the sink file. Report an error if it is the same as
+   the source file. */
+   sink_file = astGetSinkFile( this );
+
+   if( this->fd_in ) {
+      source_file = astGetSourceFile( this );
+      if( astOK && !strcmp( sink_file, source_file ) ) {
+         astError( AST__WRERR, "astWrite(%s): Failed to open output "
+                   "SinkFile '%s' - the file is currently being used "
+                   "as the input SourceFile.", status, astGetClass( this ),
+                   sink_file );
+      }
+   }
+
+/* Open the file. No binary header has yet been written to it. */
+   if( astOK ) {
+      this->fd_out = fopen( sink_file, "w" );
+      this->binary_out = 0;
+      if( !this->fd_out ) {
+         if ( errno ) {
+#if HAVE_STRERROR_R
+            strerror_r( errno, errbuf, ERRBUF_LEN );
+            errstat = errbuf;
+#else
+            errstat = strerror( errno );
+#endif
+            astError( AST__WRERR, "astWrite(%s): Failed to open output "
+                      "SinkFile '%s' - %s.", status, astGetClass( this ),
+                      sink_file, errstat );
+         } else {
+            astError( AST__WRERR, "astWrite(%s): Failed to open output "
+                      "SinkFile '%s'.", status, astGetClass( this ),
+                      sink_file );
+         }
+      }
+   }
+
+/* Undefine macros local to this function. */
+#undef ERRBUF_LEN
+}
+
+static void OpenSourceFile( AstChannel *this, int *status ) {
+/*
+*  Name:
+*     OpenSourceFile
+
+*  Purpose:
+*     Open the input file specified by the SourceFile attribute.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void OpenSourceFile( AstChannel *this, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function opens the file specified by the SourceFile attribute
+*     for reading, and stores its descriptor in the Channel. An error is
+*     reported if it is the same as the sink file.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Constants: */
+#define ERRBUF_LEN 80
+
+/* Local Variables: */
+   char *errstat;                /* Pointer for system error message */
+   char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
+   const char *sink_file;        /* Path to output sink file */
+   const char *source_file;      /* Path to source file */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get the path to the source file. Report an error if it is the same as
+   the sink file. */
+   source_file = astGetSourceFile( this );
+
+   if( this->fd_out ) {
+      sink_file = astGetSinkFile( this );
+      if( astOK && !strcmp( sink_file, source_file ) ) {
+         astError( AST__RDERR, "astRead(%s): Failed to open input "
+                   "SourceFile '%s' - the file is currently being used "
+                   "as the output SinkFile.", status, astGetClass( this ),
+                   source_file );
+      }
+   }
+
+/* Open the file. */
+   if( astOK ) {
+      this->fd_in = fopen( source_file, "r" );
+      if( !this->fd_in ) {
+         if ( errno ) {
+#if HAVE_STRERROR_R
+            strerror_r( errno, errbuf, ERRBUF_LEN );
+            errstat = errbuf;
+#else
+            errstat = strerror( errno );
+#endif
+            astError( AST__RDERR, "astRead(%s): Failed to open input "
+                      "SourceFile '%s' - %s.", status, astGetClass( this ),
+                      source_file, errstat );
+         } else {
+            astError( AST__RDERR, "astRead(%s): Failed to open input "
+                      "SourceFile '%s'.", status, astGetClass( this ),
+                      source_file );
+         }
+      }
+   }
+
+/* Undefine macros local to this function. */
+#undef ERRBUF_LEN
+}
+
+static void OutputTextItem( AstChannel *this, const char *line, int *status ) {
+/*
+*  Name:
+*     OutputTextItem
+
+*  Purpose:
+*     Output a data item formatted as text.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void OutputTextItem( AstChannel *this, const char *line, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function outputs a data item formatted as a text string to
+*     a data sink associated with a Channel. It keeps track of the
+*     number of items written.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     line
+*        Pointer to a constant null-terminated string containing the
+*        data item to be output (no newline character should be
+*        appended).
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Declare the thread specific global data */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the structure holding thread-specific global data. */
+   astGET_GLOBALS(this);
+
+/* Write out the line of text using the astPutNextText method (which
+   may be over-ridden). */
+   astPutNextText( this, line );
+
+/* If successful, increment the count of items written. */
+   if ( astOK ) items_written++;
+}
+
+static void PutBinaryData( AstChannel *this, const void *data, size_t size,
+                           int *status ) {
+/*
+*  Name:
+*     PutBinaryData
+
+*  Purpose:
+*     Write bytes to a binary data sink.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void PutBinaryData( AstChannel *this, const void *data, size_t size,
+*                         int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function writes bytes to the file specified by the SinkFile
+*     attribute or, if no SinkFile has been set, appends them to the
+*     memory buffer held in the Channel. The binary signature is written
+*     first if the file or buffer is currently empty.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     data
+*        Pointer to the bytes to write.
+*     size
+*        The number of bytes to write.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   size_t nmagic;                /* Number of signature bytes to write */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* If the SinkFile attribute of the Channel specifies an output file,
+   but no output file has yet been opened, open it now. */
+   if( astTestSinkFile( this ) ) {
+      if( !this->fd_out ) OpenSinkFile( this, status );
+
+/* Write the signature if this is the first binary data written to the
+   file, and then write the supplied bytes. */
+      nmagic = 0;
+      if( astOK && !this->binary_out ) {
+         nmagic = BINARY_MAGIC_LEN;
+         this->binary_out = 1;
+      }
+      if( astOK &&
+          ( fwrite( BINARY_MAGIC, 1, nmagic, this->fd_out ) < nmagic ||
+            fwrite( data, 1, size, this->fd_out ) < size ) ) {
+         astError( AST__WRERR, "astWrite(%s): Failed to write binary data "
+                   "to SinkFile '%s'.", status, astGetClass( this ),
+                   astGetSinkFile( this ) );
+      }
+
+/* Otherwise, extend the memory buffer and append the bytes to it,
+   preceded by the signature if the buffer is empty. */
+   } else {
+      if( !this->nmem_out ) {
+         this->mem_out = astGrow( this->mem_out, BINARY_MAGIC_LEN, 1 );
+         if( astOK ) {
+            memcpy( this->mem_out, BINARY_MAGIC, BINARY_MAGIC_LEN );
+            this->nmem_out = BINARY_MAGIC_LEN;
+         }
+      }
+      this->mem_out = astGrow( this->mem_out, this->nmem_out + size, 1 );
+      if( astOK ) {
+         memcpy( this->mem_out + this->nmem_out, data, size );
+         this->nmem_out += size;
+      }
+   }
+}
+
+static void PutBinaryInput( AstChannel *this, const void *data, size_t size,
+                            int *status ) {
+/*
+c++
+*  Name:
+*     astPutBinaryInput
+
+*  Purpose:
+*     Supply a memory buffer from which to read binary data.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void astPutBinaryInput( AstChannel *this, const void *data,
+*                             size_t size )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function supplies a memory buffer holding binary data, such
+*     as those returned by astGetBinaryOutput. Subsequent invocations of
+*     astRead will read Objects from this buffer, in preference to any
+*     SourceFile or source function, until the end of the buffer is
+*     reached.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     data
+*        Pointer to the binary data. The data are not copied, so the
+*        buffer must not be changed or freed until all the required
+*        Objects have been read. A NULL pointer may be supplied to
+*        stop using any previously supplied buffer.
+*     size
+*        The number of bytes of binary data.
+
+*  Applicability:
+*     Channel
+*        All Channels have this function. However, it is ignored by
+*        classes that use their own encoding, such as the FitsChan,
+*        XmlChan and YamlChan classes.
+
+*  Notes:
+*     - This routine is not available in the Fortran 77 interface to
+*     the AST library.
+c--
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Store the buffer and start reading at its beginning. */
+   this->mem_in = data;
+   this->nmem_in = data ? size : 0;
+   this->imem_in = 0;
+   this->binary_in = 0;
 }
 
-static void OutputTextItem( AstChannel *this, const char *line, int *status ) {
+static void PutBinaryItem( AstChannel *this, int type, const char *name,
+                           const void *data, size_t size, int *status ) {
 /*
 *  Name:
-*     OutputTextItem
+*     PutBinaryItem
 
 *  Purpose:
-*     Output a data item formatted as text.
+*     Write a record to a binary data sink.
 
 *  Type:
 *     Private function.
 
 *  Synopsis:
 *     #include "channel.h"
-*     void OutputTextItem( AstChannel *this, const char *line, int *status )
+*     void PutBinaryItem( AstChannel *this, int type, const char *name,
+*                         const void *data, size_t size, int *status )
 
 *  Class Membership:
 *     Channel member function.
 
 *  Description:
-*     This function outputs a data item formatted as a text string to
-*     a data sink associated with a Channel. It keeps track of the
-*     number of items written.
+*     This function writes a binary record (see GetBinaryItem) to the
+*     data sink associated with a Channel, and increments the count of
+*     items written.
 
 *  Parameters:
 *     this
 *        Pointer to the Channel.
-*     line
-*        Pointer to a constant null-terminated string containing the
-*        data item to be output (no newline character should be
-*        appended).
+*     type
+*        The record type code (one of the BINARY_... macros).
+*     name
+*        The item name, or NULL for "Begin", "IsA", "End" and "Ref" items.
+*     data
+*        Pointer to the bytes holding the value (or class name).
+*     size
+*        The number of bytes in "data".
 *     status
 *        Pointer to the inherited status variable.
 */
 
+/* Local Constants: */
+#define BUFF_LEN 200             /* Size of local record buffer */
+
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Declare the thread specific global data */
+   size_t len;                   /* Number of bytes following the header */
+   size_t nc;                    /* Number of bytes in name */
+   unsigned char buff[ BUFF_LEN ]; /* Local record buffer */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -2305,12 +3435,93 @@ static void OutputTextItem( AstChannel *this, const char *line, int *status ) {
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
-/* Write out the line of text using the astPutNextText method (which
-   may be over-ridden). */
-   astPutNextText( this, line );
+/* Form the record header, giving the type code and the number of bytes
+   in the name (including its terminating null) and value. */
+   nc = name ? strlen( name ) + 1 : 0;
+   len = nc + size;
+   if( (uint64_t) len > UINT32_MAX ) {
+      astError( AST__WRERR, "astWrite(%s): The value of '%s' is too long "
+                "for the binary encoding.", status, astGetClass( this ),
+                name ? name : "" );
+      return;
+   }
+   buff[ 0 ] = (unsigned char) type;
+   buff[ 1 ] = (unsigned char) ( len & 0xFF );
+   buff[ 2 ] = (unsigned char) ( ( len >> 8 ) & 0xFF );
+   buff[ 3 ] = (unsigned char) ( ( len >> 16 ) & 0xFF );
+   buff[ 4 ] = (unsigned char) ( ( len >> 24 ) & 0xFF );
+
+/* Most records are short, so assemble the whole record in the local
+   buffer and write it in one go. Otherwise, write each part in turn. */
+   if( BINARY_HEAD_LEN + len <= BUFF_LEN ) {
+      if( nc ) memcpy( buff + BINARY_HEAD_LEN, name, nc );
+      if( size ) memcpy( buff + BINARY_HEAD_LEN + nc, data, size );
+      PutBinaryData( this, buff, BINARY_HEAD_LEN + len, status );
+   } else {
+      PutBinaryData( this, buff, BINARY_HEAD_LEN, status );
+      if( nc ) PutBinaryData( this, name, nc, status );
+      PutBinaryData( this, data, size, status );
+   }
 
 /* If successful, increment the count of items written. */
    if ( astOK ) items_written++;
+
+/* Undefine macros local to this function. */
+#undef BUFF_LEN
+}
+
+static void PutBinaryNumber( AstChannel *this, int type, const char *name,
+                             uint64_t bits, int *status ) {
+/*
+*  Name:
+*     PutBinaryNumber
+
+*  Purpose:
+*     Write a numerical value to a binary data sink.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void PutBinaryNumber( AstChannel *this, int type, const char *name,
+*                           uint64_t bits, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function writes a binary record holding an eight byte
+*     numerical value, stored in little-endian order regardless of the
+*     byte order of the host.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     type
+*        The record type code (BINARY_DOUBLE or BINARY_INT64).
+*     name
+*        The item name.
+*     bits
+*        The bits of the value (an IEEE double or a two's complement
+*        integer).
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   int i;                        /* Byte index */
+   unsigned char bytes[ 8 ];     /* Little-endian bytes */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Store the bytes, least significant first, and write the record. */
+   for( i = 0; i < 8; i++ ) {
+      bytes[ i ] = (unsigned char) ( bits & 0xFF );
+      bits >>= 8;
+   }
+   PutBinaryItem( this, type, name, bytes, 8, status );
 }
 
 static void PutChannelData( AstChannel *this, void *data, int *status ) {
@@ -2363,6 +3574,68 @@ c--
    this->data = data;
 }
 
+static void PutNextBytes( AstChannel *this, const void *data, size_t size,
+                          int *status ) {
+/*
+*+
+*  Name:
+*     astPutNextBytes
+
+*  Purpose:
+*     Write raw bytes to the output SinkFile.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void astPutNextBytes( AstChannel *this, const void *data, size_t size )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function writes bytes to the file specified by the SinkFile
+*     attribute, immediately after the last line of text written using
+*     astPutNextText. It allows derived classes to write external formats
+*     in which binary data follows a textual header.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     data
+*        Pointer to the bytes to write.
+*     size
+*        The number of bytes to write.
+
+*  Notes:
+*     - An error is reported if no SinkFile has been specified, since
+*     sink functions can only accept lines of text.
+*-
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* If the SinkFile attribute of the Channel specifies an output file,
+   but no output file has yet been opened, open it now. */
+   if( astTestSinkFile( this ) && !this->fd_out ) OpenSinkFile( this, status );
+   if ( !astOK ) return;
+
+/* Report an error if there is no output file. */
+   if( !this->fd_out ) {
+      astError( AST__WRERR, "astWrite(%s): Binary data can only be "
+                "written to a file specified by the SinkFile attribute.",
+                status, astGetClass( this ) );
+
+/* Otherwise write the bytes. */
+   } else if( fwrite( data, 1, size, this->fd_out ) < size ) {
+      astError( AST__WRERR, "astWrite(%s): Failed to write binary data "
+                "to SinkFile '%s'.", status, astGetClass( this ),
+                astGetSinkFile( this ) );
+   }
+}
+
 static void PutNextText( AstChannel *this, const char *line, int *status ) {
 /*
 *+
@@ -2401,55 +3674,12 @@ static void PutNextText( AstChannel *this, const char *line, int *status ) {
 *-
 */
 
-/* Local Constants: */
-#define ERRBUF_LEN 80
-
-/* Local Variables: */
-   char *errstat;                /* Pointer for system error message */
-   char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
-   const char *sink_file;        /* Path to output sink file */
-   const char *source_file;      /* Path to output source file */
-
 /* Check the global error status. */
    if ( !astOK ) return;
 
 /* If the SinkFile attribute of the Channel specifies an output file,
-   but no output file has yet been opened, open it now. Report an error
-   if it is the same as the source file. */
-   if( astTestSinkFile( this ) && !this->fd_out ) {
-      sink_file = astGetSinkFile( this );
-
-      if( this->fd_out ) {
-         source_file = astGetSourceFile( this );
-         if( astOK && !strcmp( sink_file, source_file ) ) {
-            astError( AST__WRERR, "astWrite(%s): Failed to open output "
-                      "SinkFile '%s' - the file is currently being used "
-                      "as the input SourceFile.", status, astGetClass( this ),
-                      sink_file );
-         }
-      }
-
-      if( astOK ) {
-         this->fd_out = fopen( sink_file, "w" );
-         if( !this->fd_out ) {
-            if ( errno ) {
-#if HAVE_STRERROR_R
-               strerror_r( errno, errbuf, ERRBUF_LEN );
-               errstat = errbuf;
-#else
-               errstat = strerror( errno );
-#endif
-               astError( AST__WRERR, "astWrite(%s): Failed to open output "
-                         "SinkFile '%s' - %s.", status, astGetClass( this ),
-                         sink_file, errstat );
-            } else {
-               astError( AST__WRERR, "astWrite(%s): Failed to open output "
-                         "SinkFile '%s'.", status, astGetClass( this ),
-                         sink_file );
-            }
-         }
-      }
-   }
+   but no output file has yet been opened, open it now. */
+   if( astTestSinkFile( this ) && !this->fd_out ) OpenSinkFile( this, status );
 
 /* Check no error occurred above. */
    if( astOK ) {
@@ -2558,6 +3788,9 @@ f     is invoked with STATUS set to an error value, or if it should fail
    AstObject *new;               /* Pointer to new Object */
    char *class;                  /* Pointer to Object class name string */
    char *name;                   /* Pointer to data item name */
+   int id;                       /* Index of a shared Object */
+   int islot;                    /* Index of slot for shared Object */
+   int nc;                       /* Number of characters read */
    int skip;                     /* Skip non-AST data? */
    int top;                      /* Reading top-level Object definition? */
 
@@ -2599,6 +3832,26 @@ f     is invoked with STATUS set to an error value, or if it should fail
                       "read an AST Object.", status, astGetClass( this ) );
          }
 
+/* A "Ref" item within an Object definition refers to an Object that
+   has already been read as part of the same top-level Object (it was
+   written using the ShareObjects attribute). Return a clone of the
+   previously read Object. */
+      } else if ( !top && !strcmp( name, "ref" ) ) {
+         nc = 0;
+         if ( class && ( 1 == astSscanf( class, " %d %n", &id, &nc ) )
+                    && ( nc >= (int) strlen( class ) )
+                    && ( id >= 0 ) && ( id < this->nshared_in )
+                    && this->shared_in[ id ] ) {
+            new = astClone( this->shared_in[ id ] );
+         } else {
+            astError( AST__BADIN,
+                      "astRead(%s): Invalid reference to a shared Object "
+                      "(\"%s\").", status, astGetClass( this ),
+                      class ? class : "" );
+         }
+         name = astFree( name );
+         if ( class ) class = astFree( class );
+
 /* If a data item was found, check it is a "Begin" item. If not, there
    is a data item missing, so report an error and free all memory. */
       } else if ( strcmp( name, "begin" ) ) {
@@ -2617,6 +3870,21 @@ f     is invoked with STATUS set to an error value, or if it should fail
    class. This function will then be used to build the Object. */
          loader = astGetLoader( class, status );
 
+/* Objects nested within the top-level Object may be referred to by
+   later "Ref" items. Reserve a slot for the new Object in the list of
+   such Objects now, so that the slots are allocated in the order in
+   which the Objects were written (the slot is filled once the Object
+   has been built). */
+         islot = -1;
+         if ( !top ) {
+            this->shared_in = astGrow( this->shared_in, this->nshared_in + 1,
+                                       sizeof( AstObject * ) );
+            if ( astOK ) {
+               islot = this->nshared_in++;
+               this->shared_in[ islot ] = NULL;
+            }
+         }
+
 /* Extend all necessary stack arrays to accommodate entries for the
    next nesting level (this allocates space if none has yet been
    allocated). */
@@ -2685,14 +3953,21 @@ f     is invoked with STATUS set to an error value, or if it should fail
             nest--;
          }
 
+/* Store a clone of the new Object in its slot so that later "Ref"
+   items can refer to it. */
+         if ( astOK && new && islot >= 0 ) {
+            this->shared_in[ islot ] = astClone( new );
+         }
+
 /* Once the top-level Object has been built, free the memory used by
-   the stack arrays. */
+   the stack arrays and the list of Objects that may be referred to. */
          if ( top ) {
             end_of_object = astFree( end_of_object );
             object_class = astFree( object_class );
             values_class = astFree( values_class );
             values_list = astFree( values_list );
             values_ok = astFree( values_ok );
+            ResetSharedInput( this, status );
          }
       }
    }
@@ -2758,8 +4033,11 @@ static void ReadClassData( AstChannel *this, const char *class, int *status ) {
    AstChannelValue *value;       /* Pointer to Value structure */
    char *name;                   /* Pointer to data item name string */
    char *val;                    /* Pointer to data item value string */
+   double dval;                  /* Binary floating point value */
    int done;                     /* All class data read? */
    int indx;                     /* Index into hash table */
+   int type;                     /* Type of binary numerical value */
+   int64_t ival;                 /* Binary integer value */
    unsigned long hash;           /* Hash value for current name */
 
 /* Check the global error status. */
@@ -2811,8 +4089,18 @@ static void ReadClassData( AstChannel *this, const char *class, int *status ) {
       done = 0;
       while ( astOK && !done ) {
 
-/* Read the next input data item. */
-         astGetNextData( this, 0, &name, &val );
+/* Read the next input data item. If the input is binary, read the
+   binary record directly so that numerical values need not be
+   converted to and from text. */
+         dval = 0.0;
+         ival = 0;
+         if ( this->binary_in ) {
+            type = GetBinaryItem( this, 0, &name, &val, &dval, &ival, status );
+            if ( type != BINARY_DOUBLE && type != BINARY_INT64 ) type = 0;
+         } else {
+            astGetNextData( this, 0, &name, &val );
+            type = 0;
+         }
          if ( astOK ) {
 
 /* Unexpected end of input. */
@@ -2889,17 +4177,21 @@ static void ReadClassData( AstChannel *this, const char *class, int *status ) {
 /* String value. */
 /* ------------- */
 /* If any other name is obtained and "val" is not NULL, we have read a
-   non-Object value, encoded as a string. Allocate memory for a Value
-   structure to describe it. */
-            } else if ( val ) {
+   non-Object value, encoded as a string (or a numerical value read
+   from binary input). Allocate memory for a Value structure to
+   describe it. */
+            } else if ( val || type ) {
                value = astMalloc( sizeof( AstChannelValue ) );
                if ( astOK ) {
 
-/* Store pointers to the name and value string in the Value structure
-   and note this is not an Object value. */
+/* Store pointers to the name and value string (or the binary value) in
+   the Value structure and note this is not an Object value. */
                   value->name = name;
                   value->ptr.string = val;
+                  value->dval = dval;
+                  value->ival = ival;
                   value->is_object = 0;
+                  value->bintype = type;
 
 /* Append the Value structure to the values list for the current
    nesting level. */
@@ -2935,6 +4227,7 @@ static void ReadClassData( AstChannel *this, const char *class, int *status ) {
                   value->name = name;
                   value->ptr.object = object;
                   value->is_object = 1;
+                  value->bintype = 0;
 
 /* Append the Value structure to the values list for the current
    nesting level. */
@@ -3020,6 +4313,7 @@ static double ReadDouble( AstChannel *this, const char *name, double def, int *s
 
 /* Local Variables: */
    AstChannelValue *value;       /* Pointer to required Value structure */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
    double result;                /* Value to be returned */
    int nc;                       /* Number of characters read by astSscanf */
 
@@ -3037,33 +4331,38 @@ static double ReadDouble( AstChannel *this, const char *name, double def, int *s
 /* If a Value was found, check that it describes a string (as opposed
    to an Object). */
       if ( value ) {
-         if ( !value->is_object ) {
-
-/* If so, then attempt to decode the string to give a double value,
-   checking that the entire string is read (and checking for the magic string
-   used to represent bad values). If this fails, then the wrong name has
-   probably been given, or the input data are corrupt, so report an error. */
-            nc = 0;
-            if ( ( 0 == astSscanf( value->ptr.string, " " BAD_STRING " %n",
-                                                      &nc ) )
-                    && ( nc >= (int) strlen( value->ptr.string ) ) ) {
-               result = AST__BAD;
+         if ( value->bintype == BINARY_DOUBLE ) {
+            result = value->dval;
 
-            } else if ( !( ( 1 == astSscanf( value->ptr.string, " %lf %n",
-                                                      &result, &nc ) )
-                    && ( nc >= (int) strlen( value->ptr.string ) ) ) ) {
-               astError( AST__BADIN,
-                         "astRead(%s): The value \"%s = %s\" cannot "
-                         "be read as a double precision floating point "
-                         "number.", status, astGetClass( this ),
-                         value->name, value->ptr.string );
+         } else if ( value->bintype == BINARY_INT64 ) {
+            result = (double) value->ival;
 
-            } else if( !astISFINITE( result ) ) {
-               astError( AST__BADIN,
-                         "astRead(%s): Illegal double precision floating "
-                         "point value \"%s\" read for \"%s\".", status,
-                         astGetClass( this ), value->ptr.string, value->name );
+         } else if ( !value->is_object ) {
 
+/* If so, then attempt to decode the string to give a double value.
+   Most strings are simple numerical values, which astChr2Double reads
+   quickly. It returns AST__BAD for anything else, in which case check
+   that the entire string is read (and check for the magic string used
+   to represent bad values). If this fails, then the wrong name has
+   probably been given, or the input data are corrupt, so report an
+   error. */
+            result = astChr2Double( value->ptr.string );
+            if( result == AST__BAD ) {
+               nc = 0;
+               if ( ( 0 == astSscanf( value->ptr.string, " " BAD_STRING " %n",
+                                                         &nc ) )
+                       && ( nc >= (int) strlen( value->ptr.string ) ) ) {
+                  result = AST__BAD;
+
+               } else if ( !( ( 1 == astSscanf( value->ptr.string, " %lf %n",
+                                                         &result, &nc ) )
+                       && ( nc >= (int) strlen( value->ptr.string ) ) ) ) {
+                  astError( AST__BADIN,
+                            "astRead(%s): The value \"%s = %s\" cannot "
+                            "be read as a double precision floating point "
+                            "number.", status, astGetClass( this ),
+                            value->name, value->ptr.string );
+               }
             }
 
 /* Report a similar error if the Value does not describe a string. */
@@ -3075,6 +4374,16 @@ static double ReadDouble( AstChannel *this, const char *name, double def, int *s
                       value->name, astGetClass( value->ptr.object ) );
          }
 
+/* Report an error if a non-finite value was read. */
+         if( astOK && !value->is_object && result != AST__BAD &&
+             !astISFINITE( result ) ) {
+            astError( AST__BADIN,
+                      "astRead(%s): Illegal double precision floating "
+                      "point value \"%s\" read for \"%s\".", status,
+                      astGetClass( this ), FormatValue( value, buff, status ),
+                      value->name );
+         }
+
 /* Free the Value structure and the resources it points at. */
          value = FreeValue( value, status );
 
@@ -3146,8 +4455,10 @@ static int ReadInt( AstChannel *this, const char *name, int def, int *status ) {
 
 /* Local Variables: */
    AstChannelValue *value;       /* Pointer to required Value structure */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
    int nc;                       /* Number of characters read by astSscanf */
    int result;                   /* Value to be returned */
+   int64_t ival;                 /* Binary integer value */
 
 /* Initialise. */
    result = 0;
@@ -3163,7 +4474,21 @@ static int ReadInt( AstChannel *this, const char *name, int def, int *status ) {
 /* If a Value was found, check that it describes a string (as opposed
    to an Object). */
       if ( value ) {
-         if ( !value->is_object ) {
+
+/* Numerical values read from binary input must be integers within the
+   range of an int. */
+         if ( value->bintype ) {
+            if ( IntegerValue( value, &ival, status ) &&
+                 ival >= INT_MIN && ival <= INT_MAX ) {
+               result = (int) ival;
+            } else {
+               astError( AST__BADIN,
+                         "astRead(%s): The value \"%s = %s\" cannot "
+                         "be read as an integer.", status, astGetClass( this ),
+                         value->name, FormatValue( value, buff, status ) );
+            }
+
+         } else if ( !value->is_object ) {
 
 /* If so, then attempt to decode the string to give an int value,
    checking that the entire string is read. If this fails, then the
@@ -3258,6 +4583,7 @@ static int64_t ReadInt64( AstChannel *this, const char *name, int64_t def, int *
 
 /* Local Variables: */
    AstChannelValue *value;       /* Pointer to required Value structure */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
    int nc;                       /* Number of characters read by astSscanf */
    int64_t result;               /* Value to be returned */
 
@@ -3275,7 +4601,18 @@ static int64_t ReadInt64( AstChannel *this, const char *name, int64_t def, int *
 /* If a Value was found, check that it describes a string (as opposed
    to an Object). */
       if ( value ) {
-         if ( !value->is_object ) {
+
+/* Numerical values read from binary input must be integers. */
+         if ( value->bintype ) {
+            if ( !IntegerValue( value, &result, status ) ) {
+               astError( AST__BADIN,
+                         "astRead(%s): The value \"%s = %s\" cannot "
+                         "be read as a 64 bit integer.", status,
+                         astGetClass( this ), value->name,
+                         FormatValue( value, buff, status ) );
+            }
+
+         } else if ( !value->is_object ) {
 
 /* If so, then attempt to decode the string to give an int value,
    checking that the entire string is read. If this fails, then the
@@ -3375,6 +4712,7 @@ static AstObject *ReadObject( AstChannel *this, const char *name,
 /* Local Variables: */
    AstObject *result;            /* Pointer value to return */
    AstChannelValue *value;       /* Pointer to required Value structure */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
 
 /* Initialise. */
    result = NULL;
@@ -3403,7 +4741,7 @@ static AstObject *ReadObject( AstChannel *this, const char *name,
             astError( AST__BADIN,
                       "astRead(%s): The value \"%s = %s\" cannot be "
                       "read as an Object.", status, astGetClass( this ),
-                      value->name, value->ptr.string );
+                      value->name, FormatValue( value, buff, status ) );
          }
 
 /* Free the Value structure and the resources it points at. */
@@ -3488,6 +4826,7 @@ static char *ReadString( AstChannel *this, const char *name,
 /* Local Variables: */
    AstChannelValue *value;       /* Pointer to required Value structure */
    char *result;                 /* Pointer value to return */
+   char buff[ VALUE_BUFF_LEN ];  /* Buffer for formatting binary values */
 
 /* Initialise. */
    result = NULL;
@@ -3503,7 +4842,14 @@ static char *ReadString( AstChannel *this, const char *name,
 /* If a Value was found, check that it describes a string (as opposed
    to an Object). */
       if ( value ) {
-         if ( !value->is_object ) {
+
+/* Numerical values read from binary input are returned in the form
+   they would have in textual input. */
+         if ( value->bintype ) {
+            (void) FormatValue( value, buff, status );
+            result = astString( buff, strlen( buff ) );
+
+         } else if ( !value->is_object ) {
 
 /* If so, then extract the string pointer, replacing it with NULL. */
             result = value->ptr.string;
@@ -3557,39 +4903,139 @@ static void RemoveValue( AstChannelValue *value, AstChannelValue **head, int *st
 *     updated to point at the element following the one removed.
 
 *  Parameters:
-*     value
-*        Pointer to the structure to be removed (note that this must
-*        actually be in the list, although this function does not
-*        check).
-*     head
-*        Address of a pointer to the element at the head of the
-*        list. This pointer will be updated to point at the list
-*        element that follows the one removed. If the list becomes
-*        empty, the pointer will be set to NULL.
-*     status
-*        Pointer to the inherited status variable.
+*     value
+*        Pointer to the structure to be removed (note that this must
+*        actually be in the list, although this function does not
+*        check).
+*     head
+*        Address of a pointer to the element at the head of the
+*        list. This pointer will be updated to point at the list
+*        element that follows the one removed. If the list becomes
+*        empty, the pointer will be set to NULL.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function does not perform error chacking and does not
+*     generate errors.
+*/
+
+/* Remove the Value structure from the list by re-establishing links
+   between the elements on either side of it. */
+   value->blink->flink = value->flink;
+   value->flink->blink = value->blink;
+
+/* Update the head of list pointer to identify the following
+   element. */
+   *head = value->flink;
+
+/* If the head of list identifies the removed element, then note that
+   the list is now empty. */
+   if ( *head == value ) *head = NULL;
+
+/* Make the removed element point at itself. */
+   value->flink = value;
+   value->blink = value;
+}
+
+static void ResetSharedInput( AstChannel *this, int *status ) {
+/*
+*  Name:
+*     ResetSharedInput
+
+*  Purpose:
+*     Release the Objects read so far by the current top-level astRead.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void ResetSharedInput( AstChannel *this, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function annuls the references held to each of the Object
+*     values read so far by the current top-level invocation of
+*     astRead, and empties the list holding them. These references
+*     allow "Ref" items to be resolved (see astShareObject).
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*/
+
+/* Local Variables: */
+   int i;                        /* Index of Object */
+
+/* Annul each Object reference (some elements may be NULL if an error
+   occurred while reading the Object), and then free the list. */
+   for ( i = 0; i < this->nshared_in; i++ ) {
+      if ( this->shared_in[ i ] ) {
+         this->shared_in[ i ] = astAnnul( this->shared_in[ i ] );
+      }
+   }
+   this->shared_in = astFree( this->shared_in );
+   this->nshared_in = 0;
+}
+
+static void ResetSharedObjects( AstChannel *this, int *status ) {
+/*
+*+
+*  Name:
+*     astResetSharedObjects
+
+*  Purpose:
+*     Forget the Objects written so far by astShareObject.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void astResetSharedObjects( AstChannel *this )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function empties the list of Objects recorded by
+*     astShareObject, so that Objects written subsequently will not be
+*     written as references to any Object written previously. It is
+*     invoked at the end of each top-level invocation of astWrite.
+*     Derived classes that over-ride astWrite should also invoke it
+*     once the top-level Object has been written.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
 
 *  Notes:
-*     - This function does not perform error chacking and does not
-*     generate errors.
+*     - This function attempts to execute even if the global error
+*     status is set.
+*-
 */
 
-/* Remove the Value structure from the list by re-establishing links
-   between the elements on either side of it. */
-   value->blink->flink = value->flink;
-   value->flink->blink = value->blink;
-
-/* Update the head of list pointer to identify the following
-   element. */
-   *head = value->flink;
-
-/* If the head of list identifies the removed element, then note that
-   the list is now empty. */
-   if ( *head == value ) *head = NULL;
-
-/* Make the removed element point at itself. */
-   value->flink = value;
-   value->blink = value;
+/* Local Variables: */
+   int i;                        /* Index of Object */
+
+/* The list holds a reference to each Object so that the memory used by
+   any temporary Object created while writing is not re-used for
+   another Object before the write is complete. Annul these references
+   and free the list. */
+   for ( i = 0; i < this->nshared_out; i++ ) {
+      this->shared_out[ i ] = astAnnul( this->shared_out[ i ] );
+   }
+   this->shared_out = astFree( this->shared_out );
+   this->nshared_out = 0;
 }
 
 static void SetAttrib( AstObject *this_object, const char *setting, int *status ) {
@@ -3635,12 +5081,14 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
 
 /* Local Variables: */
    AstChannel *this;             /* Pointer to the Channel structure */
+   int binary;                   /* Binary attribute value */
    int comment;                  /* Comment attribute value */
    int full;                     /* Full attribute value */
    int indent;                   /* Indent attribute value */
    int len;                      /* Length of setting string */
    int nc;                       /* Number of characters read by "astSscanf" */
    int report_level;             /* Skip attribute value */
+   int shareobjects;             /* ShareObjects attribute value */
    int skip;                     /* Skip attribute value */
    int sourcefile;               /* Offset of SourceFile string */
    int sinkfile;                 /* Offset of SinkFile string */
@@ -3661,9 +5109,16 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
    in "nc" to check that the entire string was matched. Once a value
    has been obtained, use the appropriate method to set it. */
 
+/* Binary. */
+/* ------- */
+   if ( nc = 0,
+        ( 1 == astSscanf( setting, "binary= %d %n", &binary, &nc ) )
+        && ( nc >= len ) ) {
+      astSetBinary( this, binary );
+
 /* Comment. */
 /* ---------*/
-   if ( nc = 0,
+   } else if ( nc = 0,
         ( 1 == astSscanf( setting, "comment= %d %n", &comment, &nc ) )
         && ( nc >= len ) ) {
       astSetComment( this, comment );
@@ -3689,6 +5144,14 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
                && ( nc >= len ) ) {
       astSetReportLevel( this, report_level );
 
+/* ShareObjects. */
+/* ------------- */
+   } else if ( nc = 0,
+               ( 1 == astSscanf( setting, "shareobjects= %d %n",
+                                 &shareobjects, &nc ) )
+               && ( nc >= len ) ) {
+      astSetShareObjects( this, shareobjects );
+
 /* Skip. */
 /* ----- */
    } else if ( nc = 0,
@@ -3724,6 +5187,105 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
    }
 }
 
+static int ShareObject( AstChannel *this, AstObject *object, int *new,
+                        int *status ) {
+/*
+*+
+*  Name:
+*     astShareObject
+
+*  Purpose:
+*     Find or record an Object that is to be written.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     int astShareObject( AstChannel *this, AstObject *object, int *new )
+
+*  Class Membership:
+*     Channel method.
+
+*  Description:
+*     This function should be invoked by implementations of
+*     astWriteObject before they write out an Object value that is not
+*     a default value. If the ShareObjects attribute of the Channel is
+*     non-zero, it searches the list of Object values that have already
+*     been written out by the current top-level invocation of astWrite.
+*     If the supplied Object is found, its index within the list is
+*     returned and "*new" is returned zero, indicating that a reference
+*     to the earlier Object value should be written in place of the
+*     Object. Otherwise, the Object is appended to the list, its new
+*     index is returned and "*new" is returned non-zero, indicating
+*     that the Object should be written out in full.
+*
+*     Indices are allocated in the order in which Object values are
+*     written, starting at zero (the top-level Object itself is not
+*     included). Formats in which Object values are read back in the
+*     order in which they were written (such as that used by the
+*     Channel class) may therefore identify the referenced Object by
+*     counting the Object values read so far.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     object
+*        Pointer to the Object value that is about to be written.
+*     new
+*        Address of an int in which to return a flag indicating if the
+*        Object has not previously been written out. Always returned
+*        non-zero if the ShareObjects attribute is zero.
+
+*  Returned Value:
+*     The index of the Object within the list of Objects written so
+*     far, or -1 if the ShareObjects attribute is zero.
+
+*  Notes:
+*     - Objects are compared by identity (i.e. only a clone of an
+*     Object is considered to be the same Object).
+*     - A value of -1 will be returned (with "*new" non-zero) if this
+*     function is invoked with the global error status set, or if it
+*     should fail for any reason.
+*-
+*/
+
+/* Local Variables: */
+   int i;                        /* Index of Object within list */
+   int result;                   /* Returned index */
+
+/* Initialise. */
+   result = -1;
+   *new = 1;
+
+/* Check the global error status. Also return if shared Objects are not
+   to be detected. */
+   if ( !astOK || !astGetShareObjects( this ) ) return result;
+
+/* Search the list of Objects written so far. */
+   for ( i = 0; i < this->nshared_out; i++ ) {
+      if ( this->shared_out[ i ] == object ) {
+         result = i;
+         *new = 0;
+         break;
+      }
+   }
+
+/* If the Object has not been written before, append a new reference to
+   it to the end of the list (see astResetSharedObjects). */
+   if ( *new ) {
+      this->shared_out = astGrow( this->shared_out, this->nshared_out + 1,
+                                  sizeof( AstObject * ) );
+      if ( astOK ) {
+         result = this->nshared_out++;
+         this->shared_out[ result ] = astClone( object );
+      }
+   }
+
+/* Return the index. */
+   return result;
+}
+
 static void SinkWrap( void (* sink)( const char * ), const char *line, int *status ) {
 /*
 *  Name:
@@ -3936,9 +5498,14 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
 
 /* Check the attribute name and test the appropriate attribute. */
 
+/* Binary. */
+/* ------- */
+   if ( !strcmp( attrib, "binary" ) ) {
+      result = astTestBinary( this );
+
 /* Comment. */
 /* -------- */
-   if ( !strcmp( attrib, "comment" ) ) {
+   } else if ( !strcmp( attrib, "comment" ) ) {
       result = astTestComment( this );
 
 /* Full. */
@@ -3956,6 +5523,11 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
    } else if ( !strcmp( attrib, "reportlevel" ) ) {
       result = astTestReportLevel( this );
 
+/* ShareObjects. */
+/* ------------- */
+   } else if ( !strcmp( attrib, "shareobjects" ) ) {
+      result = astTestShareObjects( this );
+
 /* Skip. */
 /* ----- */
    } else if ( !strcmp( attrib, "skip" ) ) {
@@ -4225,8 +5797,12 @@ f     with STATUS set to an error value, or if it should fail for any
    encapsulated within the astWrite method (which belongs to the
    Channel) is simply a trick to allow it to be over-ridden either by
    a derived Channel, or a derived Object (or both), and hence to
-   adapt to the nature of either argument. */
+   adapt to the nature of either argument. Keep track of the nesting
+   depth so that the list of Objects used to detect shared Objects can
+   be reset once the top-level Object has been written. */
+   this->write_depth++;
    astDump( object, this );
+   if ( !--this->write_depth ) astResetSharedObjects( this );
 
 /* Ensure all output is flushed to any associated output file specified
    by the SinkFile attribute. */
@@ -4291,6 +5867,16 @@ static void WriteBegin( AstChannel *this, const char *class,
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
+/* If the binary encoding is in use, write a "Begin" record giving the
+   class name and clear the count of items written for this Object.
+   Indentation is not used. */
+   if ( astGetBinary( this ) ) {
+      PutBinaryItem( this, BINARY_BEGIN, NULL, class, strlen( class ),
+                     status );
+      items_written = 0;
+      return;
+   }
+
 /* Start building a dynamic string with an initial space. Then add
    further spaces to suit the current indentation level. */
    line = astAppendString( NULL, &nc, " " );
@@ -4417,6 +6003,7 @@ static void WriteDouble( AstChannel *this, const char *name,
    char buff[ BUFF_LEN + 1 ];    /* Local formatting buffer */
    int i;                        /* Loop counter for indentation characters */
    int nc;                       /* Number of output characters */
+   uint64_t bits;                /* Bits of the value */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -4424,10 +6011,19 @@ static void WriteDouble( AstChannel *this, const char *name,
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
-/* Use the "set" and "helpful" flags, along with the Channel's
+/* If the binary encoding is in use, write "set" values only (default
+   values are never read back), storing the bits of the value directly
+   so that no formatting is needed. */
+   if ( astGetBinary( this ) ) {
+      if ( set ) {
+         memcpy( &bits, &value, sizeof( bits ) );
+         PutBinaryNumber( this, BINARY_DOUBLE, name, bits, status );
+      }
+
+/* Otherwise, use the "set" and "helpful" flags, along with the Channel's
    attributes to decide whether this value should actually be
    written. */
-   if ( Use( this, set, helpful, status ) ) {
+   } else if ( Use( this, set, helpful, status ) ) {
 
 /* Start building a dynamic string with an initial space, or a comment
    character if "set" is zero. Then add further spaces to suit the
@@ -4441,10 +6037,11 @@ static void WriteDouble( AstChannel *this, const char *name,
       line = astAppendString( line, &nc, name );
       line = astAppendString( line, &nc, " = " );
 
-/* Format the value as a string and append this. Make sure "-0" isn't
-   produced. Use a magic string to represent bad values. */
+/* Format the value as a string and append this, using the fewest digits
+   that will read back exactly. Make sure "-0" isn't produced. Use a magic
+   string to represent bad values. */
       if( value != AST__BAD ) {
-         (void) sprintf( buff, "%.*g", AST__DBL_DIG, value );
+         (void) astDouble2Chr( value, AST__DBL_DIG, buff );
          if ( !strcmp( buff, "-0" ) ) {
             buff[ 0 ] = '0';
             buff[ 1 ] = '\0';
@@ -4517,6 +6114,13 @@ static void WriteEnd( AstChannel *this, const char *class, int *status ) {
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
+/* If the binary encoding is in use, write an "End" record giving the
+   class name. */
+   if ( astGetBinary( this ) ) {
+      PutBinaryItem( this, BINARY_END, NULL, class, strlen( class ), status );
+      return;
+   }
+
 /* Decrement the indentation level so that the "End" item matches the
    corresponding "Begin" item. */
    current_indent -= astGetIndent( this );
@@ -4678,10 +6282,18 @@ static void WriteInt( AstChannel *this, const char *name, int set, int helpful,
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
-/* Use the "set" and "helpful" flags, along with the Channel's
+/* If the binary encoding is in use, write "set" values only, storing
+   them as 64 bit integers. */
+   if ( astGetBinary( this ) ) {
+      if ( set ) {
+         PutBinaryNumber( this, BINARY_INT64, name,
+                          (uint64_t) (int64_t) value, status );
+      }
+
+/* Otherwise, use the "set" and "helpful" flags, along with the Channel's
    attributes to decide whether this value should actually be
    written. */
-   if ( Use( this, set, helpful, status ) ) {
+   } else if ( Use( this, set, helpful, status ) ) {
 
 /* Start building a dynamic string with an initial space, or a comment
    character if "set" is zero. Then add further spaces to suit the
@@ -4819,10 +6431,18 @@ static void WriteInt64( AstChannel *this, const char *name, int set, int helpful
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
-/* Use the "set" and "helpful" flags, along with the Channel's
+/* If the binary encoding is in use, write "set" values only, storing
+   them as 64 bit integers. */
+   if ( astGetBinary( this ) ) {
+      if ( set ) {
+         PutBinaryNumber( this, BINARY_INT64, name,
+                          (uint64_t) (int64_t) value, status );
+      }
+
+/* Otherwise, use the "set" and "helpful" flags, along with the Channel's
    attributes to decide whether this value should actually be
    written. */
-   if ( Use( this, set, helpful, status ) ) {
+   } else if ( Use( this, set, helpful, status ) ) {
 
 /* Start building a dynamic string with an initial space, or a comment
    character if "set" is zero. Then add further spaces to suit the
@@ -4955,6 +6575,15 @@ static void WriteIsA( AstChannel *this, const char *class,
    information). */
    if ( items_written || astGetFull( this ) > 0 ) {
 
+/* If the binary encoding is in use, write an "IsA" record giving the
+   class name. */
+      if ( astGetBinary( this ) ) {
+         PutBinaryItem( this, BINARY_ISA, NULL, class, strlen( class ),
+                        status );
+         items_written = 0;
+         return;
+      }
+
 /* Start building a dynamic string with an initial space. Then add
    further spaces to suit the current indentation level, but reduced
    by one to allow the "IsA" item to match the "Begin" and "End" items
@@ -5078,8 +6707,10 @@ static void WriteObject( AstChannel *this, const char *name,
    astDECLARE_GLOBALS            /* Declare the thread specific global data */
    char *line;                   /* Pointer to dynamic output string */
    int i;                        /* Loop counter for indentation characters */
+   int id;                       /* Index of a shared Object */
    int indent_inc;               /* Indentation increment */
    int nc;                       /* Number of output characters */
+   int new;                      /* Object not written previously? */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -5087,10 +6718,24 @@ static void WriteObject( AstChannel *this, const char *name,
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
-/* Use the "set" and "helpful" flags, along with the Channel's
+/* If the binary encoding is in use, write an "Object" record holding
+   just the name, followed by the Object itself. Default values are
+   omitted. */
+   if ( astGetBinary( this ) ) {
+      if ( set ) {
+         PutBinaryItem( this, BINARY_OBJECT, name, NULL, 0, status );
+         id = astShareObject( this, value, &new );
+         if ( new ) {
+            (void) astWrite( this, value );
+         } else {
+            WriteRef( this, id, status );
+         }
+      }
+
+/* Otherwise, use the "set" and "helpful" flags, along with the Channel's
    attributes to decide whether this value should actually be
    written. */
-   if ( Use( this, set, helpful, status ) ) {
+   } else if ( Use( this, set, helpful, status ) ) {
 
 /* Start building a dynamic string with an initial space, or a comment
    character if "set" is zero. Then add further spaces to suit the
@@ -5120,16 +6765,90 @@ static void WriteObject( AstChannel *this, const char *name,
 
 /* If the value is not a default, write the Object to the Channel as
    well, suitably indented (this is omitted if the value is commented
-   out). */
+   out). If the Object has already been written out and shared Objects
+   are being detected, write a reference to it instead. */
       if ( set ) {
          indent_inc = astGetIndent( this );
          current_indent += indent_inc;
-         (void) astWrite( this, value );
+         id = astShareObject( this, value, &new );
+         if ( new ) {
+            (void) astWrite( this, value );
+         } else {
+            WriteRef( this, id, status );
+         }
          current_indent -= indent_inc;
       }
    }
 }
 
+static void WriteRef( AstChannel *this, int id, int *status ) {
+/*
+*  Name:
+*     WriteRef
+
+*  Purpose:
+*     Write a "Ref" data item to a data sink.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "channel.h"
+*     void WriteRef( AstChannel *this, int id, int *status )
+
+*  Class Membership:
+*     Channel member function.
+
+*  Description:
+*     This function writes a "Ref" data item to the data sink associated
+*     with a Channel, in place of the definition of an Object value that
+*     has already been written out. The item identifies the earlier
+*     Object value by its index, as returned by astShareObject.
+
+*  Parameters:
+*     this
+*        Pointer to the Channel.
+*     id
+*        The index of the Object value that is being referred to.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Declare the thread specific global data */
+   char *line;                   /* Pointer to dynamic output string */
+   char buff[ 20 ];              /* Formatted index */
+   int i;                        /* Loop counter for indentation characters */
+   int nc;                       /* Number of output characters */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the structure holding thread-specific global data. */
+   astGET_GLOBALS(this);
+
+/* Format the index. */
+   (void) sprintf( buff, "%d", id );
+
+/* If the binary encoding is in use, write a "Ref" record holding the
+   formatted index. */
+   if ( astGetBinary( this ) ) {
+      PutBinaryItem( this, BINARY_REF, NULL, buff, strlen( buff ), status );
+
+/* Otherwise, write a line holding the "Ref" keyword followed by the
+   index, indented to match a "Begin" item. */
+   } else {
+      line = astAppendString( NULL, &nc, " " );
+      for ( i = 0; i < current_indent; i++ ) {
+         line = astAppendString( line, &nc, " " );
+      }
+      line = astAppendString( line, &nc, "Ref " );
+      line = astAppendString( line, &nc, buff );
+      OutputTextItem( this, line, status );
+      line = astFree( line );
+   }
+}
+
 static void WriteString( AstChannel *this, const char *name,
                          int set, int helpful,
                          const char *value, const char *comment, int *status ) {
@@ -5233,10 +6952,18 @@ static void WriteString( AstChannel *this, const char *name,
 /* Get a pointer to the structure holding thread-specific global data. */
    astGET_GLOBALS(this);
 
-/* Use the "set" and "helpful" flags, along with the Channel's
+/* If the binary encoding is in use, write "set" values only. The string
+   is stored verbatim, so no quoting is needed. */
+   if ( astGetBinary( this ) ) {
+      if ( set ) {
+         PutBinaryItem( this, BINARY_STRING, name, value, strlen( value ),
+                        status );
+      }
+
+/* Otherwise, use the "set" and "helpful" flags, along with the Channel's
    attributes to decide whether this value should actually be
    written. */
-   if ( Use( this, set, helpful, status ) ) {
+   } else if ( Use( this, set, helpful, status ) ) {
 
 /* Start building a dynamic string with an initial space, or a comment
    character if "set" is zero. Then add further spaces to suit the
@@ -5457,6 +7184,150 @@ astMAKE_SET(Channel,SinkFile,const char *,fn_out,((this->fd_out=(this->fd_out?(f
 /* The SinkFile value is set if the pointer to it is not NULL. */
 astMAKE_TEST(Channel,SinkFile,( this->fn_out != NULL ))
 
+/*
+*att++
+*  Name:
+*     Binary
+
+*  Purpose:
+*     Write Objects using a compact binary encoding?
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer (boolean).
+
+*  Description:
+*     This is a boolean attribute which controls whether Objects
+*     written to a Channel are described using a compact binary
+*     encoding rather than the usual textual format. The binary
+*     encoding contains the same items as the textual format, but
+*     stores floating point and integer values as raw little-endian
+*     8-byte values, and omits all comments and default values. It is
+*     faster to write and to read, and is usually considerably smaller.
+*
+*     If Binary is non-zero, binary data are written to the file
+*     specified by the SinkFile attribute. If no SinkFile has been
+*     set, the binary data are instead appended to a memory buffer
+*     held within the Channel, which may be retrieved using
+c     astGetBinaryOutput.
+f     the C function astGetBinaryOutput.
+*     Binary data are never passed to a sink function, or written to
+*     standard output. If Binary is zero (the default), the textual
+*     format is used.
+*
+*     There is no need to set this attribute when reading. Binary data
+*     are recognised automatically when they are read from a SourceFile,
+*     or from a memory buffer supplied using
+c     astPutBinaryInput.
+f     the C function astPutBinaryInput.
+
+*  Applicability:
+*     Channel
+*        All Channels have this attribute.
+*     FitsChan
+*        This attribute is ignored by the FitsChan class.
+*     MocChan
+*        This attribute is ignored by the MocChan class.
+*     StcsChan
+*        This attribute is ignored by the StcsChan class.
+*     XmlChan
+*        This attribute is ignored by the XmlChan class.
+*     YamlChan
+*        This attribute is ignored by the YamlChan class.
+
+*  Notes:
+*     - Binary and textual output should not be mixed in the same
+*     SinkFile, since the encoding is recognised only at the start of
+*     the file.
+*att--
+*/
+
+/* This is a boolean value (0 or 1) with a value of -INT_MAX when
+   undefined but yielding a default of zero. */
+astMAKE_CLEAR(Channel,Binary,binary,-INT_MAX)
+astMAKE_GET(Channel,Binary,int,0,( this->binary != -INT_MAX ? this->binary : 0 ))
+astMAKE_SET(Channel,Binary,int,binary,( value != 0 ))
+astMAKE_TEST(Channel,Binary,( this->binary != -INT_MAX ))
+
+/*
+*att++
+*  Name:
+*     ShareObjects
+
+*  Purpose:
+*     Write shared Objects only once?
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer (boolean).
+
+*  Description:
+*     This is a boolean attribute which controls how an Object is
+*     written if it refers to the same sub-Object more than once. For
+*     instance, a FrameSet may use the same Frame or Mapping in
+*     several places, and a Region may use the same Frame as a
+*     FrameSet within the same Plot.
+*
+*     If ShareObjects is zero (the default), a full description of the
+*     sub-Object is written out each time it is used, and each
+*     description creates a separate Object when read back.
+*
+*     If ShareObjects is non-zero, a full description of the sub-Object
+*     is written out only the first time it is used within each Object
+*     written using
+c     astWrite.
+f     AST_WRITE.
+*     Later uses are written as references to that first description.
+*     When read back, each reference creates a new reference to the
+*     same single Object (i.e. a clone), thus re-creating the sharing
+*     that existed within the Object that was written. This reduces
+*     both the size of the output and the time taken to read it back.
+*
+*     There is no need to set this attribute when reading, since
+*     references are recognised automatically.
+
+*  Applicability:
+*     Channel
+*        All Channels have this attribute.
+*     FitsChan
+*        This attribute is ignored by the FitsChan class.
+*     MocChan
+*        This attribute is ignored by the MocChan class.
+*     StcsChan
+*        This attribute is ignored by the StcsChan class.
+*     XmlChan
+*        When writing with XmlFormat set to NATIVE or QUOTED, references
+*        are described by "_ref" elements containing an "id" attribute
+*        that matches the "id" attribute of the element describing the
+*        first use of the sub-Object.
+*     YamlChan
+*        When writing with YamlEncoding set to NATIVE, each sub-Object
+*        is given a YAML anchor, and later uses are written as YAML
+*        aliases that refer to the anchor. This attribute is ignored
+*        when using the ASDF encoding.
+
+*  Notes:
+*     - Sub-Objects are shared only if they are the same Object (that
+*     is, references to the same Object, as created by
+c     astClone).
+f     AST_CLONE).
+*     Copies of an Object are always written out in full.
+*     - Data written with ShareObjects set cannot be read by versions
+*     of AST that pre-date the introduction of this attribute.
+*att--
+*/
+
+/* This is a boolean value (0 or 1) with a value of -INT_MAX when
+   undefined but yielding a default of zero. */
+astMAKE_CLEAR(Channel,ShareObjects,shareobjects,-INT_MAX)
+astMAKE_GET(Channel,ShareObjects,int,0,( this->shareobjects != -INT_MAX ? this->shareobjects : 0 ))
+astMAKE_SET(Channel,ShareObjects,int,shareobjects,( value != 0 ))
+astMAKE_TEST(Channel,ShareObjects,( this->shareobjects != -INT_MAX ))
+
 
 /*
 *att++
@@ -5839,6 +7710,14 @@ static void Delete( AstObject *obj, int *status ) {
 /* Free file name memory. */
    this->fn_in = astFree( this->fn_in );
    this->fn_out = astFree( this->fn_out );
+
+/* Free any binary output that has not been retrieved. The binary input
+   buffer belongs to the caller. */
+   this->mem_out = astFree( this->mem_out );
+
+/* Release any Objects held in the lists of shared Objects. */
+   ResetSharedObjects( this, status );
+   ResetSharedInput( this, status );
 }
 
 /* Copy constructor. */
@@ -5888,6 +7767,18 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->fn_in = NULL;
    out->fd_out = NULL;
    out->fn_out = NULL;
+   out->binary_in = 0;
+   out->binary_out = 0;
+   out->mem_in = NULL;
+   out->nmem_in = 0;
+   out->imem_in = 0;
+   out->mem_out = NULL;
+   out->nmem_out = 0;
+   out->write_depth = 0;
+   out->shared_out = NULL;
+   out->nshared_out = 0;
+   out->shared_in = NULL;
+   out->nshared_in = 0;
 }
 
 /* Dump function. */
@@ -5995,6 +7886,22 @@ static void Dump( AstObject *this_object, AstChannel *channel, int *status ) {
    astWriteInt( channel, "Comm", set, 0, ival,
                 ival ? "Display comments" :
                        "Omit comments" );
+
+/* Binary. */
+/* ------- */
+   set = TestBinary( this, status );
+   ival = set ? GetBinary( this, status ) : astGetBinary( this );
+   astWriteInt( channel, "Binary", set, 0, ival,
+                ival ? "Write binary data" :
+                       "Write text" );
+
+/* ShareObjects. */
+/* ------------- */
+   set = TestShareObjects( this, status );
+   ival = set ? GetShareObjects( this, status ) : astGetShareObjects( this );
+   astWriteInt( channel, "ShrObj", set, 0, ival,
+                ival ? "Write shared Objects once" :
+                       "Write shared Objects in full" );
 }
 
 /* Standard class functions. */
@@ -6655,6 +8562,23 @@ AstChannel *astLoadChannel_( void *mem, size_t size,
       new->fd_out = NULL;
       new->fn_out = NULL;
 
+/* Indicate no binary data have been read or written, and no memory
+   buffers are in use. */
+      new->binary_in = 0;
+      new->binary_out = 0;
+      new->mem_in = NULL;
+      new->nmem_in = 0;
+      new->imem_in = 0;
+      new->mem_out = NULL;
+      new->nmem_out = 0;
+
+/* Indicate no shared Objects have been read or written. */
+      new->write_depth = 0;
+      new->shared_out = NULL;
+      new->nshared_out = 0;
+      new->shared_in = NULL;
+      new->nshared_in = 0;
+
 /* Now read each individual data item from this list and use it to
    initialise the appropriate instance variable(s) for this class. */
 
@@ -6695,6 +8619,18 @@ AstChannel *astLoadChannel_( void *mem, size_t size,
       new->comment = astReadInt( channel, "comm", -INT_MAX );
       if ( TestComment( new, status ) ) SetComment( new, new->comment, status );
 
+/* Binary. */
+/* ------- */
+      new->binary = astReadInt( channel, "binary", -INT_MAX );
+      if ( TestBinary( new, status ) ) SetBinary( new, new->binary, status );
+
+/* ShareObjects. */
+/* ------------- */
+      new->shareobjects = astReadInt( channel, "shrobj", -INT_MAX );
+      if ( TestShareObjects( new, status ) ) SetShareObjects( new,
+                                                              new->shareobjects,
+                                                              status );
+
 /* If an error occurred, clean up by deleting the new Channel. */
       if ( !astOK ) new = astDelete( new );
    }
@@ -6715,6 +8651,10 @@ AstChannel *astLoadChannel_( void *mem, size_t size,
    Note that the member function may not be the one defined here, as
    it may have been over-ridden by a derived class. However, it should
    still have the same interface. */
+size_t astGetNextBytes_( AstChannel *this, void *data, size_t size, int *status ) {
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Channel,GetNextBytes))( this, data, size, status );
+}
 void astGetNextData_( AstChannel *this, int begin, char **name, char **val, int *status ) {
    *name = NULL;
    *val = NULL;
@@ -6725,14 +8665,23 @@ char *astGetNextText_( AstChannel *this, int *status ) {
    if ( !astOK ) return NULL;
    return (**astMEMBER(this,Channel,GetNextText))( this, status );
 }
+void astPutNextBytes_( AstChannel *this, const void *data, size_t size, int *status ) {
+   if ( !astOK ) return;
+   (**astMEMBER(this,Channel,PutNextBytes))( this, data, size, status );
+}
 void astPutNextText_( AstChannel *this, const char *line, int *status ) {
    if ( !astOK ) return;
    (**astMEMBER(this,Channel,PutNextText))( this, line, status );
 }
 AstObject *astRead_( AstChannel *this, int *status ) {
+   AstObject *result;
+   AstProfileCall call;
    if ( !astOK ) return NULL;
+   astProfileStart( &call, "Read", this, 0.0 );
    astAddWarning( this, 0, NULL, NULL, status );
-   return (**astMEMBER(this,Channel,Read))( this, status );
+   result = (**astMEMBER(this,Channel,Read))( this, status );
+   astProfileStop( &call );
+   return result;
 }
 void astReadClassData_( AstChannel *this, const char *class, int *status ) {
    if ( !astOK ) return;
@@ -6800,6 +8749,16 @@ void astPutChannelData_( AstChannel *this, void *data, int *status ) {
    if ( !astOK ) return;
    (**astMEMBER(this,Channel,PutChannelData))( this, data, status );
 }
+void *astGetBinaryOutput_( AstChannel *this, size_t *size, int *status ) {
+   *size = 0;
+   if ( !astOK ) return NULL;
+   return (**astMEMBER(this,Channel,GetBinaryOutput))( this, size, status );
+}
+void astPutBinaryInput_( AstChannel *this, const void *data, size_t size,
+                         int *status ) {
+   if ( !astOK ) return;
+   (**astMEMBER(this,Channel,PutBinaryInput))( this, data, size, status );
+}
 AstKeyMap *astWarnings_( AstChannel *this, int *status ){
    if( !astOK ) return NULL;
    return (**astMEMBER(this,Channel,Warnings))( this, status );
@@ -6808,6 +8767,15 @@ void astWriteFlush_( AstChannel *this, int *status ){
    if( !astOK ) return;
    return (**astMEMBER(this,Channel,WriteFlush))( this, status );
 }
+int astShareObject_( AstChannel *this, AstObject *object, int *new,
+                     int *status ){
+   *new = 1;
+   if( !astOK ) return -1;
+   return (**astMEMBER(this,Channel,ShareObject))( this, object, new, status );
+}
+void astResetSharedObjects_( AstChannel *this, int *status ){
+   (**astMEMBER(this,Channel,ResetSharedObjects))( this, status );
+}
 
 /* Because of the variable argument list, we need to work a bit harder on
    astAddWarning. Functions that provide implementations of the
@@ -6847,11 +8815,16 @@ void astAddWarning_( void *this_void, int level, const char *fmt,
    included. */
 int astWrite_( AstChannel *this, AstObject *object, int *status ) {
    astDECLARE_GLOBALS
+   AstProfileCall call;
+   int result;
    if ( !astOK ) return 0;
    astGET_GLOBALS(this);
    nwrite_invoc++;
+   astProfileStart( &call, "Write", this, 0.0 );
    astAddWarning( this, 0, NULL, NULL, status );
-   return (**astMEMBER(this,Channel,Write))( this, object, status );
+   result = (**astMEMBER(this,Channel,Write))( this, object, status );
+   astProfileStop( &call );
+   return result;
 }
 
 /* We do not want to count invocations of astWrite made from within the
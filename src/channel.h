@@ -38,6 +38,17 @@
 *     None.
 
 *  New Attributes Defined:
+*     Binary (integer)
+*        A boolean value (0 or 1) which controls whether Objects are
+*        written using a compact binary encoding rather than the usual
+*        textual format. Binary data are written to the SinkFile if
+*        one has been set, and otherwise to an internal memory buffer.
+*     ShareObjects (integer)
+*        A boolean value (0 or 1) which controls whether an Object that
+*        is referred to more than once within the Object being written
+*        is written out in full only once, with later occurrences being
+*        written as references to the first. Such references re-create
+*        the shared Object when read back.
 *     Comment (integer)
 *        A boolean value (0 or 1) which controls whether comments are
 *        to be included in textual output generated by a Channel. If
@@ -78,28 +89,44 @@
 
 *  New Methods Defined:
 *     Public:
+*        astGetBinaryOutput
+*           Return the binary data written to a Channel's memory buffer.
+*        astPutBinaryInput
+*           Supply a memory buffer from which to read binary data.
 *        astRead
 *           Read an Object from a Channel.
 *        astWrite
 *           Write an Object to a Channel.
 *
 *     Protected:
+*        astClearBinary
+*           Clear the Binary attribute for a Channel.
 *        astClearComment
 *           Clear the Comment attribute for a Channel.
 *        astClearFull
 *           Clear the Full attribute for a Channel.
+*        astClearShareObjects
+*           Clear the ShareObjects attribute for a Channel.
 *        astClearSkip
 *           Clear the Skip attribute for a Channel.
+*        astGetBinary
+*           Get the value of the Binary attribute for a Channel.
 *        astGetComment
 *           Get the value of the Comment attribute for a Channel.
 *        astGetFull
 *           Get the value of the Full attribute for a Channel.
+*        astGetNextBytes
+*           Read raw bytes from the input SourceFile.
 *        astGetNextData
 *           Read the next item of data from a data source.
 *        astGetNextText
 *           Read the next line of input text from a data source.
+*        astGetShareObjects
+*           Get the value of the ShareObjects attribute for a Channel.
 *        astGetSkip
 *           Get the value of the Skip attribute for a Channel.
+*        astPutNextBytes
+*           Write raw bytes to the output SinkFile.
 *        astPutNextText
 *           Write a line of output text to a data sink.
 *        astReadClassData
@@ -112,18 +139,32 @@
 *           Read a (sub)Object as part of loading a class.
 *        astReadString
 *           Read a string value as part of loading a class.
+*        astResetSharedObjects
+*           Forget the Objects written so far by astShareObject.
+*        astSetBinary
+*           Set the value of the Binary attribute for a Channel.
 *        astSetComment
 *           Set the value of the Comment attribute for a Channel.
 *        astSetFull
 *           Set the value of the Full attribute for a Channel.
+*        astSetShareObjects
+*           Set the value of the ShareObjects attribute for a Channel.
 *        astSetSkip
 *           Set the value of the Skip attribute for a Channel.
+*        astShareObject
+*           Find or record an Object that is to be written.
+*        astTestBinary
+*           Test whether a value has been set for the Binary attribute of a
+*           Channel.
 *        astTestComment
 *           Test whether a value has been set for the Comment attribute of a
 *           Channel.
 *        astTestFull
 *           Test whether a value has been set for the Full attribute of a
 *           Channel.
+*        astTestShareObjects
+*           Test whether a value has been set for the ShareObjects
+*           attribute of a Channel.
 *        astTestSkip
 *           Test whether a value has been set for the Skip attribute of a
 *           Channel.
@@ -200,6 +241,7 @@
 
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
+*     AGT: Agent
 
 *  History:
 *     12-AUG-1996 (RFWS):
@@ -210,6 +252,12 @@
 *        Added astWriteInvocations.
 *     8-JAN-2003 (DSB):
 *        Added protected astInitAxisVtab method.
+*     18-OCT-2026 (AGT):
+*        - Added the Binary attribute, and the astGetBinaryOutput and
+*        astPutBinaryInput functions.
+*        - Added the ShareObjects attribute, and the astShareObject and
+*        astResetSharedObjects methods.
+*        - Added the astGetNextBytes and astPutNextBytes methods.
 *-
 */
 
@@ -281,6 +329,20 @@ typedef struct AstChannel {
    char *fn_in;                  /* Full path for source text file */
    FILE *fd_out;                 /* Descriptor for sink text file */
    char *fn_out;                 /* Full path for sink text file */
+   int binary;                   /* Write using the binary encoding? */
+   int binary_in;                /* Is the current input binary? */
+   int binary_out;               /* Binary header written to sink file? */
+   const unsigned char *mem_in;  /* Memory buffer holding binary input */
+   size_t nmem_in;               /* Number of bytes in "mem_in" */
+   size_t imem_in;               /* Index of next byte to read from "mem_in" */
+   unsigned char *mem_out;       /* Memory buffer holding binary output */
+   size_t nmem_out;              /* Number of bytes in "mem_out" */
+   int shareobjects;             /* Write references to shared Objects? */
+   int write_depth;              /* Nesting depth of astWrite invocations */
+   AstObject **shared_out;       /* Objects written by the current astWrite */
+   int nshared_out;              /* Number of Objects in "shared_out" */
+   AstObject **shared_in;        /* Objects read by the current astRead */
+   int nshared_in;               /* Number of Objects in "shared_in" */
 } AstChannel;
 
 /* Virtual function table. */
@@ -301,6 +363,7 @@ typedef struct AstChannelVtab {
    AstObject *(* Read)( AstChannel *, int * );
    AstObject *(* ReadObject)( AstChannel *, const char *, AstObject *, int * );
    char *(* GetNextText)( AstChannel *, int * );
+   size_t (* GetNextBytes)( AstChannel *, void *, size_t, int * );
    char *(* ReadString)( AstChannel *, const char *, const char *, int * );
    double (* ReadDouble)( AstChannel *, const char *, double, int * );
    int (* GetComment)( AstChannel *, int * );
@@ -319,6 +382,7 @@ typedef struct AstChannelVtab {
    void (* GetNextData)( AstChannel *, int, char **, char **, int * );
    void (* PutChannelData)( AstChannel *, void *, int * );
    void (* PutNextText)( AstChannel *, const char *, int * );
+   void (* PutNextBytes)( AstChannel *, const void *, size_t, int * );
    void (* ReadClassData)( AstChannel *, const char *, int * );
    void (* SetComment)( AstChannel *, int, int * );
    void (* SetFull)( AstChannel *, int, int * );
@@ -332,6 +396,10 @@ typedef struct AstChannelVtab {
    void (* WriteObject)( AstChannel *, const char *, int, int, AstObject *, const char *, int * );
    void (* WriteString)( AstChannel *, const char *, int, int, const char *, const char *, int * );
    void (* WriteFlush)( AstChannel *, int * );
+   void *(* GetBinaryOutput)( AstChannel *, size_t *, int * );
+   void (* PutBinaryInput)( AstChannel *, const void *, size_t, int * );
+   int (* ShareObject)( AstChannel *, AstObject *, int *, int * );
+   void (* ResetSharedObjects)( AstChannel *, int * );
 
    int (* GetSkip)( AstChannel *, int * );
    int (* TestSkip)( AstChannel *, int * );
@@ -357,6 +425,16 @@ typedef struct AstChannelVtab {
    int (* TestSinkFile)( AstChannel *, int * );
    void (* ClearSinkFile)( AstChannel *, int * );
    void (* SetSinkFile)( AstChannel *, const char *, int * );
+
+   int (* GetBinary)( AstChannel *, int * );
+   int (* TestBinary)( AstChannel *, int * );
+   void (* ClearBinary)( AstChannel *, int * );
+   void (* SetBinary)( AstChannel *, int, int * );
+
+   int (* GetShareObjects)( AstChannel *, int * );
+   int (* TestShareObjects)( AstChannel *, int * );
+   void (* ClearShareObjects)( AstChannel *, int * );
+   void (* SetShareObjects)( AstChannel *, int, int * );
 } AstChannelVtab;
 
 /* Define a private structure type used to store linked lists of
@@ -369,7 +447,10 @@ typedef struct AstChannelValue {
       char *string;               /* Pointer to string value */
       AstObject *object;          /* Pointer to Object value */
    } ptr;
+   double dval;                   /* Value of a binary floating point item */
+   int64_t ival;                  /* Value of a binary integer item */
    int is_object;                 /* Whether value is an Object (else string) */
+   int bintype;                   /* Type of binary numerical item (else 0) */
 } AstChannelValue;
 
 #if defined(THREAD_SAFE)
@@ -452,6 +533,8 @@ AstObject *astRead_( AstChannel *, int * );
 int astWrite_( AstChannel *, AstObject *, int * );
 void astPutChannelData_( AstChannel *, void *, int * );
 void *astChannelData_( void );
+void *astGetBinaryOutput_( AstChannel *, size_t *, int * );
+void astPutBinaryInput_( AstChannel *, const void *, size_t, int * );
 struct AstKeyMap *astWarnings_( AstChannel *, int * );
 
 char *astSourceWrap_( const char *(*)( void ), int * );
@@ -461,6 +544,7 @@ void astSinkWrap_( void (*)( const char * ), const char *, int * );
 void astStoreChannelData_( AstChannel *, int * );
 AstObject *astReadObject_( AstChannel *, const char *, AstObject *, int * );
 char *astGetNextText_( AstChannel *, int * );
+size_t astGetNextBytes_( AstChannel *, void *, size_t, int * );
 char *astReadString_( AstChannel *, const char *, const char *, int * );
 double astReadDouble_( AstChannel *, const char *, double, int * );
 int astGetComment_( AstChannel *, int * );
@@ -477,6 +561,7 @@ void astClearFull_( AstChannel *, int * );
 void astClearStrict_( AstChannel *, int * );
 void astGetNextData_( AstChannel *, int, char **, char **, int * );
 void astPutNextText_( AstChannel *, const char *, int * );
+void astPutNextBytes_( AstChannel *, const void *, size_t, int * );
 void astReadClassData_( AstChannel *, const char *, int * );
 void astSetComment_( AstChannel *, int, int * );
 void astSetFull_( AstChannel *, int, int * );
@@ -491,6 +576,8 @@ void astWriteIsA_( AstChannel *, const char *, const char *, int * );
 void astWriteObject_( AstChannel *, const char *, int, int, AstObject *, const char *, int * );
 void astWriteString_( AstChannel *, const char *, int, int, const char *, const char *, int * );
 void astWriteFlush_( AstChannel *, int * );
+int astShareObject_( AstChannel *, AstObject *, int *, int * );
+void astResetSharedObjects_( AstChannel *, int * );
 
 int astGetSkip_( AstChannel *, int * );
 int astTestSkip_( AstChannel *, int * );
@@ -517,6 +604,16 @@ int astTestSinkFile_( AstChannel *, int * );
 void astClearSinkFile_( AstChannel *, int * );
 void astSetSinkFile_( AstChannel *, const char *, int * );
 
+int astGetBinary_( AstChannel *, int * );
+int astTestBinary_( AstChannel *, int * );
+void astClearBinary_( AstChannel *, int * );
+void astSetBinary_( AstChannel *, int, int * );
+
+int astGetShareObjects_( AstChannel *, int * );
+int astTestShareObjects_( AstChannel *, int * );
+void astClearShareObjects_( AstChannel *, int * );
+void astSetShareObjects_( AstChannel *, int, int * );
+
 #endif
 
 /* Function interfaces. */
@@ -573,6 +670,10 @@ astINVOKE(V,astWrite_(astCheckChannel(this),astCheckObject(object),STATUS_PTR))
 astINVOKE(V,astPutChannelData_(astCheckChannel(this),data,STATUS_PTR))
 #define astWarnings(this) \
 astINVOKE(O,astWarnings_(astCheckChannel(this),STATUS_PTR))
+#define astGetBinaryOutput(this,size) \
+astINVOKE(V,astGetBinaryOutput_(astCheckChannel(this),size,STATUS_PTR))
+#define astPutBinaryInput(this,data,size) \
+astINVOKE(V,astPutBinaryInput_(astCheckChannel(this),data,size,STATUS_PTR))
 
 #define astSourceWrap astSourceWrap_
 #define astSinkWrap astSinkWrap_
@@ -597,10 +698,14 @@ astINVOKE(V,astGetFull_(astCheckChannel(this),STATUS_PTR))
 astINVOKE(V,astGetNextData_(astCheckChannel(this),begin,name,val,STATUS_PTR))
 #define astGetNextText(this) \
 astINVOKE(V,astGetNextText_(astCheckChannel(this),STATUS_PTR))
+#define astGetNextBytes(this,data,size) \
+astINVOKE(V,astGetNextBytes_(astCheckChannel(this),data,size,STATUS_PTR))
 #define astGetStrict(this) \
 astINVOKE(V,astGetStrict_(astCheckChannel(this),STATUS_PTR))
 #define astPutNextText(this,line) \
 astINVOKE(V,astPutNextText_(astCheckChannel(this),line,STATUS_PTR))
+#define astPutNextBytes(this,data,size) \
+astINVOKE(V,astPutNextBytes_(astCheckChannel(this),data,size,STATUS_PTR))
 #define astReadClassData(this,class) \
 astINVOKE(V,astReadClassData_(astCheckChannel(this),class,STATUS_PTR))
 #define astReadDouble(this,name,def) \
@@ -643,6 +748,10 @@ astINVOKE(V,astWriteObject_(astCheckChannel(this),name,set,helpful,astCheckObjec
 astINVOKE(V,astWriteString_(astCheckChannel(this),name,set,helpful,value,comment,STATUS_PTR))
 #define astWriteFlush(this) \
 astINVOKE(V,astWriteFlush_(astCheckChannel(this),STATUS_PTR))
+#define astShareObject(this,object,new) \
+astINVOKE(V,astShareObject_(astCheckChannel(this),astCheckObject(object),new,STATUS_PTR))
+#define astResetSharedObjects(this) \
+astINVOKE(V,astResetSharedObjects_(astCheckChannel(this),STATUS_PTR))
 
 #define astWriteInvocations astWriteInvocations_(STATUS_PTR)
 
@@ -691,6 +800,24 @@ astINVOKE(V,astSetSinkFile_(astCheckChannel(this),value,STATUS_PTR))
 #define astTestSinkFile(this) \
 astINVOKE(V,astTestSinkFile_(astCheckChannel(this),STATUS_PTR))
 
+#define astClearBinary(this) \
+astINVOKE(V,astClearBinary_(astCheckChannel(this),STATUS_PTR))
+#define astGetBinary(this) \
+astINVOKE(V,astGetBinary_(astCheckChannel(this),STATUS_PTR))
+#define astSetBinary(this,value) \
+astINVOKE(V,astSetBinary_(astCheckChannel(this),value,STATUS_PTR))
+#define astTestBinary(this) \
+astINVOKE(V,astTestBinary_(astCheckChannel(this),STATUS_PTR))
+
+#define astClearShareObjects(this) \
+astINVOKE(V,astClearShareObjects_(astCheckChannel(this),STATUS_PTR))
+#define astGetShareObjects(this) \
+astINVOKE(V,astGetShareObjects_(astCheckChannel(this),STATUS_PTR))
+#define astSetShareObjects(this,value) \
+astINVOKE(V,astSetShareObjects_(astCheckChannel(this),value,STATUS_PTR))
+#define astTestShareObjects(this) \
+astINVOKE(V,astTestShareObjects_(astCheckChannel(this),STATUS_PTR))
+
 #endif
 #endif
 
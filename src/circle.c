@@ -54,6 +54,7 @@ f     - AST_CIRCLEPARS: Get the geometric parameters of the Circle
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     31-AUG-2004 (DSB):
@@ -62,6 +63,12 @@ f     - AST_CIRCLEPARS: Get the geometric parameters of the Circle
 *        Modify RegPins so that it can handle uncertainty regions that straddle
 *        a discontinuity. Previously, such uncertainty Regions could have a huge
 *        bounding box resulting in matching region being far too big.
+*     18-OCT-2026 (AGT):
+*        - Override the astRegPointsIn, astRegShape and astRegFixedMesh
+*        methods.
+*        - Use astRegParallel to share the testing of large numbers of
+*        points between several threads in astTransform and
+*        astRegPointsIn.
 *class--
 */
 
@@ -104,6 +111,22 @@ f     - AST_CIRCLEPARS: Get the geometric parameters of the Circle
 #include <stdio.h>
 #include <string.h>
 
+/* Type definitions. */
+/* ================= */
+
+/* A structure that describes a set of base Frame positions to be tested
+   by the TestPoints function, and the arrays in which to store the
+   results. */
+typedef struct PointsData {
+   double **ptr_in;     /* Pointers to input base Frame axis values */
+   int ncoord_in;       /* No. of base Frame axes */
+   double **ptr_out;    /* Pointers to output axis values (or NULL) */
+   int ncoord_out;      /* No. of output axes */
+   unsigned char *mask; /* Packed bit mask to receive results (or NULL) */
+   int closed;          /* Is the boundary part of the Region? */
+   int neg;             /* Has the Region been negated? */
+} PointsData;
+
 /* Module Variables. */
 /* ================= */
 
@@ -158,7 +181,11 @@ static AstPointSet *RegBaseMesh( AstRegion *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double *CircumPoint( AstFrame *, int, const double *, double, int * );
 static double *RegCentre( AstRegion *this, double *, double **, int, int, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
+static AstDim TestPoints( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static int RegShape( AstRegion *, double[2], double[4], double **, int *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Cache( AstCircle *, int * );
 static void CalcPars( AstFrame *, AstPointSet *, double *, double *, double *, int * );
@@ -731,8 +758,11 @@ void astInitCircleVtab_(  AstCircleVtab *vtab, const char *name, int *status ) {
    region->ResetCache = ResetCache;
 
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
+   region->RegShape = RegShape;
    region->RegTrace = RegTrace;
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegBaseBox = RegBaseBox;
    region->RegCentre = RegCentre;
 
@@ -1286,6 +1316,44 @@ static double *RegCentre( AstRegion *this_region, double *cen, double **ptr,
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "circle.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Circle member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh cached in the Circle depends only on the centre, radius
+*     and base Frame, and so can be retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -1541,6 +1609,182 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a Circle.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "circle.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     Circle member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Circle, and sets the corresponding bit in the
+*     supplied packed bit mask. The tests are the same as those performed
+*     by the astTransform method, but no output PointSet is created.
+
+*  Parameters:
+*     this
+*        Pointer to the Circle.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the Circle.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the Circle.
+
+*/
+
+/* Local Variables: */
+   AstDim npoint;                /* No. of points */
+   AstDim result;                /* Returned number of inside points */
+   AstFrame *frm;                /* Pointer to base Frame in FrameSet */
+   AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
+   PointsData pdata;             /* Description of the points to test */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet. The returned PointSet will usually be a clone
+   of "pset" and so must not be modified. */
+   pset_tmp = astRegTransform( this_region, pset, 0, NULL, &frm );
+   npoint = astGetNpoint( pset_tmp );
+
+/* Clear the returned mask. */
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+/* Ensure cached information is available. */
+   Cache( (AstCircle *) this_region, status );
+
+/* Describe the points to be tested, and the mask to receive the results. */
+   pdata.ptr_in = astGetPoints( pset_tmp );
+   pdata.ncoord_in = astGetNcoord( pset_tmp );
+   pdata.ptr_out = NULL;
+   pdata.ncoord_out = 0;
+   pdata.mask = mask;
+   pdata.closed = astGetClosed( this_region );
+   pdata.neg = astGetNegated( this_region );
+
+/* Test each point, possibly using several threads. */
+   if( astOK ) result = astRegParallel( this_region, frm, npoint,
+                                        TestPoints, &pdata );
+
+/* Free resources */
+   pset_tmp = astAnnul( pset_tmp );
+   frm = astAnnul( frm );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static int RegShape( AstRegion *this_region, double centre[2],
+                     double matrix[4], double **vert, int *nvert,
+                     int *status ){
+/*
+*  Name:
+*     RegShape
+
+*  Purpose:
+*     Return an analytic description of a 2-dimensional Circle.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "circle.h"
+*     int RegShape( AstRegion *this, double centre[2], double matrix[4],
+*                   double **vert, int *nvert, int *status )
+
+*  Class Membership:
+*     Circle member function (over-rides the astRegShape protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns the centre and radius of an un-negated
+*     2-dimensional Circle, in the form of an ellipse within the base
+*     Frame of the Circle. See astRegShape for details.
+
+*  Parameters:
+*     this
+*        Pointer to the Circle.
+*     centre
+*        Returned holding the centre of the Circle.
+*     matrix
+*        Returned holding the radius multiplied by the unit matrix.
+*     vert
+*        Returned holding NULL.
+*     nvert
+*        Returned holding zero.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     AST__ELLSHAPE, or AST__NOSHAPE if the Circle is negated or is not
+*     2-dimensional.
+
+*/
+
+/* Local Variables: */
+   AstCircle *this;          /* Pointer to Circle structure */
+
+/* Initialise */
+   *vert = NULL;
+   *nvert = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return AST__NOSHAPE;
+
+/* Get a pointer to the Circle structure. */
+   this = (AstCircle *) this_region;
+
+/* Only un-negated 2-dimensional Circles can be described. */
+   if( astGetNegated( this ) ||
+       astGetNin( this_region->frameset ) != 2 ) return AST__NOSHAPE;
+
+/* Ensure cached information is available. */
+   Cache( this, status );
+   if( !astOK || this->radius == AST__BAD ||
+       this->centre[ 0 ] == AST__BAD ||
+       this->centre[ 1 ] == AST__BAD ) return AST__NOSHAPE;
+
+/* Return the centre, and the matrix that maps the unit circle onto the
+   Circle. */
+   centre[ 0 ] = this->centre[ 0 ];
+   centre[ 1 ] = this->centre[ 1 ];
+   matrix[ 0 ] = this->radius;
+   matrix[ 1 ] = 0.0;
+   matrix[ 2 ] = 0.0;
+   matrix[ 3 ] = this->radius;
+
+/* Return the result. */
+   return AST__ELLSHAPE;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -1936,6 +2180,129 @@ static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
    return result;
 }
 
+static AstDim TestPoints( AstRegion *this_region, AstFrame *frm,
+                          AstDim lo, AstDim hi, void *data, int *status ){
+/*
+*  Name:
+*     TestPoints
+
+*  Purpose:
+*     Test if each of a range of points is inside a Circle.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "circle.h"
+*     AstDim TestPoints( AstRegion *this, AstFrame *frm, AstDim lo,
+*                        AstDim hi, void *data, int *status )
+
+*  Class Membership:
+*     Circle member function
+
+*  Description:
+*     This function tests each of a contiguous range of base Frame
+*     positions to see if it is inside the Circle. A bit is set in the
+*     supplied mask for each inside position, and/or the corresponding
+*     output axis values are set bad for each outside position. It is
+*     invoked via astRegParallel, possibly in a worker thread that does
+*     not have a lock on the Circle, and so uses only the cached centre
+*     and radius in the Circle structure (which must be up to date) and
+*     the supplied Frame.
+
+*  Parameters:
+*     this
+*        Pointer to the Circle.
+*     frm
+*        Pointer to a Frame equivalent to the base Frame of the Circle.
+*     lo
+*        Index of the first point to test.
+*     hi
+*        Index of the point following the last point to test.
+*     data
+*        Pointer to a PointsData structure describing the points to
+*        test and the arrays to receive the results.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of tested points that are inside the Circle.
+
+*/
+
+/* Local Variables: */
+   AstCircle *this;              /* Pointer to Circle */
+   AstDim point;                 /* Loop counter for points */
+   AstDim result;                /* Returned number of inside points */
+   PointsData *pdata;            /* Description of the points to test */
+   double *work;                 /* Pointer to array holding single base point */
+   double d;                     /* Base-Frame distance from centre to point */
+   int coord;                    /* Zero-based index for coordinates */
+   int inside;                   /* Is the point inside the Region? */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get pointers to the Circle and the description of the points. */
+   this = (AstCircle *) this_region;
+   pdata = (PointsData *) data;
+
+/* Get work space for one base Frame position */
+   work = astMalloc( sizeof( double )*(size_t) pdata->ncoord_in );
+   if( astOK ) {
+
+/* Loop round each point */
+      for ( point = lo; point < hi; point++ ) {
+
+/* Copy the base Frame position into a work array, noting if any axis
+   value is bad. */
+         inside = 1;
+         for ( coord = 0; coord < pdata->ncoord_in; coord++ ) {
+            work[ coord ] = pdata->ptr_in[ coord ][ point ];
+            if( work[ coord ] == AST__BAD ) inside = 0;
+         }
+
+/* Find the geodesic distance from the centre of the Circle in the base
+   Frame, and decide whether this puts the point in or out of the Region. */
+         if( inside ) {
+            d = astDistance( frm, this->centre, work );
+            if( d == AST__BAD ) {
+               inside = 0;
+            } else if( pdata->neg ) {
+               inside = pdata->closed ? ( d >= this->radius ) : ( d > this->radius );
+            } else {
+               inside = pdata->closed ? ( d <= this->radius ) : ( d < this->radius );
+            }
+         }
+
+/* Record the result. If the point is outside, store bad output values. */
+         if( inside ) {
+            if( pdata->mask ) {
+               pdata->mask[ point/8 ] |= (unsigned char)( 1 << ( point % 8 ) );
+            }
+            result++;
+
+         } else if( pdata->ptr_out ) {
+            for ( coord = 0; coord < pdata->ncoord_out; coord++ ) {
+               pdata->ptr_out[ coord ][ point ] = AST__BAD;
+            }
+         }
+      }
+   }
+
+/* Free resources */
+   work = astFree( work );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -1995,22 +2362,11 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 */
 
 /* Local Variables: */
-   AstCircle *this;            /* Pointer to Circle */
+   AstCircle *this;              /* Pointer to Circle */
    AstFrame *frm;                /* Pointer to base Frame in FrameSet */
    AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
    AstPointSet *result;          /* Pointer to output PointSet */
-   double **ptr_out;             /* Pointer to output coordinate data */
-   double **ptr_tmp;             /* Pointer to base Frame coordinate data */
-   double *work;                 /* Pointer to array holding single base point */
-   double d;                     /* Base-Frame distance from centre to point */
-   int closed;                   /* Is the boundary part of the Region? */
-   int coord;                    /* Zero-based index for coordinates */
-   int inside;                   /* Is the point inside the Region? */
-   int ncoord_out;               /* No. of coordinates per output point */
-   int ncoord_tmp;               /* No. of coordinates per base Frame point */
-   int neg;                      /* Has the Region been negated? */
-   int npoint;                   /* No. of points */
-   int point;                    /* Loop counter for points */
+   PointsData pdata;             /* Description of the points to test */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -2036,74 +2392,29 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    contents of the returned PointSet. */
    pset_tmp = astRegTransform( this, in, 0, NULL, &frm );
 
-/* Determine the numbers of points and coordinates per point from the base
-   Frame PointSet and obtain pointers for accessing the base Frame and output
-   coordinate values. */
-   npoint = astGetNpoint( pset_tmp );
-   ncoord_tmp = astGetNcoord( pset_tmp );
-   ptr_tmp = astGetPoints( pset_tmp );
-   ncoord_out = astGetNcoord( result );
-   ptr_out = astGetPoints( result );
-
-/* Get work space for one base Frame position */
-   work = astMalloc( sizeof( double )*(size_t) ncoord_tmp );
-
-/* See if the boundary is part of the Region. */
-   closed = astGetClosed( this );
-
-/* See if the Region has been negated. */
-   neg = astGetNegated( this );
-
-/* Perform coordinate arithmetic. */
-/* ------------------------------ */
-   if ( astOK ) {
-
-/* Ensure cached information is available. */
-      Cache( this, status );
-
-/* Loop round each point */
-      for ( point = 0; point < npoint; point++ ) {
-
-/* Copy the base Frame position into a work array. */
-         for ( coord = 0; coord < ncoord_tmp; coord++ ) {
-            work[ coord ] = ptr_tmp[ coord ][ point ];
-         }
-
-/* Find the geodesic distance from the centre of the Circle in the base
-   Frame. */
-         d = astDistance( frm, this->centre, work );
-
-/* Now consider whether this radius value puts the point in or out of the
-   Circle. */
-         if( d != AST__BAD ){
-            if( neg ) {
-               if( closed ) {
-                  inside = ( d >= this->radius );
-               } else {
-                  inside = ( d > this->radius );
-               }
-            } else {
-               if( closed ) {
-                  inside = ( d <= this->radius );
-               } else {
-                  inside = ( d < this->radius );
-               }
-            }
-         } else {
-            inside = 0;
-         }
+/* Ensure cached information is available. This must be done before
+   testing any points, since the testing may be shared between several
+   threads. */
+   Cache( this, status );
 
-/* If the point is outside, store bad output values. */
-         if( !inside ) {
-            for ( coord = 0; coord < ncoord_out; coord++ ) {
-               ptr_out[ coord ][ point ] = AST__BAD;
-            }
-         }
-      }
-   }
+/* Describe the points to be tested: the numbers of coordinates per point
+   and pointers for accessing the base Frame and output coordinate values,
+   whether the boundary is part of the Region, and whether the Region has
+   been negated. */
+   pdata.ptr_in = astGetPoints( pset_tmp );
+   pdata.ncoord_in = astGetNcoord( pset_tmp );
+   pdata.ptr_out = astGetPoints( result );
+   pdata.ncoord_out = astGetNcoord( result );
+   pdata.mask = NULL;
+   pdata.closed = astGetClosed( this );
+   pdata.neg = astGetNegated( this );
+
+/* Perform coordinate arithmetic, possibly using several threads. Points
+   that are not inside the Region are set bad in the output PointSet. */
+   if ( astOK ) (void) astRegParallel( this, frm, astGetNpoint( pset_tmp ),
+                                       TestPoints, &pdata );
 
 /* Free resources */
-   work = astFree( work );
    pset_tmp = astAnnul( pset_tmp );
    frm = astAnnul( frm );
 
@@ -76,6 +76,7 @@ f     The CmpFrame class does not define any new routines beyond those
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     4-MAR-1996 (RFWS):
@@ -189,6 +190,10 @@ f     The CmpFrame class does not define any new routines beyond those
 *        Increase size of "buf2" buffer in SetAttrib, and trap buffer overflow.
 *     11-JAN-2017 (GSB):
 *        Override astSetDtai, astGetDtai and astClearDtai.
+*     18-OCT-2026 (AGT):
+*        FrameGrid: Do not modify the axis pointers of the returned
+*        PointSet, and advance them by the correct amount. Previously, the
+*        grid for a CmpFrame overran the returned PointSet.
 *class--
 */
 
@@ -2812,6 +2817,7 @@ static AstPointSet *FrameGrid( AstFrame *this_object, int size, const double *lb
    double **ptr1;
    double **ptr2;
    double **ptr;
+   double **ptrw;
    double *lbnd1;
    double *lbnd2;
    double *p;
@@ -2900,22 +2906,26 @@ static AstPointSet *FrameGrid( AstFrame *this_object, int size, const double *lb
       npoint = npoint1*npoint2;
       result = astPointSet( npoint, naxes, " ", status );
       ptr = astGetPoints( result );
+
+/* Take a copy of the array of axis pointers, so that the copied pointers
+   can be incremented without changing the PointSet. */
+      ptrw = astStore( NULL, ptr, naxes*sizeof( *ptr ) );
       if( astOK ) {
 
 /* For every point in the first Frame's PointSet, duplicate the second
    Frame's entire PointSet, using the first Frame's axis values. */
          for( ip1 = 0; ip1 < npoint1; ip1++ ) {
             for( iax1 = 0; iax1 < nax1; iax1++ ) {
-               p = ptr[ iax1 ];
+               p = ptrw[ iax1 ];
                v = ptr1[ iax1 ][ ip1 ];
                for( ip2 = 0; ip2 < npoint2; ip2++ ) {
                   *(p++) = v;
                }
-               ptr[ iax1 ] = p;
+               ptrw[ iax1 ] = p;
             }
             for( iax2 = 0; iax2 < nax2; iax2++ ) {
-               memcpy( ptr[ iax2 + nax1 ], ptr2[ iax2 ], npoint2*sizeof( double ) );
-               ptr[ iax2 + nax1 ] += npoint2*sizeof( double );
+               memcpy( ptrw[ iax2 + nax1 ], ptr2[ iax2 ], npoint2*sizeof( double ) );
+               ptrw[ iax2 + nax1 ] += npoint2;
             }
          }
 
@@ -2924,6 +2934,7 @@ static AstPointSet *FrameGrid( AstFrame *this_object, int size, const double *lb
       }
 
 /* Free resources. */
+      ptrw = astFree( ptrw );
       ps1 = astAnnul( ps1 );
       ps2 = astAnnul( ps2 );
 
@@ -82,6 +82,7 @@ f     The CmpRegion class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     7-OCT-2004 (DSB):
@@ -116,6 +117,12 @@ f     The CmpRegion class does not define any new routines beyond those
 *     21-NOV-2012 (DSB):
 *        Map the regions returned by RegSplit into the current Frame of the
 *        CmpRegion.
+*     18-OCT-2026 (AGT):
+*        - Override the astRegPointsIn and astRegFixedMesh methods.
+*        - Check for XOR operations before a CmpRegion is frozen, and use
+*        negated copies of frozen component Regions in RegPins.
+*        - ManageLock now also manages the locks on the stored XORed
+*        Regions.
 *class--
 */
 
@@ -229,7 +236,9 @@ static int CmpRegionList( AstCmpRegion *, int *, AstRegion ***, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int GetBounded( AstRegion *, int * );
 static size_t GetObjSize( AstObject *, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void ClearClosed( AstRegion *, int * );
 static void ClearMeshSize( AstRegion *, int * );
@@ -1288,8 +1297,10 @@ void astInitCmpRegionVtab_(  AstCmpRegionVtab *vtab, const char *name, int *stat
    region->RegBaseBox = RegBaseBox;
    region->RegBaseBox2 = RegBaseBox2;
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegSplit = RegSplit;
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
    region->RegTrace = RegTrace;
    region->GetBounded = GetBounded;
    region->RegBasePick = RegBasePick;
@@ -1389,6 +1400,12 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 /* Obtain a pointers to the CmpRegion structure. */
    this = (AstCmpRegion *) this_object;
 
+/* A frozen CmpRegion cannot be changed, so before freezing it, check if
+   it is equivalent to an XOR operation and store the results. */
+   if( mode == AST__FREEZE && !this_object->frozen && astOK ) {
+      XORCheck( this, status );
+   }
+
 /* Invoke the ManageLock method inherited from the parent class. */
    if( !result ) result = (*parent_managelock)( this_object, mode, extra,
                                                 fail, status );
@@ -1397,6 +1414,8 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
    the supplied Object. */
    if( !result ) result = astManageLock( this->region1, mode, extra, fail );
    if( !result ) result = astManageLock( this->region2, mode, extra, fail );
+   if( !result ) result = astManageLock( this->xor1, mode, extra, fail );
+   if( !result ) result = astManageLock( this->xor2, mode, extra, fail );
 
    return result;
 
@@ -2182,6 +2201,46 @@ static AstRegion *RegBasePick( AstRegion *this_region, int naxes,
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpregion.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     CmpRegion member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh cached in the CmpRegion is formed from the meshes of the
+*     component Regions, which are defined within the base Frame of the
+*     CmpRegion and so are not affected by astMapRegion. The cached mesh
+*     can therefore be retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -2246,6 +2305,8 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    AstPointSet *pset2;          /* Points masked by 2nd component Region */
    AstPointSet *psetb1;         /* Points in base Frame of 1st component Region */
    AstPointSet *psetb2;         /* Points in base Frame of 2nd component Region */
+   AstRegion *neg1;             /* Negated copy of first component Region */
+   AstRegion *neg2;             /* Negated copy of second component Region */
    AstRegion *reg1;             /* Pointer to first component Region */
    AstRegion *reg2;             /* Pointer to second component Region */
    AstRegion *unc1;             /* Base Frame uncertainty in 1st component Region */
@@ -2299,16 +2360,26 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    the boundary of A and outside B, or 2) it is on the boundary of B and
    outside A. Either we need to transform the supplied PointSet using each
    component Region as a Mapping. But if using OR we temporarily negate
-   the Regions. */
-   if( this->oper == AST__OR ) {
-      astNegate( reg1 );
-      astNegate( reg2 );
-   }
-   pset1 = astTransform( reg1, pset, 1, NULL );
-   pset2 = astTransform( reg2, pset, 1, NULL );
-   if( this->oper == AST__OR ) {
-      astNegate( reg1 );
-      astNegate( reg2 );
+   the Regions. Frozen Regions cannot be changed, so use negated copies
+   instead in that case. */
+   if( this->oper == AST__OR && astGetFrozen( this ) ) {
+      neg1 = astGetNegation( reg1 );
+      neg2 = astGetNegation( reg2 );
+      pset1 = astTransform( neg1, pset, 1, NULL );
+      pset2 = astTransform( neg2, pset, 1, NULL );
+      neg1 = astAnnul( neg1 );
+      neg2 = astAnnul( neg2 );
+   } else {
+      if( this->oper == AST__OR ) {
+         astNegate( reg1 );
+         astNegate( reg2 );
+      }
+      pset1 = astTransform( reg1, pset, 1, NULL );
+      pset2 = astTransform( reg2, pset, 1, NULL );
+      if( this->oper == AST__OR ) {
+         astNegate( reg1 );
+         astNegate( reg2 );
+      }
    }
 
 /* Get pointers to the axis values in these PointSets */
@@ -2682,6 +2753,150 @@ static AstRegion **RegSplit( AstRegion *this_region, int *nlist, int *status ){
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a CmpRegion.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "cmpregion.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     CmpRegion member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the CmpRegion, and sets the corresponding bit in the
+*     supplied packed bit mask. The component Regions are tested using
+*     their own astRegPointsIn methods, and the two resulting masks are
+*     then combined using the boolean operator of the CmpRegion. No
+*     transformed PointSets are created for the component Regions.
+
+*  Parameters:
+*     this
+*        Pointer to the CmpRegion.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the CmpRegion.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the CmpRegion.
+
+*/
+
+/* Local Variables: */
+   AstCmpRegion *this;           /* Pointer to the CmpRegion structure */
+   AstDim npoint;                /* No. of points */
+   AstDim result;                /* Returned number of inside points */
+   AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
+   AstRegion *reg1;              /* Pointer to first component Region */
+   AstRegion *reg2;              /* Pointer to second component Region */
+   int neg1;                     /* Negated value for first component Region */
+   int neg2;                     /* Negated value for second component Region */
+   int oper;                     /* Boolean operator to use */
+   size_t ibyte;                 /* Index of mask byte */
+   size_t nbyte;                 /* No. of bytes in the mask */
+   unsigned char *mask2;         /* Mask for second component Region */
+   unsigned char byte;           /* Combined mask byte */
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get a Pointer to the CmpRegion structure */
+   this = (AstCmpRegion *) this_region;
+
+/* Get the component Regions, how they should be combined, and the
+   Negated values which should be used with them. The returned values
+   take account of whether the supplied CmpRegion has itself been Negated
+   or not. The returned Regions represent regions within the base Frame
+   of the FrameSet encapsulated by the parent Region structure. */
+   GetRegions( this, &reg1, &reg2, &oper, &neg1, &neg2, status );
+
+/* If either component Region does not have the required value for its
+   "Negated" attribute, use its negation in its place. */
+   if( neg1 != astGetNegated( reg1 ) ) {
+      AstRegion *tmp = astGetNegation( reg1 );
+      (void) astAnnul( reg1 );
+      reg1 = tmp;
+   }
+
+   if( neg2 != astGetNegated( reg2 ) ) {
+      AstRegion *tmp = astGetNegation( reg2 );
+      (void) astAnnul( reg2 );
+      reg2 = tmp;
+   }
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet (the Frame in which the component Regions are
+   defined). */
+   pset_tmp = astRegTransform( this, pset, 0, NULL, NULL );
+   npoint = astGetNpoint( pset_tmp );
+   nbyte = ( (size_t) npoint + 7 )/8;
+
+/* Get a mask for each component Region. The first is put directly into
+   the returned mask. */
+   mask2 = astMalloc( nbyte );
+   (void) astRegPointsIn( reg1, pset_tmp, mask );
+   (void) astRegPointsIn( reg2, pset_tmp, mask2 );
+
+/* Combine the two masks using the required operator, counting the
+   number of inside points as we go. Unused bits in the last byte are
+   zero in both masks and so remain zero in the combined mask. */
+   if ( astOK ) {
+      if( oper == AST__AND || oper == AST__OR ) {
+         for( ibyte = 0; ibyte < nbyte; ibyte++ ) {
+            if( oper == AST__AND ) {
+               byte = mask[ ibyte ] & mask2[ ibyte ];
+            } else {
+               byte = mask[ ibyte ] | mask2[ ibyte ];
+            }
+            mask[ ibyte ] = byte;
+            while( byte ) {
+               byte &= (unsigned char)( byte - 1 );
+               result++;
+            }
+         }
+
+/* Report error for any unknown operator. */
+      } else {
+         astError( AST__INTER, "astRegPointsIn(%s): The %s refers to an "
+                   "unknown boolean operator with identifier %d (internal "
+                   "AST programming error).", status, astGetClass( this ),
+                    astGetClass( this ), oper );
+      }
+   }
+
+/* Free resources. */
+   mask2 = astFree( mask2 );
+   reg1 = astAnnul( reg1 );
+   reg2 = astAnnul( reg2 );
+   pset_tmp = astAnnul( pset_tmp );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -4041,8 +4256,9 @@ static void XORCheck( AstCmpRegion *this, int *status ) {
    if ( !astOK ) return;
 
 /* If the CmpRegion is already known to be an XOR operation, return
-   without action. */
-   if( this->xor1 ) return;
+   without action. Also return if the CmpRegion is frozen, since the
+   check is made (and the results stored) before a CmpRegion is frozen. */
+   if( this->xor1 || astGetFrozen( this ) ) return;
 
 /* To be equivalent to an XOR operation, the supplied CmpRegion must be an
    OR operation and each component Region must be a CmpRegion. */
@@ -54,6 +54,7 @@ f     - AST_ELLIPSEPARS: Get the geometric parameters of the Ellipse
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     7-SEP-2004 (DSB):
@@ -65,6 +66,9 @@ f     - AST_ELLIPSEPARS: Get the geometric parameters of the Ellipse
 *     6-JAN-2014 (DSB):
 *        Ensure cached information is available in RegCentre even if no new
 *        centre is supplied.
+*     18-OCT-2026 (AGT):
+*        Override the astRegPointsIn, astRegShape and astRegFixedMesh
+*        methods.
 *class--
 */
 
@@ -161,7 +165,10 @@ static AstMapping *Simplify( AstMapping *, int * );
 static AstPointSet *RegBaseMesh( AstRegion *, int * );
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static double *RegCentre( AstRegion *this, double *, double **, int, int, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
+static int RegShape( AstRegion *, double[2], double[4], double **, int *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Cache( AstEllipse *, int * );
 static void CalcPars( AstFrame *, double[2], double[2], double[2], double *, double *, double *, int * );
@@ -543,7 +550,10 @@ void astInitEllipseVtab_(  AstEllipseVtab *vtab, const char *name, int *status )
    region->ResetCache = ResetCache;
 
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
+   region->RegShape = RegShape;
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegBaseBox = RegBaseBox;
    region->RegCentre = RegCentre;
    region->RegTrace = RegTrace;
@@ -1366,6 +1376,44 @@ static double *RegCentre( AstRegion *this_region, double *cen, double **ptr,
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "ellipse.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Ellipse member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh cached in the Ellipse is formed from the centre and axes
+*     within the base Frame, and so can be retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -1616,6 +1664,231 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside an Ellipse.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "ellipse.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     Ellipse member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Ellipse, and sets the corresponding bit in the
+*     supplied packed bit mask. The tests are the same as those performed
+*     by the astTransform method, but no output PointSet is created.
+
+*  Parameters:
+*     this
+*        Pointer to the Ellipse.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the Ellipse.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the Ellipse.
+
+*/
+
+/* Local Variables: */
+   AstDim npoint;                /* No. of points */
+   AstDim point;                 /* Loop counter for points */
+   AstDim result;                /* Returned number of inside points */
+   AstEllipse *this;             /* Pointer to Ellipse */
+   AstFrame *frm;                /* Pointer to base Frame in FrameSet */
+   AstPointSet *pset_res;        /* Pointer to PointSet holding resolved components */
+   AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
+   double **ptr_res;             /* Pointer to resolved components coordinate data */
+   double *px;                   /* Pointer to array of primary axis components */
+   double *py;                   /* Pointer to array of secondary axis components */
+   double c1;                    /* Constant */
+   double c2;                    /* Constant */
+   double d;                     /* Elliptical distance to current point */
+   int closed;                   /* Is the boundary part of the Region? */
+   int inside;                   /* Is the point inside the Region? */
+   int neg;                      /* Has the Region been negated? */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointer to the Ellipse structure. */
+   this = (AstEllipse *) this_region;
+
+/* Ensure cached information is available. */
+   Cache( this, status );
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet. The returned PointSet will usually be a clone
+   of "pset" and so must not be modified. */
+   pset_tmp = astRegTransform( this_region, pset, 0, NULL, &frm );
+
+/* Resolve all the base Frame positions into components parallel to and
+   perpendicular to the primary axis, relative to the ellipse centre. */
+   pset_res = astResolvePoints( frm, this->centre, this->point1, pset_tmp, NULL );
+   npoint = astGetNpoint( pset_res );
+   ptr_res = astGetPoints( pset_res );
+
+/* See if the boundary is part of the Region, and if the Region has been
+   negated. */
+   closed = astGetClosed( this_region );
+   neg = astGetNegated( this_region );
+
+/* Form some frequently needed constants. */
+   c1 = 1.0/(this->a*this->a);
+   c2 = 1.0/(this->b*this->b);
+
+/* Clear the returned mask. */
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+/* Test each point, using the elliptical distance from the centre (the
+   ellipse circumference has an "elliptical distance" of 1.0 at all
+   points). */
+   if ( astOK ) {
+      px = ptr_res[ 0 ];
+      py = ptr_res[ 1 ];
+      for ( point = 0; point < npoint; point++, px++, py++ ) {
+         if( *px == AST__BAD || *py == AST__BAD ) {
+            inside = 0;
+         } else {
+            d = c1*(*px)*(*px) + c2*(*py)*(*py);
+            if( neg ) {
+               inside = closed ? ( d >= 1.0 ) : ( d > 1.0 );
+            } else {
+               inside = closed ? ( d <= 1.0 ) : ( d < 1.0 );
+            }
+         }
+
+         if( inside ) {
+            mask[ point/8 ] |= (unsigned char)( 1 << ( point % 8 ) );
+            result++;
+         }
+      }
+   }
+
+/* Free resources */
+   pset_tmp = astAnnul( pset_tmp );
+   pset_res = astAnnul( pset_res );
+   frm = astAnnul( frm );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static int RegShape( AstRegion *this_region, double centre[2],
+                     double matrix[4], double **vert, int *nvert,
+                     int *status ){
+/*
+*  Name:
+*     RegShape
+
+*  Purpose:
+*     Return an analytic description of an Ellipse.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "ellipse.h"
+*     int RegShape( AstRegion *this, double centre[2], double matrix[4],
+*                   double **vert, int *nvert, int *status )
+
+*  Class Membership:
+*     Ellipse member function (over-rides the astRegShape protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns the centre and axes of an un-negated Ellipse
+*     within the base Frame of the Ellipse. See astRegShape for details.
+
+*  Parameters:
+*     this
+*        Pointer to the Ellipse.
+*     centre
+*        Returned holding the centre of the Ellipse.
+*     matrix
+*        Returned holding the matrix that maps the unit circle onto the
+*        Ellipse. Its columns are the vectors from the centre to the ends
+*        of the two axes.
+*     vert
+*        Returned holding NULL.
+*     nvert
+*        Returned holding zero.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     AST__ELLSHAPE, or AST__NOSHAPE if the Ellipse is negated.
+
+*/
+
+/* Local Variables: */
+   AstEllipse *this;         /* Pointer to Ellipse structure */
+   double len;               /* Distance from centre to "point1" */
+   double u[ 2 ];            /* Unit vector along primary axis */
+
+/* Initialise */
+   *vert = NULL;
+   *nvert = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return AST__NOSHAPE;
+
+/* Get a pointer to the Ellipse structure. */
+   this = (AstEllipse *) this_region;
+
+/* Only un-negated Ellipses can be described. */
+   if( astGetNegated( this ) ) return AST__NOSHAPE;
+
+/* Ensure cached information is available. */
+   Cache( this, status );
+   if( !astOK ) return AST__NOSHAPE;
+
+/* Get a unit vector along the primary axis, from the centre to the
+   cached point at the end of the primary axis. */
+   u[ 0 ] = this->point1[ 0 ] - this->centre[ 0 ];
+   u[ 1 ] = this->point1[ 1 ] - this->centre[ 1 ];
+   len = sqrt( u[ 0 ]*u[ 0 ] + u[ 1 ]*u[ 1 ] );
+   if( len <= 0.0 ) return AST__NOSHAPE;
+   u[ 0 ] /= len;
+   u[ 1 ] /= len;
+
+/* Return the centre, and the matrix with columns equal to the primary
+   and secondary half-axis vectors. */
+   centre[ 0 ] = this->centre[ 0 ];
+   centre[ 1 ] = this->centre[ 1 ];
+   matrix[ 0 ] = this->a*u[ 0 ];
+   matrix[ 1 ] = -this->b*u[ 1 ];
+   matrix[ 2 ] = this->a*u[ 1 ];
+   matrix[ 3 ] = this->b*u[ 0 ];
+
+/* Return the result. */
+   return AST__ELLSHAPE;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
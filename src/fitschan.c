@@ -207,6 +207,7 @@ f     - AST_WRITEFITS: Write all cards out to the sink function
 *     DSB: David Berry (Starlink)
 *     RFWS: R.F. Warren-Smith (Starlink, RAL)
 *     TIMJ: Tim Jenness (JAC, Hawaii)
+*     AGT: Agent
 
 *  History:
 *     11-DEC-1996 (DSB):
@@ -1265,6 +1266,35 @@ f     - AST_WRITEFITS: Write all cards out to the sink function
 *        - Increase some buffer sizes to avoid compilation warnings.
 *     6-JUN-2022 (DSB):
 *        Avoid copying overlapping strings in RoundFString.
+*     18-OCT-2026 (AGT):
+*        - Index the cards in a FitsChan by keyword name. The "keywords"
+*        KeyMap now holds a pointer to the first card with each name, and
+*        cards with the same name are chained together in header order.
+*        FindKeyCard uses this to locate non-wildcard keywords without
+*        scanning the whole header, and checks the literal prefix of
+*        wildcard templates before calling Match.
+*        - HasCard no longer reports a keyword as absent after just one of
+*        several cards with that name has been deleted.
+*        - Parse each FITS header card only once when storing it. The
+*        new SplitCard function splits a card into local buffers and
+*        converts any numerical value as it goes, and StoreCard inserts
+*        the resulting keyword directly instead of going through the
+*        astSetFits<X> methods (which split the keyword name again).
+*        astPutCards and the source function use StoreCard for every card.
+*        - Added the FitsWcsCache tuning parameter. If non-zero, astRead
+*        retains the FrameSets it creates from FITS-WCS headers, indexed
+*        by a description of the FitsStore, the relevant attributes and
+*        the few keywords read directly by FsetFromStore, and returns a
+*        copy of a retained FrameSet if a later header produces the same
+*        description. Warnings issued and cards marked as used when the
+*        FrameSet was first created are re-instated.
+*        - The LutMaps created for "-TAB" axes now use the look-up table
+*        directly, rather than a copy of it, if the FitsTable column was
+*        stored using astBorrowColumnData.
+*        - The TimeFrames used by TDBConv are now created when first
+*        needed, rather than when the virtual function table is
+*        initialised, and are unlocked once created so that they can be
+*        used by any thread.
 *class--
 */
 
@@ -1350,6 +1380,7 @@ f     - AST_WRITEFITS: Write all cards out to the sink function
 #define HEADER_TEXT        "Beginning of AST data for "
 #define FOOTER_TEXT        "End of AST data for "
 #define FITSNAMLEN         8
+#define CARD_SEQ_GAP       1024
 #define FITSSTCOL          20
 #define FITSRLCOL          30
 #define FITSIMCOL          50
@@ -1499,8 +1530,12 @@ typedef struct FitsCard {
    char *comment;             /* Pointer to a comment for the keyword. */
    int flags;                 /* Flags for each card */
    size_t size;               /* Size of data value */
+   AstDim seq;                /* Increases monotonically along the list */
    struct FitsCard *next;     /* Pointer to next structure in list. */
    struct FitsCard *prev;     /* Pointer to previous structure in list. */
+   struct FitsCard *knext;    /* Next card with the same keyword name */
+   struct FitsCard *kprev;    /* Previous card with the same name (the
+                                 first card points to the last card) */
 } FitsCard;
 
 /* Structure used to store information derived from the FITS WCS keyword
@@ -1552,6 +1587,29 @@ typedef struct FitsStore {
    char ****skyrefis;
 } FitsStore;
 
+/* Structure used to record the side effects on a FitsChan of creating a
+   FrameSet from a FitsStore (i.e. the warnings issued and the cards
+   marked as used), so that they can be re-instated when the FrameSet is
+   obtained from the cache of previously read FrameSets instead. */
+typedef struct ReadRecord {
+   int nwarn;         /* Number of warnings issued */
+   int *wcard;        /* Index of the current card for each warning */
+   char **wtext;      /* Condition, text, method and class for each warning */
+   int nmark;         /* Number of cards marked as used */
+   char **mark;       /* Keyword name of each card marked as used */
+} ReadRecord;
+
+/* Structure used to hold an entry in the cache of previously read
+   FrameSets. */
+typedef struct WcsCacheEntry {
+   unsigned int hash; /* Hash code for the key */
+   char *key;         /* Description of the information used to create the FrameSet */
+   size_t keylen;     /* Number of bytes in the key */
+   AstObject *object; /* The FrameSet */
+   ReadRecord rec;    /* Side effects of creating the FrameSet */
+   unsigned long int stamp; /* Value of wcs_cache_stamp when last used */
+} WcsCacheEntry;
+
 /* Module Variables. */
 /* ================= */
 
@@ -1600,6 +1658,16 @@ static AstTimeFrame *timeframe = NULL;
 /* Max number of characters in a formatted int */
 static int int_dig;
 
+/* The cache of FrameSets created from recently read FITS-WCS headers
+   (see CachedFsetFromStore), the maximum number of entries allowed in
+   the cache (the "FitsWcsCache" tuning parameter), the number of entries
+   currently in use, and a counter used to find the least recently used
+   entry. All are protected by mutex5. */
+static WcsCacheEntry *wcs_cache = NULL;
+static int wcs_cache_max = 0;
+static int wcs_cache_n = 0;
+static unsigned long int wcs_cache_stamp = 0;
+
 /* Define macros for accessing each item of thread specific global data. */
 #ifdef THREAD_SAFE
 
@@ -1666,6 +1734,9 @@ static pthread_mutex_t mutex3 = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t mutex4 = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX4 pthread_mutex_lock( &mutex4 );
 #define UNLOCK_MUTEX4 pthread_mutex_unlock( &mutex4 );
+static pthread_mutex_t mutex5 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_MUTEX5 pthread_mutex_lock( &mutex5 );
+#define UNLOCK_MUTEX5 pthread_mutex_unlock( &mutex5 );
 
 /* If thread safety is not needed, declare and initialise globals at static
    variables. */
@@ -1752,6 +1823,8 @@ static int class_init = 0;       /* Virtual function table initialised? */
 #define UNLOCK_MUTEX3
 #define LOCK_MUTEX4
 #define UNLOCK_MUTEX4
+#define LOCK_MUTEX5
+#define UNLOCK_MUTEX5
 #endif
 
 /* External Interface Function Prototypes. */
@@ -1773,6 +1846,8 @@ AstFitsChan *astFitsChanId_( const char *(* source)( void ),
 /* ======================================== */
 static size_t GetObjSize( AstObject *, int * );
 static void ClearCard( AstFitsChan *, int * );
+static AstObject *CachedFsetFromStore( AstFitsChan *, FitsStore *, const char *, const char *, int * );
+static void CopyReadRecord( const ReadRecord *, ReadRecord *, int * );
 static int GetCard( AstFitsChan *, int * );
 static int TestCard( AstFitsChan *, int * );
 static void SetCard( AstFitsChan *, int, int * );
@@ -1879,6 +1954,7 @@ static AstObject *FsetFromStore( AstFitsChan *, FitsStore *, const char *, const
 static AstObject *Read( AstChannel *, int * );
 static AstSkyFrame *WcsSkyFrame( AstFitsChan *, FitsStore *, char, int, char *, int, int, const char *, const char *, int * );
 static AstTimeScaleType TimeSysToAst( AstFitsChan *, const char *, const char *, const char *, int * );
+static void TrimWcsCache( int, int * );
 static AstWinMap *WcsShift( FitsStore *, char, int, const char *, const char *, int * );
 static FitsCard *GetLink( FitsCard *, int, const char *, const char *, int * );
 static FitsStore *FitsToStore( AstFitsChan *, int, const char *, const char *, int * );
@@ -1962,7 +2038,11 @@ static int IRAFFromStore( AstFitsChan *, FitsStore *, const char *, const char *
 static int IsAIPSSpectral( const char *, char **, char **, int * );
 static int IsMapLinear( AstMapping *, const double [], const double [], int, int *, int * );
 static int IsSkyOff( AstFrameSet *, int, int * );
+static char *KeyBytes( char *, size_t *, const void *, size_t, int * );
+static char *KeyItem( char *, size_t *, int, double ***, int * );
+static char *KeyItemC( char *, size_t *, int, char ****, int * );
 static int KeyFields( AstFitsChan *, const char *, int, int *, int *, int * );
+static int LiteralPrefix( const char *, char [ FITSNAMLEN + 1 ], int * );
 static int LooksLikeClass( AstFitsChan *, const char *, const char *, int * );
 static int MakeBasisVectors( AstMapping *, int, int, double *, AstPointSet *, AstPointSet *, int * );
 static int MakeIntWorld( AstMapping *, AstFrame *, int *, char, FitsStore *, double *, double, int, const char *, const char *, int * );
@@ -1971,12 +2051,14 @@ static int MatchChar( char, char, const char *, const char *, const char *, int
 static int MatchFront( const char *, const char *, char *, int *, int *, int *, const char *, const char *, const char *, int * );
 static int MoveCard( AstFitsChan *, int, const char *, const char *, int * );
 static int PCFromStore( AstFitsChan *, FitsStore *, const char *, const char *, int * );
+static int ReadNumbers( const char *, int, int, double [ 2 ], int [ 2 ], int * );
 static int SAOTrans( AstFitsChan *, AstFitsChan *, const char *, const char *, int * );
 static int SearchCard( AstFitsChan *, const char *, const char *, const char *, int * );
 static int SetFits( AstFitsChan *, const char *, void *, int, const char *, int, int * );
 static int Similar( const char *, const char *, int * );
 static int SkySys( AstFitsChan *, AstSkyFrame *, int, int, FitsStore *, int, int, char c, int, const char *, const char *, int * );
 static int Split( AstFitsChan *, const char *, char **, char **, char **, const char *, const char *, int * );
+static int SplitCard( AstFitsChan *, const char *, char [ FITSNAMLEN + 1 ], char [ AST__FITSCHAN_FITSCARDLEN + 2 ], char [ AST__FITSCHAN_FITSCARDLEN + 1 ], double [ 2 ], int [ 2 ], const char *, const char *, int * );
 static int SplitMap( AstMapping *, int, int, int, AstMapping **, AstWcsMap **, AstMapping **, int * );
 static int SplitMap2( AstMapping *, int, AstMapping **, AstWcsMap **, AstMapping **, int * );
 static int SplitMat( int , double *, double *, int * );
@@ -2014,9 +2096,11 @@ static void FixUsed( AstFitsChan *, int, int, int, const char *, const char *, i
 static void FormatCard( AstFitsChan *, char *, const char *, int * );
 static void FreeItem( double ****, int * );
 static void FreeItemC( char *****, int * );
+static void FreeReadRecord( ReadRecord *, int * );
 static void GetFiducialNSC( AstWcsMap *, double *, double *, int * );
 static void GetFiducialPPC( AstWcsMap *, double *, double *, int * );
 static void GetNextData( AstChannel *, int, char **, char **, int * );
+static void IndexCard( AstFitsChan *, FitsCard *, int * );
 static void InsCard( AstFitsChan *, int, const char *, int, void *, const char *, const char *, const char *, int * );
 static void MakeBanner( const char *, const char *, const char *, char [ AST__FITSCHAN_FITSCARDLEN - FITSNAMLEN + 1 ], int * );
 static void MakeIndentedComment( int, char, const char *, const char *, char [ AST__FITSCHAN_FITSCARDLEN - FITSNAMLEN + 1], int * );
@@ -2033,6 +2117,7 @@ static void PutTables( AstFitsChan *, AstKeyMap *, int * );
 static void ReadFits( AstFitsChan *, int * );
 static void ReadFromSource( AstFitsChan *, int * );
 static void RemoveTables( AstFitsChan *, const char *, int * );
+static void ReplayRecord( AstFitsChan *, const ReadRecord *, const char *, const char *, int * );
 static void RetainFits( AstFitsChan *, int * );
 static void RoundFString( char *, int, int, int * );
 static void SetAlgCode( char *, const char *, int * );
@@ -2055,9 +2140,12 @@ static void ShowFits( AstFitsChan *, int * );
 static void Shpc1( double, double, int, double *, double *, int * );
 static void SinkWrap( void (*)( const char * ), const char *, int * );
 static void SkyPole( AstWcsMap *, AstMapping *, int, int, int *, char, FitsStore *, const char *, const char *, int * );
+static void StoreCard( AstFitsChan *, const char *, int, const char *, const char *, int * );
 static void TableSource( AstFitsChan *, void (*)( AstFitsChan *, const char *, int, int, int * ), int * );
 static void TidyOffsets( AstFrameSet *, int * );
+static void UnindexCard( AstFitsChan *, FitsCard *, int * );
 static void Warn( AstFitsChan *, const char *, const char *, const char *, const char *, int * );
+static char *WcsCacheKey( AstFitsChan *, FitsStore *, size_t *, int * );
 static void WcsFcRead( AstFitsChan *, AstFitsChan *, FitsStore *, const char *, const char *, int * );
 static void WcsToStore( AstFitsChan *, AstFitsChan *, FitsStore *, const char *, const char *, int * );
 static void WriteBegin( AstChannel *, const char *, const char *, int * );
@@ -4056,6 +4144,174 @@ static int AIPSPPFromStore( AstFitsChan *this, FitsStore *store,
    return astOK ? ok : 0;
 }
 
+static AstObject *CachedFsetFromStore( AstFitsChan *this, FitsStore *store,
+                                       const char *method, const char *class,
+                                       int *status ){
+
+/*
+*  Name:
+*     CachedFsetFromStore
+
+*  Purpose:
+*     Create a FrameSet from a FitsStore, using a cache of previously
+*     created FrameSets.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     AstObject *CachedFsetFromStore( AstFitsChan *this, FitsStore *store,
+*                                     const char *method, const char *class,
+*                                     int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function returns the same FrameSet as FsetFromStore, and has
+*     the same effect on the FitsChan. However, if the "FitsWcsCache"
+*     tuning parameter is non-zero, a deep copy of each FrameSet created
+*     by FsetFromStore is retained in a process-wide cache, indexed by
+*     a description of everything that FsetFromStore uses to create the
+*     FrameSet (the contents of the FitsStore, the relevant FitsChan
+*     attributes and the few keywords that are read directly from the
+*     FitsChan). If the same description is found in the cache, a copy
+*     of the cached FrameSet is returned instead of calling FsetFromStore,
+*     and any warnings issued and cards marked as used by the original
+*     call to FsetFromStore are re-instated. This avoids the cost of
+*     constructing and simplifying the Mappings when reading many headers
+*     that describe the same WCS (e.g. the images in a mosaic).
+
+*  Parameters:
+*     this
+*        Pointer to the FitsChan.
+*     store
+*        Pointer to the FitsStore.
+*     method
+*        Pointer to a string holding the name of the calling method.
+*        This is only for use in constructing error messages.
+*     class
+*        Pointer to a string holding the name of the supplied object class.
+*        This is only for use in constructing error messages.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the new FrameSet or a NULL pointer if no FrameSet
+*     could be constructed.
+
+*  Notes:
+*     -  FrameSets that use the -TAB algorithm are never cached since
+*     they depend on the contents of binary tables supplied by the
+*     table source function.
+*/
+
+/* Local Variables: */
+   AstObject *new;               /* Pointer to returned FrameSet */
+   ReadRecord rec;               /* Record of side effects */
+   WcsCacheEntry *entry;         /* Pointer to cache entry */
+   char *key;                    /* Description of the FitsStore, etc */
+   int i;                        /* Cache entry index */
+   int use_cache;                /* Is the cache in use? */
+   size_t j;                     /* Byte index within key */
+   size_t keylen;                /* Number of bytes in key */
+   unsigned int hash;            /* Hash code for key */
+
+/* Initialise */
+   new = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return new;
+
+/* If the cache is not in use, or the FitsStore cannot be cached, just
+   create the FrameSet. */
+   LOCK_MUTEX5
+   use_cache = ( wcs_cache_max > 0 );
+   UNLOCK_MUTEX5
+   key = use_cache ? WcsCacheKey( this, store, &keylen, status ) : NULL;
+   if( !key ) return FsetFromStore( this, store, method, class, status );
+
+/* Get a hash code for the key (32 bit FNV-1a). */
+   hash = 2166136261U;
+   for( j = 0; j < keylen; j++ ) {
+      hash = ( hash ^ (unsigned char) key[ j ] )*16777619U;
+   }
+
+/* Look for an entry with the same key in the cache. If found, return a
+   copy of the cached FrameSet and re-instate the side effects of creating
+   it. The cached FrameSet is not locked by any thread when not in use. */
+   LOCK_MUTEX5
+   entry = NULL;
+   for( i = 0; i < wcs_cache_n; i++ ) {
+      if( wcs_cache[ i ].hash == hash && wcs_cache[ i ].keylen == keylen &&
+          !memcmp( wcs_cache[ i ].key, key, keylen ) ) {
+         entry = wcs_cache + i;
+         astManageLock( entry->object, AST__LOCK, 1, NULL );
+         new = astCopy( entry->object );
+         astManageLock( entry->object, AST__UNLOCK, 1, NULL );
+         ReplayRecord( this, &(entry->rec), method, class, status );
+         entry->stamp = ++wcs_cache_stamp;
+         break;
+      }
+   }
+   UNLOCK_MUTEX5
+
+/* If the key was not found in the cache, create the FrameSet, recording
+   the side effects of doing so. */
+   if( !entry ) {
+      memset( &rec, 0, sizeof( rec ) );
+      this->readrec = &rec;
+      new = FsetFromStore( this, store, method, class, status );
+      this->readrec = NULL;
+
+/* If a FrameSet was created succesfully, add it to the cache, replacing
+   the least recently used entry if the cache is full. Use permanent memory
+   for the cache since it may persist until the process exits. */
+      if( new && astOK ) {
+         LOCK_MUTEX5
+         if( wcs_cache_max > 0 ) {
+            TrimWcsCache( wcs_cache_max - 1, status );
+            astBeginPM;
+            wcs_cache = astGrow( wcs_cache, wcs_cache_n + 1,
+                                 sizeof( WcsCacheEntry ) );
+            if( astOK ) {
+               entry = wcs_cache + wcs_cache_n++;
+               memset( entry, 0, sizeof( *entry ) );
+               entry->hash = hash;
+               entry->key = astStore( NULL, key, keylen );
+               entry->keylen = keylen;
+               entry->object = astCopy( new );
+               CopyReadRecord( &rec, &(entry->rec), status );
+               entry->stamp = ++wcs_cache_stamp;
+            }
+            astEndPM;
+
+/* Unlock the cached FrameSet so that it can be used by any thread. If
+   anything went wrong, remove the entry from the cache. */
+            if( entry ) {
+               if( astOK ) {
+                  astManageLock( entry->object, AST__UNLOCK, 1, NULL );
+               } else {
+                  if( entry->object ) entry->object = astAnnul( entry->object );
+                  entry->key = astFree( entry->key );
+                  FreeReadRecord( &(entry->rec), status );
+                  wcs_cache_n--;
+               }
+            }
+         }
+         UNLOCK_MUTEX5
+      }
+      FreeReadRecord( &rec, status );
+   }
+
+/* Free resources */
+   key = astFree( key );
+
+/* Return the FrameSet. */
+   return new;
+}
+
 static char *CardComm( AstFitsChan *this, int *status ){
 
 /*
@@ -7502,6 +7758,75 @@ static char *ConcatWAT( AstFitsChan *this, int iaxis, const char *method,
    return result;
 }
 
+static void CopyReadRecord( const ReadRecord *in, ReadRecord *out,
+                            int *status ){
+/*
+*  Name:
+*     CopyReadRecord
+
+*  Purpose:
+*     Copy a record of the side effects of creating a FrameSet.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void CopyReadRecord( const ReadRecord *in, ReadRecord *out,
+*                          int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function stores a deep copy of the supplied ReadRecord in
+*     the supplied output structure, over-writing (without freeing) any
+*     existing contents.
+
+*  Parameters:
+*     in
+*        Pointer to the structure to copy.
+*     out
+*        Pointer to the structure to receive the copy.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   int i;                /* Index of string to copy */
+
+/* Initialise the output structure. */
+   memset( out, 0, sizeof( *out ) );
+
+/* Check the inherited status. */
+   if( !astOK ) return;
+
+/* Copy the warnings. Each has four strings (condition, text, method and
+   class). */
+   if( in->nwarn > 0 ) {
+      out->wcard = astStore( NULL, in->wcard, in->nwarn*sizeof( int ) );
+      out->wtext = astCalloc( 4*in->nwarn, sizeof( char * ) );
+      if( astOK ) {
+         out->nwarn = in->nwarn;
+         for( i = 0; i < 4*in->nwarn; i++ ) {
+            out->wtext[ i ] = astStore( NULL, in->wtext[ i ],
+                                        strlen( in->wtext[ i ] ) + 1 );
+         }
+      }
+   }
+
+/* Copy the names of the cards marked as used. */
+   if( in->nmark > 0 ) {
+      out->mark = astCalloc( in->nmark, sizeof( char * ) );
+      if( astOK ) {
+         out->nmark = in->nmark;
+         for( i = 0; i < in->nmark; i++ ) {
+            out->mark[ i ] = astStore( NULL, in->mark[ i ],
+                                       strlen( in->mark[ i ] ) + 1 );
+         }
+      }
+   }
+}
+
 static int CountFields( const char *temp, char type, const char *method,
                         const char *class, int *status ){
 /*
@@ -7963,8 +8288,8 @@ static void DeleteCard( AstFitsChan *this, const char *method,
 /* Get a pointer to the card to be deleted (the current card). */
    card = (FitsCard *) this->card;
 
-/* Remove it from the KeyMap holding all keywords. */
-   astMapRemove( this->keywords, card->name );
+/* Remove it from the index of keyword names. */
+   UnindexCard( this, card, status );
 
 /* Move the current card on to the next card. */
    MoveCard( this, 1, method, class, status );
@@ -10844,6 +11169,69 @@ static FitsStore *FitsToStore( AstFitsChan *this, int encoding,
    return ret;
 }
 
+int astFitsWcsCache_( int value, int *status ){
+/*
+*+
+*  Name:
+*     astFitsWcsCache
+
+*  Purpose:
+*     Set or get the maximum number of FrameSets cached by astRead.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     int astFitsWcsCache( int value )
+
+*  Class Membership:
+*     FitsChan member function
+
+*  Description:
+*     This function returns the current value of the "FitsWcsCache"
+*     tuning parameter, optionally storing a new value. It is invoked by
+*     astTune. The value is the maximum number of FrameSets that are
+*     retained by the FitsChan astRead method (for encodings other than
+*     NATIVE) so that they can be re-used when a later header describes
+*     the same WCS.
+
+*  Parameters:
+*     value
+*        The new value. If this is AST__TUNULL the current value is
+*        retained. Values less than zero are treated as zero. If the
+*        new value is smaller than the number of FrameSets currently in
+*        the cache, the least recently used FrameSets are removed from
+*        the cache. A value of zero disables the cache and empties it.
+
+*  Returned Value:
+*     The original value.
+
+*  Notes:
+*     - This function attempts to execute even if an error has already
+*     occurred.
+
+*-
+*/
+
+/* Local Variables: */
+   int result;                   /* Returned value */
+
+   LOCK_MUTEX5
+   result = wcs_cache_max;
+   if( value != AST__TUNULL ) {
+      if( value < 0 ) value = 0;
+      wcs_cache_max = value;
+
+/* Remove the least recently used entries until the cache is small
+   enough. */
+      TrimWcsCache( wcs_cache_max, status );
+   }
+   UNLOCK_MUTEX5
+
+   return result;
+}
+
 static void FreeItem( double ****item, int *status ){
 /*
 *  Name:
@@ -11044,6 +11432,61 @@ static void FreeItemC( char *****item, int *status ){
    }
 }
 
+static void FreeReadRecord( ReadRecord *rec, int *status ){
+/*
+*  Name:
+*     FreeReadRecord
+
+*  Purpose:
+*     Free the memory used by a record of the side effects of creating a
+*     FrameSet.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void FreeReadRecord( ReadRecord *rec, int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function frees all dynamically allocated arrays stored in the
+*     supplied ReadRecord structure, and leaves the structure empty.
+
+*  Parameters:
+*     rec
+*        Pointer to the structure to clean.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function attempts to execute even if an error exists on entry.
+*/
+
+/* Local Variables: */
+   int i;                /* Index of string to free */
+
+/* Free the warnings. */
+   if( rec->wtext ) {
+      for( i = 0; i < 4*rec->nwarn; i++ ) {
+         rec->wtext[ i ] = astFree( rec->wtext[ i ] );
+      }
+   }
+   rec->wtext = astFree( rec->wtext );
+   rec->wcard = astFree( rec->wcard );
+   rec->nwarn = 0;
+
+/* Free the names of the cards marked as used. */
+   if( rec->mark ) {
+      for( i = 0; i < rec->nmark; i++ ) {
+         rec->mark[ i ] = astFree( rec->mark[ i ] );
+      }
+   }
+   rec->mark = astFree( rec->mark );
+   rec->nmark = 0;
+}
+
 static FitsStore *FreeStore( FitsStore *store, int *status ){
 /*
 *  Name:
@@ -13717,6 +14160,62 @@ static AstMapping *GrismSpecWcs( char *algcode, FitsStore *store, int i,
    return ret;
 }
 
+static char *KeyBytes( char *key, size_t *keylen, const void *data,
+                       size_t size, int *status ){
+/*
+*  Name:
+*     KeyBytes
+
+*  Purpose:
+*     Append bytes to a cache key.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     char *KeyBytes( char *key, size_t *keylen, const void *data,
+*                     size_t size, int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function appends a copy of the supplied bytes to the end of a
+*     dynamically allocated array of bytes, extending the array as
+*     necessary. It is used to build the keys that identify entries in
+*     the cache of previously read FrameSets.
+
+*  Parameters:
+*     key
+*        Pointer to the array to extend, or NULL.
+*     keylen
+*        Pointer to the number of bytes currently in the array. Updated
+*        on exit.
+*     data
+*        Pointer to the bytes to append.
+*     size
+*        The number of bytes to append.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the extended array.
+*/
+
+/* Check the inherited status. */
+   if( !astOK ) return key;
+
+/* Extend the array and append the bytes. */
+   key = astGrow( key, *keylen + size, 1 );
+   if( astOK ) {
+      memcpy( key + *keylen, data, size );
+      *keylen += size;
+   }
+
+/* Return the extended array. */
+   return key;
+}
+
 static int KeyFields( AstFitsChan *this, const char *filter, int maxfld,
                     int *ubnd, int *lbnd, int *status ){
 
@@ -13813,10 +14312,12 @@ static int KeyFields( AstFitsChan *this, const char *filter, int maxfld,
 /* Local Variables: */
    const char *class;     /* Object class */
    const char *method;    /* Method name */
+   char prefix[ FITSNAMLEN + 1 ]; /* Upper case literal filter prefix */
    int *fields;           /* Pointer to array of field values */
    int i;                 /* Field index */
    int icard;             /* Index of current card on entry */
    int nmatch;            /* No. of matching cards */
+   int npref;             /* No. of characters in prefix */
    int nf;                /* No. of integer fields in the filter */
    int nfld;              /* No. of integer fields in current keyword name */
 
@@ -13849,6 +14350,11 @@ static int KeyFields( AstFitsChan *this, const char *filter, int maxfld,
    each matching keyword. */
    fields = (int *) astMalloc( sizeof( int )*(size_t) nf );
 
+/* Get the literal characters at the start of the filter. Cards that do
+   not start with these characters can be rejected without the expense
+   of a full template match. */
+   npref = LiteralPrefix( filter, prefix, status );
+
 /* Save the current card index, and rewind the FitsChan. */
    icard = astGetCard( this );
    astClearCard( this );
@@ -13871,7 +14377,8 @@ static int KeyFields( AstFitsChan *this, const char *filter, int maxfld,
 
 /* If the current keyword name matches the filter, update the returned
    bounds and increment the number of matches. */
-         if( Match( CardName( this, status ), filter, nf, fields, &nfld,
+         if( !strncmp( CardName( this, status ), prefix, npref ) &&
+             Match( CardName( this, status ), filter, nf, fields, &nfld,
                     method, class, status ) ){
             for( i = 0; i < nf; i++ ){
                if( fields[ i ] > ubnd[ i ] ) ubnd[ i ] = fields[ i ];
@@ -13913,6 +14420,160 @@ static int KeyFields( AstFitsChan *this, const char *filter, int maxfld,
    return nmatch;
 }
 
+static char *KeyItem( char *key, size_t *keylen, int id, double ***item,
+                      int *status ){
+/*
+*  Name:
+*     KeyItem
+
+*  Purpose:
+*     Append the values of a numerical FitsStore item to a cache key.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     char *KeyItem( char *key, size_t *keylen, int id, double ***item,
+*                    int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function appends a description of each value stored in the
+*     supplied FitsStore item to the end of a cache key (see KeyBytes).
+*     Each value is described by the item identifier, the co-ordinate
+*     version index, the intermediate axis index, the pixel axis or
+*     parameter index, and the value itself. Undefined values are
+*     omitted.
+
+*  Parameters:
+*     key
+*        Pointer to the key to extend, or NULL.
+*     keylen
+*        Pointer to the number of bytes currently in the key. Updated
+*        on exit.
+*     id
+*        An integer that identifies the FitsStore item.
+*     item
+*        The FitsStore item (e.g. "store->crval").
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the extended key.
+*/
+
+/* Local Variables: */
+   int ind[ 4 ];         /* Item identifier and indices */
+   int ni;               /* Number of intermediate axes */
+   int nj;               /* Number of pixel axes or parameters */
+   int nsi;              /* Number of co-ordinate versions */
+
+/* Check the inherited status and the supplied item. */
+   if( !astOK || !item ) return key;
+
+/* Loop round all the defined values in the item. */
+   ind[ 0 ] = id;
+   nsi = astSizeOf( (void *) item )/sizeof( double ** );
+   for( ind[ 1 ] = 0; ind[ 1 ] < nsi; ind[ 1 ]++ ) {
+      if( !item[ ind[ 1 ] ] ) continue;
+      ni = astSizeOf( (void *) item[ ind[ 1 ] ] )/sizeof( double * );
+      for( ind[ 2 ] = 0; ind[ 2 ] < ni; ind[ 2 ]++ ) {
+         if( !item[ ind[ 1 ] ][ ind[ 2 ] ] ) continue;
+         nj = astSizeOf( (void *) item[ ind[ 1 ] ][ ind[ 2 ] ] )/sizeof( double );
+         for( ind[ 3 ] = 0; ind[ 3 ] < nj; ind[ 3 ]++ ) {
+            if( item[ ind[ 1 ] ][ ind[ 2 ] ][ ind[ 3 ] ] != AST__BAD ) {
+               key = KeyBytes( key, keylen, ind, sizeof( ind ), status );
+               key = KeyBytes( key, keylen,
+                               item[ ind[ 1 ] ][ ind[ 2 ] ] + ind[ 3 ],
+                               sizeof( double ), status );
+            }
+         }
+      }
+   }
+
+/* Return the extended key. */
+   return key;
+}
+
+static char *KeyItemC( char *key, size_t *keylen, int id, char ****item,
+                       int *status ){
+/*
+*  Name:
+*     KeyItemC
+
+*  Purpose:
+*     Append the values of a character FitsStore item to a cache key.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     char *KeyItemC( char *key, size_t *keylen, int id, char ****item,
+*                     int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function appends a description of each string stored in the
+*     supplied FitsStore item to the end of a cache key (see KeyBytes).
+*     Each string is described by the item identifier, the co-ordinate
+*     version index, the intermediate axis index, the pixel axis or
+*     parameter index, and the string itself (including its terminating
+*     null). Undefined strings are omitted.
+
+*  Parameters:
+*     key
+*        Pointer to the key to extend, or NULL.
+*     keylen
+*        Pointer to the number of bytes currently in the key. Updated
+*        on exit.
+*     id
+*        An integer that identifies the FitsStore item.
+*     item
+*        The FitsStore item (e.g. "store->ctype").
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the extended key.
+*/
+
+/* Local Variables: */
+   const char *text;     /* Pointer to next string */
+   int ind[ 4 ];         /* Item identifier and indices */
+   int ni;               /* Number of intermediate axes */
+   int nj;               /* Number of pixel axes or parameters */
+   int nsi;              /* Number of co-ordinate versions */
+
+/* Check the inherited status and the supplied item. */
+   if( !astOK || !item ) return key;
+
+/* Loop round all the defined strings in the item. */
+   ind[ 0 ] = id;
+   nsi = astSizeOf( (void *) item )/sizeof( char *** );
+   for( ind[ 1 ] = 0; ind[ 1 ] < nsi; ind[ 1 ]++ ) {
+      if( !item[ ind[ 1 ] ] ) continue;
+      ni = astSizeOf( (void *) item[ ind[ 1 ] ] )/sizeof( char ** );
+      for( ind[ 2 ] = 0; ind[ 2 ] < ni; ind[ 2 ]++ ) {
+         if( !item[ ind[ 1 ] ][ ind[ 2 ] ] ) continue;
+         nj = astSizeOf( (void *) item[ ind[ 1 ] ][ ind[ 2 ] ] )/sizeof( char * );
+         for( ind[ 3 ] = 0; ind[ 3 ] < nj; ind[ 3 ]++ ) {
+            text = item[ ind[ 1 ] ][ ind[ 2 ] ][ ind[ 3 ] ];
+            if( text ) {
+               key = KeyBytes( key, keylen, ind, sizeof( ind ), status );
+               key = KeyBytes( key, keylen, text, strlen( text ) + 1, status );
+            }
+         }
+      }
+   }
+
+/* Return the extended key. */
+   return key;
+}
+
 static int FindFits( AstFitsChan *this, const char *name,
                      char card[ AST__FITSCHAN_FITSCARDLEN + 1 ], int inc, int *status ){
 
@@ -14162,6 +14823,13 @@ static int FindKeyCard( AstFitsChan *this, const char *name,
 *     Finds the next card which refers to the supplied keyword and makes
 *     it the current card. The search starts with the current card and ends
 *     when it reaches the last card.
+*
+*     If the template contains no fields, the cards with the required
+*     name are found directly from the index of keyword names, rather
+*     than by checking every card. Otherwise, cards are checked in turn,
+*     but the (comparatively expensive) full template match is only
+*     performed for cards that start with the literal characters at the
+*     start of the template.
 
 *  Parameters:
 *     this
@@ -14186,21 +14854,70 @@ static int FindKeyCard( AstFitsChan *this, const char *name,
 */
 
 /* Local Variables: */
+   astDECLARE_GLOBALS    /* Declare the thread specific global data */
+   FitsCard *card;       /* Pointer to candidate card */
+   FitsCard *card0;      /* Pointer to original current card */
+   char prefix[ FITSNAMLEN + 1 ]; /* Upper case literal template prefix */
    int nfld;             /* Number of fields in keyword template */
+   int npref;            /* Number of characters in prefix */
    int ret;              /* Was a card found? */
 
 /* Check the global status, and supplied keyword name. */
    if( !astOK || !name ) return 0;
 
+/* Get a pointer to the structure holding thread-specific global data. */
+   astGET_GLOBALS(this);
+
 /* Indicate that no card has been found yet. */
    ret = 0;
 
-/* Search forward through the list until all cards have been checked. */
-   while( !astFitsEof( this ) && astOK ){
+/* Get the upper case form of the literal characters at the start of the
+   template (i.e. those preceding the first field). */
+   npref = LiteralPrefix( name, prefix, status );
+
+/* If the template contains no fields, it must be matched exactly (apart
+   from case) by the name of the required card. The index of keyword
+   names contains a list of all the cards with each name, in the order
+   in which they occur in the FitsChan, so we can find the first such
+   card that is at or after the current card without looking at any
+   other cards. Cards that have been used are skipped, as in MoveCard,
+   unless the card is already the current card. The FitsChan is left at
+   end-of-file if no suitable card is found. Note, astFitsEof is called
+   first to ensure that any cards available from the source function
+   have been read. */
+   if( !name[ npref ] ) {
+      card0 = NULL;
+      if( !astFitsEof( this ) ) card0 = (FitsCard *) this->card;
+
+/* If the current card has the required name, the search can start at the
+   current card. This avoids walking the whole list of cards with the
+   same name when the caller is stepping through a block of such cards.
+   Otherwise, start with the first card with the required name. */
+      if( card0 && !strcmp( card0->name, prefix ) ) {
+         card = card0;
+      } else if( !card0 || !this->keywords ||
+                 !astMapGet0P( this->keywords, prefix, (void **) &card ) ) {
+         card = NULL;
+      }
+
+/* Walk along the list of cards with the required name until a usable
+   card is found at or after the current card. */
+      while( card && ( card->seq < card0->seq ||
+                       ( card != card0 && CARDUSED( card ) ) ) ) {
+         card = card->knext;
+      }
+      this->card = (void *) card;
+      ret = ( card != NULL );
+
+/* Otherwise, search forward through the list until all cards have been
+   checked. */
+   } else while( !astFitsEof( this ) && astOK ){
 
 /* Break out of the loop if the keyword name from the current card matches
-   the supplied keyword name. */
-      if( Match( CardName( this, status ), name, 0, NULL, &nfld, method, class, status ) ){
+   the supplied keyword name. Skip the full template match if the card
+   name does not start with the literal prefix of the template. */
+      if( !strncmp( CardName( this, status ), prefix, npref ) &&
+          Match( CardName( this, status ), name, 0, NULL, &nfld, method, class, status ) ){
          ret = 1;
          break;
 
@@ -18050,13 +18767,6 @@ void astInitFitsChanVtab_(  AstFitsChanVtab *vtab, const char *name, int *status
    LOCK_MUTEX4
    sprintf( buf, "%d", INT_MAX );
    int_dig = strlen( buf );
-
-/* Create a pair of MJD TimeFrames which will be used for converting to and
-   from TDB. */
-   astBeginPM;
-   if( !tdbframe ) tdbframe = astTimeFrame( "system=MJD,timescale=TDB", status );
-   if( !timeframe ) timeframe = astTimeFrame( "system=MJD", status );
-   astEndPM;
    UNLOCK_MUTEX4
 
 /* If we have just initialised the vtab for the current class, indicate
@@ -18068,6 +18778,137 @@ void astInitFitsChanVtab_(  AstFitsChanVtab *vtab, const char *name, int *status
    }
 }
 
+static void IndexCard( AstFitsChan *this, FitsCard *card, int *status ){
+/*
+*  Name:
+*     IndexCard
+
+*  Purpose:
+*     Add a card to the index of keyword names.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     void IndexCard( AstFitsChan *this, FitsCard *card, int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     This function assigns a sequence number to a card that has just
+*     been linked into the list of cards held in a FitsChan, and then
+*     adds the card to the list of cards with the same keyword name.
+*
+*     Sequence numbers increase monotonically from the head of the list
+*     to the end, and are used to compare the positions of two cards
+*     without needing to walk the list. New cards are given a sequence
+*     number mid way between those of their neighbours. If there is no
+*     room for this, all cards in the FitsChan are renumbered.
+*
+*     The "keywords" KeyMap in the FitsChan contains an entry for each
+*     keyword name, holding a pointer to the first card with that name.
+*     The "knext" component of each card points to the next card with
+*     the same name (or is NULL for the last card), and the "kprev"
+*     component points to the previous card with the same name (the
+*     first card points to the last card, so that cards can be appended
+*     quickly).
+
+*  Parameters:
+*     this
+*        Pointer to the FitsChan.
+*     card
+*        Pointer to the card. It should already have been linked into
+*        the list of cards held by the FitsChan.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   AstDim seq;                /* Sequence number for next card */
+   FitsCard *first;           /* First card with the same name */
+   FitsCard *next;            /* Pointer to next card in list */
+   FitsCard *prev;            /* Pointer to previous card in list */
+   FitsCard *pcard;           /* Card after which to insert the new card */
+
+/* Check the global status. */
+   if( !astOK ) return;
+
+/* Get pointers to the neighbouring cards, using NULL to indicate the
+   start or end of the list. */
+   prev = ( (void *) card != this->head ) ? card->prev : NULL;
+   next = ( (void *) card->next != this->head ) ? card->next : NULL;
+
+/* Choose a sequence number for the card. */
+   if( prev && next ) {
+      if( next->seq - prev->seq > 1 ) {
+         card->seq = prev->seq + ( next->seq - prev->seq )/2;
+
+/* If there is no gap between the neighbouring sequence numbers, renumber
+   the whole list. */
+      } else {
+         pcard = (FitsCard *) this->head;
+         seq = 0;
+         do {
+            pcard->seq = seq;
+            seq += CARD_SEQ_GAP;
+            pcard = pcard->next;
+         } while( (void *) pcard != this->head );
+      }
+
+   } else if( prev ) {
+      card->seq = prev->seq + CARD_SEQ_GAP;
+
+   } else if( next ) {
+      card->seq = next->seq - CARD_SEQ_GAP;
+
+   } else {
+      card->seq = 0;
+   }
+
+/* Ensure that a KeyMap exists to hold the keywords currently in the
+   FitsChan. */
+   if( !this->keywords ) this->keywords = astKeyMap( " ", status );
+
+/* If this is the first card with its name, create a new entry in the
+   KeyMap. */
+   if( !astMapGet0P( this->keywords, card->name, (void **) &first ) ) {
+      card->knext = NULL;
+      card->kprev = card;
+      astMapPut0P( this->keywords, card->name, card, NULL );
+
+/* Otherwise, find the last card with the same name that precedes the
+   new card. Search backwards from the last card since new cards are
+   usually appended to the end of the FitsChan. */
+   } else if( astOK ) {
+      pcard = first->kprev;
+      while( pcard && pcard->seq > card->seq ) {
+         pcard = ( pcard != first ) ? pcard->kprev : NULL;
+      }
+
+/* Insert the new card after the card found above. */
+      if( pcard ) {
+         card->knext = pcard->knext;
+         card->kprev = pcard;
+         if( pcard->knext ) {
+            pcard->knext->kprev = card;
+         } else {
+            first->kprev = card;
+         }
+         pcard->knext = card;
+
+/* If no card was found, the new card becomes the first card with its
+   name. */
+      } else {
+         card->knext = first;
+         card->kprev = first->kprev;
+         first->kprev = card;
+         astMapPut0P( this->keywords, card->name, card, NULL );
+      }
+   }
+}
+
 static void InsCard( AstFitsChan *this, int overwrite, const char *name,
                      int type, void *data, const char *comment,
                      const char *method, const char *class, int *status ){
@@ -19772,6 +20613,64 @@ static const char *IsSpectral( const char *ctype, char stype[5], char algcode[5]
    return isspectral_ret;
 }
 
+static int LiteralPrefix( const char *temp, char prefix[ FITSNAMLEN + 1 ],
+                          int *status ){
+/*
+*  Name:
+*     LiteralPrefix
+
+*  Purpose:
+*     Get the literal characters at the start of a keyword template.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     int LiteralPrefix( const char *temp, char prefix[ FITSNAMLEN + 1 ],
+*                        int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     This function returns the characters at the start of a keyword
+*     template (using the syntax expected by the Match function) that
+*     precede the first field, converted to upper case. Any keyword name
+*     that matches the template must start with these characters, since
+*     keyword names are stored in upper case.
+
+*  Parameters:
+*     temp
+*        Pointer to a null terminated string holding the template.
+*     prefix
+*        An array in which to return the null terminated upper case
+*        prefix. At most FITSNAMLEN characters are returned.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of characters in the returned prefix. If the template
+*     contains no fields and is no longer than FITSNAMLEN, "temp[n]" will
+*     be the terminating null, where "n" is the returned value.
+*/
+
+/* Local Variables: */
+   int n;                     /* Number of characters in prefix */
+
+/* Copy characters until the end of the template, the first field, or
+   the maximum length of a keyword name, is reached. */
+   n = 0;
+   while( temp[ n ] && temp[ n ] != '%' && n < FITSNAMLEN ) {
+      prefix[ n ] = (char) toupper( (int) temp[ n ] );
+      n++;
+   }
+   prefix[ n ] = 0;
+
+/* Return the number of characters. */
+   return n;
+}
+
 static AstMapping *LinearWcs( FitsStore *store, int i, char s,
                               const char *method, const char *class, int *status ) {
 /*
@@ -20283,6 +21182,7 @@ static AstMapping *MakeColumnMap( AstFitsTable *table, const char *col,
 /* Local Variables: */
    AstMapping *result;
    char *key;
+   const double *blut;
    double *lut;
    int *dims;
    int ndim;
@@ -20297,6 +21197,14 @@ static AstMapping *MakeColumnMap( AstFitsTable *table, const char *col,
 /* Get the number of dimensions spanned by the value in the named column. */
    ndim = astGetColumnNdim( table, col );
 
+/* If the column holds double precision values in an array borrowed from
+   the caller (see astBorrowColumnData), get a pointer to the array. Row 1
+   is at the start of the array. */
+   blut = NULL;
+   if( astGetColumnType( table, col ) == AST__DOUBLETYPE ) {
+      blut = astGetBorrowedCells( table, col );
+   }
+
 /* First deal with index vectors. */
    if( isindex ) {
 
@@ -20310,8 +21218,9 @@ static AstMapping *MakeColumnMap( AstFitsTable *table, const char *col,
 /* Get the length of the index vector. */
       nel = astGetColumnLength( table, col );
 
-/* Allocate memory to hold the array values, and to hold the cell key. */
-      lut = astMalloc( nel*sizeof( double ) );
+/* Allocate memory to hold the array values (unless they are borrowed),
+   and to hold the cell key. */
+      lut = blut ? NULL : astMalloc( nel*sizeof( double ) );
       key = astMalloc( strlen( col ) + 5 );
       if( astOK ) {
 
@@ -20321,12 +21230,18 @@ static AstMapping *MakeColumnMap( AstFitsTable *table, const char *col,
    the column name. */
          sprintf( key, "%.*s(1)", (int) astChrLen( col ), col );
 
-/* Copy the array values into the above memory. */
-         if( astMapGet1D( table, key, nel, &nel, lut ) ) {
-
-/* Create a 1D LutMap. FITS-WCS paper III (sec 6.1.2) mandates that the input
+/* If the array is borrowed, create a 1D LutMap that uses the borrowed
+   array directly. FITS-WCS paper III (sec 6.1.2) mandates that the input
    corresponds to FITS grid coord (i.e. 1.0 at the centre of the first entry).
    Ensure the LutMap uses linear interpolation. */
+         if( blut && astMapHasKey( table, key ) ) {
+            result = (AstMapping *) astBorrowedLutMap( nel, blut, 1.0, 1.0,
+                                                       "LutInterp=%d", status,
+                                                       interp );
+
+/* Otherwise, copy the array values into the above memory and create a
+   LutMap from them. */
+         } else if( astMapGet1D( table, key, nel, &nel, lut ) ) {
             result = (AstMapping *) astLutMap( nel, lut, 1.0, 1.0,
                                                "LutInterp=%d", status, interp );
 
@@ -20370,8 +21285,9 @@ static AstMapping *MakeColumnMap( AstFitsTable *table, const char *col,
 /* Handle 1-dimensional  look-up tables. */
       } else if( astOK ){
 
-/* Allocate memory to hold the array values, and to hold the cell key. */
-         lut = astMalloc( dims[ 1 ]*sizeof( double ) );
+/* Allocate memory to hold the array values (unless they are borrowed),
+   and to hold the cell key. */
+         lut = blut ? NULL : astMalloc( dims[ 1 ]*sizeof( double ) );
          key = astMalloc( strlen( col ) + 5 );
          if( astOK ) {
 
@@ -20381,12 +21297,19 @@ static AstMapping *MakeColumnMap( AstFitsTable *table, const char *col,
    the column name. */
             sprintf( key, "%.*s(1)", (int) astChrLen( col ), col );
 
-/* Copy the array values into the above memory. */
-            if( astMapGet1D( table, key, dims[ 1 ], dims, lut ) ) {
-
-/* Create a 1D LutMap. FITS-WCS paper III (sec 6.1.2) mandates that the input
+/* If the array is borrowed, create a 1D LutMap that uses the borrowed
+   array directly. FITS-WCS paper III (sec 6.1.2) mandates that the input
    corresponds to FITS grid coord (i.e. 1.0 at the centre of the first entry).
    Ensure the LutMap uses linear interpolation. */
+            if( blut && astMapHasKey( table, key ) ) {
+               result = (AstMapping *) astBorrowedLutMap( dims[ 1 ], blut,
+                                                          1.0, 1.0,
+                                                          "LutInterp=%d",
+                                                          status, interp );
+
+/* Otherwise, copy the array values into the above memory and create a
+   LutMap from them. */
+            } else if( astMapGet1D( table, key, dims[ 1 ], dims, lut ) ) {
                result = (AstMapping *) astLutMap( dims[ 1 ], lut, 1.0, 1.0,
                                                   "LutInterp=%d", status,
                                                   interp );
@@ -22317,7 +23240,11 @@ static void MarkCard( AstFitsChan *this, int *status ){
 *  Notes:
 *     -  The card remains the current card even though it is now marked
 *     as having been read.
+*     -  If the side effects of creating a FrameSet are being recorded
+*     (see CachedFsetFromStore), the name of the card is recorded.
 */
+   ReadRecord *rec;
+   const char *name;
    int flags;
 
 /* Return if the global error status has been set, or the current card
@@ -22329,6 +23256,18 @@ static void MarkCard( AstFitsChan *this, int *status ){
    flags = ( (FitsCard *) this->card )->flags;
    if( !( flags & PROTECTED ) ) {
       ( (FitsCard *) this->card )->flags = flags | PROVISIONALLY_USED;
+
+/* Record the name of the card if required, unless it was already
+   marked. */
+      if( this->readrec && !( flags & ( USED | PROVISIONALLY_USED ) ) ) {
+         rec = (ReadRecord *) this->readrec;
+         rec->mark = astGrow( rec->mark, rec->nmark + 1, sizeof( char * ) );
+         if( astOK ) {
+            name = ( (FitsCard *) this->card )->name;
+            rec->mark[ rec->nmark++ ] = astStore( NULL, name,
+                                                  strlen( name ) + 1 );
+         }
+      }
    }
 }
 
@@ -22694,14 +23633,6 @@ static void NewCard( AstFitsChan *this, const char *name, int type,
       while( *a ) *(b++) = (char) toupper( (int) *(a++) );
       *b = 0;
 
-/* Ensure that a KeyMap exists to hold the keywords currently in the
-   FitsChan. */
-      if( !this->keywords ) this->keywords = astKeyMap( " ", status );
-
-/* Add the keyword name to the KeyMap. The value associated with the
-   KeyMap entry is not used and is set arbitrarily to zero. */
-      astMapPut0I( this->keywords, new->name, 0, NULL );
-
 /* Copy the data type. */
       new->type = type;
 
@@ -22811,6 +23742,9 @@ static void NewCard( AstFitsChan *this, const char *name, int type,
             this->card = NULL;
          }
       }
+
+/* Add the new card to the index of keyword names. */
+      IndexCard( this, new, status );
    }
 
 /* Return. */
@@ -24539,6 +25473,7 @@ f        The global status.
 
 /* Local Variables: */
    const char *a;         /* Pointer to start of next card */
+   const char *class;     /* Object class */
    int clen;              /* Length of supplied string */
    int i;                 /* Card index */
    int ncard;             /* No. of cards supplied */
@@ -24554,12 +25489,16 @@ f        The global status.
 
 /* Loop round the supplied string in 80 character segments, inserting
    each segment into the FitsChan as a header card. Allow the last card
-   to be less than 80 characters long. */
+   to be less than 80 characters long. Each card is parsed directly from
+   the supplied string, without taking a copy of it first. */
+   class = astGetClass( this );
    clen = strlen( cards );
    ncard = clen/80;
    if( ncard*80 < clen ) ncard++;
    a = cards;
-   for( i = 0; i < ncard; i++, a += 80 ) astPutFits( this, a, 1 );
+   for( i = 0; i < ncard && astOK; i++, a += 80 ) {
+      StoreCard( this, a, 1, "astPutCards", class, status );
+   }
 
 /* Rewind the FitsChan. */
    astClearCard( this );
@@ -24631,124 +25570,15 @@ f        The global status.
 *--
 */
 
-/* Local Variables: */
-   char *comment;         /* The keyword comment */
-   char *name;            /* The keyword name */
-   char *value;           /* The keyword value */
-   const char *class;     /* Object class */
-   const char *method;    /* Current method */
-   double cfval[2];       /* Complex floating point keyword value */
-   double fval;           /* floating point keyword value */
-   int cival[2];          /* Complex integer keyword value */
-   int ival;              /* Integer keyword value */
-   int len;               /* No. of characters to read from the value string */
-   int nc;                /* No. of characters read from value string */
-   int type;              /* Keyword data type */
-
 /* Check the global error status. */
    if ( !astOK ) return;
 
 /* Ensure the source function has been called */
    ReadFromSource( this, status );
 
-/* Store the current method, and the class of the supplied object for use
-   in error messages.*/
-   method = "astPutFits";
-   class = astGetClass( this );
-
-/* Split the supplied card up into name, value and commment strings, and
-   get pointers to local copies of them. The data type associated with the
-   keyword is returned. */
-   type = Split( this, card, &name, &value, &comment, method, class, status );
-
-/* Check that the pointers can be used. */
-   if( astOK ){
-
-/* Initialise the number of characters read from the value string. */
-      nc = 0;
-
-/* Store the number of characters in the value string. */
-      len = strlen( value );
-
-/* Read and store floating point values from the value string. NB, this
-   list is roughly in the order of descreasing frequency of use (i.e.
-   most FITS keywords are simple floating point values, the next most
-   common are strings, etc). */
-      if( type == AST__FLOAT ){
-         if( 1 == astSscanf( value, " %lf %n", &fval, &nc ) && nc >= len ){
-            astSetFitsF( this, name, fval, comment, overwrite );
-         } else {
-            astError( AST__BDFTS, "%s(%s): Unable to read a floating point "
-                      "FITS keyword value.", status, method, class );
-         }
-
-/* Read and store string values from the value string. */
-      } else if( type == AST__STRING ){
-         astSetFitsS( this, name, value, comment, overwrite );
-
-/* Read and store string values from the value string. */
-      } else if( type == AST__CONTINUE ){
-         astSetFitsCN( this, name, value, comment, overwrite );
-
-/* Store comment card. */
-      } else if( type == AST__COMMENT ){
-         astSetFitsCom( this, name, comment, overwrite );
-
-/* Read and store integer values from the value string. */
-      } else if( type == AST__INT ){
-         if( 1 == astSscanf( value, " %d %n", &ival, &nc ) && nc >= len ){
-            astSetFitsI( this, name, ival, comment, overwrite );
-         } else {
-            astError( AST__BDFTS, "%s(%s): Unable to read an integer FITS "
-                      "keyword value.", status, method, class );
-         }
-
-/* Read and store logical values from the value string. */
-      } else if( type == AST__LOGICAL ){
-         astSetFitsL( this, name, (*value == 'T'), comment, overwrite );
-
-/* Read and store undefined values from the value string. */
-      } else if( type == AST__UNDEF ){
-         astSetFitsU( this, name, comment, overwrite );
-
-/* Read and store complex floating point values from the value string. */
-      } else if( type == AST__COMPLEXF ){
-         if( 2 == astSscanf( value, " %lf %lf %n", cfval, cfval + 1, &nc ) &&
-             nc >= len ){
-            astSetFitsCF( this, name, cfval, comment, overwrite );
-         } else {
-            astError( AST__BDFTS, "%s(%s): Unable to read a complex pair "
-                      "of floating point FITS keyword values.", status, method, class );
-         }
-
-/* Read and store complex integer values from the value string. */
-      } else if( type == AST__COMPLEXI ){
-         if( 2 == astSscanf( value, " %d %d %n", cival, cival + 1, &nc ) &&
-             nc >= len ){
-            astSetFitsCI( this, name, cival, comment, overwrite );
-         } else {
-            astError( AST__BDFTS, "%s(%s): Unable to read a complex pair "
-                      "of integer FITS keyword values.", status, method, class );
-         }
-
-/* Report an error for any other type. */
-      } else {
-         astError( AST__INTER, "%s: AST internal programming error - "
-                   "FITS data-type '%d' not yet supported.", status, method, type );
-      }
-
-/* Give a context message if an error occurred. */
-      if( !astOK ){
-         astError( astStatus, "%s(%s): Unable to store the following FITS "
-                   "header card:\n%s\n", status, method, class, card );
-      }
-   }
-
-/* Free the memory used to hold the keyword name, comment and value
-   strings. */
-   (void) astFree( (void *) name );
-   (void) astFree( (void *) comment );
-   (void) astFree( (void *) value );
+/* Parse the card and store it in the FitsChan. */
+   StoreCard( this, card, overwrite, "astPutFits", astGetClass( this ),
+              status );
 }
 
 static void PutTable( AstFitsChan *this, AstFitsTable *table,
@@ -24801,6 +25631,8 @@ f     TABLE = INTEGER (Given)
 *        it is replaced with the new one. A deep copy of the FitsTable is
 *        stored in the FitsChan, so any subsequent changes made to the
 *        FitsTable will have no effect on the behaviour of the FitsChan.
+c        The copy shares any column arrays that were stored in the
+c        FitsTable using astBorrowColumnData.
 c     extnam
 f     EXTNAM = CHARACTER * ( * ) (Given)
 *        The name of the FITS extension associated with the table.
@@ -25035,8 +25867,9 @@ static AstObject *Read( AstChannel *this_channel, int *status ) {
    intermediary structure called a FitsStore. */
          store = FitsToStore( this, encoding, method, class, status );
 
-/* Now create a FrameSet from this FitsStore. */
-         new = FsetFromStore( this, store, method, class, status );
+/* Now create a FrameSet from this FitsStore, re-using a previously
+   created FrameSet if possible. */
+         new = CachedFsetFromStore( this, store, method, class, status );
 
 /* Release the resources used by the FitsStore. */
          store = FreeStore( store, status );
@@ -25379,6 +26212,7 @@ static void ReadFromSource( AstFitsChan *this, int *status ){
 /* Local Variables: */
    const char *(* source)( void ); /* Pointer to source function */
    const char *card;               /* Pointer to externally-read header card */
+   const char *class;              /* Object class */
    int icard;                      /* Current card index on entry */
 
 /* Check the global status. */
@@ -25403,6 +26237,7 @@ static void ReadFromSource( AstFitsChan *this, int *status ){
 
 /* Store the current card index. */
       icard = astGetCard( this );
+      class = astGetClass( this );
 
 /* Obtain the first header card from the source function. This is an
    externally supplied function which may not be thread-safe, so lock a
@@ -25419,7 +26254,7 @@ static void ReadFromSource( AstFitsChan *this, int *status ){
       while( card && astOK ){
 
 /* Store the card in the FitsChan. */
-         astPutFits( this, card, 0 );
+         StoreCard( this, card, 0, "astPutFits", class, status );
 
 /* Free the memory holding the header card. */
          card = (char *) astFree( (void *) card );
@@ -25439,6 +26274,137 @@ static void ReadFromSource( AstFitsChan *this, int *status ){
    }
 }
 
+static int ReadNumbers( const char *text, int len, int integer,
+                        double dval[ 2 ], int ival[ 2 ], int *status ){
+/*
+*  Name:
+*     ReadNumbers
+
+*  Purpose:
+*     Read one or two numerical values from a FITS keyword value string.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     int ReadNumbers( const char *text, int len, int integer,
+*                      double dval[ 2 ], int ival[ 2 ], int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     This function attempts to read a pair of numerical values (separated
+*     by white space), or failing that a single numerical value, from the
+*     start of the supplied string. The values must account for all
+*     non-blank characters in the string. Well-formed values are read
+*     using a single pass of strtol or strtod. Anything else is passed
+*     on to astSscanf (using the formats " %d %d%n" and " %d%n", or " %lf
+*     %lf%n" and " %lf%n"), so that the C library has the final say on
+*     what is an acceptable number.
+
+*  Parameters:
+*     text
+*        Pointer to the string to read.
+*     len
+*        The number of characters in "text", excluding trailing spaces.
+*     integer
+*        If non-zero, integer values are read into "ival". Otherwise,
+*        floating point values are read into "dval".
+*     dval
+*        Array in which to return any floating point values read.
+*     ival
+*        Array in which to return any integer values read.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned value:
+*     The number of values read - 2, 1 or zero. Zero is returned if the
+*     string does not contain one or two numerical values, or if an error
+*     has already occurred.
+*/
+
+/* Local Variables: */
+   char *end1;                /* Pointer to end of first value */
+   char *end2;                /* Pointer to end of second value */
+   double d1;                 /* First floating point value */
+   double d2;                 /* Second floating point value */
+   int nch;                   /* No. of characters read by astSscanf */
+   long int l1;               /* First integer value */
+   long int l2;               /* Second integer value */
+
+/* Check the global status. */
+   if( !astOK ) return 0;
+
+/* Initialise. */
+   d1 = d2 = 0.0;
+   l1 = l2 = 0;
+
+/* Read the first value. Both strtol and strtod skip leading white space,
+   as does a space in a scanf format. */
+   if( integer ) {
+      l1 = strtol( text, &end1, 10 );
+   } else {
+      d1 = strtod( text, &end1 );
+   }
+
+/* Attempt to read a second value from the remainder of the string. If
+   successful and the whole string has been used, return both values. */
+   end2 = end1;
+   if( end1 != text ) {
+      if( integer ) {
+         l2 = strtol( end1, &end2, 10 );
+      } else {
+         d2 = strtod( end1, &end2 );
+      }
+   }
+   if( end2 != end1 && end2 - text >= len ) {
+      if( integer ) {
+         ival[ 0 ] = (int) l1;
+         ival[ 1 ] = (int) l2;
+      } else {
+         dval[ 0 ] = d1;
+         dval[ 1 ] = d2;
+      }
+      return 2;
+   }
+
+/* Otherwise, return the first value if it accounts for the whole string. */
+   if( end1 != text && end1 - text >= len ) {
+      if( integer ) {
+         ival[ 0 ] = (int) l1;
+      } else {
+         dval[ 0 ] = d1;
+      }
+      return 1;
+   }
+
+/* The string contains something else. This is rare, so fall back to
+   astSscanf. Some C libraries accept forms (such as a truncated
+   exponent) that strtod rejects. */
+   if( integer ) {
+      if( nch = 0, ( 2 == astSscanf( text, " %d %d%n", ival, ival + 1,
+                                     &nch ) ) && ( nch >= len ) ) {
+         return 2;
+      } else if( nch = 0, ( 1 == astSscanf( text, " %d%n", ival, &nch ) ) &&
+                 ( nch >= len ) ) {
+         return 1;
+      }
+   } else {
+      if( nch = 0, ( 2 == astSscanf( text, " %lf %lf%n", dval, dval + 1,
+                                     &nch ) ) && ( nch >= len ) ) {
+         return 2;
+      } else if( nch = 0, ( 1 == astSscanf( text, " %lf%n", dval, &nch ) ) &&
+                 ( nch >= len ) ) {
+         return 1;
+      }
+   }
+
+/* Return zero if the string does not contain one or two numbers. */
+   return 0;
+}
+
 static void RemoveTables( AstFitsChan *this, const char *key, int *status ){
 
 /*
@@ -25516,6 +26482,76 @@ f        The global status.
    }
 }
 
+static void ReplayRecord( AstFitsChan *this, const ReadRecord *rec,
+                          const char *method, const char *class, int *status ){
+/*
+*  Name:
+*     ReplayRecord
+
+*  Purpose:
+*     Re-instate the side effects of creating a FrameSet.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     void ReplayRecord( AstFitsChan *this, const ReadRecord *rec,
+*                        const char *method, const char *class, int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     This function modifies the supplied FitsChan in the same way that
+*     FsetFromStore modified the FitsChan from which the supplied record
+*     was made. Each recorded warning is issued again (with the same card
+*     as the current card), and the first card with each recorded keyword
+*     name that has not already been used is marked as having been
+*     provisionally used.
+
+*  Parameters:
+*     this
+*        Pointer to the FitsChan.
+*     rec
+*        Pointer to the record of the side effects created by
+*        CachedFsetFromStore.
+*     method
+*        Pointer to a string holding the name of the calling method.
+*        This is only for use in constructing error messages.
+*     class
+*        Pointer to a string holding the name of the supplied object class.
+*        This is only for use in constructing error messages.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   int i;                /* Index of recorded warning or card */
+
+/* Check the inherited status. */
+   if( !astOK ) return;
+
+/* Issue the warnings. */
+   for( i = 0; i < rec->nwarn; i++ ) {
+      astSetCard( this, rec->wcard[ i ] );
+      Warn( this, rec->wtext[ 4*i ], rec->wtext[ 4*i + 1 ],
+            rec->wtext[ 4*i + 2 ], rec->wtext[ 4*i + 3 ], status );
+   }
+
+/* Mark the cards. */
+   for( i = 0; i < rec->nmark; i++ ) {
+      astClearCard( this );
+      while( FindKeyCard( this, rec->mark[ i ], method, class, status ) ) {
+         if( !( *CardFlags( this, status ) & PROVISIONALLY_USED ) ) {
+            MarkCard( this, status );
+            break;
+         }
+         MoveCard( this, 1, method, class, status );
+      }
+   }
+}
+
 static void RetainFits( AstFitsChan *this, int *status ){
 
 /*
@@ -31193,7 +32229,8 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
 
 *  Description:
 *     The name, value and comment (if present) are extracted from the
-*     supplied card text and returned.
+*     supplied card text and returned in dynamically allocated strings.
+*     See SplitCard for details of the parsing.
 
 *  Parameters:
 *     this
@@ -31224,6 +32261,124 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
 *     AST__STRING, AST__CONTINUE, AST__FLOAT, AST__COMPLEXI or AST__COMPLEXF
 *     defined in fitschan.h.
 
+*  Notes:
+*     -  The memory holding the three strings "name", "value" and "comment"
+*     should be released when no longer needed using astFree.
+*     -  NULL pointers and a data type of AST__COMMENT are returned if an
+*     error has already occurred, or if this function fails for any reason.
+*/
+
+/* Local Variables: */
+   char lcom[ AST__FITSCHAN_FITSCARDLEN + 1 ]; /* Comment buffer */
+   char lname[ FITSNAMLEN + 1 ];               /* Keyword name buffer */
+   char lval[ AST__FITSCHAN_FITSCARDLEN + 2 ]; /* Keyword value buffer */
+   double dval[ 2 ];                           /* Unused numerical values */
+   int ival[ 2 ];                              /* Unused integer values */
+   int type;                                   /* Keyword data type */
+
+/* Initialise the returned pointers. */
+   *name = NULL;
+   *value = NULL;
+   *comment = NULL;
+
+/* Check the global status. */
+   if( !astOK ) return AST__COMMENT;
+
+/* Split the card into local buffers. */
+   type = SplitCard( this, card, lname, lval, lcom, dval, ival, method,
+                     class, status );
+
+/* Return dynamically allocated copies of the three strings. */
+   if( astOK ) {
+      *name = astStore( NULL, lname, strlen( lname ) + 1 );
+      *value = astStore( NULL, lval, strlen( lval ) + 1 );
+      *comment = astStore( NULL, lcom, strlen( lcom ) + 1 );
+   }
+
+/* If an error occurred, free the returned strings. */
+   if( !astOK ){
+      *name = (char *) astFree( (void *) *name );
+      *value = (char *) astFree( (void *) *value );
+      *comment = (char *) astFree( (void *) *comment );
+      type = AST__COMMENT;
+   }
+
+/* Return the data type. */
+   return type;
+}
+
+static int SplitCard( AstFitsChan *this, const char *card,
+                      char name[ FITSNAMLEN + 1 ],
+                      char value[ AST__FITSCHAN_FITSCARDLEN + 2 ],
+                      char comment[ AST__FITSCHAN_FITSCARDLEN + 1 ],
+                      double dval[ 2 ], int ival[ 2 ], const char *method,
+                      const char *class, int *status ){
+/*
+*  Name:
+*     SplitCard
+
+*  Purpose:
+*     Extract the keyword name, value and comment from a FITS header card
+*     into caller-supplied buffers.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     int SplitCard( AstFitsChan *this, const char *card,
+*                    char name[ FITSNAMLEN + 1 ],
+*                    char value[ AST__FITSCHAN_FITSCARDLEN + 2 ],
+*                    char comment[ AST__FITSCHAN_FITSCARDLEN + 1 ],
+*                    double dval[ 2 ], int ival[ 2 ], const char *method,
+*                    const char *class, int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     The name, value and comment (if present) are extracted from the
+*     supplied card text and returned. Any numerical value is also
+*     converted to binary form, so that the card text need only be
+*     scanned once. No memory is allocated, which allows large headers
+*     to be ingested without a collection of short-lived strings being
+*     created for every card.
+
+*  Parameters:
+*     this
+*        Pointer to the FitsCHan.
+*     card
+*        Pointer to a string holding the FITS header card.
+*     name
+*        Buffer in which to return the null-terminated keyword name.
+*     value
+*        Buffer in which to return the null-terminated keyword value.
+*     comment
+*        Buffer in which to return the null-terminated keyword comment.
+*     dval
+*        Array in which to return the floating point value (element 0),
+*        or the real and imaginary parts of a complex floating point
+*        value. Only used if the returned data type is AST__FLOAT or
+*        AST__COMPLEXF.
+*     ival
+*        Array in which to return the integer value (element 0), or the
+*        real and imaginary parts of a complex integer value. Only used
+*        if the returned data type is AST__INT or AST__COMPLEXI.
+*     method
+*        Pointer to a string holding the name of the calling method.
+*        This is only for use in constructing error messages.
+*     class
+*        Pointer to a string holding the name of the supplied object class.
+*        This is only for use in constructing error messages.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned value:
+*     -  An integer identifying the data type of the keyword value. This
+*     will be one of the values AST__UNDEF, AST__COMMENT, AST__INT,
+*     AST__STRING, AST__CONTINUE, AST__FLOAT, AST__COMPLEXI or AST__COMPLEXF
+*     defined in fitschan.h.
+
 *  Notes:
 *     -  If the keyword value is a string, then the returned value does not
 *     include the delimiting quotes, and pairs of adjacent quotes within the
@@ -31231,9 +32386,7 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
 *     -  A maximum of 80 characters are read from the supplied card, so the
 *     string does not need to be null terminated unless less than 80
 *     characters are to be read.
-*     -  The memory holding the three strings "name", "value" and "comment"
-*     should be released when no longer needed using astFree.
-*     -  NULL pointers and a data type of AST__COMMENT are returned if an
+*     -  Null strings and a data type of AST__COMMENT are returned if an
 *     error has already occurred, or if this function fails for any reason.
 */
 
@@ -31245,26 +32398,24 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
    char buf[255];             /* Buffer for warning text */
    const char *d;             /* Pointer to first comment character */
    const char *v0;            /* Pointer to first non-blank value character */
-   double fi, fr;             /* Values read from value string */
    int badval;                /* Is the keyword value illegal? */
    int blank_name;            /* Is keyword name blank? */
    int cont;                  /* Is this a continuation card? */
    int i;                     /* Character index */
-   int ii, ir;                /* Values read from value string */
    int iopt;                  /* Index of option within list */
    int len;                   /* Used length of value string */
    int lq;                    /* Was previous character an escaping quote? */
-   int nch;                   /* No. of characters used */
+   int nval;                  /* No. of numerical values read */
    int ndig;                  /* No. of digits in the formatted integer */
    int type;                  /* Keyword data type */
    size_t nc;                 /* Number of character in the supplied card */
    size_t ncc;                /* No. of characters in the comment string */
    size_t ncv;                /* No. of characters in the value string */
 
-/* Initialise the returned pointers. */
-   *name = NULL;
-   *value = NULL;
-   *comment = NULL;
+/* Initialise the returned strings. */
+   name[ 0 ] = 0;
+   value[ 0 ] = 0;
+   comment[ 0 ] = 0;
    type = AST__COMMENT;
 
 /* Check the global status. */
@@ -31282,85 +32433,70 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
    characters such as new-lines at the end of the string are ignored. */
    while( nc > 0 && !isprint( card[ nc - 1 ] ) ) nc--;
 
-/* Allocate memory for a copy of the keyword name plus a terminating
-   null character. */
-   *name = (char *) astMalloc( ( 1 + FITSNAMLEN )*sizeof(char) );
-
-/* Check the pointer can be used. */
-   if( astOK ){
-
 /* Initialise the name string by filling it with spaces, and terminating it. */
-      for( i = 0; i < FITSNAMLEN; i++ ) (*name)[ i ] = ' ';
-      (*name)[ FITSNAMLEN ] = 0;
+   for( i = 0; i < FITSNAMLEN; i++ ) name[ i ] = ' ';
+   name[ FITSNAMLEN ] = 0;
 
 /* Copy the the keyword name, ensuring that no more than FITSNAMLEN (8)
    characters are copied. */
-      strncpy( *name, card, ( nc > FITSNAMLEN ) ? FITSNAMLEN : nc );
+   strncpy( name, card, ( nc > FITSNAMLEN ) ? FITSNAMLEN : nc );
 
 /* If there is no keyword name, flag that we have a blank name which will
    be treated as a comment card. */
-      if( strspn( *name, " " ) == strlen( *name ) ){
-         blank_name = 1;
+   if( strspn( name, " " ) == strlen( name ) ){
+      blank_name = 1;
 
 /* If the card contains a keyword name, replace any white space with
    nulls. */
-      } else {
-         blank_name = 0;
-         dd = *name + strlen( *name ) - 1;
-         while( isspace( *dd ) ) *(dd--) = 0;
-      }
+   } else {
+      blank_name = 0;
+      dd = name + strlen( name ) - 1;
+      while( isspace( *dd ) ) *(dd--) = 0;
+   }
 
 /* Check the keyword name is legal. */
-      CheckFitsName( this, *name, method, class, status );
-
-/* Allocate memory to hold the keyword value and comment strings. */
-      *value = (char *) astMalloc( sizeof(char)*( 2 + nc ) );
-      *comment = (char *) astMalloc( sizeof(char)*( 1 + nc ) );
-
-/* Check the pointers can be used. */
-      if( astOK ){
+   CheckFitsName( this, name, method, class, status );
 
 /* Check for CONTINUE cards. These have keyword CONTINUE but have a space
    instead of an equals sign in column 9. They must also have a single quote
    in column 11. */
-         cont = ( !Ustrcmp( *name, "CONTINUE", status ) &&
-                  nc > FITSNAMLEN + 3 &&
-                  card[ FITSNAMLEN ] == ' ' &&
-                  card[ FITSNAMLEN + 2 ] == '\'' );
+   cont = ( !Ustrcmp( name, "CONTINUE", status ) &&
+            nc > FITSNAMLEN + 3 &&
+            card[ FITSNAMLEN ] == ' ' &&
+            card[ FITSNAMLEN + 2 ] == '\'' );
 
 /* If column 9 does not contain an equals sign (but is not a CONTINUE card), or if
    the keyword is "HISTORY", "COMMENT" or blank, then columns 9 to the end are
    comment characters, and the value string is null. */
-         if( ( nc <= FITSNAMLEN || card[ FITSNAMLEN ] != '='
-                                || !Ustrcmp( *name, "HISTORY", status )
-                                || !Ustrcmp( *name, "COMMENT", status )
-                                || blank_name ) && !cont ){
-            (*value)[ 0 ] = 0;
-            if( nc > FITSNAMLEN ){
-               (void) strncpy( *comment, card + FITSNAMLEN,
-                               nc - FITSNAMLEN );
-               (*comment)[ nc - FITSNAMLEN ] = 0;
-            } else {
-               (*comment)[ 0 ] = 0;
-            }
+   if( ( nc <= FITSNAMLEN || card[ FITSNAMLEN ] != '='
+                          || !Ustrcmp( name, "HISTORY", status )
+                          || !Ustrcmp( name, "COMMENT", status )
+                          || blank_name ) && !cont ){
+      value[ 0 ] = 0;
+      if( nc > FITSNAMLEN ){
+         (void) strncpy( comment, card + FITSNAMLEN, nc - FITSNAMLEN );
+         comment[ nc - FITSNAMLEN ] = 0;
+      } else {
+         comment[ 0 ] = 0;
+      }
 
 /* Otherwise there is a value field. */
-         } else {
+   } else {
 
 /* Find the first non-blank character in the value string. */
-            v0 = card + FITSNAMLEN + 1;
-            while( (size_t)(v0 - card) < nc &&
-                   isspace( (int) *v0 ) ) v0++;
+      v0 = card + FITSNAMLEN + 1;
+      while( (size_t)(v0 - card) < nc &&
+             isspace( (int) *v0 ) ) v0++;
 
 /* Store pointers to the start of the returned value and comment strings. */
-            v = *value;
-            c = *comment;
+      v = value;
+      c = comment;
 
 /* If the first character in the value string is a single quote, the value is
    a string. In this case the value ends at the first non-escaped single
    quote. */
-            if( *v0 == '\''){
-               type = cont ? AST__CONTINUE : AST__STRING;
+      if( *v0 == '\''){
+         type = cont ? AST__CONTINUE : AST__STRING;
 
 /* We want to copy the string value, without the delimiting quotes, to the
    returned value string. Single quotes within the string are represented
@@ -31369,54 +32505,54 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
    to the first character after the opening quote, and set a flag
    indicating that (for the purposes of identifying pairs of adjacent
    quotes within the string) the previous character was not a quote. */
-               d = v0 + 1;
-               lq = 0;
+         d = v0 + 1;
+         lq = 0;
 
 /* Loop round each remaining character in the supplied card. */
-               while( (size_t)(d - card) < nc ){
+         while( (size_t)(d - card) < nc ){
 
 /* If the current character is a single quote... */
-                  if( *d == '\'' ){
+            if( *d == '\'' ){
 
 /* If the previous character was also a single quote then the quote does
    not mark the end of the string, but is a quote to be included literally
    in the value. Copy the quote to the returned string and clear the flag
    to indicate that the pair of adjacent quotes is now complete. */
-                    if( lq ){
-                       *(v++) = '\'';
-                       lq = 0;
+              if( lq ){
+                 *(v++) = '\'';
+                 lq = 0;
 
 /* If the last character was not a quote, then set the flag for the next
    pass through the loop, but do not copy the quote to the returned string
    since it will either be a quote escaping a following adjacent quote, or
    a quote to mark the end of the string. */
-                    } else {
-                       lq = 1;
-                    }
+              } else {
+                 lq = 1;
+              }
 
 /* If the current character is not a quote... */
-                  } else {
+            } else {
 
 /* If the previous character was a quote, then we have found a single
    isolated quote which therefore marks the end of the string value.
    The pointer "d" is left pointing to the first character
    after the terminating quote. */
-                     if( lq ){
-                        break;
+               if( lq ){
+                  break;
 
 /* If the last character was not a quote, copy it to the returned string. */
-                     } else {
-                        *(v++) = *d;
-                     }
-                  }
-                  d++;
+               } else {
+                  *(v++) = *d;
                }
+            }
+            d++;
+         }
 
 /* Terminate the returned value string. */
-               *v = 0;
+         *v = 0;
 
 /* Now deal with logical and numerical values. */
-            } else {
+      } else {
 
 /* The end of the value field is marked by the first "/". Find the number
    of characters in the value field. Pointer "d" is left pointing to the
@@ -31424,182 +32560,160 @@ int Split( AstFitsChan *this, const char *card, char **name, char **value,
    occur within the first nc characters, and do not occur wiuthin the
    keyword name (not strictly legal, but a warning will have been issued
    by CheckFitsName in such cases). */
-               d = strchr( card + FITSNAMLEN, '/' );
-               if( !d || ( d - card ) >= nc ){
-                  ncv = nc - FITSNAMLEN - 1;
-                  d = NULL;
-               } else {
-                  ncv = (size_t)( d - card ) - FITSNAMLEN - 1;
-               }
+         d = strchr( card + FITSNAMLEN, '/' );
+         if( !d || ( d - card ) >= nc ){
+            ncv = nc - FITSNAMLEN - 1;
+            d = NULL;
+         } else {
+            ncv = (size_t)( d - card ) - FITSNAMLEN - 1;
+         }
 
 /* Copy the value string to the returned string. */
-               if( ncv == 0 ){
-                  *v = 0;
-               } else {
-                  strncpy( v, card + FITSNAMLEN + 1, ncv );
-                  v[ ncv ] = ' ';
-                  v[ ncv + 1 ] = 0;
-               }
+         if( ncv == 0 ){
+            *v = 0;
+         } else {
+            strncpy( v, card + FITSNAMLEN + 1, ncv );
+            v[ ncv ] = ' ';
+            v[ ncv + 1 ] = 0;
+         }
 
 /* Find the first non-blank character in the value string. */
-               v0 = v;
-               while( *v0 && isspace( (int) *v0 ) ) v0++;
+         v0 = v;
+         while( *v0 && isspace( (int) *v0 ) ) v0++;
 
 /* See if the value string is one of the following strings (optionally
-   abbreviated and case insensitive): YES, NO, TRUE, FALSE. */
-               iopt = FullForm( "YES NO TRUE FALSE", v0, 1, status );
+   abbreviated and case insensitive): YES, NO, TRUE, FALSE. Numerical
+   values cannot match any of these, so only call FullForm (which takes
+   a copy of the options list) if the first character could be the start
+   of one of them. */
+         if( *v0 && strchr( "YyNnTtFf", *v0 ) ) {
+            iopt = FullForm( "YES NO TRUE FALSE", v0, 1, status );
+         } else {
+            iopt = -1;
+         }
 
 /* Return the single character "T" or "F" at the start of the value string
    if the value matches one of the above strings. */
-               if( iopt == 0 || iopt == 2 ) {
-                  type = AST__LOGICAL;
-                  strcpy ( v, "T" );
-               } else if( iopt == 1 || iopt == 3 ) {
-                  type = AST__LOGICAL;
-                  strcpy ( v, "F" );
+         if( iopt == 0 || iopt == 2 ) {
+            type = AST__LOGICAL;
+            strcpy ( v, "T" );
+         } else if( iopt == 1 || iopt == 3 ) {
+            type = AST__LOGICAL;
+            strcpy ( v, "F" );
 
 /* If it does not match, see if the value is numerical. */
-               } else {
+         } else {
 
 /* Save the length of the value string excluding trailing blanks. */
-                  len = ChrLen( v, status );
+            len = ChrLen( v, status );
 
 /* If the entire string is blank, the value type is UNDEF. */
-                  if( len == 0 ) {
-                     type = AST__UNDEF;
-
-/* If there are no dots (decimal points) or exponents (D or E) in the value... */
-                  } else if( !strpbrk( v, ".EeDd" ) ){
-
-/* First attempt to read two integers from the string (separated by white
-   space). */
-                     if( nch = 0,
-                         ( 2 == astSscanf( v, " %d %d%n", &ir, &ii, &nch ) ) &&
-                         ( nch >= len ) ) {
-                        type = AST__COMPLEXI;
-
-/* If that failed, attempt to read a single integer from the string. */
-                     } else if( nch = 0,
-                         ( 1 == astSscanf( v, " %d%n", &ir, &nch ) ) &&
-                         ( nch >= len ) ) {
-                        type = AST__INT;
-                     }
-
-/* If there are dots (decimal points) in the value... */
-                  } else {
-
-/* First attempt to read two doubles from the string (separated by white
-   space). */
-                     if( nch = 0,
-                         ( 2 == astSscanf( v, " %lf %lf%n", &fr, &fi, &nch ) ) &&
-                         ( nch >= len ) ) {
-                        type = AST__COMPLEXF;
-
-/* If that failed, attempt to read a single double from the string. */
-                     } else if( nch = 0,
-                         ( 1 == astSscanf( v, " %lf%n", &fr, &nch ) ) &&
-                         ( nch >= len ) ) {
-                        type = AST__FLOAT;
-                     }
-
-/* If both the above failed, it could be because the string contains a
-   "D" exponent (which is probably valid FITS) instead of an "E" exponent.
-   Replace any "D" in the string with "e" and try again. */
-                     if( type == AST__COMMENT && astOK ) {
-
-/* Replace "d" and "D" by "e" (if this doesn't produce a readable floating
-   point value then the value string will not be used, so it is safe to
-   do the replacement in situ). */
-                        for( i = 0; i < len; i++ ) {
-                           if( v[ i ] == 'd' || v[ i ] == 'D' ) v[ i ] = 'e';
-                        }
+            if( len == 0 ) {
+               type = AST__UNDEF;
+
+/* If there are no dots (decimal points) or exponents (D or E) in the
+   value, attempt to read one or two integers from the string (separated
+   by white space). */
+            } else if( !strpbrk( v, ".EeDd" ) ){
+               nval = ReadNumbers( v, len, 1, dval, ival, status );
+               if( nval == 2 ) {
+                  type = AST__COMPLEXI;
+               } else if( nval == 1 ) {
+                  type = AST__INT;
+               }
 
-/* Attempt to read two doubles from the edited string (separated by white
-   space). */
-                        if( nch = 0,
-                          ( 2 == astSscanf( v, " %lf %lf%n", &fr, &fi, &nch ) ) &&
-                          ( nch >= len ) ) {
-                           type = AST__COMPLEXF;
-
-/* If that failed, attempt to read a single double from the edited string. */
-                        } else if( nch = 0,
-                            ( 1 == astSscanf( v, " %lf%n", &fr, &nch ) ) &&
-                            ( nch >= len ) ) {
-                           type = AST__FLOAT;
-                        }
-                     }
+/* If there are dots (decimal points) in the value, attempt to read one
+   or two doubles from the string (separated by white space). */
+            } else {
+               nval = ReadNumbers( v, len, 0, dval, ival, status );
+
+/* If that failed, it could be because the string contains a "D"
+   exponent (which is probably valid FITS) instead of an "E" exponent.
+   Replace any "D" in the string with "e" and try again (if this doesn't
+   produce a readable floating point value then the value string will
+   not be used, so it is safe to do the replacement in situ). */
+               if( nval == 0 ) {
+                  for( i = 0; i < len; i++ ) {
+                     if( v[ i ] == 'd' || v[ i ] == 'D' ) v[ i ] = 'e';
                   }
+                  nval = ReadNumbers( v, len, 0, dval, ival, status );
                }
 
-/* If the value type could not be determined, indicate that a warning
-   should be issued. */
-               if( type == AST__COMMENT && astOK ) {
-                  badval = 1;
-                  (*value)[ 0 ] = 0;
-                  (*comment)[ 0 ] = 0;
-                  d = NULL;
+               if( nval == 2 ) {
+                  type = AST__COMPLEXF;
+               } else if( nval == 1 ) {
+                  type = AST__FLOAT;
                }
             }
+         }
+
+/* If the value type could not be determined, indicate that a warning
+   should be issued. */
+         if( type == AST__COMMENT && astOK ) {
+            badval = 1;
+            value[ 0 ] = 0;
+            comment[ 0 ] = 0;
+            d = NULL;
+         }
+      }
 
 /* Find the number of characters in the comment. Pointer "d" should point to
    the first character following the value string. */
-            if( d ){
-               ncc = nc - (size_t)( d - card );
-            } else {
-               ncc = 0;
-            }
+      if( d ){
+         ncc = nc - (size_t)( d - card );
+      } else {
+         ncc = 0;
+      }
 
 /* Copy the remainder of the card to the returned comment string. */
-            if( astOK && ncc > 0 ){
-               strncpy( c, d, ncc );
-               c[ ncc ] = 0;
+      if( astOK && ncc > 0 ){
+         strncpy( c, d, ncc );
+         c[ ncc ] = 0;
 
 /* Find the start of the comment (indicated by the first "/" after the
    value string). */
-               slash = strchr( c, '/' );
+         slash = strchr( c, '/' );
 
 /* Temporarily terminate the string at the slash. */
-               if( slash ) *slash = 0;
+         if( slash ) *slash = 0;
 
 /* Shuffle the characters following the slash down to the
    start of the returned string. */
-               if( slash ){
-                  ncc -= (size_t)( slash - c ) + 1;
-                  d = slash + 1;
-                  for( i = 0; i < 1 + (int) ncc; i++ ) *(c++) = *(d++);
-               }
+         if( slash ){
+            ncc -= (size_t)( slash - c ) + 1;
+            d = slash + 1;
+            for( i = 0; i < 1 + (int) ncc; i++ ) *(c++) = *(d++);
+         }
 
 /* If there is no comment string, return a null string. */
-            } else {
-               *c = 0;
-            }
-         }
+      } else {
+         *c = 0;
       }
    }
 
-/* Truncate the returned string to avoid wasting space. */
-   if( *name ) *name = (char *) astRealloc( (void *) *name, strlen( *name ) + 1 );
-   if( *comment ) *comment = (char *) astRealloc( (void *) *comment, strlen( *comment ) + 1 );
-   if( *value ) *value = (char *) astRealloc( (void *) *value, strlen( *value ) + 1 );
-
 /* If the value is deemed to be integer, check that the number of digits
    in the formatted value does not exceed the capacity of an int. This may
    be the case if there are too many digits in the integer for an "int" to
-   hold. In this case, change the data type to float. */
-   if( *value && type == AST__INT ) {
+   hold. In this case, change the data type to float, and convert the
+   formatted value again. */
+   if( type == AST__INT ) {
       ndig = 0;
-      c = *value;
+      c = value;
       while( *c ) {
          if( isdigit( *(c++) ) ) ndig++;
       }
-      if( ndig >= int_dig ) type = AST__FLOAT;
+      if( ndig >= int_dig ) {
+         type = AST__FLOAT;
+         dval[ 0 ] = strtod( value, NULL );
+      }
    }
 
-/* If an error occurred, free the returned strings and issue a context message. */
+/* If an error occurred, clear the returned strings and issue a context
+   message. */
    if( !astOK ){
-      *name = (char *) astFree( (void *) *name );
-      *value = (char *) astFree( (void *) *value );
-      *comment = (char *) astFree( (void *) *comment );
+      name[ 0 ] = 0;
+      value[ 0 ] = 0;
+      comment[ 0 ] = 0;
       type = AST__COMMENT;
       astError( astStatus, "%s(%s): Unable to store the following FITS "
                 "header card:\n%.*s\n", status, method, class,
@@ -32293,6 +33407,166 @@ static int SplitMat( int naxis, double *matrix, double *cdelt, int *status ){
    }
    return ok;
 }
+static void StoreCard( AstFitsChan *this, const char *card, int overwrite,
+                       const char *method, const char *class, int *status ){
+/*
+*  Name:
+*     StoreCard
+
+*  Purpose:
+*     Parse a FITS header card and store it in a FitsChan.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     void StoreCard( AstFitsChan *this, const char *card, int overwrite,
+*                     const char *method, const char *class, int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     This function does the work of astPutFits. The supplied card is
+*     parsed once using SplitCard, and the resulting keyword is inserted
+*     directly into the FitsChan using the same rules for comments and
+*     over-writing as the astSetFits<X> methods. It is also used to
+*     store each card when a complete header is ingested (e.g. by
+*     astPutCards or from a source function), and so avoids re-parsing
+*     the keyword name or re-reading the keyword value.
+
+*  Parameters:
+*     this
+*        Pointer to the FitsChan.
+*     card
+*        Pointer to a possibly null-terminated character string
+*        containing the FITS card to be stored. No more than 80
+*        characters will be used from this string.
+*     overwrite
+*        If non-zero the new card replaces the current card. Otherwise
+*        it is inserted in front of the current card.
+*     method
+*        Pointer to a string holding the name of the calling method.
+*        This is only for use in constructing error messages.
+*     class
+*        Pointer to a string holding the name of the supplied object class.
+*        This is only for use in constructing error messages.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     -  This function does not invoke the source function. Callers
+*     should ensure ReadFromSource has been called if required.
+*/
+
+/* Local Variables: */
+   char comment[ AST__FITSCHAN_FITSCARDLEN + 1 ]; /* The keyword comment */
+   char name[ FITSNAMLEN + 1 ];                   /* The keyword name */
+   char value[ AST__FITSCHAN_FITSCARDLEN + 2 ];   /* The keyword value */
+   const char *cname;     /* The existing keyword name */
+   const char *com;       /* The comment to use */
+   double dval[ 2 ];      /* Floating point keyword value(s) */
+   int free_com;          /* Should com be freed before returning? */
+   int ival[ 2 ];         /* Integer keyword value(s) */
+   int lval;              /* Logical keyword value */
+   int type;              /* Keyword data type */
+   size_t size;           /* The size of the old data value */
+   void *data;            /* Pointer to data value to be stored */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Split the supplied card up into name, value and commment strings, and
+   convert any numerical value to binary. The data type associated with
+   the keyword is returned. SplitCard reports its own context message if
+   an error occurs. */
+   type = SplitCard( this, card, name, value, comment, dval, ival, method,
+                     class, status );
+   if( !astOK ) return;
+
+/* Use a NULL pointer in place of a blank comment. */
+   com = ChrLen( comment, status ) ? comment : NULL;
+   free_com = 0;
+
+/* Comment cards. If we are inserting a new card, or over-writing an old
+   card with a different name, store a comment card with the given
+   keyword name and comment, but no data value. If we are overwriting an
+   existing keyword comment, use the data type and value from the existing
+   current card. Note, we have to take a copy of the old data value because
+   InsCard over-writes by deleting the old card and then inserting a new
+   one. */
+   if( type == AST__COMMENT ) {
+      cname = CardName( this, status );
+      if( !overwrite || !cname || strcmp( name, cname ) ){
+         InsCard( this, overwrite, name, AST__COMMENT, NULL, com, method,
+                  class, status );
+      } else {
+         size = 0;
+         data = CardData( this, &size, status );
+         data = astStore( NULL, data, size );
+         InsCard( this, 1, name, CardType( this, status ), data, com,
+                  method, class, status );
+         data = astFree( data );
+      }
+
+/* All other keywords. */
+   } else {
+
+/* If the comment is blank, use the existing comment if we are
+   over-writing. */
+      if( !com && overwrite && CardComm( this, status ) ){
+         com = (const char *) astStore( NULL, (void *) CardComm( this, status ),
+                                        strlen( CardComm( this, status ) ) + 1 );
+         free_com = 1;
+      }
+
+/* Get a pointer to the data value to store. NB, this list is roughly in
+   the order of descreasing frequency of use (i.e. most FITS keywords are
+   simple floating point values, the next most common are strings, etc). */
+      data = NULL;
+      if( type == AST__FLOAT ){
+         data = (void *) dval;
+
+      } else if( type == AST__STRING || type == AST__CONTINUE ){
+         data = (void *) value;
+
+      } else if( type == AST__INT ){
+         data = (void *) ival;
+
+      } else if( type == AST__LOGICAL ){
+         lval = ( *value == 'T' );
+         data = (void *) &lval;
+
+      } else if( type == AST__COMPLEXF ){
+         data = (void *) dval;
+
+      } else if( type == AST__COMPLEXI ){
+         data = (void *) ival;
+
+/* Report an error for any other type. */
+      } else if( type != AST__UNDEF ){
+         astError( AST__INTER, "%s: AST internal programming error - "
+                   "FITS data-type '%d' not yet supported.", status, method, type );
+      }
+
+/* Insert the new card. */
+      if( astOK ) InsCard( this, overwrite, name, type, data, com, method,
+                           class, status );
+
+/* Release the memory holding the stored comment string, so long as it was
+   allocated within this function. */
+      if( free_com ) com = (const char *) astFree( (void *) com );
+   }
+
+/* Give a context message if an error occurred. */
+   if( !astOK ){
+      astError( astStatus, "%s(%s): Unable to store the following FITS "
+                "header card:\n%.*s\n", status, method, class,
+                AST__FITSCHAN_FITSCARDLEN, card );
+   }
+}
+
 static void TableSource( AstFitsChan *this,
                          void (* tabsource)( AstFitsChan *, const char *,
                                              int, int, int * ),
@@ -32378,6 +33652,11 @@ f        the usual inherited status value.
 c        astPutTables or astPutTable
 f        AST_PUTTABLES or AST_PUTTABLE
 *        method, and finally annull its local copy of the FitsTable pointer.
+c        To avoid copying very large tables, the call-back may use
+c        astBorrowColumnData (rather than astPutColumnData) to store
+c        column values that are held in memory that will remain valid
+c        after the call-back returns - for instance a memory-mapped copy
+c        of the FITS file.
 *        If the table cannot be read for any reason, or if any other
 *        error occurs, it should return
 c        zero for the final (third) argument (otherwise any non-zero integer
@@ -33001,6 +34280,27 @@ static double TDBConv( double mjd, int timescale, int fromTDB,
 /* Otherwise, do the conversion. */
    } else {
 
+/* If not yet done, create a pair of MJD TimeFrames which will be used for
+   converting to and from TDB. This is done here rather than in
+   astInitFitsChanVtab so that the cost is only incurred if a conversion
+   is actually needed. The new TimeFrames are locked by the current
+   thread, so unlock them to allow any thread to lock them below. */
+      LOCK_MUTEX4
+      if( !tdbframe ) {
+         astBeginPM;
+         tdbframe = astTimeFrame( "system=MJD,timescale=TDB", status );
+         timeframe = astTimeFrame( "system=MJD", status );
+         astEndPM;
+         if( astOK ) {
+            astManageLock( timeframe, AST__UNLOCK, 1, NULL );
+            astManageLock( tdbframe, AST__UNLOCK, 1, NULL );
+         } else {
+            if( tdbframe ) tdbframe = astAnnul( tdbframe );
+            if( timeframe ) timeframe = astAnnul( timeframe );
+         }
+      }
+      UNLOCK_MUTEX4
+
 /* Lock the timeframes for use by the current thread, waiting if they are
    currently locked by another thread. */
       astManageLock( timeframe, AST__LOCK, 1, NULL );
@@ -33654,6 +34954,68 @@ static AstTimeScaleType TimeSysToAst( AstFitsChan *this, const char *timesys,
    return result;
 }
 
+static void TrimWcsCache( int nmax, int *status ){
+/*
+*  Name:
+*     TrimWcsCache
+
+*  Purpose:
+*     Remove the least recently used entries from the cache of FrameSets.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void TrimWcsCache( int nmax, int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function removes entries from the cache of previously read
+*     FrameSets (see CachedFsetFromStore), starting with the least
+*     recently used entry, until no more than the specified number of
+*     entries remain. The memory used by the cache is freed if no
+*     entries remain.
+
+*  Parameters:
+*     nmax
+*        The maximum number of entries to retain.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - mutex5 should be locked by the caller.
+*     - This function attempts to execute even if an error exists on entry.
+*/
+
+/* Local Variables: */
+   WcsCacheEntry *entry;         /* Pointer to the entry to remove */
+   int i;                        /* Cache entry index */
+
+/* Remove entries until the cache is small enough. */
+   while( wcs_cache_n > nmax && wcs_cache_n > 0 ) {
+
+/* Find the least recently used entry. */
+      entry = wcs_cache;
+      for( i = 1; i < wcs_cache_n; i++ ) {
+         if( wcs_cache[ i ].stamp < entry->stamp ) entry = wcs_cache + i;
+      }
+
+/* Lock the FrameSet for use by this thread, and then annul it. Free the
+   other resources used by the entry, and move the last entry into the
+   vacated slot. */
+      astManageLock( entry->object, AST__LOCK, 1, NULL );
+      entry->object = astAnnul( entry->object );
+      entry->key = astFree( entry->key );
+      FreeReadRecord( &(entry->rec), status );
+      *entry = wcs_cache[ --wcs_cache_n ];
+   }
+
+/* Free the array if it is now empty. */
+   if( wcs_cache_n == 0 ) wcs_cache = astFree( wcs_cache );
+}
+
 static char *UnPreQuote( const char *string, int *status ) {
 /*
 *  Name:
@@ -33964,6 +35326,97 @@ static int Ustrncmp( const char *a, const char *b, size_t n, int *status ){
    return ret;
 }
 
+static void UnindexCard( AstFitsChan *this, FitsCard *card, int *status ){
+/*
+*  Name:
+*     UnindexCard
+
+*  Purpose:
+*     Remove a card from the index of keyword names.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitschan.h"
+*     void UnindexCard( AstFitsChan *this, FitsCard *card, int *status )
+
+*  Class Membership:
+*     FitsChan member function.
+
+*  Description:
+*     This function removes a card from the list of cards with the same
+*     keyword name (see IndexCard). The KeyMap entry for the keyword is
+*     removed if no other cards have the same name.
+
+*  Parameters:
+*     this
+*        Pointer to the FitsChan.
+*     card
+*        Pointer to the card. It should still be linked into the list of
+*        cards held by the FitsChan.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     -  This function attempts to execute even if an error has occurred,
+*     since the card is usually about to be freed and so must not be
+*     left in the index.
+*/
+
+/* Local Variables: */
+   FitsCard *first;           /* First card with the same name */
+   int oldreport;             /* Original reporting state */
+   int oldstatus;             /* Original status value */
+
+/* Check the supplied pointers. */
+   if( !this || !card || !this->keywords ) return;
+
+/* Start a new error reporting context. */
+   oldstatus = astStatus;
+   oldreport = 0;
+   if( !astOK ) {
+      oldreport = astReporting( 0 );
+      astClearStatus;
+   }
+
+/* Get the first card with the same name. */
+   if( astMapGet0P( this->keywords, card->name, (void **) &first ) ) {
+
+/* If this is the only card with the name, remove the KeyMap entry. */
+      if( !card->knext && card == first ) {
+         astMapRemove( this->keywords, card->name );
+
+/* If it is the first of several, the next card becomes the first. It
+   inherits the pointer to the last card. */
+      } else if( card == first ) {
+         card->knext->kprev = card->kprev;
+         astMapPut0P( this->keywords, card->name, card->knext, NULL );
+
+/* If it is the last of several, the previous card becomes the last. */
+      } else if( !card->knext ) {
+         card->kprev->knext = NULL;
+         first->kprev = card->kprev;
+
+/* Otherwise, just link the neighbouring cards together. */
+      } else {
+         card->kprev->knext = card->knext;
+         card->knext->kprev = card->kprev;
+      }
+   }
+
+   card->knext = NULL;
+   card->kprev = NULL;
+
+/* If there was an error status on entry to this function, re-instate it.
+   Otherwise, allow any new error status to remain. */
+   if( oldstatus ){
+      if( !astOK ) astClearStatus;
+      astSetStatus( oldstatus );
+      astReporting( oldreport );
+   }
+}
+
 static void Warn( AstFitsChan *this, const char *condition, const char *text,
                   const char*method, const char *class, int *status ){
 /*
@@ -34009,6 +35462,7 @@ static void Warn( AstFitsChan *this, const char *condition, const char *text,
 */
 
 /* Local Variables: */
+   ReadRecord *rec;      /* Record of the side effects of reading a FrameSet */
    char buff[ AST__FITSCHAN_FITSCARDLEN + 1 ]; /* Buffer for new card text */
    const char *a;        /* Pointer to 1st character in next card */
    const char *b;        /* Pointer to terminating null character */
@@ -34017,8 +35471,33 @@ static void Warn( AstFitsChan *this, const char *condition, const char *text,
    int icard;            /* Index of original card */
    int nc;               /* No. of characters in next card */
 
-/* Check the inherited status, warning text, FitsChan and Clean attribute. */
-   if( !astOK || !text || !text[0] || !this || astGetClean( this ) ) return;
+/* Check the inherited status, warning text and FitsChan. */
+   if( !astOK || !text || !text[0] || !this ) return;
+
+/* If the side effects of creating a FrameSet are being recorded (see
+   CachedFsetFromStore), record the warning and the current card so that
+   the warning can be re-issued if the FrameSet is re-used. */
+   if( this->readrec ) {
+      rec = (ReadRecord *) this->readrec;
+      rec->wcard = astGrow( rec->wcard, rec->nwarn + 1, sizeof( int ) );
+      rec->wtext = astGrow( rec->wtext, 4*( rec->nwarn + 1 ),
+                            sizeof( char * ) );
+      if( astOK ) {
+         rec->wcard[ rec->nwarn ] = astGetCard( this );
+         rec->wtext[ 4*rec->nwarn ] = astStore( NULL, condition,
+                                                strlen( condition ) + 1 );
+         rec->wtext[ 4*rec->nwarn + 1 ] = astStore( NULL, text,
+                                                    strlen( text ) + 1 );
+         rec->wtext[ 4*rec->nwarn + 2 ] = astStore( NULL, method,
+                                                    strlen( method ) + 1 );
+         rec->wtext[ 4*rec->nwarn + 3 ] = astStore( NULL, class,
+                                                    strlen( class ) + 1 );
+         rec->nwarn++;
+      }
+   }
+
+/* Check the Clean attribute. */
+   if( astGetClean( this ) ) return;
 
 /* Ignore the warning if the supplied condition is not contained within
    the list of conditions to be reported in this way (given by the
@@ -34391,6 +35870,177 @@ static int WATCoeffs( const char *watstr, int iaxis, double **cvals,
    return result;
 }
 
+static char *WcsCacheKey( AstFitsChan *this, FitsStore *store,
+                          size_t *keylen, int *status ){
+/*
+*  Name:
+*     WcsCacheKey
+
+*  Purpose:
+*     Create a key describing the information used to create a FrameSet
+*     from a FitsStore.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     char *WcsCacheKey( AstFitsChan *this, FitsStore *store,
+*                        size_t *keylen, int *status )
+
+*  Class Membership:
+*     FitsChan
+
+*  Description:
+*     This function returns an array of bytes that describes everything
+*     used by FsetFromStore when creating a FrameSet from the supplied
+*     FitsStore. This includes the contents of the FitsStore, the FitsChan
+*     attributes that affect the FrameSet, and the keywords (NAXISi,
+*     RFVALi, AXREFi and WATi_nnn) that FsetFromStore reads directly from
+*     the FitsChan rather than from the FitsStore. Two FitsStores with the
+*     same key will produce identical FrameSets. The key is used to
+*     identify entries in the cache of previously read FrameSets (see
+*     CachedFsetFromStore).
+
+*  Parameters:
+*     this
+*        Pointer to the FitsChan.
+*     store
+*        Pointer to the FitsStore.
+*     keylen
+*        Pointer to a location at which to return the number of bytes
+*        in the key.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a dynamically allocated array holding the key. It
+*     should be freed using astFree when no longer needed. NULL is
+*     returned if the FrameSet should not be cached (i.e. if it uses
+*     the -TAB algorithm), or if an error occurs.
+*/
+
+/* Local Variables: */
+   FitsCard *card;       /* Pointer to next card */
+   const char *fao;      /* FitsAxisOrder attribute value */
+   char *key;            /* Returned key */
+   double fitstol;       /* FitsTol attribute value */
+   int att[ 11 ];        /* Integer attribute values */
+   int i;                /* Intermediate axis index */
+   int ni;               /* Number of intermediate axes */
+   int nsi;              /* Number of co-ordinate versions */
+   int si;               /* Co-ordinate version index */
+
+/* Initialise */
+   key = NULL;
+   *keylen = 0;
+
+/* Check the inherited status. */
+   if( !astOK ) return key;
+
+/* FrameSets that use binary tables are not cached. */
+   if( store->tables && astMapSize( store->tables ) > 0 ) return key;
+   if( store->ctype ) {
+      nsi = astSizeOf( (void *) store->ctype )/sizeof( char *** );
+      for( si = 0; si < nsi; si++ ) {
+         if( !store->ctype[ si ] ) continue;
+         ni = astSizeOf( (void *) store->ctype[ si ] )/sizeof( char ** );
+         for( i = 0; i < ni; i++ ) {
+            if( store->ctype[ si ][ i ] && store->ctype[ si ][ i ][ 0 ] &&
+                strstr( store->ctype[ si ][ i ][ 0 ], "-TAB" ) ) return key;
+         }
+      }
+   }
+
+/* Describe the FitsChan attributes used by FsetFromStore. */
+   att[ 0 ] = astGetEncoding( this );
+   att[ 1 ] = astGetDefB1950( this );
+   att[ 2 ] = astGetCarLin( this );
+   att[ 3 ] = astGetCDMatrix( this );
+   att[ 4 ] = astGetForceTab( this );
+   att[ 5 ] = astGetIwc( this );
+   att[ 6 ] = astGetPolyTan( this );
+   att[ 7 ] = astGetSipOK( this );
+   att[ 8 ] = astGetSipReplace( this );
+   att[ 9 ] = astGetTabOK( this );
+   att[ 10 ] = astGetAltAxes( this );
+   fitstol = astGetFitsTol( this );
+   fao = astGetFitsAxisOrder( this );
+   key = KeyBytes( key, keylen, att, sizeof( att ), status );
+   key = KeyBytes( key, keylen, &fitstol, sizeof( fitstol ), status );
+   if( fao ) key = KeyBytes( key, keylen, fao, strlen( fao ) + 1, status );
+
+/* Describe the contents of the FitsStore. Each item is identified by a
+   different integer. */
+   key = KeyBytes( key, keylen, &(store->naxis), sizeof( int ), status );
+   key = KeyItemC( key, keylen, 1, store->cname, status );
+   key = KeyItemC( key, keylen, 2, store->ctype, status );
+   key = KeyItemC( key, keylen, 3, store->ctype_com, status );
+   key = KeyItemC( key, keylen, 4, store->cunit, status );
+   key = KeyItemC( key, keylen, 5, store->radesys, status );
+   key = KeyItemC( key, keylen, 6, store->wcsname, status );
+   key = KeyItemC( key, keylen, 7, store->specsys, status );
+   key = KeyItemC( key, keylen, 8, store->ssyssrc, status );
+   key = KeyItemC( key, keylen, 9, store->ps, status );
+   key = KeyItemC( key, keylen, 10, store->timesys, status );
+   key = KeyItemC( key, keylen, 11, store->skyrefis, status );
+   key = KeyItem( key, keylen, 12, store->pc, status );
+   key = KeyItem( key, keylen, 13, store->cdelt, status );
+   key = KeyItem( key, keylen, 14, store->crpix, status );
+   key = KeyItem( key, keylen, 15, store->crval, status );
+   key = KeyItem( key, keylen, 16, store->equinox, status );
+   key = KeyItem( key, keylen, 17, store->latpole, status );
+   key = KeyItem( key, keylen, 18, store->lonpole, status );
+   key = KeyItem( key, keylen, 19, store->mjdobs, status );
+   key = KeyItem( key, keylen, 20, store->dtai, status );
+   key = KeyItem( key, keylen, 21, store->dut1, status );
+   key = KeyItem( key, keylen, 22, store->mjdavg, status );
+   key = KeyItem( key, keylen, 23, store->pv, status );
+   key = KeyItem( key, keylen, 24, store->wcsaxes, status );
+   key = KeyItem( key, keylen, 25, store->obsgeox, status );
+   key = KeyItem( key, keylen, 26, store->obsgeoy, status );
+   key = KeyItem( key, keylen, 27, store->obsgeoz, status );
+   key = KeyItem( key, keylen, 28, store->restfrq, status );
+   key = KeyItem( key, keylen, 29, store->restwav, status );
+   key = KeyItem( key, keylen, 30, store->zsource, status );
+   key = KeyItem( key, keylen, 31, store->velosys, status );
+   key = KeyItem( key, keylen, 32, store->asip, status );
+   key = KeyItem( key, keylen, 33, store->bsip, status );
+   key = KeyItem( key, keylen, 34, store->apsip, status );
+   key = KeyItem( key, keylen, 35, store->bpsip, status );
+   key = KeyItem( key, keylen, 36, store->imagfreq, status );
+   key = KeyItem( key, keylen, 37, store->axref, status );
+   key = KeyItem( key, keylen, 38, store->skyref, status );
+   key = KeyItem( key, keylen, 39, store->skyrefp, status );
+
+/* Describe the cards that are read directly from the FitsChan by
+   FsetFromStore, including their used flags. */
+   card = (FitsCard *) this->head;
+   while( card && astOK ) {
+      if( !strncmp( card->name, "NAXIS", 5 ) ||
+          !strncmp( card->name, "RFVAL", 5 ) ||
+          !strncmp( card->name, "AXREF", 5 ) ||
+          !strncmp( card->name, "WAT", 3 ) ) {
+         key = KeyBytes( key, keylen, card->name, strlen( card->name ) + 1,
+                         status );
+         key = KeyBytes( key, keylen, &(card->type), sizeof( int ), status );
+         key = KeyBytes( key, keylen, &(card->flags), sizeof( int ), status );
+         if( card->data ) key = KeyBytes( key, keylen, card->data,
+                                          card->size, status );
+      }
+      card = card->next;
+      if( card == (FitsCard *) this->head ) card = NULL;
+   }
+
+/* Free the key if an error occurred. */
+   if( !astOK ) {
+      key = astFree( key );
+      *keylen = 0;
+   }
+
+/* Return the key. */
+   return key;
+}
+
 static AstMatrixMap *WcsCDeltMatrix( FitsStore *store, char s, int naxes,
                                      const char *method, const char *class, int *status ){
 /*
@@ -42431,6 +44081,7 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->head = NULL;
    out->keyseq = NULL;
    out->keywords = NULL;
+   out->readrec = NULL;
    out->source = NULL;
    out->saved_source = NULL;
    out->source_wrap = NULL;
@@ -43528,6 +45179,7 @@ AstFitsChan *astInitFitsChan_( void *mem, size_t size, int init,
       new->card = NULL;
       new->keyseq = NULL;
       new->keywords = NULL;
+      new->readrec = NULL;
       new->defb1950 = -1;
       new->tabok = -INT_MAX;
       new->forcetab = -INT_MAX;
@@ -43702,6 +45354,10 @@ AstFitsChan *astLoadFitsChan_( void *mem, size_t size,
 /* Initialise the KeyMap holding the keywords in the FitsChan. */
       new->keywords = NULL;
 
+/* Initialise the pointer used to record the side effects of reading a
+   FrameSet. */
+      new->readrec = NULL;
+
 /* Initialise the list of keyword sequence numbers. */
       new->keyseq = NULL;
 
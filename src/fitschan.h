@@ -192,6 +192,7 @@ typedef struct AstFitsChan {
    char *warnings;  /* Pointer to a string containing warning conditions */
    void *card;      /* Pointer to next FitsCard to be read */
    void *head;      /* Pointer to first FitsCard in the circular linked list */
+   void *readrec;   /* Records the side effects of reading a FrameSet */
    AstKeyMap *keyseq;   /* List of keyword sequence numbers used */
    AstKeyMap *keywords; /* A KeyMap holding the keywords in the FitsChan */
    AstKeyMap *tables;   /* A KeyMap holding the binary tables in the FitsChan */
@@ -622,6 +623,8 @@ void astInitFitsChanGlobals_( AstFitsChanGlobals * );
    void astSetEncoding_( AstFitsChan *, int, int * );
    void astClearEncoding_( AstFitsChan *, int * );
 
+   int astFitsWcsCache_( int, int * );
+
 #endif
 
 /* Function interfaces. */
@@ -983,6 +986,8 @@ astINVOKE(V,astSetIwc_(astCheckFitsChan(this),iwc,STATUS_PTR))
 #define astTestIwc(this) \
 astINVOKE(V,astTestIwc_(astCheckFitsChan(this),STATUS_PTR))
 
+#define astFitsWcsCache(value) astFitsWcsCache_(value,STATUS_PTR)
+
 #endif
 
 #endif
@@ -41,6 +41,7 @@ c     following functions may also be applied to all FitsTables:
 f     In addition to those routines applicable to all Tables, the
 f     following routines may also be applied to all FitsTables:
 *
+c     - astBorrowColumnData: Use a supplied array as the data in a column
 c     - astColumnNull: Get/set the null value for a column of a FitsTable
 c     - astColumnSize: Get number of bytes needed to hold a full column of data
 c     - astGetColumnData: Retrieve all the data values stored in a column
@@ -76,6 +77,7 @@ f     - AST_PUTTABLEHEADER: Store FITS headers within a FitsTable
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     25-NOV-2010 (DSB):
@@ -84,6 +86,13 @@ f     - AST_PUTTABLEHEADER: Store FITS headers within a FitsTable
 *        Check for Infs as well as NaNs.
 *     24-OCT-2019 (DSB):
 *        Correct docs for astColumnSize.
+*     18-OCT-2026 (AGT):
+*        - Use astGetColumnCells and astPutColumnCells to transfer whole
+*        numerical columns to and from the columnar storage used by the
+*        parent Table class.
+*        - Fix check for NaN values in astPutColumnData for single
+*        precision columns.
+*        - Added astBorrowColumnData.
 *class--
 */
 
@@ -190,6 +199,8 @@ static void GenerateColumns( AstFitsTable *, AstFitsChan *, int * );
 static void GetColumnData( AstFitsTable *, const char *, float, double, size_t, void *, int *, int * );
 static void PurgeHeader( AstFitsTable *, int * );
 static void PutColumnData( AstFitsTable *, const char *, int, size_t, void *, int * );
+static void BorrowColumnData( AstFitsTable *, const char *, size_t, const void *, int * );
+static void StoreColumnData( AstFitsTable *, const char *, int, size_t, void *, int, const char *, int * );
 static void PutTableHeader( AstFitsTable *, AstFitsChan *, int * );
 static void UpdateHeader( AstFitsTable *, const char *, int * );
 
@@ -296,6 +307,83 @@ static void AddColumn( AstTable *this, const char *name, int type,
    }
 }
 
+static void BorrowColumnData( AstFitsTable *this, const char *column,
+                              size_t size, const void *coldata, int *status ){
+/*
+*++
+*  Name:
+c     astBorrowColumnData
+
+*  Purpose:
+*     Use a supplied array as the data values for all rows of a column.
+
+*  Type:
+*     Public virtual function.
+
+*  Synopsis:
+c     #include "fitstable.h"
+c     void astBorrowColumnData( AstFitsTable *this, const char *column,
+c                               size_t size, const void *coldata )
+
+*  Class Membership:
+*     FitsTable method.
+
+*  Description:
+*     This function is like
+c     astPutColumnData,
+*     except that the FitsTable uses the supplied array directly, rather
+*     than taking a copy of it. This avoids copying very large columns
+*     - for instance a "-TAB" look-up table supplied by a table source
+*     function (see
+c     astTableSource)
+*     from a memory-mapped FITS file.
+*
+*     The supplied array is shared by any copies of the FitsTable
+*     (including those stored in a FitsChan by
+c     astPutTable),
+*     and by any LutMaps created from the column when a FitsChan reads
+*     a FrameSet that uses the "-TAB" algorithm. The array is never
+*     modified by AST - if any cell in the column is subsequently
+*     changed, the FitsTable first takes a private copy of the whole
+*     column.
+
+*  Parameters:
+c     this
+*        Pointer to the FitsTable.
+c     column
+*        The character string holding the name of the column. Trailing
+*        spaces are ignored. The column must not hold character strings.
+c     size
+*        The size of the
+c        "coldata"
+*        array, in bytes. This should be an integer multiple of the
+*        number of bytes needed to hold the full vector value stored in a
+*        single cell of the column. An error is reported if this is not
+*        the case.
+c     coldata
+c        A pointer to an
+*        area of memory holding the data values for the column. The values
+*        should be stored in row order, in the native byte order and data
+*        type of the column. If the column holds non-scalar values, the
+*        elements of each value should be stored in "Fortran" order.
+
+*  Notes:
+*     - The caller must ensure that the supplied array is not changed or
+*     freed until the FitsTable, and all copies of it and all Objects
+*     derived from it (such as FrameSets read from a FitsChan holding
+*     the FitsTable), have been deleted.
+*     - The values are copied, as if
+c     astPutColumnData
+*     had been used, if the FitsTable is locked (see attribute MapLocked).
+*     - This function is available only in the C interface.
+*--
+*/
+
+/* Store the values, borrowing the supplied array. */
+   StoreColumnData( this, column, 0, size, (void *) coldata, 1,
+                    "astBorrowColumnData", status );
+}
+
 static int ColumnNull( AstFitsTable *this, const char *column, int set,
                        int newval, int *wasset, int *hasnull, int *status ){
 /*
@@ -1228,12 +1316,14 @@ f     AST_COLUMNNULL functiom.
 /* Local Variables: */
    char *cbuf;       /* Array of strings returned by astMapGet1C */
    char key[ AST__MXCOLKEYLEN + 1 ]; /* Current cell key string */
+   int cached;       /* Was the value copied from columnar storage? */
    int iel;          /* Index of current element */
    int irow;         /* Index of value being copied */
    int nel;          /* No. of elements per value */
    int nrow;         /* No. of values to copy */
    int nval;         /* Number of values read from KeyMap entry */
    int ok;           /* Was the value found in the KeyMap? */
+   unsigned char *found; /* Flags indicating values copied from storage */
    int type;         /* Data type */
    int wasset;       /* Was the integer null value set explicitly? */
    size_t nb;        /* No. of bytes for a single element of a value */
@@ -1310,21 +1400,33 @@ f     AST_COLUMNNULL functiom.
    small to hold all rows. */
    if( mxsize < nbv*nrow ) nrow = mxsize/nbv;
 
+/* For numerical columns, copy all the cell values held in the columnar
+   storage of the parent Table directly into the returned array, noting
+   which cells were found. Any other cells are obtained individually
+   below. */
+   found = NULL;
+   if( type != AST__STRINGTYPE && nrow > 0 ) {
+      found = astMalloc( nrow*sizeof( *found ) );
+      if( astOK ) (void) astGetColumnCells( this, column, nrow, coldata,
+                                            found );
+   }
+
 /* Loop round the returned rows rows. */
    for( irow = 1; irow <= nrow; irow++ ) {
 
-/* Format the cell name. */
-      (void) MakeKey( column, irow, key, AST__MXCOLKEYLEN + 1,
-                      status );
+/* Format the cell name, unless the cell value has already been obtained. */
+      cached = ( found && found[ irow - 1 ] );
+      if( !cached ) (void) MakeKey( column, irow, key, AST__MXCOLKEYLEN + 1,
+                                    status );
 
 /* Get the values in the current cell of the column, using its native
    data type. For floating point, convert any NaNs into the appropriate
    null value (do not need to do this if the null value is itself NaN). */
       if( type == AST__INTTYPE ) {
-         ok = astMapGet1I( this, key, nel, &nval, pout );
+         ok = cached || astMapGet1I( this, key, nel, &nval, pout );
 
       } else if(  type == AST__DOUBLETYPE ){
-         ok = astMapGet1D( this, key, nel, &nval, pout );
+         ok = cached || astMapGet1D( this, key, nel, &nval, pout );
 
          if( ok && astISFINITE(dnull) ) {
             for( iel = 0; iel < nel; iel++ ) {
@@ -1335,7 +1437,7 @@ f     AST_COLUMNNULL functiom.
          }
 
       } else if(  type == AST__FLOATTYPE ){
-         ok = astMapGet1F( this, key, nel, &nval, pout );
+         ok = cached || astMapGet1F( this, key, nel, &nval, pout );
 
          if( ok && astISFINITE(fnull) ) {
             for( iel = 0; iel < nel; iel++ ) {
@@ -1346,10 +1448,10 @@ f     AST_COLUMNNULL functiom.
          }
 
       } else if(  type == AST__SINTTYPE ){
-         ok = astMapGet1S( this, key, nel, &nval, pout );
+         ok = cached || astMapGet1S( this, key, nel, &nval, pout );
 
       } else if(  type == AST__BYTETYPE ){
-         ok = astMapGet1B( this, key, nel, &nval, pout );
+         ok = cached || astMapGet1B( this, key, nel, &nval, pout );
 
       } else if(  type == AST__STRINGTYPE ){
          ok = astMapGet1C( this, key, nb + 1, nel, &nval, cbuf );
@@ -1412,6 +1514,7 @@ f     AST_COLUMNNULL functiom.
 /* Free resources. */
    cbuf = astFree( cbuf );
    pnull = astFree( pnull );
+   found = astFree( found );
 
 /* Return the number of returned elements. */
    *nelem = nel*nrow;
@@ -1614,6 +1717,7 @@ void astInitFitsTableVtab_(  AstFitsTableVtab *vtab, const char *name, int *stat
    vtab->ColumnSize = ColumnSize;
    vtab->GetColumnData = GetColumnData;
    vtab->PutColumnData = PutColumnData;
+   vtab->BorrowColumnData = BorrowColumnData;
 
 /* Save the inherited pointers to methods that will be extended, and
    replace them with pointers to the new member functions. */
@@ -1942,9 +2046,131 @@ f        The global status.
 *--
 */
 
+/* Store the values, taking a copy of them. */
+   StoreColumnData( this, column, clen, size, coldata, 0, "astPutColumnData",
+                    status );
+}
+
+static void PutTableHeader( AstFitsTable *this, AstFitsChan *header,
+                            int *status ) {
+/*
+*++
+*  Name:
+c     astPutTableHeader
+f     AST_PUTTABLEHEADER
+
+*  Purpose:
+*     Store new FITS headers in a FitsTable.
+
+*  Type:
+*     Public virtual function.
+
+*  Synopsis:
+c     #include "frameset.h"
+c     void astPutTableHeader( AstFitsTable *this, AstFitsChan *header )
+f     CALL AST_PUTTABLEHEADER( THIS, HEADER, STATUS )
+
+*  Class Membership:
+*     FitsTable method.
+
+*  Description:
+c     This function
+f     This routine
+*     stores new FITS headers in the supplied FitsTable. Any existing
+*     headers are first deleted.
+
+*  Parameters:
+c     this
+f     THIS = INTEGER (Given)
+*        Pointer to the FitsTable.
+c     header
+f     HEADER = INTEGER (Given)
+*        Pointer to a FitsChan holding the headers for the FitsTable.
+*        A deep copy of the supplied FitsChan is stored in the FitsTable,
+*        replacing the current FitsChan in the Fitstable. Keywords that
+*        are fixed either by the properties of the Table, or by the FITS
+*        standard, are removed from the copy (see "Notes:" below).
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
+
+*  Notes:
+*     - The attributes of the supplied FitsChan, together with any source
+*     and sink functions associated with the FitsChan, are copied to the
+*     FitsTable.
+*     - Values for the following keywords are generated automatically by
+*     the FitsTable (any values for these keywords in the supplied
+*     FitsChan will be ignored): "XTENSION", "BITPIX", "NAXIS", "NAXIS1",
+*     "NAXIS2", "PCOUNT", "GCOUNT", "TFIELDS", "TFORM%d", "TTYPE%d",
+*     "TNULL%d", "THEAP", "TDIM%d".
+
+*--
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Annul the existing FitsChan. */
+   (void) astAnnul( this->header );
+
+/* Store a deep copy of the supplied FitsChan in the FitsTable. */
+   this->header = astCopy( header );
+
+/* Remove headers that have fixed values. */
+   PurgeHeader( this, status );
+}
+
+static void StoreColumnData( AstFitsTable *this, const char *column,
+                             int clen, size_t size, void *coldata,
+                             int borrow, const char *method, int *status ){
+/*
+*  Name:
+*     StoreColumnData
+
+*  Purpose:
+*     Store new data values for all rows of a column.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "fitstable.h"
+*     void StoreColumnData( AstFitsTable *this, const char *column,
+*                           int clen, size_t size, void *coldata,
+*                           int borrow, const char *method, int *status )
+
+*  Class Membership:
+*     FitsTable member function
+
+*  Description:
+*     This function implements the astPutColumnData and
+*     astBorrowColumnData methods.
+
+*  Parameters:
+*     this
+*        Pointer to the FitsTable.
+*     column
+*        The name of the column.
+*     clen
+*        The length of each fixed length string in the supplied array.
+*        Ignored if the column does not hold character data.
+*     size
+*        The size of the "coldata" array, in bytes.
+*     coldata
+*        Pointer to the data values.
+*     borrow
+*        If non-zero, the FitsTable uses the supplied array directly
+*        rather than a copy of it, if possible (see astBorrowColumnData).
+*     method
+*        The name of the calling method, for use in error messages.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
 /* Local Variables: */
    char key[ AST__MXCOLKEYLEN + 1 ]; /* Current cell key string */
    char **carray;    /* Pointer to array of null terminated string pointers */
+   int done;         /* Were all values stored at once? */
    int irow;         /* Index of value being copied */
    int iel;          /* Index of current element */
    int nel;          /* No. of elements per value */
@@ -1952,6 +2178,7 @@ f        The global status.
    int type;         /* Data type */
    size_t nb;        /* No. of bytes for a single element of a value */
    size_t nbv;       /* No. of bytes per value */
+   unsigned char *skip; /* Flags indicating values that are entirely NaN */
    void *pin;        /* Pointer to next input array element */
 
 /* Check the global error status. */
@@ -1971,6 +2198,11 @@ f        The global status.
 
    } else if(  type == AST__STRINGTYPE ){
       nb = clen*sizeof( char );
+      if( borrow && astOK ) {
+         astError( AST__BADTYP, "%s(%s): Column '%s' holds character "
+                   "strings, which cannot be borrowed.", status, method,
+                   astGetClass( this ), column );
+      }
 
    } else if(  type == AST__FLOATTYPE ){
       nb = sizeof( float );
@@ -1982,9 +2214,9 @@ f        The global status.
       nb = sizeof( char );
 
    } else if( astOK ) {
-      astError( AST__INTER, "astPutColumnData(%s): Unsupported column type "
+      astError( AST__INTER, "%s(%s): Unsupported column type "
                 "%d (internal AST programming error).", status,
-                astGetClass( this ), type );
+                method, astGetClass( this ), type );
    }
 
 /* Get the number of elements per value, and the number of bytes (in the
@@ -2004,14 +2236,40 @@ f        The global status.
 /* Report an error if the supplied array does not hold an exact number of
    column cells. */
    if( nrow*nbv != size && astOK ) {
-      astError( AST__BADSIZ, "astPutColumnData(%s): The supplied array size "
+      astError( AST__BADSIZ, "%s(%s): The supplied array size "
                 "(%d bytes) is not an exact multiple of the size of one "
-                "column value (%d bytes).", status, astGetClass( this ),
-                (int) size, (int) nbv );
+                "column value (%d bytes).", status, method,
+                astGetClass( this ), (int) size, (int) nbv );
    }
 
-/* Loop round the rows to be copied. */
-   for( irow = 1; irow <= nrow; irow++ ) {
+/* For numerical columns, attempt to store all the values at once in the
+   columnar storage used by the parent Table, borrowing the supplied array
+   if required. Floating point values that are entirely NaN are skipped,
+   as below. */
+   done = 0;
+   if( type != AST__STRINGTYPE && nrow > 0 && astOK ) {
+      skip = NULL;
+      if( type == AST__DOUBLETYPE || type == AST__FLOATTYPE ) {
+         skip = astMalloc( nrow*sizeof( *skip ) );
+         for( irow = 0; irow < nrow && astOK; irow++ ) {
+            skip[ irow ] = 1;
+            for( iel = 0; iel < nel; iel++ ) {
+               if( type == AST__DOUBLETYPE ?
+                   astISFINITE( ((double *)coldata)[ irow*nel + iel ] ) :
+                   astISFINITE( ((float *)coldata)[ irow*nel + iel ] ) ) {
+                  skip[ irow ] = 0;
+                  break;
+               }
+            }
+         }
+      }
+      if( astOK ) done = astPutColumnCells( this, column, nrow, coldata,
+                                            skip, borrow );
+      skip = astFree( skip );
+   }
+
+/* Otherwise, loop round the rows to be copied. */
+   for( irow = done ? nrow + 1 : 1; irow <= nrow; irow++ ) {
 
 /* Format the cell name. */
       (void) MakeKey( column, irow, key, AST__MXCOLKEYLEN + 1,
@@ -2032,7 +2290,7 @@ f        The global status.
 
       } else if(  type == AST__FLOATTYPE ){
          for( iel = 0; iel < nel; iel++ ) {
-            if( astISFINITE( ((double *)pin)[ iel ] ) ) {
+            if( astISFINITE( ((float *)pin)[ iel ] ) ) {
                astMapPut1F( this, key, nel, pin, NULL );
                break;
             }
@@ -2066,74 +2324,6 @@ f        The global status.
    }
 }
 
-static void PutTableHeader( AstFitsTable *this, AstFitsChan *header,
-                            int *status ) {
-/*
-*++
-*  Name:
-c     astPutTableHeader
-f     AST_PUTTABLEHEADER
-
-*  Purpose:
-*     Store new FITS headers in a FitsTable.
-
-*  Type:
-*     Public virtual function.
-
-*  Synopsis:
-c     #include "frameset.h"
-c     void astPutTableHeader( AstFitsTable *this, AstFitsChan *header )
-f     CALL AST_PUTTABLEHEADER( THIS, HEADER, STATUS )
-
-*  Class Membership:
-*     FitsTable method.
-
-*  Description:
-c     This function
-f     This routine
-*     stores new FITS headers in the supplied FitsTable. Any existing
-*     headers are first deleted.
-
-*  Parameters:
-c     this
-f     THIS = INTEGER (Given)
-*        Pointer to the FitsTable.
-c     header
-f     HEADER = INTEGER (Given)
-*        Pointer to a FitsChan holding the headers for the FitsTable.
-*        A deep copy of the supplied FitsChan is stored in the FitsTable,
-*        replacing the current FitsChan in the Fitstable. Keywords that
-*        are fixed either by the properties of the Table, or by the FITS
-*        standard, are removed from the copy (see "Notes:" below).
-f     STATUS = INTEGER (Given and Returned)
-f        The global status.
-
-*  Notes:
-*     - The attributes of the supplied FitsChan, together with any source
-*     and sink functions associated with the FitsChan, are copied to the
-*     FitsTable.
-*     - Values for the following keywords are generated automatically by
-*     the FitsTable (any values for these keywords in the supplied
-*     FitsChan will be ignored): "XTENSION", "BITPIX", "NAXIS", "NAXIS1",
-*     "NAXIS2", "PCOUNT", "GCOUNT", "TFIELDS", "TFORM%d", "TTYPE%d",
-*     "TNULL%d", "THEAP", "TDIM%d".
-
-*--
-*/
-
-/* Check the global error status. */
-   if ( !astOK ) return;
-
-/* Annul the existing FitsChan. */
-   (void) astAnnul( this->header );
-
-/* Store a deep copy of the supplied FitsChan in the FitsTable. */
-   this->header = astCopy( header );
-
-/* Remove headers that have fixed values. */
-   PurgeHeader( this, status );
-}
-
 static void UpdateHeader( AstFitsTable *this, const char *method,
                           int *status ) {
 /*
@@ -2998,6 +3188,11 @@ void astPutColumnData_( AstFitsTable *this, const char *column, int clen,
    if ( !astOK ) return;
    (**astMEMBER(this,FitsTable,PutColumnData))(this,column,clen,size,coldata,status);
 }
+void astBorrowColumnData_( AstFitsTable *this, const char *column,
+                           size_t size, const void *coldata, int *status ){
+   if ( !astOK ) return;
+   (**astMEMBER(this,FitsTable,BorrowColumnData))(this,column,size,coldata,status);
+}
 
 
 
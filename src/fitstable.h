@@ -44,10 +44,13 @@
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     25-NOV-2010 (DSB):
 *        Original version.
+*     18-OCT-2026 (AGT):
+*        Added astBorrowColumnData.
 *-
 */
 
@@ -111,6 +114,7 @@ typedef struct AstFitsTableVtab {
    size_t (* ColumnSize)( AstFitsTable *, const char *, int * );
    void (* GetColumnData)( AstFitsTable *, const char *, float, double, size_t, void *, int *, int * );
    void (* PutColumnData)( AstFitsTable *, const char *, int, size_t, void *, int * );
+   void (* BorrowColumnData)( AstFitsTable *, const char *, size_t, const void *, int * );
 
 } AstFitsTableVtab;
 
@@ -169,6 +173,7 @@ int astColumnNull_( AstFitsTable *, const char *, int, int, int *, int *, int *
 size_t astColumnSize_( AstFitsTable *, const char *, int * );
 void astGetColumnData_( AstFitsTable *, const char *, float, double, size_t, void *, int *, int * );
 void astPutColumnData_( AstFitsTable *, const char *, int, size_t, void *, int * );
+void astBorrowColumnData_( AstFitsTable *, const char *, size_t, const void *, int * );
 
 /* Function interfaces. */
 /* ==================== */
@@ -228,6 +233,8 @@ astINVOKE(V,astColumnSize_(astCheckFitsTable(this),column,STATUS_PTR))
 astINVOKE(V,astGetColumnData_(astCheckFitsTable(this),column,fnull,dnull,mxsize,coldata,nelem,STATUS_PTR))
 #define astPutColumnData(this,column,clen,size,coldata) \
 astINVOKE(V,astPutColumnData_(astCheckFitsTable(this),column,clen,size,coldata,STATUS_PTR))
+#define astBorrowColumnData(this,column,size,coldata) \
+astINVOKE(V,astBorrowColumnData_(astCheckFitsTable(this),column,size,coldata,STATUS_PTR))
 
 #if defined(astCLASS)            /* Protected */
 #endif
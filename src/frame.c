@@ -141,6 +141,7 @@ f     - AST_UNFORMAT: Read a formatted coordinate value for a Frame axis
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: B.S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     1-MAR-1996 (RFWS):
@@ -299,6 +300,13 @@ f     - AST_UNFORMAT: Read a formatted coordinate value for a Frame axis
 *         the crossing.
 *     25-OCT-2021 (DSB):
 *        Added astNormPoints method.
+*     18-OCT-2026 (AGT):
+*        - Report an error if astPermAxes is used on a frozen Frame.
+*        - astConvert, astFindFrame, astMatchAxes, astFormat, astUnformat,
+*        astGap and astCentre make temporary changes to the Frame, so use
+*        astFrozenLock to serialise them when used with frozen Frames.
+*        - Calls to astConvert are recorded when profiling is enabled (see
+*        the Profile tuning parameter).
 *class--
 */
 
@@ -2919,6 +2927,7 @@ f        accepted. Otherwise, the next DOMAINLIST field is considered
 *        FrameSets will be modified on exit to identify the Frames
 *        used to access the intermediate coordinate system which was
 *        finally accepted.
+c        This is not done for frozen FrameSets (see astFreeze).
 *
 *        Note that it is possible to force a particular Frame within a
 *        FrameSet to be used as the basis for the intermediate
@@ -3938,7 +3947,9 @@ f        is unspecified, so AST_FINDFRAME will return the first one
 c        found as part of the "result" FrameSet. If the target is
 f        found as part of the RESULT FrameSet. If the target is
 *        a FrameSet, then its Current attribute will be updated to
-*        identify the Frame that was used.
+c        identify the Frame that was used (unless the FrameSet is
+c        frozen - see astFreeze).
+f        identify the Frame that was used.
 *
 *        If no celestial coordinate system can be found, a value of
 *        AST__NULL will be returned without error.
@@ -15393,8 +15404,18 @@ int astLineContains_( AstFrame *this, AstLineDef *l, int def, double *point, int
 }
 AstFrameSet *astConvert_( AstFrame *from, AstFrame *to,
                           const char *domainlist, int *status ) {
+   AstFrameSet *result;
+   AstProfileCall call;
+   int locked1, locked2;
    if ( !astOK ) return NULL;
-   return (**astMEMBER(from,Frame,Convert))( from, to, domainlist, status );
+   astProfileStart( &call, "Convert", from, 0.0 );
+   locked1 = astFrozenLock( from );
+   locked2 = astFrozenLock( to );
+   result = (**astMEMBER(from,Frame,Convert))( from, to, domainlist, status );
+   astFrozenUnlock( locked2 );
+   astFrozenUnlock( locked1 );
+   astProfileStop( &call );
+   return result;
 }
 AstFrameSet *astConvertX_( AstFrame *to, AstFrame *from,
                            const char *domainlist, int *status ) {
@@ -15425,28 +15446,55 @@ double astDistance_( AstFrame *this,
 }
 AstFrameSet *astFindFrame_( AstFrame *target, AstFrame *template,
                             const char *domainlist, int *status ) {
+   AstFrameSet *result;
+   int locked1, locked2;
    if ( !astOK ) return NULL;
-   return (**astMEMBER(target,Frame,FindFrame))( target, template, domainlist, status );
+   locked1 = astFrozenLock( target );
+   locked2 = astFrozenLock( template );
+   result = (**astMEMBER(target,Frame,FindFrame))( target, template, domainlist, status );
+   astFrozenUnlock( locked2 );
+   astFrozenUnlock( locked1 );
+   return result;
 }
 void astMatchAxes_( AstFrame *frm1, AstFrame *frm2, int *axes, int *status ) {
+   int locked1, locked2;
    if ( !astOK ) return;
+   locked1 = astFrozenLock( frm1 );
+   locked2 = astFrozenLock( frm2 );
    (**astMEMBER(frm1,Frame,MatchAxes))( frm1, frm2, axes, status );
+   astFrozenUnlock( locked2 );
+   astFrozenUnlock( locked1 );
 }
 void astMatchAxesX_( AstFrame *frm2, AstFrame *frm1, int *axes, int *status ) {
    if ( !astOK ) return;
    (**astMEMBER(frm2,Frame,MatchAxesX))( frm2, frm1, axes, status );
 }
 const char *astFormat_( AstFrame *this, int axis, double value, int *status ) {
+   const char *result;
+   int locked;
    if ( !astOK ) return NULL;
-   return (**astMEMBER(this,Frame,Format))( this, axis, value, status );
+   locked = astFrozenLock( this );
+   result = (**astMEMBER(this,Frame,Format))( this, axis, value, status );
+   astFrozenUnlock( locked );
+   return result;
 }
 double astCentre_( AstFrame *this, int axis, double value, double gap, int *status ) {
+   double result;
+   int locked;
    if ( !astOK ) return 0.0;
-   return (**astMEMBER(this,Frame,Centre))( this, axis, value, gap, status );
+   locked = astFrozenLock( this );
+   result = (**astMEMBER(this,Frame,Centre))( this, axis, value, gap, status );
+   astFrozenUnlock( locked );
+   return result;
 }
 double astGap_( AstFrame *this, int axis, double gap, int *ntick, int *status ) {
+   double result;
+   int locked;
    if ( !astOK ) return 0.0;
-   return (**astMEMBER(this,Frame,Gap))( this, axis, gap, ntick, status );
+   locked = astFrozenLock( this );
+   result = (**astMEMBER(this,Frame,Gap))( this, axis, gap, ntick, status );
+   astFrozenUnlock( locked );
+   return result;
 }
 AstAxis *astGetAxis_( AstFrame *this, int axis, int *status ) {
    if ( !astOK ) return NULL;
@@ -15579,7 +15627,7 @@ void astOverlay_( AstFrame *template, const int *template_axes,
    (**astMEMBER(template,Frame,Overlay))( template, template_axes, result, status );
 }
 void astPermAxes_( AstFrame *this, const int perm[], int *status ) {
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astPermAxes" ) ) return;
    (**astMEMBER(this,Frame,PermAxes))( this, perm, status );
 }
 AstFrame *astPickAxes_( AstFrame *this, int naxes, const int axes[],
@@ -15620,8 +15668,13 @@ int astSubFrame_( AstFrame *target, AstFrame *template, int result_naxes,
 }
 int astUnformat_( AstFrame *this, int axis, const char *string,
                   double *value, int *status ) {
+   int locked;
+   int result;
    if ( !astOK ) return 0;
-   return (**astMEMBER(this,Frame,Unformat))( this, axis, string, value, status );
+   locked = astFrozenLock( this );
+   result = (**astMEMBER(this,Frame,Unformat))( this, axis, string, value, status );
+   astFrozenUnlock( locked );
+   return result;
 }
 int astValidateAxis_( AstFrame *this, int axis, int fwd, const char *method, int *status ) {
    if ( !astOK ) return 0;
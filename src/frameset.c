@@ -124,6 +124,7 @@ f     - AST_REMOVEFRAME: Remove a Frame from a FrameSet
 
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
+*     AGT: Agent
 
 *  History:
 *     16-FEB-1996 (RFWS):
@@ -274,6 +275,11 @@ f     - AST_REMOVEFRAME: Remove a Frame from a FrameSet
 *        instead.
 *     11-DEC-2017 (DSB):
 *        Added method astGetNode.
+*     18-OCT-2026 (AGT):
+*        Report an error if Frames or variant Mappings are added to,
+*        removed from or re-mapped within a frozen FrameSet. astConvert
+*        and astFindFrame leave the Base and Current attributes of a
+*        frozen FrameSet unchanged.
 *class--
 */
 
@@ -3497,10 +3503,11 @@ static AstFrameSet *ConvertX( AstFrame *to, AstFrame *from,
 
 /* If successful, and a FrameSet is being returned, then set the base
    Frames of "from" and "to" (if they are FrameSets) to indicate the
-   route used to generate the result Mapping. */
+   route used to generate the result Mapping. Frozen FrameSets are left
+   unchanged. */
    if ( astOK && result ) {
-      if ( !from_isframe ) astSetBase( from, iframe_from );
-      if ( !to_isframe ) astSetBase( to, iframe_to );
+      if ( !from_isframe && !astGetFrozen( from ) ) astSetBase( from, iframe_from );
+      if ( !to_isframe && !astGetFrozen( to ) ) astSetBase( to, iframe_to );
    }
 
 /* If an error occurred, annul the returned FrameSet pointer. */
@@ -4010,8 +4017,11 @@ static AstFrameSet *FindFrame( AstFrame *target_frame, AstFrame *template,
    domainlist_copy = astFree( domainlist_copy );
 
 /* If a result is being returned, set the current Frame of the target
-   to indicate where the result Frame was found. */
-   if ( astOK && result ) astSetCurrent( target, target_index );
+   to indicate where the result Frame was found (unless the target is
+   frozen). */
+   if ( astOK && result && !astGetFrozen( target ) ) {
+      astSetCurrent( target, target_index );
+   }
 
 /* If an error occurred, annul any result FrameSet pointer. */
    if ( !astOK && result ) result = astAnnul( result );
@@ -13239,7 +13249,7 @@ AstFrameSet *astLoadFrameSet_( void *mem, size_t size,
    same interface. */
 void astAddFrame_( AstFrameSet *this, int iframe, AstMapping *map,
                    AstFrame *frame, int *status ) {
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astAddFrame" ) ) return;
    (**astMEMBER(this,FrameSet,AddFrame))( this, iframe, map, frame, status );
 }
 void astClearBase_( AstFrameSet *this, int *status ) {
@@ -13279,19 +13289,19 @@ int astGetNframe_( AstFrameSet *this, int *status ) {
    return (**astMEMBER(this,FrameSet,GetNframe))( this, status );
 }
 void astRemapFrame_( AstFrameSet *this, int iframe, AstMapping *map, int *status ) {
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astRemapFrame" ) ) return;
    (**astMEMBER(this,FrameSet,RemapFrame))( this, iframe, map, status );
 }
 void astAddVariant_( AstFrameSet *this, AstMapping *map, const char *name, int *status ) {
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astAddVariant" ) ) return;
    (**astMEMBER(this,FrameSet,AddVariant))( this, map, name, status );
 }
 void astMirrorVariants_( AstFrameSet *this, int iframe, int *status ) {
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astMirrorVariants" ) ) return;
    (**astMEMBER(this,FrameSet,MirrorVariants))( this, iframe, status );
 }
 void astRemoveFrame_( AstFrameSet *this, int iframe, int *status ) {
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astRemoveFrame" ) ) return;
    (**astMEMBER(this,FrameSet,RemoveFrame))( this, iframe, status );
 }
 void astSetBase_( AstFrameSet *this, int ibase, int *status ) {
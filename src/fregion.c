@@ -22,6 +22,8 @@
 *     AST_GETREGIONFRAMESET
 *     AST_OVERLAP
 *     AST_POINTINREGION
+*     AST_POINTSINREGION
+*     AST_POINTSINREGION8
 *     AST_SETUNC
 *     AST_GETUNC
 *     AST_SHOWMESH
@@ -48,10 +50,13 @@
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     22-MAR-2004 (DSB):
 *        Original version.
+*     18-OCT-2026 (AGT):
+*        Added AST_POINTSINREGION and AST_POINTSINREGION8.
 */
 
 /* Define the astFORTRAN77 macro which prevents error messages from
@@ -190,6 +195,58 @@ F77_LOGICAL_FUNCTION(ast_pointinregion)( INTEGER(THIS),
    return RESULT;
 }
 
+F77_INTEGER_FUNCTION(ast_pointsinregion)( INTEGER(THIS),
+                                          INTEGER(NPOINT),
+                                          INTEGER(NCOORD),
+                                          INTEGER(INDIM),
+                                          DOUBLE_ARRAY(IN),
+                                          INTEGER(FLAGS),
+                                          UBYTE_ARRAY(MASK),
+                                          INTEGER(STATUS) ) {
+   GENPTR_INTEGER(THIS)
+   GENPTR_INTEGER(NPOINT)
+   GENPTR_INTEGER(NCOORD)
+   GENPTR_INTEGER(INDIM)
+   GENPTR_DOUBLE_ARRAY(IN)
+   GENPTR_INTEGER(FLAGS)
+   GENPTR_UBYTE_ARRAY(MASK)
+   F77_INTEGER_TYPE(RESULT);
+
+   astAt( "AST_POINTSINREGION", NULL, 0 );
+   astWatchSTATUS(
+      RESULT = astPointsInRegion( astI2P( *THIS ), *NPOINT, *NCOORD, *INDIM,
+                                  (const double *) IN, *FLAGS,
+                                  (unsigned char *) MASK );
+   )
+   return RESULT;
+}
+
+F77_INTEGER8_FUNCTION(ast_pointsinregion8)( INTEGER(THIS),
+                                            INTEGER8(NPOINT),
+                                            INTEGER(NCOORD),
+                                            INTEGER8(INDIM),
+                                            DOUBLE_ARRAY(IN),
+                                            INTEGER(FLAGS),
+                                            UBYTE_ARRAY(MASK),
+                                            INTEGER(STATUS) ) {
+   GENPTR_INTEGER(THIS)
+   GENPTR_INTEGER8(NPOINT)
+   GENPTR_INTEGER(NCOORD)
+   GENPTR_INTEGER8(INDIM)
+   GENPTR_DOUBLE_ARRAY(IN)
+   GENPTR_INTEGER(FLAGS)
+   GENPTR_UBYTE_ARRAY(MASK)
+   F77_INTEGER8_TYPE(RESULT);
+
+   astAt( "AST_POINTSINREGION8", NULL, 0 );
+   astWatchSTATUS(
+      RESULT = astPointsInRegion( astI2P( *THIS ), *NPOINT, *NCOORD, *INDIM,
+                                  (const double *) IN, *FLAGS,
+                                  (unsigned char *) MASK );
+   )
+   return RESULT;
+}
+
 /* AST_MASK<X> requires a function for each possible data type, so
    define it via a macro. */
 #define MAKE_AST_MASK(f,F,Ftype,X,Xtype) \
@@ -60,6 +60,7 @@ f     The Interval class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     29-OCT-2004 (DSB):
@@ -79,6 +80,8 @@ f     The Interval class does not define any new routines beyond those
 *        - Modify RegPins so that it can handle uncertainty regions that straddle
 *        a discontinuity. Previously, such uncertainty Regions could have a huge
 *        bounding box resulting in matching region being far too big.
+*     18-OCT-2026 (AGT):
+*        Override the astRegPointsIn and astRegShape methods.
 *class--
 */
 
@@ -195,6 +198,8 @@ static int GetBounded( AstRegion *, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static int Overlap( AstRegion *, AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
+static int RegShape( AstRegion *, double[2], double[4], double **, int *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
@@ -805,6 +810,8 @@ void astInitIntervalVtab_(  AstIntervalVtab *vtab, const char *name, int *status
    region->GetBounded = GetBounded;
    region->GetDefUnc = GetDefUnc;
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
+   region->RegShape = RegShape;
    region->RegTrace = RegTrace;
    region->RegBaseMesh = RegBaseMesh;
    region->BndBaseMesh = BndBaseMesh;
@@ -2884,6 +2891,287 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside an Interval.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "interval.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     Interval member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Interval, and sets the corresponding bit in the
+*     supplied packed bit mask. The tests are the same as those performed
+*     by the astTransform method, but no output PointSet is created.
+
+*  Parameters:
+*     this
+*        Pointer to the Interval.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the Interval.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the Interval.
+
+*/
+
+/* Local Variables: */
+   AstBox *box;                  /* Pointer to equivalent Box */
+   AstDim npoint;                /* No. of points */
+   AstDim point;                 /* Loop counter for points */
+   AstDim result;                /* Returned number of inside points */
+   AstInterval *this;            /* Pointer to Interval structure */
+   AstPointSet *pset_tmp;        /* Pointer to PointSet holding base Frame positions*/
+   AstRegion *unc;               /* Uncertainty Region */
+   double **ptr_tmp;             /* Pointer to base Frame coordinate data */
+   double *lb;                   /* Base Frame axis lower bounds */
+   double *ub;                   /* Base Frame axis upper bounds */
+   double *lbnd_unc;             /* Lower bounds of uncertainty Region */
+   double *ubnd_unc;             /* Upper bounds of uncertainty Region */
+   double p;                     /* Input base Frame axis value */
+   double wid;                   /* Half width of uncertainy Region */
+   int closed;                   /* Is the boundary part of the Region? */
+   int coord;                    /* Zero-based index for coordinates */
+   int inside;                   /* Is the point inside the Region? */
+   int ncoord_tmp;               /* No. of coordinates per base Frame point */
+   int neg;                      /* Has the Region been negated? */
+   int pass;                     /* Does this point pass the axis test? */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointer to the Interval structure. */
+   this = (AstInterval *) this_region;
+
+/* If this Interval is equivalent to a Box, use the astRegPointsIn method
+   of the equivalent Box. */
+   box = Cache( this, status );
+   if( box ) return astRegPointsIn( box, pset, mask );
+
+/* Otherwise, transform the supplied positions into the base Frame of the
+   encapsulated FrameSet. The returned PointSet will usually be a clone
+   of "pset" and so must not be modified. */
+   pset_tmp = astRegTransform( this_region, pset, 0, NULL, NULL );
+   npoint = astGetNpoint( pset_tmp );
+   ncoord_tmp = astGetNcoord( pset_tmp );
+   ptr_tmp = astGetPoints( pset_tmp );
+
+/* See if the boundary is part of the Region, and if the Region has been
+   negated. */
+   closed = astGetClosed( this_region );
+   neg = astGetNegated( this_region );
+
+/* Get the limits to use on each base Frame axis. In the cases where the
+   Transform function allows some tolerance (closed un-negated Intervals
+   and open negated Intervals), equal limits are separated slightly using
+   the bounding box of the uncertainty Region. */
+   lb = astStore( NULL, this->lbnd, sizeof( double )*(size_t) ncoord_tmp );
+   ub = astStore( NULL, this->ubnd, sizeof( double )*(size_t) ncoord_tmp );
+   if( closed != neg ) {
+      unc = NULL;
+      lbnd_unc = NULL;
+      ubnd_unc = NULL;
+      for ( coord = 0; coord < ncoord_tmp && astOK; coord++ ) {
+         if( lb[ coord ] == ub[ coord ] ) {
+            if( !unc ) {
+               unc = astGetUncFrm( this_region, AST__BASE );
+               lbnd_unc = astMalloc( sizeof( double)*(size_t) ncoord_tmp );
+               ubnd_unc = astMalloc( sizeof( double)*(size_t) ncoord_tmp );
+               astGetRegionBounds( unc, lbnd_unc, ubnd_unc );
+            }
+            if( astOK ) {
+               wid = 0.5*( ubnd_unc[ coord ] - lbnd_unc[ coord ] );
+               lb[ coord ] -= wid;
+               ub[ coord ] += wid;
+            }
+         }
+      }
+      if( unc ) {
+         unc = astAnnul( unc );
+         lbnd_unc = astFree( lbnd_unc );
+         ubnd_unc = astFree( ubnd_unc );
+      }
+   }
+
+/* Clear the returned mask. */
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+/* Test each point. An un-negated Interval contains a point if *all* axis
+   values are within the limits. A negated Interval contains a point if
+   *any* axis value is outside the limits. Points with any bad axis value
+   are outside the Region. */
+   if( astOK ) {
+      for ( point = 0; point < npoint; point++ ) {
+         for ( coord = 0; coord < ncoord_tmp; coord++ ) {
+            if( ptr_tmp[ coord ][ point ] == AST__BAD ) break;
+         }
+         if( coord < ncoord_tmp ) continue;
+
+         inside = !neg;
+         for ( coord = 0; coord < ncoord_tmp; coord++ ) {
+            p = ptr_tmp[ coord ][ point ];
+
+            if( !neg ) {
+               if( lb[ coord ] <= ub[ coord ] ) {
+                  pass = closed ? ( lb[ coord ] <= p && p <= ub[ coord ] ) :
+                                  ( lb[ coord ] < p && p < ub[ coord ] );
+               } else {
+                  pass = closed ? ( p <= ub[ coord ] || lb[ coord ] <= p ) :
+                                  ( p < ub[ coord ] || lb[ coord ] < p );
+               }
+               if( !pass ) {
+                  inside = 0;
+                  break;
+               }
+
+            } else {
+               if( lb[ coord ] <= ub[ coord ] ) {
+                  pass = closed ? ( p <= lb[ coord ] || ub[ coord ] <= p ) :
+                                  ( p < lb[ coord ] || ub[ coord ] < p );
+               } else {
+                  pass = closed ? ( ub[ coord ] <= p && p <= lb[ coord ] ) :
+                                  ( ub[ coord ] < p && p < lb[ coord ] );
+               }
+               if( pass ) {
+                  inside = 1;
+                  break;
+               }
+            }
+         }
+
+         if( inside ) {
+            mask[ point/8 ] |= (unsigned char)( 1 << ( point % 8 ) );
+            result++;
+         }
+      }
+   }
+
+/* Free resources */
+   lb = astFree( lb );
+   ub = astFree( ub );
+   pset_tmp = astAnnul( pset_tmp );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static int RegShape( AstRegion *this_region, double centre[2],
+                     double matrix[4], double **vert, int *nvert,
+                     int *status ){
+/*
+*  Name:
+*     RegShape
+
+*  Purpose:
+*     Return an analytic description of a 2-dimensional Interval.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "interval.h"
+*     int RegShape( AstRegion *this, double centre[2], double matrix[4],
+*                   double **vert, int *nvert, int *status )
+
+*  Class Membership:
+*     Interval member function (over-rides the astRegShape protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns the four corners of an un-negated 2-dimensional
+*     Interval that has finite included limits on both axes, as a polygon
+*     within the base Frame of the Interval. See astRegShape for details.
+
+*  Parameters:
+*     this
+*        Pointer to the Interval.
+*     centre
+*        Not used.
+*     matrix
+*        Not used.
+*     vert
+*        Returned holding a pointer to a newly allocated array holding the
+*        corner coordinates.
+*     nvert
+*        Returned holding the number of corners (4).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     AST__POLYSHAPE, or AST__NOSHAPE if the Interval cannot be
+*     described as a rectangle.
+
+*/
+
+/* Local Variables: */
+   double **ptr;             /* Pointers to the axis limits */
+   int i;                    /* Axis index */
+
+/* Initialise */
+   *vert = NULL;
+   *nvert = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return AST__NOSHAPE;
+
+/* Only un-negated 2-dimensional Intervals can be described. */
+   if( astGetNegated( this_region ) ||
+       astGetNin( this_region->frameset ) != 2 ) return AST__NOSHAPE;
+
+/* The lower and upper limits on each axis are stored in the parent
+   Region structure. Both limits must be defined on both axes, and must
+   describe an included (rather than excluded) range. */
+   ptr = astGetPoints( this_region->points );
+   if( !astOK ) return AST__NOSHAPE;
+   for( i = 0; i < 2; i++ ) {
+      if( ptr[ i ][ 0 ] == AST__BAD || ptr[ i ][ 1 ] == AST__BAD ||
+          ptr[ i ][ 0 ] >= ptr[ i ][ 1 ] ) return AST__NOSHAPE;
+   }
+
+/* Store the corners in anti-clockwise order. */
+   *vert = astMalloc( 8*sizeof( double ) );
+   if( astOK ) {
+      (*vert)[ 0 ] = ptr[ 0 ][ 0 ];
+      (*vert)[ 1 ] = ptr[ 0 ][ 1 ];
+      (*vert)[ 2 ] = ptr[ 0 ][ 1 ];
+      (*vert)[ 3 ] = ptr[ 0 ][ 0 ];
+      (*vert)[ 4 ] = ptr[ 1 ][ 0 ];
+      (*vert)[ 5 ] = ptr[ 1 ][ 0 ];
+      (*vert)[ 6 ] = ptr[ 1 ][ 1 ];
+      (*vert)[ 7 ] = ptr[ 1 ][ 1 ];
+      *nvert = 4;
+   }
+
+/* Return the result. */
+   return astOK ? AST__POLYSHAPE : AST__NOSHAPE;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
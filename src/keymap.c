@@ -109,6 +109,7 @@ f     - AST_MAPTYPE: Return the data type of a named entry in a map
 
 *  Authors:
 *     DSB: B.S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     12-NOV-2004 (DSB):
@@ -216,6 +217,15 @@ f     - AST_MAPTYPE: Return the data type of a named entry in a map
 *     27-MAY-2021 (DSB):
 *         Modify astMapGet1<X> so that nval=0 is returned if the value is
 *         undefined.
+*     18-OCT-2026 (AGT):
+*         - Added protected method astMapHidden, which allows subclasses that
+*         hold some entries outside the hash table (e.g. the Table class)
+*         to supply copies of them when the hash table is dumped or copied,
+*         and protected methods astMapNewAge, astMapGetAge and astMapSetAge,
+*         which allow such entries to share the age sequence used by the
+*         SortBy attribute.
+*         - Report an error if an entry is added to, removed from or
+*         changed within a frozen KeyMap.
 *class--
 */
 
@@ -489,6 +499,7 @@ static AstMapEntry *RemoveTableEntry( AstKeyMap *, int, const char *, int * );
 static AstMapEntry *SearchTableEntry( AstKeyMap *, int, const char *, int * );
 static const char *ConvertKey( AstKeyMap *, const char *, char *, int, const char *, int * );
 static const char *GetKey( AstKeyMap *, int index, int * );
+static AstKeyMap *MapHidden( AstKeyMap *, const char *, int * );
 static const char *MapIterate( AstKeyMap *, int, int * );
 static const char *MapKey( AstKeyMap *, int index, int * );
 static const char *SortByString( int, const char *, int * );
@@ -526,6 +537,8 @@ static int MapGetElemF( AstKeyMap *, const char *, int, float *, int * );
 static int MapGetElemI( AstKeyMap *, const char *, int, int *, int * );
 static int MapGetElemK( AstKeyMap *, const char *, int, int64_t *, int * );
 static int MapGetElemP( AstKeyMap *, const char *, int, void **, int * );
+static int MapGetAge( AstKeyMap *, const char *, int *, int * );
+static int MapNewAge( AstKeyMap *, int * );
 static int MapHasKey( AstKeyMap *, const char *, int * );
 static int MapLenC( AstKeyMap *, const char *, int * );
 static int MapLength( AstKeyMap *, const char *, int * );
@@ -546,6 +559,7 @@ static void FreeTableEntry( AstKeyMap *, int itab, int * );
 static void InitMapEntry( AstMapEntry *, int, int, int * );
 static void MapCopy( AstKeyMap *, AstKeyMap *, int * );
 static void MapCopyEntry( AstKeyMap *, const char *, AstKeyMap *, int, int * );
+static void MapSetAge( AstKeyMap *, const char *, int, int, int * );
 static void MapPut0A( AstKeyMap *, const char *, AstObject *, const char *, int * );
 static void MapPut0C( AstKeyMap *, const char *, const char *, const char *, int * );
 static void MapPut0D( AstKeyMap *, const char *, double, const char *, int * );
@@ -3784,6 +3798,10 @@ void astInitKeyMapVtab_(  AstKeyMapVtab *vtab, const char *name, int *status ) {
    vtab->MapCopy = MapCopy;
    vtab->MapCopyEntry = MapCopyEntry;
    vtab->MapDefined = MapDefined;
+   vtab->MapHidden = MapHidden;
+   vtab->MapGetAge = MapGetAge;
+   vtab->MapNewAge = MapNewAge;
+   vtab->MapSetAge = MapSetAge;
    vtab->MapSize = MapSize;
    vtab->MapLenC = MapLenC;
    vtab->MapLength = MapLength;
@@ -4160,6 +4178,7 @@ f        The global status.
 */
 
 /* Local Variables: */
+   AstKeyMap *hidden;     /* Entries held outside the source hash table */
    AstMapEntry *in_entry; /* Pointer to next source entry to copy */
    AstMapEntry *out_entry;/* Pointer to existing destination entry */
    AstObject *in_obj;     /* Pointer for source Object entry */
@@ -4257,6 +4276,13 @@ f        The global status.
          in_entry = in_entry->next;
       }
    }
+
+/* Copy any entries held outside the source hash table by a subclass. */
+   hidden = astMapHidden( that, NULL );
+   if( hidden ) {
+      MapCopy( this, hidden, status );
+      hidden = astAnnul( hidden );
+   }
 }
 
 static void MapCopyEntry( AstKeyMap *this, const char *skey, AstKeyMap *that,
@@ -4330,6 +4356,8 @@ f        The global status.
 */
 
 /* Local Variables: */
+   AstKeyMap *hidden;     /* Source entry held outside the hash table */
+   AstKeyMap *src;        /* KeyMap holding the source entry */
    AstMapEntry *in_entry; /* Pointer to next source entry to copy */
    AstMapEntry *out_entry;/* Pointer to existing destination entry */
    AstObject *in_obj;     /* Pointer for source Object entry */
@@ -4348,12 +4376,17 @@ f        The global status.
    key = ConvertKey( that, skey, keybuf, AST__MXKEYLEN + 1, "astMapCopyEntry",
                      status );
 
+/* If a subclass holds the source entry outside the hash table, get a
+   KeyMap holding a copy of it, and use it in place of the source KeyMap. */
+   hidden = astMapHidden( that, key );
+   src = hidden ? hidden : that;
+
 /* Use the hash function to determine the element of the hash table in
    which the key will be stored. */
-   itab = HashFun( key, that->mapsize - 1, &hash, status );
+   itab = HashFun( key, src->mapsize - 1, &hash, status );
 
 /* Search the relevent table entry for the required MapEntry. */
-   in_entry = SearchTableEntry( that, itab, key, status );
+   in_entry = SearchTableEntry( src, itab, key, status );
 
 /* If found, search for a destination entry with the same key. */
    if( in_entry ) {
@@ -4425,6 +4458,141 @@ f        The global status.
          }
       }
    }
+
+/* Free any copy of a hidden source entry. */
+   if( hidden ) hidden = astAnnul( hidden );
+}
+
+static int MapGetAge( AstKeyMap *this, const char *skey, int *keyage,
+                      int *status ) {
+/*
+*+
+*  Name:
+*     astMapGetAge
+
+*  Purpose:
+*     Get the age of an entry in the hash table of a KeyMap.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "keymap.h"
+*     int astMapGetAge( AstKeyMap *this, const char *key, int *keyage )
+
+*  Class Membership:
+*     KeyMap method.
+
+*  Description:
+*     This function returns the age of the entry with a given key in the
+*     hash table of a KeyMap (i.e. the value used to sort the entry when
+*     the SortBy attribute is "AgeUp" or "AgeDown"), together with the age
+*     of the key itself (used when SortBy is "KeyAgeUp" or "KeyAgeDown").
+*     It is intended for use by subclasses that hold some entries outside
+*     the hash table (see astMapHidden) and need to preserve their ages.
+
+*  Parameters:
+*     this
+*        Pointer to the KeyMap.
+*     key
+*        The key.
+*     keyage
+*        Pointer to an int in which to return the age of the key. -1 is
+*        returned if the hash table does not contain the key.
+
+*  Returned Value:
+*     The age of the entry, or -1 if the hash table does not contain the
+*     key.
+
+*-
+*/
+
+/* Local Variables: */
+   AstMapEntry *mapentry;  /* Pointer to entry in linked list */
+   char keybuf[ AST__MXKEYLEN + 1 ]; /* Buffer for upper cas key */
+   const char *key;        /* Pointer to key string to use */
+   int itab;               /* Index of hash table element to use */
+   int result;             /* Returned value */
+   unsigned long hash;     /* Full width hash value */
+
+/* Initialise */
+   result = -1;
+   *keyage = -1;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Convert the supplied key to upper case if required. */
+   key = ConvertKey( this, skey, keybuf, AST__MXKEYLEN + 1, "astMapGetAge",
+                     status );
+
+/* Search the relevent table entry for the required MapEntry. */
+   itab = HashFun( key, this->mapsize - 1, &hash, status );
+   mapentry = SearchTableEntry( this, itab, key, status );
+
+/* If found, return the ages. */
+   if( mapentry ) {
+      result = mapentry->member;
+      *keyage = mapentry->keymember;
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static AstKeyMap *MapHidden( AstKeyMap *this, const char *key, int *status ) {
+/*
+*+
+*  Name:
+*     astMapHidden
+
+*  Purpose:
+*     Get copies of the entries held outside the hash table of a KeyMap.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "keymap.h"
+*     AstKeyMap *astMapHidden( AstKeyMap *this, const char *key )
+
+*  Class Membership:
+*     KeyMap method.
+
+*  Description:
+*     Some methods (e.g. astMapCopy and the Dump function) access the
+*     entries in a KeyMap's hash table directly rather than by invoking
+*     virtual methods. Subclasses that hold some of their entries in
+*     some other form (for instance, the Table class holds the values in
+*     numerical columns in contiguous arrays) should over-ride this method
+*     to return a new KeyMap holding a copy of each such entry, so that
+*     these methods can include them without modifying the supplied
+*     KeyMap.
+*
+*     The KeyMap class holds all entries in the hash table, so the
+*     implementation provided by this class returns a NULL pointer.
+
+*  Parameters:
+*     this
+*        Pointer to the KeyMap.
+*     key
+*        The key of a single entry to be returned. If NULL, all entries
+*        held outside the hash table are returned.
+
+*  Returned Value:
+*     A pointer to a new KeyMap holding the required entries, or NULL if
+*     no entries are held outside the hash table. The KeyCase attribute of
+*     the returned KeyMap is the same as that of the supplied KeyMap. The
+*     returned KeyMap should be annulled when no longer needed.
+
+*  Notes:
+*     - A NULL pointer will be returned if this function is invoked with
+*     the global error status set, or if it should fail for any reason.
+*-
+*/
+
+/* All entries are held in the hash table, so there is nothing to return. */
+   return NULL;
 }
 
 static const char *MapKey( AstKeyMap *this, int index, int *status ) {
@@ -5069,8 +5237,8 @@ void astMapPut1AId_( AstKeyMap *this, const char *skey, int size,
    int keymember;          /* Identifier for existing key */
    int there;              /* Did the entry already exist in the KeyMap? */
 
-/* Check the global error status. */
-   if ( !astOK ) return;
+/* Check the global error status, and check the KeyMap can be changed. */
+   if ( !astOK || astCheckFrozen( this, "astMapPut1A" ) ) return;
 
 /* Convert the supplied key to upper case if required. */
    key = ConvertKey( this, skey, keybuf, AST__MXKEYLEN + 1, "astMapPut1A",
@@ -7540,6 +7708,54 @@ f     .FALSE.
 
 }
 
+static int MapNewAge( AstKeyMap *this, int *status ) {
+/*
+*+
+*  Name:
+*     astMapNewAge
+
+*  Purpose:
+*     Reserve a new age value within a KeyMap.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "keymap.h"
+*     int astMapNewAge( AstKeyMap *this )
+
+*  Class Membership:
+*     KeyMap method.
+
+*  Description:
+*     This function returns a new age value that is larger than the age
+*     of any entry or key previously stored in the KeyMap, and that will
+*     not be used for any subsequent entry or key. It is intended for use
+*     by subclasses that hold some entries outside the hash table (see
+*     astMapHidden), so that such entries share a single age sequence
+*     with the entries in the hash table.
+
+*  Parameters:
+*     this
+*        Pointer to the KeyMap.
+
+*  Returned Value:
+*     The new age value.
+
+*  Notes:
+*     - A value of -1 will be returned if this function is invoked with
+*     the global error status set, or if it should fail for any reason.
+*-
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return -1;
+
+/* Each new entry and key has a unique member index that is never
+   re-used. */
+   return (this->member_count)++;
+}
+
 static void MapRemove( AstKeyMap *this, const char *skey, int *status ) {
 /*
 *++
@@ -7742,6 +7958,79 @@ f        The global status.
    }
 }
 
+static void MapSetAge( AstKeyMap *this, const char *skey, int age,
+                       int keyage, int *status ) {
+/*
+*+
+*  Name:
+*     astMapSetAge
+
+*  Purpose:
+*     Set the age of an entry in the hash table of a KeyMap.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "keymap.h"
+*     void astMapSetAge( AstKeyMap *this, const char *key, int age,
+*                        int keyage )
+
+*  Class Membership:
+*     KeyMap method.
+
+*  Description:
+*     This function changes the age of the entry with a given key in the
+*     hash table of a KeyMap, and the age of the key itself. It allows
+*     subclasses that move entries into the hash table from some other
+*     form of storage (see astMapHidden) to retain the ages given to the
+*     entries when they were first stored. Any sorted list of keys is
+*     updated to reflect the new ages.
+
+*  Parameters:
+*     this
+*        Pointer to the KeyMap.
+*     key
+*        The key. The function returns without action if the hash table
+*        does not contain the key.
+*     age
+*        The new age for the entry. This should be a value previously
+*        returned by astMapNewAge.
+*     keyage
+*        The new age for the key. This should be a value previously
+*        returned by astMapNewAge.
+
+*-
+*/
+
+/* Local Variables: */
+   AstMapEntry *mapentry;  /* Pointer to entry in linked list */
+   char keybuf[ AST__MXKEYLEN + 1 ]; /* Buffer for upper cas key */
+   const char *key;        /* Pointer to key string to use */
+   int itab;               /* Index of hash table element to use */
+   unsigned long hash;     /* Full width hash value */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Convert the supplied key to upper case if required. */
+   key = ConvertKey( this, skey, keybuf, AST__MXKEYLEN + 1, "astMapSetAge",
+                     status );
+
+/* Search the relevent table entry for the required MapEntry. */
+   itab = HashFun( key, this->mapsize - 1, &hash, status );
+   mapentry = SearchTableEntry( this, itab, key, status );
+
+/* If found, remove the entry from the sorted list, change its ages, and
+   then add it back into the sorted list at the new position. */
+   if( mapentry ) {
+      RemoveFromSortedList( this, mapentry, status );
+      mapentry->member = age;
+      mapentry->keymember = keyage;
+      AddToSortedList( this, mapentry, status );
+   }
+}
+
 static int MapSize( AstKeyMap *this, int *status ) {
 /*
 *++
@@ -9873,8 +10162,11 @@ static void SortEntries( AstKeyMap *this, int *status ){
 /* Do nothing more if no sorting is required. */
    if( sortby != SORTBY_NONE ) {
 
-/* Get the number of entries in the keyMap. */
-      nent = astMapSize( this );
+/* Get the number of entries in the keyMap's hash table. Use the KeyMap
+   implementation of MapSize rather than the virtual method, since
+   subclasses may hold other entries outside the hash table (e.g. the
+   Table class). */
+      nent = MapSize( this, status );
 
 /* Only sort if the KeyMap is not empty. */
       if( nent > 0 ) {
@@ -10455,6 +10747,7 @@ static void Dump( AstObject *this_object, AstChannel *channel, int *status ) {
 */
 
 /* Local Variables: */
+   AstKeyMap *hidden;            /* Entries held outside the hash table */
    AstKeyMap *this;              /* Pointer to the KeyMap structure */
    AstMapEntry *next;            /* Pointer to the next AstMapEntry to dump */
    int i;                        /* Index into hash table */
@@ -10525,6 +10818,20 @@ static void Dump( AstObject *this_object, AstChannel *channel, int *status ) {
 
       }
    }
+
+/* Dump any entries held outside the hash table by a subclass, continuing
+   the entry numbering used above. */
+   hidden = astMapHidden( this, NULL );
+   if( hidden ) {
+      for( i = 0; i < hidden->mapsize; i++ ) {
+         next = hidden->table[ i ];
+         while( next && astOK ) {
+            DumpEntry( next, channel, ++nentry, status );
+            next = next->next;
+         }
+      }
+      hidden = astAnnul( hidden );
+   }
 }
 
 /* Standard class functions. */
@@ -11256,7 +11563,7 @@ AstKeyMap *astLoadKeyMap_( void *mem, size_t size, AstKeyMapVtab *vtab,
 #define MAKE_MAPPUT0_(X,Xtype) \
 void astMapPut0##X##_( AstKeyMap *this, const char *key, Xtype value, \
                       const char *comment, int *status ){ \
-   if ( !astOK ) return; \
+   if ( !astOK || astCheckFrozen( this, "astMapPut0"#X ) ) return; \
    (**astMEMBER(this,KeyMap,MapPut0##X))(this,key,value,comment, status ); \
 }
 MAKE_MAPPUT0_(D,double)
@@ -11275,7 +11582,7 @@ MAKE_MAPPUT0_(B,unsigned char)
 void astMapPut1##X##_( AstKeyMap *this, const char *key, int size, \
                        Xtype value[], const char *comment, \
                        int *status ){ \
-   if ( !astOK ) return; \
+   if ( !astOK || astCheckFrozen( this, "astMapPut1"#X ) ) return; \
    (**astMEMBER(this,KeyMap,MapPut1##X))(this,key,size,value,comment, status ); \
 }
 MAKE_MAPPUT1_(S,const short int)
@@ -11359,7 +11666,7 @@ int astMapGetElemC_( AstKeyMap *this, const char *key, int l, int elem,
 #define MAKE_MAPPUTELEM_(X,Xtype) \
 void astMapPutElem##X##_( AstKeyMap *this, const char *key, int elem, \
                          Xtype value, int *status ){ \
-   if ( !astOK ) return; \
+   if ( !astOK || astCheckFrozen( this, "astMapPutElem"#X ) ) return; \
    (**astMEMBER(this,KeyMap,MapPutElem##X))(this,key,elem,value,status); \
 }
 MAKE_MAPPUTELEM_(B,unsigned char)
@@ -11374,26 +11681,26 @@ MAKE_MAPPUTELEM_(P,void *)
 #undef MAKE_MAPPUTELEM_
 
 void astMapPutU_( AstKeyMap *this, const char *key, const char *comment, int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astMapPutU" ) ) return;
    (**astMEMBER(this,KeyMap,MapPutU))(this,key,comment,status);
 }
 
 void astMapRemove_( AstKeyMap *this, const char *key, int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astMapRemove" ) ) return;
    (**astMEMBER(this,KeyMap,MapRemove))(this,key,status);
 }
 void astMapRename_( AstKeyMap *this, const char *oldkey, const char *newkey,
                     int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astMapRename" ) ) return;
    (**astMEMBER(this,KeyMap,MapRename))(this,oldkey,newkey,status);
 }
 void astMapCopy_( AstKeyMap *this, AstKeyMap *that, int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astMapCopy" ) ) return;
    (**astMEMBER(this,KeyMap,MapCopy))(this,that,status);
 }
 void astMapCopyEntry_( AstKeyMap *this, const char *key, AstKeyMap *that,
                        int merge, int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astMapCopyEntry" ) ) return;
    (**astMEMBER(this,KeyMap,MapCopyEntry))(this,key,that,merge,status);
 }
 int astMapDefined_( AstKeyMap *this, const char *key, int *status ){
@@ -11428,6 +11735,24 @@ const char *astMapIterate_( AstKeyMap *this, int reset, int *status ){
    if ( !astOK ) return NULL;
    return (**astMEMBER(this,KeyMap,MapIterate))(this,reset,status);
 }
+AstKeyMap *astMapHidden_( AstKeyMap *this, const char *key, int *status ){
+   if ( !astOK ) return NULL;
+   return (**astMEMBER(this,KeyMap,MapHidden))(this,key,status);
+}
+int astMapGetAge_( AstKeyMap *this, const char *key, int *keyage, int *status ){
+   *keyage = -1;
+   if ( !astOK ) return -1;
+   return (**astMEMBER(this,KeyMap,MapGetAge))(this,key,keyage,status);
+}
+int astMapNewAge_( AstKeyMap *this, int *status ){
+   if ( !astOK ) return -1;
+   return (**astMEMBER(this,KeyMap,MapNewAge))(this,status);
+}
+void astMapSetAge_( AstKeyMap *this, const char *key, int age, int keyage,
+                    int *status ){
+   if ( !astOK ) return;
+   (**astMEMBER(this,KeyMap,MapSetAge))(this,key,age,keyage,status);
+}
 int astGetSizeGuess_( AstKeyMap *this, int *status ){
    if( !astOK ) return 0;
    return (**astMEMBER(this,KeyMap,GetSizeGuess))(this,status);
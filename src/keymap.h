@@ -48,6 +48,7 @@
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     13-NOV-2004 (DSB):
@@ -56,6 +57,9 @@
 *        Added support for single precision entries.
 *     7-MAR-2008 (DSB):
 *        Added support for pointer ("P") entries.
+*     18-OCT-2026 (AGT):
+*        Added protected methods astMapHidden, astMapNewAge, astMapGetAge
+*        and astMapSetAge.
 *-
 */
 
@@ -232,6 +236,10 @@ typedef struct AstKeyMapVtab {
    int (* MapDefined)( AstKeyMap *, const char *, int * );
    const char *(* MapIterate)( AstKeyMap *, int, int * );
    const char *(* MapKey)( AstKeyMap *, int, int * );
+   AstKeyMap *(* MapHidden)( AstKeyMap *, const char *, int * );
+   int (* MapGetAge)( AstKeyMap *, const char *, int *, int * );
+   int (* MapNewAge)( AstKeyMap *, int * );
+   void (* MapSetAge)( AstKeyMap *, const char *, int, int, int * );
 
    int (* GetSizeGuess)( AstKeyMap *, int * );
    int (* TestSizeGuess)( AstKeyMap *, int * );
@@ -396,6 +404,10 @@ void astMapRename_( AstKeyMap *, const char *, const char *, int * );
 
 #if defined(astCLASS)            /* Protected */
 const char *astMapIterate_( AstKeyMap *, int, int * );
+AstKeyMap *astMapHidden_( AstKeyMap *, const char *, int * );
+int astMapGetAge_( AstKeyMap *, const char *, int *, int * );
+int astMapNewAge_( AstKeyMap *, int * );
+void astMapSetAge_( AstKeyMap *, const char *, int, int, int * );
 
 int astGetSizeGuess_( AstKeyMap *, int * );
 int astTestSizeGuess_( AstKeyMap *, int * );
@@ -537,6 +549,10 @@ astINVOKE(O,astLoadKeyMap_(mem,size,vtab,name,astCheckChannel(channel),STATUS_PT
 #define astMapPut1A(this,key,size,value,comment) astINVOKE(V,astMapPut1A_(astCheckKeyMap(this),key,size,value,comment,STATUS_PTR))
 #define astMapGetElemA(this,key,elem,value) astINVOKE(V,astMapGetElemA_(astCheckKeyMap(this),key,elem,(AstObject **)(value),STATUS_PTR))
 #define astMapIterate(this,reset) astINVOKE(V,astMapIterate_(astCheckKeyMap(this),reset,STATUS_PTR))
+#define astMapHidden(this,key) astINVOKE(O,astMapHidden_(astCheckKeyMap(this),key,STATUS_PTR))
+#define astMapGetAge(this,key,keyage) astINVOKE(V,astMapGetAge_(astCheckKeyMap(this),key,keyage,STATUS_PTR))
+#define astMapNewAge(this) astINVOKE(V,astMapNewAge_(astCheckKeyMap(this),STATUS_PTR))
+#define astMapSetAge(this,key,age,keyage) astINVOKE(V,astMapSetAge_(astCheckKeyMap(this),key,age,keyage,STATUS_PTR))
 
 #define astClearSizeGuess(this) \
 astINVOKE(V,astClearSizeGuess_(astCheckKeyMap(this),STATUS_PTR))
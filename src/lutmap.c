@@ -74,6 +74,7 @@ f     The LutMap class does not define any new routines beyond those
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: David S. Berry (JAC, UCLan)
+*     AGT: Agent
 
 *  History:
 *     8-JUL-1997 (RFWS):
@@ -115,6 +116,13 @@ f     The LutMap class does not define any new routines beyond those
 *        The GetMonotonic function had a bug that caused all LutMaps
 *        to be considered monotonic, and thus have an inverse
 *        transformation.
+*     18-OCT-2026 (AGT):
+*        - Added protected astBorrowedLutMap constructor, which creates a
+*        LutMap that uses the supplied lookup table directly rather than
+*        a copy of it.
+*        - Copies of a LutMap now share the lookup tables with the
+*        original LutMap, rather than copying them.
+*        - Override the astGetObjSize method.
 *class--
 */
 
@@ -172,6 +180,7 @@ static const char *(* parent_getattrib)( AstObject *, const char *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
+static size_t (* parent_getobjsize)( AstObject *, int * );
 
 /* Define macros for accessing each item of thread specific global data. */
 #ifdef THREAD_SAFE
@@ -216,6 +225,7 @@ AstLutMap *astLutMapId_( int, const double [], double, double, const char *, ...
 /* ======================================== */
 static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static int GetLinear( AstMapping *, int * );
+static size_t GetObjSize( AstObject *, int * );
 static int GetMonotonic( int, const double *, int *, double **, int **, int **, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 static void Copy( const AstObject *, AstObject *, int * );
@@ -509,6 +519,75 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
 
 }
 
+static size_t GetObjSize( AstObject *this_object, int *status ) {
+/*
+*  Name:
+*     GetObjSize
+
+*  Purpose:
+*     Return the in-memory size of an Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "lutmap.h"
+*     size_t GetObjSize( AstObject *this, int *status )
+
+*  Class Membership:
+*     LutMap member function (over-rides the astGetObjSize protected
+*     method inherited from the parent class).
+
+*  Description:
+*     This function returns the in-memory size of the supplied LutMap,
+*     in bytes.
+
+*  Parameters:
+*     this
+*        Pointer to the LutMap.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The Object size, in bytes.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstLutMap *this;
+   size_t result;
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointers to the LutMap structure. */
+   this = (AstLutMap *) this_object;
+
+/* Invoke the GetObjSize method inherited from the parent class, and then
+   add on any components of the class structure defined by this class
+   which are stored in dynamically allocated memory. */
+   result = (*parent_getobjsize)( this_object, status );
+
+/* A borrowed lookup table is owned by some other Object, and so is not
+   included. */
+   if( !this->borrowed ) result += astTSizeOf( this->lut );
+   result += astTSizeOf( this->luti );
+   result += astTSizeOf( this->flagsi );
+   result += astTSizeOf( this->indexi );
+
+/* If an error occurred, clear the result value. */
+   if ( !astOK ) result = 0;
+
+/* Return the result, */
+   return result;
+}
+
 static int GetLinear( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -943,6 +1022,9 @@ void astInitLutMapVtab_(  AstLutMapVtab *vtab, const char *name, int *status ) {
    object = (AstObjectVtab *) vtab;
    mapping = (AstMappingVtab *) vtab;
 
+   parent_getobjsize = object->GetObjSize;
+   object->GetObjSize = GetObjSize;
+
    parent_clearattrib = object->ClearAttrib;
    object->ClearAttrib = ClearAttrib;
    parent_getattrib = object->GetAttrib;
@@ -1883,17 +1965,21 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->flagsi = NULL;
    out->indexi = NULL;
 
-/* Allocate memory and store a copy of the lookup table data. */
-   out->lut = astStore( NULL, in->lut,
-                        sizeof( double ) * (size_t) in->nlut );
+/* The lookup table is never changed once the LutMap has been created,
+   so the output LutMap shares the input lookup table rather than a copy
+   of it (see astShare). If the input LutMap borrows its lookup table,
+   the copy borrows the same table (the owner of the table must keep it
+   in existence until all LutMaps that use it have been deleted). */
+   if( in->borrowed ) {
+      out->lut = in->lut;
+   } else {
+      out->lut = astShare( in->lut );
+   }
 
 /* Do the arrays used for the inverse transformation, if they exist. */
-   if( in->luti ) out->luti = astStore( NULL, in->luti,
-                                        sizeof( double ) * (size_t) in->nluti );
-   if( in->flagsi ) out->flagsi = astStore( NULL, in->flagsi,
-                                        sizeof( double ) * (size_t) in->nluti );
-   if( in->indexi ) out->indexi = astStore( NULL, in->indexi,
-                                        sizeof( double ) * (size_t) in->nluti );
+   if( in->luti ) out->luti = astShare( in->luti );
+   if( in->flagsi ) out->flagsi = astShare( in->flagsi );
+   if( in->indexi ) out->indexi = astShare( in->indexi );
 }
 
 /* Destructor. */
@@ -1928,8 +2014,13 @@ static void Delete( AstObject *obj, int *status ) {
 /* Obtain a pointer to the LutMap structure. */
    this = (AstLutMap *) obj;
 
-/* Free the memory holding the lookup tables, etc. */
-   this->lut = astFree( this->lut );
+/* Free the memory holding the lookup tables, etc. A borrowed lookup
+   table is owned by someone else and so is not freed. */
+   if( this->borrowed ) {
+      this->lut = NULL;
+   } else {
+      this->lut = astFree( this->lut );
+   }
    this->luti = astFree( this->luti );
    this->flagsi = astFree( this->flagsi );
    this->indexi = astFree( this->indexi );
@@ -2155,7 +2246,7 @@ f     function is invoked with STATUS set to an error value, or if it
 /* Initialise the LutMap, allocating memory and initialising the
    virtual function table as well if necessary. */
    new = astInitLutMap( NULL, sizeof( AstLutMap ), !class_init, &class_vtab,
-                        "LutMap", nlut, lut, start, inc );
+                        "LutMap", nlut, lut, start, inc, 0 );
 
 /* If successful, note that the virtual function table has been
    initialised. */
@@ -2238,7 +2329,7 @@ AstLutMap *astLutMapId_( int nlut, const double lut[],
 /* Initialise the LutMap, allocating memory and initialising the
    virtual function table as well if necessary. */
    new = astInitLutMap( NULL, sizeof( AstLutMap ), !class_init, &class_vtab,
-                        "LutMap", nlut, lut, start, inc );
+                        "LutMap", nlut, lut, start, inc, 0 );
 
 /* If successful, note that the virtual function table has been
    initialised. */
@@ -2260,10 +2351,95 @@ AstLutMap *astLutMapId_( int nlut, const double lut[],
    return astMakeId( new );
 }
 
+AstLutMap *astBorrowedLutMap_( int nlut, const double lut[],
+                               double start, double inc,
+                               const char *options, int *status, ...) {
+/*
+*+
+*  Name:
+*     astBorrowedLutMap
+
+*  Purpose:
+*     Create a LutMap that uses a supplied lookup table without copying it.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "lutmap.h"
+*     AstLutMap *astBorrowedLutMap( int nlut, const double lut[],
+*                                   double start, double inc,
+*                                   const char *options, ... )
+
+*  Class Membership:
+*     LutMap constructor.
+
+*  Description:
+*     This function is identical to astLutMap except that the new
+*     LutMap uses the supplied "lut" array directly, rather than taking
+*     a copy of it. This avoids the cost of copying very large lookup
+*     tables, such as those read from memory-mapped FITS binary tables.
+*     Copies of the new LutMap share the same array.
+
+*  Parameters:
+*     As for astLutMap.
+
+*  Returned Value:
+*     A pointer to the new LutMap.
+
+*  Notes:
+*     - The caller must ensure that the "lut" array is not changed or
+*     freed until the new LutMap, and any copies of it, have been
+*     deleted.
+*     - A copy of the array is still taken if it contains any NaN or
+*     infinite values, since these must be replaced by AST__BAD.
+*     - A null Object pointer will be returned if this function is
+*     invoked with the AST error status set, or if it should fail for
+*     any reason.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstLutMap *new;               /* Pointer to new LutMap */
+   va_list args;                 /* Variable argument list */
+
+/* Get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Check the global status. */
+   if ( !astOK ) return NULL;
+
+/* Initialise the LutMap, allocating memory and initialising the
+   virtual function table as well if necessary. */
+   new = astInitLutMap( NULL, sizeof( AstLutMap ), !class_init, &class_vtab,
+                        "LutMap", nlut, lut, start, inc, 1 );
+
+/* If successful, note that the virtual function table has been
+   initialised. */
+   if ( astOK ) {
+      class_init = 1;
+
+/* Obtain the variable argument list and pass it along with the
+   options string to the astVSet method to initialise the new
+   LutMap's attributes. */
+      va_start( args, status );
+      astVSet( new, options, NULL, args );
+      va_end( args );
+
+/* If an error occurred, clean up by deleting the new object. */
+      if ( !astOK ) new = astDelete( new );
+   }
+
+/* Return a pointer to the new LutMap. */
+   return new;
+}
+
 AstLutMap *astInitLutMap_( void *mem, size_t size, int init,
                            AstLutMapVtab *vtab, const char *name,
                            int nlut, const double lut[],
-                           double start, double inc, int *status ) {
+                           double start, double inc, int borrow,
+                           int *status ) {
 /*
 *+
 *  Name:
@@ -2280,7 +2456,7 @@ AstLutMap *astInitLutMap_( void *mem, size_t size, int init,
 *     AstLutMap *astInitLutMap( void *mem, size_t size, int init,
 *                               AstLutMapVtab *vtab, const char *name,
 *                               int nlut, const double lut[],
-*                               double start, double inc )
+*                               double start, double inc, int borrow )
 
 *  Class Membership:
 *     LutMap initialiser.
@@ -2332,6 +2508,13 @@ AstLutMap *astInitLutMap_( void *mem, size_t size, int init,
 *     inc
 *        The lookup table element spacing (i.e. the increment in input
 *        coordinate value between successive lookup table elements).
+*     borrow
+*        If non-zero, the new LutMap uses the supplied "lut" array
+*        directly rather than a copy of it. The caller must then ensure
+*        that the array is not changed or freed until the LutMap, and
+*        any copies of it, have been deleted. A copy is still taken if
+*        the array contains any NaN or infinite values, since these must
+*        be replaced by AST__BAD.
 
 *  Returned Value:
 *     A pointer to the new LutMap.
@@ -2404,13 +2587,26 @@ AstLutMap *astInitLutMap_( void *mem, size_t size, int init,
          new->flagsi = flagsi;
          new->indexi = indexi;
 
-/* Allocate memory and store the lookup table. */
-         new->lut = astStore( NULL, lut, sizeof( double ) * (size_t) nlut );
+/* If the lookup table is to be borrowed, check it contains no NaN
+   values, since these would need to be changed. */
+         for ( ilut = 0; borrow && ilut < nlut; ilut++ ) {
+            if( !astISFINITE( lut[ ilut ] ) ) borrow = 0;
+         }
+
+/* Either use the supplied lookup table, or allocate memory and store a
+   copy of it. */
+         new->borrowed = borrow;
+         if( borrow ) {
+            new->lut = (double *) lut;
+
+         } else {
+            new->lut = astStore( NULL, lut, sizeof( double ) * (size_t) nlut );
 
 /* Replace an NaN values by AST__BAD */
-         p = new->lut;
-         for ( ilut = 0; ilut < nlut; ilut++, p++ ) {
-            if( !astISFINITE(*p) ) *p = AST__BAD;
+            p = new->lut;
+            for ( ilut = 0; ilut < nlut; ilut++, p++ ) {
+               if( !astISFINITE(*p) ) *p = AST__BAD;
+            }
          }
 
 /* Initialise the retained input and output coordinate values. */
@@ -2573,6 +2769,7 @@ AstLutMap *astLoadLutMap_( void *mem, size_t size,
       if ( TestLutEpsilon( new, status ) ) SetLutEpsilon( new, new->lutepsilon, status );
 
 /* Allocate memory to hold the lookup table elements. */
+      new->borrowed = 0;
       new->lut = astMalloc( sizeof( double ) * (size_t) new->nlut );
 
 /* If OK, loop to read each element. */
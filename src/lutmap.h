@@ -108,12 +108,16 @@
 
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
+*     AGT: Agent
 
 *  History:
 *     8-JUL-1997 (RFWS):
 *        Original version.
 *     8-JAN-2003 (DSB):
 *        Added protected astInitLutMapVtab method.
+*     18-OCT-2026 (AGT):
+*        Added protected astBorrowedLutMap constructor, and a "borrow"
+*        argument to astInitLutMap.
 *-
 */
 
@@ -168,6 +172,7 @@ typedef struct AstLutMap {
    int lutinterp;               /* Interpolation method */
    int nlut;                    /* Number of table entries */
    int nluti;                   /* Reduced number of table entries */
+   int borrowed;                /* Is "lut" owned by the caller? */
 } AstLutMap;
 
 /* Virtual function table. */
@@ -226,8 +231,11 @@ AstLutMap *astLutMapId_( int, const double [], double, double, const char *, ...
 
 #if defined(astCLASS)            /* Protected */
 
+/* Constructor that uses the supplied lookup table without copying it. */
+AstLutMap *astBorrowedLutMap_( int, const double [], double, double, const char *, int *, ...);
+
 /* Initialiser. */
-AstLutMap *astInitLutMap_( void *, size_t, int, AstLutMapVtab *, const char *, int, const double *, double, double, int * );
+AstLutMap *astInitLutMap_( void *, size_t, int, AstLutMapVtab *, const char *, int, const double *, double, double, int, int * );
 
 /* Vtab initialiser. */
 void astInitLutMapVtab_( AstLutMapVtab *, const char *, int * );
@@ -287,10 +295,13 @@ void astInitLutMapGlobals_( AstLutMapGlobals * );
 
 #if defined(astCLASS)            /* Protected */
 
+/* Constructor that uses the supplied lookup table without copying it. */
+#define astBorrowedLutMap astINVOKE(F,astBorrowedLutMap_)
+
 /* Initialiser. */
 #define \
-astInitLutMap(mem,size,init,vtab,name,nlut,lut,start,inc) \
-astINVOKE(O,astInitLutMap_(mem,size,init,vtab,name,nlut,lut,start,inc,STATUS_PTR))
+astInitLutMap(mem,size,init,vtab,name,nlut,lut,start,inc,borrow) \
+astINVOKE(O,astInitLutMap_(mem,size,init,vtab,name,nlut,lut,start,inc,borrow,STATUS_PTR))
 
 /* Vtab Initialiser. */
 #define astInitLutMapVtab(vtab,name) astINVOKE(V,astInitLutMapVtab_(vtab,name,STATUS_PTR))
@@ -101,6 +101,7 @@ f     - AST_TRANN: Transform N-dimensional coordinates
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     MBT: Mark Taylor (Starlink)
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     1-FEB-1996 (RFWS):
@@ -428,6 +429,17 @@ f     - AST_TRANN: Transform N-dimensional coordinates
 *        RebinSeq<X>: change calculation of mean weight per input pixel so that
 *        it excludes pixels with zero weight. This will only affect the
 *        decision about which output pixels to set bad due to low weight.
+*     18-OCT-2026 (AGT):
+*        - Changes made to the Invert attribute of a frozen Mapping are now
+*        stored in thread-specific data (see FrozenInvert), so that frozen
+*        Mappings can be used by several threads at once.
+*        - The astTran<X> functions now run inside a scratch memory
+*        context (see astBeginScratch), so that the temporary PointSets
+*        and work arrays they use are re-used rather than being
+*        allocated afresh each time.
+*        - Calls to astTransform, astSimplify, astResample<X>, astRebin<X>
+*        and astRebinSeq<X> are recorded when profiling is enabled (see
+*        the Profile tuning parameter).
 *class--
 */
 
@@ -547,7 +559,10 @@ static int (* parent_equal)( AstObject *, AstObject *, int * );
    globals->Class_Init = 0; \
    globals->GetAttrib_Buff[ 0 ] = 0; \
    globals->Unsimplified_Mapping = NULL; \
-   globals->Rate_Disabled = 0;
+   globals->Rate_Disabled = 0; \
+   globals->Frozen_Map = NULL; \
+   globals->Frozen_Invert = NULL; \
+   globals->Frozen_Nmap = 0;
 
 
 /* Create the function that initialises global data for this module. */
@@ -563,6 +578,22 @@ astMAKE_INITGLOBALS(Mapping)
 #define ratefun_pset2_cache astGLOBAL(Mapping,RateFun_Pset2_Cache)
 #define ratefun_next_slot astGLOBAL(Mapping,RateFun_Next_Slot)
 #define ratefun_pset_size astGLOBAL(Mapping,RateFun_Pset_Size)
+#define frozen_map astGLOBAL(Mapping,Frozen_Map)
+#define frozen_invert astGLOBAL(Mapping,Frozen_Invert)
+#define frozen_nmap astGLOBAL(Mapping,Frozen_Nmap)
+
+/* Macros that get and set the "invert" component of a Mapping. If the
+   Mapping has been frozen, the value used by the current thread is held
+   in thread-specific data. */
+#define INVERT(this) \
+   ( ((AstObject *)(this))->frozen ? FrozenInvert( (this), 0, 0, status ) : \
+                                     (this)->invert )
+#define SET_INVERT(this,value) \
+   if( ((AstObject *)(this))->frozen ) { \
+      (void) FrozenInvert( (this), 1, (value), status ); \
+   } else { \
+      (this)->invert = (value); \
+   }
 
 
 
@@ -589,6 +620,11 @@ static AstPointSet *ratefun_pset2_cache[ RATEFUN_MAX_CACHE ];
 static int ratefun_next_slot;
 static int ratefun_pset_size[ RATEFUN_MAX_CACHE ];
 
+/* Objects cannot be frozen unless thread-safety is needed, so the
+   "invert" component is always accessed directly. */
+#define INVERT(this) ((this)->invert)
+#define SET_INVERT(this,value) (this)->invert = (value);
+
 
 /* Define the class virtual function table and its initialisation flag
    as static variables. */
@@ -711,6 +747,7 @@ static double MapFunction( const MapData *, const double [], int *, int * );
 static double MatrixDet( int, int, const double *, int * );
 static double MaxD( double, double, int * );
 static double NewVertex( const MapData *, int, double, double [], double [], int *, double [], int * );
+static double NumPix( int, const AstDim *, const AstDim *, int * );
 static double Random( long int *, int * );
 static double Rate( AstMapping *, double *, int, int, int * );
 static double UphillSimplex( const MapData *, double, int, const double [], double [], double *, int *, int * );
@@ -750,6 +787,9 @@ static void Dump( AstObject *, AstChannel *, int * );
 static void Gauss( double, const double [], int, double *, int * );
 static void GlobalBounds( MapData *, double *, double *, double [], double [], int * );
 static void Invert( AstMapping *, int * );
+#if defined(THREAD_SAFE)
+static int FrozenInvert( AstMapping *, int, int, int * );
+#endif
 static void MapBox( AstMapping *, const double [], const double [], int, int, double *, double *, double [], double [], int * );
 static void RateFun( AstMapping *, double *, int, int, int, double *, double *, int * );
 static void RebinSection( AstMapping *, const double *, int, const AstDim *, const AstDim *, const void *, const void *, double, DataType, int, const double *, int, const void *, int, const AstDim *, const AstDim *, const AstDim *, const AstDim *, AstDim, void *, void *, double *, int64_t *, int * );
@@ -1376,6 +1416,111 @@ static double FindGradient( AstMapping *map, double *at, int ax1, int ax2,
    return ret;
 }
 
+#if defined(THREAD_SAFE)
+static int FrozenInvert( AstMapping *this, int set, int value, int *status ) {
+/*
+*  Name:
+*     FrozenInvert
+
+*  Purpose:
+*     Get or set the "invert" component of a frozen Mapping.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mapping.h"
+*     int FrozenInvert( AstMapping *this, int set, int value, int *status )
+
+*  Class Membership:
+*     Mapping member function.
+
+*  Description:
+*     A frozen Mapping may be used by several threads at once and so
+*     must not be changed. However, many AST methods change the Invert
+*     attribute of a Mapping temporarily (for instance, a CmpMap sets the
+*     Invert attributes of its component Mappings before transforming
+*     points through them). This function allows each thread to have its
+*     own value for the "invert" component of a frozen Mapping. These
+*     values are stored in thread-specific data, and are removed as soon
+*     as they become equal to the value stored in the Mapping itself.
+
+*  Parameters:
+*     this
+*        Pointer to the frozen Mapping.
+*     set
+*        If non-zero, "value" is stored as the value of the "invert"
+*        component to be used by the current thread. Otherwise, the value
+*        currently used by the current thread is returned.
+*     value
+*        The new value for the "invert" component (0, 1 or CHAR_MAX).
+*        Ignored if "set" is zero.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The value of the "invert" component used by the current thread.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set, but no new value will be stored.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   int i;                        /* Index of Mapping in list */
+   int result;                   /* Returned value */
+
+/* Get a pointer to the thread specific global data structure. Frozen
+   Objects have no "globals" pointer, so this will always be the data
+   for the current thread. */
+   astGET_GLOBALS(NULL);
+
+/* Find the Mapping in the list of frozen Mappings that have a private
+   Invert value in the current thread. */
+   for( i = 0; i < frozen_nmap; i++ ) {
+      if( frozen_map[ i ] == this ) break;
+   }
+
+/* Get the value to return if no new value is being stored. */
+   if( !set ) {
+      result = ( i < frozen_nmap ) ? frozen_invert[ i ] : this->invert;
+
+/* If the new value equals the value stored in the Mapping, remove any
+   private value from the list by moving the last entry into its place. */
+   } else if( value == this->invert ) {
+      if( i < frozen_nmap ) {
+         frozen_nmap--;
+         frozen_map[ i ] = frozen_map[ frozen_nmap ];
+         frozen_invert[ i ] = frozen_invert[ frozen_nmap ];
+      }
+      result = value;
+
+/* Otherwise, add a new entry to the list if required, and store the new
+   private value. */
+   } else {
+      if( i == frozen_nmap && astOK ) {
+         frozen_map = astGrow( frozen_map, i + 1, sizeof( *frozen_map ) );
+         frozen_invert = astGrow( frozen_invert, i + 1,
+                                  sizeof( *frozen_invert ) );
+         if( astOK ) {
+            frozen_map[ i ] = this;
+            frozen_nmap++;
+         }
+      }
+      if( i < frozen_nmap ) {
+         frozen_invert[ i ] = value;
+         result = value;
+      } else {
+         result = this->invert;
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+#endif
+
 static void Gauss( double offset, const double params[], int flags,
                    double *value, int *status ) {
 /*
@@ -8235,6 +8380,58 @@ static AstDim MinI( AstDim a, AstDim b, int *status ) {
    return ( a < b ) ? a : b;
 }
 
+static double NumPix( int ndim, const AstDim *lbnd, const AstDim *ubnd,
+                      int *status ) {
+/*
+*  Name:
+*     NumPix
+
+*  Purpose:
+*     Return the number of pixels in a section of a grid.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "mapping.h"
+*     double NumPix( int ndim, const AstDim *lbnd, const AstDim *ubnd,
+*                    int *status )
+
+*  Class Membership:
+*     Mapping member function.
+
+*  Description:
+*     This function returns the number of pixels in a section of a grid,
+*     as a double so that it cannot overflow. It is used to record the
+*     number of pixels processed when profiling (see astProfileStart).
+
+*  Parameters:
+*     ndim
+*        The number of dimensions.
+*     lbnd
+*        The lower pixel index bounds of the section.
+*     ubnd
+*        The upper pixel index bounds of the section.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of pixels, or zero if the section is empty.
+*/
+
+/* Local Variables: */
+   double result;
+   int i;
+
+/* Form the product of the dimensions of the section. */
+   result = 1.0;
+   for( i = 0; i < ndim; i++ ) {
+      if( ubnd[ i ] < lbnd[ i ] ) return 0.0;
+      result *= (double) ( ubnd[ i ] - lbnd[ i ] + 1 );
+   }
+   return result;
+}
+
 static double NewVertex( const MapData *mapdata, int lo, double scale,
                          double x[], double f[], int *ncall, double xnew[], int *status ) {
 /*
@@ -23206,12 +23403,30 @@ f     performed with the AST_INVERT routine.
 *att--
 */
 /* This ia a boolean value (0 or 1) with a value of CHAR_MAX when
-   undefined but yielding a default of zero. */
-astMAKE_CLEAR(Mapping,Invert,invert,CHAR_MAX)
-astMAKE_GET(Mapping,Invert,int,0,( ( this->invert == CHAR_MAX ) ?
-                                   0 : this->invert ))
-astMAKE_SET(Mapping,Invert,int,invert,(astClearIsSimple(this),(value!=0)))
-astMAKE_TEST(Mapping,Invert,( this->invert != CHAR_MAX ))
+   undefined but yielding a default of zero. The Clear and Set functions
+   are written out in full (rather than using astMAKE_CLEAR and astMAKE_SET)
+   so that frozen Mappings can store the new value in thread-specific
+   data. */
+static void ClearInvert( AstMapping *this, int *status ) {
+   if ( !astOK ) return;
+   SET_INVERT( this, CHAR_MAX )
+}
+void astClearInvert_( AstMapping *this, int *status ) {
+   if ( !astOK ) return;
+   (**astMEMBER(this,Mapping,ClearInvert))( this, status );
+}
+static void SetInvert( AstMapping *this, int value, int *status ) {
+   if ( !astOK ) return;
+   astClearIsSimple( this );
+   SET_INVERT( this, ( value != 0 ) )
+}
+void astSetInvert_( AstMapping *this, int value, int *status ) {
+   if ( !astOK ) return;
+   (**astMEMBER(this,Mapping,SetInvert))( this, value, status );
+}
+astMAKE_GET(Mapping,Invert,int,0,( ( INVERT( this ) == CHAR_MAX ) ?
+                                   0 : INVERT( this ) ))
+astMAKE_TEST(Mapping,Invert,( INVERT( this ) != CHAR_MAX ))
 
 /*
 *att++
@@ -23567,7 +23782,9 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
 
 *  Notes:
 *     - This constructor exists simply to ensure that the "Report"
-*     attribute is cleared in any copy made of a Mapping.
+*     attribute is cleared in any copy made of a Mapping, and that the
+*     copy of a frozen Mapping has the Invert value used by the current
+*     thread.
 */
 
 /* Local Variables: */
@@ -23581,6 +23798,10 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
 
 /* Clear the output Report attribute. */
    out->report = CHAR_MAX;
+
+/* If the input Mapping is frozen, the copy inherits the Invert value
+   used by the current thread. */
+   out->invert = INVERT( (AstMapping *) objin );
 }
 
 /* Destructor. */
@@ -23609,12 +23830,21 @@ static void Delete( AstObject *obj, int *status ) {
 *        Pointer to the inherited status variable.
 
 *  Notes:
-*     - This destructor does nothing and exists only to maintain a
-*     one-to-one correspondence between destructors and copy
-*     constructors.
+*     - This destructor exists only to remove any Invert value stored for
+*     a frozen Mapping by the current thread.
 */
 
-/* Return without action. */
+#if defined(THREAD_SAFE)
+/* Local Variables: */
+   AstMapping *this;             /* Pointer to Mapping */
+
+/* Obtain a pointer to the Mapping. */
+   this = (AstMapping *) obj;
+
+/* Remove any private Invert value stored by the current thread by
+   setting it equal to the value stored in the Mapping. */
+   if( this->object.frozen ) (void) FrozenInvert( this, 1, this->invert, status );
+#endif
 }
 
 /* Dump function. */
@@ -24340,15 +24570,21 @@ AstDim astResample8##X##_( AstMapping *this, int ndim_in, const AstDim *lbnd_in,
                            const AstDim *lbnd_out, const AstDim *ubnd_out, \
                            const AstDim *lbnd, const AstDim *ubnd, Xtype *out, \
                            Xtype *out_var, int *status ) { \
+   AstDim result; \
+   AstProfileCall call; \
    if ( !astOK ) return 0; \
-   return (**astMEMBER(this,Mapping,Resample##X))( this, ndim_in, lbnd_in, \
-                                                   ubnd_in, in, in_var, \
-                                                   interp, finterp, params, \
-                                                   flags, tol, maxpix, \
-                                                   badval, ndim_out, \
-                                                   lbnd_out, ubnd_out, \
-                                                   lbnd, ubnd, \
-                                                   out, out_var, status ); \
+   astProfileStart( &call, "Resample", this, \
+                    NumPix( ndim_out, lbnd, ubnd, status ) ); \
+   result = (**astMEMBER(this,Mapping,Resample##X))( this, ndim_in, lbnd_in, \
+                                                     ubnd_in, in, in_var, \
+                                                     interp, finterp, params, \
+                                                     flags, tol, maxpix, \
+                                                     badval, ndim_out, \
+                                                     lbnd_out, ubnd_out, \
+                                                     lbnd, ubnd, \
+                                                     out, out_var, status ); \
+   astProfileStop( &call ); \
+   return result; \
 }
 #if HAVE_LONG_DOUBLE     /* Not normally implemented */
 MAKE_RESAMPLE8_(LD,long double)
@@ -24469,6 +24705,7 @@ void astRebin4##X##_( AstMapping *this, double wlim, int ndim_in, const int *lbn
    AstDim *ubnd8; \
    AstDim *ubnd_in8; \
    AstDim *ubnd_out8; \
+   AstProfileCall call; \
    int i; \
 \
    if ( !astOK ) return; \
@@ -24495,6 +24732,8 @@ void astRebin4##X##_( AstMapping *this, double wlim, int ndim_in, const int *lbn
          ubnd8[ i ] = (AstDim) ubnd[ i ]; \
       } \
 \
+      astProfileStart( &call, "Rebin", this, \
+                       NumPix( ndim_in, lbnd8, ubnd8, status ) ); \
       (**astMEMBER(this,Mapping,Rebin##X))( this, wlim, ndim_in, lbnd_in8, \
                                          ubnd_in8, in, in_var, \
                                          interp, params, \
@@ -24503,6 +24742,7 @@ void astRebin4##X##_( AstMapping *this, double wlim, int ndim_in, const int *lbn
                                          lbnd_out8, ubnd_out8, \
                                          lbnd8, ubnd8, \
                                          out, out_var, status ); \
+      astProfileStop( &call ); \
    } \
    lbnd_in8 = astFree( lbnd_in8 ); \
    ubnd_in8 = astFree( ubnd_in8 ); \
@@ -24531,7 +24771,10 @@ void astRebin8##X##_( AstMapping *this, double wlim, int ndim_in, const AstDim *
                     const AstDim *lbnd_out, const AstDim *ubnd_out, \
                     const AstDim *lbnd, const AstDim *ubnd, Xtype *out, \
                     Xtype *out_var, int *status ) { \
+   AstProfileCall call; \
    if ( !astOK ) return; \
+   astProfileStart( &call, "Rebin", this, \
+                    NumPix( ndim_in, lbnd, ubnd, status ) ); \
    (**astMEMBER(this,Mapping,Rebin##X))( this, wlim, ndim_in, lbnd_in, \
                                          ubnd_in, in, in_var, \
                                          interp, params, \
@@ -24540,6 +24783,7 @@ void astRebin8##X##_( AstMapping *this, double wlim, int ndim_in, const AstDim *
                                          lbnd_out, ubnd_out, \
                                          lbnd, ubnd, \
                                          out, out_var, status ); \
+   astProfileStop( &call ); \
 }
 #if HAVE_LONG_DOUBLE     /* Not normally implemented */
 MAKE_REBIN_(LD,long double)
@@ -24563,7 +24807,10 @@ void astRebinSeq8##X##_( AstMapping *this, double wlim, int ndim_in, const AstDi
                         const AstDim *lbnd, const AstDim *ubnd, Xtype *out, \
                         Xtype *out_var, double *weights, int64_t *nused, \
                         int *status ) { \
+   AstProfileCall call; \
    if ( !astOK ) return; \
+   astProfileStart( &call, "RebinSeq", this, \
+                    NumPix( ndim_in, lbnd, ubnd, status ) ); \
    (**astMEMBER(this,Mapping,RebinSeq##X))( this, wlim, ndim_in, lbnd_in, \
                                          ubnd_in, in, in_var, \
                                          interp, params, \
@@ -24572,6 +24819,7 @@ void astRebinSeq8##X##_( AstMapping *this, double wlim, int ndim_in, const AstDi
                                          lbnd_out, ubnd_out, \
                                          lbnd, ubnd, out, out_var, \
                                          weights, nused, status ); \
+   astProfileStop( &call ); \
 }
 
 #if HAVE_LONG_DOUBLE     /* Not normally implemented */
@@ -24602,6 +24850,7 @@ void astRebinSeq4##X##_( AstMapping *this, double wlim, int ndim_in, const int *
    AstDim *ubnd8; \
    AstDim *ubnd_in8; \
    AstDim *ubnd_out8; \
+   AstProfileCall call; \
    int i; \
 \
    if ( !astOK ) return; \
@@ -24628,6 +24877,8 @@ void astRebinSeq4##X##_( AstMapping *this, double wlim, int ndim_in, const int *
          ubnd8[ i ] = (AstDim) ubnd[ i ]; \
       } \
 \
+      astProfileStart( &call, "RebinSeq", this, \
+                       NumPix( ndim_in, lbnd8, ubnd8, status ) ); \
       (**astMEMBER(this,Mapping,RebinSeq##X))( this, wlim, ndim_in, lbnd_in8, \
                                          ubnd_in8, in, in_var, \
                                          interp, params, \
@@ -24636,6 +24887,7 @@ void astRebinSeq4##X##_( AstMapping *this, double wlim, int ndim_in, const int *
                                          lbnd_out8, ubnd_out8, \
                                          lbnd8, ubnd8, out, out_var, \
                                          weights, nused, status ); \
+      astProfileStop( &call ); \
    } \
    lbnd_in8 = astFree( lbnd_in8 ); \
    ubnd_in8 = astFree( ubnd_in8 ); \
@@ -24688,8 +24940,10 @@ AstMapping *astRemoveRegions_( AstMapping *this, int *status ) {
 AstMapping *astSimplify_( AstMapping *this, int *status ) {
    AstMapping *result;
    AstErrorContext error_context;
+   AstProfileCall call;
 
    if ( !astOK ) return NULL;
+   astProfileStart( &call, "Simplify", this, 0.0 );
 
 /* If this Mapping has already been simplified, or if it cannot be
    simplified (e.g. because it is a Frame) we just returned a clone
@@ -24737,28 +24991,36 @@ AstMapping *astSimplify_( AstMapping *this, int *status ) {
       result = astClone( this );
    }
 
+   astProfileStop( &call );
    return result;
 }
 
 AstPointSet *astTransform_( AstMapping *this, AstPointSet *in,
                             int forward, AstPointSet *out, int *status ) {
    AstPointSet *result;
+   AstProfileCall call;
    if ( !astOK ) return NULL;
+   astProfileStart( &call, "Transform", this, (double) astGetNpoint( in ) );
    result = (**astMEMBER(this,Mapping,Transform))( this, in, forward, out, status );
    (void) astReplaceNaN( result );
+   astProfileStop( &call );
    return result;
 }
 void astTran18_( AstMapping *this, AstDim npoint, const double xin[],
                  int forward, double xout[], int *status ) {
    if ( !astOK ) return;
+   astBeginScratch;
    (**astMEMBER(this,Mapping,Tran1))( this, npoint, xin, forward, xout, status );
+   astEndScratch;
 }
 void astTran28_( AstMapping *this,
                  AstDim npoint, const double xin[], const double yin[],
                  int forward, double xout[], double yout[], int *status ) {
    if ( !astOK ) return;
+   astBeginScratch;
    (**astMEMBER(this,Mapping,Tran2))( this, npoint, xin, yin,
                                       forward, xout, yout, status );
+   astEndScratch;
 }
 void astTranGrid4_( AstMapping *this, int ncoord_in, const int lbnd[],
                     const int ubnd[], double tol, int maxpix, int forward,
@@ -24776,9 +25038,11 @@ void astTranGrid4_( AstMapping *this, int ncoord_in, const int lbnd[],
          lbnd8[ i ] = (AstDim) lbnd[ i ];
          ubnd8[ i ] = (AstDim) ubnd[ i ];
       }
+      astBeginScratch;
       (**astMEMBER(this,Mapping,TranGrid))( this, ncoord_in, lbnd8, ubnd8,
                                             tol, maxpix, forward, ncoord_out,
                                             outdim, out, status );
+      astEndScratch;
       lbnd8 = astFree( lbnd8 );
       ubnd8 = astFree( ubnd8 );
    }
@@ -24787,25 +25051,31 @@ void astTranGrid8_( AstMapping *this, int ncoord_in, const AstDim lbnd[],
                    const AstDim ubnd[], double tol, int maxpix, int forward,
                    int ncoord_out, AstDim outdim, double *out, int *status ) {
    if ( !astOK ) return;
+   astBeginScratch;
    (**astMEMBER(this,Mapping,TranGrid))( this, ncoord_in, lbnd, ubnd, tol,
                                          maxpix, forward, ncoord_out, outdim,
                                          out, status );
+   astEndScratch;
 }
 void astTranN8_( AstMapping *this, AstDim npoint,
                 int ncoord_in, AstDim indim, const double *in,
                 int forward, int ncoord_out, AstDim outdim, double *out, int *status ) {
    if ( !astOK ) return;
+   astBeginScratch;
    (**astMEMBER(this,Mapping,TranN))( this, npoint,
                                       ncoord_in, indim, in,
                                       forward, ncoord_out, outdim, out, status );
+   astEndScratch;
 }
 void astTranP8_( AstMapping *this, AstDim npoint,
                  int ncoord_in, const double *ptr_in[],
                  int forward, int ncoord_out, double *ptr_out[], int *status ) {
    if ( !astOK ) return;
+   astBeginScratch;
    (**astMEMBER(this,Mapping,TranP))( this, npoint,
                                       ncoord_in, ptr_in,
                                       forward, ncoord_out, ptr_out, status );
+   astEndScratch;
 }
 int astLinearApprox_( AstMapping *this, const double *lbnd,
                        const double *ubnd, double tol, double *fit, int *status ){
@@ -414,31 +414,43 @@ typedef unsigned long long int UINT_BIG;
 #define AST__ALLOW_SIMPLIFY_FLAG 8 /* Nominate Mapping even if Simplify has
                                  been restricted */
 
+/* The flags of a frozen Mapping may be read by several threads at once,
+   so they are left unchanged if the Mapping has been frozen (see
+   astFreeze). */
+
 #define astSetIsSimple(this) \
-((void)(this&&(((AstMapping*)this)->flags|=AST__ISSIMPLE_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags|=AST__ISSIMPLE_FLAG)))
 #define astClearIsSimple(this) \
-((void)(this&&(((AstMapping*)this)->flags&=~AST__ISSIMPLE_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags&=~AST__ISSIMPLE_FLAG)))
 #define astIsSimple(this) \
 (this&&((((AstMapping*)this)->flags&AST__ISSIMPLE_FLAG)!=0))
 
 #define astSetFrozen(this) \
-((void)(this&&(((AstMapping*)this)->flags|=AST__FROZEN_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags|=AST__FROZEN_FLAG)))
 #define astClearFrozen(this) \
-((void)(this&&(((AstMapping*)this)->flags&=~AST__FROZEN_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags&=~AST__FROZEN_FLAG)))
 #define astFrozen(this) \
 (this&&((((AstMapping*)this)->flags&AST__FROZEN_FLAG)!=0))
 
 #define astSetRestrictedSimplify(this) \
-((void)(this&&(((AstMapping*)this)->flags|=AST__RESTRICTED_SIMPLIFY_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags|=AST__RESTRICTED_SIMPLIFY_FLAG)))
 #define astClearRestrictedSimplify(this) \
-((void)(this&&(((AstMapping*)this)->flags&=~AST__RESTRICTED_SIMPLIFY_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags&=~AST__RESTRICTED_SIMPLIFY_FLAG)))
 #define astRestrictedSimplify(this) \
 (this&&((((AstMapping*)this)->flags&AST__RESTRICTED_SIMPLIFY_FLAG)!=0))
 
 #define astSetAllowSimplify(this) \
-((void)(this&&(((AstMapping*)this)->flags|=AST__ALLOW_SIMPLIFY_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags|=AST__ALLOW_SIMPLIFY_FLAG)))
 #define astClearAllowSimplify(this) \
-((void)(this&&(((AstMapping*)this)->flags&=~AST__ALLOW_SIMPLIFY_FLAG)))
+((void)(this&&!((AstObject*)this)->frozen&& \
+        (((AstMapping*)this)->flags&=~AST__ALLOW_SIMPLIFY_FLAG)))
 #define astAllowSimplify(this) \
 (this&&((((AstMapping*)this)->flags&AST__ALLOW_SIMPLIFY_FLAG)!=0))
 
@@ -580,6 +592,9 @@ typedef struct AstMappingGlobals {
    AstPointSet *RateFun_Pset2_Cache[ AST__MAPPING_RATEFUN_MAX_CACHE ];
    int RateFun_Next_Slot;
    int RateFun_Pset_Size[ AST__MAPPING_RATEFUN_MAX_CACHE ];
+   AstMapping **Frozen_Map;
+   char *Frozen_Invert;
+   int Frozen_Nmap;
 } AstMappingGlobals;
 
 #endif
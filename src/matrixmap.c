@@ -55,6 +55,7 @@ f     The MatrixMap class does not define any new routines beyond those
 *  Authors:
 *     DSB: D.S. Berry (Starlink)
 *     RFWS: R.F. Warren-Smith (Starlink)
+*     AGT: Agent
 
 *  History:
 *     9-FEB-1996 (DSB):
@@ -192,6 +193,11 @@ f     The MatrixMap class does not define any new routines beyond those
 *        astMtrGet now has option to return the expanded matrix.
 *     14-AUG-2020 (DSB):
 *        Added argument "order" to astMtrEuler.
+*     18-OCT-2026 (AGT):
+*        Copies of a MatrixMap now share the arrays of matrix elements
+*        with the original MatrixMap, rather than copying them. The
+*        arrays are unshared (see astUnshare) before being modified.
+*        Also, override the astGetObjSize method.
 *class--
 */
 
@@ -238,6 +244,7 @@ f     The MatrixMap class does not define any new routines beyond those
 /* --------------- */
 #include <ctype.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -254,6 +261,7 @@ static const char *Form[3] = { "Full", "Diagonal", "Unit" }; /* Text values
 /* Pointers to parent class methods which are extended by this class. */
 static AstPointSet *(* parent_transform)( AstMapping *, AstPointSet *, int, AstPointSet *, int * );
 static int *(* parent_mapsplit)( AstMapping *, int, const int *, AstMapping **, int * );
+static size_t (* parent_getobjsize)( AstObject *, int * );
 
 
 #ifdef THREAD_SAFE
@@ -308,6 +316,7 @@ static int CanSwap( AstMapping *, AstMapping *, int, int, int *, int * );
 static int Equal( AstObject *, AstObject *, int * );
 static int FindString( int, const char *[], const char *, const char *, const char *, const char *, int * );
 static int GetIsLinear( AstMapping *, int * );
+static size_t GetObjSize( AstObject *, int * );
 static int GetTranForward( AstMapping *, int * );
 static int GetTranInverse( AstMapping *, int * );
 static int IsDiagonal( AstMatrixMap *, int * );
@@ -624,6 +633,7 @@ static void CompressMatrix( AstMatrixMap *this, int *status ){
    int new_inv;                   /* New inverse requied? */
    int next_diag;                 /* Index of next diagonal element */
    int nrow;                      /* No. of rows in forward matrix */
+   ptrdiff_t off;                 /* Offset of element within matrix */
 
 /* Check the global error status. */
    if ( !astOK || !this ) return;
@@ -760,11 +770,16 @@ static void CompressMatrix( AstMatrixMap *this, int *status ){
                          mval <= colmax[ j ] ) {
 
 /* If the element will change value, set a flag indicating that the inverse
-   matrix needs to be re-calculated. */
-                        if( *a != 0.0 ) new_inv = 1;
-
-/* Ensure this element value is zero. */
-                        *a = 0.0;
+   matrix needs to be re-calculated, and set it to zero. The forward
+   matrix may be shared with other MatrixMaps, so first ensure that it
+   is not (see astUnshare). */
+                        if( *a != 0.0 ) {
+                           new_inv = 1;
+                           off = a - this->f_matrix;
+                           this->f_matrix = astUnshare( this->f_matrix );
+                           a = this->f_matrix + off;
+                           if( a ) *a = 0.0;
+                        }
 
                      } else {
                         new_form = FULL;
@@ -1401,6 +1416,9 @@ void astInitMatrixMapVtab_(  AstMatrixMapVtab *vtab, const char *name, int *stat
    object = (AstObjectVtab *) vtab;
    mapping = (AstMappingVtab *) vtab;
 
+   parent_getobjsize = object->GetObjSize;
+   object->GetObjSize = GetObjSize;
+
    parent_transform = mapping->Transform;
    mapping->Transform = Transform;
 
@@ -3855,6 +3873,12 @@ f        when looking along the vector given by AXIS. Note, THETA measures
    compressed form. */
       ExpandMatrix( new, status );
 
+/* The matrices are modified in place below, so ensure they are not
+   shared with any other MatrixMap (e.g. the one from which "new" was
+   copied). */
+      new->f_matrix = astUnshare( new->f_matrix );
+      new->i_matrix = astUnshare( new->i_matrix );
+
 /* Form the 2x2 forward rotation matrix. Theta is the clockwise angle
    of rotation. */
       rotmat[0] = costh;
@@ -3905,6 +3929,8 @@ f        when looking along the vector given by AXIS. Note, THETA measures
 /* Ensure that the MatrixMap is stored in full form rather than
    compressed form. */
       ExpandMatrix( new, status );
+      new->f_matrix = astUnshare( new->f_matrix );
+      new->i_matrix = astUnshare( new->i_matrix );
 
 /* Form commonly used terms in the rotation matrix. */
       as = sinth/axlen;
@@ -4028,6 +4054,11 @@ static AstMatrixMap *MtrZoom( AstMatrixMap *this, double zoom,
    compressed form. */
    ExpandMatrix( new, status );
 
+/* The matrices are scaled in place below, so ensure they are not shared
+   with the MatrixMap from which "new" was copied. */
+   new->f_matrix = astUnshare( new->f_matrix );
+   new->i_matrix = astUnshare( new->i_matrix );
+
 /* Get a pointer to the current forward matrix (taking into account
    the current state of the Mapping inversion flag ). */
    matrix = astGetInvert( new ) ? new->i_matrix : new->f_matrix;
@@ -4873,6 +4904,71 @@ static void SMtrMult( int post, int m, int n, const double *mat1,
 
 }
 
+static size_t GetObjSize( AstObject *this_object, int *status ) {
+/*
+*  Name:
+*     GetObjSize
+
+*  Purpose:
+*     Return the in-memory size of an Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "matrixmap.h"
+*     size_t GetObjSize( AstObject *this, int *status )
+
+*  Class Membership:
+*     MatrixMap member function (over-rides the astGetObjSize protected
+*     method inherited from the parent class).
+
+*  Description:
+*     This function returns the in-memory size of the supplied MatrixMap,
+*     in bytes.
+
+*  Parameters:
+*     this
+*        Pointer to the MatrixMap.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The Object size, in bytes.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstMatrixMap *this;
+   size_t result;
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointers to the MatrixMap structure. */
+   this = (AstMatrixMap *) this_object;
+
+/* Invoke the GetObjSize method inherited from the parent class, and then
+   add on any components of the class structure defined by this class
+   which are stored in dynamically allocated memory. */
+   result = (*parent_getobjsize)( this_object, status );
+
+   result += astTSizeOf( this->f_matrix );
+   result += astTSizeOf( this->i_matrix );
+
+/* If an error occurred, clear the result value. */
+   if ( !astOK ) result = 0;
+
+/* Return the result, */
+   return result;
+}
+
 static int GetTranForward( AstMapping *this, int *status ) {
 /*
 *
@@ -5413,17 +5509,14 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
 *     void
 
 *  Notes:
-*     -  This constructor makes a deep copy, including a copy of the matrix
-*     element values associated with the input MatrixMap.
+*     -  This constructor makes a deep copy, except that the arrays of
+*     matrix element values are shared with the input MatrixMap.
 */
 
 
 /* Local Variables: */
    AstMatrixMap *in;             /* Pointer to input MatrixMap */
    AstMatrixMap *out;            /* Pointer to output MatrixMap */
-   int nel;                      /* No. of elements in the matrix */
-   int nin;                      /* No. of input coordinates */
-   int nout;                     /* No. of output coordinates */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -5444,32 +5537,13 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    stored with it, so do nothing in this case. */
    if( out->form != UNIT ){
 
-/* Obtain the number of stored values in the MatrixMap. This is independant of
-   whether the Mapping has been inverted or not. If the MatrixMap is diagonal,
-   only the diagonal terms are stored. */
-      nin = astGetNin( in );
-      nout = astGetNout( in );
-
-      if( out->form == DIAGONAL ){
-         if( nin < nout ){
-            nel = nin;
-         } else {
-            nel = nout;
-         }
-
-      } else {
-         nel = nin*nout;
-      }
-
-/* Store the forward matrix elements in the output MatrixMap. */
-      out->f_matrix = (double *) astStore( NULL, (void *) in->f_matrix,
-                                           sizeof( double )*(size_t) nel );
-
-/* Store the inverse matrix elements (if defined) in the output
-   MatrixMap. */
+/* The output MatrixMap shares the arrays of forward and inverse (if
+   defined) matrix elements with the input MatrixMap, rather than
+   having copies of them (see astShare). Functions that modify the
+   elements in place must first call astUnshare. */
+      out->f_matrix = (double *) astShare( (void *) in->f_matrix );
       if( in->i_matrix ){
-         out->i_matrix = (double *) astStore( NULL, (void *) in->i_matrix,
-                                              sizeof( double )*(size_t) nel );
+         out->i_matrix = (double *) astShare( (void *) in->i_matrix );
       }
 
 /* If an error has occurred, free the output MatrixMap arrays. */
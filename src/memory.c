@@ -38,6 +38,7 @@
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: D.S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     2-JAN-1996 (RFWS):
@@ -166,6 +167,35 @@
 *     5-OCT-2020 (DSB):
 *        Fix bug in astChrCase - the text was always converted to upper case 
 *        regardless of the value of argument "upper".
+*     18-OCT-2026 (AGT):
+*        - Added astDouble2Chr, which formats a double using the fewest
+*        digits needed to read it back exactly.
+*        - Use strtod within astChr2Double before falling back to astSscanf.
+*        - Cache memory blocks of up to 32 KB in power-of-two size classes
+*        rather than only blocks of up to 300 bytes of exactly the same
+*        size. Blocks that overflow the cache of a thread are moved in
+*        batches to a depot shared by all threads. Added
+*        astMemoryCacheStats.
+*        - Added astBeginScratch and astEndScratch.
+*        - astSscanf returns immediately without invoking sscanf if the
+*        string does not start with the literal text at the start of the
+*        format string.
+*        - Added astShare, astUnshare and astSharedSize, which allow a
+*        block of memory to be shared by several owners and copied only
+*        when one of them needs to modify it. astFree, astRealloc and
+*        astGrow take account of shared memory blocks.
+*        - Added astProfiling, astProfileStart, astProfileStop and
+*        astProfileReport, which record and report the calls made to
+*        profiled functions, and count the memory blocks allocated by
+*        astMalloc and astRealloc.
+*        - Added astProfileStartClass, which allows calls that do not
+*        operate on an Object (such as the creation of internal tables)
+*        to be profiled.
+*     19-OCT-2026 (AGT):
+*        If the MemoryCaching tuning parameter is zero, free the memory
+*        blocks cached within a scratch memory context when the outermost
+*        context ends, and never move them into the shared depot, so that
+*        they are not lost when the thread exits.
 */
 
 /* Configuration results. */
@@ -187,6 +217,29 @@
 /* The maximum number of nested astBeginPM/astEndPM contexts. */
 #define PM_STACK_MAXSIZE 20
 
+/* The number of unused memory blocks in each batch moved between the
+   cache of an individual thread and the shared depot, for size class
+   "cls". Batches hold at most 64 blocks and at most 64 KB. A thread
+   caches at most two batches of blocks in each size class. */
+#define NBATCH(cls) ( ( (cls) < 6 ) ? 64 : ( 4096 >> (cls) ) )
+
+/* The maximum number of batches of unused memory blocks in each size
+   class that can be held in the shared depot. */
+#define MXDEPOT 8
+
+/* Constants and approximations used when finding the shortest decimal
+   representation of a double (see astDouble2Chr). The tables of powers of
+   five hold the 125 most significant bits of each value, in two 64-bit
+   words. POW5_NWORD is the number of 32-bit words needed to hold the
+   largest power of five while the tables are being created. */
+#define POW5_BITS 125
+#define POW5_N 326
+#define POW5_NINV 342
+#define POW5_NWORD 27
+#define POW5BITS(e) ( (int) ( ( (uint32_t) (e)*1217359 ) >> 19 ) + 1 )
+#define LOG10POW2(e) ( (int) ( ( (uint32_t) (e)*78913 ) >> 18 ) )
+#define LOG10POW5(e) ( (int) ( ( (uint32_t) (e)*732923 ) >> 20 ) )
+
 /* Select the appropriate memory management functions. These will be the
    system's malloc, calloc, free and realloc unless AST was configured with
    the "--with-starmem" option, in which case they will be the starmem
@@ -219,9 +272,7 @@
 #include "memory.h"              /* Interface to this module */
 #include "pointset.h"            /* For AST__BAD */
 
-#ifdef MEM_DEBUG
-#include "object.h"              /* For astMakePointer */
-#endif
+#include "object.h"              /* For astMakePointer and astGetClass */
 
 /* Error code definitions. */
 /* ----------------------- */
@@ -236,11 +287,14 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <limits.h>
+#include <stdint.h>
 
 #ifdef THREAD_SAFE
 #include <pthread.h>
 #endif
 
+#include <time.h>
+
 #ifdef MEM_PROFILE
 #include <sys/times.h>
 #endif
@@ -387,6 +441,34 @@
 /* Type Definitions. */
 /* ================= */
 
+/* Structure used to record the calls made to a profiled function (e.g.
+   astTransform) for Objects of a single class, from within a single
+   chain of enclosing profiled calls (see astProfileStart). Together, these
+   structures form a tree rooted at "profile_root". */
+typedef struct AstProfNode {
+   const char *op;            /* Name of the profiled function */
+   const char *class;         /* Class of the Object used */
+   size_t nentry;             /* Number of calls */
+   double npoint;             /* Total number of points processed */
+   double time;               /* Total wall-clock time within calls (s) */
+   size_t nalloc;             /* Total number of memory allocations */
+   struct AstProfNode *parent;/* The node for the enclosing calls */
+   int nchild;                /* Number of child nodes */
+   struct AstProfNode **children;/* Nodes for calls made within these calls */
+} AstProfNode;
+
+/* Structure used to accumulate the totals for each combination of
+   profiled function and class when reporting profiling results. */
+typedef struct AstProfSum {
+   const char *op;            /* Name of the profiled function */
+   const char *class;         /* Class of the Object used */
+   size_t nentry;             /* Number of calls */
+   double npoint;             /* Total number of points processed */
+   double time;               /* Total time, excluding recursive calls */
+   double self;               /* Time not spent within profiled sub-calls */
+   size_t nalloc;             /* Allocations, excluding recursive calls */
+} AstProfSum;
+
 #ifdef MEM_PROFILE
 
 /* Structure used to record the time spent between matching calls to
@@ -487,12 +569,27 @@ static pthread_mutex_t mutex2 = PTHREAD_MUTEX_INITIALIZER;
 #define cache astGLOBAL(Memory,Cache)
 #define cache_init astGLOBAL(Memory,Cache_Init)
 #define use_cache astGLOBAL(Memory,Use_Cache)
+#define cache_count astGLOBAL(Memory,Cache_Count)
+#define cache_hits astGLOBAL(Memory,Cache_Hits)
+#define cache_misses astGLOBAL(Memory,Cache_Misses)
+#define scratch_depth astGLOBAL(Memory,Scratch_Depth)
+#define shared_size astGLOBAL(Memory,Shared_Size)
+#define alloc_count astGLOBAL(Memory,Alloc_Count)
+#define profile_current astGLOBAL(Memory,Profile_Current)
+#define profile_thread_epoch astGLOBAL(Memory,Profile_Epoch)
 
 /* Define the initial values for the global data for this module. */
 #define GLOBAL_inits \
    globals->Sizeof_Memory = 0; \
    globals->Cache_Init = 0; \
    globals->Use_Cache = 0; \
+   globals->Cache_Hits = 0; \
+   globals->Cache_Misses = 0; \
+   globals->Scratch_Depth = 0; \
+   globals->Shared_Size = 0; \
+   globals->Alloc_Count = 0; \
+   globals->Profile_Current = NULL; \
+   globals->Profile_Epoch = 0; \
 
 /* Create the global initialisation function. */
 astMAKE_INITGLOBALS(Memory)
@@ -511,12 +608,41 @@ static size_t sizeof_memory = 0;
    allocate small blocks of memory. The vast majority of memory blocks
    allocated by AST are under 200 bytes in size. Each element in this array
    stores a pointer to the header for a free (i.e. allocated but currently
-   unused) memory block. The size of the memory block (not including the
-   Memory header) will equal the index at which the pointer is stored within
-   "cache". Each free memory block contains (in its Memory header) a pointer
-   to the header for another free memory block of the same size (or a NULL
-   pointer if there are no other free memory blocks of the same size). */
-static Memory *cache[ MXCSIZE + 1 ];
+   unused) memory block. The usable size of the memory block (not including
+   the Memory header) is determined by the size class given by the index at
+   which the pointer is stored within "cache" (see MNCSIZE). Each free
+   memory block contains (in its Memory header) a pointer to the header for
+   another free memory block in the same size class (or a NULL pointer if
+   there are no other free memory blocks in the same size class). */
+static Memory *cache[ NCSIZE ];
+
+/* The number of memory blocks in each element of "cache". */
+static int cache_count[ NCSIZE ];
+
+/* The number of memory allocations since the statistics were last reset
+   that were, and were not, satisfied from the cache (see
+   astMemoryCacheStats). */
+static size_t cache_hits = 0;
+static size_t cache_misses = 0;
+
+/* The number of nested scratch memory contexts that are currently active
+   (see astBeginScratch). */
+static int scratch_depth = 0;
+
+/* The total size of the shared memory blocks found by astTSizeOf since
+   the total was last reset (see astSharedSize). */
+static size_t shared_size = 0;
+
+/* The number of memory blocks allocated by astMalloc and astRealloc,
+   used to find the number of allocations made by each profiled call (see
+   astProfileStart). */
+static size_t alloc_count = 0;
+
+/* The node in the profiling call tree for the innermost profiled call
+   that is currently active, and the profiling epoch in which it was
+   started (see astProfileStart). */
+static void *profile_current = NULL;
+static int profile_thread_epoch = 0;
 
 /* Has the "cache" array been initialised? */
 static int cache_init = 0;
@@ -526,12 +652,116 @@ static int use_cache = 0;
 
 #endif
 
+/* A depot holding batches of unused memory blocks that have overflowed
+   the cache of a thread (see astFree). It is shared by all threads, so
+   that memory blocks freed by one thread can be re-used by another. Each
+   batch contains NBATCH blocks, linked together through the "next"
+   component of their Memory headers. The batches in each size class form
+   a stack, with each batch linked to the next through a pointer stored at
+   the start of the data area of its first block. */
+static Memory *depot[ NCSIZE ];
+
+/* The number of batches in each element of "depot". */
+static int depot_count[ NCSIZE ];
+
+#ifdef THREAD_SAFE
+static pthread_mutex_t mutex3 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_DEPOT_MUTEX pthread_mutex_lock( &mutex3 );
+#define UNLOCK_DEPOT_MUTEX pthread_mutex_unlock( &mutex3 );
+#else
+#define LOCK_DEPOT_MUTEX
+#define UNLOCK_DEPOT_MUTEX
+#endif
+
+/* Macros for accessing the number of owners of a memory block. A memory
+   block may be shared by several owners (see astShare), each of which
+   may be used by a different thread. If C11 atomics are available, the
+   number of owners is held in an atomic integer. Otherwise, it is changed
+   by the ChangeNref function, which locks a mutex if thread-safety is
+   required. In either case, a value of one can be read without any
+   locking, since only the one owner can then change it. */
+#if defined(AST__ATOMIC)
+#define INIT_NREF(mem) atomic_init(&((mem)->nref),1)
+#define CHANGE_NREF(mem,delta) (atomic_fetch_add(&((mem)->nref),(delta))+(delta))
+#define GET_NREF(mem) atomic_load(&((mem)->nref))
+#else
+#define INIT_NREF(mem) ((mem)->nref=1)
+#define CHANGE_NREF(mem,delta) ChangeNref(mem,delta)
+#define GET_NREF(mem) ((mem)->nref)
+#ifdef THREAD_SAFE
+static pthread_mutex_t mutex4 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_NREF_MUTEX pthread_mutex_lock( &mutex4 );
+#define UNLOCK_NREF_MUTEX pthread_mutex_unlock( &mutex4 );
+#else
+#define LOCK_NREF_MUTEX
+#define UNLOCK_NREF_MUTEX
+#endif
+#endif
+
+/* The root of the profiling call tree (see astProfileStart), and the
+   current profiling epoch. The epoch is incremented each time the tree
+   is discarded, so that profiled calls that started before it was
+   discarded can be recognised. These are shared by all threads, and
+   should only be accessed while the profile mutex is locked. A separate
+   flag indicates if profiling is currently enabled. This is read by
+   every profiled call without locking the mutex, so it is held in an
+   atomic integer if possible. */
+static AstProfNode *profile_root = NULL;
+static int profile_epoch = 0;
+#if defined(AST__ATOMIC)
+static atomic_int profiling = 0;
+#define GET_PROFILING atomic_load_explicit(&profiling,memory_order_relaxed)
+#define SET_PROFILING(value) atomic_store(&profiling,value)
+#else
+static int profiling = 0;
+#define GET_PROFILING profiling
+#define SET_PROFILING(value) (profiling=(value))
+#endif
+
+#ifdef THREAD_SAFE
+static pthread_mutex_t mutex5 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_PROFILE_MUTEX pthread_mutex_lock( &mutex5 );
+#define UNLOCK_PROFILE_MUTEX pthread_mutex_unlock( &mutex5 );
+#else
+#define LOCK_PROFILE_MUTEX
+#define UNLOCK_PROFILE_MUTEX
+#endif
+
+/* Tables of powers of five, and of their reciprocals, used by
+   astDouble2Chr. These are created by MakePow5Tables when first needed,
+   and are read-only thereafter, so they can be shared by all threads. */
+static uint64_t pow5_split[ POW5_N ][ 2 ];
+static uint64_t pow5_inv_split[ POW5_NINV ][ 2 ];
+#ifdef THREAD_SAFE
+static pthread_once_t pow5_once = PTHREAD_ONCE_INIT;
+#else
+static int pow5_init = 0;
+#endif
+
 /* Prototypes for Private Functions. */
 /* ================================= */
 static size_t SizeOfMemory( int * );
+#if !defined(AST__ATOMIC)
+static int ChangeNref( Memory *, int );
+#endif
+static int SizeClass( size_t );
+static AstProfNode *NewProfNode( AstProfNode *, const char *, const char * );
+static void FreeProfNode( AstProfNode * );
+static double ProfileTime( void );
+static void ReportProfNode( FILE *, AstProfNode *, int, int * );
+static void JsonProfNode( FILE *, AstProfNode *, double, int *, int * );
+static void SumProfNode( AstProfNode *, AstProfSum **, int *, int * );
+static int CompareProfSums( const void *, const void * );
+static void GetBatch( int, int * );
+static void PutBatch( int, int * );
 static char *CheckTempStart( const char *, const char *, const char *, char *, int *, int *, int *, int *, int *, int *, int *, int * );
 static char *ChrMatcher( const char *, const char *, const char *, const char *, const char *[], int, int, int, char ***, int *, const char **, int * );
 static char *ChrSuber( const char *, const char *, const char *[], int, int, char ***, int *, const char **, int * );
+static int Pow5Factor( uint64_t );
+static uint64_t MulShift64( uint64_t, const uint64_t *, int );
+static void MakePow5Tables( void );
+static void ShortestDigits( uint64_t, int, uint64_t *, int * );
+static void UMul128( uint64_t, uint64_t, uint64_t *, uint64_t * );
 
 #ifdef MEM_DEBUG
 static void Issue( Memory *, int * );
@@ -784,6 +1014,71 @@ char *astAppendStringf_( char *str1, int *nc, const char *str2, ... ) {
    return result;
 }
 
+void astBeginScratch_( int *status ) {
+/*
+*+
+*  Name:
+*     astBeginScratch
+
+*  Purpose:
+*     Begin a new context for scratch memory.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     astBeginScratch
+
+*  Description:
+*     This function begins a new context for scratch memory. Between
+*     this call and the matching call to astEndScratch, small memory
+*     blocks are allocated from, and freed into, the cache of unused
+*     memory blocks (see astMemCaching) even if the MemoryCaching tuning
+*     parameter is zero. In that case, the blocks held in the cache are
+*     freed when the outermost context ends, and blocks are never moved
+*     into the depot shared by all threads, so no memory is retained
+*     once the context has ended. If the MemoryCaching tuning parameter
+*     is non-zero, blocks freed within the context remain in the cache
+*     in the usual way.
+*
+*     It is intended to be used around functions, such as the public
+*     astTran<X> functions, that create and destroy many short-lived
+*     Objects and arrays (PointSets, work arrays, etc), so that memory
+*     freed by one part of the function can be re-used by another part
+*     without using the system's memory allocator. Memory blocks that
+*     are still in use when the context ends are not affected.
+*
+*     Contexts may be nested. Each thread has its own contexts.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*     - Each call to this function must be matched by a call to
+*     astEndScratch.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS
+   int i;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* If the cache has not yet been used by this thread, initialise it. */
+   if( !cache_init ) {
+      for( i = 0; i < NCSIZE; i++ ) {
+         cache[ i ] = NULL;
+         cache_count[ i ] = 0;
+      }
+      cache_init = 1;
+   }
+
+/* Increment the depth of nested scratch memory contexts. */
+   scratch_depth++;
+}
+
 int astBrackets_( const char *text, size_t start, size_t end,
                   char opchar, char clchar, int strip,
                   size_t *openat, size_t *closeat, char **before,
@@ -1004,6 +1299,53 @@ int astBrackets_( const char *text, size_t start, size_t end,
    return result;
 }
 
+#if !defined(AST__ATOMIC)
+static int ChangeNref( Memory *mem, int delta ) {
+/*
+*  Name:
+*     ChangeNref
+
+*  Purpose:
+*     Change the number of owners of a memory block.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     int ChangeNref( Memory *mem, int delta )
+
+*  Description:
+*     This function adds a given increment to the number of owners
+*     stored in the header of a memory block, locking a mutex while it
+*     does so if thread-safety is required. It is used only if C11
+*     atomics are not available.
+
+*  Parameters:
+*     mem
+*        Pointer to the memory header.
+*     delta
+*        The increment to add to the number of owners.
+
+*  Returned Value:
+*     The new number of owners.
+
+*  Notes:
+*     - This function does not perform error checking.
+*/
+
+/* Local Variables: */
+   int result;                   /* Returned value */
+
+/* Change the number of owners and return the new value. */
+   LOCK_NREF_MUTEX
+   mem->nref += delta;
+   result = mem->nref;
+   UNLOCK_NREF_MUTEX
+   return result;
+}
+#endif
+
 void *astCalloc_( size_t nmemb, size_t size, int *status ) {
 /*
 *++
@@ -1364,6 +1706,7 @@ double astChr2Double_( const char *str, int *status ) {
 */
 
 /* Local Variables: */
+   char *end;         /* Pointer to first character not read by strtod */
    double result;     /* The returned value */
    int ival;          /* Integer value read from string */
    int len;           /* Length of supplied string */
@@ -1375,6 +1718,15 @@ double astChr2Double_( const char *str, int *status ) {
 /* Save the length of the supplied string. */
    len = strlen( str );
 
+/* Most strings are simple numerical values, so first use strtod, which is
+   much faster than astSscanf. Accept the value if nothing but white space
+   follows it. */
+   result = strtod( str, &end );
+   if( end != str ) {
+      while( isspace( (int) *end ) ) end++;
+      if( !*end ) return result;
+   }
+
 /* Use scanf to read the floating point value. This fails if either 1) the
    string does not begin with a numerical value (in which case astSscanf
    returns zero), or 2) there are non-white characters following the
@@ -2398,6 +2750,219 @@ void astChrTrunc_( char *text, int *status ){
    text[ astChrLen( text ) ] = 0;
 }
 
+int astDouble2Chr_( double value, int prec, char *buf, int *status ) {
+/*
+*++
+*  Name:
+*     astDouble2Chr
+
+*  Purpose:
+*     Format a double value using the fewest digits that read back exactly.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     int astDouble2Chr( double value, int prec, char *buf )
+
+*  Description:
+*     This function formats a double value in the same way as the C
+*     "printf" conversion "%.*g" (with the precision given by "prec"),
+*     except that the smallest number of significant digits that will
+*     allow the string to be read back to give exactly the same value
+*     is used. Thus, 0.1 is formatted as "0.1" rather than
+*     "0.10000000000000001". The choice between fixed and exponential
+*     notation is made exactly as "%.*g" would make it, and the result
+*     is identical to that produced by "%.*g" whenever all "prec"
+*     digits are needed to represent the value exactly.
+*
+*     The digits are found directly from the binary representation of
+*     the value using the "Ryu" algorithm (Adams, 2018, ACM SIGPLAN
+*     Notices, 53, 270), rather than by formatting the value
+*     repeatedly at increasing precision.
+
+*  Parameters:
+*     value
+*        The value to format.
+*     prec
+*        The maximum number of significant digits to use. If more than
+*        "prec" digits are needed to represent the value exactly, the
+*        value is formatted using "%.*g" with precision "prec". A value
+*        of 17 or more ensures the value is always represented exactly.
+*     buf
+*        Pointer to a buffer in which to return the null-terminated
+*        formatted string. It should be at least "prec+8" characters
+*        long (14 characters if "prec" is negative).
+
+*  Returned Value:
+*     astDouble2Chr()
+*       The number of characters written to the buffer, excluding the
+*       terminating null.
+
+*  Notes:
+*     -  Infinite and NaN values are formatted by "%.*g".
+*     -  A value of zero is returned if this function is invoked with
+*     the global error status set.
+*--
+*/
+
+/* Local Variables: */
+   char digits[ 20 ];       /* Significant decimal digits */
+   char *p;                 /* Pointer to next character in buffer */
+   int dexp;                /* Power of ten of the last digit */
+   int i;                   /* Digit index */
+   int nd;                  /* Number of significant digits */
+   int xexp;                /* Power of ten of the first digit */
+   uint64_t bits;           /* The bits in the supplied value */
+   uint64_t mant;           /* Decimal mantissa */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Negative and zero precisions are handled as by printf. */
+   if( prec < 0 ) {
+      prec = 6;
+   } else if( prec == 0 ) {
+      prec = 1;
+   }
+
+/* Get the bits in the value. */
+   memcpy( &bits, &value, sizeof( bits ) );
+
+/* Infinities and NaNs have all exponent bits set. Let printf format
+   them. */
+   if( ( ( bits >> 52 ) & 0x7ff ) == 0x7ff ) {
+      return sprintf( buf, "%.*g", prec, value );
+   }
+
+/* Store any minus sign. */
+   p = buf;
+   if( bits >> 63 ) *(p++) = '-';
+
+/* Zero (positive or negative) has no significant digits. */
+   if( !( bits & ( ( (uint64_t) 1 << 63 ) - 1 ) ) ) {
+      *(p++) = '0';
+      *p = 0;
+      return p - buf;
+   }
+
+/* Get the shortest decimal mantissa that reads back as the supplied
+   value, and the corresponding power of ten. */
+   ShortestDigits( bits & ( ( (uint64_t) 1 << 52 ) - 1 ),
+                   (int) ( ( bits >> 52 ) & 0x7ff ), &mant, &dexp );
+
+/* Remove any trailing zeros from the mantissa. */
+   while( mant % 10 == 0 ) {
+      mant /= 10;
+      dexp++;
+   }
+
+/* Convert the mantissa to a string of decimal digits, filling the buffer
+   from the end. The mantissa is never zero here, so at least one digit
+   is produced, but initialise the first digit anyway so that it is never
+   used uninitialised. */
+   digits[ 0 ] = '0';
+   i = sizeof( digits );
+   while( mant ) {
+      digits[ --i ] = '0' + (int)( mant % 10 );
+      mant /= 10;
+   }
+   nd = sizeof( digits ) - i;
+   memmove( digits, digits + i, nd );
+
+/* If more digits are needed than are allowed, use printf to round the
+   value to the requested number of digits. */
+   if( nd > prec ) return sprintf( buf, "%.*g", prec, value );
+
+/* Get the power of ten of the first significant digit. */
+   xexp = dexp + nd - 1;
+
+/* Use exponential notation in the same situations as "%g" would. Any
+   fractional digits follow the first digit, and the exponent has a sign
+   and at least two digits. */
+   if( xexp < -4 || xexp >= prec ) {
+      *(p++) = digits[ 0 ];
+      if( nd > 1 ) {
+         *(p++) = '.';
+         memcpy( p, digits + 1, nd - 1 );
+         p += nd - 1;
+      }
+      p += sprintf( p, "e%c%02d", ( xexp < 0 ) ? '-' : '+', abs( xexp ) );
+
+/* Otherwise, use fixed notation. First handle values of one or more. Pad
+   the integer part with zeros if necessary. */
+   } else if( xexp >= 0 ) {
+      for( i = 0; i <= xexp; i++ ) *(p++) = ( i < nd ) ? digits[ i ] : '0';
+      if( nd > xexp + 1 ) {
+         *(p++) = '.';
+         memcpy( p, digits + xexp + 1, nd - xexp - 1 );
+         p += nd - xexp - 1;
+      }
+
+/* Now handle values less than one. */
+   } else {
+      *(p++) = '0';
+      *(p++) = '.';
+      for( i = xexp + 1; i < 0; i++ ) *(p++) = '0';
+      memcpy( p, digits, nd );
+      p += nd;
+   }
+
+/* Terminate the string and return its length. */
+   *p = 0;
+   return p - buf;
+}
+
+void astEndScratch_( int *status ) {
+/*
+*+
+*  Name:
+*     astEndScratch
+
+*  Purpose:
+*     End a context for scratch memory.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     astEndScratch
+
+*  Description:
+*     This function ends a context for scratch memory begun by a
+*     matching call to astBeginScratch.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS
+   Memory *mem;
+   int i;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Decrement the depth of nested scratch memory contexts. If the outermost
+   context has ended and memory caching is switched off, the cache holds
+   only blocks freed within the context, so free them all now. */
+   if( scratch_depth > 0 && --scratch_depth == 0 && !use_cache ) {
+      for( i = 0; i < NCSIZE; i++ ) {
+         while( cache[ i ] ) {
+            mem = cache[ i ];
+            cache[ i ] = mem->next;
+            FREE( mem );
+         }
+         cache_count[ i ] = 0;
+      }
+   }
+}
+
 void astFandl_( const char *text, size_t start, size_t end,
                 size_t *f, size_t *l, int *status ){
 /*
@@ -2535,12 +3100,18 @@ void *astFree_( void *ptr, int *status ) {
 *     astFree()
 *        Always returns a NULL pointer.
 
+*  Notes:
+*     - If the memory is shared (see astShare), it is not freed. Instead,
+*     the number of owners of the memory is decremented. The memory is
+*     freed when its last owner frees it.
+
 *--
 */
 
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
    Memory *mem;                  /* Pointer to memory header */
+   int cls;                      /* Size class of the memory block */
    int isdynamic;                /* Is the memory dynamically allocated? */
    size_t size;                  /* The usable size of the memory block */
 
@@ -2560,21 +3131,36 @@ void *astFree_( void *ptr, int *status ) {
 /* If OK, obtain a pointer to the memory header. */
       mem = (Memory *) ( (char *) ptr - SIZEOF_MEMORY );
 
+/* If the memory block is shared with other owners, just reduce the
+   number of owners. Otherwise, the caller is the only owner, so free
+   the memory block. */
+      if( GET_NREF( mem ) > 1 && CHANGE_NREF( mem, -1 ) > 0 ) return NULL;
+
 #ifdef MEM_DEBUG
       DeIssue( mem, status );
 #endif
 
-/* If the memory block is small enough, and the cache is being used, put it
-   into the cache rather than freeing it, so that it can be reused. */
+/* If the memory block is small enough, and the cache is being used (or
+   a scratch memory context is active), put it into the cache rather than
+   freeing it, so that it can be reused. Within a scratch memory context,
+   blocks are only cached if there is room for them in the cache of the
+   current thread, since they must not be moved to the shared depot
+   unless caching has been switched on. */
       size = mem->size;
-      if( use_cache && size <= MXCSIZE ) {
-         mem->next = cache[ size ];
-         cache[ size ] = mem;
+      cls = ( size <= MXCSIZE ) ? SizeClass( size ) : -1;
+      if( cls >= 0 && ( use_cache || ( scratch_depth &&
+                        cache_count[ cls ] < 2*NBATCH( cls ) ) ) ) {
+         mem->next = cache[ cls ];
+         cache[ cls ] = mem;
 
 /* Set the size to zero to indicate that the memory block has been freed.
    The size of the block is implied by the Cache element it is stored in. */
          mem->size = (size_t) 0;
 
+/* If the cache now holds too many blocks in this size class, move a
+   batch of them to the shared depot. */
+         if( ++cache_count[ cls ] > 2*NBATCH( cls ) ) PutBatch( cls, status );
+
 /* Simply free other memory blocks, clearing the "magic number" and size
    values it contains. This helps prevent accidental re-use of the memory. */
       } else {
@@ -2672,6 +3258,58 @@ void *astFreeDouble_( void *ptr, int *status ) {
    return NULL;
 }
 
+static void GetBatch( int cls, int *status ) {
+/*
+*  Name:
+*     GetBatch
+
+*  Purpose:
+*     Move a batch of unused memory blocks from the depot to the cache.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void GetBatch( int cls, int *status )
+
+*  Description:
+*     This function removes a batch of unused memory blocks in a given
+*     size class from the depot shared by all threads, and stores them
+*     in the cache of the currently executing thread. The cache should
+*     contain no blocks in the size class when this function is called.
+*     Nothing is done if the depot contains no blocks in the size class.
+
+*  Parameters:
+*     cls
+*        The size class.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   Memory *batch;                /* Pointer to first block in batch */
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Remove the batch from the top of the stack of batches held in the
+   depot. */
+   LOCK_DEPOT_MUTEX;
+   batch = depot[ cls ];
+   if( batch ) {
+      depot[ cls ] = *( (Memory **) ( (char *) batch + SIZEOF_MEMORY ) );
+      depot_count[ cls ]--;
+   }
+   UNLOCK_DEPOT_MUTEX;
+
+/* Store the blocks in the cache. */
+   if( batch ) {
+      cache[ cls ] = batch;
+      cache_count[ cls ] = NBATCH( cls );
+   }
+}
+
 void *astGrow_( void *ptr, size_t n, size_t size, int *status ) {
 /*
 *++
@@ -2721,6 +3359,8 @@ void *astGrow_( void *ptr, size_t n, size_t size, int *status ) {
 *     - If this function is invoked with the global error status set,
 *     or if it fails for any reason, the original pointer value is
 *     returned and the memory contents are unchanged.
+*     - If the supplied memory is shared (see astShare), the returned
+*     pointer identifies memory that is owned only by the caller.
 *--
 */
 
@@ -2766,6 +3406,11 @@ void *astGrow_( void *ptr, size_t n, size_t size, int *status ) {
 
 /* Re-allocate the memory. */
             new = astRealloc( ptr, newsize );
+
+/* If the memory is big enough but is shared with other owners, take a
+   private copy of it, since the caller will probably modify it. */
+         } else if( GET_NREF( mem ) > 1 ) {
+            new = astUnshare( ptr );
          }
       }
    }
@@ -2892,6 +3537,8 @@ void *astMalloc_( size_t size, int init, int *status ) {
    char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
    char *errstat;                /* Pointer to system error message */
    Memory *mem;                  /* Pointer to space allocated by malloc */
+   int cls;                      /* Size class of the memory block */
+   size_t asize;                 /* Usable size of the memory block */
    void *result;                 /* Returned pointer */
 
 /* Initialise. */
@@ -2908,13 +3555,40 @@ void *astMalloc_( size_t size, int init, int *status ) {
    to allocate the memory, including space for the header structure. */
    if ( size > (size_t ) 0 ) {
 
-/* If the cache is being used and a cached memory block of the required size
-   is available, remove it from the cache array and use it. */
-      mem = ( use_cache && size <= MXCSIZE ) ? cache[ size ] : NULL;
+/* Small memory blocks are allocated with the usable size of the smallest
+   size class that can hold the requested size, so that they can be
+   cached when freed. */
+      mem = NULL;
+      if( size <= MXCSIZE ) {
+         cls = SizeClass( size );
+         asize = MNCSIZE << cls;
+
+/* If the cache is being used (or a scratch memory context is active),
+   get a memory block in the required size class from the cache, first
+   moving a batch of blocks into the cache from the shared depot if the
+   cache is empty. */
+         if( use_cache || scratch_depth ) {
+            if( !cache[ cls ] ) GetBatch( cls, status );
+            mem = cache[ cls ];
+            if( mem ) {
+               cache[ cls ] = mem->next;
+               cache_count[ cls ]--;
+               cache_hits++;
+            } else {
+               cache_misses++;
+            }
+         }
+      } else {
+         asize = size;
+      }
+
+/* If a cached memory block is available, set up its header for the new
+   size. */
       if( mem ) {
-         cache[ size ] = mem->next;
          mem->next = NULL;
+         mem->magic = MAGIC( mem, size );
          mem->size = (size_t) size;
+         INIT_NREF( mem );
 
 /* Initialise the memory (but not the header) if required. */
          if( init ) (void) memset( (char *) mem + SIZEOF_MEMORY, 0, size );
@@ -2922,9 +3596,9 @@ void *astMalloc_( size_t size, int init, int *status ) {
 /* Otherwise, allocate a new memory block using "malloc" or "calloc". */
       } else {
          if( init ) {
-            mem = CALLOC( 1, SIZEOF_MEMORY + size );
+            mem = CALLOC( 1, SIZEOF_MEMORY + asize );
          } else {
-            mem = MALLOC( SIZEOF_MEMORY + size );
+            mem = MALLOC( SIZEOF_MEMORY + asize );
          }
 
 /* Report an error if malloc failed. */
@@ -2946,6 +3620,7 @@ void *astMalloc_( size_t size, int init, int *status ) {
             mem->magic = MAGIC( mem, size );
             mem->size = size;
             mem->next = NULL;
+            INIT_NREF( mem );
 
 #ifdef MEM_DEBUG
             mem->id = -1;
@@ -2962,6 +3637,9 @@ void *astMalloc_( size_t size, int init, int *status ) {
       Issue( mem, status );
 #endif
 
+/* Count the allocation (used when profiling - see astProfileStart). */
+         alloc_count++;
+
 /* Increment the memory pointer to the start of the region of
    allocated memory to be used by the caller.*/
          result = mem;
@@ -3482,7 +4160,9 @@ int astMemCaching_( int newval, int *status ){
 *     current contents of the cache are discarded.
 *
 *     Note, each thread has a separate cache. Calling this function
-*     affects only the currently executing thread.
+*     affects only the currently executing thread, except that any unused
+*     memory blocks that have overflowed from the caches of other threads
+*     into the shared depot are also freed.
 
 *  Parameters:
 *     newval
@@ -3501,6 +4181,7 @@ int astMemCaching_( int newval, int *status ){
    astDECLARE_GLOBALS
    int i;
    int result;
+   Memory *batch;
    Memory *mem;
 
 #ifdef MEM_DEBUG
@@ -3520,23 +4201,19 @@ int astMemCaching_( int newval, int *status ){
 /* If a new value is to be set. */
    if( newval != AST__TUNULL ) {
 
-/* If the cache has been initialised, empty it. */
+/* If the cache has been initialised, empty it. The shared depot is also
+   emptied, so lock the mutex that serialises access to it. */
       if( cache_init ) {
+         LOCK_DEPOT_MUTEX;
 
 /* If we are listing the ID of every memory block in the cache, count the
    number of blocks in the cache and then allocate an array to store the ID
    values in. This is done so that we can sort them before displaying them. */
 #ifdef MEM_DEBUG
          if( List_Cache ) {
-            Memory *next;
-
             id_list_size = 0;
-            for( i = 0; i <= MXCSIZE; i++ ) {
-               next = cache[ i ];
-               while( next ) {
-                  id_list_size++;
-                  next = next->next;
-               }
+            for( i = 0; i < NCSIZE; i++ ) {
+               id_list_size += cache_count[ i ] + depot_count[ i ]*NBATCH( i );
             }
 
             id_list = MALLOC( sizeof(int)*id_list_size );
@@ -3552,21 +4229,35 @@ int astMemCaching_( int newval, int *status ){
          }
 #endif
 
-         for( i = 0; i <= MXCSIZE; i++ ) {
-            while( cache[ i ] ) {
-               mem = cache[ i ];
-               cache[ i ] = mem->next;
-               mem->size = (size_t) i;
+         for( i = 0; i < NCSIZE; i++ ) {
+
+/* Move each batch in the depot into the cache, and then free all the
+   memory blocks in the cache. */
+            do {
+               while( cache[ i ] ) {
+                  mem = cache[ i ];
+                  cache[ i ] = mem->next;
 
 #ifdef MEM_DEBUG
-               if( id_list ) {
-                  id_list[ id_list_size++ ] = mem->id;
-               }
+                  if( id_list ) {
+                     id_list[ id_list_size++ ] = mem->id;
+                  }
 #endif
 
-               FREE( mem );
-            }
+                  FREE( mem );
+               }
+
+               batch = depot[ i ];
+               if( batch ) {
+                  depot[ i ] = *( (Memory **) ( (char *) batch + SIZEOF_MEMORY ) );
+                  depot_count[ i ]--;
+                  cache[ i ] = batch;
+               }
+            } while( batch );
+
+            cache_count[ i ] = 0;
          }
+         UNLOCK_DEPOT_MUTEX;
 
 /* If we are displaying the IDs of memory blocks still in the cache, sort
    them using a bubblesort algorithm, then display them. */
@@ -3605,7 +4296,10 @@ int astMemCaching_( int newval, int *status ){
 /* Otherwise, initialise the cache array to hold a NULL pointer at every
    element. */
       } else {
-         for( i = 0; i <= MXCSIZE; i++ ) cache[ i ] = NULL;
+         for( i = 0; i < NCSIZE; i++ ) {
+            cache[ i ] = NULL;
+            cache_count[ i ] = 0;
+         }
          cache_init = 1;
       }
 
@@ -3618,49 +4312,1301 @@ int astMemCaching_( int newval, int *status ){
    return result;
 }
 
-void *astRealloc_( void *ptr, size_t size, int *status ) {
+void astMemoryCacheStats_( int reset, size_t *nhit, size_t *nmiss,
+                           size_t *nbyte, size_t *ndepot, int *status ) {
 /*
-*++
+*+
 *  Name:
-*     astRealloc
+*     astMemoryCacheStats
 
 *  Purpose:
-*     Change the size of a dynamically allocated region of memory.
+*     Return statistics describing the cache of unused memory.
 
 *  Type:
-*     Public function.
+*     Protected function.
 
 *  Synopsis:
 *     #include "memory.h"
-*     void *astRealloc( void *ptr, size_t size )
+*     void astMemoryCacheStats( int reset, size_t *nhit, size_t *nmiss,
+*                               size_t *nbyte, size_t *ndepot )
 
 *  Description:
-*     This function changes the size of a dynamically allocated region
-*     of memory, preserving its contents up to the minimum of the old
-*     and new sizes. This may involve copying the contents to a new
-*     location, so a new pointer is returned (and the old memory freed
-*     if necessary).
-*
-*     This function is similar to the standard C "realloc" function
-*     except that it provides better security against programming
-*     errors and also supports the allocation of zero-size memory
-*     regions (indicated by a NULL pointer).
+*     This function returns statistics describing the use of the cache
+*     of allocated but currently unused memory (see astMemCaching). The
+*     numbers of allocations refer only to the currently executing
+*     thread, and include only allocations made while caching was
+*     switched on (or a scratch memory context was active) for memory
+*     blocks small enough to be cached.
 
 *  Parameters:
-*     ptr
-*        Pointer to previously allocated memory (or NULL if the
-*        previous size of the allocated memory was zero).
-*     size
-*        New size required for the memory region. This may be zero, in
-*        which case a NULL pointer is returned (no error results). It
-*        should not be negative.
+*     reset
+*        If non-zero, the numbers of allocations returned in "nhit" and
+*        "nmiss" are reset to zero on exit.
+*     nhit
+*        Address at which to return the number of allocations that
+*        re-used a cached memory block since the last reset. May be NULL.
+*     nmiss
+*        Address at which to return the number of allocations that
+*        required new memory to be allocated since the last reset. May be
+*        NULL.
+*     nbyte
+*        Address at which to return the number of bytes currently held in
+*        the cache of the currently executing thread, excluding memory
+*        block headers. May be NULL.
+*     ndepot
+*        Address at which to return the number of bytes currently held in
+*        the depot shared by all threads, excluding memory block headers.
+*        May be NULL.
 
-*  Returned Value:
-*     astRealloc()
-*        If the memory was reallocated successfully, a pointer to the
-*        start of the new memory region is returned (this may be the same
-*        as the original pointer). If size was given as zero, a NULL
-*        pointer is returned.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS
+   int i;
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+   if( nhit ) *nhit = cache_hits;
+   if( nmiss ) *nmiss = cache_misses;
+
+   if( nbyte ) {
+      *nbyte = 0;
+      if( cache_init ) {
+         for( i = 0; i < NCSIZE; i++ ) {
+            *nbyte += (size_t) cache_count[ i ]*( MNCSIZE << i );
+         }
+      }
+   }
+
+   if( ndepot ) {
+      *ndepot = 0;
+      LOCK_DEPOT_MUTEX;
+      for( i = 0; i < NCSIZE; i++ ) {
+         *ndepot += (size_t) depot_count[ i ]*NBATCH( i )*( MNCSIZE << i );
+      }
+      UNLOCK_DEPOT_MUTEX;
+   }
+
+   if( reset ) {
+      cache_hits = 0;
+      cache_misses = 0;
+   }
+}
+
+static void MakePow5Tables( void ) {
+/*
+*  Name:
+*     MakePow5Tables
+
+*  Purpose:
+*     Create the tables of powers of five used by astDouble2Chr.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void MakePow5Tables( void )
+
+*  Class Membership:
+*     Memory member function.
+
+*  Description:
+*     This function fills the "pow5_split" and "pow5_inv_split" tables
+*     with the 125 most significant bits of each power of five, and of
+*     the reciprocal of each power of five, respectively. This is done
+*     using simple multi-word arithmetic the first time a double value
+*     is formatted, rather than storing several hundred numerical
+*     constants in the source code. The tables are read-only after they
+*     have been created.
+
+*  Notes:
+*     - "pow5_inv_split[i]" holds floor( 2**j/5**i ) + 1, where "j" is
+*     124 plus the number of bits in 5**i.
+*     - "pow5_split[i]" holds 5**i shifted right (or left) so that it
+*     occupies exactly 125 bits.
+*/
+
+/* Local Variables: */
+   uint32_t carry;             /* Carry between words */
+   uint32_t p5[ POW5_NWORD ];  /* The current power of five */
+   uint32_t rem[ POW5_NWORD ]; /* Remainder in long division */
+   uint32_t sum;               /* Sum or difference of two words */
+   uint64_t *inv;              /* Pointer to reciprocal table entry */
+   uint64_t *split;            /* Pointer to power table entry */
+   uint64_t t;                 /* Product of a word and 5 */
+   int b;                      /* Bit index */
+   int borrow;                 /* Borrow between words */
+   int i;                      /* Power of five */
+   int k;                      /* Bit index within the power of five */
+   int nbit;                   /* Number of bits in the power of five */
+   int nw;                     /* Number of words in use */
+   int w;                      /* Word index */
+
+/* Initialise the power of five to 1. */
+   memset( p5, 0, sizeof( p5 ) );
+   p5[ 0 ] = 1;
+
+/* Loop round each power of five. */
+   for( i = 0; i < POW5_NINV; i++ ) {
+
+/* Find the number of bits in the current power of five, and the number
+   of words needed to hold twice the power. */
+      nbit = 32*POW5_NWORD;
+      while( !( ( p5[ ( nbit - 1 )/32 ] >> ( ( nbit - 1 ) % 32 ) ) & 1 ) ) nbit--;
+      nw = nbit/32 + 1;
+
+/* Store the 125 most significant bits of the power. */
+      if( i < POW5_N ) {
+         split = pow5_split[ i ];
+         split[ 0 ] = split[ 1 ] = 0;
+         for( b = 0; b < POW5_BITS; b++ ) {
+            k = nbit - POW5_BITS + b;
+            if( k >= 0 && ( ( p5[ k/32 ] >> ( k % 32 ) ) & 1 ) ) {
+               split[ b/64 ] |= (uint64_t) 1 << ( b % 64 );
+            }
+         }
+      }
+
+/* The reciprocal of one is simply 2**125 (plus one). */
+      inv = pow5_inv_split[ i ];
+      inv[ 0 ] = inv[ 1 ] = 0;
+      if( i == 0 ) {
+         inv[ 1 ] = (uint64_t) 1 << ( POW5_BITS - 64 );
+
+/* Otherwise, use binary long division to divide 2**(nbit+124) by the
+   power of five. The leading "nbit-1" bits of the quotient are zero,
+   leaving a remainder of 2**(nbit-2). Each of the remaining 126 bits
+   of the quotient is found by doubling the remainder and subtracting
+   the power of five if possible. */
+      } else {
+         memset( rem, 0, sizeof( rem ) );
+         rem[ ( nbit - 2 )/32 ] = (uint32_t) 1 << ( ( nbit - 2 ) % 32 );
+
+         for( b = POW5_BITS; b >= 0; b-- ) {
+            carry = 0;
+            for( w = 0; w < nw; w++ ) {
+               sum = ( rem[ w ] << 1 ) | carry;
+               carry = rem[ w ] >> 31;
+               rem[ w ] = sum;
+            }
+
+            for( w = nw - 1; w >= 0 && rem[ w ] == p5[ w ]; w-- );
+            if( w < 0 || rem[ w ] > p5[ w ] ) {
+               borrow = 0;
+               for( w = 0; w < nw; w++ ) {
+                  sum = rem[ w ] - p5[ w ] - borrow;
+                  borrow = ( rem[ w ] < p5[ w ] ) ||
+                           ( borrow && rem[ w ] == p5[ w ] );
+                  rem[ w ] = sum;
+               }
+               inv[ b/64 ] |= (uint64_t) 1 << ( b % 64 );
+            }
+         }
+      }
+
+/* Add one to the truncated reciprocal. */
+      if( ++inv[ 0 ] == 0 ) inv[ 1 ]++;
+
+/* Multiply the power of five by five. */
+      carry = 0;
+      for( w = 0; w < POW5_NWORD; w++ ) {
+         t = 5*(uint64_t) p5[ w ] + carry;
+         p5[ w ] = (uint32_t) t;
+         carry = (uint32_t)( t >> 32 );
+      }
+   }
+}
+
+static uint64_t MulShift64( uint64_t m, const uint64_t *mul, int j ) {
+/*
+*  Name:
+*     MulShift64
+
+*  Purpose:
+*     Multiply an integer by a table entry and shift the product right.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     uint64_t MulShift64( uint64_t m, const uint64_t *mul, int j )
+
+*  Class Membership:
+*     Memory member function.
+
+*  Description:
+*     This function returns the 192-bit product of "m" and the 128-bit
+*     value stored in "mul" (least significant word first), shifted
+*     right by "j" bits. It is used by ShortestDigits.
+
+*  Parameters:
+*     m
+*        The integer.
+*     mul
+*        The two words of the table entry.
+*     j
+*        The shift, in the range 64 to 127.
+
+*  Returned Value:
+*     The least significant 64 bits of the shifted product.
+*/
+
+/* Local Variables: */
+   uint64_t hi0;        /* High word of m*mul[0] */
+   uint64_t hi1;        /* High word of m*mul[1] */
+   uint64_t lo0;        /* Low word of m*mul[0] */
+   uint64_t lo1;        /* Low word of m*mul[1] */
+   uint64_t sum;        /* Middle word of the product */
+   int shift;           /* Shift to apply to the upper two words */
+
+/* Form the two 128-bit partial products. */
+   UMul128( m, mul[ 0 ], &hi0, &lo0 );
+   UMul128( m, mul[ 1 ], &hi1, &lo1 );
+
+/* Add them to get the upper two words of the full product (the least
+   significant word is always shifted out). */
+   sum = hi0 + lo1;
+   if( sum < hi0 ) hi1++;
+
+/* Shift right. */
+   shift = j - 64;
+   if( shift == 0 ) return sum;
+   return ( sum >> shift ) | ( hi1 << ( 64 - shift ) );
+}
+
+static int Pow5Factor( uint64_t value ) {
+/*
+*  Name:
+*     Pow5Factor
+
+*  Purpose:
+*     Find the number of times five divides into an integer.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     int Pow5Factor( uint64_t value )
+
+*  Class Membership:
+*     Memory member function.
+
+*  Parameters:
+*     value
+*        The integer. Must not be zero.
+
+*  Returned Value:
+*     The largest power of five that is a factor of "value".
+*/
+
+/* Local Variables: */
+   int result;          /* Returned value */
+
+   result = 0;
+   while( value % 5 == 0 ) {
+      value /= 5;
+      result++;
+   }
+   return result;
+}
+
+static void PutBatch( int cls, int *status ) {
+/*
+*  Name:
+*     PutBatch
+
+*  Purpose:
+*     Move a batch of unused memory blocks from the cache to the depot.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void PutBatch( int cls, int *status )
+
+*  Description:
+*     This function removes a batch of unused memory blocks in a given
+*     size class from the cache of the currently executing thread, and
+*     stores them in the depot shared by all threads, from where they
+*     can be re-used by any thread. If the depot is full, the memory
+*     blocks are freed instead. The cache must contain at least one
+*     batch of blocks in the size class when this function is called.
+
+*  Parameters:
+*     cls
+*        The size class.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   Memory *batch;                /* Pointer to first block in batch */
+   Memory *next;                 /* Pointer to next block */
+   Memory *tail;                 /* Pointer to last block in batch */
+   int i;                        /* Block index */
+   int n;                        /* Number of blocks in batch */
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Detach the first "n" blocks from the cache. */
+   n = NBATCH( cls );
+   batch = cache[ cls ];
+   tail = batch;
+   for( i = 1; i < n; i++ ) tail = tail->next;
+   cache[ cls ] = tail->next;
+   cache_count[ cls ] -= n;
+   tail->next = NULL;
+
+/* If there is room, push the batch onto the stack of batches held in the
+   depot. */
+   LOCK_DEPOT_MUTEX;
+   if( depot_count[ cls ] < MXDEPOT ) {
+      *( (Memory **) ( (char *) batch + SIZEOF_MEMORY ) ) = depot[ cls ];
+      depot[ cls ] = batch;
+      depot_count[ cls ]++;
+      batch = NULL;
+   }
+   UNLOCK_DEPOT_MUTEX;
+
+/* Otherwise, free the blocks. */
+   while( batch ) {
+      next = batch->next;
+      FREE( batch );
+      batch = next;
+   }
+}
+
+static int CompareProfSums( const void *a, const void *b ){
+/*
+*  Name:
+*     CompareProfSums
+
+*  Purpose:
+*     Compare two AstProfSum structures.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     int CompareProfSums( const void *a, const void *b )
+
+*  Description:
+*     This function is a qsort comparison function that sorts
+*     AstProfSum structures into order of decreasing self time.
+
+*  Parameters:
+*     a
+*        Pointer to the first AstProfSum.
+*     b
+*        Pointer to the second AstProfSum.
+
+*  Returned Value:
+*     -1, 0 or +1 if the first structure should be placed before, with
+*     or after the second structure.
+*/
+
+/* Local Variables: */
+   const AstProfSum *sa;
+   const AstProfSum *sb;
+
+   sa = (const AstProfSum *) a;
+   sb = (const AstProfSum *) b;
+   if( sa->self > sb->self ) return -1;
+   if( sa->self < sb->self ) return 1;
+   return 0;
+}
+
+static void FreeProfNode( AstProfNode *node ){
+/*
+*  Name:
+*     FreeProfNode
+
+*  Purpose:
+*     Free a node in the profiling call tree.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void FreeProfNode( AstProfNode *node )
+
+*  Description:
+*     This function frees the memory used by the supplied node in the
+*     profiling call tree, together with all its descendants.
+
+*  Parameters:
+*     node
+*        Pointer to the node to free. May be NULL.
+*/
+
+/* Local Variables: */
+   int i;
+
+   if( node ) {
+      for( i = 0; i < node->nchild; i++ ) FreeProfNode( node->children[ i ] );
+      FREE( node->children );
+      FREE( node );
+   }
+}
+
+static void JsonProfNode( FILE *fd, AstProfNode *node, double ts,
+                          int *first, int *status ){
+/*
+*  Name:
+*     JsonProfNode
+
+*  Purpose:
+*     Write a node in the profiling call tree as a Chrome trace event.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void JsonProfNode( FILE *fd, AstProfNode *node, double ts,
+*                        int *first, int *status )
+
+*  Description:
+*     This function writes a "complete" (ph="X") trace event describing
+*     the supplied node to the supplied file, and then does the same for
+*     each of its descendants. The events for the children of a node are
+*     placed end to end, starting at the start of the parent event, so
+*     that the resulting trace is displayed as a flame chart.
+
+*  Parameters:
+*     fd
+*        The file to write to.
+*     node
+*        Pointer to the node.
+*     ts
+*        The start time for the event, in micro-seconds.
+*     first
+*        Pointer to a flag that is non-zero if no event has yet been
+*        written. Returned zero.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   int i;
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Write the event. */
+   fprintf( fd, "%s\n  {\"name\":\"%s(%s)\",\"cat\":\"%s\",\"ph\":\"X\","
+            "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,\"args\":{"
+            "\"calls\":%lu,\"points\":%.0f,\"allocs\":%lu}}",
+            *first ? "" : ",", node->op, node->class, node->op, ts,
+            1.0E6*node->time, (unsigned long) node->nentry, node->npoint,
+            (unsigned long) node->nalloc );
+   *first = 0;
+
+/* Write the events for the children, end to end. */
+   for( i = 0; i < node->nchild; i++ ) {
+      JsonProfNode( fd, node->children[ i ], ts, first, status );
+      ts += 1.0E6*node->children[ i ]->time;
+   }
+}
+
+static AstProfNode *NewProfNode( AstProfNode *parent, const char *op,
+                                 const char *class ){
+/*
+*  Name:
+*     NewProfNode
+
+*  Purpose:
+*     Create a new node in the profiling call tree.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     AstProfNode *NewProfNode( AstProfNode *parent, const char *op,
+*                               const char *class )
+
+*  Description:
+*     This function creates a new node in the profiling call tree and
+*     adds it to the children of the supplied parent node.
+
+*  Parameters:
+*     parent
+*        Pointer to the parent node. Should be NULL when creating the
+*        root of the tree.
+*     op
+*        The name of the profiled function. A pointer to the supplied
+*        string is stored, so it should be a constant string.
+*     class
+*        The name of the class. A pointer to the supplied string is
+*        stored, so it should be a constant string.
+
+*  Returned Value:
+*     A pointer to the new node, or NULL if memory could not be
+*     allocated.
+
+*  Notes:
+*     - The memory for the tree is allocated directly using malloc so
+*     that it is not included in the allocation counts, and so that no
+*     error is reported if it cannot be allocated.
+*/
+
+/* Local Variables: */
+   AstProfNode **children;
+   AstProfNode *result;
+
+/* Allocate and initialise the new node. */
+   result = MALLOC( sizeof( AstProfNode ) );
+   if( result ) {
+      result->op = op;
+      result->class = class;
+      result->nentry = 0;
+      result->npoint = 0.0;
+      result->time = 0.0;
+      result->nalloc = 0;
+      result->parent = parent;
+      result->nchild = 0;
+      result->children = NULL;
+
+/* Add it to the children of the parent node. */
+      if( parent ) {
+         children = REALLOC( parent->children,
+                             ( parent->nchild + 1 )*sizeof( AstProfNode * ) );
+         if( children ) {
+            parent->children = children;
+            parent->children[ parent->nchild++ ] = result;
+         } else {
+            FREE( result );
+            result = NULL;
+         }
+      }
+   }
+
+/* Return the new node. */
+   return result;
+}
+
+void astProfileReport_( const char *fname, int json, int *status ){
+/*
+*++
+*  Name:
+*     astProfileReport
+
+*  Purpose:
+*     Report the results of profiling.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void astProfileReport( const char *fname, int json )
+
+*  Description:
+*     This function writes out the profiling results recorded since
+*     the "Profile" tuning parameter was last set to a non-zero value
+*     (see astTune).
+*
+*     The results describe the calls made to each of the profiled
+*     functions (astTransform, astSimplify, astResample<X>, astRebin<X>,
+*     astRebinSeq<X> and astConvert, and the astRead and astWrite
+*     methods of a Channel), either directly by the application or from
+*     within other profiled functions. Calls made within the same chain
+*     of enclosing profiled calls for Objects of the same class are
+*     combined. For instance, the calls to astTransform made for each of
+*     the component Mappings within a CmpMap appear as children of the
+*     corresponding call for the CmpMap. The following values are
+*     recorded for each combination:
+*
+*     - Calls: The number of calls.
+*     - Points: The total number of points transformed, or the total
+*     number of pixels resampled or rebinned. This is zero for other
+*     functions.
+*     - Time: The total wall-clock time spent within the calls, in
+*     seconds.
+*     - Allocs: The total number of memory blocks allocated within the
+*     calls.
+*
+*     If "json" is zero, a text report is written. This contains the
+*     full tree of calls, indented to show nesting, followed by a list
+*     of the totals for each combination of profiled function and class,
+*     sorted into order of decreasing "self" time (i.e. the time spent
+*     within calls but not within any profiled calls that they make).
+*
+*     If "json" is non-zero, the results are written in the Chrome trace
+*     event format, as used by "chrome://tracing", "Perfetto" and
+*     "speedscope". Each node in the tree of calls is written as a single
+*     event with a duration equal to its total time, and with the events
+*     for the child nodes placed end to end within the event for their
+*     parent. The trace is thus displayed as a flame chart of aggregated
+*     times, rather than as a timeline of individual calls.
+
+*  Parameters:
+*     fname
+*        The name of the file to which the report should be written. Any
+*        existing file is over-written. If NULL or blank, the report is
+*        written to standard output.
+*     json
+*        Should the report be written in the Chrome trace event (JSON)
+*        format?
+
+*  Notes:
+*     - Profiling results are shared by all threads. The times recorded
+*     for calls made in different threads are added together, and so
+*     may exceed the elapsed time.
+*     - This function is only available in the C interface.
+*--
+*/
+
+/* Local Constants: */
+#define ERRBUF_LEN 80
+
+/* Local Variables: */
+   AstProfSum *sums;
+   FILE *fd;
+   char errbuf[ ERRBUF_LEN ];
+   char *errstat;
+   int first;
+   int i;
+   int nsum;
+   double ts;
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Open the output file. */
+   if( fname && astChrLen( fname ) > 0 ) {
+      fd = fopen( fname, "w" );
+      if( !fd ) {
+#if HAVE_STRERROR_R
+         strerror_r( errno, errbuf, ERRBUF_LEN );
+         errstat = errbuf;
+#else
+         errstat = strerror( errno );
+#endif
+         astError( AST__WRERR, "astProfileReport: Failed to open output "
+                   "file '%s' - %s.", status, fname, errstat );
+         return;
+      }
+   } else {
+      fd = stdout;
+   }
+
+/* Prevent other threads modifying the tree while it is being
+   reported. */
+   LOCK_PROFILE_MUTEX;
+
+/* Chrome trace event format. */
+   if( json ) {
+      fprintf( fd, "{\"traceEvents\":[" );
+      first = 1;
+      ts = 0.0;
+      if( profile_root ) {
+         for( i = 0; i < profile_root->nchild; i++ ) {
+            JsonProfNode( fd, profile_root->children[ i ], ts, &first, status );
+            ts += 1.0E6*profile_root->children[ i ]->time;
+         }
+      }
+      fprintf( fd, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+
+/* Text format. First write the tree of calls. */
+   } else if( !profile_root ) {
+      fprintf( fd, "No AST profiling results are available.\n" );
+
+   } else {
+      fprintf( fd, "AST profile (times are wall-clock seconds):\n\n" );
+      fprintf( fd, "%10s %14s %11s %11s %10s  %s\n", "Calls", "Points",
+               "Time", "Self", "Allocs", "Function(Class)" );
+      for( i = 0; i < profile_root->nchild; i++ ) {
+         ReportProfNode( fd, profile_root->children[ i ], 0, status );
+      }
+
+/* Now find and write the totals for each combination of function and
+   class, sorted by self time. */
+      sums = NULL;
+      nsum = 0;
+      for( i = 0; i < profile_root->nchild; i++ ) {
+         SumProfNode( profile_root->children[ i ], &sums, &nsum, status );
+      }
+
+      if( astOK && nsum > 0 ) {
+         qsort( sums, nsum, sizeof( AstProfSum ), CompareProfSums );
+         fprintf( fd, "\nTotals (excluding recursive calls), sorted by "
+                  "self time:\n\n" );
+         fprintf( fd, "%10s %14s %11s %11s %10s  %s\n", "Calls", "Points",
+                  "Time", "Self", "Allocs", "Function(Class)" );
+         for( i = 0; i < nsum; i++ ) {
+            fprintf( fd, "%10lu %14.0f %11.6f %11.6f %10lu  %s(%s)\n",
+                     (unsigned long) sums[ i ].nentry, sums[ i ].npoint,
+                     sums[ i ].time, sums[ i ].self,
+                     (unsigned long) sums[ i ].nalloc, sums[ i ].op,
+                     sums[ i ].class );
+         }
+      }
+      sums = astFree( sums );
+   }
+
+/* Allow other threads to modify the tree again. */
+   UNLOCK_PROFILE_MUTEX;
+
+/* Close the output file. */
+   if( fd == stdout ) {
+      fflush( fd );
+   } else {
+      fclose( fd );
+   }
+}
+#undef ERRBUF_LEN
+
+void astProfileStart_( AstProfileCall *call, const char *op, void *object,
+                       double npoint, int *status ){
+/*
+*+
+*  Name:
+*     astProfileStart
+
+*  Purpose:
+*     Start profiling a call to a profiled function.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void astProfileStart( AstProfileCall *call, const char *op,
+*                           void *object, double npoint )
+
+*  Description:
+*     This function should be called at the start of each call to a
+*     function that is to be profiled, and must be matched by a call to
+*     astProfileStop at the end of the call. It does nothing unless
+*     profiling has been enabled using the "Profile" tuning parameter
+*     (see astTune).
+*
+*     The call is recorded in the node of the profiling call tree that
+*     describes calls to the named function for Objects of the same
+*     class as the supplied Object, made from within the innermost
+*     profiled call that is currently active in the calling thread. The
+*     node is created if it does not already exist.
+
+*  Parameters:
+*     call
+*        Pointer to a structure in which to store the state of the call.
+*        This should be passed to the matching call to astProfileStop.
+*     op
+*        The name of the function (e.g. "Transform"). A pointer to this
+*        string is stored, so it should be a constant string.
+*     object
+*        Pointer to the Object for which the function is being called.
+*     npoint
+*        The number of points (or pixels) processed by the call.
+
+*  Notes:
+*     - This function does not record the call if the global error
+*     status is set, or if it fails for any reason, but the matching
+*     call to astProfileStop should still be made.
+*-
+*/
+
+/* Local Variables: */
+   const char *class;
+
+/* Indicate that the call is not being profiled. */
+   call->node = NULL;
+
+/* Check the global error status, and do nothing more if profiling is
+   not enabled. */
+   if( !astOK || !GET_PROFILING ) return;
+
+/* Get the class of the Object, and record the call. */
+   class = astGetClass( object );
+   astProfileStartClass( call, op, class, npoint );
+}
+
+void astProfileStartClass_( AstProfileCall *call, const char *op,
+                            const char *class, double npoint, int *status ){
+/*
+*+
+*  Name:
+*     astProfileStartClass
+
+*  Purpose:
+*     Start profiling a call to a profiled function, given a class name.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void astProfileStartClass( AstProfileCall *call, const char *op,
+*                                const char *class, double npoint )
+
+*  Description:
+*     This function is equivalent to astProfileStart, except that the
+*     class name under which the call is recorded is supplied directly
+*     rather than being obtained from an Object. It can be used to
+*     profile functions that do not operate on an Object, such as the
+*     creation of internal tables.
+
+*  Parameters:
+*     call
+*        Pointer to a structure in which to store the state of the call.
+*        This should be passed to the matching call to astProfileStop.
+*     op
+*        The name of the function (e.g. "Transform"). A pointer to this
+*        string is stored, so it should be a constant string.
+*     class
+*        The class name under which the call is to be recorded. A pointer
+*        to this string is stored, so it should be a constant string.
+*     npoint
+*        The number of points (or pixels) processed by the call.
+
+*  Notes:
+*     - This function does not record the call if the global error
+*     status is set, or if it fails for any reason, but the matching
+*     call to astProfileStop should still be made.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS
+   AstProfNode *node;
+   AstProfNode *parent;
+   int i;
+
+/* Indicate that the call is not being profiled. */
+   call->node = NULL;
+
+/* Check the global error status, and do nothing more if profiling is
+   not enabled. */
+   if( !astOK || !GET_PROFILING || !class ) return;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Lock the mutex that serialises access to the tree. */
+   LOCK_PROFILE_MUTEX;
+
+/* Get the parent node. This is the node for the innermost profiled call
+   that is currently active in this thread, unless the tree has been
+   discarded since the call started, in which case the root node is
+   used. */
+   if( profile_current && profile_thread_epoch == profile_epoch ) {
+      parent = profile_current;
+   } else {
+      parent = profile_root;
+   }
+
+/* Find the child node for the function and class, creating it if it
+   does not already exist. */
+   node = NULL;
+   if( parent ) {
+      for( i = 0; i < parent->nchild; i++ ) {
+         if( !strcmp( parent->children[ i ]->op, op ) &&
+             !strcmp( parent->children[ i ]->class, class ) ) {
+            node = parent->children[ i ];
+            break;
+         }
+      }
+      if( !node ) node = NewProfNode( parent, op, class );
+   }
+
+/* Record the call and make the node current. */
+   if( node ) {
+      node->nentry++;
+      node->npoint += npoint;
+      call->node = node;
+      call->parent = parent;
+      call->epoch = profile_epoch;
+      profile_current = node;
+      profile_thread_epoch = profile_epoch;
+   }
+
+   UNLOCK_PROFILE_MUTEX;
+
+/* Record the starting time and allocation count. */
+   if( call->node ) {
+      call->nalloc0 = alloc_count;
+      call->t0 = ProfileTime();
+   }
+}
+
+void astProfileStop_( AstProfileCall *call, int *status ){
+/*
+*+
+*  Name:
+*     astProfileStop
+
+*  Purpose:
+*     Stop profiling a call to a profiled function.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void astProfileStop( AstProfileCall *call )
+
+*  Description:
+*     This function should be called at the end of each call to a
+*     profiled function. It adds the time taken by the call, and the
+*     number of memory blocks allocated within it, to the node in the
+*     profiling call tree used by the matching call to astProfileStart.
+
+*  Parameters:
+*     call
+*        Pointer to the structure initialised by the matching call to
+*        astProfileStart.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS
+   AstProfNode *node;
+   double t;
+
+/* Do nothing if the call was not profiled. */
+   if( !call->node ) return;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Get the time at the end of the call. */
+   t = ProfileTime();
+
+/* Lock the mutex that serialises access to the tree. */
+   LOCK_PROFILE_MUTEX;
+
+/* If the tree has not been discarded since the call started, update the
+   node and re-instate its parent as the current node. */
+   if( call->epoch == profile_epoch ) {
+      node = (AstProfNode *) call->node;
+      node->time += t - call->t0;
+      node->nalloc += alloc_count - call->nalloc0;
+      profile_current = call->parent;
+
+/* Otherwise, the node no longer exists. */
+   } else {
+      profile_current = NULL;
+   }
+
+   UNLOCK_PROFILE_MUTEX;
+}
+
+static double ProfileTime( void ){
+/*
+*  Name:
+*     ProfileTime
+
+*  Purpose:
+*     Return the current time for use in profiling.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     double ProfileTime( void )
+
+*  Description:
+*     This function returns the time, in seconds, since some arbitrary
+*     moment. The system's monotonic wall-clock time is used if
+*     available. Otherwise the processor time used by the program is
+*     returned.
+
+*  Returned Value:
+*     The time, in seconds.
+*/
+
+#if defined(CLOCK_MONOTONIC)
+   struct timespec ts;
+   if( clock_gettime( CLOCK_MONOTONIC, &ts ) == 0 ) {
+      return (double) ts.tv_sec + 1.0E-9*(double) ts.tv_nsec;
+   }
+#endif
+   return ( (double) clock() )/CLOCKS_PER_SEC;
+}
+
+int astProfiling_( int newval, int *status ){
+/*
+*++
+*  Name:
+*     astProfiling
+
+*  Purpose:
+*     Controls whether calls to profiled functions are recorded.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     int astProfiling( int newval )
+
+*  Description:
+*     This function sets a flag indicating if calls to profiled functions
+*     should be recorded (see astProfileReport). It also returns the
+*     original value of the flag.
+*
+*     If profiling is switched on as a result of this call, any
+*     previously recorded results are discarded. If it is switched off,
+*     the results recorded so far are retained, and can be reported using
+*     astProfileReport.
+*
+*     The flag and the recorded results are shared by all threads.
+
+*  Parameters:
+*     newval
+*        The new value for the Profile tuning parameter (see astTune in
+*        object.c). If AST__TUNULL is supplied, the current value is left
+*        unchanged.
+
+*  Returned Value:
+*     astProfiling()
+*        The original value of the Profile tuning parameter.
+
+*--
+*/
+
+/* Local Variables: */
+   int result;
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Store the original value of the tuning parameter. */
+   result = GET_PROFILING;
+
+/* If a new value is to be set... */
+   if( newval != AST__TUNULL ) {
+
+/* If profiling is being switched on, discard any existing results and
+   create a new root node. Increment the epoch so that any calls that are
+   still active can be recognised when they end. */
+      if( newval && !result ) {
+         LOCK_PROFILE_MUTEX;
+         FreeProfNode( profile_root );
+         profile_root = NewProfNode( NULL, NULL, NULL );
+         profile_epoch++;
+         UNLOCK_PROFILE_MUTEX;
+      }
+
+/* Store the new value. */
+      SET_PROFILING( newval ? 1 : 0 );
+   }
+
+/* Return the original value. */
+   return result;
+}
+
+static void ReportProfNode( FILE *fd, AstProfNode *node, int depth,
+                            int *status ){
+/*
+*  Name:
+*     ReportProfNode
+
+*  Purpose:
+*     Write a node in the profiling call tree to a text report.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void ReportProfNode( FILE *fd, AstProfNode *node, int depth,
+*                          int *status )
+
+*  Description:
+*     This function writes a line describing the supplied node to the
+*     supplied file, and then does the same for each of its descendants.
+*     The function name is indented to show the depth of each node
+*     within the tree.
+
+*  Parameters:
+*     fd
+*        The file to write to.
+*     node
+*        Pointer to the node.
+*     depth
+*        The depth of the node within the tree (zero for the children of
+*        the root node).
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   double self;
+   int i;
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Find the time spent within the calls but not within any of the
+   profiled calls that they make. */
+   self = node->time;
+   for( i = 0; i < node->nchild; i++ ) self -= node->children[ i ]->time;
+   if( self < 0.0 ) self = 0.0;
+
+/* Write the line, and then the lines for the children. */
+   fprintf( fd, "%10lu %14.0f %11.6f %11.6f %10lu  %*s%s(%s)\n",
+            (unsigned long) node->nentry, node->npoint, node->time, self,
+            (unsigned long) node->nalloc, 2*depth, "", node->op,
+            node->class );
+   for( i = 0; i < node->nchild; i++ ) {
+      ReportProfNode( fd, node->children[ i ], depth + 1, status );
+   }
+}
+
+static void SumProfNode( AstProfNode *node, AstProfSum **sums, int *nsum,
+                         int *status ){
+/*
+*  Name:
+*     SumProfNode
+
+*  Purpose:
+*     Add a node in the profiling call tree into the totals for each
+*     function and class.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     void SumProfNode( AstProfNode *node, AstProfSum **sums, int *nsum,
+*                       int *status )
+
+*  Description:
+*     This function adds the values recorded in the supplied node, and
+*     all its descendants, into the totals for the corresponding
+*     combinations of profiled function and class. The time and number
+*     of allocations are only added if none of the ancestors of the node
+*     refer to the same function and class, so that the time spent within
+*     recursive calls is not counted more than once.
+
+*  Parameters:
+*     node
+*        Pointer to the node.
+*     sums
+*        Address of a pointer to an array holding the totals. The array
+*        is extended if necessary, and a new pointer may be returned.
+*     nsum
+*        Address of the number of elements in the "sums" array. Updated
+*        on exit.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   AstProfNode *anc;
+   AstProfSum *sum;
+   double self;
+   int i;
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Find the totals for the function and class, adding new totals if
+   necessary. */
+   sum = NULL;
+   for( i = 0; i < *nsum; i++ ) {
+      if( !strcmp( (*sums)[ i ].op, node->op ) &&
+          !strcmp( (*sums)[ i ].class, node->class ) ) {
+         sum = *sums + i;
+         break;
+      }
+   }
+
+   if( !sum ) {
+      *sums = astGrow( *sums, *nsum + 1, sizeof( AstProfSum ) );
+      if( !astOK ) return;
+      sum = *sums + (*nsum)++;
+      sum->op = node->op;
+      sum->class = node->class;
+      sum->nentry = 0;
+      sum->npoint = 0.0;
+      sum->time = 0.0;
+      sum->self = 0.0;
+      sum->nalloc = 0;
+   }
+
+/* Add in the values from the node. */
+   self = node->time;
+   for( i = 0; i < node->nchild; i++ ) self -= node->children[ i ]->time;
+   if( self > 0.0 ) sum->self += self;
+   sum->nentry += node->nentry;
+   sum->npoint += node->npoint;
+
+   for( anc = node->parent; anc; anc = anc->parent ) {
+      if( anc->op && !strcmp( anc->op, node->op ) &&
+          !strcmp( anc->class, node->class ) ) break;
+   }
+   if( !anc ) {
+      sum->time += node->time;
+      sum->nalloc += node->nalloc;
+   }
+
+/* Add in the values from the children. */
+   for( i = 0; i < node->nchild; i++ ) {
+      SumProfNode( node->children[ i ], sums, nsum, status );
+   }
+}
+
+void *astRealloc_( void *ptr, size_t size, int *status ) {
+/*
+*++
+*  Name:
+*     astRealloc
+
+*  Purpose:
+*     Change the size of a dynamically allocated region of memory.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void *astRealloc( void *ptr, size_t size )
+
+*  Description:
+*     This function changes the size of a dynamically allocated region
+*     of memory, preserving its contents up to the minimum of the old
+*     and new sizes. This may involve copying the contents to a new
+*     location, so a new pointer is returned (and the old memory freed
+*     if necessary).
+*
+*     This function is similar to the standard C "realloc" function
+*     except that it provides better security against programming
+*     errors and also supports the allocation of zero-size memory
+*     regions (indicated by a NULL pointer).
+
+*  Parameters:
+*     ptr
+*        Pointer to previously allocated memory (or NULL if the
+*        previous size of the allocated memory was zero).
+*     size
+*        New size required for the memory region. This may be zero, in
+*        which case a NULL pointer is returned (no error results). It
+*        should not be negative.
+
+*  Returned Value:
+*     astRealloc()
+*        If the memory was reallocated successfully, a pointer to the
+*        start of the new memory region is returned (this may be the same
+*        as the original pointer). If size was given as zero, a NULL
+*        pointer is returned.
 
 *  Notes:
 *     - If this function is invoked with the error status set, or if
@@ -3668,6 +5614,10 @@ void *astRealloc_( void *ptr, size_t size, int *status ) {
 *     and the memory contents are unchanged. Note that this behaviour
 *     differs from that of the standard C "realloc" function which
 *     returns NULL if it fails.
+*     - If the supplied memory is shared (see astShare), the returned
+*     pointer always identifies a new memory block that is owned only by
+*     the caller. The supplied memory is left unchanged for its other
+*     owners.
 *--
 */
 
@@ -3679,6 +5629,7 @@ void *astRealloc_( void *ptr, size_t size, int *status ) {
    char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
    char *errstat;                /* Pointer to system error message */
    int isdynamic;                /* Was memory allocated dynamically? */
+   int shared;                   /* Is the memory shared? */
    void *result;                 /* Returned pointer */
    Memory *mem;                  /* Pointer to memory header */
 
@@ -3703,8 +5654,10 @@ void *astRealloc_( void *ptr, size_t size, int *status ) {
       IS_DYNAMIC( ptr, isdynamic );
       if ( isdynamic ) {
 
-/* Obtain a pointer to the memory header. */
+/* Obtain a pointer to the memory header, and note if the memory is
+   shared with other owners. */
          mem = (Memory *) ( (char *) ptr - SIZEOF_MEMORY );
+         shared = ( GET_NREF( mem ) > 1 );
 
 /* If the new size is zero, free the old memory and set a NULL return
    pointer value. */
@@ -3715,12 +5668,32 @@ void *astRealloc_( void *ptr, size_t size, int *status ) {
 /* Otherwise, reallocate the memory. */
          } else {
 
-/* If the cache is being used, for small memory blocks, do the equivalent of
+/* Small memory blocks are allocated with the usable size of their size
+   class. So if the old and new sizes are in the same size class, the
+   existing memory block can be used without change. Just update the
+   header to hold the new size. This cannot be done if the memory block
+   is shared. */
+            if( !shared && mem->size <= MXCSIZE && size <= MXCSIZE &&
+                SizeClass( mem->size ) == SizeClass( size ) ) {
+#ifdef MEM_DEBUG
+               DeIssue( mem, status );
+#endif
+               mem->magic = MAGIC( mem, size );
+               mem->size = size;
+#ifdef MEM_DEBUG
+               Issue( mem, status );
+#endif
+
+/* For other small memory blocks, do the equivalent of
+
                mem = REALLOC( mem, SIZEOF_MEMORY + size );
 
    using astMalloc, astFree and memcpy explicitly in order to ensure
-   that the memory blocks are cached. */
-            if( use_cache && ( mem->size <= MXCSIZE || size <= MXCSIZE ) ) {
+   that the new memory block is allocated in the correct size class.
+   Shared memory blocks of any size are handled in the same way, so that
+   the other owners retain the original memory block (astFree just
+   reduces the number of owners in this case). */
+            } else if( shared || mem->size <= MXCSIZE || size <= MXCSIZE ) {
                result = astMalloc( size );
                if( result ) {
                   if( mem->size < size ) {
@@ -3768,6 +5741,7 @@ void *astRealloc_( void *ptr, size_t size, int *status ) {
                   mem->prev = NULL;
                   Issue( mem, status );
 #endif
+                  alloc_count++;
                   result = mem;
                   result = (char *) result + SIZEOF_MEMORY;
                }
@@ -3832,6 +5806,311 @@ void astRemoveLeadingBlanks_( char *string, int *status ) {
    }
 }
 
+static void ShortestDigits( uint64_t ieee_mant, int ieee_exp,
+                            uint64_t *mant, int *dexp ) {
+/*
+*  Name:
+*     ShortestDigits
+
+*  Purpose:
+*     Find the shortest decimal representation of a double.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void ShortestDigits( uint64_t ieee_mant, int ieee_exp,
+*                          uint64_t *mant, int *dexp )
+
+*  Class Membership:
+*     Memory member function.
+
+*  Description:
+*     This function finds the decimal value with the fewest significant
+*     digits that lies within the interval of real values that round to
+*     a given positive, finite, non-zero IEEE double. If several such
+*     values exist, the one closest to the double is returned. It
+*     implements the "Ryu" algorithm described by Adams (2018, ACM
+*     SIGPLAN Notices, 53, 270), which uses fixed-size integer
+*     arithmetic only.
+
+*  Parameters:
+*     ieee_mant
+*        The 52 stored mantissa bits of the double.
+*     ieee_exp
+*        The 11 stored exponent bits of the double.
+*     mant
+*        Returned holding the decimal mantissa. This may include trailing
+*        zeros.
+*     dexp
+*        Returned holding the power of ten by which "mant" should be
+*        multiplied to get the value.
+*/
+
+/* Local Variables: */
+   int accept_bounds;   /* Do the ends of the interval round to the value? */
+   int e10;             /* Power of ten of the scaled values */
+   int e2;              /* Power of two of the value */
+   int i;               /* Table index or shift */
+   int j;               /* Shift */
+   int k;               /* Number of bits in a power of five */
+   int last_digit;      /* Last digit removed from "vr" */
+   int mm_shift;        /* Is the lower interval half as wide as the upper? */
+   int q;               /* Power of ten used to scale the values */
+   int removed;         /* Number of digits removed */
+   int round_up;        /* Should "vr" be rounded up? */
+   int vm_zeros;        /* Are the digits removed from "vm" all zero? */
+   int vr_zeros;        /* Are the digits removed from "vr" all zero? */
+   uint64_t m2;         /* Binary mantissa */
+   uint64_t mv;         /* Four times the binary mantissa */
+   uint64_t vm;         /* Scaled lower end of the interval */
+   uint64_t vp;         /* Scaled upper end of the interval */
+   uint64_t vr;         /* Scaled value */
+
+/* Ensure the tables of powers of five have been created. */
+#ifdef THREAD_SAFE
+   (void) pthread_once( &pow5_once, MakePow5Tables );
+#else
+   if( !pow5_init ) {
+      MakePow5Tables();
+      pow5_init = 1;
+   }
+#endif
+
+/* Get the binary mantissa and exponent. The exponent is reduced by two
+   so that the interval end-points (which lie half way to the
+   neighbouring doubles) are integers when multiplied by four. */
+   if( ieee_exp == 0 ) {
+      e2 = 1 - 1023 - 52 - 2;
+      m2 = ieee_mant;
+   } else {
+      e2 = ieee_exp - 1023 - 52 - 2;
+      m2 = ( (uint64_t) 1 << 52 ) | ieee_mant;
+   }
+
+/* Values in the interval round to the double using round-to-even, so the
+   end points are included if the mantissa is even. The lower end of the
+   interval is closer if the mantissa is an exact power of two. */
+   accept_bounds = ( ( m2 & 1 ) == 0 );
+   mv = 4*m2;
+   mm_shift = ( ieee_mant != 0 || ieee_exp <= 1 );
+
+/* Find the value and the ends of the interval, all multiplied by
+   2**e2/10**e10 and truncated to integers. Also note whether the
+   discarded fractions were zero. */
+   vm_zeros = 0;
+   vr_zeros = 0;
+   if( e2 >= 0 ) {
+      q = LOG10POW2( e2 ) - ( e2 > 3 );
+      e10 = q;
+      k = POW5_BITS + POW5BITS( q ) - 1;
+      i = -e2 + q + k;
+      vr = MulShift64( 4*m2, pow5_inv_split[ q ], i );
+      vp = MulShift64( 4*m2 + 2, pow5_inv_split[ q ], i );
+      vm = MulShift64( 4*m2 - 1 - mm_shift, pow5_inv_split[ q ], i );
+
+      if( q <= 21 ) {
+         if( mv % 5 == 0 ) {
+            vr_zeros = ( Pow5Factor( mv ) >= q );
+         } else if( accept_bounds ) {
+            vm_zeros = ( Pow5Factor( mv - 1 - mm_shift ) >= q );
+         } else {
+            vp -= ( Pow5Factor( mv + 2 ) >= q );
+         }
+      }
+
+   } else {
+      q = LOG10POW5( -e2 ) - ( -e2 > 1 );
+      e10 = q + e2;
+      i = -e2 - q;
+      k = POW5BITS( i ) - POW5_BITS;
+      j = q - k;
+      vr = MulShift64( 4*m2, pow5_split[ i ], j );
+      vp = MulShift64( 4*m2 + 2, pow5_split[ i ], j );
+      vm = MulShift64( 4*m2 - 1 - mm_shift, pow5_split[ i ], j );
+
+      if( q <= 1 ) {
+         vr_zeros = 1;
+         if( accept_bounds ) {
+            vm_zeros = ( mm_shift == 1 );
+         } else {
+            vp--;
+         }
+      } else if( q < 63 ) {
+         vr_zeros = ( ( mv & ( ( (uint64_t) 1 << q ) - 1 ) ) == 0 );
+      }
+   }
+
+/* Remove digits from the end of the value for as long as the interval
+   still contains a value with fewer digits. */
+   removed = 0;
+   last_digit = 0;
+   if( vm_zeros || vr_zeros ) {
+      while( vp/10 > vm/10 ) {
+         vm_zeros = vm_zeros && ( vm % 10 == 0 );
+         vr_zeros = vr_zeros && ( last_digit == 0 );
+         last_digit = (int)( vr % 10 );
+         vr /= 10;
+         vp /= 10;
+         vm /= 10;
+         removed++;
+      }
+
+/* If the lower end of the interval is exact and included, further zeros
+   can be removed from it. */
+      if( vm_zeros ) {
+         while( vm % 10 == 0 ) {
+            vr_zeros = vr_zeros && ( last_digit == 0 );
+            last_digit = (int)( vr % 10 );
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+         }
+      }
+
+/* Round exact halves to even. */
+      if( vr_zeros && last_digit == 5 && vr % 2 == 0 ) last_digit = 4;
+
+      *mant = vr + ( ( vr == vm && ( !accept_bounds || !vm_zeros ) ) ||
+                     last_digit >= 5 );
+
+/* The common case in which neither end of the interval is exact. */
+   } else {
+      round_up = 0;
+      while( vp/10 > vm/10 ) {
+         round_up = ( vr % 10 >= 5 );
+         vr /= 10;
+         vp /= 10;
+         vm /= 10;
+         removed++;
+      }
+      *mant = vr + ( vr == vm || round_up );
+   }
+
+/* Return the power of ten. */
+   *dexp = e10 + removed;
+}
+
+void *astShare_( void *ptr, int *status ) {
+/*
+*+
+*  Name:
+*     astShare
+
+*  Purpose:
+*     Share dynamically allocated memory with a new owner.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void *astShare( void *ptr )
+
+*  Description:
+*     This function increments the number of owners of a region of
+*     dynamically allocated memory, and returns the supplied pointer. It
+*     allows (for instance) a copy of an Object to use the same memory
+*     as the original Object, rather than a copy of it.
+*
+*     Each owner should free the memory using astFree when it is no
+*     longer needed. The memory is only freed when its last owner frees
+*     it. An owner that wishes to modify shared memory should first call
+*     astUnshare to obtain a private copy. astRealloc and astGrow also
+*     return private memory if the supplied memory is shared. The owners
+*     may be used in different threads.
+
+*  Parameters:
+*     ptr
+*        Pointer to previously allocated memory (or NULL). An error
+*        will result if the memory has not previously been allocated by
+*        another function in this module.
+
+*  Returned Value:
+*     astShare()
+*        The supplied pointer.
+
+*  Notes:
+*     - A NULL pointer is returned if this function is invoked with the
+*     global error status set, or if it fails for any reason.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   int isdynamic;                /* Was the memory allocated dynamically? */
+
+/* Check the global error status and the supplied pointer. */
+   if ( !astOK || !ptr ) return NULL;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Check the pointer identifies dynamically allocated memory, and if so
+   increment the number of owners. */
+   IS_DYNAMIC( ptr, isdynamic );
+   if( !isdynamic ) return NULL;
+   (void) CHANGE_NREF( (Memory *) ( (char *) ptr - SIZEOF_MEMORY ), 1 );
+
+/* Return the supplied pointer. */
+   return ptr;
+}
+
+size_t astSharedSize_( int reset, int *status ) {
+/*
+*+
+*  Name:
+*     astSharedSize
+
+*  Purpose:
+*     Return the total size of the shared memory found by astTSizeOf.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     size_t astSharedSize( int reset )
+
+*  Description:
+*     Each call to astTSizeOf that is given a pointer to shared memory
+*     (see astShare) adds the size of the memory to a running total.
+*     This function returns the current value of the total, and
+*     optionally resets it to zero. Each thread has its own total.
+
+*  Parameters:
+*     reset
+*        If non-zero, the total is reset to zero after returning its
+*        current value.
+
+*  Returned Value:
+*     astSharedSize()
+*        The total size of the shared memory found by astTSizeOf, in
+*        bytes.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   size_t result;                /* Returned value */
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Get the current total and reset it if required. */
+   result = shared_size;
+   if( reset ) shared_size = 0;
+
+/* Return the result. */
+   return result;
+}
+
 size_t astSizeOf_( const void *ptr, int *status ) {
 /*
 *++
@@ -3893,6 +6172,47 @@ size_t astSizeOf_( const void *ptr, int *status ) {
    return size;
 }
 
+static int SizeClass( size_t size ) {
+/*
+*  Name:
+*     SizeClass
+
+*  Purpose:
+*     Returns the size class used for a memory block of a given size.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     int SizeClass( size_t size )
+
+*  Description:
+*     This function returns the index of the smallest size class that can
+*     hold a memory block of the given size. The usable size of a memory
+*     block in size class "i" is ( MNCSIZE << i ) bytes.
+
+*  Parameters:
+*     size
+*        The size of the memory block, not including the Memory header.
+*        It should be no larger than MXCSIZE.
+
+*  Returned Value:
+*     The size class index.
+*/
+
+/* Local Variables: */
+   int result;
+   size_t csize;
+
+   result = 0;
+   csize = MNCSIZE;
+   while( csize < size ) {
+      csize <<= 1;
+      result++;
+   }
+   return result;
+}
+
 static size_t SizeOfMemory( int *status ){
 /*
 *  Name:
@@ -3982,6 +6302,8 @@ size_t astTSizeOf_( const void *ptr, int *status ) {
 *  Notes:
 *     - A value of zero is returned if this function is invoked with
 *     the global error status set, or if it fails for any reason.
+*     - If the memory is shared (see astShare), its size is also added
+*     to the running total returned by astSharedSize.
 *     - This function is documented as protected because it should not
 *     be invoked by external code. However, it is available via the
 *     external C interface so that it may be used when writing (e.g.)
@@ -3991,6 +6313,7 @@ size_t astTSizeOf_( const void *ptr, int *status ) {
 
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   Memory *mem;                  /* Pointer to memory header */
    int isdynamic;                /* Was the memory allocated dynamically? */
    size_t size;                  /* Memory size */
 
@@ -4007,14 +6330,151 @@ size_t astTSizeOf_( const void *ptr, int *status ) {
    the memory size from the header which precedes it. */
    if ( ptr ){
       IS_DYNAMIC( ptr, isdynamic );
-      if( isdynamic ) size = SIZEOF_MEMORY +
-                             ( (Memory *) ( (char *) ptr - SIZEOF_MEMORY ) )->size;
+      if( isdynamic ) {
+         mem = (Memory *) ( (char *) ptr - SIZEOF_MEMORY );
+         size = SIZEOF_MEMORY + mem->size;
+
+/* If the memory is shared, add its size to the total size of shared
+   memory. */
+         if( GET_NREF( mem ) > 1 ) shared_size += size;
+      }
    }
 
 /* Return the result. */
    return size;
 }
 
+void *astUnshare_( void *ptr, int *status ) {
+/*
+*+
+*  Name:
+*     astUnshare
+
+*  Purpose:
+*     Ensure dynamically allocated memory is not shared.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void *astUnshare( void *ptr )
+
+*  Description:
+*     This function should be called before modifying memory that may
+*     have been shared with other owners using astShare. If the memory
+*     is shared, a new copy of it is made and returned, and the caller
+*     ceases to be an owner of the original memory (which is left
+*     unchanged for its other owners). If the memory is not shared, the
+*     supplied pointer is returned unchanged, without copying the memory.
+
+*  Parameters:
+*     ptr
+*        Pointer to previously allocated memory (or NULL). An error
+*        will result if the memory has not previously been allocated by
+*        another function in this module.
+
+*  Returned Value:
+*     astUnshare()
+*        A pointer to memory holding the same values as the supplied
+*        memory, and owned only by the caller. This should be used in
+*        place of the supplied pointer.
+
+*  Notes:
+*     - The supplied pointer is returned if this function is invoked
+*     with the global error status set, or if it fails for any reason.
+*-
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   Memory *mem;                  /* Pointer to memory header */
+   int isdynamic;                /* Was the memory allocated dynamically? */
+   void *result;                 /* Returned pointer */
+
+/* Initialise. */
+   result = ptr;
+
+/* Check the global error status and the supplied pointer. */
+   if ( !astOK || !ptr ) return result;
+
+/* If needed, get a pointer to the thread specific global data structure. */
+   astGET_GLOBALS(NULL);
+
+/* Check the pointer identifies dynamically allocated memory. */
+   IS_DYNAMIC( ptr, isdynamic );
+   if( isdynamic ) {
+
+/* If the memory is shared, take a copy of it. If successful, free the
+   original memory. Since it is shared, this just reduces the number of
+   owners. */
+      mem = (Memory *) ( (char *) ptr - SIZEOF_MEMORY );
+      if( GET_NREF( mem ) > 1 ) {
+         result = astStore( NULL, ptr, mem->size );
+         if( result ) {
+            (void) astFree( ptr );
+         } else {
+            result = ptr;
+         }
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static void UMul128( uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo ) {
+/*
+*  Name:
+*     UMul128
+
+*  Purpose:
+*     Form the full 128-bit product of two 64-bit integers.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "memory.h"
+*     void UMul128( uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo )
+
+*  Class Membership:
+*     Memory member function.
+
+*  Parameters:
+*     a
+*        The first integer.
+*     b
+*        The second integer.
+*     hi
+*        Returned holding the most significant 64 bits of the product.
+*     lo
+*        Returned holding the least significant 64 bits of the product.
+*/
+
+#if defined(__SIZEOF_INT128__)
+   unsigned __int128 p = (unsigned __int128) a * b;
+   *hi = (uint64_t)( p >> 64 );
+   *lo = (uint64_t) p;
+
+#else
+/* Local Variables: */
+   uint64_t a0 = (uint32_t) a;   /* Low half of "a" */
+   uint64_t a1 = a >> 32;        /* High half of "a" */
+   uint64_t b0 = (uint32_t) b;   /* Low half of "b" */
+   uint64_t b1 = b >> 32;        /* High half of "b" */
+   uint64_t p00 = a0*b0;         /* Partial products */
+   uint64_t p01 = a0*b1;
+   uint64_t p10 = a1*b0;
+   uint64_t p11 = a1*b1;
+   uint64_t mid;                 /* Sum of middle partial products */
+
+   mid = ( p00 >> 32 ) + (uint32_t) p10 + (uint32_t) p01;
+   *lo = ( mid << 32 ) | (uint32_t) p00;
+   *hi = p11 + ( p10 >> 32 ) + ( p01 >> 32 ) + ( mid >> 32 );
+#endif
+}
+
 void *astStore_( void *ptr, const void *data, size_t size, int *status ) {
 /*
 *++
@@ -4594,11 +7054,29 @@ int astSscanf_( const char *str, const char *fmt, ...) {
 /* Get the length of the format string excluding any trailing white space. */
       lfor = astChrLen( fmt );
 
+/* Compare the ordinary characters at the start of the format string (up
+   to the first white space or field specifier) with the start of the
+   scanned string. */
+      c = (char *) fmt;
+      d = str;
+      while( *c && *c != '%' && !isspace( (int) *c ) && *c == *d ) {
+         c++;
+         d++;
+      }
+
+/* If they differ, sscanf would fail before making any conversions, so
+   there is no need to invoke it. Return EOF if the end of the scanned
+   string was reached, as sscanf would. Attribute names are identified
+   within the SetAttrib method of each class by a long sequence of calls
+   to this function, of which all but one will fail in this way, so this
+   makes a big difference to the speed of setting attribute values. */
+      if( *c && *c != '%' && !isspace( (int) *c ) ) {
+         ret = *d ? 0 : EOF;
+
 /* Bill Joye reports that MacOS sscanf fails to return the correct number of
    characters read (using a %n conversion) if there is a space before the
    %n. So check for this. Does the format string contain " %n"? */
-      c = strstr( fmt, " %n" );
-      if( c && astOK ) {
+      } else if( ( c = strstr( fmt, " %n" ) ) && astOK ) {
 
 /* Take a copy of the supplied format string (excluding any trailing spaces). */
          newfor = (char *) astStore( NULL, (void *) fmt, (size_t) lfor + 1 );
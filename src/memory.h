@@ -19,25 +19,44 @@
 
 *  Functions Defined:
 *     Public:
-*        None.
+*        astProfileReport
+*           Report the results of profiling.
 *
 *     Protected:
 *        astAppendString
 *           Append a string to another string which grows dynamically.
+*        astBeginScratch
+*           Begin a new context for scratch memory.
 *        astCalloc
 *           Allocate memory.
 *        astChrMatch
 *           Case-insensitive string comparison.
 *        astChrMatchN
 *           Case-insensitive string comparison of an most N characters.
+*        astEndScratch
+*           End a context for scratch memory.
 *        astFree
 *           Free previously allocated memory.
 *        astGrow
 *           Allocate memory for an adjustable array.
 *        astMalloc
 *           Allocate memory.
+*        astMemoryCacheStats
+*           Return statistics describing the cache of unused memory.
+*        astProfileStart
+*           Start profiling a call to a profiled function.
+*        astProfileStartClass
+*           Start profiling a call, given a class name.
+*        astProfileStop
+*           Stop profiling a call to a profiled function.
+*        astProfiling
+*           Enable or disable profiling.
 *        astRealloc
 *           Change the size of a dynamically allocated region of memory.
+*        astShare
+*           Share dynamically allocated memory with a new owner.
+*        astSharedSize
+*           Return the total size of the shared memory found by astTSizeOf.
 *        astSizeOf
 *           Determine the size of a dynamically allocated region of memory.
 *        astStore
@@ -52,11 +71,15 @@
 *           Returns length of a string without trailing white space, etc.
 *        astChrTrunc
 *           Terminate a string to exclude trailing spaces.
+*        astDouble2Chr
+*           Format a double using the fewest digits that read back exactly.
 *        astSscanf
 *           Like sscanf, but fixes certain platform-specific bugs in the
 *           native sscanf implementation.
 *        astTSizeOf
 *           Determine the total size of a dynamically allocated region of memory.
+*        astUnshare
+*           Ensure dynamically allocated memory is not shared.
 
 *  Copyright:
 *     Copyright (C) 1997-2006 Council for the Central Laboratory of the
@@ -81,6 +104,7 @@
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: D.S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     8-JAN-1996 (RFWS):
@@ -117,6 +141,19 @@
 *        Added astStringCase.
 *     26-MAR-2015 (DSB):
 *        Added astChrTrunc.
+*     18-OCT-2026 (AGT):
+*        - Added astDouble2Chr.
+*        - Cache memory blocks in power-of-two size classes, and added
+*        astMemoryCacheStats.
+*        - Added astBeginScratch and astEndScratch.
+*        - Added astShare, astUnshare and astSharedSize, and a count of
+*        owners to the Memory header.
+*        - Added astProfiling, astProfileStart, astProfileStop and
+*        astProfileReport.
+*        - Added astProfileStartClass.
+*     19-OCT-2026 (AGT):
+*        Decide whether to use an atomic owner count in the Memory header
+*        using the result of the configure test that is used by object.h.
 
 *-
 */
@@ -150,15 +187,31 @@
 
 #if defined(astCLASS)
 
+/* If thread-safety is required and AST was configured with C11 atomic
+   types, the number of owners of a shared memory block is held in an
+   atomic integer so that it can be changed without locking a mutex. This
+   uses the same configure test as object.h, so that memory.c and object.c
+   agree about the layout of the Memory structure. */
+#if defined(THREAD_SAFE) && defined(HAVE_ATOMIC_INT)
+#include <stdatomic.h>
+#define AST__ATOMIC 1
+#endif
+
 /* Header for allocated memory. */
 /* ---------------------------- */
 /* This stores a "magic" value so that dynamically allocated memory
-   can be recognised, together with the allocated size. It also
-   ensures correct alignment. */
+   can be recognised, together with the allocated size and the number
+   of owners (greater than one if the memory is shared - see astShare).
+   It also ensures correct alignment. */
 typedef struct Memory {
    struct Memory *next;
    unsigned long magic;
    size_t size;
+#if defined(AST__ATOMIC)
+   atomic_int nref;
+#else
+   int nref;
+#endif
 
 #ifdef MEM_DEBUG
    struct Memory *prev; /* Pointer to the previous linked Memory structure */
@@ -170,11 +223,27 @@ typedef struct Memory {
 
 } Memory;
 
-/* Define the largest size of a cached memory block in bytes. This does
-   not include the size of the Memory header. This does not need to be
-   too big because the vast majority of memory blocks allocated by AST are
-   less than a few hundred bytes. */
-#define MXCSIZE 300
+/* Memory blocks of up to MXCSIZE bytes (not including the Memory header)
+   are allocated in a set of NCSIZE size classes. The usable size of a
+   block in class "i" is ( MNCSIZE << i ) bytes, and each request is
+   rounded up to the smallest class that can hold it. This allows freed
+   blocks to be cached and re-used for any request in the same class. */
+#define MNCSIZE 16
+#define NCSIZE 12
+#define MXCSIZE ( MNCSIZE << ( NCSIZE - 1 ) )
+
+/* Profiling. */
+/* ---------- */
+/* This structure records the state of a single call to a profiled
+   function. It is initialised by astProfileStart and used by
+   astProfileStop. */
+typedef struct AstProfileCall {
+   void *node;      /* Node in the call tree, or NULL if not profiled */
+   void *parent;    /* The thread's current node before the call */
+   int epoch;       /* Profiling epoch in which the call started */
+   double t0;       /* Wall-clock time at the start of the call */
+   size_t nalloc0;  /* Thread's allocation count at the start of the call */
+} AstProfileCall;
 
 #endif
 
@@ -187,7 +256,15 @@ typedef struct AstMemoryGlobals {
    size_t Sizeof_Memory;
    int Cache_Init;
    int Use_Cache;
-   Memory *Cache[ MXCSIZE + 1 ];
+   Memory *Cache[ NCSIZE ];
+   int Cache_Count[ NCSIZE ];
+   size_t Cache_Hits;
+   size_t Cache_Misses;
+   int Scratch_Depth;
+   size_t Shared_Size;
+   size_t Alloc_Count;
+   void *Profile_Current;
+   int Profile_Epoch;
 
 } AstMemoryGlobals;
 
@@ -211,6 +288,9 @@ void astInitMemoryGlobals_( AstMemoryGlobals * );
                                  /* use in developing (e.g.) foreign */
                                  /* language or graphics interfaces. */
 int astMemCaching_( int, int * );
+void astMemoryCacheStats_( int, size_t *, size_t *, size_t *, size_t *, int * );
+void astBeginScratch_( int * );
+void astEndScratch_( int * );
 void astChrClean_( char * );
 void astChrRemoveBlanks_( char * );
 void astChrCase_( const char *, char *, int, int, int * );
@@ -229,6 +309,11 @@ AstStringList *astFreeStringList_( AstStringList *, int * );
 void astAppendStringList_( AstStringList *, const char *, int * );
 int astIsDynamic_( const void *, int * );
 size_t astTSizeOf_( const void *, int * );
+void *astShare_( void *, int * );
+void *astUnshare_( void *, int * );
+size_t astSharedSize_( int, int * );
+int astProfiling_( int, int * );
+void astProfileReport_( const char *, int, int * );
 void *astFree_( void *, int * );
 void *astFreeDouble_( void *, int * );
 void *astGrow_( void *, size_t, size_t, int * );
@@ -238,6 +323,7 @@ void *astRealloc_( void *, size_t, int * );
 void *astStore_( void *, const void *, size_t, int * );
 size_t astChrLen_( const char *, int * );
 double astChr2Double_( const char *, int * );
+int astDouble2Chr_( double, int, char *, int * );
 void astRemoveLeadingBlanks_( char *, int * );
 char *astAppendString_( char *, int *, const char *, int * );
 char *astAppendStringf_( char *, int *, const char *, ... )__attribute__((format(printf,3,4)));
@@ -246,6 +332,12 @@ void astChrTrunc_( char *, int * );
 int astBrackets_( const char *, size_t, size_t, char, char, int, size_t *, size_t *, char **, char **, char **, int * );
 void astFandl_( const char *, size_t, size_t, size_t *, size_t *, int * );
 
+#if defined(astCLASS)
+void astProfileStart_( AstProfileCall *, const char *, void *, double, int * );
+void astProfileStartClass_( AstProfileCall *, const char *, const char *, double, int * );
+void astProfileStop_( AstProfileCall *, int * );
+#endif
+
 #ifdef MEM_PROFILE
 void astStartTimer_( const char *, int, const char *, int * );
 void astStopTimer_( int * );
@@ -283,10 +375,16 @@ void astEndPM_( int * );
 #define astGrow(ptr,n,size) astERROR_INVOKE(astGrow_(ptr,n,size,STATUS_PTR))
 #define astMalloc(size) astERROR_INVOKE(astMalloc_(size,0,STATUS_PTR))
 #define astMemCaching(flag) astERROR_INVOKE(astMemCaching_(flag,STATUS_PTR))
+#define astMemoryCacheStats(reset,nhit,nmiss,nbyte,ndepot) astERROR_INVOKE(astMemoryCacheStats_(reset,nhit,nmiss,nbyte,ndepot,STATUS_PTR))
 #define astRealloc(ptr,size) astERROR_INVOKE(astRealloc_(ptr,size,STATUS_PTR))
 #define astSizeOf(ptr) astERROR_INVOKE(astSizeOf_(ptr,STATUS_PTR))
 #define astIsDynamic(ptr) astERROR_INVOKE(astIsDynamic_(ptr,STATUS_PTR))
 #define astTSizeOf(ptr) astERROR_INVOKE(astTSizeOf_(ptr,STATUS_PTR))
+#define astShare(ptr) astERROR_INVOKE(astShare_(ptr,STATUS_PTR))
+#define astUnshare(ptr) astERROR_INVOKE(astUnshare_(ptr,STATUS_PTR))
+#define astSharedSize(reset) astERROR_INVOKE(astSharedSize_(reset,STATUS_PTR))
+#define astProfiling(value) astERROR_INVOKE(astProfiling_(value,STATUS_PTR))
+#define astProfileReport(fname,json) astERROR_INVOKE(astProfileReport_(fname,json,STATUS_PTR))
 #define astStore(ptr,data,size) astERROR_INVOKE(astStore_(ptr,data,size,STATUS_PTR))
 #define astAppendString(str1,nc,str2) astERROR_INVOKE(astAppendString_(str1,nc,str2,STATUS_PTR))
 #define astAppendStringf astAppendStringf_
@@ -298,6 +396,7 @@ void astEndPM_( int * );
 #define astChrLen(string) astERROR_INVOKE(astChrLen_(string,STATUS_PTR))
 #define astChrTrunc(string) astERROR_INVOKE(astChrTrunc_(string,STATUS_PTR))
 #define astChr2Double(string) astERROR_INVOKE(astChr2Double_(string,STATUS_PTR))
+#define astDouble2Chr(value,prec,buf) astERROR_INVOKE(astDouble2Chr_(value,prec,buf,STATUS_PTR))
 #define astRemoveLeadingBlanks(string) astERROR_INVOKE(astRemoveLeadingBlanks_(string,STATUS_PTR))
 #define astChrSub(test,template,subs,nsub) astERROR_INVOKE(astChrSub_(test,template,subs,nsub,STATUS_PTR))
 #define astChrCase(in,out,upper,blen) astERROR_INVOKE(astChrCase_(in,out,upper,blen,STATUS_PTR))
@@ -306,6 +405,11 @@ void astEndPM_( int * );
 
 #if defined(astCLASS) /* Protected */
 #define astMallocInit(size) astMalloc_(size,1,STATUS_PTR)
+#define astBeginScratch astBeginScratch_(STATUS_PTR)
+#define astEndScratch astEndScratch_(STATUS_PTR)
+#define astProfileStart(call,op,object,npoint) astProfileStart_(call,op,object,npoint,STATUS_PTR)
+#define astProfileStartClass(call,op,class,npoint) astProfileStartClass_(call,op,class,npoint,STATUS_PTR)
+#define astProfileStop(call) astProfileStop_(call,STATUS_PTR)
 #define astStringList(nline) astERROR_INVOKE(astStringList_(nline,STATUS_PTR))
 #define astFreeStringList(list) astERROR_INVOKE(astFreeStringList_(list,STATUS_PTR))
 #define astAppendStringList(list,text) astERROR_INVOKE(astAppendStringList_(list,text,STATUS_PTR))
@@ -115,6 +115,7 @@ f     - AST_TESTCELL: Test if a single HEALPix cell is included in a Moc
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     10-OCT-2018 (DSB):
@@ -150,6 +151,12 @@ f     - AST_TESTCELL: Test if a single HEALPix cell is included in a Moc
 *     4-MAR-2020 (DSB):
 *        Changes to remove bugs that occur only when running on 32-bit
 *        systems.
+*     18-OCT-2026 (AGT):
+*        - Override the astRegPointsIn and astRegFixedMesh methods.
+*        - Copies of a Moc now share the arrays of cell ranges, normalised
+*        cells and mesh distances with the original Moc, rather than
+*        copying them.
+*        - Override the astGetObjSize method.
 *class--
 */
 
@@ -336,6 +343,7 @@ static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
 static int (* parent_equal)( AstObject *, AstObject *, int * );
+static size_t (* parent_getobjsize)( AstObject *, int * );
 
 
 #ifdef THREAD_SAFE
@@ -403,6 +411,7 @@ static AstRegion *GetDefUnc( AstRegion *, int * );
 static Cell *MakeCell( int, int, int, Cell **, int * );
 static double GetMocArea( AstMoc *, int * );
 static double GetPixelArea( AstFrameSet *, const AstDim *, int * );
+static size_t GetObjSize( AstObject *, int * );
 static double OrderToRes( int order );
 static int Comp_corner( const void *, const void * );
 static int Comp_decra( const void *, const void * );
@@ -410,7 +419,9 @@ static int Comp_endpoint( const void *, const void * );
 static int Comp_range( const void *, const void * );
 static int Comp_int64( const void *, const void * );
 static int Equal( AstObject *, AstObject *, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static int ResToOrder( double );
 static int log2_32( int );
@@ -5193,6 +5204,75 @@ static void GetNorm( AstMoc *this, const char *method, int *status ){
 
 }
 
+static size_t GetObjSize( AstObject *this_object, int *status ) {
+/*
+*  Name:
+*     GetObjSize
+
+*  Purpose:
+*     Return the in-memory size of an Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     size_t GetObjSize( AstObject *this, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astGetObjSize protected
+*     method inherited from the parent class).
+
+*  Description:
+*     This function returns the in-memory size of the supplied Moc,
+*     in bytes.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The Object size, in bytes.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global status set, or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   AstMoc *this;
+   size_t result;
+
+/* Initialise. */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointers to the Moc structure. */
+   this = (AstMoc *) this_object;
+
+/* Invoke the GetObjSize method inherited from the parent class, and then
+   add on any components of the class structure defined by this class
+   which are stored in dynamically allocated memory. */
+   result = (*parent_getobjsize)( this_object, status );
+
+   result += astTSizeOf( this->range );
+   result += astTSizeOf( this->knorm );
+   result += astTSizeOf( this->inorm );
+   result += astTSizeOf( this->meshdist );
+   result += astGetObjSize( this->basemesh );
+   result += astGetObjSize( this->unc );
+
+/* If an error occurred, clear the result value. */
+   if ( !astOK ) result = 0;
+
+/* Return the result, */
+   return result;
+}
+
 static double GetPixelArea( AstFrameSet *wcs, const AstDim *dims, int *status ){
 /*
 *  Name:
@@ -5696,12 +5776,17 @@ void astInitMocVtab_(  AstMocVtab *vtab, const char *name, int *status ) {
    parent_equal = object->Equal;
    object->Equal = Equal;
 
+   parent_getobjsize = object->GetObjSize;
+   object->GetObjSize = GetObjSize;
+
    parent_transform = mapping->Transform;
    mapping->Transform = Transform;
 
    region->RegBaseBox = RegBaseBox;
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
    region->GetDefUnc = GetDefUnc;
    region->RegTrace = RegTrace;
 
@@ -6291,6 +6376,11 @@ static void MergeRanges( AstMoc *this, int start, int *status ){
    first range to be merged is the last range. */
    if( this->nrange > 1 && start < this->nrange - 1 ) {
 
+/* The ranges are modified in place below, so ensure the array is not
+   shared with any other Moc (see astShare). */
+      this->range = astUnshare( this->range );
+      if( !astOK ) return;
+
 /* Sort the specified ranges into increasing order of lower bound. */
       qsort( this->range + 2*start, this->nrange - start,
              2*sizeof(*(this->range)), Comp_range );
@@ -6461,6 +6551,11 @@ static void NegateRanges( AstMoc *this, int start, int order,
 /* Nothing to do if the Moc is empty, or no ranges are to be negated. */
    if( this->nrange > 0 && start < this->nrange ) {
 
+/* The ranges are modified in place below, so ensure the array is not
+   shared with any other Moc (see astShare). */
+      this->range = astUnshare( this->range );
+      if( !astOK ) return;
+
 /* Get the maximum number of nested indices at the highest order in use.
    The indices go from zero to (max_nest-1). */
       max_nest = 12*( ONE << 2*order );
@@ -8000,6 +8095,45 @@ fclose( fd );
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh cached in the Moc is formed by tracing the outline of the
+*     Moc cells within the base (pixel or sky) Frame, and so can be
+*     retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -8275,6 +8409,153 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a Moc.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "moc.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     Moc member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Moc, and sets the corresponding bit in the
+*     supplied packed bit mask. The tests are the same as those performed
+*     by the astTransform method, but no output PointSet is created, and
+*     the range containing each cell is located using a binary search.
+
+*  Parameters:
+*     this
+*        Pointer to the Moc.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the Moc.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the Moc.
+
+*/
+
+/* Local Variables: */
+   AstDim ipoint;           /* Index of input point */
+   AstDim npoint;           /* No. of input points */
+   AstDim result;           /* Returned number of inside points */
+   AstMapping *map1;        /* Sky->HPX12 grid coords Mapping */
+   AstMoc *this;            /* Pointer to Moc */
+   AstPointSet *ps1;        /* PointSet holding HPX12 grid coords */
+   AstPointSet *pset_tmp;   /* Pointer to PointSet holding ICRS positions */
+   double **ptr;            /* Pointer to grid (x,y) coordinate data */
+   double *px;              /* Pointer to grid X values */
+   double *py;              /* Pointer to grid Y values */
+   int hi;                  /* Index of last range that may hold the cell */
+   int inside;              /* Point inside Moc? */
+   int lo;                  /* Index of first range that may hold the cell */
+   int mid;                 /* Index of range to test */
+   int neg;                 /* Has the Region been negated? */
+   int order;               /* HEALPix order used by the moc */
+   int64_t inest;           /* Nested index of cell holding current position */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Obtain a pointer to the Moc structure. */
+   this = (AstMoc *) this_region;
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet (ICRS). The returned PointSet may be a clone of
+   "pset" and so must not be modified. */
+   pset_tmp = astRegTransform( this_region, pset, 0, NULL, NULL );
+   npoint = astGetNpoint( pset_tmp );
+
+/* See if the Region has been negated. */
+   neg = astGetNegated( this_region );
+
+/* Clear the returned mask. */
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+   if ( astOK ) {
+
+/* Get the HEALPix order used by the Moc, and a Mapping that goes from
+   ICRS to grid coordinates in an HPX12 projection of the whole sky with
+   the Moc's order. Use it to convert all the ICRS positions to HPX12
+   grid coords. */
+      order = astGetMaxOrder( this );
+      map1 = GetCachedMapping( this, order, "astPointsInRegion", status );
+      ps1 = astTransform( map1, pset_tmp, 1, NULL );
+      ptr = astGetPoints( ps1 );
+
+      if( astOK ) {
+         px = ptr[ 0 ];
+         py = ptr[ 1 ];
+         for( ipoint = 0; ipoint < npoint; ipoint++, px++, py++ ) {
+
+/* Positions that cannot be converted to grid coords are outside the
+   Region. */
+            if( *px == AST__BAD || *py == AST__BAD ) continue;
+
+/* Convert from grid (x,y) to nested index. */
+            inest = XyToNested( order, (int)( *px + 0.5 ), (int)( *py + 0.5 ) );
+
+/* Find the first range that ends at or after "inest". Each pair of
+   adjacent values in the "this->range" array are the lower and upper
+   bounds of a range of nested indices contained in the Moc, stored in
+   ascending order, so a binary search can be used. The position is
+   inside the Moc if this range starts at or before "inest". */
+            lo = 0;
+            hi = this->nrange;
+            while( lo < hi ) {
+               mid = ( lo + hi )/2;
+               if( this->range[ 2*mid + 1 ] < inest ) {
+                  lo = mid + 1;
+               } else {
+                  hi = mid;
+               }
+            }
+            inside = ( lo < this->nrange && this->range[ 2*lo ] <= inest );
+
+/* Negate the inside flag if the Region has been negated. */
+            if( neg ) inside = !inside;
+
+            if( inside ) {
+               mask[ ipoint/8 ] |= (unsigned char)( 1 << ( ipoint % 8 ) );
+               result++;
+            }
+         }
+      }
+
+/* Free resources */
+      ps1 = astAnnul( ps1 );
+   }
+   pset_tmp = astAnnul( pset_tmp );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -9816,7 +10097,8 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
 *        Pointer to the inherited status variable.
 
 *  Notes:
-*     -  This constructor makes a deep copy.
+*     -  This constructor makes a deep copy, except that the dynamic
+*     arrays are shared with the input Moc (see astShare).
 */
 
 /* Local Variables: */
@@ -9839,14 +10121,13 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->meshdist = NULL;
    out->unc = NULL;
 
-/* Copy dynamic arrays */
-   out->range = astStore( NULL, in->range, astSizeOf( in->range ) );
-   if( in->knorm ) out->knorm = astStore( NULL, in->knorm,
-                                          astSizeOf( in->knorm ));
-   if( in->inorm ) out->inorm = astStore( NULL, in->inorm,
-                                          astSizeOf( in->inorm ));
-   if( in->meshdist ) out->meshdist = astStore( NULL, in->meshdist,
-                                          astSizeOf( in->meshdist ));
+/* Share dynamic arrays with the input Moc. Functions that modify these
+   arrays in place (rather than replacing them) must first call
+   astUnshare. Note, astGrow and astRealloc do this automatically. */
+   out->range = astShare( in->range );
+   if( in->knorm ) out->knorm = astShare( in->knorm );
+   if( in->inorm ) out->inorm = astShare( in->inorm );
+   if( in->meshdist ) out->meshdist = astShare( in->meshdist );
    if( in->unc ) out->unc = astCopy( in->unc );
    if( in->basemesh ) out->basemesh = astCopy( in->basemesh );
 
@@ -27,6 +27,7 @@
 *     - ID: Object identification string
 *     - Ident: Permanent Object identification string
 *     - Nobject: Number of Objects in class
+*     - ObjShared: Number of bytes of ObjSize shared with other Objects
 *     - ObjSize: The in-memory size of the Object in bytes
 *     - RefCount: Count of active Object pointers
 *     - UseDefs: Allow use of default values for Object attributes?
@@ -113,6 +114,7 @@ f     - AST_VERSION: Return the verson of the AST library being used.
 *  Authors:
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     1-FEB-1996 (RFWS):
@@ -241,6 +243,36 @@ f     - AST_VERSION: Return the verson of the AST library being used.
 *        Include thrThread in public metrhod list, and change it so 
 *        that it does not report an error if the supplied object handle
 *        is owned by a different thread.
+*     18-OCT-2026 (AGT):
+*        - Added Threads tuning parameter.
+*        - Added FitsWcsCache tuning parameter.
+*        - The default value for the Threads tuning parameter is now
+*        taken from the AST_THREADS environment variable.
+*        - When C11 atomics are available, the reference count and the
+*        identity of the locking thread are now changed atomically, so
+*        that astClone, astAnnul and uncontended calls to astLock and
+*        astUnlock no longer need to lock any mutex.
+*        - The "handles" array is now divided into fixed slabs, and each
+*        thread allocates Handles from its own list of free Handles, so
+*        that creating, annulling and using Object identifiers no longer
+*        requires a mutex to be locked. A generation count is included in
+*        each identifier so that stale identifiers are still detected.
+*        - astLock now waits for a Handle that is owned by another thread
+*        to be released, rather than reporting an error, when "wait" is
+*        non-zero.
+*        - The MemoryCaching tuning parameter now applies to memory blocks
+*        of up to 32768 bytes.
+*        - astVSet now caches the list of attribute assignments obtained
+*        from each setting string, so that repeated use of the same
+*        setting string does not need to parse it again. It also uses
+*        local buffers rather than allocated memory for short strings, as
+*        do astGet, astTest and astClear.
+*        - Added protected function astAttribKnown.
+*        - Added read-only attribute ObjShared.
+*        - Added Profile tuning parameter.
+*     19-OCT-2026 (AGT):
+*        In astVSet, use vsnprintf to format attribute settings, so that
+*        long formatted settings do not overflow the local buffer.
 *class--
 */
 
@@ -253,6 +285,7 @@ f     - AST_VERSION: Return the verson of the AST library being used.
 
 #define INVALID_CONTEXT -1   /* Context value for handles that have no
                                 associated Object */
+#define NAME_BUFF_LEN 50     /* Length of local buffers for attribute names */
 #define UNOWNED_CONTEXT -2   /* Context value for handles for objects
                                 that are not locked by any thread */
 
@@ -275,6 +308,8 @@ f     - AST_VERSION: Return the verson of the AST library being used.
 #include "keymap.h"              /* Hash tables */
 #include "object.h"              /* Interface definition for this class */
 #include "plot.h"                /* Plot class (for astStripEscapes) */
+#include "parallel.h"            /* Worker thread pool (for astParallelThreads) */
+#include "fitschan.h"            /* FitsChan class (for astFitsWcsCache) */
 #include "globals.h"             /* Thread-safe global data access */
 
 /* Error code definitions. */
@@ -346,9 +381,13 @@ static int object_caching = 0;
    globals->AstGetC_Init = 0; \
    globals->AstGetC_Istr = 0; \
    globals->Active_Handles = NULL; \
+   globals->Free_Handles = -1; \
+   globals->Nfree_Handles = 0; \
    globals->Class_Init = 0; \
    globals->Nvtab = 0; \
-   globals->Known_Vtabs = NULL;
+   globals->Known_Vtabs = NULL; \
+   globals->Frozen_Held = 0; \
+   globals->Set_Cache_Init = 0;
 
 /* Create the function that initialises global data for this module. */
 astMAKE_INITGLOBALS(Object)
@@ -357,6 +396,8 @@ astMAKE_INITGLOBALS(Object)
 #define retain_esc  astGLOBAL(Object,Retain_Esc)
 #define context_level  astGLOBAL(Object,Context_Level)
 #define active_handles  astGLOBAL(Object,Active_Handles)
+#define free_handles  astGLOBAL(Object,Free_Handles)
+#define nfree_handles  astGLOBAL(Object,Nfree_Handles)
 #define getattrib_buff  astGLOBAL(Object,GetAttrib_Buff)
 #define astgetc_strings  astGLOBAL(Object,AstGetC_Strings)
 #define astgetc_istr  astGLOBAL(Object,AstGetC_Istr)
@@ -365,6 +406,10 @@ astMAKE_INITGLOBALS(Object)
 #define class_vtab astGLOBAL(Object,Class_Vtab)
 #define nvtab astGLOBAL(Object,Nvtab)
 #define known_vtabs astGLOBAL(Object,Known_Vtabs)
+#define frozen_held astGLOBAL(Object,Frozen_Held)
+#define set_cache_init astGLOBAL(Object,Set_Cache_Init)
+#define set_cache_key astGLOBAL(Object,Set_Cache_Key)
+#define set_cache_list astGLOBAL(Object,Set_Cache_List)
 
 /* mutex1 is used to prevent tuning parameters being accessed by more
    than one thread at any one time.  */
@@ -372,23 +417,47 @@ static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX1 pthread_mutex_lock( &mutex1 );
 #define UNLOCK_MUTEX1 pthread_mutex_unlock( &mutex1 );
 
-/* mutex2 is used to prevent the global lists of object handles being
-   accessed by more than one thread at any one time.  */
+/* mutex2 is used to prevent the global lists of object handles (the
+   lists of spare and unowned handles, and the list of allocated slabs)
+   being accessed by more than one thread at any one time. Each thread's
+   own lists of active and free handles are not protected by this mutex. */
 static pthread_mutex_t mutex2 = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX2 pthread_mutex_lock( &mutex2 );
 #define UNLOCK_MUTEX2 pthread_mutex_unlock( &mutex2 );
 
+/* mutex3 is used to prevent more than one thread at any one time from
+   invoking methods that make temporary changes to frozen Objects (see
+   astFrozenLock). */
+static pthread_mutex_t mutex3 = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_MUTEX3 pthread_mutex_lock( &mutex3 );
+#define UNLOCK_MUTEX3 pthread_mutex_unlock( &mutex3 );
+
 /* Each Object contains two mutexes. The primary mutex (mutex1) is used
    to guard access to all aspects of the Object except for the "locker"
    and "ref_count" items. The secondary mutex (mutex2) is used to guard
    access to these two remaining items. We need this secondary mutex
    since the "locker" and "ref_count" items need to be accessable within
    a thread even if that thread has not locked the Object using astLock.
-   Define macros for accessing these two mutexes. */
+   Define macros for accessing these two mutexes.
+
+   If C11 atomics are available, "locker" and "ref_count" are atomic
+   integers that are changed without locking any mutex, and there is no
+   primary mutex. Instead, the secondary mutex is used together with the
+   "unlocked" condition variable only by threads that have to wait for
+   another thread to unlock the Object. */
+#if defined(AST__ATOMIC)
+#define LOCK_SMUTEX(this) (pthread_mutex_lock(&((this)->mutex2)))
+#define UNLOCK_SMUTEX(this) (pthread_mutex_unlock(&((this)->mutex2)))
+#define CHANGE_REFCOUNT(this,delta) (atomic_fetch_add(&((this)->ref_count),(delta))+(delta))
+#define GET_REFCOUNT(this) atomic_load(&((this)->ref_count))
+#else
 #define LOCK_PMUTEX(this) (pthread_mutex_lock(&((this)->mutex1)))
 #define UNLOCK_PMUTEX(this) (pthread_mutex_unlock(&((this)->mutex1)))
 #define LOCK_SMUTEX(this) (pthread_mutex_lock(&((this)->mutex2)))
 #define UNLOCK_SMUTEX(this) (pthread_mutex_unlock(&((this)->mutex2)))
+#define CHANGE_REFCOUNT(this,delta) ChangeRefCount(this,delta,status)
+#define GET_REFCOUNT(this) ChangeRefCount(this,0,status)
+#endif
 
 
 
@@ -419,6 +488,11 @@ static int context_level = 0;
    structures). */
 static int *active_handles = NULL;
 
+/* Head of the list of free Handle structures, and the number of Handles
+   in the list. */
+static int free_handles = -1;
+static int nfree_handles = 0;
+
 /* String returned by GetAttrib. */
 static char getattrib_buff[ AST__GETATTRIB_BUFF_LEN + 1 ] = "";
 
@@ -431,6 +505,12 @@ static int astgetc_istr = 0;
 /* "AstGetC_Strings" array initialised? */
 static int astgetc_init = 0;
 
+/* Cache of formatted setting strings used by astVSet, and the
+   corresponding lists of processed attribute assignments. */
+static int set_cache_init = 0;
+static char set_cache_key[ AST__SETCACHE_SIZE ][ AST__SETCACHE_LEN + 1 ];
+static char set_cache_list[ AST__SETCACHE_SIZE ][ 2*AST__SETCACHE_LEN + 2 ];
+
 /* Null macros for mutex locking and unlocking */
 #define LOCK_MUTEX1
 #define UNLOCK_MUTEX1
@@ -441,6 +521,10 @@ static int astgetc_init = 0;
 #define UNLOCK_PMUTEX(this)
 #define UNLOCK_SMUTEX(this)
 
+/* Macros for changing and getting the Object reference count. */
+#define CHANGE_REFCOUNT(this,delta) ((this)->ref_count += (delta))
+#define GET_REFCOUNT(this) ((this)->ref_count)
+
 #endif
 
 
@@ -468,6 +552,7 @@ static void ClearID( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static void EmptyObjectCache( int * );
 static void ToStringSink( const char * );
+static int SetCacheIndex( const char *, int * );
 static void SetAttrib( AstObject *, const char *, int * );
 static void SetID( AstObject *, const char *, int * );
 static void SetIdent( AstObject *, const char *, int * );
@@ -483,6 +568,9 @@ static void SetUseDefs( AstObject *, int, int * );
 #if defined(THREAD_SAFE)
 static void ChangeThreadVtab( AstObject *, int * );
 static int ManageLock( AstObject *, int, int, AstObject **, int * );
+#if !defined(AST__ATOMIC)
+static int ChangeRefCount( AstObject *, int, int * );
+#endif
 #endif
 
 /* Member functions. */
@@ -553,32 +641,27 @@ f     error value
 *--
 */
 
+/* Local Variables: */
+   int rc;                       /* New reference count */
+
 /* Check the pointer to ensure it identifies a valid Object (this
    generates an error if it doesn't). */
    if ( !astIsAObject( this ) ) return NULL;
 
-/* Get a lock on the object's secondary mutex. This mutex guards access
-   to the "ref_count" and "locker" components of the AstObject structure. */
-   LOCK_SMUTEX(this);
+/* Decrement the Object's reference count. The new count is returned by
+   the same (atomic or mutex-protected) operation, so only one thread can
+   see the count fall to zero. */
+   rc = CHANGE_REFCOUNT( this, -1 );
 
 #ifdef MEM_DEBUG
-   {   int rc;
-       char buf[100];
-       rc = this->ref_count;
-       sprintf(buf,"annulled (refcnt: %d -> %d)", rc, rc-1 );
+   {   char buf[100];
+       sprintf(buf,"annulled (refcnt: %d -> %d)", rc+1, rc );
        astMemoryUse( this, buf );
    }
 #endif
 
-/* Decrement the Object's reference count. */
-   --(this->ref_count);
-
-/* Unlock the object's secondary mutex. */
-   UNLOCK_SMUTEX(this);
-
-/* Decrement the Object's reference count and delete the Object if
-   necessary. */
-   if ( !this->ref_count ) (void) astDelete( this );
+/* Delete the Object if no pointers to it remain. */
+   if ( !rc ) (void) astDelete( this );
 
 /* Always return NULL. */
    return NULL;
@@ -759,6 +842,68 @@ AstObject *astCastCopy_( AstObject *this, AstObject *obj, int *status ) {
    return new;
 }
 
+#if defined(THREAD_SAFE) && !defined(AST__ATOMIC)
+static int ChangeRefCount( AstObject *this, int delta, int *status ){
+/*
+*  Name:
+*     ChangeRefCount
+
+*  Purpose:
+*     Change the reference count of an Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int ChangeRefCount( AstObject *this, int delta, int *status )
+
+*  Class Membership:
+*     Object member function.
+
+*  Description:
+*     This function adds a given value to the reference count of an
+*     Object and returns the new reference count. The Object's secondary
+*     mutex is locked while this is done. It is only used if C11 atomics
+*     are not available (otherwise the reference count is changed
+*     atomically without locking a mutex).
+
+*  Parameters:
+*     this
+*        Pointer to the Object.
+*     delta
+*        The value to add to the reference count. May be zero.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The new reference count.
+
+*  Notes:
+*     - This function attempts to execute even if an error has already
+*     occurred.
+
+*/
+
+/* Local Variables: */
+   int result;                   /* Returned value */
+
+/* Get a lock on the object's secondary mutex. This mutex guards access
+   to the "ref_count" and "locker" components of the AstObject structure. */
+   LOCK_SMUTEX(this);
+
+/* Change the reference count. */
+   this->ref_count += delta;
+   result = this->ref_count;
+
+/* Unlock the object's secondary mutex. */
+   UNLOCK_SMUTEX(this);
+
+/* Return the new reference count. */
+   return result;
+}
+#endif
+
 #if defined(THREAD_SAFE)
 static void ChangeThreadVtab( AstObject *this, int *status ){
 /*
@@ -879,8 +1024,9 @@ AstObject *astCheckLock_( AstObject *this, int *status ) {
 /* Local Variables; */
    AstObject *fail;
 
-/* Check the supplied pointer. */
-   if( this ) {
+/* Check the supplied pointer. Frozen Objects (and all the Objects they
+   contain) may be used by any thread, so no further checks are needed. */
+   if( this && !this->frozen ) {
 
 /* First use the private ManageLock function rather than the virtual
    astManageLock method to check the top level Object is locked for use
@@ -914,6 +1060,153 @@ AstObject *astCheckLock_( AstObject *this, int *status ) {
 
 }
 
+int astCheckFrozen_( AstObject *this, const char *method, int *status ) {
+/*
+*+
+*  Name:
+*     astCheckFrozen
+
+*  Purpose:
+*     Report an error if an Object has been frozen.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int astCheckFrozen( AstObject *this, const char *method )
+
+*  Class Membership:
+*     Object method.
+
+*  Description:
+*     This function reports an error if the supplied Object has been
+*     frozen using astFreeze. It should be invoked by methods that modify
+*     an Object, before any modification is made.
+
+*  Parameters:
+*     this
+*        Pointer to the Object.
+*     method
+*        Pointer to a null terminated string holding the name of the
+*        method that is about to modify the Object. This is used only
+*        in the error message.
+
+*  Returned Value:
+*     Non-zero if the Object has been frozen, and zero otherwise.
+
+*  Notes:
+*     - A value of zero is returned if this function is invoked with
+*     the global error status set.
+
+*-
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Report an error if the Object is frozen. */
+   if( this && this->frozen ) {
+      astError( AST__FROZN, "%s(%s): The supplied %s cannot be modified "
+                "because it has been frozen (programming error).", status,
+                method, astGetClass( this ), astGetClass( this ) );
+      return 1;
+   }
+   return 0;
+}
+
+int astAttribKnown_( const char *attrib, const char *const names[],
+                     int nname, int *status ) {
+/*
+*+
+*  Name:
+*     astAttribKnown
+
+*  Purpose:
+*     Determine if an attribute name is in a class's table of names.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int astAttribKnown( const char *attrib, const char *const names[],
+*                         int nname )
+
+*  Class Membership:
+*     Object method.
+
+*  Description:
+*     This function returns a flag indicating if the attribute name
+*     at the start of the supplied string is included in a table of
+*     attribute names. The name is taken to be the characters preceding
+*     the first "(" or "=" character (or the whole string if neither is
+*     present). Any axis index or graphical element in parentheses is
+*     therefore ignored.
+*
+*     It is intended to be used at the start of the astGetAttrib,
+*     astSetAttrib, astTestAttrib and astClearAttrib methods of classes
+*     that define many attributes, so that attributes defined by a parent
+*     class can be passed on to the parent class immediately, rather
+*     than after being compared with each of the attributes defined by
+*     the class.
+
+*  Parameters:
+*     attrib
+*        Pointer to a null-terminated string holding an attribute name,
+*        or an attribute setting of the form "name=value". It should be
+*        in lower case with no white space (as passed to the astGetAttrib,
+*        etc, methods).
+*     names
+*        A static array holding the lower case names of all the
+*        attributes recognised by the class. It must be in alphabetical
+*        order (as determined by strcmp), so that it can be searched
+*        using a binary search.
+*     nname
+*        The number of names in "names".
+
+*  Returned Value:
+*     Non-zero if the attribute name was found in "names", and zero
+*     otherwise.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*-
+*/
+
+/* Local Variables: */
+   const char *c;                /* Pointer to next character */
+   int cmp;                      /* Result of comparing names */
+   int hi;                       /* Index of last name to be searched */
+   int lo;                       /* Index of first name to be searched */
+   int mid;                      /* Index of name to compare */
+   size_t len;                   /* Length of attribute name */
+
+/* Find the length of the attribute name. */
+   for( c = attrib; *c && *c != '(' && *c != '='; c++ );
+   len = c - attrib;
+
+/* Do a binary search of the table of names. */
+   lo = 0;
+   hi = nname - 1;
+   while( lo <= hi ) {
+      mid = ( lo + hi )/2;
+      cmp = strncmp( attrib, names[ mid ], len );
+      if( !cmp && names[ mid ][ len ] ) cmp = -1;
+      if( cmp < 0 ) {
+         hi = mid - 1;
+      } else if( cmp > 0 ) {
+         lo = mid + 1;
+      } else {
+         return 1;
+      }
+   }
+
+/* The name was not found. */
+   return 0;
+}
+
 int astClassCompare_( AstObjectVtab *class1, AstObjectVtab *class2,
                       int *status ) {
 /*
@@ -1109,6 +1402,7 @@ f        This routine applies to all Objects.
    char *buff;                   /* Pointer to character buffer */
    char *name;                   /* Pointer to individual attribute name */
    char *name_end;               /* Pointer to null at end of name */
+   char name_buf[ NAME_BUFF_LEN + 1 ]; /* Buffer for short attribute names */
    int i;                        /* Loop counter for characters */
    int j;                        /* Non-blank character count */
    int len;                      /* Length of attrib string */
@@ -1120,8 +1414,13 @@ f        This routine applies to all Objects.
    len = (int) strlen( attrib );
    if ( len != 0 ) {
 
-/* Allocate memory and store a copy of the string. */
-      buff = astStore( NULL, attrib, (size_t) ( len + 1 ) );
+/* Store a copy of the string, allocating memory only if it is too long
+   for the local buffer. */
+      if( len <= NAME_BUFF_LEN ) {
+         buff = strcpy( name_buf, attrib );
+      } else {
+         buff = astStore( NULL, attrib, (size_t) ( len + 1 ) );
+      }
       if ( astOK ) {
 
 /* Loop to process each element in the comma-separated list. */
@@ -1152,7 +1451,7 @@ f        This routine applies to all Objects.
       }
 
 /* Free the memory allocated for the string buffer. */
-      buff = astFree( buff );
+      if( buff != name_buf ) buff = astFree( buff );
    }
 }
 
@@ -1219,7 +1518,9 @@ static void ClearAttrib( AstObject *this, const char *attrib, int *status ) {
 /* Test if the attribute string matches any of the read-only
    attributes of this class. If it does, then report an error. */
    } else if ( !strcmp( attrib, "class" ) ||
+               !strcmp( attrib, "frozen" ) ||
                !strcmp( attrib, "nobject" ) ||
+               !strcmp( attrib, "objshared" ) ||
                !strcmp( attrib, "objsize" ) ||
                !strcmp( attrib, "refcount" ) ) {
       astError( AST__NOWRT, "astClear: Invalid attempt to clear the \"%s\" "
@@ -1291,24 +1592,18 @@ f     function is invoked with STATUS set to an error value, or if it
 /* Check the global error status. */
    if ( !astOK ) return NULL;
 
-/* Get a lock on the object's secondary mutex. This mutex guards access
-   to the "ref_count" and "locker" components of the AstObject structure. */
-   LOCK_SMUTEX(this);
-
 #ifdef MEM_DEBUG
    {   int rc;
        char buf[100];
-       rc = this->ref_count;
-       sprintf(buf,"cloned (refcnt: %d -> %d)", rc, rc+1 );
+       rc = CHANGE_REFCOUNT( this, 1 );
+       sprintf(buf,"cloned (refcnt: %d -> %d)", rc-1, rc );
        astMemoryUse( this, buf );
    }
-#endif
+#else
 
 /* Increment the Object's reference count. */
-   this->ref_count++;
-
-/* Unlock the object's secondary mutex. */
-   UNLOCK_SMUTEX(this);
+   (void) CHANGE_REFCOUNT( this, 1 );
+#endif
 
 /* Return a new pointer to the Object. */
    return this;
@@ -1380,10 +1675,12 @@ f     function is invoked with STATUS set to an error value, or if it
    if ( !astOK ) return new;
 
 /* Re-use cached memory, or allocate new memory using the size of the input
-   object, to store the output Object. */
+   object, to store the output Object. The cache is not used if the input
+   Object is frozen, since the vtab to which it refers (and which holds
+   the cache) may belong to another thread. */
 
    vtab = this->vtab;
-   if( object_caching ){
+   if( object_caching && !this->frozen ){
 
       if( vtab->nfree > 0 ) {
          new = vtab->free_list[ --(vtab->nfree) ];
@@ -1399,8 +1696,18 @@ f     function is invoked with STATUS set to an error value, or if it
    if ( astOK ) {
 
 /* Perform an initial byte-by-byte copy of the entire object
-   structure. */
+   structure. The reference count is skipped since other threads may
+   be changing it concurrently if the Object is frozen (it is re-set
+   below anyway). */
+#if defined(AST__ATOMIC)
+      (void) memcpy( (void *) new, (const void *) this,
+                     offsetof( AstObject, ref_count ) );
+      (void) memcpy( (char *) new + offsetof( AstObject, id ),
+                     (const char *) this + offsetof( AstObject, id ),
+                     this->size - offsetof( AstObject, id ) );
+#else
       (void) memcpy( (void *) new, (const void *) this, this->size );
+#endif
 
 /* Initialise any components of the new Object structure that need to
    differ from the input. */
@@ -1409,6 +1716,7 @@ f     function is invoked with STATUS set to an error value, or if it
       new->ref_count = 1;
       new->id = NULL;   /* ID attribute is not copied (but Ident is copied) */
       new->proxy = NULL;
+      new->frozen = 0;  /* A copy of a frozen Object is not frozen */
 
 /* Copy the persistent identifier string. */
       if( this->ident ) {
@@ -1417,7 +1725,22 @@ f     function is invoked with STATUS set to an error value, or if it
 
 /* Create a new mutex for the new Object, and lock it for use by the
    current thread. */
-#ifdef THREAD_SAFE
+#if defined(AST__ATOMIC)
+      if( pthread_cond_init( &(new->unlocked), NULL ) != 0 && astOK ) {
+         astError( AST__INTER, "astInitObject(%s): Failed to "
+                   "initialise POSIX condition variable for the new "
+                   "Object.", status, vtab->class );
+      }
+      if( pthread_mutex_init( &(new->mutex2), NULL ) != 0 && astOK ) {
+         astError( AST__INTER, "astInitObject(%s): Failed to "
+                   "initialise POSIX mutex2 for the new Object.", status,
+                   vtab->class );
+      }
+      atomic_init( &(new->locker), -1 );
+      atomic_init( &(new->nwait), 0 );
+      new->globals = NULL;
+      (void) ManageLock( new, AST__LOCK, 0, NULL, status );
+#elif defined(THREAD_SAFE)
       if( pthread_mutex_init( &(new->mutex1), NULL ) != 0 && astOK ) {
          astError( AST__INTER, "astInitObject(%s): Failed to "
                    "initialise POSIX mutex1 for the new Object.", status,
@@ -1461,8 +1784,10 @@ f     function is invoked with STATUS set to an error value, or if it
       }
    }
 
-/* If OK, increment the count of active objects. */
-   if ( astOK ) vtab->nobject++;
+/* If OK, increment the count of active objects. Use the vtab now
+   referred to by the new Object, since this will have been changed to
+   the vtab for the calling thread when the new Object was locked. */
+   if ( astOK ) new->vtab->nobject++;
 
 /* Return a pointer to the new Object. */
    return new;
@@ -1528,6 +1853,8 @@ f     - This routine attempts to execute even if STATUS is set to an error
 f     value
 *     on entry, although no further error report will be
 *     made if it subsequently fails under these circumstances.
+c     - An error is reported if the Object has been frozen using
+c     astFreeze, since it may be in use by other threads.
 *--
 */
 
@@ -1556,8 +1883,19 @@ f     value
    this->id = astFree( this->id );
    this->ident = astFree( this->ident );
 
-/* Attempt to unlock the Object and destroy its mutexes. */
+/* A frozen Object may refer to a vtab created by another thread. Ensure
+   it refers to a vtab created by the calling thread, since the vtab is
+   modified below. */
 #if defined(THREAD_SAFE)
+   if( this->frozen ) ChangeThreadVtab( this, status );
+#endif
+
+/* Attempt to unlock the Object and destroy its mutexes. */
+#if defined(AST__ATOMIC)
+   (void) ManageLock( this, AST__UNLOCK, 0, NULL, status );
+   pthread_cond_destroy( &(this->unlocked) );
+   pthread_mutex_destroy( &(this->mutex2) );
+#elif defined(THREAD_SAFE)
    (void) ManageLock( this, AST__UNLOCK, 0, NULL, status );
    pthread_mutex_destroy( &(this->mutex1) );
    pthread_mutex_destroy( &(this->mutex2) );
@@ -1698,9 +2036,7 @@ static void Dump( AstObject *this, AstChannel *channel, int *status ) {
 
 /* RefCnt. */
 /* ------- */
-   LOCK_SMUTEX(this);
-   ival = this->ref_count;
-   UNLOCK_SMUTEX(this);
+   ival = GET_REFCOUNT(this);
 
    astWriteInt( channel, "RefCnt", 0, 0, ival,
                 "Count of active Object pointers" );
@@ -1950,6 +2286,122 @@ static int Equal( AstObject *this, AstObject *that, int *status ){
    return result;
 }
 
+void astFreeze_( AstObject *this, int *status ) {
+/*
+*++
+*  Name:
+c     astFreeze
+
+*  Purpose:
+*     Make an Object immutable so that it can be used by any thread.
+
+*  Type:
+*     Public function.
+
+*  Synopsis:
+c     #include "object.h"
+c     void astFreeze( AstObject *this )
+
+*  Class Membership:
+*     Object method.
+
+*  Description:
+*     This function "freezes" an Object and all the Objects contained
+*     within it. A frozen Object cannot be modified. Any attempt to set
+*     or clear an attribute value, or to change the Object using a method
+*     such as astInvert, astAddFrame or astMapPut0<X>, will result in an
+*     error. In return, a frozen Object may be used by any number of
+*     threads at the same time, without being locked (see astLock). So for
+*     instance, a single FrameSet describing the WCS of a data array may
+*     be used to transform positions in many threads at once, without
+*     needing to make a separate deep copy of the FrameSet for each
+*     thread.
+*
+*     The Object must be locked by the calling thread when this function
+*     is invoked (as is the case for any newly created Object). Once it
+*     has been frozen it is not locked by any thread, and astLock and
+*     astUnlock have no effect on it. A pointer to a frozen Object may
+*     then be passed to any other thread and used immediately. However,
+*     the pointer remains in the AST context of the thread that issued
+*     it, and so should not be annulled while other threads are still
+*     using it. If required, each thread can use astClone to obtain a
+*     pointer of its own.
+*
+*     An Object cannot be unfrozen. However, a deep copy of a frozen
+*     Object (created using astCopy) is not frozen, and may be modified
+*     in the usual way.
+
+*  Parameters:
+c     this
+*        Pointer to the Object to be frozen.
+
+*  Applicability:
+*     Object
+c        This function applies to all Objects.
+
+*  Notes:
+*     - Any information that an Object caches internally to speed up
+*     later operations (for instance, the mesh of points covering the
+*     boundary of a Region) is created before the Object is frozen.
+*     - A few operations need to change an Object temporarily whilst
+*     they are performed (for instance, formatting an axis value, or
+*     getting an attribute value from a Frame). When used with a frozen
+*     Object, these operations are performed by only one thread at a
+*     time.
+*     - A frozen Object may be included in new compound Objects (for
+*     instance, in a CmpMap created using astCmpMap). The new Object is
+*     not itself frozen.
+*     - This function returns without action if the Object is already
+*     frozen.
+*     - This function is only available in the C interface.
+*     - This function returns without action if the AST library has
+*     been built without POSIX thread support (i.e. the "-with-pthreads"
+*     option was not specified when running the "configure" script).
+*--
+*/
+
+/* This function does nothing if thread support is not enabled. */
+#if defined(THREAD_SAFE)
+
+/* Local Variables: */
+   AstObject *fail;              /* Pointer to Object that failed */
+   int lstat;                    /* Local status value */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Check that the Object, and all the Objects it contains, are locked by
+   the calling thread. Nothing is frozen unless they all are. */
+   lstat = astManageLock( this, AST__CHECKLOCK, 0, &fail );
+
+/* If so, use the astManageLock method to freeze the Object and all the
+   Objects within it. Each class fills any internal caches before its
+   Objects are frozen. */
+   if( !lstat ) lstat = astManageLock( this, AST__FREEZE, 0, &fail );
+
+/* Report an error if anything failed. */
+   if( lstat && astOK ) {
+      if( lstat == 2 || lstat == 3 ) {
+         astError( AST__LCKERR, "astFreeze(%s): Failed to lock or unlock "
+                   "a POSIX mutex.", status, astGetClass( this ) );
+
+      } else if( fail == this ) {
+         astError( AST__LCKERR, "astFreeze(%s): Failed to freeze the %s "
+                   "because it is not locked by the current thread "
+                   "(programming error).", status, astGetClass( this ),
+                   astGetClass( this ) );
+
+      } else {
+         astError( AST__LCKERR, "astFreeze(%s): Failed to freeze the %s "
+                   "because a %s contained within it is not locked by the "
+                   "current thread (programming error).", status,
+                   astGetClass( this ), astGetClass( this ),
+                   astGetClass( fail ) );
+      }
+   }
+#endif
+}
+
 static const char *Get( AstObject *this, const char *attrib, int *status ) {
 /*
 *  Name:
@@ -2006,9 +2458,11 @@ static const char *Get( AstObject *this, const char *attrib, int *status ) {
 
 /* Local Variables: */
    char *buff;                   /* Pointer to local string buffer */
+   char name_buf[ NAME_BUFF_LEN + 1 ]; /* Buffer for short attribute names */
    const char *result;           /* Pointer value to return */
    int i;                        /* Loop counter for characters */
    int j;                        /* Non-blank character count */
+   size_t len;                   /* Length of attrib string */
 
 /* Initialise. */
    result = NULL;
@@ -2016,9 +2470,10 @@ static const char *Get( AstObject *this, const char *attrib, int *status ) {
 /* Check the global error status. */
    if ( !astOK ) return result;
 
-/* Allocate a local buffer long enough to hold the attribute name
-   string. */
-   buff = astMalloc( strlen( attrib ) + (size_t) 1 );
+/* Get a buffer long enough to hold the attribute name string. Only
+   allocate memory if the name is too long for the local buffer. */
+   len = strlen( attrib );
+   buff = ( len <= NAME_BUFF_LEN ) ? name_buf : astMalloc( len + (size_t) 1 );
    if ( astOK ) {
 
 /* Copy the attribute name characters into the buffer, omitting all
@@ -2046,8 +2501,8 @@ static const char *Get( AstObject *this, const char *attrib, int *status ) {
       }
    }
 
-/* Free the local string buffer. */
-   buff = astFree( buff );
+/* Free the local string buffer if it was allocated. */
+   if( buff != name_buf ) buff = astFree( buff );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = NULL;
@@ -2107,7 +2562,9 @@ static const char *GetAttrib( AstObject *this, const char *attrib, int *status )
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Thread-specific global data */
    const char *result;           /* Pointer value to return */
+   int frozen;                   /* Frozen attribute value */
    int nobject;                  /* Nobject attribute value */
+   size_t objshared;             /* ObjShared attribute value */
    size_t objsize;               /* ObjSize attribute value */
    int ref_count;                /* RefCount attribute value */
    int usedefs;                  /* UseDefs attribute value */
@@ -2131,6 +2588,15 @@ static const char *GetAttrib( AstObject *this, const char *attrib, int *status )
    if ( !strcmp( attrib, "class" ) ) {
       result = astGetClass( this );
 
+/* Frozen. */
+/* ------- */
+   } else if ( !strcmp( attrib, "frozen" ) ) {
+      frozen = astGetFrozen( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", frozen );
+         result = getattrib_buff;
+      }
+
 /* ID. */
 /* --- */
    } else if ( !strcmp( attrib, "id" ) ) {
@@ -2159,6 +2625,19 @@ static const char *GetAttrib( AstObject *this, const char *attrib, int *status )
          result = getattrib_buff;
       }
 
+/* ObjShared */
+/* --------- */
+/* The size of any shared memory is recorded by astTSizeOf while the
+   Object size is being determined. */
+   } else if ( !strcmp( attrib, "objshared" ) ) {
+      (void) astSharedSize( 1 );
+      (void) astGetObjSize( this );
+      objshared = astSharedSize( 1 );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%zu", objshared );
+         result = getattrib_buff;
+      }
+
 /* ObjSize */
 /* ------- */
    } else if ( !strcmp( attrib, "objsize" ) ) {
@@ -2250,54 +2729,219 @@ const char *astGetClass_( const AstObject *this, int *status ) {
    return name;
 }
 
-int astGetNobject_( const AstObject *this, int *status ) {
+int astFrozenLock_( AstObject *this, int *status ) {
 /*
 *+
 *  Name:
-*     astGetNobject
+*     astFrozenLock
 
 *  Purpose:
-*     Obtain the value of the Nobject attribute for an Object.
+*     Serialise temporary changes to a frozen Object.
 
 *  Type:
 *     Protected function.
 
 *  Synopsis:
 *     #include "object.h"
-*     int astGetNobject( const AstObject *this )
+*     int astFrozenLock( AstObject *this )
 
 *  Class Membership:
 *     Object method.
 
 *  Description:
-*     This function returns the value of the Nobject attribute for an
-*     Object. This is a count of the number of active Objects in the
-*     same class as the Object supplied. This count does not include
-*     Objects in derived classes.
+*     Some methods make temporary changes to an Object (or to the
+*     Objects within it) whilst they are executing, reinstating the
+*     original state before they return. Such methods can only be used
+*     with a frozen Object if no other thread is doing the same thing at
+*     the same time. This function should be invoked before making any
+*     such temporary changes. If the supplied Object is frozen, it waits
+*     until no other thread is making temporary changes to any frozen
+*     Object, and then prevents any other thread doing so until
+*     astFrozenUnlock is invoked. It returns without action if the
+*     Object is not frozen, or if the calling thread has already
+*     invoked this function without a matching call to astFrozenUnlock.
 
 *  Parameters:
 *     this
 *        Pointer to the Object.
 
 *  Returned Value:
-*     The number of active Objects.
+*     Non-zero if other threads are now prevented from making temporary
+*     changes to frozen Objects. The returned value should be passed to
+*     the matching call to astFrozenUnlock.
 
 *  Notes:
-*     - A value of zero will be returned if this function is invoked
-*     with the global error status set, or if it should fail for any
-*     reason.
+*     - A value of zero is returned if this function is invoked with
+*     the global error status set, or if AST has been built without
+*     POSIX thread support.
 *-
 */
 
+#if defined(THREAD_SAFE)
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+
 /* Check the global error status. */
    if ( !astOK ) return 0;
 
-/* Return the active object count. */
-   return this->vtab->nobject;
-}
+/* Get a pointer to Thread-specific global data. */
+   astGET_GLOBALS(this);
 
-static size_t GetObjSize( AstObject *this, int *status ) {
-/*
+/* Return without action if the Object is not frozen or if the calling
+   thread already has exclusive access. */
+   if( !this || !this->frozen || frozen_held ) return 0;
+
+/* Otherwise, lock the mutex. */
+   LOCK_MUTEX3
+   frozen_held = 1;
+   return 1;
+#else
+   return 0;
+#endif
+}
+
+void astFrozenUnlock_( int locked, int *status ) {
+/*
+*+
+*  Name:
+*     astFrozenUnlock
+
+*  Purpose:
+*     Allow other threads to make temporary changes to frozen Objects.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "object.h"
+*     void astFrozenUnlock( int locked )
+
+*  Class Membership:
+*     Object method.
+
+*  Description:
+*     This function should be invoked once any temporary changes made
+*     to an Object after a call to astFrozenLock have been reversed.
+
+*  Parameters:
+*     locked
+*        The value returned by the matching call to astFrozenLock.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*-
+*/
+
+#if defined(THREAD_SAFE)
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+
+/* Unlock the mutex if it was locked by the matching call to
+   astFrozenLock. */
+   if( locked ) {
+      astGET_GLOBALS(NULL);
+      frozen_held = 0;
+      UNLOCK_MUTEX3
+   }
+#endif
+}
+
+int astGetFrozen_( AstObject *this, int *status ) {
+/*
+*+
+*  Name:
+*     astGetFrozen
+
+*  Purpose:
+*     Obtain the value of the Frozen attribute for an Object.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int astGetFrozen( AstObject *this )
+
+*  Class Membership:
+*     Object method.
+
+*  Description:
+*     This function returns the value of the read-only Frozen attribute
+*     for an Object. This is non-zero if the Object has been frozen
+*     using astFreeze.
+
+*  Parameters:
+*     this
+*        Pointer to the Object.
+
+*  Returned Value:
+*     The Frozen value.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*-
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Return the flag. */
+   return this->frozen;
+}
+
+int astGetNobject_( const AstObject *this, int *status ) {
+/*
+*+
+*  Name:
+*     astGetNobject
+
+*  Purpose:
+*     Obtain the value of the Nobject attribute for an Object.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int astGetNobject( const AstObject *this )
+
+*  Class Membership:
+*     Object method.
+
+*  Description:
+*     This function returns the value of the Nobject attribute for an
+*     Object. This is a count of the number of active Objects in the
+*     same class as the Object supplied. This count does not include
+*     Objects in derived classes.
+
+*  Parameters:
+*     this
+*        Pointer to the Object.
+
+*  Returned Value:
+*     The number of active Objects.
+
+*  Notes:
+*     - A value of zero will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*-
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Return the active object count. */
+   return this->vtab->nobject;
+}
+
+static size_t GetObjSize( AstObject *this, int *status ) {
+/*
 *+
 *  Name:
 *     astGetObjSize
@@ -2430,15 +3074,8 @@ int astGetRefCount_( AstObject *this, int *status ) {
 /* Check the global error status. */
    if ( !astOK ) return 0;
 
-/* Get a lock on the object's secondary mutex. This mutex guards access
-   to the "ref_count" and "locker" components of the AstObject structure. */
-   LOCK_SMUTEX(this);
-
 /* Get the reference count. */
-   result = this->ref_count;
-
-/* Unlock the object's secondary mutex. */
-   UNLOCK_SMUTEX(this);
+   result = GET_REFCOUNT(this);
 
 /* Return the result. */
    return result;
@@ -2829,6 +3466,9 @@ static int ManageLock( AstObject *this, int mode, int extra,
 *
 *        AST__CHECKLOCK: Check that the object is locked for use by the
 *        calling thread.
+*
+*        AST__FREEZE: Freeze the Object (see astFreeze). The Object must
+*        be locked by the calling thread. It is unlocked as a result.
 *     extra
 *        Extra mode-specific information.
 *     fail
@@ -2854,6 +3494,13 @@ static int ManageLock( AstObject *this, int mode, int extra,
 *  Notes:
 *     - This function attempts to execute even if an error has already
 *     occurred.
+*     - If C11 atomics are available, the Object's mutex is used only if
+*     the calling thread needs to wait for another thread to unlock the
+*     Object, or if another thread is waiting for the calling thread to
+*     unlock the Object.
+*     - A frozen Object is not locked by any thread and may be used by
+*     all threads. This function returns zero without action for a
+*     frozen Object, whatever the value of "mode".
 
 *-
 */
@@ -2861,6 +3508,10 @@ static int ManageLock( AstObject *this, int mode, int extra,
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Thread-specific global data */
    int result;                   /* Returned value */
+#if defined(AST__ATOMIC)
+   int expected;                 /* Expected value of "locker" */
+   int locker;                   /* Thread that has locked the Object */
+#endif
 
 /* Initialise */
    result = 0;
@@ -2869,11 +3520,147 @@ static int ManageLock( AstObject *this, int mode, int extra,
 /* Check the supplied point is not NULL. */
    if( ! this ) return result;
 
+/* Frozen Objects cannot be locked or unlocked, and may be used by any
+   thread. */
+   if( this->frozen ) return result;
+
 /* Get a pointer to Thread-specific global data. */
    astGET_GLOBALS(NULL);
 
-/* Get a lock on the object's secondary mutex. This gives us exclusive
-   access to the "locker" (and "ref_count") component in the AstObject
+/* If C11 atomics are available, the "locker" component is changed
+   using atomic operations, and no mutex is needed unless a thread has to
+   wait for the Object to be unlocked by another thread. */
+#if defined(AST__ATOMIC)
+
+/* If the Object is to be frozen, check it is locked by the calling
+   thread. If so, set the "frozen" flag and then unlock the Object in
+   the usual way, waking up any threads that are waiting to lock it.
+   These threads will find the Object is frozen when they wake up. */
+   if( mode == AST__FREEZE ) {
+      if( atomic_load( &(this->locker) ) != AST__THREAD_ID ) {
+         result = 1;
+      } else {
+         this->frozen = 1;
+         mode = AST__UNLOCK;
+      }
+   }
+
+/* First deal with cases where the caller wants to lock the Object for
+   exclusive use by the calling thread. If the Object is not currently
+   locked, store the identity of the calling thread in the Object using
+   an atomic compare-and-swap. This fails, returning the identity of the
+   thread that currently has the Object locked, if another thread got
+   there first. */
+   if( mode == AST__LOCK ) {
+      expected = -1;
+      if( atomic_compare_exchange_strong( &(this->locker), &expected,
+                                          AST__THREAD_ID ) ) {
+
+/* If another thread froze the Object after the above check on the
+   "frozen" flag, release it again. */
+         if( this->frozen ) {
+            atomic_store( &(this->locker), -1 );
+         } else {
+            this->globals = AST__GLOBALS;
+            ChangeThreadVtab( this, status );
+         }
+
+/* If the Object is already locked by the calling thread, do nothing. */
+      } else if( expected == AST__THREAD_ID ) {
+
+/* If the object is locked by a different thread, and the caller is
+   willing to wait, lock the secondary mutex and increment the count of
+   waiting threads (so that the thread that unlocks the Object knows it
+   must signal the condition variable). Then repeatedly attempt to claim
+   the Object, waiting on the condition variable between attempts. */
+      } else if( extra ) {
+         if( LOCK_SMUTEX(this) ) {
+            result = 2;
+         } else {
+            atomic_fetch_add( &(this->nwait), 1 );
+            expected = -1;
+            while( !this->frozen &&
+                   !atomic_compare_exchange_strong( &(this->locker),
+                                                    &expected,
+                                                    AST__THREAD_ID ) ) {
+               if( pthread_cond_wait( &(this->unlocked), &(this->mutex2) ) ) {
+                  result = 2;
+                  break;
+               }
+               expected = -1;
+            }
+            atomic_fetch_sub( &(this->nwait), 1 );
+            if( UNLOCK_SMUTEX(this) ) result = 3;
+
+/* If the Object was frozen while we were waiting, ensure it is left
+   unlocked. */
+            if( result != 2 ) {
+               if( this->frozen ) {
+                  atomic_store( &(this->locker), -1 );
+               } else {
+                  this->globals = AST__GLOBALS;
+                  ChangeThreadVtab( this, status );
+               }
+            }
+         }
+
+/* If the caller does not want to wait until the Object is available,
+   return a status of 1. */
+      } else {
+         result = 1;
+      }
+
+/* Unlock the Object for use by other threads. */
+   } else if( mode == AST__UNLOCK ) {
+      locker = atomic_load( &(this->locker) );
+
+/* Do nothing if the Object is currently unlocked. */
+      if( locker == -1 ) {
+
+/* If the object is currently locked by the calling thread, clear the
+   identity of the thread that owns the lock. If any other threads are
+   waiting to lock the Object, wake them up. The secondary mutex is
+   locked while doing this so that the signal cannot be lost between a
+   waiting thread's last attempt to claim the Object and its call to
+   pthread_cond_wait. */
+      } else if( locker == AST__THREAD_ID ) {
+         this->globals = NULL;
+         atomic_store( &(this->locker), -1 );
+         if( atomic_load( &(this->nwait) ) > 0 ) {
+            if( LOCK_SMUTEX(this) ) {
+               result = 2;
+            } else {
+               if( pthread_cond_broadcast( &(this->unlocked) ) ) result = 3;
+               if( UNLOCK_SMUTEX(this) ) result = 3;
+            }
+         }
+
+/* Return an error status value if the Object is locked by another
+   thread. */
+      } else {
+         result = 1;
+      }
+
+/* Check the Object is locked by the calling thread. */
+   } else if( mode == AST__CHECKLOCK ) {
+      locker = atomic_load( &(this->locker) );
+      if( locker == -1 ) {
+         result = 6;
+      } else if( locker != AST__THREAD_ID ) {
+         result = 5;
+      }
+
+/* Return a status of 4 for any other modes (other than an attempt to
+   freeze an Object that is not locked by the calling thread, for which
+   the status has already been set). */
+   } else if( mode != AST__FREEZE ) {
+      result = 4;
+   }
+
+#else
+
+/* If C11 atomics are not available, get a lock on the object's secondary
+   mutex. This gives us exclusive access to the "locker" (and "ref_count") component in the AstObject
    structure. All other components in the structure are guarded by the
    primary mutex (this->mutex1). */
    if( LOCK_SMUTEX(this) ) {
@@ -2884,9 +3671,13 @@ static int ManageLock( AstObject *this, int mode, int extra,
    calling thread. */
    } else if( mode == AST__LOCK ) {
 
+/* Do nothing if another thread has frozen the Object since the "frozen"
+   flag was checked above. */
+      if( this->frozen ) {
+
 /* If the Object is not currently locked, lock the Object primary mutex
    and record the identity of the calling thread in the Object. */
-      if( this->locker == -1 ) {
+      } else if( this->locker == -1 ) {
          if( LOCK_PMUTEX(this) ) result = 2;
          this->locker = AST__THREAD_ID;
          this->globals = AST__GLOBALS;
@@ -2912,9 +3703,16 @@ static int ManageLock( AstObject *this, int mode, int extra,
          } else if( LOCK_SMUTEX(this) ) {
             result = 2;
          }
-         this->locker = AST__THREAD_ID;
-         this->globals = AST__GLOBALS;
-         ChangeThreadVtab( this, status );
+
+/* If the Object was frozen while we were waiting, release the primary
+   mutex again, leaving the Object unlocked. */
+         if( this->frozen ) {
+            if( UNLOCK_PMUTEX(this) ) result = 3;
+         } else {
+            this->locker = AST__THREAD_ID;
+            this->globals = AST__GLOBALS;
+            ChangeThreadVtab( this, status );
+         }
 
 /* If the caller does not want to wait until the Object is available,
    return a status of 1. */
@@ -2942,6 +3740,19 @@ static int ManageLock( AstObject *this, int mode, int extra,
          result = 1;
       }
 
+/* Freeze the Object. It must be locked by the calling thread. Set the
+   "frozen" flag and then unlock the Object, allowing any threads that
+   are waiting to lock it to continue (they will find it is frozen). */
+   } else if( mode == AST__FREEZE ) {
+      if( this->locker == AST__THREAD_ID ) {
+         this->frozen = 1;
+         this->locker = -1;
+         this->globals = NULL;
+         if( UNLOCK_PMUTEX(this) ) result = 3;
+      } else {
+         result = 1;
+      }
+
 /* Check the Object is locked by the calling thread. Return a status of 1 if
    not. */
    } else if( mode == AST__CHECKLOCK ) {
@@ -2959,6 +3770,7 @@ static int ManageLock( AstObject *this, int mode, int extra,
 /* Unlock the secondary mutex so that other threads can access the "locker"
    component in the Object to see if it is locked. */
    if( UNLOCK_SMUTEX(this) ) result = 3;
+#endif
 
 /* If the operation failed, return a pointer to the failed object. */
    if( result && fail ) *fail = this;
@@ -3313,7 +4125,9 @@ static void SetAttrib( AstObject *this, const char *setting, int *status ) {
                   ( nc >= len ) )
 
    } else if ( MATCH( "class" ) ||
+               MATCH( "frozen" ) ||
                MATCH( "nobject" ) ||
+               MATCH( "objshared" ) ||
                MATCH( "objsize" ) ||
                MATCH( "refcount" ) ) {
       astError( AST__NOWRT, "astSet: The setting \"%s\" is invalid for a %s.", status,
@@ -3331,6 +4145,78 @@ static void SetAttrib( AstObject *this, const char *setting, int *status ) {
 #undef MATCH
 }
 
+static int SetCacheIndex( const char *text, int *status ) {
+/*
+*  Name:
+*     SetCacheIndex
+
+*  Purpose:
+*     Find the entry in the astVSet cache to use for a given string.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int SetCacheIndex( const char *text, int *status )
+
+*  Class Membership:
+*     Object member function.
+
+*  Description:
+*     This function returns the index of the entry within the cache of
+*     formatted setting strings used by astVSet that should be used to
+*     hold the supplied string. The index is formed from a hash of the
+*     string, so a given string always uses the same entry. The caller
+*     should check if the string stored in the entry matches the
+*     supplied string. If not, the entry should be replaced.
+
+*  Parameters:
+*     text
+*        Pointer to the formatted setting string. It should contain no
+*        more than AST__SETCACHE_LEN characters.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The index of the cache entry to use.
+
+*  Notes:
+*     - Each thread has its own cache.
+*     - This function attempts to execute even if the global error
+*     status is set.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   const char *c;                /* Pointer to next character */
+   int i;                        /* Cache entry index */
+   unsigned int hash;            /* Hash of string */
+
+/* Get a pointer to Thread-specific data for the currently executing thread. */
+   astGET_GLOBALS(NULL);
+
+/* If the cache has not yet been used by this thread, mark all entries
+   as empty. */
+   if( !set_cache_init ) {
+      for( i = 0; i < AST__SETCACHE_SIZE; i++ ) {
+         set_cache_key[ i ][ 0 ] = '\0';
+         set_cache_list[ i ][ 0 ] = '\0';
+      }
+      set_cache_init = 1;
+   }
+
+/* Form a hash of the string (the FNV-1a hash). */
+   hash = 2166136261U;
+   for( c = text; *c; c++ ) {
+      hash ^= (unsigned char) *c;
+      hash *= 16777619U;
+   }
+
+/* Return the cache index. */
+   return (int) ( hash % AST__SETCACHE_SIZE );
+}
+
 void astSetCopy_( AstObjectVtab *vtab,
                   void (* copy)( const AstObject *, AstObject *, int * ), int *status ) {
 /*
@@ -4050,6 +4936,7 @@ f     - A value of .FALSE. will also be returned if this function is used
 
 /* Local Variables: */
    char *buff;                   /* Pointer to character buffer */
+   char name_buf[ NAME_BUFF_LEN + 1 ]; /* Buffer for short attribute names */
    int i;                        /* Loop counter for characters */
    int j;                        /* Non-blank character count */
    int len;                      /* Length of attrib string */
@@ -4064,8 +4951,13 @@ f     - A value of .FALSE. will also be returned if this function is used
 /* Obtain the length of the attrib string. */
    len = (int) strlen( attrib );
 
-/* Allocate memory and store a copy of the string. */
-   buff = astStore( NULL, attrib, (size_t) ( len + 1 ) );
+/* Store a copy of the string, allocating memory only if it is too long
+   for the local buffer. */
+   if( len <= NAME_BUFF_LEN ) {
+      buff = strcpy( name_buf, attrib );
+   } else {
+      buff = astStore( NULL, attrib, (size_t) ( len + 1 ) );
+   }
    if ( astOK ) {
 
 /* Remove white space and upper case characters. */
@@ -4080,7 +4972,7 @@ f     - A value of .FALSE. will also be returned if this function is used
    }
 
 /* Free the memory allocated for the string buffer. */
-   buff = astFree( buff );
+   if( buff != name_buf ) buff = astFree( buff );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
@@ -4158,7 +5050,9 @@ static int TestAttrib( AstObject *this, const char *attrib, int *status ) {
 /* Test if the attribute string matches any of the read-only
    attributes of this class. If it does, then return zero. */
    } else if ( !strcmp( attrib, "class" ) ||
+               !strcmp( attrib, "frozen" ) ||
                !strcmp( attrib, "nobject" ) ||
+               !strcmp( attrib, "objshared" ) ||
                !strcmp( attrib, "objsize" ) ||
                !strcmp( attrib, "refcount" ) ) {
       result = 0;
@@ -4239,9 +5133,57 @@ f        AST_DELETE).
 *        cache other memory blocks allocated by AST, use MemoryCaching.
 *     MemoryCaching
 *        A boolean flag similar to ObjectCaching except
-*        that it controls caching of all memory blocks of less than 300 bytes
+*        that it controls caching of all memory blocks of up to 32768 bytes
 *        allocated by AST (whether for internal or external use), not just
-*        memory used to store AST Objects.
+*        memory used to store AST Objects. Cached memory blocks are re-used
+*        for any later request of a similar size.
+*     Threads
+*        The maximum number of threads (including the calling thread)
+*        that may be used by AST to process large numbers of items
+*        concurrently, for instance when testing whether large numbers of
+*        positions are inside a Region (such as when a Region is used as a
+c        Mapping or within astMask<X>).
+f        Mapping or within AST_MASK<X>).
+*        The items are divided into chunks, which are shared between the
+*        calling thread and a pool of worker threads. If no value has been
+*        set, the default value is taken from the AST_THREADS environment
+*        variable. If that is not defined, the default value is one,
+*        meaning that all items are processed in the calling thread. The
+*        maximum allowed value is 64. Values larger than one have no
+*        effect unless AST was built with thread-safety enabled.
+*     FitsWcsCache
+*        The maximum number of FrameSets to be retained for re-use when
+*        reading FITS headers using a FitsChan with any encoding other than
+*        NATIVE. When a FrameSet is read from a header that describes the
+*        same WCS as a previously read header (i.e. the same WCS keyword
+*        values, attributes, etc), a copy of the retained FrameSet is
+*        returned, avoiding the cost of creating it again. This can speed
+*        up the reading of large numbers of similar headers, such as the
+*        headers for the images in a mosaic. The FitsChan is left in the
+*        same state as if the FrameSet had been created afresh. FrameSets
+*        that use the -TAB algorithm are never retained. The default value
+*        is zero, which disables the cache. Setting it to zero also frees
+*        any retained FrameSets. All threads share the same cache.
+*     Profile
+*        A boolean flag indicating if calls to the main AST processing
+c        functions (astTransform, astSimplify, astResample<X>,
+c        astRebin<X>, astRebinSeq<X> and astConvert, and the astRead
+c        and astWrite methods of a Channel) should be profiled. For each
+f        routines (AST_TRANSFORM, AST_SIMPLIFY, AST_RESAMPLE<X>,
+f        AST_REBIN<X>, AST_REBINSEQ<X> and AST_CONVERT, and the AST_READ
+f        and AST_WRITE methods of a Channel) should be profiled. For each
+*        combination of function and Object class, the number of calls,
+*        the number of points or pixels processed, the wall-clock time
+*        and the number of memory allocations are recorded, separately
+*        for each chain of enclosing profiled calls (for instance, for
+*        each component Mapping within a CmpMap). The results may be
+*        written out as text or in the Chrome trace event format using
+*        the astProfileReport function, which is available only in the
+*        C interface. The default value is zero, which disables
+*        profiling. Setting it to a non-zero value discards any previous
+*        results. Setting it back to zero stops further calls being
+*        recorded, but retains the results. All threads share the same
+*        results.
 
 *  Notes:
 c     - This function attempts to execute even if the AST error
@@ -4271,6 +5213,15 @@ f     error value
       } else if( astChrMatch( name, "MemoryCaching" ) ) {
          result = astMemCaching( value );
 
+      } else if( astChrMatch( name, "Threads" ) ) {
+         result = astParallelThreads( value );
+
+      } else if( astChrMatch( name, "FitsWcsCache" ) ) {
+         result = astFitsWcsCache( value );
+
+      } else if( astChrMatch( name, "Profile" ) ) {
+         result = astProfiling( value );
+
       } else if( astOK ) {
          astError( AST__TUNAM, "astTune: Unknown AST tuning parameter "
                    "specified \"%s\".", status, name );
@@ -4659,6 +5610,10 @@ static void VSet( AstObject *this, const char *settings, char **text,
 *     astSetAttrib method should therefore be extended by derived
 *     classes which define new attributes, and this will allow the
 *     astVSet (and astSet) methods to have access to those attributes.
+*     - Each thread keeps a cache of recently used setting strings
+*     (after substitution of any format specifiers) and the
+*     corresponding lists of processed attribute assignments, so that
+*     re-using a setting string does not require it to be parsed again.
 *     - This function provides the same functionality as the astSet
 *     public method but accepts a va_list variable argument list
 *     instead of a variable number of arguments. It is provided for
@@ -4672,7 +5627,11 @@ static void VSet( AstObject *this, const char *settings, char **text,
 #define ERRBUF_LEN 80
 
 /* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   char buff1_buf[ MIN_BUFF_LEN ]; /* Local buffer for copy of settings */
+   char buff2_buf[ MIN_BUFF_LEN + 1 ]; /* Local buffer for formatted settings */
    char errbuf[ ERRBUF_LEN ];    /* Buffer for system error message */
+   char list_buf[ 2*AST__SETCACHE_LEN + 2 ]; /* Local buffer for assignment list */
    char setting_buf[ MIN_BUFF_LEN ]; /* Expanded "%s" settting string */
    char *dyn_buf;                /* Pointer to dynamic buffer for expanded setting */
    char *errstat;                /* Pointer to error message */
@@ -4680,18 +5639,21 @@ static void VSet( AstObject *this, const char *settings, char **text,
    char *assign_end;             /* Pointer to null at end of assignment */
    char *buff1;                  /* Pointer to temporary string buffer */
    char *buff2;                  /* Pointer to temporary string buffer */
-   char *buff3;                  /* Pointer to temporary string buffer */
    char *eq1;                    /* Pointer to 1st equals sign */
+   char *list;                   /* Pointer to list of processed assignments */
    int buff_len;                 /* Length of temporary buffer */
    int expanded;                 /* Has the Settings string been expanded yet? */
    int i;                        /* Loop counter for characters */
+   int icache;                   /* Index of cache entry to use */
    int j;                        /* Offset for revised assignment character */
    int len;                      /* Length of settings string */
    int lo;                       /* Convert next character to lower case? */
    int nc;                       /* Number of vsprintf output characters */
+   int nlist;                    /* Number of characters in list */
    int quoted;                   /* Are we in a quoted string? */
    int stat;                     /* Value of errno after an error */
    int tq;                       /* Test if the next non-space is a quote? */
+   va_list args_copy;            /* Copy of variable argument list */
 
 /* Initialise */
    if( text ) *text = NULL;
@@ -4699,6 +5661,9 @@ static void VSet( AstObject *this, const char *settings, char **text,
 /* Check the global error status. */
    if ( !astOK ) return;
 
+/* Get a pointer to Thread-specific data for the currently executing thread. */
+   astGET_GLOBALS(this);
+
 /* Obtain the length of the "settings" string and test it is not
    zero. If it is, there is nothing more to do. */
    len = (int) strlen( settings );
@@ -4739,8 +5704,14 @@ static void VSet( AstObject *this, const char *settings, char **text,
          dyn_buf = NULL;
       }
 
-/* Allocate memory and store a copy of the string. */
-      buff1 = astStore( NULL, settings, (size_t) ( len + 1 ) );
+/* Store a copy of the string, using a local buffer if it is short
+   enough. */
+      if( len < MIN_BUFF_LEN ) {
+         buff1 = buff1_buf;
+         strcpy( buff1, settings );
+      } else {
+         buff1 = astStore( NULL, settings, (size_t) ( len + 1 ) );
+      }
       if ( astOK ) {
 
 /* Convert each comma in the string into '\n'. This is to distinguish
@@ -4767,22 +5738,41 @@ static void VSet( AstObject *this, const char *settings, char **text,
 
 /* Calculate a size for a further buffer twice the size of the first
    one.  Ensure it is not less than a minimum size and then allocate
-   this buffer. */
+   this buffer (again, using a local buffer if possible). */
          buff_len = 2 * len;
-         if ( buff_len < MIN_BUFF_LEN ) buff_len = MIN_BUFF_LEN;
-         buff2 = astMalloc( (size_t) ( buff_len + 1 ) );
+         if ( buff_len <= MIN_BUFF_LEN ) {
+            buff_len = MIN_BUFF_LEN;
+            buff2 = buff2_buf;
+         } else {
+            buff2 = astMalloc( (size_t) ( buff_len + 1 ) );
+         }
          if ( astOK ) {
 
-/* Use "vsprintf" to substitute values for any format specifiers in
+/* Use "vsnprintf" to substitute values for any format specifiers in
    the "settings" string, writing the resulting string into the second
-   buffer. If the "settings" string has already been expanded, then just
+   buffer. If the buffer is too small, allocate one that is large enough
+   to hold the whole formatted string and format it again (using the
+   original copy of the argument list). If the "settings" string has
+   already been expanded, or contains no format specifiers, then just
    copy it. */
             errno = 0;
-            if( !expanded ) {
-               nc = vsprintf( buff2, buff1, args );
+            if( !expanded && strchr( buff1, '%' ) ) {
+               va_copy( args_copy, args );
+               nc = vsnprintf( buff2, (size_t) ( buff_len + 1 ), buff1,
+                               args_copy );
+               va_end( args_copy );
+               if( nc > buff_len ) {
+                  if( buff2 != buff2_buf ) buff2 = astFree( buff2 );
+                  buff2 = astMalloc( (size_t) ( nc + 1 ) );
+                  if( astOK ) {
+                     buff_len = nc;
+                     nc = vsnprintf( buff2, (size_t) ( buff_len + 1 ), buff1,
+                                     args );
+                  }
+               }
             } else {
                strcpy( buff2, buff1 );
-               nc = strlen( buff1 );
+               nc = len;
             }
 
 /* Get a copy of the expanded string to return as the function value and
@@ -4822,10 +5812,9 @@ static void VSet( AstObject *this, const char *settings, char **text,
                             settings );
                }
 
-/* Also check that the result buffer did not overflow. If it did,
-   memory will probably have been corrupted but this cannot be
-   prevented with "vsprintf" (although we try and make the buffer
-   large enough). Report the error and abort. */
+/* Also check that the whole formatted string fitted into the result
+   buffer (it will not if a large enough buffer could not be allocated
+   above). Report the error and abort. */
             } else if ( nc > buff_len ) {
                if( astOK ) {
                   astError( AST__ATSER, "astVSet(%s): Internal buffer overflow "
@@ -4836,106 +5825,146 @@ static void VSet( AstObject *this, const char *settings, char **text,
                             settings );
                }
 
-/* If all is OK, loop to process each formatted attribute assignment
-   (these are now separated by '\n' characters). */
+/* If all is OK, get a list of the individual attribute assignments
+   (these are separated by '\n' characters in the formatted string),
+   with white space and upper case characters removed from each
+   attribute name, in the form expected by astSetAttrib. Each
+   assignment in the list is terminated by a null character, and the
+   end of the list is marked by an additional null. */
 	    } else {
-               assign = buff2;
-               while ( assign ) {
+
+/* The processed list depends only on the contents of the formatted
+   string, so look for a cached list created from an identical string by
+   a previous invocation of this function. If found, take a copy of it
+   (the cache may be changed by any further invocation of this function
+   made from within astSetAttrib). */
+               list = NULL;
+               icache = -1;
+               if( nc <= AST__SETCACHE_LEN && (int) strlen( buff2 ) == nc ) {
+                  icache = SetCacheIndex( buff2, status );
+                  if( !strcmp( set_cache_key[ icache ], buff2 ) ) {
+                     list = list_buf;
+                     memcpy( list, set_cache_list[ icache ],
+                             sizeof( list_buf ) );
+                  }
+               }
+
+/* If no cached list was found, create one now. If it will fit, it is
+   created in a local buffer and then copied into the cache, replacing
+   the previous cache entry. */
+               if( !list ) {
+                  if( icache >= 0 ) {
+                     list = list_buf;
+                     strcpy( set_cache_key[ icache ], buff2 );
+                  } else {
+                     list = astMalloc( (size_t) ( 2*nc + 2 ) );
+                  }
+                  nlist = 0;
+
+/* Loop to process each assignment. */
+                  assign = astOK ? buff2 : NULL;
+                  while ( assign ) {
 
 /* Change the '\n' at the end of each assignment to a null to
    terminate it. */
-                  if ( ( assign_end = strchr( assign, '\n' ) ) ) {
-                     *assign_end = '\0';
-                  }
+                     if ( ( assign_end = strchr( assign, '\n' ) ) ) {
+                        *assign_end = '\0';
+                     }
 
-/* Before making the assignment, loop to remove white space and upper
-   case characters from the attribute name. */
-                  lo = 1;
-                  tq = -1;
-                  quoted = 0;
-                  for ( i = j = 0; assign[ i ]; i++ ) {
+/* Copy the assignment to the end of the list, removing white space and
+   upper case characters from the attribute name. */
+                     lo = 1;
+                     tq = -1;
+                     quoted = 0;
+                     j = nlist;
+                     for ( i = 0; assign[ i ]; i++ ) {
 
 /* Note when an '=' sign is encountered (this signals the end of the
    attribute name). */
-                     if ( assign[ i ] == '=' ) lo = 0;
-
-/* Before the '=' sign, convert all characters to lower case and move
-   everything to the left to eliminate white space. Afer the '=' sign,
-   copy all characters to their new location unchanged, except for any
-   delimiting quotes, which are removed. astSetC replaces commas in the
-   attribute value by '\r' characters. Reverse this now. */
-                     if ( !lo || !isspace( assign[ i ] ) ) {
-                        if( assign[ i ] == '\r' ) {
-                           assign[ j++ ] = ',';
-
-                        } else if( lo ) {
-                           assign[ j++ ] = tolower( assign[ i ] );
-
-                        } else {
-                           assign[ j++ ] = assign[ i ];
-
-                           if( tq > 0 && !isspace( assign[ i ] ) ) {
-                              if( assign[ i ] == '"' ) {
-                                 quoted = 1;
-                                 j--;
+                        if ( assign[ i ] == '=' ) lo = 0;
+
+/* Before the '=' sign, convert all characters to lower case and omit
+   white space. Afer the '=' sign, copy all characters unchanged, except
+   for any delimiting quotes, which are removed. astSetC replaces commas
+   in the attribute value by '\r' characters. Reverse this now. */
+                        if ( !lo || !isspace( assign[ i ] ) ) {
+                           if( assign[ i ] == '\r' ) {
+                              list[ j++ ] = ',';
+
+                           } else if( lo ) {
+                              list[ j++ ] = tolower( assign[ i ] );
+
+                           } else {
+                              list[ j++ ] = assign[ i ];
+
+                              if( tq > 0 && !isspace( assign[ i ] ) ) {
+                                 if( assign[ i ] == '"' ) {
+                                    quoted = 1;
+                                    j--;
+                                 }
+                                 tq = 0;
                               }
-                              tq = 0;
-                           }
 
+                           }
                         }
-                     }
 
 /* If the current character is the initial '=' sign, set "tq" positive,
-   meaning "check if the next non-space character is a quote". */
-                     if ( assign[ i ] == '=' && tq == -1 ) tq = 1;
-                  }
+   meaning "check if the next non-space is a quote". */
+                        if ( assign[ i ] == '=' && tq == -1 ) tq = 1;
+                     }
 
 /* if the value was quoted. remove the trailing quote. */
-                  if( quoted ) {
-                     j--;
-                     while( isspace( assign[ j ] ) ) j--;
-                     if( assign[ j ] == '"' ) j--;
-                     j++;
-                  }
-
-/* Terminate the revised assignment string and pass it to astSetAttrib
-   to make the assignment (unless the string was all blank, in which
-   case we ignore it). */
-                  assign[ j ] = '\0';
-                  if ( j ) {
-
-/* If there are no characters to the right of the equals sign append a
-   space after the equals sign. Without this, a string such as "Title="
-   would not be succesfully matched against the attribute name "Title"
-   within SetAttrib. */
-                     if( assign[ j - 1 ] == '=' ) {
-                        buff3 = astStore( NULL, assign,
-                                          (size_t) j + 2 );
-                        if ( astOK ) {
-                           buff3[ j ] = ' ';
-                           buff3[ j + 1 ] = '\0';
-                           astSetAttrib( this, buff3 );
-                        }
-                        buff3 = astFree( buff3 );
+                     if( quoted ) {
+                        j--;
+                        while( isspace( list[ j ] ) ) j--;
+                        if( list[ j ] == '"' ) j--;
+                        j++;
+                     }
 
-                     } else {
-                        astSetAttrib( this, assign );
+/* Ignore the assignment if it was all blank. Otherwise, if there are no
+   characters to the right of the equals sign append a space after the
+   equals sign. Without this, a string such as "Title=" would not be
+   succesfully matched against the attribute name "Title" within
+   SetAttrib. Then terminate it. */
+                     if ( j > nlist ) {
+                        if( list[ j - 1 ] == '=' ) list[ j++ ] = ' ';
+                        list[ j++ ] = '\0';
+                        nlist = j;
                      }
+
+/* Process the next assignment substring. */
+                     assign = assign_end ? assign_end + 1 : NULL;
                   }
 
-/* Check for errors and abort if any assignment fails. Otherwise,
-   process the next assignment substring. */
-                  if ( !astOK ) break;
-                  assign = assign_end ? assign_end + 1 : NULL;
+/* Terminate the list and copy it into the cache if required. */
+                  if( astOK ) {
+                     list[ nlist ] = '\0';
+                     if( icache >= 0 ) memcpy( set_cache_list[ icache ], list,
+                                               (size_t) ( nlist + 1 ) );
+                  }
                }
+
+/* Loop to pass each assignment to astSetAttrib. Check for errors and
+   abort if any assignment fails. */
+               if( astOK ) {
+                  assign = list;
+                  while( *assign ) {
+                     astSetAttrib( this, assign );
+                     if ( !astOK ) break;
+                     assign += strlen( assign ) + 1;
+                  }
+               }
+
+/* Free any dynamically allocated list. */
+               if( list != list_buf ) list = astFree( list );
 	    }
          }
 
 /* Free the memory allocated for string buffers. */
-         buff2 = astFree( buff2 );
+         if( buff2 != buff2_buf ) buff2 = astFree( buff2 );
          dyn_buf = astFree( dyn_buf );
       }
-      buff1 = astFree( buff1 );
+      if( buff1 != buff1_buf ) buff1 = astFree( buff1 );
    }
 }
 #undef ERRBUF_LEN
@@ -4967,6 +5996,36 @@ static void VSet( AstObject *this, const char *settings, char **text,
 *att--
 */
 
+/*
+*att++
+*  Name:
+*     Frozen
+
+*  Purpose:
+*     Has the Object been frozen?
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer (boolean), read-only.
+
+*  Description:
+*     This attribute is non-zero if the Object has been frozen using the
+*     astFreeze function (available only in the C interface). A frozen
+*     Object cannot be modified, but may be used by any number of threads
+*     at the same time without being locked.
+
+*  Applicability:
+*     Object
+*        All Objects have this attribute.
+
+*  Notes:
+*     - This attribute is always zero if the AST library has been built
+*     without POSIX thread support.
+*att--
+*/
+
 /*
 *att++
 *  Name:
@@ -5195,7 +6254,43 @@ astMAKE_TEST(Object,UseDefs,(this->usedefs!=CHAR_MAX))
 *  Description:
 *     This attribute gives the total number of bytes of memory used by
 *     the Object. This includes any Objects which are encapsulated within
-*     the supplied Object.
+*     the supplied Object. It also includes any memory that is shared
+*     with other Objects (see attribute ObjShared).
+
+*  Applicability:
+*     Object
+*        All Objects have this attribute.
+*att--
+*/
+
+/*
+*att++
+*  Name:
+*     ObjShared
+
+*  Purpose:
+*     The number of bytes of the Object that are shared with other Objects.
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer, read-only.
+
+*  Description:
+*     This attribute gives the number of bytes included in the ObjSize
+*     attribute that are shared with other Objects. The difference
+*     between ObjSize and ObjShared is the number of bytes used only by
+*     the Object.
+*
+*     When an Object is copied (for instance using
+c     astCopy),
+f     AST_COPY),
+*     large arrays of values that are not changed after the Object
+*     has been created (such as the coefficients of a PolyMap or the
+*     elements of a MatrixMap) are shared by the original Object and
+*     the copy. A private copy of such an array is made only if one of
+*     the Objects needs to change it.
 
 *  Applicability:
 *     Object
@@ -5669,6 +6764,9 @@ AstObject *astInitObject_( void *mem, size_t size, int init,
 /* Use default values for unspecified attributes. */
          new->usedefs = CHAR_MAX;
 
+/* New Objects are not frozen. */
+         new->frozen = 0;
+
 /* Increment the count of active Objects in the virtual function table.
    Use the count as a unique identifier (unique within the class) for
    the Object. */
@@ -5684,7 +6782,24 @@ AstObject *astInitObject_( void *mem, size_t size, int init,
       if ( !astOK ) {
          new = astDelete( new );
 
-#ifdef THREAD_SAFE
+#if defined(AST__ATOMIC)
+      } else {
+         if( pthread_cond_init( &(new->unlocked), NULL ) != 0 && astOK ) {
+            astError( AST__INTER, "astInitObject(%s): Failed to "
+                      "initialise POSIX condition variable for the new "
+                      "Object.", status, vtab->class );
+         }
+         if( pthread_mutex_init( &(new->mutex2), NULL ) != 0 && astOK ) {
+            astError( AST__INTER, "astInitObject(%s): Failed to "
+                      "initialise POSIX mutex2 for the new Object.", status,
+                      vtab->class );
+         }
+         atomic_init( &(new->locker), -1 );
+         atomic_init( &(new->nwait), 0 );
+         new->globals = NULL;
+         (void) ManageLock( new, AST__LOCK, 0, NULL, status );
+         if( !astOK ) new = astDelete( new );
+#elif defined(THREAD_SAFE)
       } else {
          if( pthread_mutex_init( &(new->mutex1), NULL ) != 0 && astOK ) {
             astError( AST__INTER, "astInitObject(%s): Failed to "
@@ -5862,6 +6977,7 @@ void astClear_( AstObject *this, const char *attrib, int *status ) {
 }
 void astClearAttrib_( AstObject *this, const char *attrib, int *status ) {
    if ( !astOK ) return;
+   if ( astCheckFrozen( this, "astClear" ) ) return;
    (**astMEMBER(this,Object,ClearAttrib))( this, attrib, status );
 }
 void astDump_( AstObject *this, AstChannel *channel, int *status ) {
@@ -5884,11 +7000,17 @@ int astEqual_( AstObject *this, AstObject *that, int *status ) {
    return (**astMEMBER(this,Object,Equal))( this, that, status );
 }
 const char *astGetAttrib_( AstObject *this, const char *attrib, int *status ) {
+   const char *result;
+   int locked;
    if ( !astOK ) return NULL;
-   return (**astMEMBER(this,Object,GetAttrib))( this, attrib, status );
+   locked = astFrozenLock( this );
+   result = (**astMEMBER(this,Object,GetAttrib))( this, attrib, status );
+   astFrozenUnlock( locked );
+   return result;
 }
 void astSetAttrib_( AstObject *this, const char *setting, int *status ) {
    if ( !astOK ) return;
+   if ( astCheckFrozen( this, "astSet" ) ) return;
    (**astMEMBER(this,Object,SetAttrib))( this, setting, status );
 }
 void astShow_( AstObject *this, int *status ) {
@@ -5896,8 +7018,13 @@ void astShow_( AstObject *this, int *status ) {
    (**astMEMBER(this,Object,Show))( this, status );
 }
 int astTestAttrib_( AstObject *this, const char *attrib, int *status ) {
+   int locked;
+   int result;
    if ( !astOK ) return 0;
-   return (**astMEMBER(this,Object,TestAttrib))( this, attrib, status );
+   locked = astFrozenLock( this );
+   result = (**astMEMBER(this,Object,TestAttrib))( this, attrib, status );
+   astFrozenUnlock( locked );
+   return result;
 }
 void astEnvSet_( AstObject *this, int *status ) {
    if ( !astOK ) return;
@@ -5944,13 +7071,31 @@ int astHasAttribute_( AstObject *this, const char *attrib, int *status ) {
    external users and the naked C pointers used to handle Objects
    internally. They also implement the context levels used by
    astBegin, astEnd, astExempt and astExport (which are only available
-   to external users). */
+   to external users).
+
+   Each Handle is owned by a single thread, and is only modified by that
+   thread, except for Handles that are not owned by any thread (see
+   astUnlock), which are modified only while mutex2 is locked. The "ptr",
+   "check" and "thread" components may also be read by other threads
+   (e.g. when checking an identifier issued by a different thread), and
+   so are held in atomic variables if possible. */
 typedef struct Handle {
+#if defined(AST__ATOMIC)
+   _Atomic(AstObject *) ptr;     /* C Pointer to the associated Object */
+#else
    AstObject *ptr;               /* C Pointer to the associated Object */
+#endif
    int context;                  /* Context level for this Object */
+#if defined(AST__ATOMIC)
+   atomic_int check;             /* Check value to ensure validity */
+#else
    int check;                    /* Check value to ensure validity */
+#endif
+   unsigned int gen;             /* No. of times the Handle has been issued */
 
-#if defined(THREAD_SAFE)
+#if defined(AST__ATOMIC)
+   atomic_int thread;            /* Identifier for owning thread */
+#elif defined(THREAD_SAFE)
    int thread;                   /* Identifier for owning thread */
 #endif
 
@@ -5992,15 +7137,52 @@ typedef union MixedInts {
    unsigned u;
 } MixedInts;
 
+/* Macros. */
+/* ------- */
+/* Handle structures are allocated in slabs of HANDLE_SLAB Handles. A
+   slab is never moved or freed once allocated, so a Handle can be
+   accessed using its index without locking a mutex. The low 8 bits of
+   an identifier are used for the Handle's generation count, so the
+   index of a Handle must fit in the remaining 24 bits. */
+#define HANDLE_SHIFT 9
+#define HANDLE_SLAB (1<<HANDLE_SHIFT)
+#define HANDLE_MXSLAB (1<<(24-HANDLE_SHIFT))
+
+/* Return a pointer to the Handle with a given index. */
+#define HANDLE(ihandle) (handle_slabs[(ihandle)>>HANDLE_SHIFT]+((ihandle)&(HANDLE_SLAB-1)))
+
+/* The number of free Handles transferred between the list of spare
+   Handles and the free Handle list of a thread at any one time. */
+#define HANDLE_BATCH 64
+
+/* Macros for changing the check value in a Handle that may also be
+   changed by another thread (see astDeleteId). SWAP_CHECK stores a new
+   check value and returns the old value. CLEAR_CHECK sets the check
+   value to zero if it is currently equal to "old", and returns non-zero
+   if it did so. */
+#if defined(AST__ATOMIC)
+#define SWAP_CHECK(handle,value) atomic_exchange(&((handle)->check),(value))
+#define CLEAR_CHECK(handle,old) atomic_compare_exchange_strong(&((handle)->check),&(old),0)
+#else
+#define SWAP_CHECK(handle,value) SwapCheck(handle,value)
+#define CLEAR_CHECK(handle,old) ((handle)->check==(old)?((handle)->check=0,1):0)
+#endif
+
 /* Static Variables. */
 /* ----------------- */
-/* The array of Handle structures is a pool of resources available to all
-   threads. Each thread has its own conext level and its own "active_handles"
-   array to identify the first Handle at each context level. */
-static Handle *handles = NULL; /* Pointer to allocated array of Handles */
-static int free_handles = -1; /* Offset to head of free Handle list */
-static int nhandles = 0; /* Number of Handles in "handles" array */
-static unsigned nids = 0; /* Number of IDs issued to external users */
+/* The slabs of Handle structures are a pool of resources available to all
+   threads. Each thread has its own conext level, its own "active_handles"
+   array to identify the first Handle at each context level, and its own
+   list of free Handles. Free Handles are transferred in batches between
+   the free Handle list of each thread and a global list of spare Handles,
+   so that a thread only needs to lock mutex2 occasionally. */
+#if defined(AST__ATOMIC)
+static _Atomic(Handle *) handle_slabs[ HANDLE_MXSLAB ]; /* Handle slabs */
+#else
+static Handle *handle_slabs[ HANDLE_MXSLAB ]; /* Handle slabs */
+#endif
+static int nslab = 0; /* Number of allocated slabs */
+static int spare_handles = -1; /* Offset to head of spare Handle list */
 
 #if defined(THREAD_SAFE)
 static int unowned_handles = -1; /* Offset to head of unowned Handle
@@ -6028,10 +7210,20 @@ static int Watched_Pointer = -1; /* A pointer ID value to be watched. */
 MYSTATIC AstObject *AssocId( int, int * );
 MYSTATIC int CheckId( AstObject *, int, int * );
 MYSTATIC void AnnulHandle( int, int * );
+MYSTATIC int GetHandle( int * );
+MYSTATIC void FreeHandle( int, int * );
 MYSTATIC void InitContext( int * );
 MYSTATIC void InsertHandle( int, int *, int * );
 MYSTATIC void RemoveHandle( int, int *, int * );
 
+#if defined(THREAD_SAFE)
+MYSTATIC int ClaimHandle( int, int * );
+#endif
+
+#if !defined(AST__ATOMIC)
+MYSTATIC int SwapCheck( Handle *, int );
+#endif
+
 #if defined(MEM_DEBUG)
 MYSTATIC void CheckList( int *, int * );
 MYSTATIC void CheckInList( int, int *, int, int * );
@@ -6136,6 +7328,7 @@ c--
    astDECLARE_GLOBALS         /* Thread-specific global data */
    int i;                     /* Loop count */
    int ihandle;               /* Offset of Handle to be annulled */
+   int nhandle;               /* Number of allocated Handles */
    AstObjectVtab *req_vtab;   /* Vtab for requested class */
    Handle *handle;            /* Pointer to current Handle */
    int generation_gap;        /* Hereditary relationshp between two classes */
@@ -6166,34 +7359,31 @@ c--
       }
    }
 
-/* Get exclusive access to the handles array. */
+/* Get the number of Handles that have been allocated. Slabs of Handles
+   are never moved or freed, so the Handles can then be accessed without
+   locking the mutex. */
    LOCK_MUTEX2;
+   nhandle = nslab*HANDLE_SLAB;
+   UNLOCK_MUTEX2;
 
-/* Get the index of the first Handle to check. If we are checking only the
-   current context level, then get this index from the appropriate element
-   of the active_handles array. Otherwise, we check the whole of the
-   handles array, starting at element zero. */
-   if( current && active_handles ) {
-      ihandle = active_handles[ context_level ];
-   } else {
-      ihandle = 0;
-   }
+/* Loop over all allocated Handles. */
+   for( ihandle = 0; ihandle < nhandle; ihandle++ ) {
+      handle = HANDLE( ihandle );
 
-/* Loop over the Handles array, starting from the above element. */
-   handle = handles + ihandle;
-   for( ; ihandle < nhandles; ihandle++,handle++ ) {
+#if defined(THREAD_SAFE)
+/* Skip handles that are not locked for use by the current thread. This
+   is done first since the other components of such Handles may be
+   changed at any time by other threads. */
+      if( handle->thread != AST__THREAD_ID ) continue;
+#endif
 
-/* Skip Handles that have no associated object. */
-      if( !handle->ptr ) continue;
+/* Skip Handles that have no associated object, or that have been
+   invalidated by astDelete. */
+      if( !handle->ptr || !handle->check ) continue;
 
 /* Skip handles that are in an unrequired context. */
       if( current && handle->context != context_level ) continue;
 
-#if defined(THREAD_SAFE)
-/* Skip handles that are not locked for use by the current thread. */
-      if( handle->thread != AST__THREAD_ID ) continue;
-#endif
-
 /* If required, check that the current handle is for an object of the
    specified class. */
       if( class ) {
@@ -6217,9 +7407,6 @@ c--
                       astI2P( handle->check ) );
    }
 
-/* Relinquish access to the handles array. */
-   UNLOCK_MUTEX2;
-
 /* Return the KeyMap. */
    return result;
 }
@@ -6267,6 +7454,8 @@ MYSTATIC void AnnulHandle( int ihandle, int *status ) {
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Thread-specific global data */
    AstObject *ptr;               /* Object pointer */
+   Handle *handle;               /* Pointer to the Handle */
+   int check;                    /* Check value for the Handle */
    int context;                  /* Context level where Handle was issued */
 
 /* Get a pointer to Thread-specific global data. */
@@ -6275,7 +7464,8 @@ MYSTATIC void AnnulHandle( int ihandle, int *status ) {
 /* Check that the handle offset supplied is valid and report an error
    if it is not (but only if the global error status has not already
    been set). */
-   if ( ( ihandle < 0 ) || ( ihandle >= nhandles ) ) {
+   if ( ( ihandle < 0 ) || ( ihandle >= HANDLE_MXSLAB*HANDLE_SLAB ) ||
+        !handle_slabs[ ihandle >> HANDLE_SHIFT ] ) {
       if ( astOK ) {
          astError( AST__INHAN, "astAnnulHandle: Invalid attempt to annul an "
                    "Object Handle (no. %u).", status, ihandle );
@@ -6283,15 +7473,26 @@ MYSTATIC void AnnulHandle( int ihandle, int *status ) {
                    "internal programming error)." , status);
       }
 
-/* If OK, obtain the Handle's context level. */
+/* If OK, obtain the Handle's context level. We allow handles that are
+   currently not owned by any thread to be annulled, so first take
+   ownership of any such Handle (this moves it into the current context
+   of the calling thread). Handles owned by other threads are treated as
+   inactive. */
    } else {
-      context = handles[ ihandle ].context;
+      handle = HANDLE( ihandle );
+
+#if defined(THREAD_SAFE)
+      if( handle->thread != AST__THREAD_ID ) (void) ClaimHandle( ihandle, status );
+      context = ( handle->thread == AST__THREAD_ID ) ? handle->context :
+                                                       INVALID_CONTEXT;
+#else
+      context = handle->context;
+#endif
 
 /* If this indicates that the Handle isn't active, then report an
    error (but only if the global error status has not already been
-   set). We allow handles that are currently not owned by any thread to
-   be annulled. */
-      if ( context < 0 && context != UNOWNED_CONTEXT ) {
+   set). */
+      if ( context < 0 ) {
          if ( astOK ) {
             astError( AST__INHAN, "astAnnulHandle: Invalid attempt to annul "
                       "an Object Handle (no. %u).", status, ihandle );
@@ -6299,36 +7500,26 @@ MYSTATIC void AnnulHandle( int ihandle, int *status ) {
                       "internal programming error)." , status);
          }
 
-/* If the Handle is active, annul its Object pointer. The astAnnul
-   function may call Delete functions supplied by any class, and these
-   Delete functions may involve annulling external Object IDs, which in
-   turn requires access to the handles array. For this reason, we release
-   the mutex that protects access to the handles arrays so that it can
-   potentially be re-aquired within astAnnul without causing deadlock. */
+/* If the Handle is active, reset its "check" value (so it is no longer
+   associated with an identifier value) and annul its Object pointer. A
+   "check" value of zero indicates that the Object has already been
+   deleted by another thread using astDelete, in which case the pointer
+   is not annulled. The astAnnul function may call Delete functions
+   supplied by any class, and these Delete functions may involve
+   annulling other external Object IDs. */
       } else {
 
 #ifdef MEM_DEBUG
          astHandleUse( ihandle, "annulled using check value %d ",
-                       handles[ ihandle ].check  );
+                       handle->check  );
 #endif
 
-         ptr = handles[ ihandle ].ptr;
-         UNLOCK_MUTEX2;
-         ptr = astAnnul( ptr );
-         LOCK_MUTEX2;
+         ptr = handle->ptr;
+         check = SWAP_CHECK( handle, 0 );
+         if( check ) ptr = astAnnul( ptr );
 
 /* Remove the Handle from the active list for its context level. */
-         if( context == UNOWNED_CONTEXT ) {
-
-#if defined(THREAD_SAFE)
-            RemoveHandle( ihandle, &unowned_handles, status );
-#else
-            if( astOK ) astError( AST__INTER, "AnnulHandle: reference to "
-                         "'unowned_handles' in a non-thread-safe context "
-                         "(internal AST programming error).", status );
-#endif
-
-         } else if( active_handles ) {
+         if( active_handles ) {
             RemoveHandle( ihandle, &active_handles[ context ], status );
 
          } else if( astOK ){
@@ -6337,18 +7528,9 @@ MYSTATIC void AnnulHandle( int ihandle, int *status ) {
                       status );
          }
 
-/* Reset the Handle's "context" value (making it inactive) and its "check"
-   value (so it is no longer associated with an identifier value). */
-         handles[ ihandle ].ptr = NULL;
-         handles[ ihandle ].context = INVALID_CONTEXT;
-         handles[ ihandle ].check = 0;
-#if defined(THREAD_SAFE)
-         handles[ ihandle ].thread = -1;
-#endif
-
-/* Place the modified Handle on the free Handles list ready for re-use. */
-         InsertHandle( ihandle, &free_handles, status );
-
+/* Place the Handle on the free Handles list ready for re-use. This
+   also resets its "context" value, making it inactive. */
+         FreeHandle( ihandle, status );
       }
    }
 }
@@ -6418,9 +7600,7 @@ AstObject *astAnnulId_( AstObject *this_id, int *status ) {
    not be locked by the current thread (as indicated by the use of
    astMakePointer above), but the *handle* must be owned by the current
    thread. */
-   LOCK_MUTEX2;
    AnnulHandle( CheckId( this_id, 1, status ), status );
-   UNLOCK_MUTEX2;
 
 /* Always return a NULL pointer value. */
    return NULL;
@@ -6482,6 +7662,7 @@ MYSTATIC AstObject *AssocId( int ihandle, int *status ) {
 
 /* Local Variables: */
    AstObject *result;            /* Pointer value to return */
+   Handle *handle;               /* Pointer to the Handle */
    MixedInts test;               /* Union for testing encoding */
    MixedInts work;               /* Union for encoding ID value */
 
@@ -6502,7 +7683,7 @@ MYSTATIC AstObject *AssocId( int ihandle, int *status ) {
    test.u = work.u >> 8U;
    if ( test.i != ihandle ) {
       astError( AST__XSOBJ, "AssocId(%s): There are too many AST Objects in "
-                "use at once.", status, astGetClass( handles[ ihandle ].ptr ) );
+                "use at once.", status, astGetClass( HANDLE( ihandle )->ptr ) );
 
 /* If OK, scramble the value by exclusive-ORing with the bit pattern
    in AST__FAC (a value unique to this library), also shifted left by
@@ -6511,21 +7692,23 @@ MYSTATIC AstObject *AssocId( int ihandle, int *status ) {
    } else {
       work.u ^= ( ( (unsigned) AST__FAC ) << 8U );
 
-/* Fill the lowest 8 bits with a count of the total number of IDs
-   issued so far (which we increment here). This makes each ID unique,
-   so that an old one that identifies a Handle that has been annulled
-   and re-used (i.e. associated with a new ID) can be spotted.  We
-   only use the lowest 8 bits of this count because this provides
-   adequate error detection to reveal programming errors and we do not
-   need higher security than this. We also prevent a count of zero
-   being used, as this could result in a zero identifier value (this
-   being reserved as the "null" value). */
-      if ( ++nids > 255U ) nids = 1U;
-      work.u |= nids;
+/* Fill the lowest 8 bits with the generation count of the Handle (the
+   number of IDs that have been issued for the Handle, which we increment
+   here). This makes each ID unique, so that an old one that identifies a
+   Handle that has been annulled and re-used (i.e. associated with a new
+   ID) can be spotted. The count is held in the Handle, and so can be
+   changed without reference to any other thread. We only use the lowest
+   8 bits of this count because this provides adequate error detection to
+   reveal programming errors and we do not need higher security than
+   this. We also prevent a count of zero being used, as this could result
+   in a zero identifier value (this being reserved as the "null" value). */
+      handle = HANDLE( ihandle );
+      if ( ++(handle->gen) > 255U ) handle->gen = 1U;
+      work.u |= handle->gen;
 
 /* Store the value as a check count in the Handle. This will be used
    to validate the ID in future. */
-      handles[ ihandle ].check = work.i;
+      handle->check = work.i;
 
 /* Pack the value into the pointer to be returned. */
       result = astI2P( work.i );
@@ -6659,7 +7842,9 @@ MYSTATIC int CheckId( AstObject *this_id, int lock_check, int *status ) {
 *        The identifier value to be decoded.
 *     lock_check
 *        Should an error be reported if the handle is in an Object
-*        context for a different thread?
+*        context for a different thread? If a value of 2 is supplied,
+*        no such error is reported if the associated Object has been
+*        frozen (see astFreeze).
 *     status
 *        Pointer to the inherited status variable.
 
@@ -6671,13 +7856,20 @@ MYSTATIC int CheckId( AstObject *this_id, int lock_check, int *status ) {
 *     - This function attempts to execute even if the global error
 *     status is set, but no further error report will be made if it
 *     fails under these circumstances.
+*     - This function may lock mutex2, and so should not be called
+*     while mutex2 is locked.
 */
 
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Thread-specific global data */
+   Handle *handle;               /* Pointer to the Handle */
    MixedInts work;               /* Union for decoding ID value */
    int id;                       /* ID value as an int */
    int ihandle;                  /* Result to return */
+   int valid;                    /* Is the Handle active? */
+#if defined(THREAD_SAFE)
+   int thread;                   /* Thread that owns the Handle */
+#endif
 
 #ifdef MEM_DEBUG
    int oldok = astOK;
@@ -6707,44 +7899,69 @@ MYSTATIC int CheckId( AstObject *this_id, int lock_check, int *status ) {
       work.i = id;
       work.u = ( work.u ^ ( ( (unsigned) AST__FAC ) << 8U ) ) >> 8U;
 
-/* Check that the offset obtained doesn't extend beyond the limits of
-   the "handles" array. Report an error if it does. */
-      if ( ( work.i < 0 ) || ( work.i >= nhandles ) ) {
+/* Check that the offset obtained refers to a Handle within an allocated
+   slab. Report an error if it does not. */
+      if ( ( work.i < 0 ) || ( work.i >= HANDLE_MXSLAB*HANDLE_SLAB ) ||
+           !handle_slabs[ work.i >> HANDLE_SHIFT ] ) {
          if ( astOK ) {
             astError( AST__OBJIN, "Invalid Object pointer given (value is "
                       "%d).", status, id );
          }
 
-/* See if the "check" field matches the ID value and the Handle is
-   valid (i.e. is associated with an active Object). If not, the
-   Handle has been annulled and possibly re-used, so report an
-   error. */
-      } else if ( ( handles[ work.i ].check != id ) ||
-                  ( handles[ work.i ].context == INVALID_CONTEXT ) ) {
-         if ( astOK ) {
-            astError( AST__OBJIN, "Invalid Object pointer given (value is "
-                      "%d).", status, id  );
-            astError( AST__OBJIN, "This pointer has been annulled, or the "
-                      "associated Object deleted." , status);
-         }
+/* Otherwise, see if the "check" field matches the ID value and the
+   Handle is valid (i.e. is associated with an active Object). The
+   "check" value of a Handle is reset to zero when it is annulled. If the
+   Handle is not owned by any thread, its other components may be changed
+   at any time by any thread, so lock the mutex while checking it. */
+      } else {
+         handle = HANDLE( work.i );
+
 #if defined(THREAD_SAFE)
-      } else if(  lock_check && handles[ work.i ].context != UNOWNED_CONTEXT &&
-                                handles[ work.i ].thread != AST__THREAD_ID ) {
-         if ( astOK ) {
-            astError( AST__OBJIN, "Invalid Object pointer given (value is "
-                      "%d).", status, id  );
-            astError( AST__OBJIN, "This pointer is currently owned by "
-                      "another thread (possible programming error)." , status);
+         thread = handle->thread;
+         if( thread == -1 ) {
+            LOCK_MUTEX2;
+            thread = handle->thread;
+            valid = ( handle->check == id ) && ( thread != -1 ||
+                              handle->context == UNOWNED_CONTEXT );
+            UNLOCK_MUTEX2;
+         } else {
+            valid = ( handle->check == id );
          }
+#else
+         valid = ( handle->check == id ) &&
+                 ( handle->context != INVALID_CONTEXT );
+#endif
+
+/* If the Handle is not valid, it has been annulled and possibly re-used,
+   so report an error. */
+         if ( !valid ) {
+            if ( astOK ) {
+               astError( AST__OBJIN, "Invalid Object pointer given (value is "
+                         "%d).", status, id  );
+               astError( AST__OBJIN, "This pointer has been annulled, or the "
+                         "associated Object deleted." , status);
+            }
+#if defined(THREAD_SAFE)
+         } else if( lock_check && thread != -1 && thread != AST__THREAD_ID &&
+                    ( lock_check == 1 || !handle->ptr->frozen ) ) {
+            if ( astOK ) {
+               astError( AST__OBJIN, "Invalid Object pointer given (value is "
+                         "%d).", status, id  );
+               astError( AST__OBJIN, "This pointer is currently owned by "
+                         "another thread (possible programming error)." , status);
+            }
 #endif
 
 /* If OK, set the Handle offset to be returned. */
-      } else {
-         ihandle = work.i;
+         } else {
+            ihandle = work.i;
+         }
       }
 
 #ifdef MEM_DEBUG
-      if ( oldok && !astOK && ( work.i >= 0 ) && ( work.i < nhandles ) ) {
+      if ( oldok && !astOK && ( work.i >= 0 ) &&
+           ( work.i < HANDLE_MXSLAB*HANDLE_SLAB ) &&
+           handle_slabs[ work.i >> HANDLE_SHIFT ] ) {
          char buf[200];
          astError( astStatus, "Handle properties: %s ", status,
                    HandleString( work.i, buf ) );
@@ -6757,6 +7974,101 @@ MYSTATIC int CheckId( AstObject *this_id, int lock_check, int *status ) {
    return ihandle;
 }
 
+#if defined(THREAD_SAFE)
+MYSTATIC int ClaimHandle( int ihandle, int *status ) {
+/*
+*  Name:
+*     ClaimHandle
+
+*  Purpose:
+*     Take ownership of a Handle that is not owned by any thread.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int ClaimHandle( int ihandle, int *status )
+
+*  Class Membership:
+*     Object member function.
+
+*  Description:
+*     This function removes an active Handle from the list of Handles
+*     that are not owned by any thread (see astUnlock), assigns it to the
+*     calling thread, and inserts it into the list of active Handles for
+*     the current context level of the calling thread.
+
+*  Parameters:
+*     ihandle
+*        Offset in the "handles" array that identifies the Handle.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the Handle is now owned by the calling thread. Zero if
+*     the Handle is owned by another thread or is not active.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*     - This function locks mutex2, and so should not be called while
+*     mutex2 is locked.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Thread-specific global data */
+   Handle *handle;               /* Pointer to the Handle */
+   int claimed;                  /* Was the Handle claimed? */
+   int result;                   /* Returned value */
+
+/* Get a pointer to Thread-specific global data. */
+   astGET_GLOBALS(NULL);
+
+/* Initialise */
+   result = 0;
+   claimed = 0;
+   handle = HANDLE( ihandle );
+
+/* Ensure the Handles arrays have been initialised. */
+   if ( !active_handles ) InitContext( status );
+
+/* Gain exclusive access to the list of unowned Handles. Check that the
+   Handle is still unowned, since another thread may have claimed it
+   since it was last checked. If so, remove it from the list and assign
+   it to the calling thread. */
+   LOCK_MUTEX2;
+   if( handle->thread == AST__THREAD_ID ) {
+      result = 1;
+
+   } else if( handle->thread == -1 && handle->context == UNOWNED_CONTEXT &&
+              active_handles ) {
+      RemoveHandle( ihandle, &unowned_handles, status );
+      handle->context = context_level;
+      handle->thread = AST__THREAD_ID;
+      result = 1;
+      claimed = 1;
+   }
+   UNLOCK_MUTEX2;
+
+/* Insert the Handle into the active Handles list for the current context
+   level. This list is only used by the calling thread, and so the mutex
+   need not be locked. */
+   if( claimed ) {
+
+#if defined(MEM_DEBUG)
+      astHandleUse( ihandle, "locked by thread %d at context level %d",
+                    AST__THREAD_ID, context_level );
+#endif
+
+      InsertHandle( ihandle, &active_handles[ context_level ], status );
+   }
+
+/* Return the result. */
+   return result;
+}
+#endif
+
 void astCreatedAtId_( AstObject *this_id, const char **routine,
                       const char **file, int *line, int *status ){
 /*
@@ -6835,22 +8147,16 @@ c--
 /* Check the global error status. */
    if ( !astOK ) return;
 
-/* Gain exclusive access to the handles array. */
-   LOCK_MUTEX2;
-
 /* Obtain the Handle offset for this Object. */
    ihandle = CheckId( this_id, 1, status );
    if ( ihandle != -1 ) {
 
 /* Copy the required pointers etc to the supplied addresses. */
-      *routine = handles[ ihandle ].routine;
-      *file = handles[ ihandle ].file;
-      *line = handles[ ihandle ].line;
+      *routine = HANDLE( ihandle )->routine;
+      *file = HANDLE( ihandle )->file;
+      *line = HANDLE( ihandle )->line;
    }
 
-/* Unlock the mutex that guards access to the handles array */
-   UNLOCK_MUTEX2;
-
 }
 
 AstObject *astDeleteId_( AstObject *this_id, int *status ) {
@@ -6903,36 +8209,62 @@ AstObject *astDeleteId_( AstObject *this_id, int *status ) {
 */
 
 /* Local Variables: */
+   astDECLARE_GLOBALS            /* Thread-specific global data */
    AstObject *this;              /* Pointer to Object */
+   Handle *handle;               /* Pointer to current Handle */
+   int check;                    /* Check value for current Handle */
    int i;                        /* Loop counter for Handles */
    int ihandle;                  /* Object Handle offset */
+   int nhandle;                  /* Number of allocated Handles */
 
 /* Obtain the Object pointer from the ID supplied and validate the
    pointer to ensure it identifies a valid Object (this generates an
    error if it doesn't). */
    if ( !astIsAObject( this = astMakePointer( this_id ) ) ) return NULL;
 
-/* Gain exclusive access to the handles array. */
-   LOCK_MUTEX2;
+/* A frozen Object may be in use by other threads, and so cannot be
+   deleted. */
+   if ( astCheckFrozen( this, "astDelete" ) ) return NULL;
+
+/* Get a pointer to Thread-specific global data. */
+   astGET_GLOBALS(NULL);
 
 /* Obtain the Handle offset for this Object. */
    ihandle = CheckId( this_id, 1, status );
    if ( ihandle != -1 ) {
 
+/* Get the number of Handles that have been allocated. */
+      LOCK_MUTEX2;
+      nhandle = nslab*HANDLE_SLAB;
+      UNLOCK_MUTEX2;
+
 /* Since the Object is to be deleted, we must annul all identifiers
-   that refer to it.  Loop to inspect each currently allocated Handle
-   in the "handles" array. */
-      for ( i = 0; i < nhandles; i++ ) {
+   that refer to it.  Loop to inspect each currently allocated Handle. */
+      for ( i = 0; i < nhandle; i++ ) {
+         handle = HANDLE( i );
 
 /* Select active handles and test if their Object pointer refers to
    the Object to be deleted. */
-         if ( ( handles[ i ].context != INVALID_CONTEXT ) &&
-              ( handles[ i ].ptr == this ) ) {
+         check = handle->check;
+         if ( check && ( handle->ptr == this ) ) {
+
+/* Handles owned by another thread cannot be annulled by this thread.
+   Instead, reset their "check" value to zero, so that any ID associated
+   with the Handle becomes invalid. The owning thread will then release
+   the Handle without annulling its Object pointer when the ID is
+   annulled or its context ends. The "check" value is only reset if it
+   has not been changed by the owning thread since it was read. */
+#if defined(THREAD_SAFE)
+            if( handle->thread != AST__THREAD_ID && handle->thread != -1 ) {
+               (void) CLEAR_CHECK( handle, check );
+               continue;
+            }
+#endif
 
-/* If so, explicitly set the reference count for the Object to 2 so
+/* Otherwise, explicitly set the reference count for the Object to 2 so
    that it will not be deleted (yet) when we annul the pointer
    associated with the Handle. */
-            handles[ i ].ptr->ref_count = 2;
+            this->ref_count = 2;
 
 /* Annul the Handle, which frees its resources, decrements the Object
    reference count and makes any ID associated with the Handle become
@@ -6947,8 +8279,6 @@ AstObject *astDeleteId_( AstObject *this_id, int *status ) {
 #endif
    }
 
-   UNLOCK_MUTEX2;
-
 /* When all Handles associated with the Object have been annulled,
    delete the object itself. This over-rides the reference count and
    causes any remaining pointers to the Object (e.g. in internal code
@@ -7032,10 +8362,9 @@ f     depth.
       }
 
 /* If OK, loop while there are still active Handles associated with
-   the current context level. First gain exclusive access to the handles
-   array. */
+   the current context level. All these Handles are owned by the current
+   thread, so no mutex is needed. */
    } else if ( active_handles ) {
-      LOCK_MUTEX2;
       while ( ( ihandle = active_handles[ context_level ] ) != -1 ) {
 
 /* Annul the Handle at the head of the active Handles list. */
@@ -7048,16 +8377,13 @@ f     depth.
    so, transfer it to the free Handles list for re-use. */
          if ( ihandle == active_handles[ context_level ] ) {
             RemoveHandle( ihandle, &active_handles[ context_level ], status );
-            InsertHandle( ihandle, &free_handles, status );
+            FreeHandle( ihandle, status );
          }
       }
 
 /* Ensure the context level is decremented unless it was zero to start
    with. */
       context_level--;
-
-/* Relinquish access to the handles array. */
-      UNLOCK_MUTEX2;
    }
 
 }
@@ -7137,34 +8463,29 @@ f        This routine applies to all Objects.
    (void) astCheckObject( astMakePointer( this_id ) );
    if ( astOK ) {
 
-/* Gain exclusive access to the handles array. */
-      LOCK_MUTEX2;
-
 /* Obtain the Handle offset for this Object. */
       ihandle = CheckId( this_id, 1, status );
+
+/* If the Handle is not currently owned by any thread, take ownership of
+   it (this moves it into the current context of the calling thread). */
+#if defined(THREAD_SAFE)
+      if ( ihandle != -1 && HANDLE( ihandle )->thread != AST__THREAD_ID &&
+           !ClaimHandle( ihandle, status ) ) ihandle = -1;
+#endif
+
       if ( ihandle != -1 ) {
 
 /* Extract the context level at which the Object was created. */
-         context = handles[ ihandle ].context;
+         context = HANDLE( ihandle )->context;
 
 /* Set the new context level to zero, where it cannot be affected by
    ending any context. */
-         handles[ ihandle ].context = 0;
+         HANDLE( ihandle )->context = 0;
 
 /* Remove the object's Handle from its original active Handles list
    and insert it into the list appropriate to its new context
    level. */
-
-#if defined(THREAD_SAFE)
-         if( context == UNOWNED_CONTEXT ) {
-            RemoveHandle( ihandle, &unowned_handles, status );
-         } else {
-            RemoveHandle( ihandle, &active_handles[ context ], status );
-         }
-#else
          RemoveHandle( ihandle, &active_handles[ context ], status );
-#endif
-
          InsertHandle( ihandle, &active_handles[ 0 ], status );
 
 /* If required, tell the user that the handle has been exempted. */
@@ -7172,8 +8493,6 @@ f        This routine applies to all Objects.
          astHandleUse( ihandle, "exempted" );
 #endif
       }
-
-      UNLOCK_MUTEX2;
    }
 }
 
@@ -7250,9 +8569,6 @@ f     and have not been rendered exempt using AST_EXEMPT.
    (void) astCheckObject( astMakePointer( this_id ) );
    if ( astOK ) {
 
-/* Gain exclusive access to the handles array. */
-      LOCK_MUTEX2;
-
 /* Obtain the Handle offset for this Object. */
       ihandle = CheckId( this_id, 1, status );
       if ( ihandle != -1 ) {
@@ -7262,11 +8578,18 @@ f     and have not been rendered exempt using AST_EXEMPT.
          if ( context_level < 1 ) {
             if( astOK ) astError( AST__EXPIN, "astExport(%s): Attempt to export an Object "
                                   "from context level zero.", status,
-                                  astGetClass( handles[ ihandle ].ptr ) );
+                                  astGetClass( HANDLE( ihandle )->ptr ) );
 
-/* Extract the context level at which the Object was created. */
+/* Extract the context level at which the Object was created. Handles
+   that are not owned by any thread are not in any context, and so are
+   left unchanged. */
          } else {
-            context = handles[ ihandle ].context;
+#if defined(THREAD_SAFE)
+            context = ( HANDLE( ihandle )->thread == AST__THREAD_ID ) ?
+                      HANDLE( ihandle )->context : UNOWNED_CONTEXT;
+#else
+            context = HANDLE( ihandle )->context;
+#endif
 
 /* Check that the Object's existing context level is high enough to be
    affected by being exported to the next outer context level. If not,
@@ -7274,7 +8597,7 @@ f     and have not been rendered exempt using AST_EXEMPT.
             if ( context > ( context_level - 1 ) ) {
 
 /* Set the new context level. */
-               handles[ ihandle ].context = context_level - 1;
+               HANDLE( ihandle )->context = context_level - 1;
 
 /* Remove the object's Handle from its original active Handles list
    and insert it into the list appropriate to its new context
@@ -7291,7 +8614,6 @@ f     and have not been rendered exempt using AST_EXEMPT.
             }
          }
       }
-      UNLOCK_MUTEX2;
    }
 }
 
@@ -7361,21 +8683,26 @@ f        This routine applies to all Objects.
    (void) astCheckObject( astMakePointer( this_id ) );
    if ( astOK ) {
 
-/* Gain exclusive access to the handles array. */
-      LOCK_MUTEX2;
-
 /* Obtain the Handle offset for this Object. */
       ihandle = CheckId( this_id, 1, status );
+
+/* If the Handle is not currently owned by any thread, take ownership of
+   it (this moves it into the current context of the calling thread). */
+#if defined(THREAD_SAFE)
+      if ( ihandle != -1 && HANDLE( ihandle )->thread != AST__THREAD_ID &&
+           !ClaimHandle( ihandle, status ) ) ihandle = -1;
+#endif
+
       if ( ihandle != -1 ) {
 
 /* Extract the context level at which the Object was created. */
-         context = handles[ ihandle ].context;
+         context = HANDLE( ihandle )->context;
 
 /* Do nothing if the Identifier already belongs to the current context. */
          if( context != context_level ) {
 
 /* Set the new context level. */
-            handles[ ihandle ].context = context_level;
+            HANDLE( ihandle )->context = context_level;
 
 /* Remove the object's Handle from its original active Handles list
    and insert it into the list appropriate to its new context
@@ -7390,7 +8717,6 @@ f        This routine applies to all Objects.
 #endif
          }
       }
-      UNLOCK_MUTEX2;
    }
 }
 
@@ -7483,20 +8809,14 @@ c--
    another thread and so we would pick up the wrong globals. */
    astGET_GLOBALS(NULL);
 
-/* Ensure the running thread has sole access to the static handles arrays. */
-   LOCK_MUTEX2;
-
 /* Ensure the Handles arrays have been initialised. */
    if ( !active_handles ) InitContext( status );
 
-/* Get the Handle index for the supplied object identifier. No error is
-   reported if the handle is not curently associated with a thread.
-   However, an error is reported if the Handle is associated with any
-   thread other than the running thread. */
-   ihandle = CheckId( this_id, 1, status );
-
-/* We've finished with the handles arrays, for the moment. */
-   UNLOCK_MUTEX2;
+/* Get the Handle index for the supplied object identifier. No check is
+   made on the thread that owns the Handle at this point, since the Handle
+   may legitimately be owned by another thread that is about to unlock the
+   Object (if "wait" is non-zero we wait for this below). */
+   ihandle = CheckId( this_id, 0, status );
 
 /* Check the object pointer was valid. */
    if( ihandle != -1 ){
@@ -7524,30 +8844,17 @@ c--
             astError( AST__LCKERR, "astLock(%s): Failed to lock a POSIX mutex.", status,
                       astGetClass( this ) );
 
-/* If the Object is now locked for the running thread... */
-         } else {
-
-/* We need access to the handles arrays again. */
-            LOCK_MUTEX2;
-
-/* If the supplied handle is not currently assigned to any thread, assign
-   it to the running thread. */
-            if( handles[ ihandle ].context == UNOWNED_CONTEXT ) {
-               RemoveHandle( ihandle, &unowned_handles, status );
-
-#if defined(MEM_DEBUG)
-               astHandleUse( ihandle, "locked by thread %d at context level %d",
-                             handles[ ihandle ].thread, context_level );
-#endif
-
-               handles[ ihandle ].thread = AST__THREAD_ID;
-               handles[ ihandle ].context = context_level;
-               InsertHandle( ihandle, &active_handles[ context_level ],
-                                status );
-            }
-
-/* Finished with the handles arrays again. */
-            UNLOCK_MUTEX2;
+/* If the Object is now locked for the running thread, and the supplied
+   handle is not currently assigned to any thread, assign it to the
+   running thread. Any other thread that was using the Handle will have
+   released it before unlocking the Object, so report an error if the
+   Handle is still owned by another thread. */
+         } else if( !ClaimHandle( ihandle, status ) ) {
+            astError( AST__OBJIN, "Invalid Object pointer given (value is "
+                      "%d).", status, astP2I( this_id ) );
+            astError( AST__OBJIN, "This pointer is currently owned by "
+                      "another thread (possible programming error).",
+                      status );
          }
       }
    }
@@ -7615,6 +8922,7 @@ c--
    AstErrorContext error_context;/* Info about the current error context */
    AstObject *fail;              /* Pointer to Object that failed */
    AstObject *this;              /* Pointer to Object */
+   Handle *handle;               /* Pointer to the supplied object handle */
    int ihandle;                  /* Index of supplied objetc handle */
    int lstat;                    /* Local status value */
 
@@ -7632,9 +8940,6 @@ c--
    and then clear the status value. It also defer further error reporting. */
    astErrorBegin( &error_context );
 
-/* Ensure the running thread has sole access to the static handles arrays. */
-   LOCK_MUTEX2;
-
 /* Ensure the Handles arrays have been initialised. */
    if ( !active_handles ) InitContext( status );
 
@@ -7648,23 +8953,24 @@ c--
    handle is not assigned to any thread. We do this before unlocking the
    Object structure (using astManageLock) since as soon as astManageLock
    returns, another thread that is waiting for the object to be unlocked
-   may start up and modify the handle properties. */
-   if( ihandle >= 0 && handles[ ihandle ].context >= 0 ) {
-      RemoveHandle( ihandle, &active_handles[ handles[ ihandle ].context ],
-                    status );
+   may start up and modify the handle properties. The Handle is removed
+   from the current thread's context list without locking the mutex, but
+   the list of unowned handles is shared by all threads and so the mutex
+   must be locked while adding the Handle to it. */
+   if( ihandle >= 0 && HANDLE( ihandle )->thread == AST__THREAD_ID ) {
+      handle = HANDLE( ihandle );
+      RemoveHandle( ihandle, &active_handles[ handle->context ], status );
 #if defined(MEM_DEBUG)
       astHandleUse( ihandle, "unlocked from thread %d at context "
-                    "level %d", handles[ ihandle ].thread,
-                    handles[ ihandle ].context );
+                    "level %d", handle->thread, handle->context );
 #endif
-      handles[ ihandle ].thread = -1;
-      handles[ ihandle ].context = UNOWNED_CONTEXT;
+      LOCK_MUTEX2;
+      handle->context = UNOWNED_CONTEXT;
+      handle->thread = -1;
       InsertHandle( ihandle, &unowned_handles, status );
+      UNLOCK_MUTEX2;
    }
 
-/* We've finished with the handles arrays, for the moment. */
-   UNLOCK_MUTEX2;
-
 /* Check the supplied object pointer was valid. */
    if( ihandle != -1 ){
 
@@ -7766,6 +9072,222 @@ AstObject *astI2P_( int integer, int *status ) {
    return temp.pointer;
 }
 
+MYSTATIC void FreeHandle( int ihandle, int *status ) {
+/*
+*  Name:
+*     FreeHandle
+
+*  Purpose:
+*     Return a Handle to the free Handle list of the calling thread.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     void FreeHandle( int ihandle, int *status )
+
+*  Class Membership:
+*     Object member function.
+
+*  Description:
+*     This function makes a Handle inactive and adds it to the list of
+*     free Handles owned by the calling thread, ready for re-use. If the
+*     list becomes too long, a batch of Handles is moved from it to the
+*     global list of spare Handles, so that they can be used by other
+*     threads.
+
+*  Parameters:
+*     ihandle
+*        Offset in the "handles" array that identifies the Handle. The
+*        Handle should be owned by the calling thread and should not be
+*        in any list.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Thread-specific global data */
+   Handle *handle;               /* Pointer to the Handle */
+   int i;                        /* Loop count */
+   int jhandle;                  /* Offset of Handle to move */
+
+/* Get a pointer to Thread-specific global data. */
+   astGET_GLOBALS(NULL);
+
+/* Reset the Handle's "context" value (making it inactive) and its "check"
+   value (so it is no longer associated with an identifier value). */
+   handle = HANDLE( ihandle );
+   handle->ptr = NULL;
+   handle->context = INVALID_CONTEXT;
+   handle->check = 0;
+
+/* Place the Handle on the calling thread's list of free Handles. */
+   InsertHandle( ihandle, &free_handles, status );
+   nfree_handles++;
+
+/* If the list has become too long, move a batch of the least recently
+   freed Handles (at the end of the list) to the global list of spare
+   Handles. */
+   if( nfree_handles > 2*HANDLE_BATCH ) {
+      LOCK_MUTEX2;
+      for( i = 0; i < HANDLE_BATCH; i++ ) {
+         jhandle = HANDLE( free_handles )->blink;
+         RemoveHandle( jhandle, &free_handles, status );
+#if defined(THREAD_SAFE)
+         HANDLE( jhandle )->thread = -1;
+#endif
+         InsertHandle( jhandle, &spare_handles, status );
+      }
+      nfree_handles -= HANDLE_BATCH;
+      UNLOCK_MUTEX2;
+   }
+}
+
+MYSTATIC int GetHandle( int *status ) {
+/*
+*  Name:
+*     GetHandle
+
+*  Purpose:
+*     Obtain a free Handle for use by the calling thread.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int GetHandle( int *status )
+
+*  Class Membership:
+*     Object member function.
+
+*  Description:
+*     This function removes a Handle from the list of free Handles owned
+*     by the calling thread and returns its offset. If the list is empty,
+*     a batch of Handles is first transferred to it from the global list
+*     of spare Handles (a new slab of Handles is allocated if there are no
+*     spare Handles). Only the transfer requires mutex2 to be locked.
+
+*  Parameters:
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The offset of the Handle in the "handles" array. The Handle is
+*     owned by the calling thread and is not in any list.
+
+*  Notes:
+*     - A value of -1 is returned if this function is invoked with the
+*     global status set or if it should fail for any reason.
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Thread-specific global data */
+   Handle *slab;                 /* Pointer to new slab of Handles */
+   int i;                        /* Loop count */
+   int ihandle;                  /* Offset of Handle */
+   int jhandle;                  /* Offset of last Handle in batch */
+   int result;                   /* Returned value */
+
+/* Initialise. */
+   result = -1;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get a pointer to Thread-specific global data. */
+   astGET_GLOBALS(NULL);
+
+/* If the calling thread has no free Handles, gain exclusive access to
+   the global list of spare Handles. */
+   if( free_handles == -1 ) {
+      LOCK_MUTEX2;
+
+/* If there are no spare Handles, allocate a new slab of Handles and add
+   them all to the list of spare Handles. Report an error if the maximum
+   number of Handles has been reached. */
+      if( spare_handles == -1 ) {
+         if( nslab >= HANDLE_MXSLAB ) {
+            astError( AST__XSOBJ, "astMakeId: There are too many AST "
+                      "Objects in use at once.", status );
+         } else {
+            astBeginPM;
+            slab = astMalloc( HANDLE_SLAB*sizeof( Handle ) );
+            astEndPM;
+
+            if( astOK ) {
+               for( i = 0; i < HANDLE_SLAB; i++ ) {
+                  slab[ i ].ptr = NULL;
+                  slab[ i ].context = INVALID_CONTEXT;
+                  slab[ i ].check = 0;
+                  slab[ i ].gen = 0;
+                  slab[ i ].flink = -1;
+                  slab[ i ].blink = -1;
+                  slab[ i ].line = 0;
+                  slab[ i ].file = NULL;
+                  slab[ i ].routine = NULL;
+#if defined(THREAD_SAFE)
+                  slab[ i ].thread = -1;
+#endif
+
+#if defined(MEM_DEBUG)
+                  slab[ i ].id = 0;
+                  slab[ i ].vtab = NULL;
+#endif
+               }
+
+               handle_slabs[ nslab ] = slab;
+               for( i = HANDLE_SLAB - 1; i >= 0; i-- ) {
+                  InsertHandle( nslab*HANDLE_SLAB + i, &spare_handles, status );
+               }
+               nslab++;
+            }
+         }
+      }
+
+/* Transfer a batch of spare Handles from the start of the global list
+   to the calling thread's list of free Handles. Find the last Handle in
+   the batch, and then work backwards so that the Handles retain their
+   order (Handles are then re-used in order of increasing offset, as
+   they were before the "handles" array was divided into slabs). */
+      if( spare_handles != -1 ) {
+         jhandle = spare_handles;
+         for( i = 1; i < HANDLE_BATCH &&
+                     HANDLE( jhandle )->flink != spare_handles; i++ ) {
+            jhandle = HANDLE( jhandle )->flink;
+         }
+
+         for( ; i > 0; i-- ) {
+            ihandle = jhandle;
+            jhandle = HANDLE( ihandle )->blink;
+            RemoveHandle( ihandle, &spare_handles, status );
+#if defined(THREAD_SAFE)
+            HANDLE( ihandle )->thread = AST__THREAD_ID;
+#endif
+            InsertHandle( ihandle, &free_handles, status );
+            nfree_handles++;
+         }
+      }
+
+      UNLOCK_MUTEX2;
+   }
+
+/* Remove the Handle at the head of the list of free Handles. */
+   if( free_handles != -1 ) {
+      result = free_handles;
+      RemoveHandle( result, &free_handles, status );
+      nfree_handles--;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 MYSTATIC void InitContext( int *status ) {
 /*
 *  Name:
@@ -7862,10 +9384,9 @@ MYSTATIC void InsertHandle( int ihandle, int *head, int *status ) {
 *     - This function does not perform error chacking and does not
 *     generate errors.
 *     - The lists generated by this function use integer offsets into
-*     the "handles" array for their links, rather than pointers. This
-*     is because the array may be re-located in memory when it needs
-*     to be extended, so pointers to its element would not remain
-*     valid.
+*     the "handles" array for their links, rather than pointers. The
+*     "handles" array is composed of separately allocated slabs of
+*     Handles (see the HANDLE macro).
 *     - The list elements are drawn from the "handles" array in the
 *     first place so that they can be addressed by small integers (the
 *     offset in the array). This allows references to Handles to be
@@ -7890,16 +9411,16 @@ MYSTATIC void InsertHandle( int ihandle, int *head, int *status ) {
 
 /* If the list is empty, the sole new element points at itself. */
    if ( *head == -1 ) {
-      handles[ ihandle ].flink = ihandle;
-      handles[ ihandle ].blink = ihandle;
+      HANDLE( ihandle )->flink = ihandle;
+      HANDLE( ihandle )->blink = ihandle;
 
 /* Otherwise, insert the new element in front of the element at the
    head of the list. */
    } else {
-      handles[ ihandle ].flink = *head;
-      handles[ ihandle ].blink = handles[ *head ].blink;
-      handles[ ( handles[ *head ].blink) ].flink = ihandle;
-      handles[ *head ].blink = ihandle;
+      HANDLE( ihandle )->flink = *head;
+      HANDLE( ihandle )->blink = HANDLE( *head )->blink;
+      HANDLE( HANDLE( *head )->blink )->flink = ihandle;
+      HANDLE( *head )->blink = ihandle;
    }
 
 /* Update the list head to identify the new element. */
@@ -7959,125 +9480,73 @@ AstObject *astMakeId_( AstObject *this, int *status ) {
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Thread-specific global data */
    AstObject *id;                /* ID value to return */
+   Handle *handle;               /* Pointer to Handle */
    int ihandle;                  /* Handle offset */
 
 /* Initialise. */
    id = astI2P( 0 );
-   ihandle = 0;
 
-/* Check the global error status. */
-   if ( astOK ) {
+/* Check the global error status. If a non-NULL Object pointer was given,
+   we must obtain a Handle structure to associate with it (otherwise a
+   zero identifier value is returned without error). */
+   if ( astOK && this ) {
 
 /* Get a pointer to Thread-specific global data. */
       astGET_GLOBALS(this);
 
-/* Gain exclusive access to the handles array. */
-      LOCK_MUTEX2;
-
-/* If a non-NULL Object pointer was given, we must obtain a Handle
-   structure to associate with it (otherwise a zero identifier value
-   is returned without error). */
-      if ( this ) {
-
-/* If the free Handles list is not empty, obtain a Handle from it. */
-         if ( free_handles != -1 ) {
-            ihandle = free_handles;
-            RemoveHandle( ihandle, &free_handles, status );
-
-/* Otherwise, allocate a new Handle by extending the "handles" array
-   and using the offset of the new element. */
-         } else {
-
-            astBeginPM;
-            handles = astGrow( handles, nhandles + 1, sizeof( Handle ) );
-            astEndPM;
-
-            if ( astOK ) {
-               ihandle = nhandles++;
-
-               handles[ ihandle ].ptr = NULL;
-               handles[ ihandle ].context = INVALID_CONTEXT;
-               handles[ ihandle ].check = 0;
-               handles[ ihandle ].flink = -1;
-               handles[ ihandle ].blink = -1;
-               handles[ ihandle ].line = 0;
-               handles[ ihandle ].file = NULL;
-               handles[ ihandle ].routine = NULL;
-#if defined(THREAD_SAFE)
-               handles[ ihandle ].thread = 0;
-#endif
-
-#if defined(MEM_DEBUG)
-               handles[ ihandle ].id = 0;
-               handles[ ihandle ].vtab = NULL;
-#endif
-            }
-         }
-
 /* If the first AST context level has not yet been initialised, invoke
    InitContext to initialise it and allocate memory for the
    "active_handles" array which stores context information. */
-         if ( astOK ) {
-            if ( !active_handles ) InitContext( status );
+      if ( !active_handles ) InitContext( status );
+
+/* Obtain a free Handle owned by the current thread. */
+      ihandle = GetHandle( status );
+      if ( astOK ) {
+         handle = HANDLE( ihandle );
 
 /* Store the Object pointer and current context level in the Handle. */
-            if ( astOK ) {
-               handles[ ihandle ].ptr = this;
-               handles[ ihandle ].context = context_level;
-#if defined(THREAD_SAFE)
-               handles[ ihandle ].thread = AST__THREAD_ID;
-#endif
+         handle->ptr = this;
+         handle->context = context_level;
 
 /* Store information that records where the Handle is created - routine
    name, file name and line number. */
-               astGetAt( &handles[ ihandle ].routine,
-                         &handles[ ihandle ].file,
-                         &handles[ ihandle ].line );
+         astGetAt( &handle->routine, &handle->file, &handle->line );
 
 /* Store extra debugging information in the handle if enabled */
 #if defined(MEM_DEBUG)
-               handles[ ihandle ].id = astMemoryId( this );
-               handles[ ihandle ].vtab = this->vtab;
-               if( Watched_Pointer == -1 ) {
-                  astHandleUse( ihandle, "associated with a %s (id %d)",
-                                 astGetClass( this ), astMemoryId( this ));
-               }
+         handle->id = astMemoryId( this );
+         handle->vtab = this->vtab;
+         if( Watched_Pointer == -1 ) {
+            astHandleUse( ihandle, "associated with a %s (id %d)",
+                           astGetClass( this ), astMemoryId( this ));
+         }
 #endif
 
 /* Insert the Handle into the active Handles list for the current
    context level. */
-               InsertHandle( ihandle, &active_handles[ context_level ], status );
+         InsertHandle( ihandle, &active_handles[ context_level ], status );
 
 /* Associate an identifier value with the Handle. */
-               id = AssocId( ihandle, status );
+         id = AssocId( ihandle, status );
 
 #if defined(MEM_DEBUG)
-               int iid = astP2I( id );
-               if( iid == Watched_Pointer ) {
-                  Watched_Handle = ihandle;
-                  printf( "astHandleAlarm: Watched AST pointer (value %d) has been "
-                          "issued for Object handle index %d\n", iid, ihandle );
-                  astHandleUse( ihandle, "associated with a %s (id %d)",
-                                astGetClass( this ), astMemoryId( this ));
-               }
+         int iid = astP2I( id );
+         if( iid == Watched_Pointer ) {
+            Watched_Handle = ihandle;
+            printf( "astHandleAlarm: Watched AST pointer (value %d) has been "
+                    "issued for Object handle index %d\n", iid, ihandle );
+            astHandleUse( ihandle, "associated with a %s (id %d)",
+                          astGetClass( this ), astMemoryId( this ));
+         }
 #endif
 
-/* If an error occurred, clean up by annulling the Handle. This
-   ensures that the Object pointer is annulled and returns the unused
-   Handle to the Free Handle list. */
-               if ( !astOK ) {
-                  AnnulHandle( ihandle, status );
-                  this = NULL;
-               }
-
-/* If the Handle wasn't used (because of an earlier error), return it
-   to the free Handles list. */
-            } else {
-               InsertHandle( ihandle, &free_handles, status );
-            }
+/* If an error occurred, clean up by returning the unused Handle to the
+   free Handles list. The Object pointer is annulled below. */
+         if ( !astOK ) {
+            RemoveHandle( ihandle, &active_handles[ context_level ], status );
+            FreeHandle( ihandle, status );
          }
       }
-      UNLOCK_MUTEX2;
    }
 
 /* If a bad status value was either supplied or generated within this
@@ -8122,7 +9591,8 @@ AstObject *astMakePointer_( AstObject *this_id, int *status ) {
 *  Notes:
 *     - In a thread-safe context, an error is reported if the supplied
 *     Object has not been locked by the calling thread (using astLock)
-*     prior to invoking this function.
+*     prior to invoking this function, unless the Object has been frozen
+*     (using astFreeze).
 *     - The object reference count is not modified by this function,
 *     so the returned pointer should not be annulled by the caller.
 *     - Typically, this function should be used whenever a public
@@ -8150,17 +9620,14 @@ AstObject *astMakePointer_( AstObject *this_id, int *status ) {
 /* Initialise. */
    ptr = NULL;
 
-/* Gain exclusive access to the handles array. */
-   LOCK_MUTEX2;
-
-/* Validate the identifier supplied and derive the Handle offset. */
-   ihandle = CheckId( this_id, 1, status );
+/* Validate the identifier supplied and derive the Handle offset. An
+   identifier owned by another thread may be used if the Object has been
+   frozen. */
+   ihandle = CheckId( this_id, 2, status );
 
 /* If the identifier was valid, extract the Object pointer from the
    Handle. */
-   if ( ihandle != -1 ) ptr = handles[ ihandle ].ptr;
-
-   UNLOCK_MUTEX2;
+   if ( ihandle != -1 ) ptr = HANDLE( ihandle )->ptr;
 
 /* Return the result. */
    return ptr;
@@ -8228,17 +9695,12 @@ AstObject *astMakePointer_NoLockCheck_( AstObject *this_id, int *status ) {
 /* Initialise. */
    ptr = NULL;
 
-/* Gain exclusive access to the handles array. */
-   LOCK_MUTEX2;
-
 /* Validate the identifier supplied and derive the Handle offset. */
    ihandle = CheckId( this_id, 0, status );
 
 /* If the identifier was valid, extract the Object pointer from the
    Handle. */
-   if ( ihandle != -1 ) ptr = handles[ ihandle ].ptr;
-
-   UNLOCK_MUTEX2;
+   if ( ihandle != -1 ) ptr = HANDLE( ihandle )->ptr;
 
 /* Return the result. */
    return ptr;
@@ -8358,13 +9820,13 @@ MYSTATIC void RemoveHandle( int ihandle, int *head, int *status ) {
 
 /* Remove the Handle from the list by re-establishing links between
    the elements on either side of it. */
-   handles[ ( handles[ ihandle ].blink ) ].flink = handles[ ihandle ].flink;
-   handles[ ( handles[ ihandle ].flink ) ].blink = handles[ ihandle ].blink;
+   HANDLE( HANDLE( ihandle )->blink )->flink = HANDLE( ihandle )->flink;
+   HANDLE( HANDLE( ihandle )->flink )->blink = HANDLE( ihandle )->blink;
 
 /* If the element removed was at the head of the list, update the head
    of list offset to identify the following element. */
    if ( ihandle == *head ) {
-      *head = handles[ ihandle ].flink;
+      *head = HANDLE( ihandle )->flink;
 
 /* If the head of list still identifies the removed element, then note
    that the list is now empty. */
@@ -8372,8 +9834,8 @@ MYSTATIC void RemoveHandle( int ihandle, int *head, int *status ) {
    }
 
 /* Make the removed element point at itself. */
-   handles[ ihandle ].flink = ihandle;
-   handles[ ihandle ].blink = ihandle;
+   HANDLE( ihandle )->flink = ihandle;
+   HANDLE( ihandle )->blink = ihandle;
 
 #if defined(MEM_DEBUG)
    astHandleUse( ihandle, "has been removed from %s", buf );
@@ -8381,6 +9843,53 @@ MYSTATIC void RemoveHandle( int ihandle, int *head, int *status ) {
 #endif
 }
 
+#if !defined(AST__ATOMIC)
+MYSTATIC int SwapCheck( Handle *handle, int value ) {
+/*
+*  Name:
+*     SwapCheck
+
+*  Purpose:
+*     Store a new check value in a Handle and return the old value.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     int SwapCheck( Handle *handle, int value )
+
+*  Class Membership:
+*     Object member function.
+
+*  Description:
+*     This function stores a new check value in a Handle and returns the
+*     previous check value. It is used by the SWAP_CHECK macro if C11
+*     atomics are not available (otherwise the check value is swapped
+*     atomically).
+
+*  Parameters:
+*     handle
+*        Pointer to the Handle.
+*     value
+*        The new check value.
+
+*  Returned Value:
+*     The previous check value.
+*/
+
+/* Local Variables: */
+   int result;                   /* Returned value */
+
+/* Swap the values. */
+   result = handle->check;
+   handle->check = value;
+
+/* Return the result. */
+   return result;
+}
+#endif
+
 void astSetId_( void *this_id_void, const char *settings, ... ) {
 /*
 *  Name:
@@ -8528,6 +10037,9 @@ c++
 *     - This function attempts to execute even if the global error
 *     status is set, but no further error report will be made if it
 *     subsequently fails under these circumstances.
+*     - A frozen Object (see astFreeze) may be used by any thread, and
+*     so AST__RUNNING is always returned for a frozen Object if "ptr" is
+*     zero.
 *     - This function is only available in the C interface.
 *     - This function always returns AST__RUNNING if the AST library has
 *     been built without POSIX thread support (i.e. the "-with-pthreads"
@@ -8545,6 +10057,7 @@ c--
    AstObject *this;
    int ihandle;
    int check;
+   int thread;
 
 /* Ensure global variables are accessable. */
    astGET_GLOBALS(NULL);
@@ -8559,9 +10072,6 @@ c--
 /* If the ownership of the handle is being queried... */
    if( ptr ) {
 
-/* Lock the mutex that guards access to the handles array */
-      LOCK_MUTEX2;
-
 /* Check the supplied object identifier is valid and get the
    corresponding index into the handles array. Do not report an
    error if the handle is in an Object context for a different thread. */
@@ -8570,16 +10080,14 @@ c--
 
 /* Set the returned value on the basis of the threa didentifier stored in
    the handle structure. */
-         if( handles[ ihandle ].thread == -1 ) {
+         thread = HANDLE( ihandle )->thread;
+         if( thread == -1 ) {
             result = AST__UNLOCKED;
-         } else if( handles[ ihandle ].thread != AST__THREAD_ID ) {
+         } else if( thread != AST__THREAD_ID ) {
             result = AST__OTHER;
          }
       }
 
-/* Unlock the mutex that guards access to the handles array */
-      UNLOCK_MUTEX2;
-
 /* Otherwise, the ownership of the Object is being queried. Obtain the
    Object pointer from the ID supplied and validate the pointer to ensure
    it identifies a valid Object (this generates an error if it doesn't).
@@ -8763,21 +10271,21 @@ void CheckList( int *head, int *status ) {
    ok = 1;
    if ( *head != -1 ) {
       ihandle = *head;
-      if( handles[ handles[ ihandle ].blink ].flink != ihandle ||
-          handles[ handles[ ihandle ].flink ].blink != ihandle ) {
+      if( HANDLE( HANDLE( ihandle )->blink )->flink != ihandle ||
+          HANDLE( HANDLE( ihandle )->flink )->blink != ihandle ) {
          ok = 0;
 
       } else {
          if( CheckThread( ihandle, head, status ) ) {
-            ihandle= handles[ *head ].blink;
+            ihandle= HANDLE( *head )->blink;
             while( ihandle != *head ) {
-               if( handles[ handles[ ihandle ].blink ].flink != ihandle ||
-                   handles[ handles[ ihandle ].flink ].blink != ihandle ||
+               if( HANDLE( HANDLE( ihandle )->blink )->flink != ihandle ||
+                   HANDLE( HANDLE( ihandle )->flink )->blink != ihandle ||
                    CheckThread( ihandle, head, status ) == 0 ) {
                   ok = 0;
                   break;
                }
-               ihandle= handles[ ihandle ].blink;
+               ihandle= HANDLE( ihandle )->blink;
             }
          }
       }
@@ -8787,18 +10295,18 @@ void CheckList( int *head, int *status ) {
       printf("CheckList error in %s\n", HeadString( head, buf ) );
       printf("   Central handle: %s\n", HandleString( ihandle, buf ) );
 
-      if( handles[ handles[ ihandle ].blink ].flink != ihandle ) {
+      if( HANDLE( HANDLE( ihandle )->blink )->flink != ihandle ) {
          printf("   Central handle->blink: %s\n",
-                 HandleString( handles[ ihandle ].blink, buf ) );
+                 HandleString( HANDLE( ihandle )->blink, buf ) );
          printf("   Central handle->blink->flink: %s\n",
-                 HandleString( handles[ handles[ ihandle ].blink ].flink, buf ) );
+                 HandleString( HANDLE( HANDLE( ihandle )->blink )->flink, buf ) );
       }
 
-      if( handles[ handles[ ihandle ].flink ].blink != ihandle ) {
+      if( HANDLE( HANDLE( ihandle )->flink )->blink != ihandle ) {
          printf("   Central handle->flink: %s\n",
-                 HandleString( handles[ ihandle ].flink, buf ) );
+                 HandleString( HANDLE( ihandle )->flink, buf ) );
          printf("   Central handle->flink->blink: %s\n",
-                 HandleString( handles[ handles[ ihandle ].flink ].blink, buf ) );
+                 HandleString( HANDLE( HANDLE( ihandle )->flink )->blink, buf ) );
       }
    }
 
@@ -8817,13 +10325,13 @@ void CheckInList( int ihandle, int *head, int in, int *status ){
          found = 1;
       } else {
          if( CheckThread( ihandle, head, status ) ) {
-            int jhandle= handles[ *head ].blink;
+            int jhandle= HANDLE( *head )->blink;
             while( jhandle != *head ) {
                if( ihandle == jhandle ) {
                   found = 1;
                   break;
                }
-               jhandle= handles[ jhandle ].blink;
+               jhandle= HANDLE( jhandle )->blink;
             }
          }
       }
@@ -8853,26 +10361,26 @@ int CheckThread( int ihandle, int *head, int *status ) {
    astGET_GLOBALS(NULL);
 
    if( *head == unowned_handles  ) {
-      if(  handles[ ihandle ].thread != -1 ) {
+      if(  HANDLE( ihandle )->thread != -1 ) {
          printf("Handle %s has wrong thread: is %d, should "
              "be -1 (i.e. unowned)\n", HandleString( ihandle, buf ),
-              handles[ ihandle ].thread );
+              HANDLE( ihandle )->thread );
 
          result = 0;
       }
 
-   } else if( *head == free_handles ) {
-      if(  handles[ ihandle ].thread != -1 ) {
+   } else if( *head == spare_handles ) {
+      if(  HANDLE( ihandle )->thread != -1 ) {
          printf("Handle %s has wrong thread: is %d, should "
-             "be -1 (i.e. free)\n", HandleString( ihandle, buf ),
-              handles[ ihandle ].thread );
+             "be -1 (i.e. spare)\n", HandleString( ihandle, buf ),
+              HANDLE( ihandle )->thread );
          result = 0;
       }
 
-   } else if( handles[ ihandle ].thread != AST__THREAD_ID ) {
+   } else if( HANDLE( ihandle )->thread != AST__THREAD_ID ) {
       printf("Handle %s has wrong thread: is %d, should "
              "be %d\n", HandleString( ihandle, buf ),
-              handles[ ihandle ].thread, AST__THREAD_ID );
+              HANDLE( ihandle )->thread, AST__THREAD_ID );
       result = 0;
    }
 
@@ -8932,10 +10440,10 @@ MYSTATIC const char *HandleString( int ihandle, char *buf ){
    if( ihandle >= 0 ) {
       sprintf( buf, "(index:%d v:%d c:%d t:%d i:%d cl:%s) [cur. thread: %d]",
                ihandle,
-               handles[ ihandle ].check,
-               handles[ ihandle ].context, handles[ ihandle ].thread,
-               handles[ ihandle ].id,
-               handles[ ihandle ].vtab ? handles[ ihandle ].vtab->class : "<none>",
+               HANDLE( ihandle )->check,
+               HANDLE( ihandle )->context, HANDLE( ihandle )->thread,
+               HANDLE( ihandle )->id,
+               HANDLE( ihandle )->vtab ? HANDLE( ihandle )->vtab->class : "<none>",
                AST__THREAD_ID );
    } else {
       sprintf( buf, "(index:%d <invalid>) [cur. thread: %d]", ihandle,
@@ -8945,9 +10453,9 @@ MYSTATIC const char *HandleString( int ihandle, char *buf ){
 #else
    if( ihandle >= 0 ) {
       sprintf( buf, "(index:%d v:%d c:%d i:%d cl:%s)", ihandle,
-               handles[ ihandle ].check,
-               handles[ ihandle ].context, handles[ ihandle ].id,
-               handles[ ihandle ].vtab ? handles[ ihandle ].vtab->class : "<none>" );
+               HANDLE( ihandle )->check,
+               HANDLE( ihandle )->context, HANDLE( ihandle )->id,
+               HANDLE( ihandle )->vtab ? HANDLE( ihandle )->vtab->class : "<none>" );
    } else {
       sprintf( buf, "(index:%d <invalid>)", ihandle );
    }
@@ -8963,6 +10471,9 @@ MYSTATIC const char *HeadString( int *head, char *list ){
    if( head == &free_handles ) {
       strcpy( list, "free_handles" );
 
+   } else if( head == &spare_handles ) {
+      strcpy( list, "spare_handles" );
+
 #if defined(THREAD_SAFE)
    } else if( head == &unowned_handles ) {
       strcpy( list, "unowned_handles" );
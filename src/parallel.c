@@ -0,0 +1,861 @@
+/*
+*  Name:
+*     parallel.c
+
+*  Purpose:
+*     Implement functions for sharing work between several threads.
+
+*  Description:
+*     This file implements the Parallel module which provides a pool of
+*     worker threads for use throughout the AST library. For a
+*     description of the module and its interface, see the .h file of
+*     the same name.
+*
+*     Each job started by astParallelFor divides a range of items into
+*     one contiguous section for each participating thread. Each thread
+*     processes its own section in chunks, starting at the low end. A
+*     thread that finishes its own section steals the upper half of the
+*     largest section that remains unprocessed, so that the load is
+*     balanced without each thread having to claim every chunk from a
+*     single shared counter.
+*
+*     Worker threads are only created if AST is built with thread
+*     safety enabled. Otherwise, all items are processed in the calling
+*     thread.
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory.
+*     All Rights Reserved.
+
+*  Licence:
+*     This program is free software: you can redistribute it and/or
+*     modify it under the terms of the GNU Lesser General Public
+*     License as published by the Free Software Foundation, either
+*     version 3 of the License, or (at your option) any later
+*     version.
+*
+*     This program is distributed in the hope that it will be useful,
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*     GNU Lesser General Public License for more details.
+*
+*     You should have received a copy of the GNU Lesser General
+*     License along with this program.  If not, see
+*     <http://www.gnu.org/licenses/>.
+
+*  Authors:
+*     AGT: Agent
+
+*  History:
+*     18-OCT-2026 (AGT):
+*        - Original version.
+*        - Give each thread its own section of the item range, with work
+*        stealing between sections, rather than claiming every chunk from
+*        a single shared counter.
+*        - Worker threads now adopt the MemoryCaching and astEscapes
+*        settings of the calling thread, and the error messages reported
+*        by the first worker to fail are re-reported in the calling
+*        thread.
+*        - The default value for the "Threads" tuning parameter is now
+*        taken from the AST_THREADS environment variable.
+*/
+
+/* Configuration results. */
+/* ====================== */
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/* Module Macros. */
+/* ============== */
+/* Define the astCLASS macro (even although this is not a class
+   implementation) to obtain access to the protected error handling
+   functions. */
+#define astCLASS
+
+/* The name of the environment variable that supplies the default value
+   for the "Threads" tuning parameter. */
+#define THREADS_ENV "AST_THREADS"
+
+/* Include files. */
+/* ============== */
+/* Interface definitions. */
+/* ---------------------- */
+#include "error.h"               /* Error reporting facilities */
+#include "globals.h"             /* Thread-safe global data access */
+#include "memory.h"              /* Memory allocation facilities */
+#include "object.h"              /* For AST__TUNULL and astEscapes */
+#include "parallel.h"            /* Interface to this module */
+
+/* C header files. */
+/* --------------- */
+#include <stdlib.h>
+#include <string.h>
+#if defined(THREAD_SAFE)
+#include <pthread.h>
+#endif
+
+/* Type Definitions. */
+/* ================= */
+#if defined(THREAD_SAFE)
+
+/* The section of the item range owned by one thread taking part in a
+   job. Items "next" to "end-1" have not yet been claimed. Each section
+   has its own mutex so that the threads do not contend for a single
+   lock when claiming chunks. */
+typedef struct ParallelSection {
+   AstDim next;                  /* Index of first unclaimed item */
+   AstDim end;                   /* Index of first item after section */
+   pthread_mutex_t mutex;        /* Protects "next" and "end" */
+} ParallelSection;
+
+/* A description of a job being processed by the pool. */
+typedef struct ParallelJob {
+   AstParallelFun fun;           /* Function that processes a chunk */
+   void *data;                   /* Data to pass to "fun" */
+   AstDim grain;                 /* Number of items in each chunk */
+   int nthread;                  /* Number of threads taking part */
+   ParallelSection section[ AST__MXTHREAD ]; /* Section owned by each thread */
+   int status;                   /* First bad status from a worker */
+   char **messages;              /* Messages reported with "status" */
+   int nmessage;                 /* Number of messages in "messages" */
+   int nbusy;                    /* Number of workers still running */
+   int mem_caching;              /* MemoryCaching value of calling thread */
+   int escapes;                  /* astEscapes value of calling thread */
+} ParallelJob;
+
+#endif
+
+/* Module Variables. */
+/* ================= */
+/* The maximum number of threads (including the calling thread) to be
+   used by astParallelFor. Set via the "Threads" tuning parameter. A
+   value of zero indicates that the default value has not yet been
+   obtained from the AST_THREADS environment variable. */
+static int threads = 0;
+
+/* Data used by the pool of worker threads. Only one job at a time can use
+   the pool ("pool_use_mutex" is locked while a job is in progress). The
+   remaining pool data, and the contents of the current job description
+   (except for the sections, which have their own mutexes), are protected
+   by "pool_mutex". */
+#if defined(THREAD_SAFE)
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t pool_use_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_start_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done_cond = PTHREAD_COND_INITIALIZER;
+static ParallelJob *pool_job = NULL;
+static int pool_nthread = 0;
+static int pool_todo[ AST__MXTHREAD ];
+#define LOCK_POOL_MUTEX pthread_mutex_lock( &pool_mutex );
+#define UNLOCK_POOL_MUTEX pthread_mutex_unlock( &pool_mutex );
+#else
+#define LOCK_POOL_MUTEX
+#define UNLOCK_POOL_MUTEX
+#endif
+
+/* Prototypes for Private Functions. */
+/* ================================= */
+static int DefaultThreads( void );
+
+#if defined(THREAD_SAFE)
+static int ClaimChunk( ParallelJob *, int, AstDim *, AstDim * );
+static void AbortJob( ParallelJob * );
+static void *PoolWorker( void * );
+static void RunJob( ParallelJob *, int, int * );
+#endif
+
+/* Function implementations. */
+/* ========================= */
+#if defined(THREAD_SAFE)
+static void AbortJob( ParallelJob *job ){
+/*
+*  Name:
+*     AbortJob
+
+*  Purpose:
+*     Prevent any further chunks of a job being claimed.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     void AbortJob( ParallelJob *job )
+
+*  Description:
+*     This function empties the section owned by every thread taking
+*     part in a job, so that no further chunks are claimed. Chunks that
+*     have already been claimed are unaffected.
+
+*  Parameters:
+*     job
+*        The job description.
+
+*/
+
+/* Local Variables: */
+   ParallelSection *sec;         /* Section owned by a thread */
+   int i;                        /* Thread index */
+
+   for( i = 0; i < job->nthread; i++ ) {
+      sec = job->section + i;
+      pthread_mutex_lock( &sec->mutex );
+      sec->end = sec->next;
+      pthread_mutex_unlock( &sec->mutex );
+   }
+}
+#endif
+
+#if defined(THREAD_SAFE)
+static int ClaimChunk( ParallelJob *job, int ithread, AstDim *lo,
+                       AstDim *hi ){
+/*
+*  Name:
+*     ClaimChunk
+
+*  Purpose:
+*     Claim the next chunk of items to be processed by a thread.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     int ClaimChunk( ParallelJob *job, int ithread, AstDim *lo,
+*                     AstDim *hi )
+
+*  Description:
+*     This function returns the next chunk from the section of items
+*     owned by the specified thread. If the section is empty, the upper
+*     half of the largest remaining section owned by any other thread is
+*     first transferred to the specified thread. The lower bound of each
+*     chunk is always a multiple of the job's grain size.
+*
+*     A thread only ever holds the mutex for a single section at any one
+*     time, so no deadlock can occur.
+
+*  Parameters:
+*     job
+*        The job description.
+*     ithread
+*        The index of the thread claiming the chunk.
+*     lo
+*        Returned holding the index of the first item in the chunk.
+*     hi
+*        Returned holding the index of the first item after the chunk.
+
+*  Returned Value:
+*     Non-zero if a chunk was claimed, zero if no unclaimed items remain
+*     or the job has been aborted.
+
+*/
+
+/* Local Variables: */
+   AstDim end;                   /* End of stolen items */
+   AstDim ngrain;                /* No. of grains left in victim's section */
+   AstDim nleft;                 /* No. of items left in a section */
+   AstDim nmax;                  /* Largest number of items left */
+   AstDim start;                 /* Start of stolen items */
+   ParallelSection *mine;        /* Section owned by the claiming thread */
+   ParallelSection *victim;      /* Section from which to steal */
+   int i;                        /* Thread index */
+   int result;                   /* Returned value */
+
+/* Attempt to claim the first chunk from this thread's own section. */
+   mine = job->section + ithread;
+   pthread_mutex_lock( &mine->mutex );
+   result = ( mine->next < mine->end );
+   if( result ) {
+      *lo = mine->next;
+      *hi = *lo + job->grain;
+      if( *hi > mine->end ) *hi = mine->end;
+      mine->next = *hi;
+   }
+   pthread_mutex_unlock( &mine->mutex );
+
+/* If this thread's own section is empty, steal items from another
+   thread. Loop until some items are stolen or all sections are empty
+   (another thief may empty the chosen section before we can lock it). */
+   while( !result ) {
+
+/* Find the section with the most unclaimed items. Return zero if all
+   sections are empty. */
+      victim = NULL;
+      nmax = 0;
+      for( i = 0; i < job->nthread; i++ ) {
+         if( i != ithread ) {
+            pthread_mutex_lock( &job->section[ i ].mutex );
+            nleft = job->section[ i ].end - job->section[ i ].next;
+            pthread_mutex_unlock( &job->section[ i ].mutex );
+            if( nleft > nmax ) {
+               nmax = nleft;
+               victim = job->section + i;
+            }
+         }
+      }
+      if( !victim ) break;
+
+/* Take the upper half of the victim's section (rounded to a whole number
+   of grains), or all of it if it contains only a single grain. */
+      pthread_mutex_lock( &victim->mutex );
+      nleft = victim->end - victim->next;
+      if( nleft > 0 ) {
+         ngrain = ( nleft + job->grain - 1 )/job->grain;
+         start = victim->next + ( ngrain/2 )*job->grain;
+         end = victim->end;
+         victim->end = start;
+      }
+      pthread_mutex_unlock( &victim->mutex );
+
+/* If successful, claim the first chunk of the stolen items and make the
+   remainder this thread's new section. */
+      if( nleft > 0 ) {
+         *lo = start;
+         *hi = *lo + job->grain;
+         if( *hi > end ) *hi = end;
+         pthread_mutex_lock( &mine->mutex );
+         mine->next = *hi;
+         mine->end = end;
+         pthread_mutex_unlock( &mine->mutex );
+         result = 1;
+      }
+   }
+
+   return result;
+}
+#endif
+
+static int DefaultThreads( void ){
+/*
+*  Name:
+*     DefaultThreads
+
+*  Purpose:
+*     Get the default value for the "Threads" tuning parameter.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     int DefaultThreads( void )
+
+*  Description:
+*     This function returns the value of the AST_THREADS environment
+*     variable, limited to the range 1 to AST__MXTHREAD. One is returned
+*     if the variable is not defined or does not hold an integer value.
+
+*  Returned Value:
+*     The default number of threads.
+
+*/
+
+/* Local Variables: */
+   char *envvar;                 /* Value of the environment variable */
+   char *end;                    /* Pointer to end of integer value */
+   long int value;               /* Integer value */
+   int result;                   /* Returned value */
+
+   result = 1;
+   envvar = getenv( THREADS_ENV );
+   if( envvar ) {
+      value = strtol( envvar, &end, 10 );
+      if( end != envvar ) {
+         if( value > AST__MXTHREAD ) {
+            result = AST__MXTHREAD;
+         } else if( value > 1 ) {
+            result = (int) value;
+         }
+      }
+   }
+
+   return result;
+}
+
+void astParallelFor_( int nthread, AstDim nitem, AstDim grain,
+                      AstParallelFun fun, void *data, int *status ){
+/*
+*+
+*  Name:
+*     astParallelFor
+
+*  Purpose:
+*     Invoke a function for all items in a range, using several threads.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     void astParallelFor( int nthread, AstDim nitem, AstDim grain,
+*                          AstParallelFun fun, void *data )
+
+*  Description:
+*     This function divides the range of item indices [0,nitem) into
+*     contiguous chunks and invokes the supplied function once for each
+*     chunk. If "nthread" is greater than one, the chunks are shared out
+*     between the calling thread and up to "nthread-1" threads from a
+*     pool of worker threads. Otherwise, the supplied function is invoked
+*     once, in the calling thread, for the whole range.
+*
+*     The supplied function is invoked as:
+*
+*        fun( ithread, lo, hi, data, status )
+*
+*     and should process items "lo" to "hi-1" inclusive. "ithread" is
+*     zero when "fun" is invoked by the calling thread, and is otherwise
+*     the index (in the range 1 to "nthread-1") of the worker thread
+*     invoking "fun". It may be used to select data (such as private
+*     copies of Objects) that is used only by a single thread. "lo" is
+*     always a multiple of "grain".
+*
+*     Worker threads do not hold a lock on any Objects that are locked
+*     by the calling thread, and so "fun" must not invoke AST methods on
+*     any such Objects when "ithread" is greater than zero. It may read
+*     shared data (which must not be changed by any thread while the
+*     job is in progress), and may write to any elements of shared
+*     arrays that correspond to items in the range [lo,hi).
+*
+*     Each worker thread uses the same MemoryCaching and astEscapes
+*     settings as the calling thread while processing the job. Error
+*     messages reported within a worker thread are deferred, and the
+*     messages reported by the first worker to fail are re-reported
+*     within the calling thread, with the same status value, once all
+*     threads have finished.
+
+*  Parameters:
+*     nthread
+*        The maximum number of threads (including the calling thread)
+*        to use. This should usually be the value returned by
+*        astParallelSize.
+*     nitem
+*        The total number of items to process.
+*     grain
+*        The number of items in each chunk. All chunks except the last
+*        will contain exactly this number of items.
+*     fun
+*        The function to invoke for each chunk of items.
+*     data
+*        A pointer that is passed on unchanged to "fun".
+
+*  Notes:
+*     - Only one thread at a time may use the worker pool. If the pool
+*     is already in use (for instance, if this function is invoked by
+*     "fun" within a worker thread), all items are processed in the
+*     calling thread in a single invocation of "fun".
+*     - Once any invocation of "fun" fails, the remaining unclaimed
+*     chunks are abandoned, and each thread stops once it has finished
+*     its current chunk.
+
+*-
+*/
+
+/* Local Variables: */
+#if defined(THREAD_SAFE)
+   AstDim nsec;                  /* Items in each initial section */
+   ParallelJob job;              /* Description of the job */
+   int i;                        /* Thread index */
+   int nworker;                  /* No. of worker threads to use */
+   pthread_attr_t attr;          /* Attributes for new worker threads */
+   pthread_t thread;             /* Identifier for new worker thread */
+#endif
+
+/* Check the global error status. */
+   if ( !astOK || nitem <= 0 ) return;
+   if( grain < 1 ) grain = 1;
+
+#if defined(THREAD_SAFE)
+
+/* Decide how many worker threads (in addition to the calling thread) to
+   use. Each thread should get at least one chunk. */
+   nworker = nthread - 1;
+   if( nworker > AST__MXTHREAD - 1 ) nworker = AST__MXTHREAD - 1;
+   if( (AstDim) nworker > ( nitem - 1 )/grain ) {
+      nworker = (int)( ( nitem - 1 )/grain );
+   }
+
+/* Only one job at a time can use the pool. If another thread is
+   currently using it, process the items in this thread. */
+   if( nworker > 0 && !pthread_mutex_trylock( &pool_use_mutex ) ) {
+
+/* Ensure the pool contains enough worker threads. The threads are
+   detached and persist until the process exits, so that their AST
+   thread-specific data is re-used by subsequent jobs. If a thread cannot
+   be created, just use the ones we have already got. */
+      if( pool_nthread < nworker ) {
+         pthread_attr_init( &attr );
+         pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+         while( pool_nthread < nworker ) {
+            if( pthread_create( &thread, &attr, PoolWorker,
+                                (void *)(size_t)( pool_nthread + 1 ) ) ) break;
+            pool_nthread++;
+         }
+         pthread_attr_destroy( &attr );
+         if( nworker > pool_nthread ) nworker = pool_nthread;
+      }
+
+/* Describe the job. Each thread initially owns an equal section of the
+   item range, containing a whole number of chunks. */
+      job.fun = fun;
+      job.data = data;
+      job.grain = grain;
+      job.nthread = nworker + 1;
+      nsec = ( ( nitem/job.nthread + grain - 1 )/grain )*grain;
+      for( i = 0; i < job.nthread; i++ ) {
+         job.section[ i ].next = i*nsec;
+         job.section[ i ].end = ( i + 1 )*nsec;
+         if( job.section[ i ].next > nitem ) job.section[ i ].next = nitem;
+         if( job.section[ i ].end > nitem ) job.section[ i ].end = nitem;
+         pthread_mutex_init( &job.section[ i ].mutex, NULL );
+      }
+      job.section[ nworker ].end = nitem;
+      job.status = 0;
+      job.messages = NULL;
+      job.nmessage = 0;
+      job.nbusy = nworker;
+
+/* Record the per-thread settings that are to be inherited by the
+   workers. */
+      job.mem_caching = astMemCaching( AST__TUNULL );
+      job.escapes = astEscapes( -1 );
+
+/* Wake up the required workers. */
+      if( astOK ) {
+         LOCK_POOL_MUTEX
+         pool_job = &job;
+         for( i = 1; i <= nworker; i++ ) pool_todo[ i ] = 1;
+         pthread_cond_broadcast( &pool_start_cond );
+         UNLOCK_POOL_MUTEX
+
+/* Process chunks in this thread too, then wait until all the workers
+   have finished. */
+         RunJob( &job, 0, status );
+         LOCK_POOL_MUTEX
+         while( job.nbusy > 0 ) pthread_cond_wait( &pool_done_cond,
+                                                   &pool_mutex );
+         pool_job = NULL;
+         UNLOCK_POOL_MUTEX
+
+/* If a worker failed, and no error has occurred in this thread, re-report
+   the worker's error messages in this thread. */
+         if( job.status && astOK ) {
+            for( i = 0; i < job.nmessage; i++ ) {
+               astError( job.status, "%s", status, job.messages[ i ] );
+            }
+            if( astOK ) {
+               astError( job.status, "astParallelFor: A worker thread "
+                         "failed.", status );
+            }
+         }
+      }
+
+/* Free the section mutexes and the copied messages. */
+      for( i = 0; i < job.nthread; i++ ) {
+         pthread_mutex_destroy( &job.section[ i ].mutex );
+      }
+      for( i = 0; i < job.nmessage; i++ ) {
+         job.messages[ i ] = astFree( job.messages[ i ] );
+      }
+      job.messages = astFree( job.messages );
+
+/* Allow other threads to use the pool. */
+      pthread_mutex_unlock( &pool_use_mutex );
+      return;
+   }
+#endif
+
+/* If no worker threads are being used, process all items in the calling
+   thread. */
+   (*fun)( 0, 0, nitem, data, status );
+}
+
+int astParallelSize_( AstDim nitem, AstDim grain, int *status ){
+/*
+*+
+*  Name:
+*     astParallelSize
+
+*  Purpose:
+*     Return the number of threads astParallelFor would use.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     int astParallelSize( AstDim nitem, AstDim grain )
+
+*  Description:
+*     This function returns the number of threads (including the
+*     calling thread) that should be used to process a given number of
+*     items using astParallelFor. It is the value of the "Threads"
+*     tuning parameter, reduced if necessary so that each thread has
+*     at least four chunks of items to process. The returned value may
+*     be used to allocate any per-thread data needed by the function
+*     passed to astParallelFor, and should then be passed to
+*     astParallelFor as its "nthread" argument.
+
+*  Parameters:
+*     nitem
+*        The total number of items to be processed.
+*     grain
+*        The number of items in each chunk.
+
+*  Returned Value:
+*     The number of threads. Always one if AST was built without
+*     thread-safety enabled.
+
+*  Notes:
+*     - A value of one is returned if an error has already occurred,
+*     or if this function should fail for any reason.
+
+*-
+*/
+
+/* Local Variables: */
+   int result;                   /* Returned value */
+
+/* Initialise. */
+   result = 1;
+
+/* Check the global error status. */
+   if( !astOK ) return result;
+
+#if defined(THREAD_SAFE)
+   result = astParallelThreads( AST__TUNULL );
+   if( grain < 1 ) grain = 1;
+   if( (AstDim) result > nitem/( 4*grain ) ) result = (int)( nitem/( 4*grain ) );
+   if( result < 1 ) result = 1;
+#endif
+
+   return result;
+}
+
+int astParallelThreads_( int value, int *status ){
+/*
+*+
+*  Name:
+*     astParallelThreads
+
+*  Purpose:
+*     Set or get the value of the "Threads" tuning parameter.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     int astParallelThreads( int value )
+
+*  Description:
+*     This function returns the current value of the "Threads" tuning
+*     parameter, optionally storing a new value. It is invoked by
+*     astTune. The value is the maximum number of threads (including the
+*     calling thread) used by astParallelFor. If no value has been set,
+*     the value of the AST_THREADS environment variable is used, or one
+*     if the variable is not defined.
+
+*  Parameters:
+*     value
+*        The new value. If this is AST__TUNULL the current value is
+*        retained. Values less than one are treated as one. The value is
+*        also limited to a maximum of AST__MXTHREAD.
+
+*  Returned Value:
+*     The original value.
+
+*  Notes:
+*     - This function attempts to execute even if an error has already
+*     occurred.
+*     - The value has no effect unless AST was built with thread-safety
+*     enabled.
+
+*-
+*/
+
+/* Local Variables: */
+   int result;
+
+   LOCK_POOL_MUTEX
+   if( !threads ) threads = DefaultThreads();
+   result = threads;
+   if( value != AST__TUNULL ) {
+      if( value < 1 ) value = 1;
+      if( value > AST__MXTHREAD ) value = AST__MXTHREAD;
+      threads = value;
+   }
+   UNLOCK_POOL_MUTEX
+
+   return result;
+}
+
+#if defined(THREAD_SAFE)
+static void *PoolWorker( void *arg ){
+/*
+*  Name:
+*     PoolWorker
+
+*  Purpose:
+*     The main function for a worker thread.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     void *PoolWorker( void *arg )
+
+*  Description:
+*     This function is run by each thread in the pool of worker threads.
+*     It waits until it is asked to take part in a job, adopts the
+*     per-thread settings of the thread that started the job, processes
+*     chunks of items until there are none left, records any error
+*     status and messages in the job description, and then waits for the
+*     next job. It never returns.
+
+*  Parameters:
+*     arg
+*        The one-based index of the worker thread, cast to a pointer.
+
+*  Returned Value:
+*     NULL (never returned).
+
+*/
+
+/* Local Variables: */
+   astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   ParallelJob *job;             /* The job being processed */
+   char **messages;              /* Copies of deferred error messages */
+   int *status;                  /* Pointer to inherited status value */
+   int i;                        /* Message index */
+   int iworker;                  /* Index of this worker */
+   int nmessage;                 /* Number of deferred error messages */
+   int wstatus;                  /* Status value at end of job */
+
+/* Get the index of this worker, and a pointer to its thread-specific
+   status value and global data. */
+   iworker = (int)(size_t) arg;
+   status = astGetStatusPtr;
+   astGET_GLOBALS(NULL);
+
+/* Defer all error messages reported in this thread. Messages from a
+   failed job are re-reported by the calling thread. */
+   (void) astReporting( 0 );
+
+/* Loop for ever, processing jobs. */
+   LOCK_POOL_MUTEX
+   while( 1 ) {
+
+/* Wait until this worker is asked to take part in a job. */
+      while( !pool_todo[ iworker ] ) pthread_cond_wait( &pool_start_cond,
+                                                        &pool_mutex );
+      job = pool_job;
+      UNLOCK_POOL_MUTEX
+
+/* Adopt the per-thread settings of the calling thread. The memory cache
+   is emptied whenever its setting is changed, so only change it if
+   necessary. */
+      astClearStatus;
+      if( astMemCaching( AST__TUNULL ) != job->mem_caching ) {
+         (void) astMemCaching( job->mem_caching );
+      }
+      (void) astEscapes( job->escapes );
+
+/* Process chunks of items. This is done in a scratch memory context so
+   that memory blocks freed while processing one job are re-used by later
+   jobs. */
+      astBeginScratch;
+      RunJob( job, iworker, status );
+      astEndScratch;
+
+/* If an error occurred, take copies of the deferred error messages, then
+   clear the status (which also discards the messages). */
+      wstatus = *status;
+      messages = NULL;
+      nmessage = 0;
+      if( wstatus ) {
+         *status = 0;
+         nmessage = astGLOBAL(Error,Mstack_Size);
+         messages = astMalloc( sizeof( char * )*(size_t) nmessage );
+         if( messages ) {
+            for( i = 0; i < nmessage; i++ ) {
+               messages[ i ] = astStore( NULL,
+                                         astGLOBAL(Error,Message_Stack)[ i ],
+                                         strlen( astGLOBAL(Error,Message_Stack)[ i ] ) + 1 );
+            }
+         } else {
+            nmessage = 0;
+         }
+      }
+      astClearStatus;
+
+/* Record the status and messages if this is the first worker to fail,
+   and tell the calling thread when the last worker has finished. */
+      LOCK_POOL_MUTEX
+      if( wstatus != 0 && job->status == 0 ) {
+         job->status = wstatus;
+         job->messages = messages;
+         job->nmessage = nmessage;
+         messages = NULL;
+         nmessage = 0;
+      }
+      pool_todo[ iworker ] = 0;
+      if( --job->nbusy == 0 ) pthread_cond_signal( &pool_done_cond );
+
+/* Free any messages that were not needed. */
+      for( i = 0; i < nmessage; i++ ) messages[ i ] = astFree( messages[ i ] );
+      messages = astFree( messages );
+   }
+
+   return NULL;
+}
+#endif
+
+#if defined(THREAD_SAFE)
+static void RunJob( ParallelJob *job, int ithread, int *status ){
+/*
+*  Name:
+*     RunJob
+
+*  Purpose:
+*     Process chunks of items until none are left.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "parallel.h"
+*     void RunJob( ParallelJob *job, int ithread, int *status )
+
+*  Description:
+*     This function is invoked by the calling thread and by each worker
+*     thread taking part in a job started by astParallelFor. It
+*     repeatedly claims the next unprocessed chunk of items and invokes
+*     the job's function on it. If an error occurs, the job is aborted
+*     so that no further chunks are started by any thread.
+
+*  Parameters:
+*     job
+*        The job description.
+*     ithread
+*        Zero for the calling thread, or the one-based index of a worker
+*        thread.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstDim hi;                    /* Index of first item after chunk */
+   AstDim lo;                    /* Index of first item in chunk */
+
+/* Loop until all chunks have been claimed. */
+   while( astOK && ClaimChunk( job, ithread, &lo, &hi ) ) {
+      (*job->fun)( ithread, lo, hi, job->data, status );
+
+/* If an error has occurred, prevent any further chunks being started. */
+      if( !astOK ) AbortJob( job );
+   }
+}
+#endif
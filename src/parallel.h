@@ -0,0 +1,107 @@
+#if !defined( PARALLEL_INCLUDED )  /* Include this file only once */
+#define PARALLEL_INCLUDED
+/*
+*+
+*  Name:
+*     parallel.h
+
+*  Purpose:
+*     Define the interface to the Parallel module.
+
+*  Description:
+*     This module provides a pool of worker threads that may be used by
+*     any part of the AST library to share the processing of a large
+*     number of independent items (points, pixels, rows, etc) between
+*     several threads. The number of threads is controlled by the
+*     "Threads" tuning parameter (see astTune), or by the AST_THREADS
+*     environment variable.
+*
+*     Note that this module is not a class implementation, although it
+*     resembles one.
+
+*  Functions Defined:
+*     Public:
+*        None.
+*
+*     Protected:
+*        astParallelFor
+*           Invoke a function for all items in a range, using several
+*           threads.
+*        astParallelSize
+*           Return the number of threads astParallelFor would use.
+*        astParallelThreads
+*           Set or get the value of the "Threads" tuning parameter.
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory.
+*     All Rights Reserved.
+
+*  Licence:
+*     This program is free software: you can redistribute it and/or
+*     modify it under the terms of the GNU Lesser General Public
+*     License as published by the Free Software Foundation, either
+*     version 3 of the License, or (at your option) any later
+*     version.
+*
+*     This program is distributed in the hope that it will be useful,
+*     but WITHOUT ANY WARRANTY; without even the implied warranty of
+*     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*     GNU Lesser General Public License for more details.
+*
+*     You should have received a copy of the GNU Lesser General
+*     License along with this program.  If not, see
+*     <http://www.gnu.org/licenses/>.
+
+*  Authors:
+*     AGT: Agent
+
+*  History:
+*     18-OCT-2026 (AGT):
+*        Original version.
+*-
+*/
+
+/* Include files. */
+/* ============== */
+#include "object.h"
+
+/* Macros. */
+/* ======= */
+#if defined(astCLASS)            /* Protected */
+
+/* The maximum number of threads (including the calling thread) that may
+   be used by astParallelFor. */
+#define AST__MXTHREAD 64
+
+#endif
+
+/* Type Definitions. */
+/* ================= */
+#if defined(astCLASS)            /* Protected */
+
+/* The function invoked by astParallelFor to process a contiguous range
+   of items. The arguments are the index of the invoking thread (zero for
+   the calling thread), the index of the first item, the index of the
+   first item after the range, the "data" pointer supplied to
+   astParallelFor, and the inherited status. */
+typedef void (* AstParallelFun)( int, AstDim, AstDim, void *, int * );
+
+#endif
+
+/* Function prototypes. */
+/* ==================== */
+#if defined(astCLASS)            /* Protected */
+int astParallelSize_( AstDim, AstDim, int * );
+int astParallelThreads_( int, int * );
+void astParallelFor_( int, AstDim, AstDim, AstParallelFun, void *, int * );
+#endif
+
+/* Function interfaces. */
+/* ==================== */
+#if defined(astCLASS)            /* Protected */
+#define astParallelFor(nthread,nitem,grain,fun,data) astParallelFor_(nthread,nitem,grain,fun,data,STATUS_PTR)
+#define astParallelSize(nitem,grain) astParallelSize_(nitem,grain,STATUS_PTR)
+#define astParallelThreads(value) astParallelThreads_(value,STATUS_PTR)
+#endif
+
+#endif
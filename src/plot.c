@@ -225,6 +225,7 @@ f     - Title: The Plot title drawn using AST_GRID
 *  Authors:
 *     DSB: D.S. Berry (Starlink)
 *     RFWS: R.F. Warren-Smith (Starlink)
+*     AGT: Agent
 
 *  History:
 *     18-SEP-1996 (DSB):
@@ -735,6 +736,10 @@ f     - Title: The Plot title drawn using AST_GRID
 *        has been set. Previously, the set value was used without change
 *        if Format was set, but this caused things like 5 minor gaps
 *        between major tick values 40 and 44.
+*     18-OCT-2026 (AGT):
+*        Use astAttribKnown to pass attributes defined by parent classes
+*        directly to the parent GetAttrib, SetAttrib, TestAttrib and
+*        ClearAttrib methods.
 
 *class--
 */
@@ -1720,6 +1725,19 @@ static const char *xlbling[2] = { "exterior", "interior" };
 /* Text values used to represent TextGapType externally. */
 static const char *xtgaptype[2] = { "box", "plot" };
 
+/* The names of all the attributes defined by this class, in alphabetical
+   order (see astAttribKnown). */
+static const char *const attrib_names[] = {
+   "abbrev", "border", "centre", "clip", "clipop", "color", "colour",
+   "drawaxes", "drawtitle", "edge", "escape", "font", "forceexterior",
+   "gap", "grf", "grid", "invisible", "labelat", "labelling", "labelunits",
+   "labelup", "loggap", "loglabel", "logplot", "logticks", "majticklen",
+   "mintick", "minticklen", "numlab", "numlabgap", "size", "style",
+   "textgaptype", "textlab", "textlabgap", "tickall", "titlegap", "tol",
+   "width"
+};
+#define NATTRIB ( (int) ( sizeof( attrib_names )/sizeof( attrib_names[ 0 ] ) ) )
+
 /* Define macros for accessing each item of thread specific global data. */
 #ifdef THREAD_SAFE
 
@@ -6555,9 +6573,18 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
 
 /* Check the attribute name and clear the appropriate attribute. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+/* Look for the attribute name in the table of Plot attribute names
+   first, so that attributes defined by parent classes are passed on to
+   the parent method without being compared with each Plot attribute in
+   turn. */
+   if( !astAttribKnown( attrib, attrib_names, NATTRIB ) ) {
+      (*parent_clearattrib)( this_object, attrib, status );
+
 /* Edge(axis). */
 /* ------------ */
-   if ( nc = 0,
+   } else if ( nc = 0,
                ( 1 == astSscanf( attrib, "edge(%d)%n", &axis, &nc ) )
                && ( nc >= len ) ) {
       astClearEdge( this, axis - 1 );
@@ -15590,9 +15617,14 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    the value into "getattrib_buff" as a null terminated string in an appropriate
    format.  Set "result" to point at the result string. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+   if( !astAttribKnown( attrib, attrib_names, NATTRIB ) ) {
+      result = (*parent_getattrib)( this_object, attrib, status );
+
 /* Tol. */
 /* ---- */
-   if ( !strcmp( attrib, "tol" ) ) {
+   } else if ( !strcmp( attrib, "tol" ) ) {
       dval = astGetTol( this );
       if ( astOK ) {
          (void) sprintf( getattrib_buff, "%.*g", AST__DBL_DIG, dval );
@@ -24976,9 +25008,14 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
    in "nc" to check that the entire string was matched. Once a value
    has been obtained, use the appropriate method to set it. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+   if( !astAttribKnown( setting, attrib_names, NATTRIB ) ) {
+      (*parent_setattrib)( this_object, setting, status );
+
 /* Tol. */
 /* ---- */
-   if ( nc = 0,
+   } else if ( nc = 0,
         ( 1 == astSscanf( setting, "tol= %lg %n", &dval, &nc ) )
         && ( nc >= len ) ) {
       astSetTol( this, dval );
@@ -25936,9 +25973,14 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
 
 /* Check the attribute name and test the appropriate attribute. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+   if( !astAttribKnown( attrib, attrib_names, NATTRIB ) ) {
+      result = (*parent_testattrib)( this_object, attrib, status );
+
 /* Tol. */
 /* ---- */
-   if ( !strcmp( attrib, "tol" ) ) {
+   } else if ( !strcmp( attrib, "tol" ) ) {
       result = astTestTol( this );
 
 /* Edge(axis). */
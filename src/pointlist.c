@@ -53,6 +53,7 @@ f     The PointList class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     22-MAR-2004 (DSB):
@@ -72,15 +73,20 @@ f     The PointList class does not define any new routines beyond those
 *        Move methods astGetEnclosure and astSetEnclosure to Region class.
 *     8-JUL-2009 (DSB):
 *        In Transform, use "ptr2", not "ptr", if we are creating a mask.
+*     18-OCT-2026 (AGT):
+*        - Override the astRegPointsIn and astRegFixedMesh methods.
+*        - Use a lazily created KD-tree index of the PointList positions
+*        to speed up Transform and astRegPointsIn when the base Frame is a
+*        simple Frame. Override astResetCache to free the index.
+*        - Override astManageLock to create the index before the
+*        PointList is frozen.
 *class--
 
 *  Implementation Deficiencies:
-*     - Use of simple arrays to hold lists  of points is probably not
-*     efficient for large numbers of points. For instance, use of k-tree
-*     structures instead of arrays could result in a much  more efficient
-*     implementation of the Transform function. Maybe the PointSet class
-*     should be extended to provide a k-tree representation as well as a
-*     simple array.
+*     - The KD-tree index used to speed up the Transform function is only
+*     used if the base Frame is a simple Cartesian Frame. PointLists
+*     defined within SkyFrames, etc, still test each point in the list in
+*     turn.
 
 */
 
@@ -91,6 +97,14 @@ f     The PointList class does not define any new routines beyond those
    "protected" symbols available. */
 #define astCLASS PointList
 
+/* Parameters of the KD-tree index of PointList positions: the maximum
+   number of positions in a leaf of the tree, the minimum number of
+   positions in a PointList for which the index is used, and the number
+   of shifted test points tested in each call to astRegPointsIn. */
+#define KD_LEAF 8
+#define KD_MINPOINTS 8
+#define KD_NPAIR 4096
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -139,6 +153,11 @@ static size_t (* parent_getobjsize)( AstObject *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
+static void (* parent_resetcache)( AstRegion *, int * );
+
+#if defined(THREAD_SAFE)
+static int (* parent_managelock)( AstObject *, int, int, AstObject **, int * );
+#endif
 
 
 #ifdef THREAD_SAFE
@@ -199,9 +218,19 @@ static AstPointSet *Transform( AstMapping *, AstPointSet *, int, AstPointSet *,
 static AstRegion *RegBasePick( AstRegion *, int, const int *, int * );
 static int GetClosed( AstRegion *, int * );
 static int GetListSize( AstPointList *, int * );
+static int GoodPoint( double **, int, int );
+static int IndexPointsIn( AstPointList *, AstPointSet *, AstRegion *, unsigned char *, int * );
 static size_t GetObjSize( AstObject *, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
+static void BuildIndex( AstPointList *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
+static void FreeIndex( AstPointList *, int * );
+static void KdSearch( AstPointList *, int, int, int, const double *, const double *, int **, int *, int * );
+static void KdSplit( int *, unsigned char *, int, int, int, double ** );
+static void ResetCache( AstRegion *, int * );
+static void TestPairs( AstRegion *, AstPointSet *, int, const AstDim *, unsigned char *, unsigned char *, int * );
 static void PointListPoints( AstPointList *, AstPointSet **, int *);
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
@@ -209,6 +238,10 @@ static void RegBaseBox( AstRegion *, double *, double *, int * );
 static AstRegion *MergePointList( AstPointList *, AstRegion *, int, int * );
 static int MapMerge( AstMapping *, int, int, int *, AstMapping ***, int **, int * );
 
+#if defined(THREAD_SAFE)
+static int ManageLock( AstObject *, int, int, AstObject **, int * );
+#endif
+
 static const char *GetAttrib( AstObject *, const char *, int * );
 static int TestAttrib( AstObject *, const char *, int * );
 static void ClearAttrib( AstObject *, const char *, int * );
@@ -218,6 +251,96 @@ static void SetAttrib( AstObject *, const char *, int * );
 /* Member functions. */
 /* ================= */
 
+static void BuildIndex( AstPointList *this, int *status ){
+/*
+*  Name:
+*     BuildIndex
+
+*  Purpose:
+*     Create a KD-tree index for the positions in a PointList.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void BuildIndex( AstPointList *this, int *status )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function creates a KD-tree holding the good base Frame
+*     positions in the supplied PointList, and stores it in the PointList
+*     structure. Any existing index is first freed.
+*
+*     The tree is stored implicitly in three arrays. Each node in the tree
+*     corresponds to a contiguous range of elements within these arrays.
+*     The node position is the element at the middle of the range, and the
+*     positions at lower and higher indices within the range form the left
+*     and right sub-trees, having axis values less than or equal to (left)
+*     or greater than or equal to (right) the node position on the node's
+*     split axis. Ranges containing no more than KD_LEAF positions are not
+*     subdivided any further. The axis values are stored in tree order,
+*     with all the values for a position being adjacent, so that searches
+*     of the tree access memory in a roughly sequential manner.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   double **ptr;                 /* Pointers to PointList axis values */
+   int coord;                    /* Axis index */
+   int i;                        /* Index of position within tree */
+   int ipoint;                   /* Index of position within PointList */
+   int ncoord;                   /* No. of axes */
+   int npoint;                   /* No. of positions in PointList */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Free any existing index. */
+   FreeIndex( this, status );
+
+/* Get the base Frame positions. */
+   npoint = astGetNpoint( ((AstRegion *) this)->points );
+   ncoord = astGetNcoord( ((AstRegion *) this)->points );
+   ptr = astGetPoints( ((AstRegion *) this)->points );
+
+/* Allocate the index arrays. */
+   this->kdindex = astMalloc( sizeof( int )*(size_t) npoint );
+   this->kdaxis = astMalloc( sizeof( unsigned char )*(size_t) npoint );
+   this->kdpoints = astMalloc( sizeof( double )*(size_t) npoint*(size_t) ncoord );
+   if( astOK ) {
+
+/* Store the indices of the positions that have good values on every
+   axis. Positions with any bad axis value cannot be inside the PointList,
+   and so are excluded from the tree. */
+      this->kdnp = 0;
+      for( ipoint = 0; ipoint < npoint; ipoint++ ) {
+         if( GoodPoint( ptr, ncoord, ipoint ) ) this->kdindex[ this->kdnp++ ] = ipoint;
+      }
+
+/* Sort the indices into tree order. */
+      KdSplit( this->kdindex, this->kdaxis, 0, this->kdnp, ncoord, ptr );
+
+/* Copy the axis values into the tree, in tree order. */
+      for( i = 0; i < this->kdnp; i++ ) {
+         for( coord = 0; coord < ncoord; coord++ ) {
+            this->kdpoints[ i*ncoord + coord ] = ptr[ coord ][ this->kdindex[ i ] ];
+         }
+      }
+   }
+
+/* Free the index if anything went wrong. */
+   if( !astOK ) FreeIndex( this, status );
+}
+
 static void ClearAttrib( AstObject *this_object, const char *attrib,
                          int *status ) {
 /*
@@ -278,6 +401,46 @@ static void ClearAttrib( AstObject *this_object, const char *attrib,
    }
 }
 
+static void FreeIndex( AstPointList *this, int *status ){
+/*
+*  Name:
+*     FreeIndex
+
+*  Purpose:
+*     Free the KD-tree index for a PointList.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void FreeIndex( AstPointList *this, int *status )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function frees any KD-tree index stored in the supplied
+*     PointList (see BuildIndex). A new index will be created when it is
+*     next needed.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     This function attempts to execute even if the global error status is
+*     set.
+*/
+
+   this->kdindex = astFree( this->kdindex );
+   this->kdaxis = astFree( this->kdaxis );
+   this->kdpoints = astFree( this->kdpoints );
+   this->kdnp = 0;
+}
+
 static const char *GetAttrib( AstObject *this_object, const char *attrib,
                               int *status ) {
 /*
@@ -520,6 +683,9 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
 
    result += astGetObjSize( this->lbnd );
    result += astGetObjSize( this->ubnd );
+   result += astGetObjSize( this->kdindex );
+   result += astGetObjSize( this->kdaxis );
+   result += astGetObjSize( this->kdpoints );
 
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
@@ -528,6 +694,499 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
    return result;
 }
 
+static int GoodPoint( double **ptr, int ncoord, int point ){
+/*
+*  Name:
+*     GoodPoint
+
+*  Purpose:
+*     Check if a position has good values on all axes.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     int GoodPoint( double **ptr, int ncoord, int point )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function returns a flag indicating if the specified position
+*     within a set of axis values has a good value on every axis.
+
+*  Parameters:
+*     ptr
+*        Pointers to the axis values, as returned by astGetPoints.
+*     ncoord
+*        The number of axes.
+*     point
+*        The zero-based index of the position to check.
+
+*  Returned Value:
+*     Non-zero if all the axis values are good.
+
+*/
+
+/* Local Variables: */
+   int coord;                    /* Axis index */
+
+   for( coord = 0; coord < ncoord; coord++ ) {
+      if( ptr[ coord ][ point ] == AST__BAD ) return 0;
+   }
+   return 1;
+}
+
+static int IndexPointsIn( AstPointList *this, AstPointSet *in_base,
+                          AstRegion *unc, unsigned char *mask, int *status ){
+/*
+*  Name:
+*     IndexPointsIn
+
+*  Purpose:
+*     Use the KD-tree index to find the points inside a PointList.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     int IndexPointsIn( AstPointList *this, AstPointSet *in_base,
+*                        AstRegion *unc, unsigned char *mask, int *status )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function sets a bit in the supplied packed bit mask for each
+*     supplied base Frame position that is inside the un-negated
+*     uncertainty Region when it is centred on any of the positions in the
+*     PointList. The Negated attribute of the PointList itself is ignored.
+*
+*     The KD-tree index of the PointList (created if necessary) is used to
+*     find the PointList positions that may be close enough to each test
+*     point, using the bounding box of the uncertainty Region. In a
+*     Cartesian Frame, testing a point against the uncertainty Region
+*     centred on a PointList position is equivalent to testing a suitably
+*     shifted point against the uncertainty Region at its original centre.
+*     So shifted copies of the test point are created for each candidate
+*     PointList position, and all such copies are tested in bulk using
+*     astRegPointsIn, without needing to re-centre the uncertainty Region.
+*
+*     This can only be done if the base Frame of the PointList and the
+*     base Frame of the uncertainty Region are both simple Frames (i.e.
+*     not SkyFrames, etc), connected by a unit Mapping, and if the
+*     uncertainty Region is bounded. If these conditions are not met,
+*     or the PointList is very small, zero is returned without action and
+*     the caller should test each PointList position in turn instead.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     in_base
+*        Pointer to the PointSet holding the positions to be tested, in
+*        the base Frame of the PointList.
+*     unc
+*        Pointer to the un-negated base Frame uncertainty Region, as
+*        returned by astGetUncFrm. It should be centred at its original
+*        position.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn. Not changed if zero is returned.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the mask was formed using the index, and zero otherwise.
+
+*/
+
+/* Local Variables: */
+   AstDim *ptest;                /* Test point index for each pair */
+   AstDim npoint;                /* No. of supplied test points */
+   AstDim point;                 /* Loop counter for test points */
+   AstFrame *frm;                /* Pointer to a base Frame */
+   AstMapping *map;              /* Base->current Mapping in "unc" */
+   AstMapping *smap;             /* Simplified Mapping */
+   AstPointSet *ps_pair;         /* Shifted test points */
+   AstRegion *this_region;       /* Pointer to Region structure */
+   double **ptr_in;              /* Pointers to test point axis values */
+   double **ptr_pair;            /* Pointers to shifted test point axis values */
+   double *cen;                  /* Original centre of uncertainty Region */
+   double *dhi;                  /* Upper offsets of unc bounding box */
+   double *dlo;                  /* Lower offsets of unc bounding box */
+   double *lbnd;                 /* Lower bounds of unc bounding box */
+   double *qhi;                  /* Upper bounds of tree search box */
+   double *qlo;                  /* Lower bounds of tree search box */
+   double *ubnd;                 /* Upper bounds of unc bounding box */
+   double margin;                /* Safety margin for bounding box */
+   double *pos;                  /* Pointer to axis values in tree */
+   int *cand;                    /* Candidate tree elements */
+   int coord;                    /* Axis index */
+   int i;                        /* Candidate index */
+   int ncand;                    /* No. of candidate tree elements */
+   int ncoord;                   /* No. of axes */
+   int npair;                    /* No. of pairs in "ps_pair" */
+   int result;                   /* Returned value */
+   unsigned char *pmask;         /* Mask for the shifted test points */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get a pointer to the Region structure. */
+   this_region = (AstRegion *) this;
+
+/* Check the index is usable, and worth using. */
+   if( astGetNpoint( this_region->points ) < KD_MINPOINTS ) return result;
+
+   frm = astGetFrame( this_region->frameset, AST__BASE );
+   result = !strcmp( astGetClass( frm ), "Frame" );
+   frm = astAnnul( frm );
+
+   if( result ) {
+      frm = astGetFrame( unc->frameset, AST__BASE );
+      result = !strcmp( astGetClass( frm ), "Frame" );
+      frm = astAnnul( frm );
+   }
+
+   if( result ) {
+      map = astGetMapping( unc->frameset, AST__BASE, AST__CURRENT );
+      smap = astSimplify( map );
+      result = astIsAUnitMap( smap );
+      map = astAnnul( map );
+      smap = astAnnul( smap );
+   }
+
+   if( result ) result = astGetBounded( unc );
+   if( !astOK || !result ) return 0;
+
+/* Get the bounding box of the uncertainty Region, and its centre, and
+   hence the offsets from the centre to the edges of the bounding box. A
+   small margin is added to ensure that no points on the edge of the
+   uncertainty Region are missed because of rounding errors. */
+   ncoord = astGetNcoord( in_base );
+   lbnd = astMalloc( sizeof( double )*(size_t) ncoord );
+   ubnd = astMalloc( sizeof( double )*(size_t) ncoord );
+   dlo = astMalloc( sizeof( double )*(size_t) ncoord );
+   dhi = astMalloc( sizeof( double )*(size_t) ncoord );
+   qlo = astMalloc( sizeof( double )*(size_t) ncoord );
+   qhi = astMalloc( sizeof( double )*(size_t) ncoord );
+   astGetRegionBounds( unc, lbnd, ubnd );
+   cen = astRegCentre( unc, NULL, NULL, 0, AST__BASE );
+   if( astOK ) {
+      for( coord = 0; coord < ncoord; coord++ ) {
+         if( lbnd[ coord ] == AST__BAD || ubnd[ coord ] == AST__BAD ||
+             cen[ coord ] == AST__BAD || !astISFINITE( lbnd[ coord ] ) ||
+             !astISFINITE( ubnd[ coord ] ) ) {
+            result = 0;
+            break;
+         }
+         margin = 1.0E-6*( ubnd[ coord ] - lbnd[ coord ] ) +
+                  DBL_EPSILON*fabs( cen[ coord ] );
+         dlo[ coord ] = lbnd[ coord ] - cen[ coord ] - margin;
+         dhi[ coord ] = ubnd[ coord ] - cen[ coord ] + margin;
+      }
+   }
+
+/* Create the index if it does not already exist. */
+   if( result && !this->kdindex ) BuildIndex( this, status );
+
+/* Create a PointSet to hold shifted test points, an array to hold the
+   index of the test point associated with each shifted point, and a mask
+   for the shifted points. Also create work space for the list of
+   candidate PointList positions close to each test point. */
+   if( result && astOK ) {
+      ps_pair = astPointSet( KD_NPAIR, ncoord, "", status );
+      ptr_pair = astGetPoints( ps_pair );
+      ptest = astMalloc( sizeof( AstDim )*KD_NPAIR );
+      pmask = astMalloc( ( KD_NPAIR + 7 )/8 );
+      cand = NULL;
+
+      npoint = astGetNpoint( in_base );
+      ptr_in = astGetPoints( in_base );
+      memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+      npair = 0;
+
+/* Loop round each test point that has good axis values. */
+      for( point = 0; point < npoint && astOK; point++ ) {
+         for( coord = 0; coord < ncoord; coord++ ) {
+            if( ptr_in[ coord ][ point ] == AST__BAD ) break;
+            qlo[ coord ] = ptr_in[ coord ][ point ] - dhi[ coord ];
+            qhi[ coord ] = ptr_in[ coord ][ point ] - dlo[ coord ];
+         }
+         if( coord < ncoord ) continue;
+
+/* Find the PointList positions at which the re-centred uncertainty
+   Region could possibly include the test point. */
+         ncand = 0;
+         KdSearch( this, 0, this->kdnp, ncoord, qlo, qhi, &cand, &ncand,
+                   status );
+
+/* For each one, store the test point shifted so that its position
+   relative to the original centre of the uncertainty Region is the same
+   as its position relative to the PointList position. */
+         for( i = 0; i < ncand && astOK; i++ ) {
+            pos = this->kdpoints + cand[ i ]*ncoord;
+            for( coord = 0; coord < ncoord; coord++ ) {
+               ptr_pair[ coord ][ npair ] = ptr_in[ coord ][ point ] -
+                                            pos[ coord ] + cen[ coord ];
+            }
+            ptest[ npair++ ] = point;
+
+/* When the PointSet is full, test the shifted points. */
+            if( npair == KD_NPAIR ) {
+               TestPairs( unc, ps_pair, npair, ptest, pmask, mask, status );
+               npair = 0;
+            }
+         }
+      }
+
+/* Test any remaining shifted points. */
+      if( npair > 0 ) TestPairs( unc, ps_pair, npair, ptest, pmask, mask, status );
+
+/* Free resources. */
+      ps_pair = astAnnul( ps_pair );
+      ptest = astFree( ptest );
+      pmask = astFree( pmask );
+      cand = astFree( cand );
+   }
+
+   lbnd = astFree( lbnd );
+   ubnd = astFree( ubnd );
+   dlo = astFree( dlo );
+   dhi = astFree( dhi );
+   qlo = astFree( qlo );
+   qhi = astFree( qhi );
+   cen = astFree( cen );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static void KdSearch( AstPointList *this, int lo, int hi, int ncoord,
+                      const double *qlo, const double *qhi, int **cand,
+                      int *ncand, int *status ){
+/*
+*  Name:
+*     KdSearch
+
+*  Purpose:
+*     Find the indexed PointList positions within a box.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void KdSearch( AstPointList *this, int lo, int hi, int ncoord,
+*                    const double *qlo, const double *qhi, int **cand,
+*                    int *ncand, int *status )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function searches the sub-tree of the KD-tree index held in the
+*     supplied PointList that covers tree elements "lo" to "hi-1", and
+*     appends to the supplied list the index of every tree element that
+*     falls within the supplied box (including its edges). It calls itself
+*     recursively to search lower levels of the tree.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     lo
+*        The first tree element in the sub-tree.
+*     hi
+*        One more than the last tree element in the sub-tree.
+*     ncoord
+*        The number of axes.
+*     qlo
+*        The lower axis bounds of the box.
+*     qhi
+*        The upper axis bounds of the box.
+*     cand
+*        Address of a pointer to the dynamically allocated list of tree
+*        element indices. Extended as necessary.
+*     ncand
+*        Address of the number of elements used in "*cand".
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   double *pos;                  /* Pointer to axis values for a position */
+   double val;                   /* Node value on the split axis */
+   int axis;                     /* Split axis */
+   int coord;                    /* Axis index */
+   int i;                        /* Tree element index */
+   int mid;                      /* Node element index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Leaf ranges are checked exhaustively. Otherwise check the node
+   position itself, and search whichever sub-trees may overlap the box. */
+   while( hi > lo ) {
+      if( hi - lo <= KD_LEAF ) {
+         mid = hi;
+         i = lo;
+      } else {
+         mid = ( lo + hi )/2;
+         i = mid;
+      }
+
+      for( ; i < hi && i <= mid; i++ ) {
+         pos = this->kdpoints + i*ncoord;
+         for( coord = 0; coord < ncoord; coord++ ) {
+            if( pos[ coord ] < qlo[ coord ] || pos[ coord ] > qhi[ coord ] ) break;
+         }
+         if( coord == ncoord ) {
+            *cand = astGrow( *cand, *ncand + 1, sizeof( int ) );
+            if( !astOK ) return;
+            (*cand)[ (*ncand)++ ] = i;
+         }
+      }
+      if( mid == hi ) break;
+
+/* Search the left sub-tree recursively, and the right sub-tree by
+   iteration. */
+      axis = this->kdaxis[ mid ];
+      val = this->kdpoints[ mid*ncoord + axis ];
+      if( qlo[ axis ] <= val ) {
+         KdSearch( this, lo, mid, ncoord, qlo, qhi, cand, ncand, status );
+      }
+      if( qhi[ axis ] >= val ) {
+         lo = mid + 1;
+      } else {
+         break;
+      }
+   }
+}
+
+static void KdSplit( int *index, unsigned char *axis, int lo, int hi,
+                     int ncoord, double **ptr ){
+/*
+*  Name:
+*     KdSplit
+
+*  Purpose:
+*     Sort a range of positions into KD-tree order.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void KdSplit( int *index, unsigned char *axis, int lo, int hi,
+*                   int ncoord, double **ptr )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function re-orders elements "lo" to "hi-1" of the supplied
+*     array of position indices to form a KD-tree (see BuildIndex). The
+*     split axis for each node is the axis with the largest spread of
+*     values within the node's range, and the node position is the median
+*     position along that axis. It calls itself recursively to form
+*     the lower levels of the tree.
+
+*  Parameters:
+*     index
+*        The array of position indices.
+*     axis
+*        The array in which to store the split axis for each node.
+*     lo
+*        The first element in the range.
+*     hi
+*        One more than the last element in the range.
+*     ncoord
+*        The number of axes.
+*     ptr
+*        Pointers to the axis values for each position.
+
+*/
+
+/* Local Variables: */
+   double *v;                    /* Pointer to values on the split axis */
+   double pivot;                 /* Partition value */
+   double range;                 /* Spread of values on an axis */
+   double rmax;                  /* Largest spread */
+   double vhi;                   /* Largest value on an axis */
+   double vlo;                   /* Smallest value on an axis */
+   int a;                        /* Split axis */
+   int coord;                    /* Axis index */
+   int i;                        /* Element index */
+   int j;                        /* Element index */
+   int l;                        /* Start of range being partitioned */
+   int mid;                      /* Node element index */
+   int r;                        /* End of range being partitioned */
+   int t;                        /* Temporary storage for swapping */
+
+   while( hi - lo > KD_LEAF ) {
+
+/* Find the axis with the largest spread of values. */
+      a = 0;
+      rmax = -1.0;
+      for( coord = 0; coord < ncoord; coord++ ) {
+         vlo = vhi = ptr[ coord ][ index[ lo ] ];
+         for( i = lo + 1; i < hi; i++ ) {
+            if( ptr[ coord ][ index[ i ] ] < vlo ) {
+               vlo = ptr[ coord ][ index[ i ] ];
+            } else if( ptr[ coord ][ index[ i ] ] > vhi ) {
+               vhi = ptr[ coord ][ index[ i ] ];
+            }
+         }
+         range = vhi - vlo;
+         if( range > rmax ) {
+            rmax = range;
+            a = coord;
+         }
+      }
+
+/* Partially sort the range (using Hoare's selection algorithm) so that
+   the median value on the split axis is at the middle, with no larger
+   values before it and no smaller values after it. */
+      mid = ( lo + hi )/2;
+      v = ptr[ a ];
+      l = lo;
+      r = hi - 1;
+      while( l < r ) {
+         pivot = v[ index[ mid ] ];
+         i = l;
+         j = r;
+         do {
+            while( v[ index[ i ] ] < pivot ) i++;
+            while( pivot < v[ index[ j ] ] ) j--;
+            if( i <= j ) {
+               t = index[ i ];
+               index[ i ] = index[ j ];
+               index[ j ] = t;
+               i++;
+               j--;
+            }
+         } while( i <= j );
+         if( j < mid ) l = i;
+         if( mid < i ) r = j;
+      }
+      axis[ mid ] = (unsigned char) a;
+
+/* Form the left sub-tree recursively, and the right sub-tree by
+   iteration. */
+      KdSplit( index, axis, lo, mid, ncoord, ptr );
+      lo = mid + 1;
+   }
+}
+
 void astInitPointListVtab_(  AstPointListVtab *vtab, const char *name,
                              int *status ) {
 /*
@@ -616,6 +1275,11 @@ void astInitPointListVtab_(  AstPointListVtab *vtab, const char *name,
    parent_testattrib = object->TestAttrib;
    object->TestAttrib = TestAttrib;
 
+#if defined(THREAD_SAFE)
+   parent_managelock = object->ManageLock;
+   object->ManageLock = ManageLock;
+#endif
+
    parent_transform = mapping->Transform;
    mapping->Transform = Transform;
 
@@ -627,9 +1291,14 @@ void astInitPointListVtab_(  AstPointListVtab *vtab, const char *name,
    mapping->MapMerge = MapMerge;
 
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegBaseBox = RegBaseBox;
    region->RegBasePick = RegBasePick;
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
+
+   parent_resetcache = region->ResetCache;
+   region->ResetCache = ResetCache;
    region->GetClosed = GetClosed;
    region->MaskB = MaskB;
    region->MaskD = MaskD;
@@ -966,6 +1635,92 @@ MAKE_MASK(UB,unsigned char)
 /* Undefine the macro. */
 #undef MAKE_MASK
 
+#if defined(THREAD_SAFE)
+static int ManageLock( AstObject *this_object, int mode, int extra,
+                       AstObject **fail, int *status ) {
+/*
+*  Name:
+*     ManageLock
+
+*  Purpose:
+*     Manage the thread lock on an Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "object.h"
+*     AstObject *ManageLock( AstObject *this, int mode, int extra,
+*                            AstObject **fail, int *status )
+
+*  Class Membership:
+*     PointList member function (over-rides the astManageLock protected
+*     method inherited from the parent class).
+
+*  Description:
+*     This function manages the thread lock on the supplied Object. The
+*     lock can be locked, unlocked or checked by this function as
+*     deteremined by parameter "mode". See astLock for details of the way
+*     these locks are used.
+*
+*     If the PointList is being frozen, the KD-tree index of the PointList
+*     positions is first created if it does not already exist, since a
+*     frozen PointList cannot be changed.
+
+*  Parameters:
+*     this
+*        Pointer to the Object.
+*     mode
+*        An integer flag indicating what the function should do. See
+*        the Object class implementation of this method.
+*     extra
+*        Extra mode-specific information.
+*     fail
+*        If a non-zero function value is returned, a pointer to the
+*        Object that caused the failure is returned at "*fail". This may
+*        be "this" or it may be an Object contained within "this". Note,
+*        the Object's reference count is not incremented, and so the
+*        returned pointer should not be annulled. A NULL pointer is
+*        returned if this function returns a value of zero.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*    A local status value:
+*        0 - Success
+*        1 - Could not lock or unlock the object because it was already
+*            locked by another thread.
+*        2 - Failed to lock a POSIX mutex
+*        3 - Failed to unlock a POSIX mutex
+*        4 - Bad "mode" value supplied.
+
+*  Notes:
+*     - This function attempts to execute even if an error has already
+*     occurred.
+*/
+
+/* Local Variables: */
+   AstPointList *this;    /* Pointer to PointList structure */
+
+/* Check the supplied pointer is not NULL. */
+   if( !this_object ) return 0;
+
+/* Obtain a pointers to the PointList structure. */
+   this = (AstPointList *) this_object;
+
+/* If the PointList is about to be frozen, create the index if it would
+   be used. */
+   if( mode == AST__FREEZE && !this_object->frozen && astOK &&
+       !this->kdindex &&
+       astGetNpoint( ((AstRegion *) this)->points ) >= KD_MINPOINTS ) {
+      BuildIndex( this, status );
+   }
+
+/* Invoke the ManageLock method inherited from the parent class. */
+   return (*parent_managelock)( this_object, mode, extra, fail, status );
+}
+#endif
+
 static int MapMerge( AstMapping *this, int where, int series, int *nmap,
                      AstMapping ***map_list, int **invert_list, int *status ) {
 /*
@@ -1862,6 +2617,44 @@ static AstRegion *RegBasePick( AstRegion *this_region, int naxes,
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     PointList member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh cached in the PointList is just the list of base Frame
+*     positions, and so can be retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -2155,6 +2948,226 @@ static void SetAttrib( AstObject *this_object, const char *setting,
 #undef MATCH
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a PointList.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     PointList member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the PointList (i.e. within the uncertainty Region
+*     centred on any of the positions in the PointList), and sets the
+*     corresponding bit in the supplied packed bit mask. The uncertainty
+*     Region is re-centred on each PointList position in turn and its
+*     astRegPointsIn method used to test the supplied points, the
+*     resulting masks being ORed together. No copies of the supplied
+*     PointSet are made.
+
+*  Parameters:
+*     this
+*        Pointer to the PointList.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the PointList.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the PointList.
+
+*/
+
+/* Local Variables: */
+   AstDim npoint;                /* No. of supplied input test points */
+   AstDim point;                 /* Loop counter for test points */
+   AstDim result;                /* Returned number of inside points */
+   AstPointSet *in_base;         /* Pointer to PointSet holding base Frame positions*/
+   AstPointSet *pset_base;       /* PointList positions in "unc" base Frame */
+   AstPointSet *pset_reg;        /* Pointer to Region PointSet */
+   AstRegion *unc;               /* Pointer to uncertainty Region */
+   double **ptr_base;            /* Pointer to axis values for "pset_base" */
+   double **ptr_in;              /* Pointer to base Frame test positions */
+   double *cen_orig;             /* Pointer to array holding original centre coords */
+   int coord;                    /* Zero-based index for coordinates */
+   int good;                     /* Are all axis values good? */
+   int inside;                   /* Is the test point inside? */
+   int ncoord_base;              /* No. of coordinates per base Frame point */
+   int ncoord_unc;               /* No. of coordinates per "unc" base Frame point */
+   int neg;                      /* Has the PointList been negated? */
+   int nrp;                      /* No. of points in Region PointSet */
+   int rp;                       /* Loop counter for PointList positions */
+   size_t ibyte;                 /* Index of mask byte */
+   size_t nbyte;                 /* No. of bytes in the mask */
+   unsigned char *umask;         /* Mask for a single uncertainty Region */
+   unsigned char bit;            /* Mask bit for current test point */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet. The returned PointSet may be a clone of "pset",
+   but we do not modify it. */
+   in_base = astRegTransform( this_region, pset, 0, NULL, NULL );
+   npoint = astGetNpoint( in_base );
+   ncoord_base = astGetNcoord( in_base );
+   ptr_in = astGetPoints( in_base );
+   nbyte = ( (size_t) npoint + 7 )/8;
+
+/* Clear the returned mask, and allocate work space for the mask produced
+   by each re-centred uncertainty Region. */
+   memset( mask, 0, nbyte );
+   umask = astMalloc( nbyte );
+
+/* Get the axis values for the PointSet which defines the location and
+   extent of the region in the base Frame, and check them. */
+   pset_reg = this_region->points;
+   nrp = astGetNpoint( pset_reg );
+   if( astGetNcoord( pset_reg ) != ncoord_base && astOK ) {
+      astError( AST__INTER, "astRegPointsIn(PointList): Illegal number of "
+                "coords (%d) in the Region - should be %d "
+                "(internal AST programming error).", status, astGetNcoord( pset_reg ),
+                ncoord_base );
+   }
+
+/* Get the base Frame uncertainty Region. Temporarily ensure it is not
+   negated. */
+   unc = astGetUncFrm( this_region, AST__BASE );
+   astSetNegated( unc, 0 );
+
+/* Transform the PointList PointSet into the base Frame of the uncertainty
+   Region, and get pointers to the corresponding axis value. */
+   pset_base = astRegTransform( unc, pset_reg, 0, NULL, NULL );
+   ptr_base = astGetPoints( pset_base );
+   ncoord_unc = astGetNcoord( pset_base );
+
+   if ( astOK ) {
+
+/* If possible, use the KD-tree index of the PointList positions to find
+   the test points that are within any of the re-centred uncertainty
+   Regions. */
+      if( !IndexPointsIn( (AstPointList *) this_region, in_base, unc, mask,
+                          status ) ) {
+
+/* Otherwise, save the original base Frame centre coords of the
+   uncertainty Region. */
+         cen_orig = astRegCentre( unc, NULL, NULL, 0, AST__BASE );
+
+/* Loop round all the points in the PointList, centring the uncertainty
+   Region at each one in turn and accumulating the test points that fall
+   within any of them. Positions with any bad axis values are skipped. */
+         for ( rp = 0; rp < nrp && astOK; rp++ ) {
+            if( !GoodPoint( ptr_base, ncoord_unc, rp ) ) continue;
+            astRegCentre( unc, NULL, ptr_base, rp, AST__BASE );
+            if( astRegPointsIn( unc, in_base, umask ) > 0 ) {
+               for( ibyte = 0; ibyte < nbyte; ibyte++ ) mask[ ibyte ] |= umask[ ibyte ];
+            }
+         }
+
+/* Re-instate the original centre coords of the uncertainty Region. */
+         astRegCentre( unc, cen_orig, NULL, 0, AST__BASE );
+         cen_orig = astFree( cen_orig );
+      }
+
+/* If the PointList has been negated, invert the mask for all points that
+   have good axis values. Count the inside points. */
+      neg = astGetNegated( this_region );
+      for ( point = 0; point < npoint && astOK; point++ ) {
+         bit = (unsigned char)( 1 << ( point % 8 ) );
+         inside = ( mask[ point/8 ] & bit ) != 0;
+
+         if( neg ) {
+            good = 1;
+            for( coord = 0; coord < ncoord_base; coord++ ) {
+               if( ptr_in[ coord ][ point ] == AST__BAD ) {
+                  good = 0;
+                  break;
+               }
+            }
+            inside = good && !inside;
+            if( inside ) {
+               mask[ point/8 ] |= bit;
+            } else {
+               mask[ point/8 ] &= (unsigned char) ~bit;
+            }
+         }
+
+         if( inside ) result++;
+      }
+   }
+
+/* Clear the negated flag for the uncertainty Region. */
+   astClearNegated( unc );
+
+/* Free resources */
+   umask = astFree( umask );
+   in_base = astAnnul( in_base );
+   pset_base = astAnnul( pset_base );
+   unc = astAnnul( unc );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static void ResetCache( AstRegion *this, int *status ){
+/*
+*  Name:
+*     ResetCache
+
+*  Purpose:
+*     Clear cached information within the supplied Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void ResetCache( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Region member function (overrides the astResetCache method
+*     inherited from the parent Region class).
+
+*  Description:
+*     This function clears cached information from the supplied Region
+*     structure, including the KD-tree index of PointList positions.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+*/
+   if( this ) {
+      FreeIndex( (AstPointList *) this, status );
+      (*parent_resetcache)( this, status );
+   }
+}
+
 static AstMapping *Simplify( AstMapping *this_mapping, int *status ) {
 /*
 *  Name:
@@ -2353,6 +3366,72 @@ static int TestAttrib( AstObject *this_object, const char *attrib,
    return result;
 }
 
+static void TestPairs( AstRegion *unc, AstPointSet *ps_pair, int npair,
+                       const AstDim *ptest, unsigned char *pmask,
+                       unsigned char *mask, int *status ){
+/*
+*  Name:
+*     TestPairs
+
+*  Purpose:
+*     Test a set of shifted test points against an uncertainty Region.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "pointlist.h"
+*     void TestPairs( AstRegion *unc, AstPointSet *ps_pair, int npair,
+*                     const AstDim *ptest, unsigned char *pmask,
+*                     unsigned char *mask, int *status )
+
+*  Class Membership:
+*     PointList member function.
+
+*  Description:
+*     This function is used by IndexPointsIn to test the first "npair"
+*     shifted test points in the supplied PointSet against the
+*     uncertainty Region, and set the bit in the returned mask for the
+*     original test point associated with each shifted point that is
+*     inside the uncertainty Region.
+
+*  Parameters:
+*     unc
+*        Pointer to the uncertainty Region.
+*     ps_pair
+*        Pointer to the PointSet holding the shifted test points. The
+*        number of points in this PointSet is reduced to "npair" if it
+*        is larger.
+*     npair
+*        The number of shifted test points to test.
+*     ptest
+*        The index of the original test point for each shifted test point.
+*     pmask
+*        Work space for a packed bit mask with a bit for each shifted
+*        test point.
+*     mask
+*        The packed bit mask for the original test points.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   int ipair;                    /* Shifted test point index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+   if( astGetNpoint( ps_pair ) > npair ) astSetNpoint( ps_pair, npair );
+   if( astRegPointsIn( unc, ps_pair, pmask ) > 0 ) {
+      for( ipair = 0; ipair < npair; ipair++ ) {
+         if( pmask[ ipair/8 ] & ( 1 << ( ipair % 8 ) ) ) {
+            mask[ ptest[ ipair ]/8 ] |= (unsigned char)( 1 << ( ptest[ ipair ] % 8 ) );
+         }
+      }
+   }
+}
+
 static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -2430,9 +3509,13 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    int coord;                    /* Zero-based index for coordinates */
    int ncoord_base;              /* No. of coordinates per base Frame point */
    int ncoord_out;               /* No. of coordinates per output point */
+   int ncoord_unc;               /* No. of coordinates per "unc" base Frame point */
+   int inside;                   /* Is the test point inside the PointList? */
+   int neg;                      /* Has the PointList been negated? */
    int npoint;                   /* No. of supplied input test points */
    int nrp;                      /* No. of points in Region PointSet */
    int point;                    /* Loop counter for points */
+   unsigned char *inmask;        /* Packed mask of inside test points */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -2487,14 +3570,40 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
                 ncoord_base );
    }
 
-/* Get the base Frame uncertainty Region. Temporarily set its negated flag. */
+/* Get the base Frame uncertainty Region. */
    unc = astGetUncFrm( this, AST__BASE );
+
+/* If possible, use the KD-tree index of the PointList positions to find
+   the test points that are within any of the re-centred uncertainty
+   Regions, and set bad all output points that are outside the PointList
+   (taking account of negation). */
+   inmask = astMalloc( ( (size_t) npoint + 7 )/8 );
+   if( IndexPointsIn( (AstPointList *) this, in_base, unc, inmask, status ) ) {
+      neg = astGetNegated( this );
+      for ( point = 0; point < npoint; point++ ) {
+         inside = ( inmask[ point/8 ] & ( 1 << ( point % 8 ) ) ) != 0;
+         if( inside == neg ) {
+            for( coord = 0; coord < ncoord_out; coord++ ) {
+               ptr_out[ coord ][ point ] = AST__BAD;
+            }
+         }
+      }
+      inmask = astFree( inmask );
+      in_base = astAnnul( in_base );
+      unc = astAnnul( unc );
+      if( !astOK ) result = astAnnul( result );
+      return result;
+   }
+   inmask = astFree( inmask );
+
+/* Otherwise, temporarily set the negated flag of the uncertainty Region. */
    astSetNegated( unc, 1 );
 
 /* Transform the PointList PointSet into the base Frame of the uncertainty
    Region, and get pointers to the corresponding axis value. */
    pset_base = astRegTransform( unc, pset_reg, 0, NULL, NULL );
    ptr_base = astGetPoints( pset_base );
+   ncoord_unc = astGetNcoord( pset_base );
 
 /* Perform coordinate arithmetic. */
 /* ------------------------------ */
@@ -2510,8 +3619,10 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
       ps1 = astClone( in_base );
       ps2 = NULL;
 
-/* Loop round all the points in the PointList. */
+/* Loop round all the points in the PointList, skipping any that have
+   bad axis values. */
       for ( point = 0; point < nrp; point++ ) {
+         if( !GoodPoint( ptr_base, ncoord_unc, point ) ) continue;
 
 /* Centre the uncertainty Region at this PointList position. Note, the
    base Frame of the PointList should be the same as the current Frame
@@ -2665,6 +3776,13 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->lbnd = NULL;
    out->ubnd = NULL;
 
+/* The KD-tree index is not copied. A new one will be created by the
+   output PointList if needed. */
+   out->kdnp = 0;
+   out->kdindex = NULL;
+   out->kdaxis = NULL;
+   out->kdpoints = NULL;
+
 /* Copy dynamic memory contents */
    if( in->lbnd && in->ubnd ) {
       nb = sizeof( double )*astGetNaxes( in );
@@ -2713,6 +3831,7 @@ static void Delete( AstObject *obj, int *status ) {
 /* Annul all resources. */
    this->lbnd = astFree( this->lbnd );
    this->ubnd = astFree( this->ubnd );
+   FreeIndex( this, status );
 }
 
 /* Dump function. */
@@ -3210,6 +4329,10 @@ AstPointList *astInitPointList_( void *mem, size_t size, int init,
 /* ------------------------------ */
          new->lbnd = NULL;
          new->ubnd = NULL;
+         new->kdnp = 0;
+         new->kdindex = NULL;
+         new->kdaxis = NULL;
+         new->kdpoints = NULL;
 
 /* If an error occurred, clean up by deleting the new PointList. */
          if ( !astOK ) new = astDelete( new );
@@ -3336,6 +4459,12 @@ AstPointList *astLoadPointList_( void *mem, size_t size, AstPointListVtab *vtab,
    this class into the internal "values list". */
       astReadClassData( channel, "PointList" );
 
+/* The KD-tree index is created when first needed. */
+      new->kdnp = 0;
+      new->kdindex = NULL;
+      new->kdaxis = NULL;
+      new->kdpoints = NULL;
+
 /* Now read each individual data item from this list and use it to
    initialise the appropriate instance variable(s) for this class. */
 
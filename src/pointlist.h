@@ -100,6 +100,10 @@ typedef struct AstPointList {
 /* Attributes specific to objects in this class. */
    double *lbnd;              /* Lower axis limits of bounding box */
    double *ubnd;              /* Upper axis limits of bounding box */
+   int kdnp;                  /* No. of positions in KD-tree index */
+   int *kdindex;              /* PointSet index of each KD-tree position */
+   unsigned char *kdaxis;     /* Split axis for each KD-tree node */
+   double *kdpoints;          /* KD-tree axis values, in tree order */
 } AstPointList;
 
 /* Virtual function table. */
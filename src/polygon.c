@@ -81,6 +81,7 @@ f     - AST_OUTLINE<X>: Create a Polygon outlining values in a pixel array
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     26-OCT-2004 (DSB):
@@ -128,6 +129,12 @@ f     - AST_OUTLINE<X>: Create a Polygon outlining values in a pixel array
 *        in the sky" (i.e. have widths larger than 180 degrees). 
 *        - Fix bug in GetBounded (Regions on SkyFrames are all bounded), that could 
 *        cause Polygons on the sky to be incorrectly negated.
+*     18-OCT-2026 (AGT):
+*        - Override the astRegPointsIn, astRegShape and astRegFixedMesh
+*        methods.
+*        - Use astRegParallel to share the testing of large numbers of
+*        points between several threads in astTransform and
+*        astRegPointsIn.
 *class--
 */
 
@@ -216,6 +223,19 @@ typedef struct Segment {
    struct Segment *prev;/* Pointer to previous Segment in a double link list */
 } Segment;
 
+/* A structure that describes a set of base Frame positions to be tested
+   by the TestPoints function, and the arrays in which to store the
+   results. */
+typedef struct PointsData {
+   double **ptr_in;     /* Pointers to input base Frame axis values */
+   double **ptr_out;    /* Pointers to output axis values (or NULL) */
+   int ncoord_out;      /* No. of output axes */
+   unsigned char *mask; /* Packed bit mask to receive results (or NULL) */
+   int nv;              /* No. of vertices in the Polygon */
+   int closed;          /* Is the boundary part of the Region? */
+   int neg;             /* Has the Region been negated? */
+} PointsData;
+
 
 /* Module Variables. */
 /* ================= */
@@ -449,7 +469,11 @@ static Segment *RemoveFromChain( Segment *, Segment *, int * );
 static double Polywidth( AstFrame *, AstLineDef **, int, int, double[ 2 ], int * );
 static int GetBounded( AstRegion *, int * );
 static int IntCmp( const void *, const void * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
+static AstDim TestPoints( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static int RegShape( AstRegion *, double[2], double[4], double **, int *, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static void Cache( AstPolygon *, int * );
 static void Copy( const AstObject *, AstObject *, int * );
@@ -2889,7 +2913,10 @@ void astInitPolygonVtab_(  AstPolygonVtab *vtab, const char *name, int *status )
    object->TestAttrib = TestAttrib;
 
    region->RegPins = RegPins;
+   region->RegPointsIn = RegPointsIn;
+   region->RegShape = RegShape;
    region->RegBaseMesh = RegBaseMesh;
+   region->RegFixedMesh = RegFixedMesh;
    region->RegBaseBox = RegBaseBox;
    region->RegTrace = RegTrace;
    region->GetBounded = GetBounded;
@@ -4527,6 +4554,44 @@ static AstPointSet *RegBaseMesh( AstRegion *this_region, int *status ){
    return result;
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*  Name:
+*     RegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     int RegFixedMesh( AstRegion *this, int *status )
+
+*  Class Membership:
+*     Polygon member function (over-rides the astRegFixedMesh protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns a non-zero value to indicate that the base
+*     Frame mesh cached in the Polygon is formed by offsetting along the
+*     edges within the base Frame, and so can be retained by astMapRegion.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     One.
+
+*/
+   return 1;
+}
+
 static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -4785,6 +4850,178 @@ static int RegPins( AstRegion *this_region, AstPointSet *pset, AstRegion *unc,
    return result;
 }
 
+static AstDim RegPointsIn( AstRegion *this_region, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*  Name:
+*     RegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a Polygon.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+*                         unsigned char *mask, int *status )
+
+*  Class Membership:
+*     Polygon member function (over-rides the astRegPointsIn protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Polygon, and sets the corresponding bit in the
+*     supplied packed bit mask. The tests are the same as those performed
+*     by the astTransform method, but no output PointSet is created.
+
+*  Parameters:
+*     this
+*        Pointer to the Polygon.
+*     pset
+*        Pointer to the PointSet holding the points to be tested, in the
+*        current Frame of the Polygon.
+*     mask
+*        Pointer to the array in which to return the packed bit mask.
+*        See astRegPointsIn.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of points that are inside the Polygon.
+
+*/
+
+/* Local Variables: */
+   AstDim npoint;                /* No. of input points */
+   AstDim result;                /* Returned number of inside points */
+   AstFrame *frm;                /* Pointer to base Frame in FrameSet */
+   AstPointSet *in_base;         /* PointSet holding base Frame input positions*/
+   PointsData pdata;             /* Description of the points to test */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Transform the supplied positions into the base Frame of the
+   encapsulated FrameSet. The returned PointSet will usually be a clone
+   of "pset" and so must not be modified. */
+   in_base = astRegTransform( this_region, pset, 0, NULL, &frm );
+   npoint = astGetNpoint( in_base );
+
+/* Clear the returned mask. */
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+/* Ensure cached information is available. This must be done before
+   testing any points, since the testing may be shared between several
+   threads. */
+   Cache( (AstPolygon *) this_region, status );
+
+/* Describe the points to be tested, and the mask to receive the results. */
+   pdata.ptr_in = astGetPoints( in_base );
+   pdata.ptr_out = NULL;
+   pdata.ncoord_out = 0;
+   pdata.mask = mask;
+   pdata.nv = astGetNpoint( this_region->points );
+   pdata.closed = astGetClosed( this_region );
+   pdata.neg = astGetNegated( this_region );
+
+/* Test the points, possibly using several threads. */
+   if( astOK ) result = astRegParallel( this_region, frm, npoint,
+                                        TestPoints, &pdata );
+
+/* Free resources */
+   in_base = astAnnul( in_base );
+   frm = astAnnul( frm );
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
+static int RegShape( AstRegion *this_region, double centre[2],
+                     double matrix[4], double **vert, int *nvert,
+                     int *status ){
+/*
+*  Name:
+*     RegShape
+
+*  Purpose:
+*     Return an analytic description of a Polygon.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     int RegShape( AstRegion *this, double centre[2], double matrix[4],
+*                   double **vert, int *nvert, int *status )
+
+*  Class Membership:
+*     Polygon member function (over-rides the astRegShape protected
+*     method inherited from the Region class).
+
+*  Description:
+*     This function returns the vertices of a bounded Polygon within the
+*     base Frame of the Polygon. See astRegShape for details.
+
+*  Parameters:
+*     this
+*        Pointer to the Polygon.
+*     centre
+*        Not used.
+*     matrix
+*        Not used.
+*     vert
+*        Returned holding a pointer to a newly allocated array holding the
+*        vertex coordinates.
+*     nvert
+*        Returned holding the number of vertices.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     AST__POLYSHAPE, or AST__NOSHAPE if the Polygon is unbounded (i.e.
+*     represents the outside of its boundary).
+
+*/
+
+/* Local Variables: */
+   double **ptr;             /* Pointers to vertex axis values */
+   int nv;                   /* Number of vertices */
+
+/* Initialise */
+   *vert = NULL;
+   *nvert = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return AST__NOSHAPE;
+
+/* Only bounded Polygons can be described. This takes account of both
+   the Negated attribute and the order in which the vertices are
+   stored. */
+   if( !astGetBounded( this_region ) ) return AST__NOSHAPE;
+
+/* Copy the vertices, which are stored in the parent Region structure. */
+   nv = astGetNpoint( this_region->points );
+   ptr = astGetPoints( this_region->points );
+   *vert = astMalloc( 2*nv*sizeof( double ) );
+   if( astOK ) {
+      memcpy( *vert, ptr[ 0 ], nv*sizeof( double ) );
+      memcpy( *vert + nv, ptr[ 1 ], nv*sizeof( double ) );
+      *nvert = nv;
+   }
+
+/* Return the result. */
+   return astOK ? AST__POLYSHAPE : AST__NOSHAPE;
+}
+
 static int RegTrace( AstRegion *this_region, int n, double *dist, double **ptr,
                      int *status ){
 /*
@@ -6102,6 +6339,192 @@ MAKEALL_TRACEEDGE(F,float)
 #undef MAKE_TRACEEDGE
 #undef MAKEALL_TRACEEDGE
 
+static AstDim TestPoints( AstRegion *this_region, AstFrame *frm,
+                          AstDim lo, AstDim hi, void *data, int *status ){
+/*
+*  Name:
+*     TestPoints
+
+*  Purpose:
+*     Test if each of a range of points is inside a Polygon.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "polygon.h"
+*     AstDim TestPoints( AstRegion *this, AstFrame *frm, AstDim lo,
+*                        AstDim hi, void *data, int *status )
+
+*  Class Membership:
+*     Polygon member function
+
+*  Description:
+*     This function tests each of a contiguous range of base Frame
+*     positions to see if it is inside the Polygon. A bit is set in the
+*     supplied mask for each inside position, and/or the corresponding
+*     output axis values are set bad for each outside position. It is
+*     used by the astTransform and astRegPointsIn methods via
+*     astRegParallel, and so may be invoked by a worker thread that does
+*     not have a lock on the Polygon. It therefore uses only the cached
+*     data in the Polygon structure, which must be up to date when this
+*     function is called, and invokes methods only on the supplied Frame.
+*     If the supplied Frame is not the Frame for which the cached edges
+*     were created (i.e. it is a copy of the base Frame made for a worker
+*     thread), private copies of the edges are made that refer to the
+*     supplied Frame.
+
+*  Parameters:
+*     this
+*        Pointer to the Polygon.
+*     frm
+*        Pointer to a Frame equivalent to the base Frame of the Polygon.
+*     lo
+*        Index of the first point to test.
+*     hi
+*        Index of the point following the last point to test.
+*     data
+*        Pointer to a PointsData structure describing the points to
+*        test and the arrays to receive the results.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of tested points that are inside the Polygon.
+
+*/
+
+/* Local Variables: */
+   AstDim point;                 /* Loop counter for input points */
+   AstDim result;                /* Returned number of inside points */
+   AstLineDef *a;                /* Line from inside point to test point */
+   AstLineDef *b;                /* Polygon edge */
+   AstLineDef **edges;           /* Polygon edges */
+   AstPolygon *this;             /* Pointer to Polygon */
+   PointsData *pdata;            /* Description of the points to test */
+   double *px;                   /* Pointer to array of first axis values */
+   double *py;                   /* Pointer to array of second axis values */
+   double p[ 2 ];                /* Current test position */
+   int i;                        /* Edge index */
+   int icoord;                   /* Coordinate index */
+   int in_region;                /* Is the point inside the Region? */
+   int ncross;                   /* Number of crossings */
+   int pos;                      /* Is test position in, on, or outside boundary? */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get pointers to the Polygon and the description of the points. */
+   this = (AstPolygon *) this_region;
+   pdata = (PointsData *) data;
+
+/* Each cached edge includes a pointer to the Frame in which it was
+   created, and can only be used with that Frame. If a different Frame
+   has been supplied, make copies of the edges that refer to the supplied
+   Frame. */
+   edges = this->edges;
+   if( pdata->nv > 0 && edges[ 0 ]->frame != frm ) {
+      edges = astCalloc( pdata->nv, sizeof( AstLineDef * ) );
+      for( i = 0; i < pdata->nv && astOK; i++ ) {
+         edges[ i ] = astStore( NULL, this->edges[ i ],
+                                astSizeOf( this->edges[ i ] ) );
+         if( astOK ) edges[ i ]->frame = frm;
+      }
+   }
+
+/* Loop round each supplied point in the base Frame of the polygon. */
+   px = pdata->ptr_in[ 0 ] + lo;
+   py = pdata->ptr_in[ 1 ] + lo;
+   for ( point = lo; point < hi && astOK; point++, px++, py++ ) {
+
+/* If the input point is bad, it is outside the Region. */
+      if( *px == AST__BAD || *py == AST__BAD ) {
+         in_region = 0;
+
+/* Otherwise, we first determine if the point is inside, outside, or on,
+   the Polygon boundary. Initialially it is unknown. */
+      } else {
+
+/* Create a definition of the line from a point which is inside the
+   polygon to the supplied point. This is a structure which includes
+   cached intermediate information which can be used to speed up
+   subsequent calculations. */
+         p[ 0 ] = *px;
+         p[ 1 ] = *py;
+         a = astLineDef( frm, this->in, p );
+
+/* We now determine the number of times this line crosses the polygon
+   boundary. Initialise the number of crossings to zero. */
+         ncross = 0;
+         pos = UNKNOWN;
+
+/* Loop rouind all edges of the polygon. */
+         for( i = 0; i < pdata->nv; i++ ) {
+            b = edges[ i ];
+
+/* If this point is on the current edge, then we need do no more checks
+   since we know it is either inside or outside the polygon (depending on
+   whether the polygon is closed or not). */
+            if( astLineContains( frm, b, 0, p ) ) {
+               pos = ON;
+               break;
+
+/* Otherwise, see if the two lines cross within their extent. If so,
+   increment the number of crossings. */
+            } else if( astLineCrossing( frm, b, a, NULL, NULL ) ) {
+               ncross++;
+            }
+         }
+
+/* Free resources */
+         a = astFree( a );
+
+/* If the position is not on the boundary, it is inside the boundary if
+   the number of crossings is even, and outside otherwise. */
+         if( pos == UNKNOWN ) pos = ( ncross % 2 == 0 )? IN : OUT;
+
+/* Whether the point is in the Region depends on whether the point is
+   inside the polygon boundary, whether the Polygon has been negated, and
+   whether the polygon is closed. */
+         if( pos == ON ) {
+            in_region = pdata->closed;
+         } else if( pdata->neg ) {
+            in_region = ( pos == OUT );
+         } else {
+            in_region = ( pos == IN );
+         }
+      }
+
+/* Record the result. */
+      if( in_region ) {
+         if( pdata->mask ) {
+            pdata->mask[ point/8 ] |= (unsigned char)( 1 << ( point % 8 ) );
+         }
+         result++;
+
+      } else if( pdata->ptr_out ) {
+         for ( icoord = 0; icoord < pdata->ncoord_out; icoord++ ) {
+            pdata->ptr_out[ icoord ][ point ] = AST__BAD;
+         }
+      }
+   }
+
+/* Free any copies of the edges. */
+   if( edges && edges != this->edges ) {
+      for( i = 0; i < pdata->nv; i++ ) edges[ i ] = astFree( edges[ i ] );
+      edges = astFree( edges );
+   }
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
                                int forward, AstPointSet *out, int *status ) {
 /*
@@ -6162,27 +6585,10 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
 
 /* Local Variables: */
    AstFrame *frm;                /* Pointer to base Frame in FrameSet */
-   AstLineDef *a;                /* Line from inside point to test point */
-   AstLineDef *b;                /* Polygon edge */
    AstPointSet *in_base;         /* PointSet holding base Frame input positions*/
    AstPointSet *result;          /* Pointer to output PointSet */
    AstPolygon *this;             /* Pointer to Polygon */
-   double **ptr_in;              /* Pointer to input base Frame coordinate data */
-   double **ptr_out;             /* Pointer to output current Frame coordinate data */
-   double *px;                   /* Pointer to array of first axis values */
-   double *py;                   /* Pointer to array of second axis values */
-   double p[ 2 ];                /* Current test position */
-   int closed;                   /* Is the boundary part of the Region? */
-   int i;                        /* Edge index */
-   int icoord;                   /* Coordinate index */
-   int in_region;                /* Is the point inside the Region? */
-   int ncoord_out;               /* No. of current Frame axes */
-   int ncross;                   /* Number of crossings */
-   int neg;                      /* Has the Region been negated? */
-   int npoint;                   /* No. of input points */
-   int nv;                       /* No. of vertices */
-   int point;                    /* Loop counter for input points */
-   int pos;                      /* Is test position in, on, or outside boundary? */
+   PointsData pdata;             /* Description of the points to test */
 
 /* Check the global error status. */
    if ( !astOK ) return NULL;
@@ -6196,16 +6602,6 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    containing a copy of the input PointSet. */
    result = (*parent_transform)( this_mapping, in, forward, out, status );
 
-/* Get the number of points to be transformed. */
-   npoint = astGetNpoint( result );
-
-/* Get a pointer to the output axis values. */
-   ptr_out = astGetPoints( result );
-
-/* Find the number of axes in the current Frame. This need not be 2 (the
-   number of axes in the *base* Frame must be 2 however). */
-   ncoord_out = astGetNcoord( result );
-
 /* We will now extend the parent astTransform method by performing the
    calculations needed to generate the output coordinate values. */
 
@@ -6217,111 +6613,27 @@ static AstPointSet *Transform( AstMapping *this_mapping, AstPointSet *in,
    clone of the "in" pointer, and so we must be carefull not to modify the
    contents of the returned PointSet. */
    in_base = astRegTransform( this, in, 0, NULL, &frm );
-   ptr_in = astGetPoints( in_base );
-
-/* Get the number of vertices in the polygon. */
-   nv = astGetNpoint( ((AstRegion *) this)->points );
-
-/* See if the boundary is part of the Region. */
-   closed = astGetClosed( this );
-
-/* See if the Region has been negated. */
-   neg = astGetNegated( this );
-
-/* Perform coordinate arithmetic. */
-/* ------------------------------ */
-   if ( astOK ) {
-      px = ptr_in[ 0 ];
-      py = ptr_in[ 1 ];
-
-/* Loop round each supplied point in the base Frame of the polygon. */
-      for ( point = 0; point < npoint; point++, px++, py++ ) {
 
-/* If the input point is bad, indicate that bad output values should be
-   returned. */
-         if( *px == AST__BAD || *py == AST__BAD ) {
-            in_region = 0;
-
-/* Otherwise, we first determine if the point is inside, outside, or on,
-   the Polygon boundary. Initialially it is unknown. */
-         } else {
-
-/* Ensure cached information is available.*/
-            Cache( this, status );
-
-/* Create a definition of the line from a point which is inside the
-   polygon to the supplied point. This is a structure which includes
-   cached intermediate information which can be used to speed up
-   subsequent calculations. */
-            p[ 0 ] = *px;
-            p[ 1 ] = *py;
-            a = astLineDef( frm, this->in, p );
-
-/* We now determine the number of times this line crosses the polygon
-   boundary. Initialise the number of crossings to zero. */
-            ncross = 0;
-            pos = UNKNOWN;
-
-/* Loop rouind all edges of the polygon. */
-            for( i = 0; i < nv; i++ ) {
-               b = this->edges[ i ];
-
-/* If this point is on the current edge, then we need do no more checks
-   since we know it is either inside or outside the polygon (depending on
-   whether the polygon is closed or not). */
-               if( astLineContains( frm, b, 0, p ) ) {
-                  pos = ON;
-                  break;
-
-/* Otherwise, see if the two lines cross within their extent. If so,
-   increment the number of crossings. */
-               } else if( astLineCrossing( frm, b, a, NULL, NULL ) ) {
-                  ncross++;
-               }
-            }
-
-/* Free resources */
-            a = astFree( a );
-
-/* If the position is not on the boundary, it is inside the boundary if
-   the number of crossings is even, and outside otherwise. */
-            if( pos == UNKNOWN ) pos = ( ncross % 2 == 0 )? IN : OUT;
-
-/* Whether the point is in the Region depends on whether the point is
-   inside the polygon boundary, whether the Polygon has been negated, and
-   whether the polygon is closed. */
-            if( neg ) {
-               if( pos == IN ) {
-                  in_region = 0;
-               } else if( pos == OUT ) {
-                  in_region = 1;
-               } else if( closed ) {
-                  in_region = 1;
-               } else {
-                  in_region = 0;
-               }
-
-            } else {
-               if( pos == IN ) {
-                  in_region = 1;
-               } else if( pos == OUT ) {
-                  in_region = 0;
-               } else if( closed ) {
-                  in_region = 1;
-               } else {
-                  in_region = 0;
-               }
-            }
-         }
+/* Ensure cached information is available. This must be done before
+   testing any points, since the testing may be shared between several
+   threads. */
+   Cache( this, status );
 
-/* If the point is not inside the Region, store bad output values. */
-         if( !in_region ) {
-            for ( icoord = 0; icoord < ncoord_out; icoord++ ) {
-               ptr_out[ icoord ][ point ] = AST__BAD;
-            }
-         }
-      }
-   }
+/* Describe the points to be tested. The number of axes in the current
+   Frame need not be 2 (the number of axes in the *base* Frame must be 2
+   however). */
+   pdata.ptr_in = astGetPoints( in_base );
+   pdata.ptr_out = astGetPoints( result );
+   pdata.ncoord_out = astGetNcoord( result );
+   pdata.mask = NULL;
+   pdata.nv = astGetNpoint( ((AstRegion *) this)->points );
+   pdata.closed = astGetClosed( this );
+   pdata.neg = astGetNegated( this );
+
+/* Perform coordinate arithmetic, possibly using several threads. Points
+   that are not inside the Region are set bad in the output PointSet. */
+   if ( astOK ) (void) astRegParallel( this, frm, astGetNpoint( result ),
+                                       TestPoints, &pdata );
 
 /* Free resources */
    in_base = astAnnul( in_base );
@@ -67,6 +67,7 @@ f     - AST_POLYTRAN: Fit a PolyMap inverse or forward transformation
 
 *  Authors:
 *     DSB: D.S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     27-SEP-2003 (DSB):
@@ -139,6 +140,10 @@ f     - AST_POLYTRAN: Fit a PolyMap inverse or forward transformation
 *        of the original uninverted PolyMap, or the current forward
 *        transformation of the PolyMap (i.e. taking the "Invert" flag into
 *        account).
+*     18-OCT-2026 (AGT):
+*        Copies of a PolyMap now share the arrays describing the
+*        polynomials with the original PolyMap, rather than copying them.
+*        Also, include these arrays in the value returned by astGetObjSize.
 *class--
 */
 
@@ -1647,8 +1652,12 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
 
 /* Local Variables: */
    AstPolyMap *this;
+   int i;
    int ic;
+   int j;
    int nc;
+   int nin;
+   int nout;
    size_t result;
 
 /* Initialise. */
@@ -1673,6 +1682,43 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
       result += sizeof( AstPolyMap * )*nc;
    }
 
+/* Add on the arrays describing the forward polynomials. */
+   nin = ( (AstMapping *) this )->nin;
+   nout = ( (AstMapping *) this )->nout;
+
+   result += astTSizeOf( this->ncoeff_f );
+   result += astTSizeOf( this->mxpow_f );
+   result += astTSizeOf( this->coeff_f );
+   result += astTSizeOf( this->power_f );
+   for( i = 0; i < nout; i++ ) {
+      if( this->coeff_f ) result += astTSizeOf( this->coeff_f[ i ] );
+      if( this->power_f && this->power_f[ i ] ) {
+         result += astTSizeOf( this->power_f[ i ] );
+         if( this->ncoeff_f ) {
+            for( j = 0; j < this->ncoeff_f[ i ]; j++ ) {
+               result += astTSizeOf( this->power_f[ i ][ j ] );
+            }
+         }
+      }
+   }
+
+/* Add on the arrays describing the inverse polynomials. */
+   result += astTSizeOf( this->ncoeff_i );
+   result += astTSizeOf( this->mxpow_i );
+   result += astTSizeOf( this->coeff_i );
+   result += astTSizeOf( this->power_i );
+   for( i = 0; i < nin; i++ ) {
+      if( this->coeff_i ) result += astTSizeOf( this->coeff_i[ i ] );
+      if( this->power_i && this->power_i[ i ] ) {
+         result += astTSizeOf( this->power_i[ i ] );
+         if( this->ncoeff_i ) {
+            for( j = 0; j < this->ncoeff_i[ i ]; j++ ) {
+               result += astTSizeOf( this->power_i[ i ][ j ] );
+            }
+         }
+      }
+   }
+
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
 
@@ -5225,30 +5271,34 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    nin = ( (AstMapping *) in )->nin;
    nout = ( (AstMapping *) in )->nout;
 
-/* Copy the number of coefficients associated with each output of the
+/* The arrays holding the number of coefficients, maximum powers,
+   coefficient values and input axis powers are never changed once they
+   have been created (new arrays are created instead), so the output
+   PolyMap can share them with the input PolyMap rather than copying
+   them (see astShare). The arrays of pointers to these arrays are
+   copied, since FreeArrays uses them to free the shared arrays. */
+
+/* Share the number of coefficients associated with each output of the
    forward transformation of the uninverted Mapping. */
    if( in->ncoeff_f ) {
-      out->ncoeff_f = (int *) astStore( NULL, (void *) in->ncoeff_f,
-                                        sizeof( int )*(size_t) nout );
+      out->ncoeff_f = (int *) astShare( in->ncoeff_f );
 
-/* Copy the maximum power of each input axis value used by the forward
+/* Share the maximum power of each input axis value used by the forward
    transformation. */
-      out->mxpow_f = (int *) astStore( NULL, (void *) in->mxpow_f,
-                                       sizeof( int )*(size_t) nin );
+      out->mxpow_f = (int *) astShare( in->mxpow_f );
 
-/* Copy the coefficient values used by the forward transformation. */
+/* Share the coefficient values used by the forward transformation. */
       if( in->coeff_f ) {
          out->coeff_f = astMalloc( sizeof( double * )*(size_t) nout );
          if( astOK ) {
             for( i = 0; i < nout; i++ ) {
-               out->coeff_f[ i ] = (double *) astStore( NULL, (void *) in->coeff_f[ i ],
-                                                     sizeof( double )*(size_t) in->ncoeff_f[ i ] );
+               out->coeff_f[ i ] = (double *) astShare( in->coeff_f[ i ] );
             }
          }
       }
 
-/* Copy the input axis powers associated with each coefficient of the forward
-   transformation. */
+/* Share the input axis powers associated with each coefficient of the
+   forward transformation. */
       if( in->power_f ) {
          out->power_f = astMalloc( sizeof( int ** )*(size_t) nout );
          if( astOK ) {
@@ -5256,8 +5306,7 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
                out->power_f[ i ] = astMalloc( sizeof( int * )*(size_t) in->ncoeff_f[ i ] );
                if( astOK ) {
                   for( j = 0; j < in->ncoeff_f[ i ]; j++ ) {
-                     out->power_f[ i ][ j ] = (int *) astStore( NULL, (void *) in->power_f[ i ][ j ],
-                                                                sizeof( int )*(size_t) nin );
+                     out->power_f[ i ][ j ] = (int *) astShare( in->power_f[ i ][ j ] );
                   }
                }
             }
@@ -5267,18 +5316,14 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
 
 /* Do the same for the inverse transformation. */
    if( in->ncoeff_i ) {
-      out->ncoeff_i = (int *) astStore( NULL, (void *) in->ncoeff_i,
-                                        sizeof( int )*(size_t) nin );
-
-      out->mxpow_i = (int *) astStore( NULL, (void *) in->mxpow_i,
-                                       sizeof( int )*(size_t) nout );
+      out->ncoeff_i = (int *) astShare( in->ncoeff_i );
+      out->mxpow_i = (int *) astShare( in->mxpow_i );
 
       if( in->coeff_i ) {
          out->coeff_i = astMalloc( sizeof( double * )*(size_t) nin );
          if( astOK ) {
             for( i = 0; i < nin; i++ ) {
-               out->coeff_i[ i ] = (double *) astStore( NULL, (void *) in->coeff_i[ i ],
-                                                     sizeof( double )*(size_t) in->ncoeff_i[ i ] );
+               out->coeff_i[ i ] = (double *) astShare( in->coeff_i[ i ] );
             }
          }
       }
@@ -5290,8 +5335,7 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
                out->power_i[ i ] = astMalloc( sizeof( int * )*(size_t) in->ncoeff_i[ i ] );
                if( astOK ) {
                   for( j = 0; j < in->ncoeff_i[ i ]; j++ ) {
-                     out->power_i[ i ][ j ] = (int *) astStore( NULL, (void *) in->power_i[ i ][ j ],
-                                                                sizeof( int )*(size_t) nout );
+                     out->power_i[ i ][ j ] = (int *) astShare( in->power_i[ i ][ j ] );
                   }
                }
             }
@@ -60,6 +60,7 @@ f     The Prism class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     17-DEC-2004 (DSB):
@@ -85,6 +86,9 @@ f     The Prism class does not define any new routines beyond those
 *        within the class virtual function table.
 *     28-JAN-2021 (DSB):
 *        GetRegionBounds: Take account of axis permutation in the Prism's FrameSet.
+*     18-OCT-2026 (AGT):
+*        GetBounded: Use negated copies of the component Regions if the
+*        Prism is frozen.
 *class--
 */
 
@@ -818,6 +822,8 @@ static int GetBounded( AstRegion *this_region, int *status ) {
    AstPrism *this;            /* Pointer to Prism structure */
    AstRegion *reg1;           /* Pointer to first component Region */
    AstRegion *reg2;           /* Pointer to second component Region */
+   AstRegion *tmp;            /* Negated copy of a component Region */
+   int frozen;                /* Is the Prism frozen? */
    int neg;                   /* Negated flag to use with the Prism */
    int reg1b;                 /* Is the first component Region bounded?*/
    int reg2b;                 /* Is the second component Region bounded?*/
@@ -837,8 +843,18 @@ static int GetBounded( AstRegion *this_region, int *status ) {
    encapsulated by the parent Region structure. */
    GetRegions( this, &reg1, &reg2, &neg, status );
 
-/* If the Prism has been inverted, temporarily invert the components. */
-   if( neg ) {
+/* If the Prism has been inverted, temporarily invert the components. A
+   frozen Region cannot be changed, so use negated copies of the
+   components instead if the Prism is frozen. */
+   frozen = astGetFrozen( this );
+   if( neg && frozen ) {
+      tmp = astGetNegation( reg1 );
+      (void) astAnnul( reg1 );
+      reg1 = tmp;
+      tmp = astGetNegation( reg2 );
+      (void) astAnnul( reg2 );
+      reg2 = tmp;
+   } else if( neg ) {
       astNegate( reg1 );
       astNegate( reg2 );
    }
@@ -849,7 +865,7 @@ static int GetBounded( AstRegion *this_region, int *status ) {
 
 /* If the Prism has been inverted, re-invert the components to bring them
    back to their original states. */
-   if( neg ) {
+   if( neg && !frozen ) {
       astNegate( reg1 );
       astNegate( reg2 );
    }
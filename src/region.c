@@ -132,6 +132,8 @@ c     - astOverlap: Determines the nature of the overlap between two Regions
 f     - AST_OVERLAP: Determines the nature of the overlap between two Regions
 c     - astPointInRegion: Test if a single point is inside a Region
 f     - AST_POINTINREGION: Test if a single point is inside a Region
+c     - astPointsInRegion: Test if each of a set of points is inside a Region
+f     - AST_POINTSINREGION: Test if each of a set of points is inside a Region
 c     - astMask<X>: Mask a region of a data grid
 f     - AST_MASK<X>: Mask a region of a data grid
 c     - astSetUnc: Associate a new uncertainty with a Region
@@ -164,6 +166,7 @@ f     - AST_SHOWMESH: Display a mesh of points on the surface of a Region
 
 *  Authors:
 *     DSB: David S. Berry (STARLINK)
+*     AGT: Agent
 
 *  History:
 *     3-DEC-2003 (DSB):
@@ -270,6 +273,36 @@ f     - AST_SHOWMESH: Display a mesh of points on the surface of a Region
 *     28-OCT-2021 (DSB):
 *        Modified astGetRegionMesh so that meshes for SkyFrame regions that cross
 *        zero longitude do not include jumps of 2.PI in logitude.
+*     18-OCT-2026 (AGT):
+*        - Added astPointsInRegion and the protected astRegPointsIn method,
+*        which test many points without creating a transformed copy of
+*        them.
+*        - Added protected method astRegShape. Use it in astOverlap to
+*        determine the overlap between pairs of ellipses and convex polygons
+*        analytically, rather than by sampling their boundaries.
+*        - Added protected method astRegFixedMesh. Use it in astMapRegion
+*        to retain the base Frame mesh and grid cached in the new Region,
+*        rather than discarding them.
+*        - Added protected function astRegParallel, which shares the
+*        testing of large numbers of points between the library's pool
+*        of worker threads (see astParallelFor), controlled by the new
+*        "Threads" tuning parameter. Use it in astMask<X> to mask
+*        sections of large arrays concurrently.
+*        - Create the base Frame mesh and grid before a Region is frozen,
+*        and do not cache the negated Region or default uncertainty
+*        Region in a frozen Region. astOverlap and astMask<X> use
+*        negated copies of frozen Regions rather than negating them
+*        temporarily.
+*        - Report an error if astNegate or astSetUnc is used on a frozen
+*        Region. GetUncFrm returns a copy of the uncertainty Region of a
+*        frozen Region since callers may re-centre it.
+*        - The ObjSize and ObjShared attributes now describe the Region
+*        itself rather than its encapsulated FrameSet.
+*     19-OCT-2026 (AGT):
+*        In PrinAxes, find the orientation of the principal axes using
+*        atan2 and the shorter axis from the determinant, to avoid loss
+*        of precision that caused astOverlap to give inconsistent results
+*        for some ellipses depending on the order of the two Regions.
 *class--
 
 *  Implementation Notes:
@@ -847,6 +880,7 @@ static int Test##attribute( AstFrame *this_frame, int axis, int *status ) { \
 #include "wcsmap.h"              /* For AST__DPI */
 #include "ellipse.h"             /* Elliptical regions */
 #include "pointset.h"            /* Sets of points */
+#include "parallel.h"            /* Worker thread pool */
 #include "globals.h"             /* Thread-safe global data access */
 
 /* Error code definitions. */
@@ -871,6 +905,20 @@ static int Test##attribute( AstFrame *this_frame, int axis, int *status ) { \
    member of this class. */
 static int class_check;
 
+/* A structure that describes an array being masked by astMask<X>, for
+   use by the MaskSection<X> functions. */
+typedef struct MaskData {
+   int ndim;                     /* No. of pixel axes */
+   const AstDim *lbnd;           /* Lower bounds of array */
+   const AstDim *ubnd;           /* Upper bounds of array */
+   const AstDim *lbndg;          /* Lower bounds of box to be masked */
+   const AstDim *ubndg;          /* Upper bounds of box to be masked */
+   AstDim nplane;                /* No. of pixels in one plane of the box */
+   void *in;                     /* Input array */
+   void *out;                    /* Output array */
+   void *val;                    /* Pointer to the value to assign */
+} MaskData;
+
 /* Pointers to parent class methods which are extended by this class. */
 static size_t (* parent_getobjsize)( AstObject *, int * );
 static int (* parent_getusedefs)( AstObject *, int * );
@@ -879,6 +927,26 @@ static int (* parent_getusedefs)( AstObject *, int * );
 static int (* parent_managelock)( AstObject *, int, int, AstObject **, int * );
 #endif
 
+/* The number of points in each block of points copied by
+   astPointsInRegion when the AST__INTERLEAVED flag is set. This must be a
+   multiple of 8 (see astPointsInRegion). */
+#define PIR_BLOCK 65536
+
+/* The minimum number of points to be tested by each thread used by
+   astRegParallel, and the number of points in each chunk of points. The
+   chunk size must be a multiple of 8 (see astRegParallel). */
+#define MIN_THREAD_POINTS 4096
+#define CHUNK_POINTS ( MIN_THREAD_POINTS/4 )
+
+/* Data passed to RegParallelChunk by astParallelFor. */
+typedef struct RegParallelData {
+   AstRegion *this;              /* Region being tested */
+   AstFrame **frames;            /* Frame to be used by each thread */
+   AstRegChunkFun fun;           /* Function that tests a chunk of points */
+   void *data;                   /* Data to pass to "fun" */
+   AstDim *results;              /* Sum of values returned for each thread */
+} RegParallelData;
+
 /* Define macros for accessing each item of thread specific global data. */
 #ifdef THREAD_SAFE
 
@@ -915,6 +983,7 @@ static int class_init = 0;       /* Virtual function table initialised? */
 /* ======================================== */
 #if HAVE_LONG_DOUBLE     /* Not normally implemented */
 static AstDim MaskLD( AstRegion *, AstMapping *, int, int, const AstDim[], const AstDim ubnd[], long double [], long double, int * );
+static AstDim MaskSectionLD( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
 #endif
 static AstDim MaskB( AstRegion *, AstMapping *, int, int, const AstDim[], const AstDim[], signed char[], signed char, int * );
 static AstDim MaskD( AstRegion *, AstMapping *, int, int, const AstDim[], const AstDim[], double[], double, int * );
@@ -926,6 +995,16 @@ static AstDim MaskUB( AstRegion *, AstMapping *, int, int, const AstDim[], const
 static AstDim MaskUI( AstRegion *, AstMapping *, int, int, const AstDim[], const AstDim[], unsigned int[], unsigned int, int * );
 static AstDim MaskUL( AstRegion *, AstMapping *, int, int, const AstDim[], const AstDim[], unsigned long int[], unsigned long int, int * );
 static AstDim MaskUS( AstRegion *, AstMapping *, int, int, const AstDim[], const AstDim[], unsigned short int[], unsigned short int, int * );
+static AstDim MaskSectionB( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionD( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionF( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionI( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionL( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionS( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionUB( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionUI( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionUL( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
+static AstDim MaskSectionUS( AstRegion *, AstFrame *, AstDim, AstDim, void *, int * );
 
 static AstAxis *GetAxis( AstFrame *, int, int * );
 static AstFrame *GetRegionFrame( AstRegion *, int * );
@@ -967,10 +1046,13 @@ static double AxAngle( AstFrame *, const double[], const double[], int, int * );
 static double AxDistance( AstFrame *, int, double, double, int * );
 static double AxOffset( AstFrame *, int, double, double, int * );
 static double Distance( AstFrame *, const double[], const double[], int * );
+static double EllipseDist( double, double, double, double, int, int * );
 static double Centre( AstFrame *, int, double, double, int * );
 static double Gap( AstFrame *, int, double, int *, int * );
 static double Offset2( AstFrame *, const double[2], double, double, double[2], int * );
+static double PolyDist( const double *, int, double, double, int, int * );
 static int Equal( AstObject *, AstObject *, int * );
+static int ConvexPoly( double *, int, int * );
 static int GetNaxes( AstFrame *, int * );
 static size_t GetObjSize( AstObject *, int * );
 static int GetUseDefs( AstObject *, int * );
@@ -981,8 +1063,13 @@ static int Match( AstFrame *, AstFrame *, int, int **, int **, AstMapping **, As
 static int Overlap( AstRegion *, AstRegion *, int * );
 static int OverlapX( AstRegion *, AstRegion *, int * );
 static int PointInRegion( AstRegion *, const double *, int * );
+static AstDim PointsInRegion( AstRegion *, AstDim, int, AstDim, const double *, int, unsigned char *, int * );
+static AstDim RegPointsIn( AstRegion *, AstPointSet *, unsigned char *, int * );
 static int RegDummyFS( AstRegion *, int * );
+static int RegFixedMesh( AstRegion *, int * );
 static int RegPins( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+static int RegShape( AstRegion *, double[2], double[4], double **, int *, int * );
+static int ShapeOverlap( AstRegion *, AstRegion *, AstMapping *, int * );
 static int SubFrame( AstFrame *, AstFrame *, int, const int *, const int *, AstMapping **, AstFrame **, int * );
 static int RegTrace( AstRegion *, int, double *, double **, int * );
 static int Unformat( AstFrame *, int, const char *, double *, int * );
@@ -1008,6 +1095,7 @@ static void NormBox( AstFrame *, double[], double[], AstMapping *, int * );
 static void Offset( AstFrame *, const double[], const double[], double, double[], int * );
 static void Overlay( AstFrame *, const int *, AstFrame *, int * );
 static void PermAxes( AstFrame *, const int[], int * );
+static void PrinAxes( const double[4], double *, double *, double[2], int * );
 static void RegBaseBox( AstRegion *, double *, double *, int * );
 static void RegBaseBox2( AstRegion *, double *, double *, int * );
 static void RegClearAttrib( AstRegion *, const char *, char **, int * );
@@ -1015,6 +1103,7 @@ static void RegOverlay( AstRegion *, AstRegion *, int, int * );
 static void RegSetAttrib( AstRegion *, const char *, char **, int * );
 static void ReportPoints( AstMapping *, int, AstPointSet *, AstPointSet *, int * );
 static void ResetCache( AstRegion *, int * );
+static void RegParallelChunk( int, AstDim, AstDim, void *, int * );
 static void Resolve( AstFrame *, const double [], const double [], const double [], double [], double *, double *, int * );
 static void SetAxis( AstFrame *, int, AstAxis *, int * );
 static void SetRegFS( AstRegion *, AstFrame *, int * );
@@ -2277,6 +2366,8 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
                !strcmp( attrib, "nin" ) ||
                !strcmp( attrib, "nobject" ) ||
                !strcmp( attrib, "nout" ) ||
+               !strcmp( attrib, "objshared" ) ||
+               !strcmp( attrib, "objsize" ) ||
                !strcmp( attrib, "bounded" ) ||
                !strcmp( attrib, "refcount" ) ||
                !strcmp( attrib, "tranforward" ) ||
@@ -2625,6 +2716,272 @@ static double Distance( AstFrame *this_frame, const double point1[],
    return result;
 }
 
+static double EllipseDist( double a, double b, double y0, double y1, int far,
+                           int *status ){
+/*
+*  Name:
+*     EllipseDist
+
+*  Purpose:
+*     Find the nearest or furthest distance from a point to an ellipse.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     double EllipseDist( double a, double b, double y0, double y1, int far,
+*                         int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function returns the smallest or largest distance from a given
+*     point to the boundary of an ellipse. The ellipse is centred on the
+*     origin, with its axes parallel to the coordinate axes. The point is
+*     assumed to be in the first quadrant (any point can be moved into the
+*     first quadrant by reflection without changing the returned distance).
+*
+*     The points on the ellipse that are closest to or furthest from the
+*     given point are found using the method of Lagrange multipliers,
+*     which results in a quartic equation for the multiplier. Only one root
+*     of this equation is relevant in each case, and this root is located
+*     by bisection within a bracket that is known to contain only the
+*     required root. See "Distance from a Point to an Ellipse, an Ellipsoid,
+*     or a Hyperellipsoid" (D. Eberly, Geometric Tools, 2013).
+
+*  Parameters:
+*     a
+*        The half-length of the ellipse axis parallel to the first
+*        coordinate axis. Must be no less than "b".
+*     b
+*        The half-length of the ellipse axis parallel to the second
+*        coordinate axis. Must be greater than zero.
+*     y0
+*        The first coordinate of the point. Must not be negative.
+*     y1
+*        The second coordinate of the point. Must not be negative.
+*     far
+*        If non-zero, the largest distance is returned. Otherwise the
+*        smallest distance is returned.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The required distance.
+
+*/
+
+/* Local Constants: */
+#define MAXITER 200          /* Max. no. of bisection iterations */
+
+/* Local Variables: */
+   double a2;                /* Square of "a" */
+   double b2;                /* Square of "b" */
+   double d2;                /* Alternative squared distance */
+   double f;                 /* Constraint function value */
+   double hi;                /* Upper limit of bracket */
+   double lo;                /* Lower limit of bracket */
+   double mid;               /* Bisection point */
+   double x0;                /* First coord of extreme point on ellipse */
+   double x1;                /* Second coord of extreme point on ellipse */
+   int iter;                 /* Iteration count */
+
+/* Check the global error status. */
+   if( !astOK ) return 0.0;
+
+   a2 = a*a;
+   b2 = b*b;
+
+/* First deal with the smallest distance. The closest point (x0,y0) is
+   given by "xi = ai^2.yi/(ai^2 + s)" for the root "s > -b^2" of
+   "(a.y0/(a^2 + s))^2 + (b.y1/(b^2 + s))^2 = 1". Handle the cases
+   where the point is on an axis separately since the above root may not
+   then exist. */
+   if( !far ) {
+      if( y1 > 0.0 ) {
+         if( y0 > 0.0 ) {
+            lo = -b2 + b*y1;
+            hi = -b2 + sqrt( a2*y0*y0 + b2*y1*y1 );
+            if( hi < lo ) hi = lo;
+            mid = 0.5*( lo + hi );
+            for( iter = 0; iter < MAXITER; iter++ ) {
+               mid = 0.5*( lo + hi );
+               if( mid == lo || mid == hi ) break;
+               x0 = a*y0/( a2 + mid );
+               x1 = b*y1/( b2 + mid );
+               f = x0*x0 + x1*x1 - 1.0;
+               if( f > 0.0 ) {
+                  lo = mid;
+               } else if( f < 0.0 ) {
+                  hi = mid;
+               } else {
+                  break;
+               }
+            }
+            x0 = a2*y0/( a2 + mid );
+            x1 = b2*y1/( b2 + mid );
+            return sqrt( ( x0 - y0 )*( x0 - y0 ) + ( x1 - y1 )*( x1 - y1 ) );
+
+         } else {
+            return fabs( y1 - b );
+         }
+
+      } else {
+         if( a*y0 < a2 - b2 ) {
+            x0 = a*y0/( a2 - b2 );
+            x1 = b*sqrt( 1.0 - x0*x0 );
+            x0 *= a;
+            return sqrt( ( x0 - y0 )*( x0 - y0 ) + x1*x1 );
+         } else {
+            return fabs( y0 - a );
+         }
+      }
+
+/* Now deal with the largest distance. The furthest point (-x0,-x1)
+   is in the opposite quadrant, with "xi = ai^2.yi/(s - ai^2)" for the root
+   "s > a^2" of "(a.y0/(s - a^2))^2 + (b.y1/(s - b^2))^2 = 1". */
+   } else {
+      if( y0 > 0.0 ) {
+         lo = a2 + a*y0;
+         hi = a2 + sqrt( a2*y0*y0 + b2*y1*y1 );
+         if( hi < lo ) hi = lo;
+         mid = 0.5*( lo + hi );
+         for( iter = 0; iter < MAXITER; iter++ ) {
+            mid = 0.5*( lo + hi );
+            if( mid == lo || mid == hi ) break;
+            x0 = a*y0/( mid - a2 );
+            x1 = b*y1/( mid - b2 );
+            f = x0*x0 + x1*x1 - 1.0;
+            if( f > 0.0 ) {
+               lo = mid;
+            } else if( f < 0.0 ) {
+               hi = mid;
+            } else {
+               break;
+            }
+         }
+         x0 = a2*y0/( mid - a2 );
+         x1 = b2*y1/( mid - b2 );
+         return sqrt( ( x0 + y0 )*( x0 + y0 ) + ( x1 + y1 )*( x1 + y1 ) );
+
+/* If the point is on the second axis, the furthest point is either at
+   the end of the second axis, or at the point where the multiplier
+   equals a^2. */
+      } else {
+         d2 = ( y1 + b )*( y1 + b );
+         if( b*y1 < a2 - b2 ) {
+            x1 = b*y1/( a2 - b2 );
+            x0 = a2*( 1.0 - x1*x1 );
+            x1 *= b;
+            if( x0 + ( x1 + y1 )*( x1 + y1 ) > d2 ) {
+               d2 = x0 + ( x1 + y1 )*( x1 + y1 );
+            }
+         }
+         return sqrt( d2 );
+      }
+   }
+
+/* Undefine local constants. */
+#undef MAXITER
+}
+
+static int ConvexPoly( double *vert, int nvert, int *status ){
+/*
+*  Name:
+*     ConvexPoly
+
+*  Purpose:
+*     Check a polygon is convex and ensure its vertices are anti-clockwise.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int ConvexPoly( double *vert, int nvert, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function checks that the supplied polygon is convex and has
+*     non-zero area. If so, the order of the vertices is reversed if
+*     necessary so that they are stored in anti-clockwise order.
+
+*  Parameters:
+*     vert
+*        Pointer to an array holding the vertex coordinates. All the X
+*        values are stored first, followed by all the Y values. Modified
+*        on exit if the vertices need to be re-ordered.
+*     nvert
+*        The number of vertices.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the polygon is convex. Zero otherwise.
+
+*/
+
+/* Local Variables: */
+   double *vx;               /* Pointer to vertex X values */
+   double *vy;               /* Pointer to vertex Y values */
+   double area;              /* Twice the signed area of the polygon */
+   double cross;             /* Cross product of adjacent edges */
+   double tmp;               /* Temporary storage for swapping */
+   int i;                    /* Vertex index */
+   int j;                    /* Index of next vertex */
+   int k;                    /* Index of next but one vertex */
+   int neg;                  /* Any clockwise turns found? */
+   int pos;                  /* Any anti-clockwise turns found? */
+
+/* Check the global error status. */
+   if( !astOK || nvert < 3 ) return 0;
+
+   vx = vert;
+   vy = vert + nvert;
+
+/* Check that the polygon turns in the same sense at every vertex, and
+   find its area. Bad vertices cannot be used. */
+   pos = 0;
+   neg = 0;
+   area = 0.0;
+   for( i = 0; i < nvert; i++ ) {
+      if( vx[ i ] == AST__BAD || vy[ i ] == AST__BAD ) return 0;
+      j = ( i + 1 ) % nvert;
+      k = ( i + 2 ) % nvert;
+      cross = ( vx[ j ] - vx[ i ] )*( vy[ k ] - vy[ j ] ) -
+              ( vy[ j ] - vy[ i ] )*( vx[ k ] - vx[ j ] );
+      if( cross > 0.0 ) {
+         pos = 1;
+      } else if( cross < 0.0 ) {
+         neg = 1;
+      }
+      area += vx[ i ]*vy[ j ] - vx[ j ]*vy[ i ];
+   }
+
+/* A polygon that turns both ways is not convex. Note, this test does not
+   detect a star-shaped polygon that winds more than once round its
+   centre, but such polygons have no meaningful area anyway. */
+   if( ( pos && neg ) || area == 0.0 ) return 0;
+
+/* Reverse the order of the vertices if they are clockwise. */
+   if( area < 0.0 ) {
+      for( i = 0, j = nvert - 1; i < j; i++, j-- ) {
+         tmp = vx[ i ];
+         vx[ i ] = vx[ j ];
+         vx[ j ] = tmp;
+         tmp = vy[ i ];
+         vy[ i ] = vy[ j ];
+         vy[ j ] = tmp;
+      }
+   }
+
+   return 1;
+}
+
 static int Equal( AstObject *this_object, AstObject *that_object, int *status ) {
 /*
 *  Name:
@@ -3169,6 +3526,7 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    const char *result;           /* Pointer value to return */
    double dval;                  /* Floating point attribute value */
    int ival;                     /* Integer attribute value */
+   size_t sval;                  /* Size attribute value */
 
 /* Initialise. */
    result = NULL;
@@ -3290,6 +3648,26 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
          result = getattrib_buff;
       }
 
+/* ObjShared. */
+/* ---------- */
+   } else if ( !strcmp( attrib, "objshared" ) ) {
+      (void) astSharedSize( 1 );
+      (void) astGetObjSize( this );
+      sval = astSharedSize( 1 );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%zu", sval );
+         result = getattrib_buff;
+      }
+
+/* ObjSize. */
+/* -------- */
+   } else if ( !strcmp( attrib, "objsize" ) ) {
+      sval = astGetObjSize( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%zu", sval );
+         result = getattrib_buff;
+      }
+
 /* Nout. */
 /* ----- */
    } else if ( !strcmp( attrib, "nout" ) ) {
@@ -3623,12 +4001,21 @@ static AstRegion *GetNegation( AstRegion *this, int *status ) {
 *-
 */
 
+/* Local Variables: */
+   AstRegion *result;         /* Returned pointer */
+
 /* Check the global error status. */
    if ( !astOK ) return NULL;
 
 /* If the Region struture does not contain a pointer to a negated copy of
-   itself, create one now. */
+   itself, create one now. A frozen Region cannot be changed, so in that
+   case just return a new negated copy without storing it. */
    if( ! this->negation ) {
+      if( astGetFrozen( this ) ) {
+         result = astCopy( this );
+         astNegate( result );
+         return result;
+      }
       this->negation = astCopy( this );
       astNegate( this->negation );
    }
@@ -3971,21 +4358,25 @@ static AstRegion *GetUncFrm( AstRegion *this, int ifrm, int *status ) {
 /* If the Region has an explicitly assigned base-frame uncertainty Region,
    use it. */
    if( this->unc ) {
-      unc = this->unc;
+      unc = astClone( this->unc );
 
 /* If not, use the default base-frame uncertainty Region, creating it if
-   necessary. */
-   } else {
+   necessary. A frozen Region cannot be changed, so in that case the
+   default uncertainty Region is created afresh each time it is needed. */
+   } else if( this->defunc || !astGetFrozen( this ) ) {
       if( !this->defunc ) this->defunc = astGetDefUnc( this );
-      unc = this->defunc;
+      unc = astClone( this->defunc );
+   } else {
+      unc = astGetDefUnc( this );
    }
 
 /* If the uncertainty Region is the base Frame is required, just return a
    clone of the uncertainty Region pointer. The Frame represented by an
    uncertainty Region will always (barring bugs!) be the base Frame of
-   its parent Region. */
+   its parent Region. Callers are free to modify the returned Region (e.g.
+   to re-centre it), so return a copy if the Region is frozen. */
    if( ifrm == AST__BASE ) {
-      result = astClone( unc );
+      result = astGetFrozen( this ) ? astCopy( unc ) : astClone( unc );
 
 /* If the uncertainty Region is the current Frame is required... */
    } else {
@@ -3995,9 +4386,9 @@ static AstRegion *GetUncFrm( AstRegion *this, int ifrm, int *status ) {
       map = astGetMapping( this->frameset, AST__BASE, AST__CURRENT );
 
 /* If this is a UnitMap, the uncertainty Region is already in the correct
-   Frame, so just return the stored pointer. */
+   Frame, so just return the stored pointer (or a copy if frozen). */
       if( astIsAUnitMap( map ) ) {
-         result = astClone( unc );
+         result = astGetFrozen( this ) ? astCopy( unc ) : astClone( unc );
 
 /* Otherwise, use this Mapping to map the uncertainty Region into the current
    Frame. */
@@ -4012,6 +4403,9 @@ static AstRegion *GetUncFrm( AstRegion *this, int ifrm, int *status ) {
       map = astAnnul( map );
    }
 
+/* Free resources. */
+   unc = astAnnul( unc );
+
 /* Return NULL if an error occurred. */
    if( !astOK ) result = astAnnul( result );
 
@@ -4643,11 +5037,15 @@ void astInitRegionVtab_(  AstRegionVtab *vtab, const char *name, int *status ) {
    vtab->GetRegionPoints = GetRegionPoints;
    vtab->GetRegionDisc = GetRegionDisc;
    vtab->PointInRegion = PointInRegion;
+   vtab->PointsInRegion = PointsInRegion;
+   vtab->RegPointsIn = RegPointsIn;
    vtab->RegOverlay = RegOverlay;
    vtab->RegFrame = RegFrame;
    vtab->RegDummyFS = RegDummyFS;
+   vtab->RegFixedMesh = RegFixedMesh;
    vtab->RegMapping = RegMapping;
    vtab->RegPins = RegPins;
+   vtab->RegShape = RegShape;
    vtab->RegTransform = RegTransform;
    vtab->BTransform = BTransform;
    vtab->GetRegFS = GetRegFS;
@@ -5311,6 +5709,9 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 *
 *        AST__CHECKLOCK: Check that the object is locked for use by the
 *        calling thread (report an error if not).
+*
+*        AST__FREEZE: Freeze the Object (see astFreeze). Any cached
+*        mesh and grid PointSets are created first.
 *     extra
 *        Extra mode-specific information.
 *     fail
@@ -5339,6 +5740,7 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 
 /* Local Variables: */
    AstRegion *this;       /* Pointer to Region structure */
+   int rep;               /* Original error reporting status */
    int result;            /* Returned status value */
 
 /* Initialise */
@@ -5350,6 +5752,20 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 /* Obtain a pointers to the Region structure. */
    this = (AstRegion *) this_object;
 
+/* A frozen Region cannot be changed, so before freezing a Region create
+   the mesh and grid PointSets that would otherwise be created and cached
+   when first needed. Some Regions (e.g. unbounded Regions) cannot produce
+   a mesh or grid, so ignore any errors that occur whilst doing this - the
+   same errors will be reported if the mesh or grid is used later. */
+   if( mode == AST__FREEZE && !this_object->frozen && astOK ) {
+      rep = astReporting( 0 );
+      (void) astAnnul( astRegBaseMesh( this ) );
+      if( !astOK ) astClearStatus;
+      (void) astAnnul( astRegBaseGrid( this ) );
+      if( !astOK ) astClearStatus;
+      astReporting( rep );
+   }
+
 /* Invoke the ManageLock method inherited from the parent class. */
    if( !result ) result = (*parent_managelock)( this_object, mode, extra,
                                                 fail, status );
@@ -5436,6 +5852,8 @@ static AstRegion *MapRegion( AstRegion *this, AstMapping *map0,
    AstMapping *tmap;
    AstMapping *usemap;
    AstMapping *map;
+   AstPointSet *basegrid;
+   AstPointSet *basemesh;
    AstPointSet *ps1;
    AstPointSet *pst;
    AstPointSet *ps2;
@@ -5719,8 +6137,19 @@ static AstRegion *MapRegion( AstRegion *this, AstMapping *map0,
    }
 
 /* Since the Mapping has been changed, any cached information calculated
-   on the basis of the Mapping properties may no longer be up to date. */
-   astResetCache( result );
+   on the basis of the Mapping properties may no longer be up to date.
+   The base Frame mesh and grid do not depend on the Mapping for some
+   classes of Region, so in these cases retain them rather than
+   re-creating them when next needed. */
+   if( astOK && astRegFixedMesh( result ) ) {
+      basemesh = result->basemesh ? astClone( result->basemesh ) : NULL;
+      basegrid = result->basegrid ? astClone( result->basegrid ) : NULL;
+      astResetCache( result );
+      result->basemesh = basemesh;
+      result->basegrid = basegrid;
+   } else {
+      astResetCache( result );
+   }
 
 /* Free resources */
    usemap = astAnnul( usemap );
@@ -5902,6 +6331,11 @@ f        BADVAL
 *     reason.
 *     - An error will be reported if the overlap of the Region and
 *     the array cannot be determined.
+*     - Large arrays are divided into sections along the last pixel
+*     axis, which are masked concurrently by several threads if the
+*     "Threads" tuning parameter is greater than one (see
+c     astTune).
+f     AST_TUNE).
 
 *  Data Type Codes:
 *     To select the appropriate masking function, you should
@@ -5963,6 +6397,58 @@ f     AST_MASK<X> becomes AST_MASK8<X>.
 /* Define a macro to implement the function for a specific data
    type. */
 #define MAKE_MASK(X,Xtype) \
+static AstDim MaskSection##X( AstRegion *this, AstFrame *frm, AstDim lo, \
+                              AstDim hi, void *data, int *status ) { \
+\
+/* Local Variables: */ \
+   AstDim *lbnds;                /* Lower grid bounds of section */ \
+   AstDim *ubnds;                /* Upper grid bounds of section */ \
+   AstDim first;                 /* Index of first plane in section */ \
+   AstDim last;                  /* Index of last plane in section */ \
+   AstDim result;                /* Result value to return */ \
+   MaskData *mdata;              /* Description of the masking job */ \
+\
+/* Initialise. */ \
+   result = 0; \
+\
+/* Check the global error status. */ \
+   if ( !astOK ) return result; \
+\
+/* The supplied range is a range of pixel offsets into the bounding box. \
+   Mask each plane of the box (i.e. each pixel along the last axis) whose \
+   first pixel falls within this range. */ \
+   mdata = (MaskData *) data; \
+   first = ( lo + mdata->nplane - 1 )/mdata->nplane; \
+   last = ( hi + mdata->nplane - 1 )/mdata->nplane - 1; \
+   if( first <= last ) { \
+      lbnds = astStore( NULL, mdata->lbndg, sizeof( AstDim )*(size_t) mdata->ndim ); \
+      ubnds = astStore( NULL, mdata->ubndg, sizeof( AstDim )*(size_t) mdata->ndim ); \
+      if( astOK ) { \
+         lbnds[ mdata->ndim - 1 ] = mdata->lbndg[ mdata->ndim - 1 ] + first; \
+         ubnds[ mdata->ndim - 1 ] = mdata->lbndg[ mdata->ndim - 1 ] + last; \
+\
+/* Use astResample to mask the section. The supplied Frame is either the \
+   Region to be used, or a copy of it that is locked by the current \
+   thread. Each output pixel is derived only from the input pixel at the \
+   same position, so sections can be processed concurrently. */ \
+         result = astResample8##X( (AstRegion *) frm, mdata->ndim, mdata->lbnd, \
+                                   mdata->ubnd, (Xtype *) mdata->in, NULL, \
+                                   AST__NEAREST, NULL, NULL, 0, 0.0, 100, \
+                                   *( (Xtype *) mdata->val ), mdata->ndim, \
+                                   mdata->lbnd, mdata->ubnd, lbnds, ubnds, \
+                                   (Xtype *) mdata->out, NULL ); \
+      } \
+      lbnds = astFree( lbnds ); \
+      ubnds = astFree( ubnds ); \
+   } \
+\
+/* If an error occurred, clear the returned result. */ \
+   if ( !astOK ) result = 0; \
+\
+/* Return the result. */ \
+   return result; \
+} \
+\
 static AstDim Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
                        const AstDim lbnd[], const AstDim ubnd[], \
                        Xtype in[], Xtype val, int *status ) { \
@@ -5975,7 +6461,9 @@ static AstDim Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
    AstDim npixg;                 /* Number of pixels in bounding box */ \
    AstDim result;                /* Result value to return */ \
    AstFrame *grid_frame;         /* Pointer to Frame describing grid coords */ \
+   AstRegion *tmp_region;        /* Copy of a frozen Region */ \
    AstRegion *used_region;       /* Pointer to Region to be used by astResample */ \
+   MaskData mdata;               /* Description of the masking job */ \
    Xtype *c;                     /* Pointer to next array element */ \
    Xtype *d;                     /* Pointer to next array element */ \
    Xtype *out;                   /* Pointer to the array used for resample output */ \
@@ -6138,15 +6626,31 @@ static AstDim Mask##X( AstRegion *this, AstMapping *map, int inside, int ndim, \
    leave interior points unchanged and assign AST__BAD to exterior points. \
    This is the opposite of what we want (which is to leave exterior \
    points unchanged and assign VAL to interior points), so we negate the \
-   region if the inside is to be assigned the value VAL.*/ \
+   region if the inside is to be assigned the value VAL. A frozen Region \
+   cannot be changed, so a copy is used in that case. */ \
+         if( inside && astGetFrozen( used_region ) ) { \
+            tmp_region = astCopy( used_region ); \
+            (void) astAnnul( used_region ); \
+            used_region = tmp_region; \
+         } \
          if( inside ) astNegate( used_region ); \
 \
 /* Invoke astResample to mask just the region inside the bounding box found \
    above (specified by lbndg and ubndg), since all the points outside this \
-   box will already contain their required value. */ \
-         result += astResample8##X( used_region, ndim, lbnd, ubnd, in, NULL, AST__NEAREST, \
-                                    NULL, NULL, 0, 0.0, 100, val, ndim, \
-                                    lbnd, ubnd, lbndg, ubndg, out, NULL ); \
+   box will already contain their required value. The box is divided into \
+   sections along the last axis, which may be masked concurrently by \
+   several threads, each using its own copy of the Region. */ \
+         mdata.ndim = ndim; \
+         mdata.lbnd = lbnd; \
+         mdata.ubnd = ubnd; \
+         mdata.lbndg = lbndg; \
+         mdata.ubndg = ubndg; \
+         mdata.nplane = npixg/( ubndg[ ndim - 1 ] - lbndg[ ndim - 1 ] + 1 ); \
+         mdata.in = in; \
+         mdata.out = out; \
+         mdata.val = &val; \
+         result += astRegParallel( used_region, (AstFrame *) used_region, \
+                                   npixg, MaskSection##X, &mdata ); \
 \
 /* Revert to the original setting of the Negated attribute. */ \
          if( inside ) astNegate( used_region ); \
@@ -7071,7 +7575,13 @@ static int OverlapX( AstRegion *that, AstRegion *this, int *status ){
       return 5;
 
 /* Return 6 if the two Regions are equal using the Equal method after
-   temporarily negating the first. */
+   temporarily negating the first. A frozen Region cannot be changed, so
+   use a negated copy instead in that case. */
+   } else if( astGetFrozen( this ) ) {
+      reg1 = astGetNegation( this );
+      result = astEqual( reg1, that );
+      reg1 = astAnnul( reg1 );
+      if( result ) return 6;
    } else {
       astNegate( this );
       result = astEqual( this, that );
@@ -7087,6 +7597,15 @@ static int OverlapX( AstRegion *that, AstRegion *this, int *status ){
    cmap = astGetMapping( fs0, AST__BASE, AST__CURRENT );
    fs0 = astAnnul( fs0 );
 
+/* If both Regions have simple analytic shapes (ellipses or convex
+   polygons) that are related by a linear Mapping, determine the overlap
+   exactly, without needing to sample the boundaries. */
+   result = ShapeOverlap( this, that, cmap, status );
+   if( result ) {
+      cmap = astAnnul( cmap );
+      return result;
+   }
+
 /* First test the circumference of "that" to see if it falls within
    "this". We may need to try again with the above selection swapped. */
    lbnd = NULL;
@@ -7849,76 +8368,568 @@ f    - .FALSE. will be returned if an error occurs.
    return result;
 }
 
-static void RegBaseBox( AstRegion *this, double *lbnd, double *ubnd, int *status ){
+static AstDim PointsInRegion( AstRegion *this, AstDim npoint, int ncoord,
+                              AstDim indim, const double *in, int flags,
+                              unsigned char *mask, int *status ){
 /*
-*+
+*++
 *  Name:
-*     astRegBaseBox
+c     astPointsInRegion
+f     AST_POINTSINREGION
 
 *  Purpose:
-*     Returns the bounding box of an un-negated Region in the base Frame of
-*     the encapsulated FrameSet.
+*     Tests if each of a set of points is inside a Region.
 
 *  Type:
-*     Protected function.
+*     Public virtual function.
 
 *  Synopsis:
-*     #include "region.h"
-*     void astRegBaseBox( AstRegion *this, double *lbnd, double *ubnd )
+c     #include "region.h"
+c     AstDim astPointsInRegion( AstRegion *this, AstDim npoint, int ncoord,
+c                               AstDim indim, const double *in, int flags,
+c                               unsigned char *mask )
+f     RESULT = AST_POINTSINREGION( THIS, NPOINT, NCOORD, INDIM, IN, FLAGS,
+f                                  MASK, STATUS )
 
 *  Class Membership:
-*     Region virtual function.
+*     Region method.
 
 *  Description:
-*     This function returns the upper and lower axis bounds of a Region in
-*     the base Frame of the encapsulated FrameSet, assuming the Region
-*     has not been negated. That is, the value of the Negated attribute
-*     is ignored.
+c     This function
+f     This routine
+*     tests each of a set of points to see if it is inside a supplied
+*     Region, and returns the results as a mask, together with the
+*     number of points found to be inside the Region.
+*
+*     It gives the same results as using the Region as a Mapping to
+*     transform the points (see
+c     astTranN)
+f     AST_TRANN)
+*     and checking the transformed positions for AST__BAD values, but
+*     it does not need to create and return a copy of the supplied axis
+*     values. Most classes of Region perform the test directly on the
+*     supplied axis values, and so this function should be preferred
+*     when large numbers of points need to be tested.
 
 *  Parameters:
-*     this
+c     this
+f     THIS = INTEGER (Given)
 *        Pointer to the Region.
-*     lbnd
-*        Pointer to an array in which to return the lower axis bounds
-*        covered by the Region in the base Frame of the encapsulated
-*        FrameSet. It should have at least as many elements as there are
-*        axes in the base Frame.
-*     ubnd
-*        Pointer to an array in which to return the upper axis bounds
-*        covered by the Region in the base Frame of the encapsulated
-*        FrameSet. It should have at least as many elements as there are
-*        axes in the base Frame.
+c     npoint
+f     NPOINT = INTEGER (Given)
+*        The number of points to be tested.
+c     ncoord
+f     NCOORD = INTEGER (Given)
+*        The number of coordinates being supplied for each point. This
+*        must equal the number of axes in the Region.
+c     indim
+f     INDIM = INTEGER (Given)
+c        The number of elements along the second dimension of the "in"
+f        The number of elements along the first dimension of the IN
+*        array (which contains the coordinates of the points to be
+*        tested). If this is less than
+c        "npoint",
+f        NPOINT,
+*        an error will result. If the AST__INTERLEAVED flag is set, it
+*        is instead the number of elements between the first coordinate
+*        values of successive points, and an error will result if it is
+c        less than "ncoord".
+f        less than NCOORD.
+c     in
+f     IN( INDIM, NCOORD ) = DOUBLE PRECISION (Given)
+c        The address of the first element in a 2-dimensional array of
+c        shape "[ncoord][indim]", containing the coordinates of the
+c        points to be tested. These should be stored such that the value
+c        of coordinate number "coord" for point number "point" is found
+c        in element "in[coord][point]". If the AST__INTERLEAVED flag is
+c        set, the array should instead have shape "[npoint][indim]", and
+c        the value of coordinate number "coord" for point number "point"
+c        should be found in element "in[point][coord]".
+f        An array, each column of which contains the values of one
+f        coordinate for the points to be tested, so that the value of
+f        coordinate number COORD for point number POINT is found in
+f        element IN(POINT,COORD). If the AST__INTERLEAVED flag is set,
+f        the array should instead be declared as IN( INDIM, NPOINT ),
+f        and the value of coordinate number COORD for point number POINT
+f        should be found in element IN(COORD,POINT).
+c     flags
+f     FLAGS = INTEGER (Given)
+*        The bitwise OR of a set of flag values which control the
+*        operation of the function. These are chosen from:
+*
+*        - AST__INTERLEAVED: The coordinates of each point are stored
+*        together in the
+c        "in"
+f        IN
+*        array, rather than the values of each coordinate being stored
+*        together (see above).
+*        - AST__BYTEMASK: Return one mask element for each point, rather
+*        than packing the results for eight points into each element
+*        (see below).
+*
+*        Zero should be supplied if neither flag is required.
+c     mask
+f     MASK( * ) = BYTE (Returned)
+c        Pointer to an array in which the results are returned. By
+c        default, the array should have at least "(npoint+7)/8"
+c        elements. Each element holds the results for eight consecutive
+c        points, the point with zero-based index "point" being described
+c        by bit "point%8" (where bit 0 is the least significant bit) of
+c        element "point/8". A bit is set if the corresponding point is
+c        inside the Region, and is cleared otherwise. Any unused bits in
+c        the final element are cleared. If the AST__BYTEMASK flag is set,
+c        the array should instead have at least "npoint" elements, and
+c        element "point" is set to 1 if the point is inside the Region
+c        and 0 otherwise.
+f        An array in which the results are returned. By default, the
+f        array should have at least (NPOINT+7)/8 elements. Each element
+f        holds the results for eight consecutive points, the point with
+f        index POINT being described by bit MOD(POINT-1,8) (where bit 0
+f        is the least significant bit) of element (POINT+7)/8. A bit is
+f        set if the corresponding point is inside the Region, and is
+f        cleared otherwise. Any unused bits in the final element are
+f        cleared. If the AST__BYTEMASK flag is set, the array should
+f        instead have at least NPOINT elements, and element POINT is set
+f        to 1 if the point is inside the Region and 0 otherwise.
+f     STATUS = INTEGER (Given and Returned)
+f        The global status.
 
-*-
+*  Returned Value:
+c     astPointsInRegion()
+f     AST_POINTSINREGION = INTEGER
+*        The number of points found to be inside the Region.
+
+*  Notes:
+*    - A point is always considered to be outside the Region if any of
+*    its axis values are AST__BAD.
+*    - The test makes use of the Negated and Closed attributes of the
+*    Region in exactly the same way as the
+c    astTran<X>
+f    AST_TRAN<X>
+*    functions.
+*    - Points supplied using the AST__INTERLEAVED flag are copied in
+*    blocks of several thousand points before being tested, and so the
+*    default storage order is slightly faster.
+*    - Zero will be returned if an error occurs.
+
+f  Handling of Huge Pixel Arrays:
+f     If the number of points to be tested exceeds the largest value that
+f     can be represented by a 4-byte integer, then the alternative "8-byte"
+f     interface for this function should be used. This alternative interface
+f     uses 8 byte integer arguments (instead of 4-byte). Specifically, the
+f     arguments NPOINT and INDIM are changed from type INTEGER to type
+f     INTEGER*8, as is the returned value. The function name is changed by
+f     appending the digit "8" to the name. Thus, AST_POINTSINREGION
+f     becomes AST_POINTSINREGION8. The C interface uses AstDim (a 64-bit
+f     integer type) for these arguments, and so has no "8-byte" variant.
+
+*--
 */
 
-/* Check the inherited status. */
-   if( !astOK ) return;
+/* Local Variables: */
+   AstDim hi;                    /* Index of first point after block */
+   AstDim ipoint;                /* Point index */
+   AstDim lo;                    /* Index of first point in block */
+   AstDim nblock;                /* No. of points in first block */
+   AstPointSet *pset;            /* PointSet describing the supplied points */
+   AstDim result;                /* Returned number of inside points */
+   const double **ptr;           /* Pointers to supplied axis values */
+   const double *pin;            /* Pointer to next supplied axis value */
+   double *buf;                  /* Buffer for de-interleaved axis values */
+   int coord;                    /* Axis index */
+   int naxes;                    /* Number of axes in the Region */
+   unsigned char *bits;          /* Packed bit mask */
 
-/* This abstract implementation simply reports an error. All sub-classes of
-   Region should over-ride this to return appropriate values. */
-   astError( AST__NOIMP, "astRegBaseBox(%s): The %s class does not implement "
-             "the astRegBaseBox method inherited from the Region class "
-             "(internal AST programming error).", status, astGetClass( this ),
-             astGetClass( this ) );
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Validate the numbers of points and coordinates, and the input array
+   dimension. */
+   naxes = astGetNaxes( this );
+   if( ncoord != naxes && astOK ) {
+      astError( AST__NCPIN, "astPointsInRegion(%s): Bad number of coordinate "
+                "values (%d).", status, astGetClass( this ), ncoord );
+      astError( AST__NCPIN, "The %s given requires %d coordinate value(s) "
+                "for each point.", status, astGetClass( this ), naxes );
+   }
+
+   if( npoint < 0 && astOK ) {
+      astError( AST__NPTIN, "astPointsInRegion(%s): Number of points to be "
+                "tested (%" AST__DIMFMT ") is invalid.", status,
+                astGetClass( this ), npoint );
+      astError( AST__NPTIN, "This number should not be negative." , status);
+   }
+
+   if( flags & AST__INTERLEAVED ) {
+      if ( indim < ncoord && astOK ) {
+         astError( AST__DIMIN, "astPointsInRegion(%s): The input array "
+                   "dimension value (%" AST__DIMFMT ") is invalid.", status,
+                   astGetClass( this ), indim );
+         astError( AST__DIMIN, "This should not be less than the number of "
+                   "coordinates for each point (%d).", status, ncoord );
+      }
+
+   } else if ( indim < npoint && astOK ) {
+      astError( AST__DIMIN, "astPointsInRegion(%s): The input array "
+                "dimension value (%" AST__DIMFMT ") is invalid.", status,
+                astGetClass( this ), indim );
+      astError( AST__DIMIN, "This should not be less than the number of "
+                "points being tested (%" AST__DIMFMT ").", status, npoint );
+   }
+
+/* Nothing to do if no points were supplied. */
+   if( npoint == 0 || !astOK ) return result;
+
+/* If a byte mask is required, get workspace to hold the packed bit mask
+   created by astRegPointsIn. Otherwise, use the supplied array. */
+   if( flags & AST__BYTEMASK ) {
+      bits = astMalloc( (size_t)( ( npoint + 7 )/8 ) );
+   } else {
+      bits = mask;
+   }
+
+/* Get space for pointers to the start of each axis. */
+   ptr = astMalloc( sizeof( *ptr )*(size_t) ncoord );
+   buf = NULL;
+   if( astOK ) {
+
+/* If the coordinates of each point are stored together, the points are
+   tested in blocks. The axis values for each block are copied into a
+   buffer so that the values for each axis are stored together, as
+   required by a PointSet. The block size is a multiple of 8 so that each
+   block starts at the beginning of an element of the bit mask. */
+      if( flags & AST__INTERLEAVED ) {
+         nblock = ( npoint < PIR_BLOCK ) ? npoint : PIR_BLOCK;
+         buf = astMalloc( sizeof( *buf )*(size_t)( ncoord*nblock ) );
+         pset = astPointSet( nblock, ncoord, "", status );
+         for( lo = 0; lo < npoint && astOK; lo = hi ) {
+            hi = lo + nblock;
+            if( hi > npoint ) {
+               hi = npoint;
+               astSetNpoint( pset, hi - lo );
+            }
+
+            for( coord = 0; coord < ncoord; coord++ ) {
+               ptr[ coord ] = buf + coord*nblock;
+               pin = in + lo*indim + coord;
+               for( ipoint = 0; ipoint < hi - lo; ipoint++ ) {
+                  ( (double *) ptr[ coord ] )[ ipoint ] = *pin;
+                  pin += indim;
+               }
+            }
+
+/* Associate the buffer with the PointSet and test the points in the
+   block. */
+            astSetPoints( pset, (double **) ptr );
+            result += astRegPointsIn( this, pset, bits + lo/8 );
+         }
+         pset = astDelete( pset );
+
+/* Otherwise, set up pointers to the start of each axis within the
+   supplied array. */
+      } else {
+         for( coord = 0; coord < ncoord; coord++ ) {
+            ptr[ coord ] = in + coord*indim;
+         }
+
+/* Create a PointSet to describe the supplied points and associate the
+   supplied axis values with it (note we must explicitly remove the
+   "const" qualifier here, although they will not be modified). No copy
+   of the axis values is made. */
+         pset = astPointSet( npoint, ncoord, "", status );
+         astSetPoints( pset, (double **) ptr );
+
+/* Use the protected astRegPointsIn method to do the work. */
+         result = astRegPointsIn( this, pset, bits );
+
+/* Free resources. */
+         pset = astDelete( pset );
+      }
+
+/* If required, expand the packed bit mask into the returned byte mask. */
+      if( ( flags & AST__BYTEMASK ) && astOK ) {
+         for( ipoint = 0; ipoint < npoint; ipoint++ ) {
+            mask[ ipoint ] = ( bits[ ipoint/8 ] >> ( ipoint%8 ) ) & 1;
+         }
+      }
+   }
+
+/* Free resources. */
+   buf = astFree( buf );
+   ptr = astFree( (void *) ptr );
+   if( bits != mask ) bits = astFree( bits );
+
+/* Return zero if an error occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
 }
 
-static void RegBaseBox2( AstRegion *this, double *lbnd, double *ubnd, int *status ){
+static double PolyDist( const double *vert, int nvert, double x, double y,
+                        int exact, int *status ){
 /*
-*+
 *  Name:
-*     astRegBaseBox2
+*     PolyDist
 
 *  Purpose:
-*     Returns the bounding box of an un-negated Region in the base Frame of
-*     the encapsulated FrameSet.
+*     Find the signed distance from a point to a convex polygon.
 
 *  Type:
-*     Protected function.
+*     Private function.
 
 *  Synopsis:
 *     #include "region.h"
-*     void astRegBaseBox2( AstRegion *this, double *lbnd, double *ubnd )
+*     double PolyDist( const double *vert, int nvert, double x, double y,
+*                      int exact, int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function returns the largest of the signed distances from the
+*     supplied point to the lines containing each edge of the supplied
+*     convex polygon. Distances are positive on the outside of each edge.
+*     The returned value is thus negative if the point is inside the
+*     polygon, in which case its absolute value is the distance to the
+*     nearest edge.
+*
+*     For points outside the polygon, the returned value is a lower limit
+*     on the distance to the polygon. If "exact" is non-zero, the exact
+*     distance to the nearest point on the polygon is returned instead.
+
+*  Parameters:
+*     vert
+*        Pointer to an array holding the vertex coordinates, in
+*        anti-clockwise order. All the X values are stored first,
+*        followed by all the Y values.
+*     nvert
+*        The number of vertices.
+*     x
+*        The X coordinate of the point.
+*     y
+*        The Y coordinate of the point.
+*     exact
+*        Should the exact distance be returned for external points?
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The signed distance.
+
+*/
+
+/* Local Variables: */
+   const double *vx;         /* Pointer to vertex X values */
+   const double *vy;         /* Pointer to vertex Y values */
+   double d;                 /* Distance to current edge */
+   double dx;                /* X increment along edge */
+   double dy;                /* Y increment along edge */
+   double len2;              /* Squared length of edge */
+   double result;            /* Returned value */
+   double t;                 /* Fractional position along edge */
+   int i;                    /* Index of vertex at start of edge */
+   int j;                    /* Index of vertex at end of edge */
+
+/* Check the global error status. */
+   if( !astOK ) return 0.0;
+
+   vx = vert;
+   vy = vert + nvert;
+
+/* Find the largest signed distance to any edge line. */
+   result = -DBL_MAX;
+   for( i = 0; i < nvert; i++ ) {
+      j = ( i + 1 ) % nvert;
+      dx = vx[ j ] - vx[ i ];
+      dy = vy[ j ] - vy[ i ];
+      len2 = dx*dx + dy*dy;
+      if( len2 > 0.0 ) {
+         d = ( ( x - vx[ i ] )*dy - ( y - vy[ i ] )*dx )/sqrt( len2 );
+         if( d > result ) result = d;
+      }
+   }
+
+/* If required, find the exact distance from an external point to the
+   nearest point on any edge. */
+   if( exact && result > 0.0 ) {
+      result = DBL_MAX;
+      for( i = 0; i < nvert; i++ ) {
+         j = ( i + 1 ) % nvert;
+         dx = vx[ j ] - vx[ i ];
+         dy = vy[ j ] - vy[ i ];
+         len2 = dx*dx + dy*dy;
+         t = ( len2 > 0.0 ) ? ( ( x - vx[ i ] )*dx + ( y - vy[ i ] )*dy )/len2 : 0.0;
+         if( t < 0.0 ) {
+            t = 0.0;
+         } else if( t > 1.0 ) {
+            t = 1.0;
+         }
+         d = sqrt( ( vx[ i ] + t*dx - x )*( vx[ i ] + t*dx - x ) +
+                   ( vy[ i ] + t*dy - y )*( vy[ i ] + t*dy - y ) );
+         if( d < result ) result = d;
+      }
+   }
+
+   return result;
+}
+
+static void PrinAxes( const double matrix[4], double *s0, double *s1,
+                      double u0[2], int *status ){
+/*
+*  Name:
+*     PrinAxes
+
+*  Purpose:
+*     Find the principal axes of an ellipse.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     void PrinAxes( const double matrix[4], double *s0, double *s1,
+*                    double u0[2], int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function finds the half-lengths and orientation of the axes of
+*     the ellipse containing all points "M.u", where M is the supplied
+*     2x2 matrix and "u" is any vector of length less than or equal to
+*     one. These are the singular values and left singular vectors of M,
+*     found from the eigen-decomposition of M.M^T.
+
+*  Parameters:
+*     matrix
+*        The elements of M, in row order.
+*     s0
+*        Returned holding the half-length of the longer axis.
+*     s1
+*        Returned holding the half-length of the shorter axis. Zero is
+*        returned if the ellipse is degenerate.
+*     u0
+*        Returned holding a unit vector parallel to the longer axis. The
+*        shorter axis is parallel to (-u0[1],u0[0]).
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   double a;                 /* Orientation of the longer axis */
+   double det;               /* Determinant of M */
+   double p;                 /* Element [0][0] of M.M^T */
+   double q;                 /* Elements [0][1] and [1][0] of M.M^T */
+   double r;                 /* Element [1][1] of M.M^T */
+
+/* Initialise */
+   *s0 = 0.0;
+   *s1 = 0.0;
+   u0[ 0 ] = 1.0;
+   u0[ 1 ] = 0.0;
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Form the symmetric matrix M.M^T and find its larger eigenvalue. */
+   p = matrix[ 0 ]*matrix[ 0 ] + matrix[ 1 ]*matrix[ 1 ];
+   q = matrix[ 0 ]*matrix[ 2 ] + matrix[ 1 ]*matrix[ 3 ];
+   r = matrix[ 2 ]*matrix[ 2 ] + matrix[ 3 ]*matrix[ 3 ];
+   *s0 = sqrt( 0.5*( p + r ) + sqrt( 0.25*( p - r )*( p - r ) + q*q ) );
+
+/* The product of the two singular values equals the absolute determinant
+   of M. Using this to find the smaller singular value avoids the loss of
+   precision that would result from subtracting two nearly equal values
+   for a thin ellipse. */
+   if( *s0 > 0.0 ) {
+      det = matrix[ 0 ]*matrix[ 3 ] - matrix[ 1 ]*matrix[ 2 ];
+      *s1 = fabs( det )/( *s0 );
+      if( *s1 > *s0 ) *s1 = *s0;
+   }
+
+/* Find the orientation of the eigenvector corresponding to the larger
+   eigenvalue. This form remains accurate whichever diagonal element is
+   the larger, and when the ellipse is nearly circular. */
+   a = 0.5*atan2( 2.0*q, p - r );
+   u0[ 0 ] = cos( a );
+   u0[ 1 ] = sin( a );
+}
+
+static void RegBaseBox( AstRegion *this, double *lbnd, double *ubnd, int *status ){
+/*
+*+
+*  Name:
+*     astRegBaseBox
+
+*  Purpose:
+*     Returns the bounding box of an un-negated Region in the base Frame of
+*     the encapsulated FrameSet.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "region.h"
+*     void astRegBaseBox( AstRegion *this, double *lbnd, double *ubnd )
+
+*  Class Membership:
+*     Region virtual function.
+
+*  Description:
+*     This function returns the upper and lower axis bounds of a Region in
+*     the base Frame of the encapsulated FrameSet, assuming the Region
+*     has not been negated. That is, the value of the Negated attribute
+*     is ignored.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     lbnd
+*        Pointer to an array in which to return the lower axis bounds
+*        covered by the Region in the base Frame of the encapsulated
+*        FrameSet. It should have at least as many elements as there are
+*        axes in the base Frame.
+*     ubnd
+*        Pointer to an array in which to return the upper axis bounds
+*        covered by the Region in the base Frame of the encapsulated
+*        FrameSet. It should have at least as many elements as there are
+*        axes in the base Frame.
+
+*-
+*/
+
+/* Check the inherited status. */
+   if( !astOK ) return;
+
+/* This abstract implementation simply reports an error. All sub-classes of
+   Region should over-ride this to return appropriate values. */
+   astError( AST__NOIMP, "astRegBaseBox(%s): The %s class does not implement "
+             "the astRegBaseBox method inherited from the Region class "
+             "(internal AST programming error).", status, astGetClass( this ),
+             astGetClass( this ) );
+}
+
+static void RegBaseBox2( AstRegion *this, double *lbnd, double *ubnd, int *status ){
+/*
+*+
+*  Name:
+*     astRegBaseBox2
+
+*  Purpose:
+*     Returns the bounding box of an un-negated Region in the base Frame of
+*     the encapsulated FrameSet.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "region.h"
+*     void astRegBaseBox2( AstRegion *this, double *lbnd, double *ubnd )
 
 *  Class Membership:
 *     Region virtual function.
@@ -8873,6 +9884,52 @@ static int RegDummyFS( AstRegion *this, int *status ){
    return !strcmp( astGetIdent( this->frameset ), DUMMY_FS );
 }
 
+static int RegFixedMesh( AstRegion *this, int *status ){
+/*
+*+
+*  Name:
+*     astRegFixedMesh
+
+*  Purpose:
+*     Check if the base Frame meshes of a Region depend only on the
+*     base Frame.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int astRegFixedMesh( AstRegion *this )
+
+*  Class Membership:
+*     Region virtual function.
+
+*  Description:
+*     This function returns a non-zero value if the base Frame mesh and
+*     grid cached in the Region (see astRegBaseMesh and astRegBaseGrid)
+*     depend only on the base Frame, the PointSet defining the Region and
+*     the attributes of the Region, and not on the Mapping to the current
+*     Frame. If so, the cached mesh and grid can be retained when a new
+*     Region is created by astMapRegion, rather than being re-created.
+*
+*     The Region class implementation returns zero, since the default
+*     astRegBaseMesh method creates the mesh in the current Frame.
+*     Sub-classes that create their meshes directly in the base Frame
+*     should over-ride this method to return a non-zero value.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+
+*  Returned Value:
+*     Non-zero if the cached base Frame mesh and grid can be retained
+*     when the current Frame of the Region is changed.
+
+*-
+*/
+   return 0;
+}
+
 static int RegPins( AstRegion *this, AstPointSet *pset, AstRegion *unc,
                     int **mask, int *status ){
 /*
@@ -8942,6 +9999,127 @@ static int RegPins( AstRegion *this, AstPointSet *pset, AstRegion *unc,
    return 0;
 }
 
+static AstDim RegPointsIn( AstRegion *this, AstPointSet *pset,
+                           unsigned char *mask, int *status ){
+/*
+*+
+*  Name:
+*     astRegPointsIn
+
+*  Purpose:
+*     Test if each of a set of points is inside a Region.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "region.h"
+*     AstDim astRegPointsIn( AstRegion *this, AstPointSet *pset,
+*                            unsigned char *mask )
+
+*  Class Membership:
+*     Region virtual function.
+
+*  Description:
+*     This function tests each point in the supplied PointSet to see if
+*     it is inside the Region, and sets the corresponding bit in the
+*     supplied packed bit mask. It is the protected equivalent of
+*     astPointsInRegion.
+*
+*     This default implementation uses the Region as a Mapping to
+*     transform the supplied points, and then checks the transformed
+*     positions for bad axis values. Sub-classes should over-ride it with
+*     a direct test if possible, so that no transformed copy of the
+*     points needs to be created.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     pset
+*        Pointer to the PointSet holding the points to be tested. These
+*        should be in the current Frame of the Region's encapsulated
+*        FrameSet (i.e. the Frame represented by the Region). The
+*        contents of the PointSet are not changed.
+*     mask
+*        Pointer to an array with at least "(npoint+7)/8" elements (where
+*        "npoint" is the number of points in "pset"), in which to return
+*        the results. The point with zero-based index "i" is described by
+*        bit "i%8" (bit 0 being the least significant) in element "i/8".
+*        A bit is set if the point is inside the Region and cleared
+*        otherwise. All bits in the used elements of the array are
+*        assigned a value. A point that has a bad value on any axis is
+*        always considered to be outside the Region.
+
+*  Returned Value:
+*     The number of points that are inside the Region.
+
+*  Notes:
+*     - Zero will be returned if an error occurs.
+*-
+*/
+
+/* Local Variables: */
+   AstDim npoint;                /* Number of points */
+   AstDim point;                 /* Point index */
+   AstDim result;                /* Returned number of inside points */
+   AstPointSet *pset_out;        /* Transformed points */
+   double **ptr_in;              /* Pointers to supplied axis values */
+   double **ptr_out;             /* Pointers to transformed axis values */
+   int good;                     /* Are all supplied axis values good? */
+   int coord;                    /* Axis index */
+   int ncoord;                   /* Number of axes */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Clear the returned mask. */
+   npoint = astGetNpoint( pset );
+   ncoord = astGetNcoord( pset );
+   memset( mask, 0, ( (size_t) npoint + 7 )/8 );
+
+/* Use the Region to transform the supplied points. Points outside the
+   Region will be returned with bad values on all axes. */
+   pset_out = astTransform( this, pset, 1, NULL );
+   ptr_in = astGetPoints( pset );
+   ptr_out = astGetPoints( pset_out );
+
+/* A point is inside the Region if all its supplied axis values are good
+   and at least one of its transformed axis values is good. */
+   if( astOK ) {
+      for( point = 0; point < npoint; point++ ) {
+         good = 1;
+         for( coord = 0; coord < ncoord; coord++ ) {
+            if( ptr_in[ coord ][ point ] == AST__BAD ) {
+               good = 0;
+               break;
+            }
+         }
+
+         if( good ) {
+            for( coord = 0; coord < ncoord; coord++ ) {
+               if( ptr_out[ coord ][ point ] != AST__BAD ) {
+                  mask[ point/8 ] |= (unsigned char)( 1 << ( point % 8 ) );
+                  result++;
+                  break;
+               }
+            }
+         }
+      }
+   }
+
+/* Free resources. */
+   pset_out = astAnnul( pset_out );
+
+/* Return zero if an error occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static void GetRegionBounds( AstRegion *this, double *lbnd, double *ubnd, int *status ){
 /*
 *++
@@ -10202,6 +11380,87 @@ static void ReportPoints( AstMapping *this_mapping, int forward,
 
 }
 
+static int RegShape( AstRegion *this, double centre[2], double matrix[4],
+                     double **vert, int *nvert, int *status ){
+/*
+*+
+*  Name:
+*     astRegShape
+
+*  Purpose:
+*     Return an analytic description of a 2-dimensional convex Region.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int astRegShape( AstRegion *this, double centre[2], double matrix[4],
+*                      double **vert, int *nvert )
+
+*  Class Membership:
+*     Region method.
+
+*  Description:
+*     This function returns an exact analytic description of the area
+*     covered by a Region within the base Frame of its encapsulated
+*     FrameSet, if the Region can be described as either an ellipse or a
+*     convex polygon. It is used by astOverlap to determine the overlap
+*     between two such Regions analytically, without needing to sample
+*     their boundaries.
+*
+*     The description takes account of the Negated attribute of the
+*     Region, but ignores the Closed attribute. It assumes the base
+*     Frame is a 2-dimensional Cartesian Frame - it is the responsibility
+*     of the caller to check this.
+
+*  Parameters:
+*     this
+*        Pointer to the Region.
+*     centre
+*        If AST__ELLSHAPE is returned, this array is returned holding the
+*        base Frame coordinates of the centre of the ellipse. Not used
+*        otherwise.
+*     matrix
+*        If AST__ELLSHAPE is returned, this array is returned holding the
+*        elements (in row order) of a 2x2 matrix M such that the ellipse
+*        contains all points "centre + M.u" where "u" is any vector of
+*        length less than or equal to one. So the columns of M are the
+*        vectors from the centre of the ellipse to the end of each of its
+*        two axes. Not used otherwise.
+*     vert
+*        If AST__POLYSHAPE is returned, *vert is returned holding a pointer
+*        to a newly allocated array holding the base Frame coordinates of
+*        the vertices of the polygon. All the X values are stored first,
+*        followed by all the Y values. The vertices may be in clockwise or
+*        anti-clockwise order. The array should be freed using astFree
+*        when no longer needed. Returned holding NULL otherwise.
+*     nvert
+*        If AST__POLYSHAPE is returned, *nvert is returned holding the
+*        number of vertices in the polygon. Returned holding zero otherwise.
+
+*  Returned Value:
+*     One of:
+*
+*     - AST__ELLSHAPE: The Region is an ellipse (or circle).
+*     - AST__POLYSHAPE: The Region is a convex polygon.
+*     - AST__NOSHAPE: The Region cannot be described in either of these ways.
+
+*  Notes:
+*     - AST__NOSHAPE will be returned if this function is invoked with the
+*     AST error status set, or if it should fail for any reason.
+*-
+*/
+
+/* Initialise */
+   *vert = NULL;
+   *nvert = 0;
+
+/* This implementation is used by classes that have no simple analytic
+   description. Classes that do should over-ride it. */
+   return AST__NOSHAPE;
+}
+
 static void ResetCache( AstRegion *this, int *status ){
 /*
 *+
@@ -10574,6 +11833,8 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
                MATCH( "nobject" ) ||
                MATCH( "bounded" ) ||
                MATCH( "nout" ) ||
+               MATCH( "objshared" ) ||
+               MATCH( "objsize" ) ||
                MATCH( "refcount" ) ||
                MATCH( "tranforward" ) ||
                MATCH( "traninverse" ) ) {
@@ -10907,6 +12168,448 @@ f        The global status.
 
 }
 
+static int ShapeOverlap( AstRegion *this, AstRegion *that, AstMapping *cmap,
+                         int *status ){
+/*
+*  Name:
+*     ShapeOverlap
+
+*  Purpose:
+*     Test if two regions overlap each other using their analytic shapes.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     int ShapeOverlap( AstRegion *this, AstRegion *that, AstMapping *cmap,
+*                       int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function attempts to determine the overlap between two Regions
+*     exactly, using the analytic descriptions of their shapes returned by
+*     the astRegShape method. This is possible if both Regions are
+*     ellipses or convex polygons defined within 2-dimensional Cartesian
+*     Frames, and the Mapping between their base Frames is linear. In
+*     all other cases, or if the Regions touch each other to within their
+*     combined uncertainty, zero is returned, and the caller should use
+*     a more general method.
+*
+*     Pairs of convex polygons are tested using the separating axis
+*     theorem. An ellipse is compared with another shape by first
+*     transforming both shapes linearly so that the ellipse becomes a
+*     unit circle. The polygon is then tested using point-to-edge
+*     distances, and the other ellipse is tested using its nearest and
+*     furthest distances from the origin.
+
+*  Parameters:
+*     this
+*        Pointer to the first Region.
+*     that
+*        Pointer to the second Region.
+*     cmap
+*        Pointer to the Mapping from the current Frame of "that" to the
+*        current Frame of "this".
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A value indicating if there is any overlap between the two Regions,
+*     as described for astOverlap (but values 5 and 6 are never returned).
+*     Zero is returned if the overlap cannot be determined.
+
+*/
+
+/* Local Variables: */
+   AstFrame *bfrm1;          /* Base Frame of "this" */
+   AstFrame *bfrm2;          /* Base Frame of "that" */
+   AstMapping *map1;         /* Base->current Mapping for "that" */
+   AstMapping *map2;         /* Current->base Mapping for "this" */
+   AstMapping *map;          /* "that" base -> "this" base Mapping */
+   AstMapping *smap;         /* Simplified "map" */
+   AstMapping *tmap;         /* Temporary Mapping */
+   AstRegion *unc;           /* Uncertainty Region */
+   double *vert1;            /* Vertices of first polygon */
+   double *vert2;            /* Vertices of second polygon */
+   double *vo;               /* Pointer to vertices of other polygon */
+   double *vx;               /* Pointer to vertex X values */
+   double *vy;               /* Pointer to vertex Y values */
+   double c[ 2 ];            /* Offset of first ellipse centre */
+   double cen1[ 2 ];         /* Centre of first ellipse */
+   double cen2[ 2 ];         /* Centre of second ellipse */
+   double d;                 /* A distance */
+   double det;               /* Determinant of 2x2 matrix */
+   double dmax;              /* Furthest distance from origin to ellipse */
+   double dmin;              /* Nearest distance from origin to ellipse */
+   double dx;                /* X increment along edge */
+   double dy;                /* Y increment along edge */
+   double fit[ 6 ];          /* Coefficients of linear Mapping */
+   double gmin;              /* Smallest gap between edge and vertices */
+   double lbnd[ 2 ];         /* Lower bounds of bounding box */
+   double len;               /* Length of edge */
+   double m[ 4 ];            /* First ellipse matrix in whitened coords */
+   double mat1[ 4 ];         /* Matrix describing first ellipse */
+   double mat2[ 4 ];         /* Matrix describing second ellipse */
+   double s0;                /* Length of longer ellipse half-axis */
+   double s1;                /* Length of shorter ellipse half-axis */
+   double sep;               /* Largest separation along any edge normal */
+   double tol;               /* Tolerance in "this" base Frame */
+   double toly;              /* Tolerance in whitened coords */
+   double u0[ 2 ];           /* Direction of longer ellipse axis */
+   double ubnd[ 2 ];         /* Upper bounds of bounding box */
+   double w1;                /* Uncertainty width for "this" */
+   double w2;                /* Uncertainty width for "that" */
+   double w[ 4 ];            /* Inverse of second ellipse matrix */
+   double x;                 /* Temporary X value */
+   double y0;                /* Origin coord on longer ellipse axis */
+   double y1;                /* Origin coord on shorter ellipse axis */
+   int gap;                  /* 1 = disjoint, -1 = overlap, 0 = unsure */
+   int i;                    /* Vertex index */
+   int in12;                 /* First Region is inside second? */
+   int in21;                 /* Second Region is inside first? */
+   int ipass;                /* Pass index */
+   int j;                    /* Index of next vertex */
+   int k;                    /* Vertex index */
+   int n1;                   /* No. of vertices in polygon with edges */
+   int n2;                   /* No. of vertices in other polygon */
+   int nv1;                  /* No. of vertices in first polygon */
+   int nv2;                  /* No. of vertices in second polygon */
+   int ok;                   /* Can the overlap be determined? */
+   int out12;                /* First Region extends outside second? */
+   int out21;                /* Second Region extends outside first? */
+   int result;               /* Returned value */
+   int shape1;               /* Shape of first Region */
+   int shape2;               /* Shape of second Region */
+   int tmp;                  /* Temporary storage for swapping flags */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if( !astOK ) return result;
+
+/* Both Regions must be defined within 2-dimensional Cartesian Frames
+   (i.e. basic Frames, not sub-classes such as SkyFrames in which
+   distances are not Euclidean). */
+   bfrm1 = astGetFrame( this->frameset, AST__BASE );
+   bfrm2 = astGetFrame( that->frameset, AST__BASE );
+   ok = ( astGetNaxes( bfrm1 ) == 2 && astGetNaxes( bfrm2 ) == 2 &&
+          !strcmp( astGetClass( bfrm1 ), "Frame" ) &&
+          !strcmp( astGetClass( bfrm2 ), "Frame" ) );
+   bfrm1 = astAnnul( bfrm1 );
+   bfrm2 = astAnnul( bfrm2 );
+   if( !ok || !astOK ) return result;
+
+/* Get analytic descriptions of both Regions within their own base
+   Frames. Return if either Region has no such description. */
+   vert2 = NULL;
+   nv2 = 0;
+   shape1 = astRegShape( this, cen1, mat1, &vert1, &nv1 );
+   shape2 = ( shape1 != AST__NOSHAPE ) ? astRegShape( that, cen2, mat2, &vert2, &nv2 ) : AST__NOSHAPE;
+   ok = ( shape1 != AST__NOSHAPE && shape2 != AST__NOSHAPE );
+
+/* Get the Mapping from the base Frame of "that" to the base Frame of
+   "this". */
+   if( ok && astOK ) {
+      map1 = astGetMapping( that->frameset, AST__BASE, AST__CURRENT );
+      map2 = astGetMapping( this->frameset, AST__CURRENT, AST__BASE );
+      tmap = (AstMapping *) astCmpMap( map1, cmap, 1, "", status );
+      map = (AstMapping *) astCmpMap( tmap, map2, 1, "", status );
+      smap = astSimplify( map );
+      map = astAnnul( map );
+      tmap = astAnnul( tmap );
+      map2 = astAnnul( map2 );
+      map1 = astAnnul( map1 );
+
+/* Get the width of the uncertainty Region for each Region, within its own
+   base Frame. */
+      unc = astGetUncFrm( this, AST__BASE );
+      astGetRegionBounds( unc, lbnd, ubnd );
+      w1 = astMAX( ubnd[ 0 ] - lbnd[ 0 ], ubnd[ 1 ] - lbnd[ 1 ] );
+      unc = astAnnul( unc );
+
+      unc = astGetUncFrm( that, AST__BASE );
+      astGetRegionBounds( unc, lbnd, ubnd );
+      w2 = astMAX( ubnd[ 0 ] - lbnd[ 0 ], ubnd[ 1 ] - lbnd[ 1 ] );
+      unc = astAnnul( unc );
+
+/* Get the coefficients of the Mapping, checking that it is linear to
+   well within the uncertainty of the first Region over the bounding box
+   of the second Region. */
+      if( astIsAUnitMap( smap ) ) {
+         fit[ 0 ] = 0.0;
+         fit[ 1 ] = 0.0;
+         fit[ 2 ] = 1.0;
+         fit[ 3 ] = 0.0;
+         fit[ 4 ] = 0.0;
+         fit[ 5 ] = 1.0;
+      } else {
+         astRegBaseBox( that, lbnd, ubnd );
+         ok = ( w1 > 0.0 && astLinearApprox( smap, lbnd, ubnd, 0.01*w1, fit ) );
+      }
+      smap = astAnnul( smap );
+
+/* Transform the shape of the second Region into the base Frame of the
+   first Region. The uncertainty width is scaled by the Frobenius norm of
+   the Mapping matrix, which is an upper limit on the scale factor. */
+      det = fit[ 2 ]*fit[ 5 ] - fit[ 3 ]*fit[ 4 ];
+      if( ok && det != 0.0 && astOK ) {
+         if( shape2 == AST__ELLSHAPE ) {
+            x = cen2[ 0 ];
+            cen2[ 0 ] = fit[ 0 ] + fit[ 2 ]*x + fit[ 3 ]*cen2[ 1 ];
+            cen2[ 1 ] = fit[ 1 ] + fit[ 4 ]*x + fit[ 5 ]*cen2[ 1 ];
+            m[ 0 ] = fit[ 2 ]*mat2[ 0 ] + fit[ 3 ]*mat2[ 2 ];
+            m[ 1 ] = fit[ 2 ]*mat2[ 1 ] + fit[ 3 ]*mat2[ 3 ];
+            m[ 2 ] = fit[ 4 ]*mat2[ 0 ] + fit[ 5 ]*mat2[ 2 ];
+            m[ 3 ] = fit[ 4 ]*mat2[ 1 ] + fit[ 5 ]*mat2[ 3 ];
+            for( i = 0; i < 4; i++ ) mat2[ i ] = m[ i ];
+         } else {
+            vx = vert2;
+            vy = vert2 + nv2;
+            for( i = 0; i < nv2; i++ ) {
+               if( vx[ i ] == AST__BAD || vy[ i ] == AST__BAD ) ok = 0;
+               x = vx[ i ];
+               vx[ i ] = fit[ 0 ] + fit[ 2 ]*x + fit[ 3 ]*vy[ i ];
+               vy[ i ] = fit[ 1 ] + fit[ 4 ]*x + fit[ 5 ]*vy[ i ];
+            }
+         }
+         w2 *= sqrt( fit[ 2 ]*fit[ 2 ] + fit[ 3 ]*fit[ 3 ] +
+                     fit[ 4 ]*fit[ 4 ] + fit[ 5 ]*fit[ 5 ] );
+
+/* Two features are considered to be coincident if they are closer than
+   the sum in quadrature of the two uncertainty widths. */
+         tol = sqrt( w1*w1 + w2*w2 );
+
+/* Polygons must be convex. This also ensures the vertices are in
+   anti-clockwise order. */
+         if( ok && shape1 == AST__POLYSHAPE ) ok = ConvexPoly( vert1, nv1, status );
+         if( ok && shape2 == AST__POLYSHAPE ) ok = ConvexPoly( vert2, nv2, status );
+      } else {
+         ok = 0;
+      }
+   }
+
+/* Each of the following branches sets "gap" to indicate if the Regions
+   are definitely separate (+1) or definitely overlap (-1), "in12" (or
+   "in21") if the first (or second) Region is definitely inside the
+   other Region, and "out12" (or "out21") if some part of the first (or
+   second) Region is definitely outside the other Region. Here,
+   "definitely" means "by more than the tolerance". */
+   gap = 0;
+   in12 = in21 = out12 = out21 = 0;
+
+/* First deal with two polygons. Check the vertices of each polygon
+   against the other polygon. */
+   if( ok && astOK && shape1 == AST__POLYSHAPE && shape2 == AST__POLYSHAPE ) {
+      in12 = 1;
+      for( i = 0; i < nv1; i++ ) {
+         d = PolyDist( vert2, nv2, vert1[ i ], vert1[ i + nv1 ], 0, status );
+         if( d >= -tol ) in12 = 0;
+         if( d > tol ) out12 = 1;
+      }
+
+      in21 = 1;
+      for( i = 0; i < nv2; i++ ) {
+         d = PolyDist( vert1, nv1, vert2[ i ], vert2[ i + nv2 ], 0, status );
+         if( d >= -tol ) in21 = 0;
+         if( d > tol ) out21 = 1;
+      }
+
+/* Use the separating axis theorem to determine if the polygons are
+   disjoint: two convex polygons are disjoint if and only if there is
+   an edge of one polygon that has all the vertices of the other polygon
+   on its outside. Find the largest separation along any edge normal. */
+      sep = -DBL_MAX;
+      for( ipass = 0; ipass < 2; ipass++ ) {
+         vx = ipass ? vert2 : vert1;
+         n1 = ipass ? nv2 : nv1;
+         vo = ipass ? vert1 : vert2;
+         n2 = ipass ? nv1 : nv2;
+         for( i = 0; i < n1; i++ ) {
+            j = ( i + 1 ) % n1;
+            dx = vx[ j ] - vx[ i ];
+            dy = vx[ j + n1 ] - vx[ i + n1 ];
+            len = sqrt( dx*dx + dy*dy );
+            if( len > 0.0 ) {
+               gmin = DBL_MAX;
+               for( k = 0; k < n2; k++ ) {
+                  d = ( ( vo[ k ] - vx[ i ] )*dy -
+                        ( vo[ k + n2 ] - vx[ i + n1 ] )*dx )/len;
+                  if( d < gmin ) gmin = d;
+               }
+               if( gmin > sep ) sep = gmin;
+            }
+         }
+      }
+      gap = ( sep > tol ) ? 1 : ( ( sep < -tol ) ? -1 : 0 );
+
+/* Now deal with two ellipses. Transform both linearly so that the second
+   ellipse becomes a unit circle centred on the origin. Distances in these
+   "whitened" coordinates are at most a factor 1/s1 larger than in the
+   original coordinates, where s1 is the shorter half-axis of the second
+   ellipse. */
+   } else if( ok && astOK && shape1 == AST__ELLSHAPE && shape2 == AST__ELLSHAPE ) {
+      PrinAxes( mat2, &s0, &s1, u0, status );
+      det = mat2[ 0 ]*mat2[ 3 ] - mat2[ 1 ]*mat2[ 2 ];
+      if( s1 > 0.0 && det != 0.0 ) {
+         toly = tol/s1;
+         w[ 0 ] = mat2[ 3 ]/det;
+         w[ 1 ] = -mat2[ 1 ]/det;
+         w[ 2 ] = -mat2[ 2 ]/det;
+         w[ 3 ] = mat2[ 0 ]/det;
+
+/* Get the centre and matrix for the first ellipse in whitened coords. */
+         c[ 0 ] = w[ 0 ]*( cen1[ 0 ] - cen2[ 0 ] ) + w[ 1 ]*( cen1[ 1 ] - cen2[ 1 ] );
+         c[ 1 ] = w[ 2 ]*( cen1[ 0 ] - cen2[ 0 ] ) + w[ 3 ]*( cen1[ 1 ] - cen2[ 1 ] );
+         m[ 0 ] = w[ 0 ]*mat1[ 0 ] + w[ 1 ]*mat1[ 2 ];
+         m[ 1 ] = w[ 0 ]*mat1[ 1 ] + w[ 1 ]*mat1[ 3 ];
+         m[ 2 ] = w[ 2 ]*mat1[ 0 ] + w[ 3 ]*mat1[ 2 ];
+         m[ 3 ] = w[ 2 ]*mat1[ 1 ] + w[ 3 ]*mat1[ 3 ];
+
+/* Find the axes of the first ellipse, and the position of the origin
+   (the centre of the unit circle) relative to the centre of the first
+   ellipse, measured along its axes. */
+         PrinAxes( m, &s0, &s1, u0, status );
+         if( s1 > 0.0 ) {
+            y0 = fabs( u0[ 0 ]*c[ 0 ] + u0[ 1 ]*c[ 1 ] );
+            y1 = fabs( u0[ 0 ]*c[ 1 ] - u0[ 1 ]*c[ 0 ] );
+
+/* Find the nearest and furthest distances from the origin to the
+   boundary of the first ellipse. The first ellipse is inside the unit
+   circle if its furthest point is within unit distance of the origin. */
+            dmin = EllipseDist( s0, s1, y0, y1, 0, status );
+            dmax = EllipseDist( s0, s1, y0, y1, 1, status );
+            in12 = ( dmax < 1.0 - toly );
+            out12 = ( dmax > 1.0 + toly );
+
+/* If the origin is inside the first ellipse, the ellipses overlap, and
+   the unit circle is inside the first ellipse if the nearest point on
+   the boundary is more than unit distance from the origin. */
+            if( ( y0/s0 )*( y0/s0 ) + ( y1/s1 )*( y1/s1 ) <= 1.0 ) {
+               gap = -1;
+               in21 = ( dmin > 1.0 + toly );
+               out21 = ( dmin < 1.0 - toly );
+
+/* Otherwise, the unit circle cannot be inside the first ellipse, and the
+   ellipses are separate if the nearest point on the boundary is more
+   than unit distance from the origin. */
+            } else {
+               out21 = 1;
+               gap = ( dmin > 1.0 + toly ) ? 1 : ( ( dmin < 1.0 - toly ) ? -1 : 0 );
+            }
+         } else {
+            ok = 0;
+         }
+      } else {
+         ok = 0;
+      }
+
+/* Now deal with an ellipse and a polygon. Swap them if necessary so that
+   the ellipse is the first Region, and then transform both linearly so
+   that the ellipse becomes a unit circle centred on the origin. */
+   } else if( ok && astOK ) {
+      if( shape1 == AST__ELLSHAPE ) {
+         for( i = 0; i < 2; i++ ) c[ i ] = cen1[ i ];
+         for( i = 0; i < 4; i++ ) m[ i ] = mat1[ i ];
+         vx = vert2;
+         n2 = nv2;
+      } else {
+         for( i = 0; i < 2; i++ ) c[ i ] = cen2[ i ];
+         for( i = 0; i < 4; i++ ) m[ i ] = mat2[ i ];
+         vx = vert1;
+         n2 = nv1;
+      }
+
+      PrinAxes( m, &s0, &s1, u0, status );
+      det = m[ 0 ]*m[ 3 ] - m[ 1 ]*m[ 2 ];
+      if( s1 > 0.0 && det != 0.0 ) {
+         toly = tol/s1;
+         w[ 0 ] = m[ 3 ]/det;
+         w[ 1 ] = -m[ 1 ]/det;
+         w[ 2 ] = -m[ 2 ]/det;
+         w[ 3 ] = m[ 0 ]/det;
+
+/* Transform the polygon vertices in place. The transformation may
+   include a reflection, so ensure the vertices are still anti-clockwise. */
+         vy = vx + n2;
+         for( i = 0; i < n2; i++ ) {
+            x = w[ 0 ]*( vx[ i ] - c[ 0 ] ) + w[ 1 ]*( vy[ i ] - c[ 1 ] );
+            vy[ i ] = w[ 2 ]*( vx[ i ] - c[ 0 ] ) + w[ 3 ]*( vy[ i ] - c[ 1 ] );
+            vx[ i ] = x;
+         }
+         (void) ConvexPoly( vx, n2, status );
+
+/* Check the vertices of the polygon against the unit circle. */
+         in21 = 1;
+         for( i = 0; i < n2; i++ ) {
+            d = sqrt( vx[ i ]*vx[ i ] + vy[ i ]*vy[ i ] );
+            if( d >= 1.0 - toly ) in21 = 0;
+            if( d > 1.0 + toly ) out21 = 1;
+         }
+
+/* Find the signed distance from the origin to the polygon. If the origin
+   is inside the polygon, the shapes overlap, and the unit circle is
+   inside the polygon if every edge is more than unit distance from the
+   origin. */
+         d = PolyDist( vx, n2, 0.0, 0.0, 1, status );
+         if( d <= 0.0 ) {
+            gap = -1;
+            in12 = ( -d > 1.0 + toly );
+            out12 = ( -d < 1.0 - toly );
+
+/* Otherwise, the circle cannot be inside the polygon, and the shapes are
+   separate if the nearest point on the polygon is more than unit
+   distance from the origin. */
+         } else {
+            out12 = 1;
+            gap = ( d > 1.0 + toly ) ? 1 : ( ( d < 1.0 - toly ) ? -1 : 0 );
+         }
+
+/* The above flags treat the ellipse as the first Region. Swap them if
+   the ellipse is actually the second Region. */
+         if( shape1 != AST__ELLSHAPE ) {
+            tmp = in12;
+            in12 = in21;
+            in21 = tmp;
+            tmp = out12;
+            out12 = out21;
+            out21 = tmp;
+         }
+      } else {
+         ok = 0;
+      }
+   }
+
+/* Form the returned value from the above flags. Return zero if the
+   Regions touch or nearly touch. */
+   if( ok && astOK ) {
+      if( gap == 1 ) {
+         result = 1;
+      } else if( gap == -1 ) {
+         if( in12 && !in21 ) {
+            result = 2;
+         } else if( in21 && !in12 ) {
+            result = 3;
+         } else if( out12 && out21 ) {
+            result = 4;
+         }
+      }
+   }
+
+/* Free resources. */
+   vert1 = astFree( vert1 );
+   vert2 = astFree( vert2 );
+
+/* Return zero if an error occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result. */
+   return result;
+}
+
 static void ShowMesh( AstRegion *this, int format, const char *ttl, int *status ){
 /*
 *++
@@ -11760,6 +13463,8 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
                !strcmp( attrib, "nobject" ) ||
                !strcmp( attrib, "bounded" ) ||
                !strcmp( attrib, "nout" ) ||
+               !strcmp( attrib, "objshared" ) ||
+               !strcmp( attrib, "objsize" ) ||
                !strcmp( attrib, "refcount" ) ||
                !strcmp( attrib, "tranforward" ) ||
                !strcmp( attrib, "traninverse" ) ) {
@@ -11919,6 +13624,215 @@ double *astRegTranPoint_( AstRegion *this, double *in, int np, int forward, int
    return result;
 }
 
+static void RegParallelChunk( int ithread, AstDim lo, AstDim hi, void *data,
+                              int *status ){
+/*
+*  Name:
+*     RegParallelChunk
+
+*  Purpose:
+*     Test a chunk of points on behalf of astRegParallel.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "region.h"
+*     void RegParallelChunk( int ithread, AstDim lo, AstDim hi, void *data,
+*                            int *status )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function is invoked by astParallelFor, within the calling
+*     thread or a worker thread, to test a chunk of points on behalf of
+*     astRegParallel. Worker threads lock their private copy of the Frame
+*     while the chunk is tested, and unlock it again afterwards (even if
+*     an error occurs) so that it can be used by other chunks and finally
+*     annulled by the calling thread.
+
+*  Parameters:
+*     ithread
+*        Zero for the calling thread, or the index of a worker thread.
+*     lo
+*        The index of the first point in the chunk.
+*     hi
+*        The index of the first point after the chunk.
+*     data
+*        Pointer to a RegParallelData structure.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstFrame *frm;                /* Frame used by this thread */
+   RegParallelData *rdata;       /* Description of the test */
+
+/* Check the global error status. */
+   if( !astOK ) return;
+
+/* Lock the Frame for use by this thread. */
+   rdata = (RegParallelData *) data;
+   frm = rdata->frames[ ithread ];
+   if( ithread > 0 && frm ) astManageLock( frm, AST__LOCK, 1, NULL );
+
+/* Test the points, accumulating the result for this thread. */
+   rdata->results[ ithread ] += (*rdata->fun)( rdata->this, frm, lo, hi,
+                                               rdata->data, status );
+
+/* Unlock the Frame. */
+   if( ithread > 0 && frm ) astManageLock( frm, AST__UNLOCK, 1, NULL );
+}
+
+AstDim astRegParallel_( AstRegion *this, AstFrame *frm, AstDim npoint,
+                        AstRegChunkFun fun, void *data, int *status ){
+/*
+*+
+*  Name:
+*     astRegParallel
+
+*  Purpose:
+*     Apply a point-testing function to a set of points using several
+*     threads.
+
+*  Type:
+*     Protected function.
+
+*  Synopsis:
+*     #include "region.h"
+*     AstDim astRegParallel( AstRegion *this, AstFrame *frm, AstDim npoint,
+*                            AstRegChunkFun fun, void *data )
+
+*  Class Membership:
+*     Region member function
+
+*  Description:
+*     This function divides the range of point indices [0,npoint) into
+*     contiguous chunks and invokes the supplied function once for each
+*     chunk. If the "Threads" tuning parameter (see astTune) is greater
+*     than one and enough points are supplied, the chunks are shared out
+*     between the calling thread and the library's pool of worker threads
+*     using astParallelFor. Otherwise, the supplied function is invoked
+*     once, in the calling thread, for the whole range.
+*
+*     The supplied function is invoked as:
+*
+*        n = fun( this, frm2, lo, hi, data, status )
+*
+*     and should process points "lo" to "hi-1" inclusive, returning the
+*     number of those points that are inside the Region. "frm2" is either
+*     "frm" itself or a private deep copy of "frm" that has been locked
+*     for exclusive use by the thread invoking "fun". "lo" is always a
+*     multiple of 8, so that each chunk may safely write to its own bytes
+*     within a packed bit mask.
+*
+*     Since worker threads do not have a lock on the Region, "fun" must
+*     not invoke any AST methods on the Region, or on any other Objects
+*     except "frm2". It may read cached data from the Region structure
+*     (which must therefore be up to date before this function is
+*     called), and may read and write the arrays described by "data", so
+*     long as it only writes to elements for points in the range
+*     [lo,hi).
+
+*  Parameters:
+*     this
+*        The Region pointer. This is passed on to "fun" but is not
+*        otherwise used.
+*     frm
+*        The Frame in which the points are to be tested (usually the base
+*        Frame of the Region). A deep copy of this Frame is made for
+*        each worker thread. May be NULL if "fun" does not need a Frame.
+*     npoint
+*        The total number of points to test.
+*     fun
+*        The function to invoke for each chunk of points.
+*     data
+*        A pointer that is passed on unchanged to "fun".
+
+*  Returned Value:
+*     The sum of the values returned by all invocations of "fun".
+
+*  Notes:
+*     - If any invocation of "fun" fails within a worker thread, the
+*     error is re-reported in the calling thread (see astParallelFor).
+*     - Threads are used only if AST was built with thread-safety
+*     enabled. Only one thread at a time may use the worker pool; calls
+*     made while the pool is busy process all points in the calling
+*     thread.
+*     - Zero is returned if an error has already occurred, or if this
+*     function should fail for any reason.
+
+*-
+*/
+
+/* Local Variables: */
+   AstDim result;                /* Returned value */
+   RegParallelData rdata;        /* Data passed to RegParallelChunk */
+   int i;                        /* Thread index */
+   int nthread;                  /* No. of threads to use */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK || npoint <= 0 ) return result;
+
+/* Decide how many threads (including the calling thread) to use. */
+   nthread = astParallelSize( npoint, CHUNK_POINTS );
+
+/* If more than one thread is to be used, create a deep copy of the Frame
+   for each worker thread, and unlock it so that the worker can lock it
+   for its own use. Element zero is used by the calling thread. Also
+   create an array to hold the sum of the values returned by "fun" within
+   each thread. */
+   if( nthread > 1 ) {
+      rdata.frames = astMalloc( sizeof( AstFrame * )*(size_t) nthread );
+      rdata.results = astCalloc( nthread, sizeof( AstDim ) );
+      if( astOK ) {
+         rdata.frames[ 0 ] = frm;
+         for( i = 1; i < nthread; i++ ) {
+            if( frm ) {
+               rdata.frames[ i ] = astCopy( frm );
+               astManageLock( rdata.frames[ i ], AST__UNLOCK, 1, NULL );
+            } else {
+               rdata.frames[ i ] = NULL;
+            }
+         }
+
+/* Share the points out between the threads, and sum the results. */
+         rdata.this = this;
+         rdata.fun = fun;
+         rdata.data = data;
+         astParallelFor( nthread, npoint, CHUNK_POINTS, RegParallelChunk,
+                         &rdata );
+         for( i = 0; i < nthread; i++ ) result += rdata.results[ i ];
+
+/* Re-lock and annul the Frame copies. */
+         for( i = 1; i < nthread; i++ ) {
+            if( rdata.frames[ i ] ) {
+               astManageLock( rdata.frames[ i ], AST__LOCK, 1, NULL );
+               rdata.frames[ i ] = astAnnul( rdata.frames[ i ] );
+            }
+         }
+      }
+      rdata.frames = astFree( rdata.frames );
+      rdata.results = astFree( rdata.results );
+
+/* If only one thread is being used, process all points in the calling
+   thread. */
+   } else {
+      result = (*fun)( this, frm, 0, npoint, data, status );
+   }
+
+/* Return zero if an error has occurred. */
+   if( !astOK ) result = 0;
+
+/* Return the result.*/
+   return result;
+}
+
 static AstPointSet *RegTransform( AstRegion *this, AstPointSet *in,
                                   int forward, AstPointSet *out, AstFrame **frm, int *status ) {
 /*
@@ -13646,7 +15560,7 @@ void astRegSetAttrib_( AstRegion *this, const char *setting, char **base_setting
    (**astMEMBER(this,Region,RegSetAttrib))( this, setting, base_setting, status );
 }
 void astNegate_( AstRegion *this, int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astNegate" ) ) return;
    (**astMEMBER(this,Region,Negate))( this, status );
 }
 AstFrame *astGetRegionFrame_( AstRegion *this, int *status ){
@@ -13702,6 +15616,10 @@ int astRegDummyFS_( AstRegion *this, int *status ){
    if ( !astOK ) return 0;
    return (**astMEMBER(this,Region,RegDummyFS))( this, status );
 }
+int astRegFixedMesh_( AstRegion *this, int *status ){
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Region,RegFixedMesh))( this, status );
+}
 int astGetBounded_( AstRegion *this, int *status ){
    if ( !astOK ) return 0;
    return (**astMEMBER(this,Region,GetBounded))( this, status );
@@ -13780,6 +15698,24 @@ int astPointInRegion_( AstRegion *this, const double *point, int *status ){
    if ( !astOK ) return 0;
    return (**astMEMBER(this,Region,PointInRegion))( this, point, status );
 }
+AstDim astPointsInRegion_( AstRegion *this, AstDim npoint, int ncoord,
+                           AstDim indim, const double *in, int flags,
+                           unsigned char *mask, int *status ){
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Region,PointsInRegion))( this, npoint, ncoord, indim, in, flags, mask, status );
+}
+AstDim astRegPointsIn_( AstRegion *this, AstPointSet *pset, unsigned char *mask,
+                        int *status ){
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Region,RegPointsIn))( this, pset, mask, status );
+}
+int astRegShape_( AstRegion *this, double centre[2], double matrix[4],
+                  double **vert, int *nvert, int *status ){
+   *vert = NULL;
+   *nvert = 0;
+   if ( !astOK ) return AST__NOSHAPE;
+   return (**astMEMBER(this,Region,RegShape))( this, centre, matrix, vert, nvert, status );
+}
 AstRegion *astGetNegation_( AstRegion *this, int *status ){
    if ( !astOK ) return NULL;
    return (**astMEMBER(this,Region,GetNegation))( this, status );
@@ -13797,7 +15733,7 @@ AstRegion *astGetUnc_( AstRegion *this, int def, int *status ){
    return (**astMEMBER(this,Region,GetUnc))( this, def, status );
 }
 void astSetUnc_( AstRegion *this, AstRegion *unc, int *status ){
-   if ( !astOK ) return;
+   if ( !astOK || astCheckFrozen( this, "astSetUnc" ) ) return;
    (**astMEMBER(this,Region,SetUnc))( this, unc, status );
 }
 AstFrameSet *astGetRegFS_( AstRegion *this, int *status ){
@@ -69,6 +69,17 @@
 
 /* Macros. */
 /* ======= */
+/* Flags used by the astPointsInRegion method. */
+#define AST__INTERLEAVED (1)     /* Axis values for each point stored together? */
+#define AST__BYTEMASK (2)        /* Return one mask element per point? */
+
+#if defined(astCLASS)            /* Protected */
+
+/* Values returned by the astRegShape method. */
+#define AST__NOSHAPE 0
+#define AST__ELLSHAPE 1
+#define AST__POLYSHAPE 2
+#endif
 
 /* Type Definitions. */
 /* ================= */
@@ -104,6 +115,12 @@ typedef struct AstRegion {
    struct AstRegion *negation;/* Negated copy of "this" */
 } AstRegion;
 
+/* Function used by astRegParallel to test a chunk of points. */
+#if defined(astCLASS)            /* Protected */
+typedef AstDim (* AstRegChunkFun)( AstRegion *, AstFrame *, AstDim, AstDim,
+                                   void *, int * );
+#endif
+
 /* Virtual function table. */
 /* ----------------------- */
 /* This table contains all information that is the same for all objects in the
@@ -121,6 +138,8 @@ typedef struct AstRegionVtab {
    int (* Overlap)( AstRegion *, AstRegion *, int * );
    int (* OverlapX)( AstRegion *, AstRegion *, int * );
    int (* PointInRegion)( AstRegion *, const double *, int * );
+   AstDim (* PointsInRegion)( AstRegion *, AstDim, int, AstDim, const double *, int, unsigned char *, int * );
+   AstDim (* RegPointsIn)( AstRegion *, AstPointSet *, unsigned char *, int * );
    AstRegion *(* MapRegion)( AstRegion *, AstMapping *, AstFrame *, int * );
    AstFrame *(* GetRegionFrame)( AstRegion *, int * );
    AstFrameSet *(* GetRegionFrameSet)( AstRegion *, int * );
@@ -144,7 +163,9 @@ typedef struct AstRegionVtab {
    int (* GetBounded)( AstRegion *, int * );
    int (* TestUnc)( AstRegion *, int * );
    int (* RegDummyFS)( AstRegion *, int * );
+   int (* RegFixedMesh)( AstRegion *, int * );
    int (* RegPins)( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+   int (* RegShape)( AstRegion *, double[2], double[4], double **, int *, int * );
    AstMapping *(* RegMapping)( AstRegion *, int * );
    AstPointSet *(* RegMesh)( AstRegion *, int * );
    AstPointSet *(* RegGrid)( AstRegion *, int * );
@@ -257,6 +278,7 @@ AstFrameSet *astGetRegionFrameSet_( AstRegion *, int * );
 int astOverlap_( AstRegion *, AstRegion *, int * );
 void astNegate_( AstRegion *, int * );
 int astPointInRegion_( AstRegion *, const double *, int * );
+AstDim astPointsInRegion_( AstRegion *, AstDim, int, AstDim, const double *, int, unsigned char *, int * );
 
 #if HAVE_LONG_DOUBLE     /* Not normally implemented */
 int astMask4LD_( AstRegion *, AstMapping *, int, int, const int[], const int[], long double [], long double, int * );
@@ -307,7 +329,9 @@ void astRegOverlay_( AstRegion *, AstRegion *, int, int * );
 int astGetBounded_( AstRegion *, int * );
 int astTestUnc_( AstRegion *, int * );
 int astRegDummyFS_( AstRegion *, int * );
+int astRegFixedMesh_( AstRegion *, int * );
 int astRegPins_( AstRegion *, AstPointSet *, AstRegion *, int **, int * );
+int astRegShape_( AstRegion *, double[2], double[4], double **, int *, int * );
 AstMapping *astRegMapping_( AstRegion *, int * );
 AstPointSet *astRegMesh_( AstRegion *, int * );
 AstPointSet *astRegGrid_( AstRegion *, int * );
@@ -324,6 +348,8 @@ AstFrameSet *astGetRegFS_( AstRegion *, int * );
 void astSetRegFS_( AstRegion *, AstFrame *, int * );
 double *astRegCentre_( AstRegion *, double *, double **, int, int, int * );
 double *astRegTranPoint_( AstRegion *, double *, int, int, int * );
+AstDim astRegPointsIn_( AstRegion *, AstPointSet *, unsigned char *, int * );
+AstDim astRegParallel_( AstRegion *, AstFrame *, AstDim, AstRegChunkFun, void *, int * );
 void astResetCache_( AstRegion *, int * );
 int astRegTrace_( AstRegion *, int, double *, double **, int * );
 
@@ -480,6 +506,8 @@ astINVOKE(V,astNegate_(astCheckRegion(this),STATUS_PTR))
 astINVOKE(V,astOverlap_(astCheckRegion(this),astCheckRegion(that),STATUS_PTR))
 #define astPointInRegion(this,point) \
 astINVOKE(V,astPointInRegion_(astCheckRegion(this),point,STATUS_PTR))
+#define astPointsInRegion(this,npoint,ncoord,indim,in,flags,mask) \
+astINVOKE(V,astPointsInRegion_(astCheckRegion(this),npoint,ncoord,indim,in,flags,mask,STATUS_PTR))
 #define astSetUnc(this,unc) astINVOKE(V,astSetUnc_(astCheckRegion(this),unc?astCheckRegion(unc):NULL,STATUS_PTR))
 #define astGetUnc(this,def) astINVOKE(O,astGetUnc_(astCheckRegion(this),def,STATUS_PTR))
 #define astGetRegionBounds(this,lbnd,ubnd) astINVOKE(V,astGetRegionBounds_(astCheckRegion(this),lbnd,ubnd,STATUS_PTR))
@@ -518,9 +546,13 @@ astINVOKE(V,astGetRegionPoints_(astCheckRegion(this),maxpoint,maxcoord,npoint,po
 #define astRegMesh(this) astINVOKE(O,astRegMesh_(astCheckRegion(this),STATUS_PTR))
 #define astRegOverlay(this,that,unc) astINVOKE(V,astRegOverlay_(astCheckRegion(this),astCheckRegion(that),unc,STATUS_PTR))
 #define astRegDummyFS(this) astINVOKE(V,astRegDummyFS_(astCheckRegion(this),STATUS_PTR))
+#define astRegFixedMesh(this) astINVOKE(V,astRegFixedMesh_(astCheckRegion(this),STATUS_PTR))
 #define astRegMapping(this) astINVOKE(O,astRegMapping_(astCheckRegion(this),STATUS_PTR))
 #define astRegPins(this,pset,unc,mask) astINVOKE(V,astRegPins_(astCheckRegion(this),astCheckPointSet(pset),unc?astCheckRegion(unc):unc,mask,STATUS_PTR))
+#define astRegShape(this,centre,matrix,vert,nvert) astINVOKE(V,astRegShape_(astCheckRegion(this),centre,matrix,vert,nvert,STATUS_PTR))
 #define astRegTranPoint(this,in,np,forward) astRegTranPoint_(this,in,np,forward,STATUS_PTR)
+#define astRegPointsIn(this,pset,mask) astINVOKE(V,astRegPointsIn_(astCheckRegion(this),astCheckPointSet(pset),mask,STATUS_PTR))
+#define astRegParallel(this,frm,npoint,fun,data) astINVOKE(V,astRegParallel_(astCheckRegion(this),(frm)?astCheckFrame(frm):NULL,npoint,fun,data,STATUS_PTR))
 #define astGetRegFS(this) astINVOKE(O,astGetRegFS_(astCheckRegion(this),STATUS_PTR))
 #define astSetRegFS(this,frm) astINVOKE(V,astSetRegFS_(astCheckRegion(this),astCheckFrame(frm),STATUS_PTR))
 #define astTestUnc(this) astINVOKE(V,astTestUnc_(astCheckRegion(this),STATUS_PTR))
@@ -73,6 +73,7 @@ f     The SelectorMap class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     15-MAR-2006 (DSB):
@@ -80,6 +81,8 @@ f     The SelectorMap class does not define any new routines beyond those
 *     18-MAY-2006 (DSB):
 *        - Change logic for detecting interior points in function Transform.
 *        - Added BADVAL to contructor argument list.
+*     18-OCT-2026 (AGT):
+*        Transform: Use copies of the Regions if the SelectorMap is frozen.
 *class--
 */
 
@@ -860,6 +863,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
    double badval;
    int bad;
    int closed;
+   int frozen;
    int icoord;
    int ipoint;
    int ireg;
@@ -869,8 +873,9 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* Check the global error status. */
    if ( !astOK ) return NULL;
 
-/* Obtain a pointer to the SelectorMap. */
+/* Obtain a pointer to the SelectorMap, and see if it is frozen. */
    map = (AstSelectorMap *) this;
+   frozen = astGetFrozen( this );
 
 /* Apply the parent Mapping using the stored pointer to the Transform member
    function inherited from the parent Mapping class. This function validates
@@ -917,6 +922,10 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
          for( ireg = 1; ireg <= map->nreg; ireg++ ) {
             reg = map->reg[ ireg - 1 ];
 
+/* A frozen Region cannot be changed, so use a copy of the Region if the
+   SelectorMap is frozen. */
+            reg = frozen ? astCopy( reg ) : astClone( reg );
+
 /* Temporarily Negate the Region. */
             astNegate( reg );
             closed = astGetClosed( reg );
@@ -940,6 +949,7 @@ static AstPointSet *Transform( AstMapping *this, AstPointSet *in,
 /* Negate the Region to get it back to its original state. */
             astSetClosed( reg, closed );
             astNegate( reg );
+            reg = astAnnul( reg );
 
 /* Swap the input and output PointSets. */
             tps = ps1;
@@ -96,6 +96,7 @@ f     - AST_SKYOFFSETMAP: Obtain a Mapping from absolute to offset coordinates
 *     RFWS: R.F. Warren-Smith (Starlink)
 *     DSB: David S. Berry (Starlink)
 *     BEC: Brad Cavanagh (JAC, Hawaii)
+*     AGT: Agent
 
 *  History:
 *     4-MAR-1996 (RFWS):
@@ -359,6 +360,15 @@ f     - AST_SKYOFFSETMAP: Obtain a Mapping from absolute to offset coordinates
 *         astLineCrossing now returns the distance from the line start to
 *         the crossing. This distance takes account of which half of the
 *         great circle contains the crossing.
+*     18-OCT-2026 (AGT):
+*         - GetLAST and GetDiurab do not cache values in a frozen SkyFrame.
+*         - Use astAttribKnown to pass attributes defined by parent classes
+*         directly to the parent GetAttrib, SetAttrib, TestAttrib and
+*         ClearAttrib methods.
+*         - In MakeSkyMapping, only get the LAST if the conversion involves
+*         AzEl. This avoids creating and using two TimeFrames when the
+*         first non-AzEl conversion is made.
+*         - Profile exact LAST calculations in CalcLAST.
 *class--
 */
 
@@ -882,6 +892,14 @@ static double piby2;
 static int nlast_tables = 0;
 static AstSkyLastTable **last_tables = NULL;
 
+/* The names of all the attributes defined by this class, in alphabetical
+   order (see astAttribKnown). */
+static const char *const attrib_names[] = {
+   "alignoffset", "astime", "equinox", "islataxis", "islonaxis", "lataxis",
+   "lonaxis", "neglon", "projection", "skyref", "skyrefis", "skyrefp",
+   "skytol"
+};
+#define NATTRIB ( (int) ( sizeof( attrib_names )/sizeof( attrib_names[ 0 ] ) ) )
 
 /* Define macros for accessing each item of thread specific global data. */
 #ifdef THREAD_SAFE
@@ -1268,6 +1286,7 @@ static double CalcLAST( AstSkyFrame *this, double epoch, double obslon,
 /* Local Variables: */
    astDECLARE_GLOBALS /* Declare the thread specific global data */
    AstFrameSet *fs;   /* Mapping from TDB offset to LAST offset */
+   AstProfileCall call; /* Profiling information */
    double epoch0;     /* Supplied epoch value */
    double result;     /* Returned LAST value */
 
@@ -1282,8 +1301,11 @@ static double CalcLAST( AstSkyFrame *this, double epoch, double obslon,
    result = GetCachedLAST( this, epoch, obslon, obslat, obsalt, dut1, dtai,
                            status );
 
-/* If not, we do an exact calculation from scratch. */
+/* If not, we do an exact calculation from scratch. Record the
+   calculation if profiling is enabled (see the "Profile" tuning
+   parameter). */
    if( result == AST__BAD ) {
+      astProfileStart( &call, "CalcLAST", this, 1.0 );
 
 /* If not yet done, create two TimeFrames. Note, this is done here
    rather than in astInitSkyFrameVtab in order to avoid infinite vtab
@@ -1342,6 +1364,7 @@ static double CalcLAST( AstSkyFrame *this, double epoch, double obslon,
 /* Cache the new LAST value in the SkyFrame virtual function table. */
       SetCachedLAST( this, result, epoch0, obslon, obslat, obsalt, dut1, dtai,
                      status );
+      astProfileStop( &call );
    }
 
 /* Return the required LAST value. */
@@ -1459,9 +1482,18 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
 
 /* Check the attribute name and clear the appropriate attribute. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+/* Look for the attribute name in the table of SkyFrame attribute names
+   first, so that attributes defined by parent classes are passed on to
+   the parent method without being compared with each SkyFrame attribute
+   in turn. */
+   if( !astAttribKnown( attrib, attrib_names, NATTRIB ) ) {
+      (*parent_clearattrib)( this_object, attrib, status );
+
 /* AsTime(axis). */
 /* ------------- */
-   if ( nc = 0,
+   } else if ( nc = 0,
         ( 1 == astSscanf( attrib, "astime(%d)%n", &axis, &nc ) )
         && ( nc >= len ) ) {
       astClearAsTime( this, axis - 1 );
@@ -2655,9 +2687,14 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    the value into "getattrib_buff" as a null-terminated string in an appropriate
    format.  Set "result" to point at the result string. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+   if( !astAttribKnown( attrib, attrib_names, NATTRIB ) ) {
+      result = (*parent_getattrib)( this_object, attrib, status );
+
 /* AsTime(axis). */
 /* ------------- */
-   if ( nc = 0,
+   } else if ( nc = 0,
         ( 1 == astSscanf( attrib, "astime(%d)%n", &axis, &nc ) )
         && ( nc >= len ) ) {
       as_time = astGetAsTime( this, axis - 1 );
@@ -3732,6 +3769,10 @@ static double GetDiurab( AstSkyFrame *this, int *status ) {
    changed. This code is transliterated from SLA_AOPPA. */
    if( this->diurab == AST__BAD ) {
       palGeoc( astGetObsLat( this ), astGetObsAlt( this ), &uau, &vau );
+
+/* A frozen SkyFrame cannot be changed, so just return the value without
+   caching it. */
+      if( astGetFrozen( this ) ) return 2*AST__DPI*uau*SOLSID/C;
       this->diurab = 2*AST__DPI*uau*SOLSID/C;
    }
 
@@ -3794,8 +3835,23 @@ static double GetLAST( AstSkyFrame *this, int *status ) {
    then converted to radians. This approximation seems to be good to less
    than a tenth of an arcsecond. If this approximation cannot be used,
    invoke SetLast to recalculate the accurate LAST and update the "eplast"
-   and "last" values. */
-   if( this->eplast != AST__BAD ) {
+   and "last" values.
+
+   A frozen SkyFrame cannot be changed, and so its cached values cannot be
+   updated. Since its Epoch cannot change either, the cached LAST value is
+   returned if it refers to the Epoch of the SkyFrame, and otherwise an
+   accurate LAST value is calculated afresh each time. */
+   if( astGetFrozen( this ) ) {
+      epoch = astGetEpoch( this );
+      if( epoch == this->eplast ) {
+         result = this->last;
+      } else {
+         result = CalcLAST( this, epoch, astGetObsLon( this ),
+                            astGetObsLat( this ), astGetObsAlt( this ),
+                            astGetDut1( this ), astGetDtai( this ), status );
+      }
+
+   } else if( this->eplast != AST__BAD ) {
       epoch = astGetEpoch( this );
       delta_epoch = epoch - this->eplast;
 
@@ -6062,7 +6118,12 @@ static int MakeSkyMapping( AstSkyFrame *target, AstSkyFrame *result,
    system = target_system;
    equinox = target_equinox;
    epoch = target_epoch;
-   last = GetLAST( target, status );
+
+/* The LAST is only needed for conversions to or from AzEl. It can be
+   expensive to calculate (it requires conversion between time scales),
+   so only get it if it is needed. */
+   last = ( system == AST__AZEL || align_sys == AST__AZEL ) ?
+          GetLAST( target, status ) : AST__BAD;
    diurab = GetDiurab( target, status );
    lat = astGetObsLat( target );
    if( astOK && step1 ) {
@@ -6301,7 +6362,8 @@ static int MakeSkyMapping( AstSkyFrame *target, AstSkyFrame *result,
    equinox = result_equinox;
    epoch = result_epoch;
    diurab = GetDiurab( result, status );
-   last = GetLAST( result, status );
+   last = ( system == AST__AZEL || align_sys == AST__AZEL ) ?
+          GetLAST( result, status ) : AST__BAD;
    lat = astGetObsLat( result );
 
 /* Convert the equinox and epoch values (stored as Modified Julian
@@ -8837,9 +8899,14 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
    that the entire string was matched. Once a value has been obtained, use the
    appropriate method to set it. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+   if( !astAttribKnown( setting, attrib_names, NATTRIB ) ) {
+      (*parent_setattrib)( this_object, setting, status );
+
 /* AsTime(axis). */
 /* ------------- */
-   if ( nc = 0,
+   } else if ( nc = 0,
         ( 2 == astSscanf( setting, "astime(%d)= %d %n", &axis, &astime, &nc ) )
         && ( nc >= len ) ) {
       astSetAsTime( this, axis - 1, astime );
@@ -10584,9 +10651,14 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
 
 /* Check the attribute name and test the appropriate attribute. */
 
+/* Attributes defined by parent classes. */
+/* ------------------------------------- */
+   if( !astAttribKnown( attrib, attrib_names, NATTRIB ) ) {
+      result = (*parent_testattrib)( this_object, attrib, status );
+
 /* AsTime(axis). */
 /* ------------- */
-   if ( nc = 0,
+   } else if ( nc = 0,
         ( 1 == astSscanf( attrib, "astime(%d)%n", &axis, &nc ) )
         && ( nc >= len ) ) {
       result = astTestAsTime( this, axis - 1 );
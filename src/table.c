@@ -43,9 +43,12 @@ c     astAddParameter
 f     AST_ADDPARAMETER
 *     method before being accessed.
 *
-*     Note - since accessing entries within a KeyMap is a relatively slow
-*     process, it is not recommended to use the Table class to store
-*     very large tables.
+*     The values in columns holding numerical data (i.e. any data type
+*     other than string, Object or pointer) are stored internally in
+*     contiguous arrays, one per column, rather than as separate KeyMap
+*     entries. This reduces the memory needed for large tables and allows
+*     whole columns to be copied efficiently. The values can still be
+*     accessed using the normal KeyMap methods, as described above.
 
 *  Inheritance:
 *     The Table class inherits from the KeyMap class.
@@ -114,6 +117,7 @@ f     - AST_REMOVEROW: Remove a row from a Table
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     22-NOV-2010 (DSB):
@@ -122,6 +126,29 @@ f     - AST_REMOVEROW: Remove a row from a Table
 *        Added support for table parameters.
 *     16-NOV-2013 (DSB):
 *        Fix bug in forming keys in GetColumnLenC.
+*     18-OCT-2026 (AGT):
+*        - Hold the cells of numerical columns in contiguous arrays (one per
+*        column) rather than as individual entries in the parent KeyMap.
+*        The KeyMap methods are over-ridden so that such cells still behave
+*        as KeyMap entries. Cells that cannot be held in a column array (e.g.
+*        cells with comments) are still stored in the parent KeyMap.
+*        - Added protected methods astGetColumnCells and astPutColumnCells.
+*        - The column array for a numerical column may be borrowed from the
+*        caller (see astPutColumnCells and astGetBorrowedCells), in which
+*        case it is shared by any copies of the Table and is copied only
+*        when a cell is modified.
+*        - The astMapGet<X>K and astMapPut<X>K methods now check the cell key
+*        in the same way as the other data types.
+*        - Copies of a Table now share the column arrays with the original
+*        Table, rather than copying them. Each Table takes a private copy
+*        of a column array when it first modifies it.
+*     19-OCT-2026 (AGT):
+*        - Cells held in column arrays now share the age sequence used by
+*        the parent KeyMap, so that the SortBy attribute orders them
+*        correctly.
+*        - Dumping or copying a Table no longer modifies the Table.
+*        - Cells held in column arrays are moved into the parent KeyMap
+*        when the Table is frozen, so that a frozen Table is never changed.
 *class--
 */
 
@@ -144,6 +171,12 @@ f     - AST_REMOVEROW: Remove a row from a Table
 /* A function macro that puts quotes around a value */
 #define STRING(w) #w
 
+/* A function macro that tests if a cell is in use within a column store.
+   "irow" is the one-based row index. */
+#define CELL_SET(store,irow) \
+   ( (irow) <= (store)->mxrow && \
+     ( ( (store)->set[ ( (irow) - 1 )/8 ] >> ( ( (irow) - 1 ) % 8 ) ) & 1 ) )
+
 /* Include files. */
 /* ============== */
 /* Interface definitions. */
@@ -192,6 +225,7 @@ static int (* parent_mapget0i)( AstKeyMap *, const char *, int *, int *);
 static int (* parent_mapget0p)( AstKeyMap *, const char *, void **, int *);
 static int (* parent_mapget0b)( AstKeyMap *, const char *, unsigned char *, int *);
 static int (* parent_mapget0s)( AstKeyMap *, const char *, short int *, int *);
+static int (* parent_mapget0k)( AstKeyMap *, const char *, int64_t *, int *);
 static int (* parent_mapget1a)( AstKeyMap *, const char *, int, int *, AstObject **, int * );
 static int (* parent_mapget1c)( AstKeyMap *, const char *, int, int, int *, char *, int * );
 static int (* parent_mapget1d)( AstKeyMap *, const char *, int, int *, double *, int * );
@@ -200,6 +234,7 @@ static int (* parent_mapget1i)( AstKeyMap *, const char *, int, int *, int *, in
 static int (* parent_mapget1p)( AstKeyMap *, const char *, int, int *, void **, int * );
 static int (* parent_mapget1s)( AstKeyMap *, const char *, int, int *, short int *, int * );
 static int (* parent_mapget1b)( AstKeyMap *, const char *, int, int *, unsigned char *, int * );
+static int (* parent_mapget1k)( AstKeyMap *, const char *, int, int *, int64_t *, int * );
 static int (* parent_mapgetelema)( AstKeyMap *, const char *, int, AstObject **, int * );
 static int (* parent_mapgetelemc)( AstKeyMap *, const char *, int, int, char *, int * );
 static int (* parent_mapgetelemd)( AstKeyMap *, const char *, int, double *, int * );
@@ -208,6 +243,7 @@ static int (* parent_mapgetelemi)( AstKeyMap *, const char *, int, int *, int *
 static int (* parent_mapgetelemp)( AstKeyMap *, const char *, int, void **, int * );
 static int (* parent_mapgetelems)( AstKeyMap *, const char *, int, short int *, int * );
 static int (* parent_mapgetelemb)( AstKeyMap *, const char *, int, unsigned char *, int * );
+static int (* parent_mapgetelemk)( AstKeyMap *, const char *, int, int64_t *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_mapput0a)( AstKeyMap *, const char *, AstObject *, const char *, int *);
@@ -218,6 +254,7 @@ static void (* parent_mapput0i)( AstKeyMap *, const char *, int, const char *, i
 static void (* parent_mapput0p)( AstKeyMap *, const char *, void *, const char *, int *);
 static void (* parent_mapput0b)( AstKeyMap *, const char *, unsigned char, const char *, int *);
 static void (* parent_mapput0s)( AstKeyMap *, const char *, short int, const char *, int *);
+static void (* parent_mapput0k)( AstKeyMap *, const char *, int64_t, const char *, int *);
 static void (* parent_mapput1a)( AstKeyMap *, const char *, int, AstObject *const [], const char *, int * );
 static void (* parent_mapput1c)( AstKeyMap *, const char *, int, const char *const [], const char *, int * );
 static void (* parent_mapput1d)( AstKeyMap *, const char *, int, const double *, const char *, int * );
@@ -226,6 +263,7 @@ static void (* parent_mapput1i)( AstKeyMap *, const char *, int, const int *, co
 static void (* parent_mapput1p)( AstKeyMap *, const char *, int, void *const [], const char *, int * );
 static void (* parent_mapput1b)( AstKeyMap *, const char *, int, const unsigned char *, const char *, int * );
 static void (* parent_mapput1s)( AstKeyMap *, const char *, int, const short int *, const char *, int * );
+static void (* parent_mapput1k)( AstKeyMap *, const char *, int, const int64_t *, const char *, int * );
 static void (* parent_mapputelema)( AstKeyMap *, const char *, int, AstObject *, int * );
 static void (* parent_mapputelemc)( AstKeyMap *, const char *, int, const char *, int * );
 static void (* parent_mapputelemd)( AstKeyMap *, const char *, int, double, int * );
@@ -234,7 +272,19 @@ static void (* parent_mapputelemi)( AstKeyMap *, const char *, int, int, int * )
 static void (* parent_mapputelemp)( AstKeyMap *, const char *, int, void *, int * );
 static void (* parent_mapputelemb)( AstKeyMap *, const char *, int, unsigned char, int * );
 static void (* parent_mapputelems)( AstKeyMap *, const char *, int, short int, int * );
+static void (* parent_mapputelemk)( AstKeyMap *, const char *, int, int64_t, int * );
 static void (* parent_mapremove)( AstKeyMap *, const char *, int * );
+static void (* parent_maprename)( AstKeyMap *, const char *, const char *, int * );
+static void (* parent_mapcopy)( AstKeyMap *, AstKeyMap *, int * );
+static void (* parent_mapcopyentry)( AstKeyMap *, const char *, AstKeyMap *, int, int * );
+static int (* parent_mapdefined)( AstKeyMap *, const char *, int * );
+static int (* parent_maphaskey)( AstKeyMap *, const char *, int * );
+static int (* parent_maplenc)( AstKeyMap *, const char *, int * );
+static int (* parent_maplength)( AstKeyMap *, const char *, int * );
+static int (* parent_mapsize)( AstKeyMap *, int * );
+static int (* parent_maptype)( AstKeyMap *, const char *, int * );
+static const char *(* parent_mapiterate)( AstKeyMap *, int, int * );
+static const char *(* parent_mapkey)( AstKeyMap *, int, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
 static void (* parent_mapputu)( AstKeyMap *, const char *, const char *, int * );
 
@@ -283,13 +333,24 @@ AstTable *astTableId_( const char *, ... );
 
 /* Prototypes for Private Member Functions. */
 /* ======================================== */
+static AstKeyMap *CellKeyMap( AstTable *, AstTableColumn *, int, int * );
+static AstKeyMap *MapHidden( AstKeyMap *, const char *, int * );
 static AstKeyMap *ColumnProps( AstTable *, int * );
 static AstKeyMap *ParameterProps( AstTable *, int * );
+static AstTableColumn *CellStore( AstTable *, const char *, const char *, int, int * );
+static AstTableColumn *FindStore( AstTable *, const char *, int * );
+static AstTableColumn *KeyStore( AstTable *, const char *, int *, int * );
+static AstTableColumn *MakeStore( AstTable *, const char *, int, int, int, int * );
+static const void *GetBorrowedCells( AstTable *, const char *, int * );
 static const char *ColumnName( AstTable *, int index, int * );
 static const char *ParameterName( AstTable *, int index, int * );
 static const char *GetColumnUnit( AstTable *, const char *, int * );
+static const char *MapIterate( AstKeyMap *, int, int * );
+static const char *MapKey( AstKeyMap *, int, int * );
 static const char *TypeString( int );
+static size_t TypeSize( int );
 static int Equal( AstObject *, AstObject *, int * );
+static int GetColumnCells( AstTable *, const char *, int, void *, unsigned char *, int * );
 static int GetColumnLenC( AstTable *, const char *, int * );
 static int GetColumnLength( AstTable *, const char *, int * );
 static int GetColumnNdim( AstTable *, const char *, int * );
@@ -297,8 +358,15 @@ static int GetColumnType( AstTable *, const char *, int * );
 static int GetNcolumn( AstTable *, int * );
 static int GetNparameter( AstTable *, int * );
 static size_t GetObjSize( AstObject *, int * );
+static int KeyAge( AstTable *, AstTableColumn *, int, int * );
 static int HasColumn( AstTable *, const char *, int *);
 static int HasParameter( AstTable *, const char *, int *);
+static int MapDefined( AstKeyMap *, const char *, int * );
+static int MapHasKey( AstKeyMap *, const char *, int * );
+static int MapLenC( AstKeyMap *, const char *, int * );
+static int MapLength( AstKeyMap *, const char *, int * );
+static int MapSize( AstKeyMap *, int * );
+static int MapType( AstKeyMap *, const char *, int * );
 static int MapGet0A( AstKeyMap *, const char *, AstObject **, int * );
 static int MapGet0B( AstKeyMap *, const char *, unsigned char *, int * );
 static int MapGet0C( AstKeyMap *, const char *, const char **, int * );
@@ -307,6 +375,7 @@ static int MapGet0F( AstKeyMap *, const char *, float *, int * );
 static int MapGet0I( AstKeyMap *, const char *, int *, int * );
 static int MapGet0P( AstKeyMap *, const char *, void **, int * );
 static int MapGet0S( AstKeyMap *, const char *, short int *, int * );
+static int MapGet0K( AstKeyMap *, const char *, int64_t *, int * );
 static int MapGet1A( AstKeyMap *, const char *, int, int *, AstObject **, int * );
 static int MapGet1B( AstKeyMap *, const char *, int, int *, unsigned char *, int * );
 static int MapGet1C( AstKeyMap *, const char *, int, int, int *, char *, int * );
@@ -315,6 +384,7 @@ static int MapGet1F( AstKeyMap *, const char *, int, int *, float *, int * );
 static int MapGet1I( AstKeyMap *, const char *, int, int *, int *, int * );
 static int MapGet1P( AstKeyMap *, const char *, int, int *, void **, int * );
 static int MapGet1S( AstKeyMap *, const char *, int, int *, short int *, int * );
+static int MapGet1K( AstKeyMap *, const char *, int, int *, int64_t *, int * );
 static int MapGetElemA( AstKeyMap *, const char *, int, AstObject **, int * );
 static int MapGetElemB( AstKeyMap *, const char *, int, unsigned char *, int * );
 static int MapGetElemC( AstKeyMap *, const char *, int, int, char *, int * );
@@ -323,13 +393,26 @@ static int MapGetElemF( AstKeyMap *, const char *, int, float *, int * );
 static int MapGetElemI( AstKeyMap *, const char *, int, int *, int * );
 static int MapGetElemP( AstKeyMap *, const char *, int, void **, int * );
 static int MapGetElemS( AstKeyMap *, const char *, int, short int *, int * );
+static int MapGetElemK( AstKeyMap *, const char *, int, int64_t *, int * );
 static int ParseKey( AstTable *, const char *, int, char *, int *, AstKeyMap **, const char *, int * );
+static int PutColumnCells( AstTable *, const char *, int, const void *, const unsigned char *, int, int * );
 static void AddColumn( AstTable *, const char *, int, int, int *, const char *, int * );
 static void AddParameter( AstTable *, const char *, int * );
 static void ColumnShape( AstTable *, const char *, int, int *, int *, int *);
 static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
+static void CopyCell( AstTableColumn *, int, AstKeyMap *, int * );
+static void ExposeCell( AstTable *, AstTableColumn *, int, int * );
+static void FlushCells( AstTable *, int * );
+static void GrowStore( AstTableColumn *, int, int * );
+static void OwnStore( AstTableColumn *, int * );
+static void MapCopy( AstKeyMap *, AstKeyMap *, int * );
+static void MapCopyEntry( AstKeyMap *, const char *, AstKeyMap *, int, int * );
+static void MapRemove( AstKeyMap *, const char *, int * );
+static void MapRename( AstKeyMap *, const char *, const char *, int * );
+static void PutCell( AstTable *, AstTableColumn *, int, const void *, int * );
+static void ReleaseCell( AstTable *, AstTableColumn *, int, int, int * );
 static void MapPut0A( AstKeyMap *, const char *, AstObject *, const char *, int * );
 static void MapPut0B( AstKeyMap *, const char *, unsigned char, const char *, int * );
 static void MapPut0C( AstKeyMap *, const char *, const char *, const char *, int * );
@@ -338,6 +421,7 @@ static void MapPut0F( AstKeyMap *, const char *, float, const char *, int * );
 static void MapPut0I( AstKeyMap *, const char *, int, const char *, int * );
 static void MapPut0P( AstKeyMap *, const char *, void *, const char *, int * );
 static void MapPut0S( AstKeyMap *, const char *, short int, const char *, int * );
+static void MapPut0K( AstKeyMap *, const char *, int64_t, const char *, int * );
 static void MapPut1A( AstKeyMap *, const char *, int, AstObject *const [], const char *, int * );
 static void MapPut1B( AstKeyMap *, const char *, int, const unsigned char *, const char *, int * );
 static void MapPut1C( AstKeyMap *, const char *, int, const char *const [], const char *, int * );
@@ -346,6 +430,7 @@ static void MapPut1F( AstKeyMap *, const char *, int, const float *, const char
 static void MapPut1I( AstKeyMap *, const char *, int, const int *, const char *, int * );
 static void MapPut1P( AstKeyMap *, const char *, int, void *const [], const char *, int * );
 static void MapPut1S( AstKeyMap *, const char *, int, const short int *, const char *, int * );
+static void MapPut1K( AstKeyMap *, const char *, int, const int64_t *, const char *, int * );
 static void MapPutElemA( AstKeyMap *, const char *, int, AstObject *, int * );
 static void MapPutElemB( AstKeyMap *, const char *, int, unsigned char, int * );
 static void MapPutElemC( AstKeyMap *, const char *, int, const char *, int * );
@@ -354,6 +439,7 @@ static void MapPutElemF( AstKeyMap *, const char *, int, float, int * );
 static void MapPutElemI( AstKeyMap *, const char *, int, int, int * );
 static void MapPutElemP( AstKeyMap *, const char *, int, void *, int * );
 static void MapPutElemS( AstKeyMap *, const char *, int, short int, int * );
+static void MapPutElemK( AstKeyMap *, const char *, int, int64_t, int * );
 static void MapPutU( AstKeyMap *, const char *, const char *, int * );
 static void PurgeRows( AstTable *, int * );
 static void RemoveColumn( AstTable *, const char *, int * );
@@ -483,6 +569,7 @@ f     routine
    int *olddims;         /* Shape of pre-existing column */
    int idim;             /* Axis index */
    int namlen;           /* Used length of "name" */
+   int nel;              /* Number of values in each cell */
    int nval;             /* Number of values returned */
    int oldtype;          /* Data type of pre-existing column */
 
@@ -576,6 +663,12 @@ f     routine
 /* Put the column KeyMap into the KeyMap holding details of all columns.
    Use the column name as the key. */
          astMapPut0A( cols, name, col_km, NULL );
+
+/* If the column holds numerical values, create columnar storage for
+   the cell values. */
+         nel = 1;
+         for( idim = 0; idim < ndim; idim++ ) nel *= dims[ idim ];
+         (void) MakeStore( this, name, type, nel, ( ndim > 0 ), status );
       }
 
 /* Annul the local KeyMap pointers. */
@@ -663,6 +756,135 @@ f        The global status.
    }
 }
 
+static AstKeyMap *CellKeyMap( AstTable *this, AstTableColumn *store,
+                              int irow, int *status ) {
+/*
+*  Name:
+*     CellKeyMap
+
+*  Purpose:
+*     Create a KeyMap holding a copy of a cell held in columnar storage.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     AstKeyMap *CellKeyMap( AstTable *this, AstTableColumn *store,
+*                            int irow, int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function returns a new KeyMap holding a single entry that is
+*     a copy of a cell held in columnar storage. It allows the methods of
+*     the parent KeyMap class (e.g. type conversion and formatting) to be
+*     applied to the cell without storing the cell in the parent KeyMap,
+*     and so without modifying the Table.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     store
+*        Pointer to the columnar storage holding the cell.
+*     irow
+*        The one-based row index of the cell.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the new KeyMap, or NULL if the cell is not in use.
+*     Like the Table, the KeyMap has a zero value for its KeyCase
+*     attribute.
+
+*/
+
+/* Local Variables: */
+   AstKeyMap *result;            /* Returned KeyMap */
+
+/* Check the global error status, and that the cell is in use. */
+   if ( !astOK || !store || !CELL_SET( store, irow ) ) return NULL;
+
+/* Create the KeyMap and copy the cell into it. */
+   result = astKeyMap( "KeyCase=0", status );
+   CopyCell( store, irow, result, status );
+
+/* Return NULL if an error occurred. */
+   if( !astOK ) result = astAnnul( result );
+
+/* Return the result.*/
+   return result;
+}
+
+static AstTableColumn *CellStore( AstTable *this, const char *key,
+                                  const char *colname, int irow, int *status ) {
+/*
+*  Name:
+*     CellStore
+
+*  Purpose:
+*     Find the columnar storage that can hold a specified cell.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     AstTableColumn *CellStore( AstTable *this, const char *key,
+*                                const char *colname, int irow, int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function returns a pointer to the structure holding the values
+*     of the column that contains a specified cell. NULL is returned if
+*     the column is not held in columnar storage, or if the supplied key
+*     is not the standard form of the cell key (i.e. "COLNAME(irow)" with
+*     no embedded spaces or leading zeros in the row index). Values for
+*     cells with non-standard keys are always stored in the parent KeyMap.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The cell key.
+*     colname
+*        The column name, as returned by ParseKey.
+*     irow
+*        The one-based row index, as returned by ParseKey.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the columnar storage, or NULL.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *result;       /* Returned pointer */
+   char buf[ AST__MXCOLKEYLEN + 1 ]; /* Standard cell key */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status, and that some columns have columnar
+   storage. */
+   if ( !astOK || this->nstore == 0 ) return result;
+
+/* Find the column storage, and check the supplied key is the standard
+   key for the cell. */
+   result = FindStore( this, colname, status );
+   if( result ) {
+      sprintf( buf, "%s(%d)", result->name, irow );
+      if( !astChrMatch( buf, key ) ) result = NULL;
+   }
+
+/* Return the result.*/
+   return result;
+}
+
 static void ClearAttrib( AstObject *this_object, const char *attrib, int *status ) {
 /*
 *  Name:
@@ -1019,6 +1241,100 @@ f     NDIM
 
 }
 
+static void CopyCell( AstTableColumn *store, int irow, AstKeyMap *km,
+                      int *status ) {
+/*
+*  Name:
+*     CopyCell
+
+*  Purpose:
+*     Copy a cell value from columnar storage into a KeyMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void CopyCell( AstTableColumn *store, int irow, AstKeyMap *km,
+*                    int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function stores a copy of the value of a cell held in columnar
+*     storage as an entry in the hash table of a KeyMap, using the methods
+*     of the KeyMap class. The entry key is the usual cell key. Any
+*     existing entry with the same key is replaced. The cell is left
+*     unchanged in the columnar storage.
+
+*  Parameters:
+*     store
+*        Pointer to the columnar storage holding the cell.
+*     irow
+*        The one-based row index of the cell.
+*     km
+*        Pointer to the KeyMap. This may be the Table itself, in which
+*        case the entry is stored in the parent KeyMap.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key */
+   const char *ptr;              /* Pointer to cell value */
+   int type;                     /* Data type */
+   int nel;                      /* No. of values in cell */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get the key and a pointer to the cell value. */
+   sprintf( key, "%s(%d)", store->name, irow );
+   ptr = store->data + ( irow - 1 )*store->size;
+   type = store->type;
+   nel = store->nel;
+
+/* Store the value in the KeyMap. */
+   if( store->vector ) {
+      if( type == AST__INTTYPE ) {
+         (*parent_mapput1i)( km, key, nel, (const int *) ptr, NULL,
+                             status );
+      } else if( type == AST__DOUBLETYPE ) {
+         (*parent_mapput1d)( km, key, nel, (const double *) ptr,
+                             NULL, status );
+      } else if( type == AST__FLOATTYPE ) {
+         (*parent_mapput1f)( km, key, nel, (const float *) ptr,
+                             NULL, status );
+      } else if( type == AST__SINTTYPE ) {
+         (*parent_mapput1s)( km, key, nel, (const short int *) ptr,
+                             NULL, status );
+      } else if( type == AST__BYTETYPE ) {
+         (*parent_mapput1b)( km, key, nel,
+                             (const unsigned char *) ptr, NULL, status );
+      }
+
+   } else {
+      if( type == AST__INTTYPE ) {
+         (*parent_mapput0i)( km, key, *( (const int *) ptr ), NULL,
+                             status );
+      } else if( type == AST__DOUBLETYPE ) {
+         (*parent_mapput0d)( km, key, *( (const double *) ptr ),
+                             NULL, status );
+      } else if( type == AST__FLOATTYPE ) {
+         (*parent_mapput0f)( km, key, *( (const float *) ptr ),
+                             NULL, status );
+      } else if( type == AST__SINTTYPE ) {
+         (*parent_mapput0s)( km, key, *( (const short int *) ptr ),
+                             NULL, status );
+      } else if( type == AST__BYTETYPE ) {
+         (*parent_mapput0b)( km, key,
+                             *( (const unsigned char *) ptr ), NULL, status );
+      }
+   }
+}
+
 static int Equal( AstObject *this_object, AstObject *that_object, int *status ) {
 /*
 *  Name:
@@ -1106,6 +1422,202 @@ static int Equal( AstObject *this_object, AstObject *that_object, int *status )
    return result;
 }
 
+static void ExposeCell( AstTable *this, AstTableColumn *store, int irow,
+                        int *status ) {
+/*
+*  Name:
+*     ExposeCell
+
+*  Purpose:
+*     Copy a cell value from columnar storage into the parent KeyMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void ExposeCell( AstTable *this, AstTableColumn *store, int irow,
+*                      int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function stores a copy of the value of a cell held in columnar
+*     storage as an entry in the parent KeyMap, so that it can be
+*     accessed using the methods of the parent KeyMap class. The new
+*     entry is given the ages recorded for the cell, so that its position
+*     within any sorted list of keys is unchanged. The MapLocked attribute
+*     is ignored. The cell is left unchanged in the columnar storage.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     store
+*        Pointer to the columnar storage holding the cell.
+*     irow
+*        The one-based row index of the cell.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key */
+   int locked;                   /* Was the KeyMap locked? */
+   int oldreport;                /* Original reporting state */
+   int oldstatus;                /* Original status value */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* The parent KeyMap will not accept new keys if it is locked, so
+   temporarily unlock it. */
+   locked = astGetMapLocked( this );
+   if( locked ) astSetMapLocked( this, 0 );
+
+/* Store the value in the parent KeyMap, and then give it the ages
+   recorded for the cell. */
+   CopyCell( store, irow, (AstKeyMap *) this, status );
+   sprintf( key, "%s(%d)", store->name, irow );
+   astMapSetAge( this, key, store->age[ irow - 1 ],
+                 store->keyage[ irow - 1 ] );
+
+/* Re-lock the KeyMap, even if an error has occurred. */
+   if( locked ) {
+      oldstatus = astStatus;
+      oldreport = 0;
+      if( !astOK ) {
+         oldreport = astReporting( 0 );
+         astClearStatus;
+      }
+      astSetMapLocked( this, 1 );
+      if( oldstatus ){
+         if( !astOK ) astClearStatus;
+         astSetStatus( oldstatus );
+         astReporting( oldreport );
+      }
+   }
+}
+
+static AstTableColumn *FindStore( AstTable *this, const char *colname,
+                                  int *status ) {
+/*
+*  Name:
+*     FindStore
+
+*  Purpose:
+*     Find the columnar storage for a named column.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     AstTableColumn *FindStore( AstTable *this, const char *colname,
+*                                int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function returns a pointer to the structure holding the values
+*     of a named column.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     colname
+*        The column name. Case and trailing spaces are ignored.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the columnar storage, or NULL if the column does not
+*     exist or is not held in columnar storage (e.g. string columns).
+
+*/
+
+/* Local Variables: */
+   int i;                        /* Index of column storage */
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* Search the array of column storage structures. */
+   for( i = 0; i < this->nstore; i++ ) {
+      if( astChrMatch( this->store[ i ].name, colname ) ) {
+         return this->store + i;
+      }
+   }
+   return NULL;
+}
+
+static void FlushCells( AstTable *this, int *status ) {
+/*
+*  Name:
+*     FlushCells
+
+*  Purpose:
+*     Move all cells from columnar storage into the parent KeyMap.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void FlushCells( AstTable *this, int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function moves the values of all cells currently held in
+*     columnar storage into the parent KeyMap. It is used before any
+*     operation that needs to access the entries of the parent KeyMap by
+*     index (e.g. astMapKey), since the indices would otherwise change as
+*     cells are moved between columnar storage and the parent KeyMap.
+*     Subsequent changes to cell values may again be held in columnar
+*     storage.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int i;                        /* Index of column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Loop round all column storage structures that are in use. */
+   for( i = 0; i < this->nstore && astOK; i++ ) {
+      store = this->store + i;
+      if( store->nset > 0 ) {
+
+/* Copy each cell to the parent KeyMap. */
+         for( irow = 1; irow <= store->mxrow && astOK; irow++ ) {
+            if( CELL_SET( store, irow ) ) ExposeCell( this, store, irow, status );
+         }
+
+/* Indicate that the column storage is now empty, and that the parent
+   KeyMap may hold cells for the column. */
+         if( astOK ) store->set = astUnshare( store->set );
+         if( astOK ) {
+            memset( store->set, 0, ( store->mxrow + 7 )/8 );
+            store->nset = 0;
+            store->spill = 1;
+         }
+      }
+   }
+}
+
 static const char *GetAttrib( AstObject *this_object, const char *attrib, int *status ) {
 /*
 *  Name:
@@ -1286,67 +1798,224 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
    return result;
 }
 
-static int GetColumnLenC( AstTable *this, const char *column, int *status ) {
+static const void *GetBorrowedCells( AstTable *this, const char *column,
+                                     int *status ) {
 /*
 *+
 *  Name:
-*     astGetColumnLenC
+*     astGetBorrowedCells
 
 *  Purpose:
-*     Get the maximum formatted length of any value in a column.
+*     Get a pointer to a borrowed column array.
 
 *  Type:
 *     Protected virtual function.
 
 *  Synopsis:
 *     #include "table.h"
-*     int astGetColumnLenC( AstTable *this, const char *column )
+*     const void *astGetBorrowedCells( AstTable *this, const char *column )
 
 *  Class Membership:
 *     Table method.
 
 *  Description:
-*     This function returns the minimum length which a character variable
-*     must have in order to be able to store the longest value currently
-*     present (at any row) in a specified column of the supplied Table. If
-*     the named column holds vector values, then the returned value is
-*     the length of the longest element of the vector value.
+*     If the cell values for the named column are held in an array that
+*     was borrowed from the caller of astPutColumnCells, this function
+*     returns a pointer to the start of that array. This allows other
+*     Objects to use the cell values directly, without copying them,
+*     subject to the same lifetime requirements as the Table itself.
 
 *  Parameters:
 *     this
 *        Pointer to the Table.
 *     column
-*        The character string holding the upper-case name of the column.
-*        Trailing spaces are ignored. An error is reported if the supplied
-*        column is not found in the Table.
+*        The column name.
 
 *  Returned Value:
-*     The length (i.e. number of characters) of the longest formatted
-*     value associated with the named column. This does not include the
-*     trailing null character.
-
-*  Notes:
-*     - Automatic data type conversion occurs if the named column holds
-*     numerical values.
-*     - An error will be reported if named column does not exist or cannot
-*     be formatted as a character
-*     string.
-*     - A function value of zero will be returned if an error has already
-*     occurred, or if this function should fail for any reason.
+*     A pointer to the value of the first element in row 1 of the
+*     column, in the native data type of the column. Subsequent cells
+*     follow contiguously. NULL is returned if the column array is not
+*     borrowed. Note, cells that have no value occupy space in the array
+*     but contain undefined values - astMapHasKey should be used to check
+*     that a cell has a value before using it.
 
 *-
 */
 
 /* Local Variables: */
-   AstKeyMap *cols;        /* KeyMap holding column definitions */
-   char key[ AST__MXCOLKEYLEN ]; /* Current cell key string */
-   int irow;               /* Current row index */
-   int len;                /* Length needed to format current cell */
-   int nrow;               /* Number of rows in table */
-   int result;             /* Returned value */
+   AstTableColumn *store;        /* Pointer to column storage */
 
-/* Initialise */
-   result = 0;
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* Find the column storage, and return its array if it is borrowed. */
+   store = FindStore( this, column, status );
+   return ( store && store->borrowed ) ? store->data : NULL;
+}
+
+static int GetColumnCells( AstTable *this, const char *column, int nrow,
+                           void *data, unsigned char *found, int *status ) {
+/*
+*+
+*  Name:
+*     astGetColumnCells
+
+*  Purpose:
+*     Get the values of a numerical column directly from columnar storage.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int astGetColumnCells( AstTable *this, const char *column, int nrow,
+*                            void *data, unsigned char *found )
+
+*  Class Membership:
+*     Table method.
+
+*  Description:
+*     This function copies the values of the first "nrow" cells of a
+*     numerical column into a supplied array, for all cells that are
+*     currently held in columnar storage. It can be used to read a whole
+*     column more efficiently than using the astMapGet1<X> method
+*     for each cell. Values for cells that are not held in columnar
+*     storage (e.g. cells that have been stored with a comment) must
+*     be obtained by other means (e.g. astMapGet1<X>).
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     column
+*        The column name.
+*     nrow
+*        The number of rows to return.
+*     data
+*        Pointer to an array in which to return the cell values, in the
+*        native data type of the column. It should have room for "nrow"
+*        cells, each holding the number of values returned by
+*        astGetColumnLength. Elements for cells that are not returned
+*        are left unchanged.
+*     found
+*        Pointer to an array with "nrow" elements. Each element is
+*        returned non-zero if the corresponding cell value has been
+*        returned in "data", and zero otherwise.
+
+*  Returned Value:
+*     The number of cells returned in "data". Zero is returned, and all
+*     elements of "found" are set to zero, if the column is not held in
+*     columnar storage.
+
+*-
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+   int n;                        /* No. of rows with allocated storage */
+   int result;                   /* Returned value */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK || nrow <= 0 ) return result;
+
+/* Initialise the returned flags. */
+   memset( found, 0, nrow );
+
+/* Find the column storage. */
+   store = FindStore( this, column, status );
+   if( store && store->nset > 0 ) {
+
+/* Flag the cells that are in use. */
+      n = ( nrow < store->mxrow ) ? nrow : store->mxrow;
+      for( irow = 1; irow <= n; irow++ ) {
+         if( CELL_SET( store, irow ) ) {
+            found[ irow - 1 ] = 1;
+            result++;
+         }
+      }
+
+/* If all cells are in use, copy them all at once. Otherwise copy them
+   individually. */
+      if( result == n ) {
+         memcpy( data, store->data, n*store->size );
+      } else {
+         for( irow = 0; irow < n; irow++ ) {
+            if( found[ irow ] ) {
+               memcpy( (char *) data + irow*store->size,
+                       store->data + irow*store->size, store->size );
+            }
+         }
+      }
+   }
+
+/* Return the result.*/
+   return result;
+}
+
+static int GetColumnLenC( AstTable *this, const char *column, int *status ) {
+/*
+*+
+*  Name:
+*     astGetColumnLenC
+
+*  Purpose:
+*     Get the maximum formatted length of any value in a column.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int astGetColumnLenC( AstTable *this, const char *column )
+
+*  Class Membership:
+*     Table method.
+
+*  Description:
+*     This function returns the minimum length which a character variable
+*     must have in order to be able to store the longest value currently
+*     present (at any row) in a specified column of the supplied Table. If
+*     the named column holds vector values, then the returned value is
+*     the length of the longest element of the vector value.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     column
+*        The character string holding the upper-case name of the column.
+*        Trailing spaces are ignored. An error is reported if the supplied
+*        column is not found in the Table.
+
+*  Returned Value:
+*     The length (i.e. number of characters) of the longest formatted
+*     value associated with the named column. This does not include the
+*     trailing null character.
+
+*  Notes:
+*     - Automatic data type conversion occurs if the named column holds
+*     numerical values.
+*     - An error will be reported if named column does not exist or cannot
+*     be formatted as a character
+*     string.
+*     - A function value of zero will be returned if an error has already
+*     occurred, or if this function should fail for any reason.
+
+*-
+*/
+
+/* Local Variables: */
+   AstKeyMap *cols;        /* KeyMap holding column definitions */
+   char key[ AST__MXCOLKEYLEN ]; /* Current cell key string */
+   int irow;               /* Current row index */
+   int len;                /* Length needed to format current cell */
+   int nrow;               /* Number of rows in table */
+   int result;             /* Returned value */
+
+/* Initialise */
+   result = 0;
 
 /* Check the global error status. */
    if ( !astOK ) return result;
@@ -1888,6 +2557,7 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
 /* Local Variables: */
    AstKeyMap *km;             /* KeyMap holding column/parameter definitions */
    AstTable *this;            /* Pointer to Table structure */
+   int i;                     /* Index of column storage */
    size_t result;             /* Result value to return */
 
 /* Initialise. */
@@ -1912,6 +2582,17 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
    result += astGetObjSize( km );
    km = astAnnul( km );
 
+   result += astTSizeOf( this->store );
+   for( i = 0; i < this->nstore; i++ ) {
+      result += astTSizeOf( this->store[ i ].name );
+      if( !this->store[ i ].borrowed ) {
+         result += astTSizeOf( this->store[ i ].data );
+      }
+      result += astTSizeOf( this->store[ i ].set );
+      result += astTSizeOf( this->store[ i ].age );
+      result += astTSizeOf( this->store[ i ].keyage );
+   }
+
 /* If an error occurred, clear the result value. */
    if ( !astOK ) result = 0;
 
@@ -1919,6 +2600,78 @@ static size_t GetObjSize( AstObject *this_object, int *status ) {
    return result;
 }
 
+static void GrowStore( AstTableColumn *store, int nrow, int *status ) {
+/*
+*  Name:
+*     GrowStore
+
+*  Purpose:
+*     Ensure columnar storage has room for a given number of rows.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void GrowStore( AstTableColumn *store, int nrow, int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function extends the memory used by the supplied column
+*     storage structure if necessary so that it has room for at least
+*     "nrow" cells. The memory is extended geometrically to avoid
+*     repeated re-allocation as rows are added one at a time. It also
+*     ensures that the cell values are not borrowed, so that they can be
+*     modified.
+
+*  Parameters:
+*     store
+*        Pointer to the column storage.
+*     nrow
+*        The required number of rows.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   char *data;                   /* Pointer to extended cell values */
+   int *age;                     /* Pointer to extended cell ages */
+   int *keyage;                  /* Pointer to extended key ages */
+   int mxrow;                    /* New number of rows */
+   unsigned char *set;           /* Pointer to extended mask */
+
+/* Take a private copy of any borrowed cell values. */
+   OwnStore( store, status );
+
+/* Check the global error status, and if the storage is big enough
+   already. */
+   if ( !astOK || nrow <= store->mxrow ) return;
+
+/* Get the new size. */
+   mxrow = 2*store->mxrow;
+   if( mxrow < nrow ) mxrow = nrow;
+   if( mxrow < 16 ) mxrow = 16;
+
+/* Extend the arrays, initialising the new mask elements to indicate
+   that the new cells are not in use. */
+   data = astGrow( store->data, mxrow, store->size );
+   if( astOK ) store->data = data;
+   age = astGrow( store->age, mxrow, sizeof( int ) );
+   if( astOK ) store->age = age;
+   keyage = astGrow( store->keyage, mxrow, sizeof( int ) );
+   if( astOK ) store->keyage = keyage;
+   set = astGrow( store->set, ( mxrow + 7 )/8, 1 );
+   if( astOK ) {
+      memset( set + ( store->mxrow + 7 )/8, 0,
+              ( mxrow + 7 )/8 - ( store->mxrow + 7 )/8 );
+      store->set = set;
+      store->mxrow = mxrow;
+   }
+}
+
 static int HasColumn( AstTable *this, const char *column, int *status ){
 /*
 *++
@@ -2133,6 +2886,8 @@ void astInitTableVtab_(  AstTableVtab *vtab, const char *name, int *status ) {
    vtab->ParameterName = ParameterName;
    vtab->ColumnProps = ColumnProps;
    vtab->ColumnShape = ColumnShape;
+   vtab->GetBorrowedCells = GetBorrowedCells;
+   vtab->GetColumnCells = GetColumnCells;
    vtab->GetColumnLenC = GetColumnLenC;
    vtab->GetColumnLength = GetColumnLength;
    vtab->GetColumnNdim = GetColumnNdim;
@@ -2145,6 +2900,7 @@ void astInitTableVtab_(  AstTableVtab *vtab, const char *name, int *status ) {
    vtab->HasParameter = HasParameter;
    vtab->ParameterProps = ParameterProps;
    vtab->PurgeRows = PurgeRows;
+   vtab->PutColumnCells = PutColumnCells;
    vtab->RemoveColumn = RemoveColumn;
    vtab->RemoveParameter = RemoveParameter;
    vtab->RemoveRow = RemoveRow;
@@ -2178,8 +2934,6 @@ void astInitTableVtab_(  AstTableVtab *vtab, const char *name, int *status ) {
    object->ManageLock = ManageLock;
 #endif
 
-   parent_mapremove = keymap->MapRemove;
-
 /* Define convenience macros for overriding methods inherited from the
    parent KeyMap class using all data type supported by KeyMap. */
 #define OVERRIDE(method,code,methodlc,codelc) \
@@ -2194,7 +2948,8 @@ void astInitTableVtab_(  AstTableVtab *vtab, const char *name, int *status ) {
    OVERRIDE(method,F,methodlc,f) \
    OVERRIDE(method,I,methodlc,i) \
    OVERRIDE(method,S,methodlc,s) \
-   OVERRIDE(method,B,methodlc,b)
+   OVERRIDE(method,B,methodlc,b) \
+   OVERRIDE(method,K,methodlc,k)
 
 /* Use these macros to override the required methods. */
    OVERRIDE_METHOD(MapPut0,mapput0)
@@ -2206,6 +2961,19 @@ void astInitTableVtab_(  AstTableVtab *vtab, const char *name, int *status ) {
    OVERRIDE(MapPut,U,mapput,u)
    OVERRIDE(SetKeyCase,,setkeycase,)
    OVERRIDE(ClearKeyCase,,clearkeycase,)
+   OVERRIDE(MapRemove,,mapremove,)
+   OVERRIDE(MapRename,,maprename,)
+   OVERRIDE(MapCopy,,mapcopy,)
+   OVERRIDE(MapCopyEntry,,mapcopyentry,)
+   OVERRIDE(MapDefined,,mapdefined,)
+   OVERRIDE(MapHasKey,,maphaskey,)
+   OVERRIDE(MapLenC,,maplenc,)
+   OVERRIDE(MapLength,,maplength,)
+   OVERRIDE(MapSize,,mapsize,)
+   OVERRIDE(MapType,,maptype,)
+   OVERRIDE(MapIterate,,mapiterate,)
+   OVERRIDE(MapKey,,mapkey,)
+   keymap->MapHidden = MapHidden;
 
 /* Remove the macros. */
 #undef OVERRIDE_METHOD
@@ -2228,6 +2996,134 @@ void astInitTableVtab_(  AstTableVtab *vtab, const char *name, int *status ) {
    }
 }
 
+static int KeyAge( AstTable *this, AstTableColumn *store, int irow,
+                   int *status ) {
+/*
+*  Name:
+*     KeyAge
+
+*  Purpose:
+*     Get the age of the key for a cell.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int KeyAge( AstTable *this, AstTableColumn *store, int irow,
+*                 int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function returns the age of the key for a cell in a column
+*     that has columnar storage (i.e. the value used when sorting the
+*     keys with SortBy set to "KeyAgeUp" or "KeyAgeDown"). The cell value
+*     may be held either in the columnar storage or in the parent KeyMap.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     store
+*        Pointer to the columnar storage for the cell's column.
+*     irow
+*        The one-based row index of the cell.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The age of the key, or -1 if the cell does not currently have a
+*     value.
+
+*/
+
+/* Local Variables: */
+   char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key */
+   int result;                   /* Returned value */
+
+/* Initialise */
+   result = -1;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Cells held in columnar storage record the age of their key. */
+   if( CELL_SET( store, irow ) ) {
+      result = store->keyage[ irow - 1 ];
+
+/* Otherwise, look for an entry in the parent KeyMap. */
+   } else if( store->spill ) {
+      sprintf( key, "%s(%d)", store->name, irow );
+      (void) astMapGetAge( this, key, &result );
+   }
+
+/* Return the result.*/
+   return result;
+}
+
+static AstTableColumn *KeyStore( AstTable *this, const char *key, int *irow,
+                                 int *status ) {
+/*
+*  Name:
+*     KeyStore
+
+*  Purpose:
+*     Find the columnar storage that holds a cell with a given key.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     AstTableColumn *KeyStore( AstTable *this, const char *key, int *irow,
+*                               int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function checks if the supplied key is the standard key for a
+*     cell in a column that is held in columnar storage. If so, a pointer
+*     to the column storage is returned, together with the row index.
+*     No error is reported if the key is not a valid cell key.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key to test.
+*     irow
+*        Address of an int in which to return the one-based row index.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the columnar storage, or NULL.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *result;       /* Returned pointer */
+   char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status, and that some columns have columnar
+   storage. Parameter names are never cell keys. */
+   if ( !astOK || this->nstore == 0 || !key || !strchr( key, '(' ) ||
+        astHasParameter( this, key ) ) return result;
+
+/* Parse the key and find the column storage. */
+   if( ParseKey( this, key, 0, colname, irow, NULL, "", status ) ) {
+      result = CellStore( this, key, colname, *irow, status );
+   }
+
+/* Return the result.*/
+   return result;
+}
+
 #if defined(THREAD_SAFE)
 static int ManageLock( AstObject *this_object, int mode, int extra,
                        AstObject **fail, int *status ) {
@@ -2270,6 +3166,9 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 *
 *        AST__CHECKLOCK: Check that the object is locked for use by the
 *        calling thread (report an error if not).
+*
+*        AST__FREEZE: Freeze the Object (see astFreeze). Any cells held
+*        in columnar storage are first moved into the parent KeyMap.
 *     extra
 *        Extra mode-specific information.
 *     fail
@@ -2309,6 +3208,12 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 /* Obtain a pointers to the Table structure. */
    this = (AstTable *) this_object;
 
+/* A frozen Table cannot be changed, so before freezing a Table move any
+   cells held in columnar storage into the parent KeyMap. Otherwise,
+   methods such as astMapKey that need all cells to be in the parent
+   KeyMap would move them when first used. */
+   if( mode == AST__FREEZE && !this_object->frozen ) FlushCells( this, status );
+
 /* Invoke the ManageLock method inherited from the parent class. */
    if( !result ) result = (*parent_managelock)( this_object, mode, extra,
                                                 fail, status );
@@ -2326,48 +3231,392 @@ static int ManageLock( AstObject *this_object, int mode, int extra,
 }
 #endif
 
+static AstTableColumn *MakeStore( AstTable *this, const char *name, int type,
+                                  int nel, int vector, int *status ) {
 /*
 *  Name:
-*     MapGet0<X>
+*     MakeStore
 
 *  Purpose:
-*     Get a scalar value from a cell of a Table.
+*     Create columnar storage for a new column.
 
 *  Type:
 *     Private function.
 
 *  Synopsis:
 *     #include "table.h"
-*     int MapGet0<X>( AstKeyMap *this, const char *key, <X>type *value );
+*     AstTableColumn *MakeStore( AstTable *this, const char *name, int type,
+*                                int nel, int vector, int *status )
 
 *  Class Membership:
-*     Table member function (over-rides the astMapGet0<X> method inherited
-*     from the KeyMap class).
+*     Table member function
 
 *  Description:
-*     This is a set of functions for retrieving a scalar value from a
-*     cell of a Table. You should replace <X> in the generic function name
-*     MapGet0<X> by an appropriate 1-character type code (see the "Data
-*     Type Codes" section in the astMapGet0<X> docs). The stored value is
-*     converted to the data type indiced by <X> before being returned (an
-*     error is reported if it is not possible to convert the stored value
-*     to the requested data type).
+*     This function adds a new, empty, column storage structure to the
+*     Table, if the column data type can be held in columnar storage.
 
 *  Parameters:
 *     this
 *        Pointer to the Table.
-*     key
-*        A character string identifying the cell from which the value is
-*        to be retrieved. It should have the form "COLNAME(irow)", where
-*        "COLNAME" is replaced by the name of a column that has been
-*        defined previously using the astAddColumn method, and "irow" is
-*        an integer row index (the first row is row 1).
-*     value
-*        A pointer to a buffer in which to return the requested value.
-*        If the requested cell is not found, or if it is found but has an
-*        undefined value (see astMapPutU), then the contents of the buffer
-*        on entry to this function will be unchanged on exit. For pointer
-*        types ("A" and "C"), the buffer should be a suitable pointer, and
+*     name
+*        The column name.
+*     type
+*        The column data type.
+*     nel
+*        The number of values in each cell of the column.
+*     vector
+*        Non-zero if the column holds vector values.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the new column storage, or NULL if the data type cannot
+*     be held in columnar storage.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *result;       /* Returned pointer */
+   AstTableColumn *store;        /* Extended array of column storage */
+   int namlen;                   /* Used length of "name" */
+   size_t size;                  /* No. of bytes per value */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status, and that the data type is numerical. */
+   size = TypeSize( type );
+   if ( !astOK || size == 0 ) return result;
+
+/* Extend the array of column storage structures. */
+   store = astGrow( this->store, this->nstore + 1, sizeof( AstTableColumn ) );
+   if( astOK ) {
+      this->store = store;
+      result = this->store + this->nstore;
+
+/* Initialise the new structure. */
+      namlen = astChrLen( name );
+      result->name = astMalloc( namlen + 1 );
+      if( astOK ) {
+         astChrCase( name, result->name, 1, namlen + 1 );
+         result->name[ namlen ] = 0;
+         result->type = type;
+         result->nel = nel;
+         result->vector = vector;
+         result->size = nel*size;
+         result->mxrow = 0;
+         result->nset = 0;
+         result->spill = 0;
+         result->data = NULL;
+         result->set = NULL;
+         result->age = NULL;
+         result->keyage = NULL;
+         result->borrowed = 0;
+         this->nstore++;
+      } else {
+         result = NULL;
+      }
+   }
+
+/* Return the result.*/
+   return result;
+}
+
+static void MapCopy( AstKeyMap *this_keymap, AstKeyMap *that, int *status ) {
+/*
+*  Name:
+*     MapCopy
+
+*  Purpose:
+*     Copy entries from one KeyMap into a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void MapCopy( AstKeyMap *this, AstKeyMap *that, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapCopy method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function copies all entries from the KeyMap "that" into the
+*     Table "this". The parent method stores the copied entries directly
+*     in the parent KeyMap, so any cells held in columnar storage are
+*     first moved into the parent KeyMap so that they are replaced
+*     correctly.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     that
+*        Pointer to the source KeyMap.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstTable *this;               /* Pointer to Table structure */
+   int i;                        /* Index of column storage */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* Move all cells into the parent KeyMap, and note that the parent KeyMap
+   may now hold cells for any column. */
+   FlushCells( this, status );
+   for( i = 0; i < this->nstore; i++ ) this->store[ i ].spill = 1;
+
+/* Invoke the parent method to copy the entries. */
+   (*parent_mapcopy)( this_keymap, that, status );
+}
+
+static void MapCopyEntry( AstKeyMap *this_keymap, const char *key,
+                          AstKeyMap *that, int merge, int *status ) {
+/*
+*  Name:
+*     MapCopyEntry
+
+*  Purpose:
+*     Copy one entry from one KeyMap into a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void MapCopyEntry( AstKeyMap *this, const char *key, AstKeyMap *that,
+*                        int merge, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapCopyEntry method
+*     inherited from the KeyMap class).
+
+*  Description:
+*     This function copies a single entry from the KeyMap "that" into the
+*     Table "this". The parent method stores the copied entry directly in
+*     the parent KeyMap, so any existing value for the cell held in
+*     columnar storage is first moved into the parent KeyMap.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key of the entry to copy.
+*     that
+*        Pointer to the source KeyMap.
+*     merge
+*        Should KeyMap entries be merged?
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstTable *this;               /* Pointer to Table structure */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* If the cell is held in columnar storage, move it into the parent
+   KeyMap. */
+   store = KeyStore( this, key, &irow, status );
+   if( store ) {
+      ReleaseCell( this, store, irow, 1, status );
+      store->spill = 1;
+   }
+
+/* Invoke the parent method to copy the entry. */
+   (*parent_mapcopyentry)( this_keymap, key, that, merge, status );
+}
+
+static int MapDefined( AstKeyMap *this_keymap, const char *key, int *status ) {
+/*
+*  Name:
+*     MapDefined
+
+*  Purpose:
+*     Check if a Table cell or parameter has a defined value.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int MapDefined( AstKeyMap *this, const char *key, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapDefined method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function checks if a cell held in columnar storage has a
+*     value. Other keys are passed on to the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key to check.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the key has a defined value.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Cells held in columnar storage always have a defined value. */
+   store = KeyStore( (AstTable *) this_keymap, key, &irow, status );
+   if( store && CELL_SET( store, irow ) ) return 1;
+
+/* Otherwise, use the parent method. */
+   return (*parent_mapdefined)( this_keymap, key, status );
+}
+
+static AstKeyMap *MapHidden( AstKeyMap *this_keymap, const char *key,
+                             int *status ) {
+/*
+*  Name:
+*     MapHidden
+
+*  Purpose:
+*     Get copies of the cells held in columnar storage.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     AstKeyMap *MapHidden( AstKeyMap *this, const char *key, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the protected astMapHidden
+*     method inherited from the KeyMap class).
+
+*  Description:
+*     This function returns a new KeyMap holding a copy of each cell
+*     value that is currently held in columnar storage rather than in
+*     the parent KeyMap. The Table itself is not changed.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key of a single cell to be returned. If NULL, all cells held
+*        in columnar storage are returned.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a new KeyMap, or NULL if no cells are held in columnar
+*     storage.
+
+*/
+
+/* Local Variables: */
+   AstKeyMap *result;            /* Returned KeyMap */
+   AstTable *this;               /* Pointer to Table structure */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int i;                        /* Index of column storage */
+   int irow;                     /* Row index */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* If a single cell is required, return a KeyMap holding it if it is held
+   in columnar storage. */
+   if( key ) {
+      store = KeyStore( this, key, &irow, status );
+      if( store ) result = CellKeyMap( this, store, irow, status );
+
+/* Otherwise, copy every cell held in columnar storage into a new KeyMap. */
+   } else {
+      for( i = 0; i < this->nstore && astOK; i++ ) {
+         store = this->store + i;
+         for( irow = 1; irow <= store->mxrow && store->nset > 0 && astOK;
+              irow++ ) {
+            if( CELL_SET( store, irow ) ) {
+               if( !result ) result = astKeyMap( "KeyCase=0", status );
+               CopyCell( store, irow, result, status );
+            }
+         }
+      }
+   }
+
+/* Return NULL if an error occurred. */
+   if( !astOK && result ) result = astAnnul( result );
+
+/* Return the result.*/
+   return result;
+}
+
+/*
+*  Name:
+*     MapGet0<X>
+
+*  Purpose:
+*     Get a scalar value from a cell of a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int MapGet0<X>( AstKeyMap *this, const char *key, <X>type *value );
+
+*  Class Membership:
+*     Table member function (over-rides the astMapGet0<X> method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This is a set of functions for retrieving a scalar value from a
+*     cell of a Table. You should replace <X> in the generic function name
+*     MapGet0<X> by an appropriate 1-character type code (see the "Data
+*     Type Codes" section in the astMapGet0<X> docs). The stored value is
+*     converted to the data type indiced by <X> before being returned (an
+*     error is reported if it is not possible to convert the stored value
+*     to the requested data type).
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        A character string identifying the cell from which the value is
+*        to be retrieved. It should have the form "COLNAME(irow)", where
+*        "COLNAME" is replaced by the name of a column that has been
+*        defined previously using the astAddColumn method, and "irow" is
+*        an integer row index (the first row is row 1).
+*     value
+*        A pointer to a buffer in which to return the requested value.
+*        If the requested cell is not found, or if it is found but has an
+*        undefined value (see astMapPutU), then the contents of the buffer
+*        on entry to this function will be unchanged on exit. For pointer
+*        types ("A" and "C"), the buffer should be a suitable pointer, and
 *        the address of this pointer should be supplied as the "value"
 *        parameter.
 *     status
@@ -2404,7 +3653,9 @@ static int MapGet0##X( AstKeyMap *this_keymap, const char *key, Xtype *value, \
                        int *status ) { \
 \
 /* Local Variables: */ \
+   AstKeyMap *cell;    /* Temporary copy of cell */ \
    AstTable *this;     /* Pointer to Table structure */ \
+   AstTableColumn *store; /* Pointer to column storage */ \
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */ \
    int irow;           /* Row index within key string */ \
    int result;         /* Returned flag */ \
@@ -2433,9 +3684,22 @@ static int MapGet0##X( AstKeyMap *this_keymap, const char *key, Xtype *value, \
    table, do nothing more. */ \
       if( irow <= astGetNrow( this ) ){ \
 \
-/* Use the astMapGet0<X> method in the parent keyMap class to get the \
-   cell contents. */ \
-         result = (*parent_mapget0##Xlc)( this_keymap, key, value, status ); \
+/* If the cell is held in columnar storage with the requested data type, \
+   copy the value directly. Otherwise, use the astMapGet0<X> method in the \
+   parent keyMap class to get the cell contents, temporarily copying any \
+   cell held in columnar storage into a separate KeyMap. */ \
+         store = CellStore( this, key, colname, irow, status ); \
+         if( store && !CELL_SET( store, irow ) ) store = NULL; \
+         if( store && store->type == Itype ) { \
+            memcpy( value, store->data + ( irow - 1 )*store->size, \
+                    sizeof( Xtype ) ); \
+            result = 1; \
+         } else { \
+            cell = CellKeyMap( this, store, irow, status ); \
+            result = (*parent_mapget0##Xlc)( cell ? cell : this_keymap, key, \
+                                             value, status ); \
+            if( cell ) cell = astAnnul( cell ); \
+         } \
       } \
    } \
 \
@@ -2456,6 +3720,7 @@ MAKE_MAPGET0(A,a,AstObject *,AST__OBJECTTYPE)
 MAKE_MAPGET0(P,p,void *,AST__POINTERTYPE)
 MAKE_MAPGET0(S,s,short int,AST__SINTTYPE)
 MAKE_MAPGET0(B,b,unsigned char,AST__BYTETYPE)
+MAKE_MAPGET0(K,k,int64_t,AST__KINTTYPE)
 
 /* Undefine the macro. */
 #undef MAKE_MAPGET0
@@ -2548,7 +3813,9 @@ static int MapGet1##X( AstKeyMap *this_keymap, const char *key, int mxval, int *
                        Xtype *value, int *status ) { \
 \
 /* Local Variables: */ \
+   AstKeyMap *cell;    /* Temporary copy of cell */ \
    AstTable *this;     /* Pointer to Table structure */ \
+   AstTableColumn *store; /* Pointer to column storage */ \
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */ \
    int irow;           /* Row index within key string */ \
    int result;         /* Returned flag */ \
@@ -2578,10 +3845,24 @@ static int MapGet1##X( AstKeyMap *this_keymap, const char *key, int mxval, int *
    table, do nothing more. */ \
       if( irow <= astGetNrow( this ) ){ \
 \
-/* Use the astMapGet1<X> method in the parent keyMap class to get the \
-   cell contents. */ \
-         result = (*parent_mapget1##Xlc)( this_keymap, key, mxval, nval, \
-                   value, status ); \
+/* If the cell is held in columnar storage with the requested data type, \
+   copy the values directly. Otherwise, use the astMapGet1<X> method in the \
+   parent keyMap class to get the cell contents, temporarily copying any \
+   cell held in columnar storage into a separate KeyMap. */ \
+         store = CellStore( this, key, colname, irow, status ); \
+         if( store && !CELL_SET( store, irow ) ) store = NULL; \
+         if( store && store->type == Itype ) { \
+            *nval = ( store->nel > mxval ) ? mxval : store->nel; \
+            if( *nval > 0 ) memcpy( value, store->data + \
+                                    ( irow - 1 )*store->size, \
+                                    *nval*sizeof( Xtype ) ); \
+            result = 1; \
+         } else { \
+            cell = CellKeyMap( this, store, irow, status ); \
+            result = (*parent_mapget1##Xlc)( cell ? cell : this_keymap, key, \
+                                             mxval, nval, value, status ); \
+            if( cell ) cell = astAnnul( cell ); \
+         } \
       } \
    } \
 \
@@ -2601,6 +3882,7 @@ MAKE_MAPGET1(A,a,AstObject *,AST__OBJECTTYPE)
 MAKE_MAPGET1(P,p,void *,AST__POINTERTYPE)
 MAKE_MAPGET1(S,s,short int,AST__SINTTYPE)
 MAKE_MAPGET1(B,b,unsigned char,AST__BYTETYPE)
+MAKE_MAPGET1(K,k,int64_t,AST__KINTTYPE)
 
 /* Undefine the macro. */
 #undef MAKE_MAPGET1
@@ -2638,7 +3920,9 @@ static int MapGet1C( AstKeyMap *this_keymap, const char *key, int l, int mxval,
 */
 
 /* Local Variables: */
+   AstKeyMap *cell;    /* Temporary copy of cell */
    AstTable *this;     /* Pointer to Table structure */
+   AstTableColumn *store; /* Pointer to column storage */
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */
    int irow;           /* Row index within key string */
    int result;         /* Returned flag */
@@ -2669,9 +3953,13 @@ static int MapGet1C( AstKeyMap *this_keymap, const char *key, int l, int mxval,
       if( irow <= astGetNrow( this ) ){
 
 /* Use the astMapGet1<X> method in the parent keyMap class to get the
-   cell contents. */
-         result = (*parent_mapget1c)( this_keymap, key, l, mxval, nval,
-                   value, status );
+   cell contents, temporarily copying any cell held in columnar storage
+   into a separate KeyMap. */
+         store = CellStore( this, key, colname, irow, status );
+         cell = CellKeyMap( this, store, irow, status );
+         result = (*parent_mapget1c)( cell ? cell : this_keymap, key, l,
+                                      mxval, nval, value, status );
+         if( cell ) cell = astAnnul( cell );
       }
    }
 
@@ -2768,7 +4056,9 @@ static int MapGetElem##X( AstKeyMap *this_keymap, const char *key, int elem, \
                           Xtype *value, int *status ) { \
 \
 /* Local Variables: */ \
+   AstKeyMap *cell;    /* Temporary copy of cell */ \
    AstTable *this;     /* Pointer to Table structure */ \
+   AstTableColumn *store; /* Pointer to column storage */ \
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */ \
    int irow;           /* Row index within key string */ \
    int result;         /* Returned flag */ \
@@ -2798,10 +4088,24 @@ static int MapGetElem##X( AstKeyMap *this_keymap, const char *key, int elem, \
    table, do nothing more. */ \
       if( irow <= astGetNrow( this ) ){ \
 \
-/* Use the astMapGetElem<X> method in the parent keyMap class to get the \
-   cell contents. */ \
-         result = (*parent_mapgetelem##Xlc)( this_keymap, key, elem, \
-                                             value, status ); \
+/* If the cell is held in columnar storage with the requested data type, \
+   copy the value directly. Otherwise, use the astMapGetElem<X> method in \
+   the parent keyMap class to get the cell contents (or report an error \
+   if the element index is invalid), temporarily copying any cell held in \
+   columnar storage into a separate KeyMap. */ \
+         store = CellStore( this, key, colname, irow, status ); \
+         if( store && !CELL_SET( store, irow ) ) store = NULL; \
+         if( store && store->type == Itype && elem >= 0 && \
+             elem < store->nel ) { \
+            memcpy( value, store->data + ( irow - 1 )*store->size + \
+                    elem*sizeof( Xtype ), sizeof( Xtype ) ); \
+            result = 1; \
+         } else { \
+            cell = CellKeyMap( this, store, irow, status ); \
+            result = (*parent_mapgetelem##Xlc)( cell ? cell : this_keymap, \
+                                                key, elem, value, status ); \
+            if( cell ) cell = astAnnul( cell ); \
+         } \
       } \
    } \
 \
@@ -2821,6 +4125,7 @@ MAKE_MAPGETELEM(A,a,AstObject *,AST__OBJECTTYPE)
 MAKE_MAPGETELEM(P,p,void *,AST__POINTERTYPE)
 MAKE_MAPGETELEM(S,s,short int,AST__SINTTYPE)
 MAKE_MAPGETELEM(B,b,unsigned char,AST__BYTETYPE)
+MAKE_MAPGETELEM(K,k,int64_t,AST__KINTTYPE)
 
 /* Undefine the macro. */
 #undef MAKE_MAPGETELEM
@@ -2857,7 +4162,9 @@ static int MapGetElemC( AstKeyMap *this_keymap, const char *key, int l,
 */
 
 /* Local Variables: */
+   AstKeyMap *cell;    /* Temporary copy of cell */
    AstTable *this;     /* Pointer to Table structure */
+   AstTableColumn *store; /* Pointer to column storage */
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */
    int irow;           /* Row index within key string */
    int result;         /* Returned flag */
@@ -2888,9 +4195,13 @@ static int MapGetElemC( AstKeyMap *this_keymap, const char *key, int l,
       if( irow <= astGetNrow( this ) ){
 
 /* Use the astMapGetElem<X> method in the parent keyMap class to get the
-   cell contents. */
-         result = (*parent_mapgetelemc)( this_keymap, key, l, elem,
-                                         value, status );
+   cell contents, temporarily copying any cell held in columnar storage
+   into a separate KeyMap. */
+         store = CellStore( this, key, colname, irow, status );
+         cell = CellKeyMap( this, store, irow, status );
+         result = (*parent_mapgetelemc)( cell ? cell : this_keymap, key, l,
+                                         elem, value, status );
+         if( cell ) cell = astAnnul( cell );
       }
    }
 
@@ -2901,54 +4212,312 @@ static int MapGetElemC( AstKeyMap *this_keymap, const char *key, int l,
    return result;
 }
 
+static int MapHasKey( AstKeyMap *this_keymap, const char *key, int *status ) {
 /*
 *  Name:
-*     MapPut0<X>
+*     MapHasKey
 
 *  Purpose:
-*     Stores a scalar value in a cell of a Table.
+*     Check if a Table contains a cell or parameter with a given key.
 
 *  Type:
 *     Private function.
 
 *  Synopsis:
 *     #include "table.h"
-*     void MapPut0<X>( AstKeyMap *this, const char *key, <X>type value,
-*                      const char *comment, int *status )
+*     int MapHasKey( AstKeyMap *this, const char *key, int *status )
 
 *  Class Membership:
-*     Table member function (over-rides the astMapPut0<X> method inherited
+*     Table member function (over-rides the astMapHasKey method inherited
 *     from the KeyMap class).
 
 *  Description:
-*     This is a set of functions for storing a scalar value in a cell of
-*     a Table. You should use a function which matches the data type of the
-*     data you wish to add to the Table by replacing <X> in the generic
-*     function name MapPut0<X> by an appropriate 1-character type code (see
-*     the "Data Type Codes" section in the astMapPut0<X> docs).
+*     This function checks if a cell held in columnar storage has a
+*     value. Other keys are passed on to the parent method.
 
 *  Parameters:
 *     this
-*        Pointer to the Table in which to store the supplied value.
+*        Pointer to the Table.
 *     key
-*        A character string identifying the cell in which the value is
-*        to be stored. It should have the form "COLNAME(irow)", where
-*        "COLNAME" is replaced by the name of a column that has been
-*        defined previously using the astAddColumn method, and "irow" is
-*        an integer row index (the first row is row 1).
-*     value
-*        The value to be stored. The data type of this value should match
-*        the 1-character type code appended to the function name (e.g. if
-*        you are using astMapPut0A, the type of this value should be "pointer
-*        to AstObject"). An error will be reported if this data type is
-*        different to the data type assigned to the column when it was
-*        created via astAddColumn.
-*     comment
-*        A pointer to a null-terminated comment string to be stored with the
-*        value. A NULL pointer may be supplied, in which case no comment is
-*        stored.
+*        The key to check.
 *     status
-*        Pointer to inherited status value.
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the key exists.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Check for cells held in columnar storage. */
+   store = KeyStore( (AstTable *) this_keymap, key, &irow, status );
+   if( store && CELL_SET( store, irow ) ) return 1;
+
+/* Otherwise, use the parent method. */
+   return (*parent_maphaskey)( this_keymap, key, status );
+}
+
+static const char *MapIterate( AstKeyMap *this_keymap, int reset,
+                               int *status ) {
+/*
+*  Name:
+*     MapIterate
+
+*  Purpose:
+*     Iterate through the keys in a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     const char *MapIterate( AstKeyMap *this, int reset, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the protected astMapIterate method
+*     inherited from the KeyMap class).
+
+*  Description:
+*     This function moves all cells held in columnar storage into the
+*     parent KeyMap, and then invokes the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     reset
+*        If non-zero, return the first key.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the next key, or NULL if there are no more keys.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* The parent method iterates through the parent KeyMap hash table, so
+   ensure that this holds all cells. */
+   FlushCells( (AstTable *) this_keymap, status );
+   return (*parent_mapiterate)( this_keymap, reset, status );
+}
+
+static const char *MapKey( AstKeyMap *this_keymap, int index, int *status ) {
+/*
+*  Name:
+*     MapKey
+
+*  Purpose:
+*     Get the key at a given index within a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     const char *MapKey( AstKeyMap *this, int index, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapKey method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function moves all cells held in columnar storage into the
+*     parent KeyMap, and then invokes the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     index
+*        The index of the required key (zero-based).
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the key.
+
+*/
+
+/* Check the global error status. */
+   if ( !astOK ) return NULL;
+
+/* The parent method indexes the parent KeyMap hash table, so ensure that
+   this holds all cells. */
+   FlushCells( (AstTable *) this_keymap, status );
+   return (*parent_mapkey)( this_keymap, index, status );
+}
+
+static int MapLenC( AstKeyMap *this_keymap, const char *key, int *status ) {
+/*
+*  Name:
+*     MapLenC
+
+*  Purpose:
+*     Get the length of the formatted value of a Table cell or parameter.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int MapLenC( AstKeyMap *this, const char *key, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapLenC method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function returns the length of the longest formatted value
+*     stored in a cell or parameter, using the parent method. Cells held
+*     in columnar storage are temporarily copied into a separate KeyMap.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of characters.
+
+*/
+
+/* Local Variables: */
+   AstKeyMap *cell;              /* Temporary copy of cell */
+   AstTable *this;               /* Pointer to Table structure */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+   int result;                   /* Returned value */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* If the cell is held in columnar storage, get a temporary KeyMap
+   holding a copy of it. */
+   store = KeyStore( this, key, &irow, status );
+   cell = CellKeyMap( this, store, irow, status );
+
+/* Use the parent method. */
+   result = (*parent_maplenc)( cell ? cell : this_keymap, key, status );
+
+/* Free any temporary copy of the cell. */
+   if( cell ) cell = astAnnul( cell );
+
+/* Return the result.*/
+   return result;
+}
+
+static int MapLength( AstKeyMap *this_keymap, const char *key, int *status ) {
+/*
+*  Name:
+*     MapLength
+
+*  Purpose:
+*     Get the number of values stored in a Table cell or parameter.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int MapLength( AstKeyMap *this, const char *key, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapLength method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function returns the number of values stored in a cell held in
+*     columnar storage. Other keys are passed on to the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of values.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Check for cells held in columnar storage. */
+   store = KeyStore( (AstTable *) this_keymap, key, &irow, status );
+   if( store && CELL_SET( store, irow ) ) return store->nel;
+
+/* Otherwise, use the parent method. */
+   return (*parent_maplength)( this_keymap, key, status );
+}
+
+/*
+*  Name:
+*     MapPut0<X>
+
+*  Purpose:
+*     Stores a scalar value in a cell of a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void MapPut0<X>( AstKeyMap *this, const char *key, <X>type value,
+*                      const char *comment, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapPut0<X> method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This is a set of functions for storing a scalar value in a cell of
+*     a Table. You should use a function which matches the data type of the
+*     data you wish to add to the Table by replacing <X> in the generic
+*     function name MapPut0<X> by an appropriate 1-character type code (see
+*     the "Data Type Codes" section in the astMapPut0<X> docs).
+
+*  Parameters:
+*     this
+*        Pointer to the Table in which to store the supplied value.
+*     key
+*        A character string identifying the cell in which the value is
+*        to be stored. It should have the form "COLNAME(irow)", where
+*        "COLNAME" is replaced by the name of a column that has been
+*        defined previously using the astAddColumn method, and "irow" is
+*        an integer row index (the first row is row 1).
+*     value
+*        The value to be stored. The data type of this value should match
+*        the 1-character type code appended to the function name (e.g. if
+*        you are using astMapPut0A, the type of this value should be "pointer
+*        to AstObject"). An error will be reported if this data type is
+*        different to the data type assigned to the column when it was
+*        created via astAddColumn.
+*     comment
+*        A pointer to a null-terminated comment string to be stored with the
+*        value. A NULL pointer may be supplied, in which case no comment is
+*        stored.
+*     status
+*        Pointer to inherited status value.
 
 *  Notes:
 *     - Key names are case insensitive, and white space is considered
@@ -2972,6 +4541,7 @@ static void MapPut0##X( AstKeyMap *this_keymap, const char *key, Xtype value, \
 /* Local Variables: */ \
    AstKeyMap *col_km;  /* KeyMap holding details of the requested column */ \
    AstTable *this;     /* Pointer to Table structure */ \
+   AstTableColumn *store; /* Pointer to column storage */ \
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */ \
    int irow;           /* Row index within key string */ \
    int type;           /* Data type of the requested column */ \
@@ -3011,11 +4581,23 @@ static void MapPut0##X( AstKeyMap *this_keymap, const char *key, Xtype value, \
 \
 /* If the row index is larger than the current number of rows in the \
    table, update the number of rows in the table. */ \
-      if( irow > astGetNrow( this ) ) astSetNrow( this, irow ); \
+      if( astOK ) { \
+         if( irow > astGetNrow( this ) ) astSetNrow( this, irow ); \
 \
-/* Use the astMapPut0<X> method in the parent keyMap class to store the \
-   new cell contents. */ \
-      (*parent_mapput0##Xlc)( this_keymap, key, value, comment, status ); \
+/* If the column is held in columnar storage, store the value there unless \
+   a comment is supplied, or the Table is locked and the cell would be a \
+   new entry. Otherwise, use the astMapPut0<X> method in the parent keyMap \
+   class to store the new cell contents. */ \
+         store = CellStore( this, key, colname, irow, status ); \
+         if( store && !comment && ( CELL_SET( store, irow ) || \
+                                    !astGetMapLocked( this ) ) ) { \
+            PutCell( this, store, irow, &value, status ); \
+         } else { \
+            if( store ) ReleaseCell( this, store, irow, 1, status ); \
+            (*parent_mapput0##Xlc)( this_keymap, key, value, comment, status ); \
+            if( store ) store->spill = 1; \
+         } \
+      } \
 \
 /* Free resources. */ \
       col_km = astAnnul( col_km ); \
@@ -3032,6 +4614,7 @@ MAKE_MAPPUT0(A,a,AstObject *,AST__OBJECTTYPE,(value?astClone(value):NULL))
 MAKE_MAPPUT0(P,p,void *,AST__POINTERTYPE,value)
 MAKE_MAPPUT0(S,s,short int,AST__SINTTYPE,value)
 MAKE_MAPPUT0(B,b,unsigned char,AST__BYTETYPE,value)
+MAKE_MAPPUT0(K,k,int64_t,AST__KINTTYPE,value)
 
 /* Undefine the macro. */
 #undef MAKE_MAPPUT0
@@ -3104,6 +4687,7 @@ static void MapPut1##X( AstKeyMap *this_keymap, const char *key, int size, \
 \
 /* Local Variables: */ \
    AstTable *this;     /* Pointer to Table structure */ \
+   AstTableColumn *store; /* Pointer to column storage */ \
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */ \
    int irow;           /* Row index within key string */ \
 \
@@ -3144,11 +4728,21 @@ static void MapPut1##X( AstKeyMap *this_keymap, const char *key, int size, \
       } \
 \
 /* If all is OK, update the number of rows in the table if required, and \
-   store the vector in the parent KeyMap. */ \
+   store the vector in columnar storage, or in the parent KeyMap if the \
+   column is not held in columnar storage, a comment is supplied, or the \
+   Table is locked and the cell would be a new entry. */ \
       if( astOK ) { \
          if( irow > astGetNrow( this ) ) astSetNrow( this, irow ); \
-         (*parent_mapput1##Xlc)( this_keymap, key, size, value, \
-                                 comment, status ); \
+         store = CellStore( this, key, colname, irow, status ); \
+         if( store && !comment && ( CELL_SET( store, irow ) || \
+                                    !astGetMapLocked( this ) ) ) { \
+            PutCell( this, store, irow, value, status ); \
+         } else { \
+            if( store ) ReleaseCell( this, store, irow, 1, status ); \
+            (*parent_mapput1##Xlc)( this_keymap, key, size, value, \
+                                    comment, status ); \
+            if( store ) store->spill = 1; \
+         } \
       } \
 \
    } \
@@ -3164,6 +4758,7 @@ MAKE_MAPPUT1(A,a,AstObject *const,AST__OBJECTTYPE,(value[i]?astClone(value[i]):N
 MAKE_MAPPUT1(P,p,void *const,AST__POINTERTYPE,value[i])
 MAKE_MAPPUT1(S,s,const short int,AST__SINTTYPE,value[i])
 MAKE_MAPPUT1(B,b,const unsigned char,AST__BYTETYPE,value[i])
+MAKE_MAPPUT1(K,k,const int64_t,AST__KINTTYPE,value[i])
 
 /* Undefine the macro. */
 #undef MAKE_MAPPUT1
@@ -3240,6 +4835,7 @@ static void MapPutElem##X( AstKeyMap *this_keymap, const char *key, int elem, \
 \
 /* Local Variables: */ \
    AstTable *this;     /* Pointer to Table structure */ \
+   AstTableColumn *store; /* Pointer to column storage */ \
    char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */ \
    int irow;           /* Row index within key string */ \
    int type;           /* Data type of the requested column */ \
@@ -3282,11 +4878,23 @@ static void MapPutElem##X( AstKeyMap *this_keymap, const char *key, int elem, \
       } \
 \
 /* If all is OK, update the number of rows in the table if required, and \
-   store the value in the parent KeyMap. */ \
+   store the value. If the cell already has a value in columnar storage, \
+   just modify the requested element. Otherwise, store the value in the \
+   parent KeyMap. */ \
       if( astOK ) { \
          if( irow > astGetNrow( this ) ) astSetNrow( this, irow ); \
-         (*parent_mapputelem##Xlc)( this_keymap, key, elem, value, \
-                                    status ); \
+         store = CellStore( this, key, colname, irow, status ); \
+         if( store && CELL_SET( store, irow ) && elem >= 0 ) { \
+            OwnStore( store, status ); \
+            if( astOK ) memcpy( store->data + ( irow - 1 )*store->size + \
+                                elem*sizeof( Xtype ), &value, \
+                                sizeof( Xtype ) ); \
+         } else { \
+            if( store ) ReleaseCell( this, store, irow, 1, status ); \
+            (*parent_mapputelem##Xlc)( this_keymap, key, elem, value, \
+                                       status ); \
+            if( store ) store->spill = 1; \
+         } \
       } \
    } \
 }
@@ -3301,6 +4909,7 @@ MAKE_MAPPUTELEM(P,p,void *,AST__POINTERTYPE)
 MAKE_MAPPUTELEM(C,c,const char *,AST__STRINGTYPE)
 MAKE_MAPPUTELEM(S,s,short int,AST__SINTTYPE)
 MAKE_MAPPUTELEM(B,b,unsigned char,AST__BYTETYPE)
+MAKE_MAPPUTELEM(K,k,int64_t,AST__KINTTYPE)
 
 /* Undefine the macro. */
 #undef MAKE_MAPPUTELEM
@@ -3323,73 +4932,358 @@ static void MapPutU( AstKeyMap *this_keymap, const char *key, const char *commen
 *                   int *status )
 
 *  Class Membership:
-*     Table member function (over-rides the astMapPutU method inherited
-*     from the KeyMap class).
+*     Table member function (over-rides the astMapPutU method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function adds a new cell to a Table, but no value is stored with
+*     the cell. The cell therefore has a special data type represented by
+*     symbolic constant AST__UNDEFTYPE.
+*
+*     An example use is to add cells with undefined values to a Table
+*     prior to locking them with the MapLocked attribute. Such cells
+*     can act as placeholders for values that can be added to the KeyMap
+*     later.
+
+*  Parameters:
+*     this
+*        Pointer to the Table in which to store the supplied value.
+*     key
+*        A character string identifying the cell in which the value is
+*        to be stored. It should have the form "COLNAME(irow)", where
+*        "COLNAME" is replaced by the name of a column that has been
+*        defined previously using the astAddColumn method, and "irow" is
+*        an integer row index (the first row is row 1).
+*     comment
+*        A pointer to a null-terminated comment string to be stored with the
+*        value. A NULL pointer may be supplied, in which case no comment is
+*        stored.
+*     status
+*        Pointer to inherited status value.
+
+*  Notes:
+*     - Key names are case insensitive, and white space is considered
+*     significant.
+*     - The new undefined value will replace any old value already stored in
+*     the Table for the specified cell.
+
+*/
+
+/* Local Variables: */
+   AstTable *this;     /* Pointer to Table structure */
+   AstTableColumn *store; /* Pointer to column storage */
+   char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */
+   int irow;           /* Row index within key string */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* If the key is the name of a global table parameter, use the parent
+   method to put the value of the parameter. */
+   if( astHasParameter( this, key ) ) {
+      (*parent_mapputu)( this_keymap, key, comment, status );
+
+/* Check the supplied key looks like a table cell key, and get the
+   the column name and the row number. Also checks that the table
+   contains a column with the specified name. */
+   } else if( ParseKey( this, key, 1, colname, &irow, NULL, "astMapPutU",
+                        status ) ) {
+
+/* If the row index is larger than the current number of rows in the
+   table, update the number of rows in the table. */
+      if( irow > astGetNrow( this ) ) astSetNrow( this, irow );
+
+/* Use the astMapPutU method in the parent keyMap class to store the
+   new cell contents, first moving any value held in columnar storage
+   into the parent KeyMap so that it is replaced. */
+      store = CellStore( this, key, colname, irow, status );
+      if( store ) ReleaseCell( this, store, irow, 1, status );
+      (*parent_mapputu)( this_keymap, key, comment, status );
+      if( store ) store->spill = 1;
+   }
+}
+
+static void MapRemove( AstKeyMap *this_keymap, const char *key, int *status ) {
+/*
+*  Name:
+*     MapRemove
+
+*  Purpose:
+*     Remove a cell or parameter value from a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void MapRemove( AstKeyMap *this, const char *key, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapRemove method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function removes a cell held in columnar storage. Other keys
+*     are passed on to the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key to remove.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Remove cells held in columnar storage. Otherwise, use the parent
+   method. */
+   store = KeyStore( (AstTable *) this_keymap, key, &irow, status );
+   if( store && CELL_SET( store, irow ) ) {
+      ReleaseCell( (AstTable *) this_keymap, store, irow, 0, status );
+   } else {
+      (*parent_mapremove)( this_keymap, key, status );
+   }
+}
+
+static void MapRename( AstKeyMap *this_keymap, const char *oldkey,
+                       const char *newkey, int *status ) {
+/*
+*  Name:
+*     MapRename
+
+*  Purpose:
+*     Rename a cell or parameter within a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void MapRename( AstKeyMap *this, const char *oldkey,
+*                     const char *newkey, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapRename method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function moves any cells held in columnar storage that are
+*     affected by the renaming into the parent KeyMap, and then invokes
+*     the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     oldkey
+*        The existing key.
+*     newkey
+*        The new key.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstTable *this;               /* Pointer to Table structure */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* Move the old and new cells into the parent KeyMap. */
+   store = KeyStore( this, oldkey, &irow, status );
+   if( store ) ReleaseCell( this, store, irow, 1, status );
+
+   store = KeyStore( this, newkey, &irow, status );
+   if( store ) {
+      ReleaseCell( this, store, irow, 1, status );
+      store->spill = 1;
+   }
+
+/* Use the parent method to rename the entry. */
+   (*parent_maprename)( this_keymap, oldkey, newkey, status );
+}
+
+static int MapSize( AstKeyMap *this_keymap, int *status ) {
+/*
+*  Name:
+*     MapSize
+
+*  Purpose:
+*     Get the number of cells and parameters in a Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int MapSize( AstKeyMap *this, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapSize method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function returns the number of entries in the parent KeyMap
+*     plus the number of cells held in columnar storage.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The number of entries.
+
+*/
+
+/* Local Variables: */
+   AstTable *this;               /* Pointer to Table structure */
+   int i;                        /* Index of column storage */
+   int result;                   /* Returned value */
+
+/* Check the global error status. */
+   if ( !astOK ) return 0;
+
+/* Get a pointer to the Table structure. */
+   this = (AstTable *) this_keymap;
+
+/* Get the number of entries in the parent KeyMap. */
+   result = (*parent_mapsize)( this_keymap, status );
+
+/* Add on the number of cells held in columnar storage. */
+   for( i = 0; i < this->nstore; i++ ) result += this->store[ i ].nset;
+
+/* Return the result.*/
+   return result;
+}
+
+static int MapType( AstKeyMap *this_keymap, const char *key, int *status ) {
+/*
+*  Name:
+*     MapType
+
+*  Purpose:
+*     Get the data type of a Table cell or parameter.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int MapType( AstKeyMap *this, const char *key, int *status )
+
+*  Class Membership:
+*     Table member function (over-rides the astMapType method inherited
+*     from the KeyMap class).
+
+*  Description:
+*     This function returns the data type of a cell held in columnar
+*     storage. Other keys are passed on to the parent method.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     key
+*        The key.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     The data type.
+
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   int irow;                     /* Row index */
+
+/* Check the global error status. */
+   if ( !astOK ) return AST__BADTYPE;
+
+/* Check for cells held in columnar storage. */
+   store = KeyStore( (AstTable *) this_keymap, key, &irow, status );
+   if( store && CELL_SET( store, irow ) ) return store->type;
+
+/* Otherwise, use the parent method. */
+   return (*parent_maptype)( this_keymap, key, status );
+}
+
+static void OwnStore( AstTableColumn *store, int *status ) {
+/*
+*  Name:
+*     OwnStore
+
+*  Purpose:
+*     Ensure the values in a column array are owned by the Table.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void OwnStore( AstTableColumn *store, int *status )
+
+*  Class Membership:
+*     Table member function
 
 *  Description:
-*     This function adds a new cell to a Table, but no value is stored with
-*     the cell. The cell therefore has a special data type represented by
-*     symbolic constant AST__UNDEFTYPE.
-*
-*     An example use is to add cells with undefined values to a Table
-*     prior to locking them with the MapLocked attribute. Such cells
-*     can act as placeholders for values that can be added to the KeyMap
-*     later.
+*     If the array of cell values in the supplied column storage
+*     structure was borrowed from the caller of astPutColumnCells, this
+*     function replaces it with a private copy so that it can be
+*     modified. Likewise, the array of cell values and the mask of cells
+*     in use are replaced by private copies if they are shared with
+*     other Tables (see astShare). It does nothing if the arrays are
+*     already owned exclusively by the Table.
 
 *  Parameters:
-*     this
-*        Pointer to the Table in which to store the supplied value.
-*     key
-*        A character string identifying the cell in which the value is
-*        to be stored. It should have the form "COLNAME(irow)", where
-*        "COLNAME" is replaced by the name of a column that has been
-*        defined previously using the astAddColumn method, and "irow" is
-*        an integer row index (the first row is row 1).
-*     comment
-*        A pointer to a null-terminated comment string to be stored with the
-*        value. A NULL pointer may be supplied, in which case no comment is
-*        stored.
+*     store
+*        Pointer to the column storage.
 *     status
-*        Pointer to inherited status value.
-
-*  Notes:
-*     - Key names are case insensitive, and white space is considered
-*     significant.
-*     - The new undefined value will replace any old value already stored in
-*     the Table for the specified cell.
+*        Pointer to the inherited status variable.
 
 */
 
 /* Local Variables: */
-   AstTable *this;     /* Pointer to Table structure */
-   char colname[ AST__MXCOLNAMLEN + 1 ]; /* Column name read from string */
-   int irow;           /* Row index within key string */
+   char *data;                   /* Pointer to private copy */
 
 /* Check the global error status. */
    if ( !astOK ) return;
 
-/* Get a pointer to the Table structure. */
-   this = (AstTable *) this_keymap;
-
-/* If the key is the name of a global table parameter, use the parent
-   method to put the value of the parameter. */
-   if( astHasParameter( this, key ) ) {
-      (*parent_mapputu)( this_keymap, key, comment, status );
-
-/* Check the supplied key looks like a table cell key, and get the
-   the column name and the row number. Also checks that the table
-   contains a column with the specified name. */
-   } else if( ParseKey( this, key, 1, colname, &irow, NULL, "astMapPutU",
-                        status ) ) {
-
-/* If the row index is larger than the current number of rows in the
-   table, update the number of rows in the table. */
-      if( irow > astGetNrow( this ) ) astSetNrow( this, irow );
+/* If the array is borrowed, take a copy of it, and use it in place of
+   the borrowed array. */
+   if( store->borrowed ) {
+      data = astStore( NULL, store->data, store->mxrow*store->size );
+      if( astOK ) {
+         store->data = data;
+         store->borrowed = 0;
+      }
 
-/* Use the astMapPutU method in the parent keyMap class to store the
-   new cell contents. */
-      (*parent_mapputu)( this_keymap, key, comment, status );
+/* Otherwise, ensure the array is not shared with another Table. */
+   } else {
+      store->data = astUnshare( store->data );
    }
+
+/* Ensure the mask and ages are not shared with another Table. */
+   store->set = astUnshare( store->set );
+   store->age = astUnshare( store->age );
+   store->keyage = astUnshare( store->keyage );
 }
 
 static const char *ParameterName( AstTable *this, int index, int *status ) {
@@ -3697,9 +5591,11 @@ f        The global status.
 */
 
 /* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
    char newkey[ AST__MXCOLKEYLEN + 1 ]; /* New cell key string */
    char oldkey[ AST__MXCOLKEYLEN + 1 ]; /* Old cell key string */
    const char *col;              /* Column name */
+   int istore;                   /* Index of column storage */
    const char *key;              /* Pointer to key string */
    const char *op;               /* Pointer to opening parenthesis */
    int *w1;                      /* Work space pointer */
@@ -3721,9 +5617,10 @@ f        The global status.
    w1 = astCalloc( nrow, sizeof( int ) );
    if( astOK ) {
 
-/* Iterate round all keys in the KeyMap. */
+/* Iterate round all keys in the parent KeyMap. */
       reset = 1;
-      while( ( key = astMapIterate( this, reset ) ) && astOK ) {
+      while( ( key = (*parent_mapiterate)( (AstKeyMap *) this, reset,
+                                           status ) ) && astOK ) {
          reset = 0;
 
 /* Extract the row number from the key. */
@@ -3741,13 +5638,22 @@ f        The global status.
          }
       }
 
+/* Also count the cells held in columnar storage. */
+      for( istore = 0; istore < this->nstore; istore++ ) {
+         store = this->store + istore;
+         for( iold = 1; iold <= nrow && iold <= store->mxrow; iold++ ) {
+            if( CELL_SET( store, iold ) ) w1[ iold - 1 ]++;
+         }
+      }
+
 /* Loop round all columns in the Table. */
       ncol = astGetNcolumn( this );
       inew = nrow;
       for( icol = 1; icol <= ncol; icol++ ) {
 
-/* Get the column name */
+/* Get the column name, and any columnar storage for the column. */
          col = astColumnName( this, icol );
+         store = FindStore( this, col, status );
 
 /* Loop round all the old row numbers. Skip empty rows.*/
          inew = 0;
@@ -3758,12 +5664,29 @@ f        The global status.
    old and new row numbers are the same, we do not need to rename the cell. */
                if( iold != inew++ ) {
 
-/* For the old and new cell names */
-                  sprintf( oldkey, "%s(%d)", col, iold + 1 );
-                  sprintf( newkey, "%s(%d)", col, inew );
+/* If the old cell is held in columnar storage, move it to the new row.
+   The new cell will have been emptied already since inew <= iold. Like
+   a renamed KeyMap entry, the moved cell gets new ages. */
+                  if( store && CELL_SET( store, iold + 1 ) ) {
+                     GrowStore( store, inew, status );
+                     if( !astOK ) break;
+                     memcpy( store->data + ( inew - 1 )*store->size,
+                             store->data + iold*store->size, store->size );
+                     store->set[ ( inew - 1 )/8 ] |= 1 << ( ( inew - 1 ) % 8 );
+                     store->set[ iold/8 ] &= ~( 1 << ( iold % 8 ) );
+                     store->age[ inew - 1 ] = astMapNewAge( this );
+                     store->keyage[ inew - 1 ] = astMapNewAge( this );
+
+/* Otherwise, rename any entry in the parent KeyMap. First form the old
+   and new cell names */
+                  } else if( !store || store->spill ) {
+                     sprintf( oldkey, "%s(%d)", col, iold + 1 );
+                     sprintf( newkey, "%s(%d)", col, inew );
 
 /* Rename the KeyMap entry. */
-                  astMapRename( this, oldkey, newkey );
+                     (*parent_maprename)( (AstKeyMap *) this, oldkey, newkey,
+                                          status );
+                  }
                }
             }
          }
@@ -3781,6 +5704,315 @@ f        The global status.
 
 }
 
+static void PutCell( AstTable *this, AstTableColumn *store, int irow,
+                     const void *value, int *status ) {
+/*
+*  Name:
+*     PutCell
+
+*  Purpose:
+*     Store a cell value in columnar storage.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void PutCell( AstTable *this, AstTableColumn *store, int irow,
+*                   const void *value, int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function stores a cell value in columnar storage, removing
+*     any value for the same cell from the parent KeyMap.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     store
+*        Pointer to the column storage.
+*     irow
+*        The one-based row index of the cell.
+*     value
+*        Pointer to the cell value, in the native data type of the
+*        column.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key */
+   int keyage;                   /* Age of cell key */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Ensure there is room for the cell. */
+   GrowStore( store, irow, status );
+   if( astOK ) {
+
+/* Get the age of any existing key for the cell. */
+      keyage = KeyAge( this, store, irow, status );
+
+/* If the cell is not currently in use, remove any value for the cell
+   from the parent KeyMap, and flag the cell as in use. */
+      if( !CELL_SET( store, irow ) ) {
+         if( store->spill ) {
+            sprintf( key, "%s(%d)", store->name, irow );
+            (*parent_mapremove)( (AstKeyMap *) this, key, status );
+         }
+         store->set[ ( irow - 1 )/8 ] |= 1 << ( ( irow - 1 ) % 8 );
+         store->nset++;
+      }
+
+/* Give the cell the ages that the parent KeyMap would give to a new
+   entry. The key retains its original age if it already existed. */
+      store->age[ irow - 1 ] = astMapNewAge( this );
+      if( keyage < 0 ) keyage = astMapNewAge( this );
+      store->keyage[ irow - 1 ] = keyage;
+
+/* Store the value. */
+      memcpy( store->data + ( irow - 1 )*store->size, value, store->size );
+   }
+}
+
+static int PutColumnCells( AstTable *this, const char *column, int nrow,
+                           const void *data, const unsigned char *skip,
+                           int borrow, int *status ) {
+/*
+*+
+*  Name:
+*     astPutColumnCells
+
+*  Purpose:
+*     Store the values of a numerical column directly in columnar storage.
+
+*  Type:
+*     Protected virtual function.
+
+*  Synopsis:
+*     #include "table.h"
+*     int astPutColumnCells( AstTable *this, const char *column, int nrow,
+*                            const void *data, const unsigned char *skip,
+*                            int borrow )
+
+*  Class Membership:
+*     Table method.
+
+*  Description:
+*     This function stores new values for the first "nrow" cells of a
+*     numerical column, replacing any existing values. It can be used to
+*     store a whole column more efficiently than using the astMapPut1<X>
+*     method for each cell. The number of rows in the Table is increased
+*     if necessary.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     column
+*        The column name.
+*     nrow
+*        The number of rows to store.
+*     data
+*        Pointer to an array holding the new cell values, in the native
+*        data type of the column. It should hold "nrow" cells, each holding
+*        the number of values returned by astGetColumnLength.
+*     skip
+*        Pointer to an array with "nrow" elements, or NULL. If supplied,
+*        any cell for which the corresponding element is non-zero is left
+*        unchanged (or is left without a value if "borrow" is non-zero).
+*     borrow
+*        If non-zero, the Table uses the supplied "data" array directly
+*        as the column array, rather than taking a copy of it, and all
+*        existing values in the column are discarded. The array is shared
+*        by any copies of the Table, and may also be used directly by
+*        other Objects created from the Table (see astGetBorrowedCells).
+*        It is never modified by the Table - a private copy is taken if
+*        any cell in the column is subsequently changed. The caller must
+*        ensure that the array is not changed or freed until the Table,
+*        and all such Objects, have been deleted.
+
+*  Returned Value:
+*     Non-zero if the values were stored. Zero is returned, and the Table
+*     is left unchanged, if the column is not held in columnar storage or
+*     if the Table is locked (see attribute MapLocked). The astMapPut1<X>
+*     methods should then be used instead.
+
+*-
+*/
+
+/* Local Variables: */
+   AstTableColumn *store;        /* Pointer to column storage */
+   char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key */
+   int *keyage;                  /* Ages of existing cell keys */
+   int irow;                     /* Row index */
+   int lastrow;                  /* Last row stored */
+   int n;                        /* No. of rows in Table */
+   int result;                   /* Returned flag */
+   unsigned char *set;           /* Pointer to new mask */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status. */
+   if ( !astOK || nrow <= 0 ) return result;
+
+/* Find the column storage. Locked Tables are handled by the KeyMap
+   methods since they may need to report errors. */
+   store = FindStore( this, column, status );
+   if( store && !astGetMapLocked( this ) ) {
+      result = 1;
+
+/* Record the age of any existing key for each cell, so that it can be
+   retained when the cell is given its new value. */
+      keyage = astMalloc( nrow*sizeof( int ) );
+      for( irow = 1; irow <= nrow && astOK; irow++ ) {
+         keyage[ irow - 1 ] = KeyAge( this, store, irow, status );
+      }
+
+/* If the supplied array is to be borrowed, discard all existing values
+   in the column, including any held in the parent KeyMap, and then use
+   the supplied array in place of the column array. */
+      if( borrow ) {
+         if( store->spill ) {
+            n = astGetNrow( this );
+            for( irow = 1; irow <= n; irow++ ) {
+               sprintf( key, "%s(%d)", store->name, irow );
+               (*parent_mapremove)( (AstKeyMap *) this, key, status );
+            }
+            store->spill = 0;
+         }
+         set = astCalloc( ( nrow + 7 )/8, 1 );
+         if( astOK ) {
+            if( !store->borrowed ) store->data = astFree( store->data );
+            store->set = astFree( store->set );
+            store->age = astFree( store->age );
+            store->keyage = astFree( store->keyage );
+            store->data = (char *) data;
+            store->set = set;
+            store->age = astMalloc( nrow*sizeof( int ) );
+            store->keyage = astMalloc( nrow*sizeof( int ) );
+            store->mxrow = nrow;
+            store->nset = 0;
+            store->borrowed = 1;
+         }
+
+/* Otherwise, ensure there is room for the cells. */
+      } else {
+         GrowStore( store, nrow, status );
+      }
+      if( astOK ) {
+
+/* If the parent KeyMap may hold values for any of the cells, remove them. */
+         if( store->spill ) {
+            for( irow = 1; irow <= nrow; irow++ ) {
+               if( ( !skip || !skip[ irow - 1 ] ) &&
+                   !CELL_SET( store, irow ) ) {
+                  sprintf( key, "%s(%d)", store->name, irow );
+                  (*parent_mapremove)( (AstKeyMap *) this, key, status );
+               }
+            }
+         }
+
+/* Copy the values (unless they are borrowed) and flag the cells as in
+   use. Give each cell the ages that the parent KeyMap would give to a
+   new entry, retaining the age of any existing key. */
+         lastrow = 0;
+         if( !skip && !borrow ) memcpy( store->data, data, nrow*store->size );
+         for( irow = 0; irow < nrow && astOK; irow++ ) {
+            if( !skip || !skip[ irow ] ) {
+               if( skip && !borrow ) {
+                  memcpy( store->data + irow*store->size,
+                          (const char *) data + irow*store->size,
+                          store->size );
+               }
+               store->set[ irow/8 ] |= 1 << ( irow % 8 );
+               store->age[ irow ] = astMapNewAge( this );
+               store->keyage[ irow ] = ( keyage[ irow ] >= 0 ) ?
+                                       keyage[ irow ] : astMapNewAge( this );
+               lastrow = irow + 1;
+            }
+         }
+
+/* Count the cells in use. */
+         store->nset = 0;
+         for( irow = 1; irow <= store->mxrow; irow++ ) {
+            if( CELL_SET( store, irow ) ) store->nset++;
+         }
+
+/* Update the number of rows in the table if required. */
+         if( lastrow > astGetNrow( this ) ) astSetNrow( this, lastrow );
+      }
+
+/* Free resources. */
+      keyage = astFree( keyage );
+   }
+
+/* Return the result.*/
+   return result;
+}
+
+static void ReleaseCell( AstTable *this, AstTableColumn *store, int irow,
+                         int copy, int *status ) {
+/*
+*  Name:
+*     ReleaseCell
+
+*  Purpose:
+*     Remove a cell value from columnar storage.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "table.h"
+*     void ReleaseCell( AstTable *this, AstTableColumn *store, int irow,
+*                       int copy, int *status )
+
+*  Class Membership:
+*     Table member function
+
+*  Description:
+*     This function removes a cell value from columnar storage,
+*     optionally storing it in the parent KeyMap first. It returns
+*     without action if the cell is not in use.
+
+*  Parameters:
+*     this
+*        Pointer to the Table.
+*     store
+*        Pointer to the column storage.
+*     irow
+*        The one-based row index of the cell.
+*     copy
+*        If non-zero, the cell value is moved into the parent KeyMap.
+*        Otherwise, the cell value is discarded.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Check the global error status, and that the cell is in use. */
+   if ( !astOK || !CELL_SET( store, irow ) ) return;
+
+/* Copy the value into the parent KeyMap if required. */
+   if( copy ) {
+      ExposeCell( this, store, irow, status );
+      store->spill = 1;
+   }
+
+/* Flag the cell as not in use. The mask may be shared with other Tables,
+   so first ensure it is not. */
+   if( astOK ) store->set = astUnshare( store->set );
+   if( astOK ) {
+      store->set[ ( irow - 1 )/8 ] &= ~( 1 << ( ( irow - 1 ) % 8 ) );
+      store->nset--;
+   }
+}
+
 static void RemoveColumn( AstTable *this, const char *name, int *status ) {
 /*
 *++
@@ -3826,6 +6058,7 @@ f        The global status.
 
 /* Local Variables: */
    AstKeyMap *cols;      /* KeyMap holding column definitions */
+   AstTableColumn *store; /* Pointer to column storage */
    char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key string */
    int irow;             /* Row index */
    int namlen;           /* Used length of "name" */
@@ -3851,10 +6084,26 @@ f        The global status.
 /* Remove the column description from the columns keymap. */
       astMapRemove( cols, name );
 
-/* Remove any column cells with defined values from the parent KeyMap. */
-      for( irow = 1; irow <= nrow; irow++ ) {
-         sprintf( key, "%.*s(%d)", namlen, name, irow );
-         (*parent_mapremove)( (AstKeyMap *) this, key, status );
+/* Remove any column cells with defined values from the parent KeyMap
+   (unless they are all held in columnar storage). */
+      store = FindStore( this, name, status );
+      if( !store || store->spill ) {
+         for( irow = 1; irow <= nrow; irow++ ) {
+            sprintf( key, "%.*s(%d)", namlen, name, irow );
+            (*parent_mapremove)( (AstKeyMap *) this, key, status );
+         }
+      }
+
+/* Free any columnar storage, and remove it from the array. */
+      if( store ) {
+         store->name = astFree( store->name );
+         if( !store->borrowed ) store->data = astFree( store->data );
+         store->set = astFree( store->set );
+         store->age = astFree( store->age );
+         store->keyage = astFree( store->keyage );
+         memmove( store, store + 1, ( this->nstore - ( store - this->store )
+                                      - 1 )*sizeof( AstTableColumn ) );
+         this->nstore--;
       }
    }
    cols = astAnnul( cols );
@@ -3972,6 +6221,7 @@ f        The global status.
 
 /* Local Variables: */
    AstKeyMap *cols;              /* KeyMap holding column definitions */
+   AstTableColumn *store;        /* Pointer to column storage */
    char key[ AST__MXCOLKEYLEN + 1 ]; /* Cell key string */
    const char *col;              /* Column name */
    int icol;                     /* Column index */
@@ -3993,9 +6243,15 @@ f        The global status.
       for( icol = 0; icol < ncol; icol++ ) {
          col = astMapKey( cols, icol );
 
-/* Remove the cell of the current column at the requested row. */
-         sprintf( key, "%s(%d)", col, index );
-         (*parent_mapremove)( (AstKeyMap *) this, key, status );
+/* Remove the cell of the current column at the requested row, from
+   columnar storage or from the parent KeyMap. */
+         store = FindStore( this, col, status );
+         if( store && CELL_SET( store, index ) ) {
+            ReleaseCell( this, store, index, 0, status );
+         } else if( !store || store->spill ) {
+            sprintf( key, "%s(%d)", col, index );
+            (*parent_mapremove)( (AstKeyMap *) this, key, status );
+         }
       }
       cols = astAnnul( cols );
 
@@ -4292,6 +6548,61 @@ static const char *TypeString( int type ) {
    return result;
 }
 
+static size_t TypeSize( int type ) {
+/*
+*  Name:
+*     TypeSize
+
+*  Purpose:
+*     Return the number of bytes used to store a value of a given data type.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*      size_t TypeSize( int type );
+
+*  Description:
+*     This function returns the number of bytes needed to store a single
+*     value of a given numerical data type in columnar storage.
+
+*  Parameters:
+*     type
+*        The integer data type code.
+
+*  Returned Value:
+*     The number of bytes, or zero if values of the supplied data type
+*     cannot be held in columnar storage.
+
+*/
+
+/* Local Variables: */
+   size_t result;
+
+/* Compare the supplied type code against each supported value. */
+   if( type == AST__INTTYPE ) {
+      result = sizeof( int );
+
+   } else if( type == AST__DOUBLETYPE ) {
+      result = sizeof( double );
+
+   } else if( type == AST__FLOATTYPE ) {
+      result = sizeof( float );
+
+   } else if( type == AST__SINTTYPE ) {
+      result = sizeof( short int );
+
+   } else if( type == AST__BYTETYPE ) {
+      result = sizeof( unsigned char );
+
+   } else {
+      result = 0;
+   }
+
+/* Return the result. */
+   return result;
+}
+
 
 /* Functions which access class attributes. */
 /* ---------------------------------------- */
@@ -4557,12 +6868,15 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
 
 *  Notes:
 *     -  This constructor makes a deep copy, including a copy of the component
-*     Mappings within the Table.
+*     Mappings within the Table, except that the column arrays are shared
+*     with the input Table.
 */
 
 /* Local Variables: */
    AstTable *in;                /* Pointer to input Table */
    AstTable *out;               /* Pointer to output Table */
+   AstTableColumn *store;       /* Pointer to output column storage */
+   int i;                       /* Index of column storage */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -4575,6 +6889,23 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    output Table structure. */
    out->columns = in->columns ? astCopy( in->columns ) : NULL;
    out->parameters = in->parameters ? astCopy( in->parameters ) : NULL;
+
+/* Make a deep copy of the columnar storage. The column arrays are
+   shared with the input Table rather than copied (see astShare), and are
+   unshared by OwnStore before being modified. Borrowed column arrays are
+   simply used by both Tables. */
+   out->store = in->store ? astStore( NULL, in->store,
+                                      in->nstore*sizeof( AstTableColumn ) ) : NULL;
+   if( !out->store ) out->nstore = 0;
+   for( i = 0; i < out->nstore; i++ ) {
+      store = out->store + i;
+      store->name = astStore( NULL, in->store[ i ].name,
+                              strlen( in->store[ i ].name ) + 1 );
+      if( !store->borrowed ) store->data = astShare( in->store[ i ].data );
+      store->set = astShare( in->store[ i ].set );
+      store->age = astShare( in->store[ i ].age );
+      store->keyage = astShare( in->store[ i ].keyage );
+   }
 }
 
 
@@ -4613,6 +6944,7 @@ static void Delete( AstObject *obj, int *status ) {
 
 /* Local Variables: */
    AstTable *this;              /* Pointer to Table */
+   int i;                       /* Index of column storage */
 
 /* Obtain a pointer to the Table structure. */
    this = (AstTable *) obj;
@@ -4621,6 +6953,20 @@ static void Delete( AstObject *obj, int *status ) {
    if( this->columns ) this->columns = astAnnul( this->columns );
    if( this->parameters ) this->parameters = astAnnul( this->parameters );
 
+/* Free the columnar storage. Borrowed column arrays are owned by
+   someone else and so are not freed. */
+   for( i = 0; i < this->nstore; i++ ) {
+      this->store[ i ].name = astFree( this->store[ i ].name );
+      if( !this->store[ i ].borrowed ) {
+         this->store[ i ].data = astFree( this->store[ i ].data );
+      }
+      this->store[ i ].set = astFree( this->store[ i ].set );
+      this->store[ i ].age = astFree( this->store[ i ].age );
+      this->store[ i ].keyage = astFree( this->store[ i ].keyage );
+   }
+   this->store = astFree( this->store );
+   this->nstore = 0;
+
 }
 
 
@@ -4752,9 +7098,12 @@ c     astAddParameter
 f     AST_ADDPARAMETER
 *     method before being accessed.
 *
-*     Note - since accessing entries within a KeyMap is a relatively slow
-*     process, it is not recommended to use the Table class to store
-*     very large tables.
+*     The values in columns holding numerical data (i.e. any data type
+*     other than string, Object or pointer) are stored internally in
+*     contiguous arrays, one per column, rather than as separate KeyMap
+*     entries. This reduces the memory needed for large tables and allows
+*     whole columns to be copied efficiently. The values can still be
+*     accessed using the normal KeyMap methods, as described above.
 
 *  Parameters:
 c     options
@@ -5000,6 +7349,8 @@ AstTable *astInitTable_( void *mem, size_t size, int init,
       new->nrow = 0;
       new->columns = astKeyMap( "KeyCase=0,Sortby=AgeDown", status );
       new->parameters = astKeyMap( "KeyCase=0,Sortby=AgeDown", status );
+      new->nstore = 0;
+      new->store = NULL;
 
 /* Tables require the KeyCase attribute to be zero. */
       (*parent_setkeycase)( (AstKeyMap *) new, 0, status );
@@ -5088,7 +7439,18 @@ AstTable *astLoadTable_( void *mem, size_t size, AstTableVtab *vtab,
 
 /* Local Variables: */
    astDECLARE_GLOBALS            /* Pointer to thread-specific global data */
+   AstKeyMap *col_km;            /* KeyMap holding column details */
    AstTable *new;                /* Pointer to the new Table */
+   AstTableColumn *store;        /* Pointer to column storage */
+   const char *colname;          /* Column name */
+   int *dims;                    /* Column shape */
+   int icol;                     /* Column index */
+   int idim;                     /* Axis index */
+   int ncol;                     /* Number of columns */
+   int ndim;                     /* Number of axes */
+   int nel;                      /* Number of values in each cell */
+   int nval;                     /* Number of values returned */
+   int type;                     /* Column data type */
 
 /* Initialise. */
    new = NULL;
@@ -5141,6 +7503,35 @@ AstTable *astLoadTable_( void *mem, size_t size, AstTableVtab *vtab,
 /* KeyMap holding parameter definitions. */
       new->parameters = astReadObject( channel, "params", NULL );
 
+/* Create columnar storage for each numerical column. All the cell values
+   read from the Channel are held in the parent KeyMap, so indicate that
+   the parent KeyMap may hold cells for each column. New values will be
+   held in columnar storage. */
+      new->nstore = 0;
+      new->store = NULL;
+      ncol = new->columns ? astMapSize( new->columns ) : 0;
+      for( icol = 0; icol < ncol && astOK; icol++ ) {
+         colname = astMapKey( new->columns, icol );
+         if( astMapGet0A( new->columns, colname, &col_km ) ) {
+            if( astMapGet0I( col_km, TYPE, &type ) ) {
+               nel = 1;
+               ndim = astMapLength( col_km, SHAPE );
+               if( ndim > 0 ) {
+                  dims = astMalloc( sizeof( int )*ndim );
+                  (void) astMapGet1I( col_km, SHAPE, ndim, &nval, dims );
+                  for( idim = 0; idim < ndim && astOK; idim++ ) {
+                     nel *= dims[ idim ];
+                  }
+                  dims = astFree( dims );
+               }
+               store = MakeStore( new, colname, type, nel, ( ndim > 0 ),
+                                 status );
+               if( store ) store->spill = 1;
+            }
+            col_km = astAnnul( col_km );
+         }
+      }
+
 /* If an error occurred, clean up by deleting the new Table. */
       if ( !astOK ) new = astDelete( new );
    }
@@ -5166,6 +7557,22 @@ void astAddColumn_( AstTable *this, const char *name, int type,
    if ( !astOK ) return;
    (**astMEMBER(this,Table,AddColumn))(this,name,type,ndim,dims,unit,status);
 }
+int astGetColumnCells_( AstTable *this, const char *column, int nrow,
+                        void *data, unsigned char *found, int *status ) {
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Table,GetColumnCells))(this,column,nrow,data,found,status);
+}
+int astPutColumnCells_( AstTable *this, const char *column, int nrow,
+                        const void *data, const unsigned char *skip,
+                        int borrow, int *status ) {
+   if ( !astOK ) return 0;
+   return (**astMEMBER(this,Table,PutColumnCells))(this,column,nrow,data,skip,borrow,status);
+}
+const void *astGetBorrowedCells_( AstTable *this, const char *column,
+                                  int *status ) {
+   if ( !astOK ) return NULL;
+   return (**astMEMBER(this,Table,GetBorrowedCells))(this,column,status);
+}
 void astAddParameter_( AstTable *this, const char *name, int *status ) {
    if ( !astOK ) return;
    (**astMEMBER(this,Table,AddParameter))(this,name,status);
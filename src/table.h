@@ -44,10 +44,15 @@
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     22-NOV-2010 (DSB):
 *        Original version.
+*     18-OCT-2026 (AGT):
+*        - Added columnar storage for numerical columns (AstTableColumn).
+*        - Added protected method astGetBorrowedCells, and a "borrow"
+*        argument to astPutColumnCells.
 *-
 */
 
@@ -88,6 +93,31 @@
 
 /* Type Definitions. */
 /* ================= */
+/* Column storage structure. */
+/* ------------------------- */
+/* This structure holds the cell values for a single numerical column
+   in contiguous memory. Cell "irow" (one-based) occupies "size" bytes
+   starting at byte offset (irow-1)*size within "data", and is in use if
+   bit (irow-1) of the "set" mask is set. Cells that are not in use may
+   instead be held as entries in the parent KeyMap. The "age" and "keyage"
+   arrays hold the ages (see astMapNewAge) that the parent KeyMap would
+   have given to each cell in use. */
+typedef struct AstTableColumn {
+   char *name;                   /* Upper case column name */
+   int type;                     /* KeyMap data type of each value */
+   int nel;                      /* No. of values in each cell */
+   int vector;                   /* Does the column hold vector values? */
+   size_t size;                  /* No. of bytes in each cell */
+   int mxrow;                    /* No. of cells for which memory is allocated */
+   int nset;                     /* No. of cells in use */
+   int spill;                    /* May the parent KeyMap hold any cells? */
+   char *data;                   /* Cell values */
+   unsigned char *set;           /* Mask of cells in use */
+   int *age;                     /* KeyMap age of each cell value */
+   int *keyage;                  /* KeyMap age of each cell key */
+   int borrowed;                 /* Is "data" owned by the caller? */
+} AstTableColumn;
+
 /* Table structure. */
 /* ----------------- */
 /* This structure contains all information that is unique to each
@@ -101,6 +131,8 @@ typedef struct AstTable {
    int nrow;                     /* Mo. of rows in table */
    AstKeyMap *columns;           /* KeyMap holding column definitions */
    AstKeyMap *parameters;        /* KeyMap holding parameter definitions */
+   int nstore;                   /* No. of columns with columnar storage */
+   AstTableColumn *store;        /* Columnar storage for numerical columns */
 } AstTable;
 
 /* Virtual function table. */
@@ -131,6 +163,9 @@ typedef struct AstTableVtab {
    int (* GetNrow)( AstTable *, int * );
    int (* HasColumn)( AstTable *, const char *, int * );
    int (* HasParameter)( AstTable *, const char *, int * );
+   int (* GetColumnCells)( AstTable *, const char *, int, void *, unsigned char *, int * );
+   int (* PutColumnCells)( AstTable *, const char *, int, const void *, const unsigned char *, int, int * );
+   const void *(* GetBorrowedCells)( AstTable *, const char *, int * );
    void (* AddColumn)( AstTable *, const char *, int, int, int *, const char *, int * );
    void (* AddParameter)( AstTable *, const char *, int * );
    void (* ColumnShape)( AstTable *, const char *, int, int *, int *, int * );
@@ -215,6 +250,9 @@ int astGetNcolumn_( AstTable *, int * );
 int astGetNparameter_( AstTable *, int * );
 int astGetNrow_( AstTable *, int * );
 void astSetNrow_( AstTable *, int, int * );
+int astGetColumnCells_( AstTable *, const char *, int, void *, unsigned char *, int * );
+int astPutColumnCells_( AstTable *, const char *, int, const void *, const unsigned char *, int, int * );
+const void *astGetBorrowedCells_( AstTable *, const char *, int * );
 #endif
 
 /* Function interfaces. */
@@ -299,6 +337,12 @@ astINVOKE(V,astGetColumnNdim_(astCheckTable(this),column,STATUS_PTR))
 astINVOKE(V,astGetColumnType_(astCheckTable(this),column,STATUS_PTR))
 #define astGetColumnUnit(this,column) \
 astINVOKE(V,astGetColumnUnit_(astCheckTable(this),column,STATUS_PTR))
+#define astGetColumnCells(this,column,nrow,data,found) \
+astINVOKE(V,astGetColumnCells_(astCheckTable(this),column,nrow,data,found,STATUS_PTR))
+#define astPutColumnCells(this,column,nrow,data,skip,borrow) \
+astINVOKE(V,astPutColumnCells_(astCheckTable(this),column,nrow,data,skip,borrow,STATUS_PTR))
+#define astGetBorrowedCells(this,column) \
+astINVOKE(V,astGetBorrowedCells_(astCheckTable(this),column,STATUS_PTR))
 
 #endif
 #endif
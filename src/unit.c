@@ -37,6 +37,7 @@
 
 *  Authors:
 *     DSB: D.S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     10-DEC-2002 (DSB):
@@ -90,6 +91,16 @@
 *     9-MAY-2011 (DSB):
 *        Change "A" to be Ampere (as defined by FITS-WCS paper 1) rather
 *        than "Angstrom".
+*     18-OCT-2026 (AGT):
+*        - Reduce the cost of the first use of the known units. The tree
+*        defining each known derived unit is now created when it is first
+*        needed (see GetUnitTree), rather than the trees for all units
+*        being created when the list of known units is created.
+*        - The list of standard multipliers is now a statically
+*        initialised table, so no initialisation or locking is needed to
+*        use it.
+*        - Profile the creation of the known units list and unit trees,
+*        and calls to astUnitMapper (see the "Profile" tuning parameter).
 */
 
 /* Module Macros. */
@@ -193,7 +204,9 @@ typedef struct KnownUnit {
    const char *label;       /* Unit label string (null terminated) */
    int symlen;              /* Length of symbol (without trailing null ) */
    int lablen;              /* Length of label (without trailing null ) */
-   struct UnitNode *head;   /* Head of definition tree (NULL for basic units) */
+   const char *exp;         /* Definition string (NULL for basic units) */
+   struct UnitNode *head;   /* Head of definition tree (NULL for basic
+                               units, or if not yet created) */
    struct KnownUnit *next;  /* Next KnownUnit in linked list */
    struct KnownUnit *use;   /* KnownUnit to be used in place of this one */
 } KnownUnit;
@@ -209,9 +222,32 @@ static KnownUnit *known_units = NULL;
 used in dimensional analysis. */
 static KnownUnit *quant_units[ NQUANT ];
 
-/* A pointer to the Multiplier structure at the head of a linked list of
-   such structures containing definitions of all known multipliers. */
-static Multiplier *multipliers = NULL;
+/* A linked list of Multiplier structures containing definitions of all
+   the standard multipliers listed in FITS WCS paper I. The first element
+   is the head of the list. Longer symbols (e.g. "da") must come before
+   any shorter symbols with which they start (e.g. "d"). */
+static Multiplier multipliers[] = {
+   { "yotta", "Y",  1, 5, 1.0E24,  multipliers + 1 },
+   { "zetta", "Z",  1, 5, 1.0E21,  multipliers + 2 },
+   { "exa",   "E",  1, 3, 1.0E18,  multipliers + 3 },
+   { "peta",  "P",  1, 4, 1.0E15,  multipliers + 4 },
+   { "tera",  "T",  1, 4, 1.0E12,  multipliers + 5 },
+   { "giga",  "G",  1, 4, 1.0E9,   multipliers + 6 },
+   { "mega",  "M",  1, 4, 1.0E6,   multipliers + 7 },
+   { "kilo",  "k",  1, 4, 1.0E3,   multipliers + 8 },
+   { "hecto", "h",  1, 5, 1.0E2,   multipliers + 9 },
+   { "deca",  "da", 2, 4, 1.0E1,   multipliers + 10 },
+   { "yocto", "y",  1, 5, 1.0E-24, multipliers + 11 },
+   { "zepto", "z",  1, 5, 1.0E-21, multipliers + 12 },
+   { "atto",  "a",  1, 4, 1.0E-18, multipliers + 13 },
+   { "femto", "f",  1, 5, 1.0E-15, multipliers + 14 },
+   { "pico",  "p",  1, 4, 1.0E-12, multipliers + 15 },
+   { "nano",  "n",  1, 4, 1.0E-9,  multipliers + 16 },
+   { "micro", "u",  1, 5, 1.0E-6,  multipliers + 17 },
+   { "milli", "m",  1, 5, 1.0E-3,  multipliers + 18 },
+   { "centi", "c",  1, 5, 1.0E-2,  multipliers + 19 },
+   { "deci",  "d",  1, 4, 1.0E-1,  NULL }
+};
 
 /* Set up mutexes */
 #ifdef THREAD_SAFE
@@ -220,18 +256,11 @@ static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX1 pthread_mutex_lock( &mutex1 );
 #define UNLOCK_MUTEX1 pthread_mutex_unlock( &mutex1 );
 
-static pthread_mutex_t mutex2 = PTHREAD_MUTEX_INITIALIZER;
-#define LOCK_MUTEX2 pthread_mutex_lock( &mutex2 );
-#define UNLOCK_MUTEX2 pthread_mutex_unlock( &mutex2 );
-
 #else
 
 #define LOCK_MUTEX1
 #define UNLOCK_MUTEX1
 
-#define LOCK_MUTEX2
-#define UNLOCK_MUTEX2
-
 #endif
 
 /* Prototypes for Private Functions. */
@@ -244,6 +273,7 @@ static UnitNode *CopyTree( UnitNode *, int * );
 static UnitNode *CreateTree( const char *, int, int, int * );
 static UnitNode *FixUnits( UnitNode *, UnitNode *, int * );
 static UnitNode *FreeTree( UnitNode *, int * );
+static UnitNode *GetUnitTree( KnownUnit *, int, int * );
 static UnitNode *MakeTree( const char *, int, int, int * );
 static UnitNode *MakeLabelTree( const char *, int, int * );
 static UnitNode *NewNode( UnitNode *, Oper, int * );
@@ -257,7 +287,7 @@ static UnitNode *InvertTree( UnitNode *, UnitNode *, int * );
 static void LocateUnits( UnitNode *, UnitNode ***, int *, int * );
 static void MakeKnownUnit( const char *, const char *, const char *, int * );
 static void MakeUnitAlias( const char *, const char *, int * );
-static void RemakeTree( UnitNode **, int * );
+static void RemakeTree( UnitNode **, int, int * );
 static int SimplifyTree( UnitNode **, int, int * );
 static int ComplicateTree( UnitNode **, int * );
 static int ReplaceNode( UnitNode *, UnitNode *, UnitNode *, int * );
@@ -1357,7 +1387,7 @@ static UnitNode *CreateTree( const char *exp, int basic, int lock, int *status )
 /* Now replace each LDVAR node which refers to a known derived unit with
    a sub-tree which defines the derived unit in terms of known basic units.
    The LDVAR nodes in the resulting tree all refer to basic units. */
-      if( basic ) RemakeTree( &result, status );
+      if( basic ) RemakeTree( &result, lock, status );
    }
 
 /* Free resources. */
@@ -2155,7 +2185,9 @@ static KnownUnit *GetKnownUnits( int lock, int *status ) {
 *  Description:
 *     This function returns a pointer to the head of a linked list of known
 *     unit definitions. The unit definitions are created as static module
-*     variables if they have not previously been created.
+*     variables if they have not previously been created. The trees that
+*     define derived units in terms of basic units are not created until
+*     they are needed (see GetUnitTree).
 
 *  Parameters:
 *     lock
@@ -2173,6 +2205,7 @@ static KnownUnit *GetKnownUnits( int lock, int *status ) {
 */
 
 /* Local Variables: */
+   AstProfileCall call;
    int iq;
    KnownUnit *result;
 
@@ -2191,6 +2224,7 @@ static KnownUnit *GetKnownUnits( int lock, int *status ) {
    has not yet been created, create it now. A pointer to the head of the
    linked list is put into the static variable "known_units". */
    if( !known_units ) {
+      astProfileStartClass( &call, "KnownUnits", "Unit", 0.0 );
 
 /* At the same time we store pointers to the units describing the basic
    quantities used in dimensional analysis. Initialise th index of the
@@ -2284,6 +2318,7 @@ static KnownUnit *GetKnownUnits( int lock, int *status ) {
       MakeUnitAlias( "pixel", "pix", status );
       MakeUnitAlias( "s", "sec", status );
       MakeUnitAlias( "m", "meter", status );
+      astProfileStop( &call );
    }
 
 /* If succesful, return the pointer to the head of the list. */
@@ -2318,20 +2353,71 @@ static Multiplier *GetMultipliers( int *status ) {
 
 *  Description:
 *     This function returns a pointer to the head of a linked list of known
-*     multiplier definitions. The multiplier definitions are created as
-*     static module variables if they have not previously been created.
+*     multiplier definitions. The multiplier definitions are held in a
+*     statically initialised module variable, and so can be used by any
+*     thread without locking.
 
 *  Returned Value:
 *     A pointer to the first known multiplier definition.
 
+*  Notes:
+*     - A NULL pointer is returned if it is invoked with the global error
+*     status set.
+*/
+
+/* Check inherited status. */
+   if( !astOK ) return NULL;
+
+/* Return the pointer to the head of the list. */
+   return multipliers;
+}
+
+static UnitNode *GetUnitTree( KnownUnit *unit, int lock, int *status ) {
+/*
+*  Name:
+*     GetUnitTree
+
+*  Purpose:
+*     Get the tree of UnitNodes defining a known unit.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "unit.h"
+*     UnitNode *GetUnitTree( KnownUnit *unit, int lock, int *status )
+
+*  Class Membership:
+*     Unit member function.
+
+*  Description:
+*     This function returns a pointer to the tree of UnitNodes that
+*     defines a known derived unit in terms of known basic units. The
+*     tree is created from the definition string stored in the KnownUnit
+*     if it has not previously been created, and is then retained for
+*     use by later calls.
+
+*  Parameters:
+*     unit
+*        Pointer to the KnownUnit.
+*     lock
+*        If non-zero, then lock a mutex prior to accessing the list of
+*        known units.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the UnitNode at the head of the tree. This should not
+*     be modified or freed. NULL is returned if the unit is a basic unit.
+
 *  Notes:
 *     - A NULL pointer is returned if it is invoked with the global error
 *     status set, or if an error occurs.
 */
 
 /* Local Variables: */
-   Multiplier *result;
-   Multiplier *mult;
+   AstProfileCall call;
+   UnitNode *result;
 
 /* Initialise. */
    result = NULL;
@@ -2339,61 +2425,32 @@ static Multiplier *GetMultipliers( int *status ) {
 /* Check inherited status. */
    if( !astOK ) return result;
 
-/* Ensure the list is only initialised by one thread. */
-   LOCK_MUTEX2
-
-/* If the linked list of Multiplier structures describing the known
-   multipliers has not yet been created, create it now. A pointer to the
-   head of the linked list is put into the static variable "multipliers". */
-   if( !multipliers ) {
-
-/* Define a macro to create a multiplier struncture and add it to the
-   linked list of multiplier structures. */
-#define MAKEMULT(s,sl,sc,lab,ll) \
-      mult = astMalloc( sizeof( Multiplier ) ); \
-      if( astOK ) { \
-         mult->sym = s; \
-         mult->symlen = sl; \
-         mult->lablen = ll; \
-         mult->scale = sc; \
-         mult->label = lab; \
-         mult->next = multipliers; \
-         multipliers = mult; \
-      }
-
-/* Use the above macro to create all the standard multipliers listed in the
-   FITS WCS paper I. */
-      MAKEMULT("d",1,1.0E-1,"deci",4)
-      MAKEMULT("c",1,1.0E-2,"centi",5)
-      MAKEMULT("m",1,1.0E-3,"milli",5)
-      MAKEMULT("u",1,1.0E-6,"micro",5)
-      MAKEMULT("n",1,1.0E-9,"nano",4)
-      MAKEMULT("p",1,1.0E-12,"pico",4)
-      MAKEMULT("f",1,1.0E-15,"femto",5)
-      MAKEMULT("a",1,1.0E-18,"atto",4)
-      MAKEMULT("z",1,1.0E-21,"zepto",5)
-      MAKEMULT("y",1,1.0E-24,"yocto",5)
-      MAKEMULT("da",2,1.0E1,"deca",4)
-      MAKEMULT("h",1,1.0E2,"hecto",5)
-      MAKEMULT("k",1,1.0E3,"kilo",4)
-      MAKEMULT("M",1,1.0E6,"mega",4)
-      MAKEMULT("G",1,1.0E9,"giga",4)
-      MAKEMULT("T",1,1.0E12,"tera",4)
-      MAKEMULT("P",1,1.0E15,"peta",4)
-      MAKEMULT("E",1,1.0E18,"exa",3)
-      MAKEMULT("Z",1,1.0E21,"zetta",5)
-      MAKEMULT("Y",1,1.0E24,"yotta",5)
-
-/* Undefine the macro. */
-#undef MAKEMULT
+/* Ensure the tree is only created once. */
+   if( lock ) {
+      LOCK_MUTEX1
+   }
 
+/* If the tree has not yet been created, create it now from the
+   definition string. The tree is expanded so that all its leaf nodes
+   are basic units, which may involve creating the trees for other known
+   units. The mutex is already locked (if required), so tell CreateTree
+   not to lock it again. Indicate that the memory used may never be freed
+   (other than by any AST exit handler). */
+   if( !unit->head && unit->exp ) {
+      astProfileStartClass( &call, "UnitTree", unit->sym, 0.0 );
+      astBeginPM;
+      unit->head = CreateTree( unit->exp, 1, 0, status );
+      astEndPM;
+      astProfileStop( &call );
    }
 
-/* If succesful, return the pointer to the head of the list. */
-   if( astOK ) result = multipliers;
+/* If succesful, return the pointer to the head of the tree. */
+   if( astOK ) result = unit->head;
 
 /* Allow the next thread to proceed. */
-   UNLOCK_MUTEX2
+   if( lock ) {
+      UNLOCK_MUTEX1
+   }
 
 /* Return the result. */
    return result;
@@ -3166,6 +3223,9 @@ static void MakeKnownUnit( const char *sym, const char *label, const char *exp,
 *     Therefore the strings to which the pointers point should not be
 *     modified after this function returned (in fact this function is
 *     always called with literal strings for these arguments).
+*     -  The same applies to the "exp" string. The unit definition is
+*     not parsed until it is first needed (see GetUnitTree), and so may
+*     refer to any known unit.
 */
 
 /* Local Variables: */
@@ -3196,9 +3256,11 @@ static void MakeKnownUnit( const char *sym, const char *label, const char *exp,
 /* Store the length of the label (without the trailing null character). */
       result->lablen = strlen( label );
 
-/* Create a tree of UnitNodes describing the unit if an expression was
-   supplied. */
-      result->head = exp ? CreateTree( exp, 1, 0, status ) : NULL;
+/* Store the pointer to the definition string, if one was supplied. The
+   tree of UnitNodes describing the unit is not created until it is
+   needed (see GetUnitTree). */
+      result->exp = ( exp && astChrLen( exp ) ) ? exp : NULL;
+      result->head = NULL;
 
 /* Unit aliases are replaced in use by the KnownUnit pointed to by the
    "use" component of the structure. Indicate this KnownUnitis not an
@@ -3212,7 +3274,6 @@ static void MakeKnownUnit( const char *sym, const char *label, const char *exp,
 
 /* If an error has occurred, free any returned structure. */
    if( !astOK ) {
-      result->head = FreeTree( result->head, status );
       result = astFree( result ) ;
 
 /* Otherwise, add the new KnownUnit to the head of the linked list of
@@ -4469,7 +4530,7 @@ static UnitNode *NewNode( UnitNode *old, Oper code, int *status ) {
    return result;
 }
 
-static void RemakeTree( UnitNode **node, int *status ) {
+static void RemakeTree( UnitNode **node, int lock, int *status ) {
 /*
 *  Name:
 *     RemakeTree
@@ -4482,7 +4543,7 @@ static void RemakeTree( UnitNode **node, int *status ) {
 
 *  Synopsis:
 *     #include "unit.h"
-*     void RemakeTree( UnitNode **node, int *status )
+*     void RemakeTree( UnitNode **node, int lock, int *status )
 
 *  Class Membership:
 *     Unit member function.
@@ -4498,6 +4559,8 @@ static void RemakeTree( UnitNode **node, int *status ) {
 *        The address of a pointer to the UnitNode at the head of the tree
 *        which is to be simplified. On exit the supplied tree is freed and a
 *        pointer to a new tree is placed at the given address.
+*     lock
+*        Use a mutex to guard access to the KnownUnits list?
 *     status
 *        Pointer to the inherited status variable.
 
@@ -4506,6 +4569,7 @@ static void RemakeTree( UnitNode **node, int *status ) {
 /* Local Variables: */
    KnownUnit *unit;
    int i;
+   UnitNode *head;
    UnitNode *newnode;
 
 /* Check inherited status. */
@@ -4531,8 +4595,9 @@ static void RemakeTree( UnitNode **node, int *status ) {
    the second argument of the OP_MULT node (without the multiplier).
    Otherwise, use a copy of the tree which defines the derived unit. */
                unit = (*node)->unit;
-               if( unit && unit->head ) {
-                  newnode->arg[1] = CopyTree( unit->head, status );
+               head = unit ? GetUnitTree( unit, lock, status ) : NULL;
+               if( head ) {
+                  newnode->arg[1] = CopyTree( head, status );
                } else {
                   newnode->arg[1] = CopyTree( *node, status );
                   if( astOK ) newnode->arg[1]->mult = NULL;
@@ -4545,14 +4610,15 @@ static void RemakeTree( UnitNode **node, int *status ) {
    unknown). */
       } else {
          unit = (*node)->unit;
-         if( unit && unit->head ) newnode = CopyTree( unit->head, status );
+         head = unit ? GetUnitTree( unit, lock, status ) : NULL;
+         if( head ) newnode = CopyTree( head, status );
       }
 
 /* If this is not an LDVAR Node, remake the sub-trees which form the
    arguments of this node. */
    } else {
       for( i = 0; i < (*node)->narg; i++ ) {
-         RemakeTree( &((*node)->arg[ i ]), status );
+         RemakeTree( &((*node)->arg[ i ]), lock, status );
       }
    }
 
@@ -5437,6 +5503,7 @@ AstMapping *astUnitMapper_( const char *in, const char *out,
 /* Local Variables: */
    AstMapping *result;
    UnitNode **units;
+   AstProfileCall call;
    UnitNode *in_tree;
    UnitNode *intemp;
    UnitNode *inv;
@@ -5475,6 +5542,10 @@ AstMapping *astUnitMapper_( const char *in, const char *out,
    out_tree = NULL;
    units = NULL;
 
+/* Record the call if profiling is enabled (see the "Profile" tuning
+   parameter). */
+   astProfileStartClass( &call, "UnitMapper", "Unit", 0.0 );
+
 /* Parse the input units string, producing a tree of UnitNodes which
    represents the input units. A pointer to the UnitNode at the head of
    the tree is returned if succesfull. Report a context message if this
@@ -5750,6 +5821,7 @@ AstMapping *astUnitMapper_( const char *in, const char *out,
       result = astAnnul( result );
       if( in_lab ) *out_lab = astFree( *out_lab );
    }
+   astProfileStop( &call );
 
 /* Return the result. */
    return result;
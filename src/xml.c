@@ -31,6 +31,7 @@
 
 *  Authors:
 *     DSB: David S. Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     22-OCT-2003 (DSB):
@@ -60,6 +61,11 @@
 *     10-DEC-2008 (DSB):
 *        Allow a prefix to be included with the attribute name in
 *        astXmlGetAttributeValue.
+*     18-OCT-2026 (AGT):
+*        Search for content items backwards in astXmlRemoveItem and
+*        astXmlDelete, and delete the content of an element in reverse
+*        order in CleanXml, so that emptying an element takes a time
+*        proportional to the number of items rather than to its square.
 */
 
 
@@ -2707,9 +2713,10 @@ void astXmlRemoveItem_( AstXmlContentItem *this, int *status ){
       elem = (AstXmlElement *) parent;
 
 /* Search through all the items within the parent element looking for the
-   supplied item. */
+   supplied item. Search backwards from the last item so that removing
+   all the items in an element in reverse order is fast. */
       found = 0;
-      for( i = 0; i < elem->nitem; i++ ) {
+      for( i = elem->nitem - 1; i >= 0; i-- ) {
          if( elem->items[ i ] == this ) {
 
 /* When found, decrement the number of items in the element, and shuffle
@@ -3447,7 +3454,9 @@ static void CleanXml( AstXmlObject *this, long int type, int *status ){
       while( elem->nattr > 0 ) astXmlDelete( elem->attrs[ 0 ] );
       elem->attrs = astFree( elem->attrs );
 
-      while( elem->nitem > 0 ) astXmlDelete( elem->items[ 0 ] );
+/* Delete the content items last first, since this avoids shuffling the
+   remaining items down on each deletion. */
+      while( elem->nitem > 0 ) astXmlDelete( elem->items[ elem->nitem - 1 ] );
       elem->items = astFree( elem->items );
 
       while( elem->nnspref > 0 ) astXmlDelete( elem->nsprefs[ 0 ] );
@@ -3773,9 +3782,11 @@ void *astXmlDelete_( void *obj_ptr, int *status ){
                }
             }
 
+/* Search content items backwards so that deleting all the items in an
+   element in reverse order is fast. */
          } else if( astXmlCheckType( obj, AST__XMLCONT ) ) {
             n = elem->nitem;
-            for( i = 0; i < n; i++ ) {
+            for( i = n - 1; i >= 0; i-- ) {
                if( elem->items[ i ] == (AstXmlContentItem *) obj ) {
                   for( j = i + 1; j < n; j++ ) {
                      elem->items[ j - 1 ] =  elem->items[ j ];
@@ -73,6 +73,7 @@ f     The XmlChan class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David Berry (Starlink)
+*     AGT: Agent
 
 *  History:
 *     10-OCT-2003 (DSB):
@@ -93,6 +94,20 @@ f     The XmlChan class does not define any new routines beyond those
 *        This bug only manifested itself as a result of running the STC
 *        tester on a 32 bit machine, where the loss of prcision caused
 *        by the bug caused a test to fail.
+*     18-OCT-2026 (AGT):
+*        Write floating point attribute values using the fewest digits
+*        that read back exactly (see astDouble2Chr), and use astChr2Double
+*        to read them.
+*        - Support the ShareObjects attribute by writing later uses of a
+*        shared Object as "_ref" elements, and re-creating the sharing
+*        when such elements are read.
+*        - Index the elements within each container when reading, so
+*        that FindAttribute and FindObject no longer need to search the
+*        whole container for each value, and delete used elements in a
+*        single pass once the container has been read (see Remove and
+*        PurgeContent). This makes the time taken to read large Objects
+*        (e.g. PolyMaps with many coefficients) proportional to their
+*        size, rather than to its square.
 *class--
 
 * Further STC work:
@@ -158,6 +173,14 @@ f     The XmlChan class does not define any new routines beyond those
 /* A string used to indicate atrue attribute value */
 #define TRUE "true"
 
+/* The XML element name used to refer to an AST Object that has already
+   been written out (see the ShareObjects attribute). */
+#define REF "_ref"
+
+/* The XML attribute name which holds the identifier of an AST Object
+   that is referred to by a REF element. */
+#define ID "id"
+
 /* Format identifiers and strings */
 #define UNKNOWN_FORMAT  -1
 #define NATIVE_FORMAT    0
@@ -286,6 +309,7 @@ static const char *(* parent_getattrib)( AstObject *, const char *, int * );
 static int (* parent_testattrib)( AstObject *, const char *, int * );
 static void (* parent_clearattrib)( AstObject *, const char *, int * );
 static void (* parent_setattrib)( AstObject *, const char *, int * );
+static void (* parent_resetsharedobjects)( AstChannel *, int * );
 static int (* parent_getfull)( AstChannel *, int * );
 static int (* parent_getcomment)( AstChannel *, int * );
 static int (* parent_getindent)( AstChannel *, int * );
@@ -362,6 +386,7 @@ static AstObject *MakeAstFromXml( AstXmlChan *, AstXmlElement *, int * );
 static AstObject *ObsDataLocationReader( AstXmlChan *, AstXmlElement *, int * );
 static AstObject *Read( AstChannel *, int * );
 static AstObject *ReadObject( AstChannel *, const char *, AstObject *, int * );
+static AstObject *ReadShared( AstXmlChan *, AstXmlElement *, const char *, int * );
 static AstObject *RedshiftFrameReader( AstXmlChan *, AstXmlElement *, int * );
 static AstObject *SpaceFrameReader( AstXmlChan *, AstXmlElement *, int * );
 static AstObject *SpectralFrameReader( AstXmlChan *, AstXmlElement *, int * );
@@ -398,6 +423,7 @@ static AstSystemType SpecSys( AstXmlChan *, AstXmlElement *, const char *, int,
 static AstXmlElement *FindAttribute( AstXmlChan *, const char *, int * );
 static AstXmlElement *FindElement( AstXmlChan *, AstXmlElement *, const char *, int * );
 static AstXmlElement *FindObject( AstXmlChan *, const char *, int * );
+static AstXmlElement *FindShared( AstXmlElement *, const char *, int * );
 static AstXmlElement *MakePos2D( AstXmlChan *, AstXmlElement *, int * );
 static AstXmlElement *ReadXmlText( AstXmlChan *, int * );
 static AstXmlElement *Remove( AstXmlChan *, AstXmlElement *, int * );
@@ -425,6 +451,8 @@ static int FindString( int, const char *[], const char *, const char *, const ch
 static int GetComment( AstChannel *, int * );
 static int GetFull( AstChannel *, int * );
 static int GetIndent( AstChannel *, int * );
+static int IndexFind( AstXmlChan *, int, const char *, AstXmlElement **, int * );
+static int IndexKey( int, const char *, const char *, char *, int * );
 static int IsUsable( AstXmlElement *, int * );
 static int ReadInt( AstChannel *, const char *, int, int * );
 static int64_t ReadInt64( AstChannel *, const char *, int64_t, int * );
@@ -438,10 +466,13 @@ static void Copy( const AstObject *, AstObject *, int * );
 static void Delete( AstObject *, int * );
 static void Dump( AstObject *, AstChannel *, int * );
 static void FillAndLims( AstXmlChan *, AstXmlElement *, AstRegion *, int * );
+static void IndexContent( AstXmlChan *, int * );
 static void OutputText( AstXmlChan *, const char *, int, int * );
+static void PurgeContent( AstXmlElement *, int * );
 static void ReCentreAnc( AstRegion *, int, AstKeyMap **, int * );
 static void ReadClassData( AstChannel *, const char *, int * );
 static void Report( AstXmlChan *, AstXmlElement *, int, const char *, int * );
+static void ResetSharedObjects( AstChannel *, int * );
 static void SetAttrib( AstObject *, const char *, int * );
 static void SinkWrap( void (*)( const char * ), const char *, int * );
 static void WriteBegin( AstChannel *, const char *, const char *, int * );
@@ -2191,6 +2222,9 @@ void astInitXmlChanVtab_(  AstXmlChanVtab *vtab, const char *name, int *status )
    parent_getcomment = channel->GetComment;
    channel->GetComment = GetComment;
 
+   parent_resetsharedobjects = channel->ResetSharedObjects;
+   channel->ResetSharedObjects = ResetSharedObjects;
+
 
 /* Save the inherited pointers to methods that will be extended, and
    replace them with pointers to the new member functions. */
@@ -4076,10 +4110,10 @@ static AstXmlElement *FindAttribute( AstXmlChan *this, const char *name, int *st
                 astXmlGetName( this->container ) );
    }
 
-/* Check all is OK. */
-   if( astOK ) {
-
-/* Loop round all items in the elements contents. */
+/* If the elements in the container have been indexed, use the index to
+   find the required element. Otherwise, loop round all items in the
+   elements contents. */
+   if( astOK && !IndexFind( this, 1, name, &result, status ) ) {
       nitem = astXmlGetNitem( this->container );
       for( i = 0; i < nitem; i++ ) {
          item = astXmlGetItem( this->container, i );
@@ -4486,10 +4520,10 @@ static AstXmlElement *FindObject( AstXmlChan *this, const char *name, int *statu
                 astXmlGetName( this->container ) );
    }
 
-/* Check all is OK. */
-   if( astOK ) {
-
-/* Loop round all items in the elements contents. */
+/* If the elements in the container have been indexed, use the index to
+   find the required element. Otherwise, loop round all items in the
+   elements contents. */
+   if( astOK && !IndexFind( this, 0, name, &result, status ) ) {
       nitem = astXmlGetNitem( this->container );
       for( i = 0; i < nitem; i++ ) {
          item = astXmlGetItem( this->container, i );
@@ -4528,6 +4562,79 @@ static AstXmlElement *FindObject( AstXmlChan *this, const char *name, int *statu
    return result;
 }
 
+static AstXmlElement *FindShared( AstXmlElement *elem, const char *id,
+                                  int *status ) {
+/*
+*  Name:
+*     FindShared
+
+*  Purpose:
+*     Find the XML element describing a shared AST Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     AstXmlElement *FindShared( AstXmlElement *elem, const char *id,
+*                                int *status )
+
+*  Class Membership:
+*     XmlChan member function.
+
+*  Description:
+*     This function searches the supplied element and all its descendants
+*     for an element (other than a REF element) that has an ID attribute
+*     with a given value. Such elements describe AST Objects that are
+*     referred to elsewhere by REF elements (see the ShareObjects
+*     attribute). No error is reported if no such element is found.
+
+*  Parameters:
+*     elem
+*        Pointer to the XML element to search.
+*     id
+*        Pointer to a string holding the required ID value.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the XmlElement if found, and NULL otherwise.
+
+*/
+
+/* Local Variables: */
+   AstXmlContentItem *item; /* Item */
+   AstXmlElement *result;   /* Returned pointer */
+   const char *value;       /* Value of ID attribute */
+   int i;                   /* Index of current item */
+   int nitem;               /* Number of items in the element */
+
+/* Initialise */
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK || !elem ) return result;
+
+/* See if the supplied element is the required element. */
+   value = astXmlGetAttributeValue( elem, ID );
+   if( value && !strcmp( value, id ) && strcmp( astXmlGetName( elem ), REF ) ) {
+      result = elem;
+
+/* If not, search each element within the supplied element. */
+   } else {
+      nitem = astXmlGetNitem( elem );
+      for( i = 0; i < nitem && !result && astOK; i++ ) {
+         item = astXmlGetItem( elem, i );
+         if( astXmlCheckType( item, AST__XMLELEM ) ) {
+            result = FindShared( (AstXmlElement *) item, id, status );
+         }
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+
 static int FindString( int n, const char *list[], const char *test,
                        const char *text, const char *method,
                        const char *class, int *status ){
@@ -5180,6 +5287,249 @@ static AstRegion *IntersectionReader( AstXmlChan *this, AstXmlElement *elem,
    return new;
 }
 
+static void IndexContent( AstXmlChan *this, int *status ) {
+/*
+*  Name:
+*     IndexContent
+
+*  Purpose:
+*     Create an index of the elements within the current container.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     void IndexContent( AstXmlChan *this, int *status )
+
+*  Class Membership:
+*     XmlChan member function.
+
+*  Description:
+*     This function creates a KeyMap holding a pointer to each element
+*     within the current container element that describes a non-default
+*     AST attribute or Object, and stores it in the XmlChan. The key for
+*     each element is formed from its "definedby" attribute (see
+*     ReadClassData) and its NAME or LABEL attribute (see IndexKey).
+*     The FindAttribute and FindObject functions can then locate an
+*     element without searching the whole container.
+*
+*     If more than one element has the same key, the key is associated
+*     with a NULL pointer. FindAttribute and FindObject then revert to
+*     searching the container for such keys, so that the first matching
+*     element is still the one that is used.
+
+*  Parameters:
+*     this
+*        Pointer to the XmlChan.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - ReadClassData should be called before this function so that
+*     each element has a "definedby" attribute.
+*/
+
+/* Local Variables: */
+   AstXmlContentItem *item; /* Item no. "i" */
+   char key[ AST__MXKEYLEN + 1 ]; /* Key for the current element */
+   const char *def;         /* Value from XML DEFAULT attribute */
+   const char *name;        /* Value from XML NAME or LABEL attribute */
+   int attr;                /* Does the element describe an AST attribute? */
+   int i;                   /* Index of current item */
+   int nitem;               /* Number of items in the element */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Create an empty index. */
+   this->index = astKeyMap( " ", status );
+
+/* Loop round all items in the container. */
+   nitem = astXmlGetNitem( this->container );
+   for( i = 0; i < nitem && astOK; i++ ) {
+      item = astXmlGetItem( this->container, i );
+
+/* Ignore this item if it is not an element, or if it represents a
+   default value. */
+      if( astXmlCheckType( item, AST__XMLELEM ) ) {
+         def = astXmlGetAttributeValue( item, DEFAULT );
+         if( !def || strcmp( def, TRUE ) ) {
+
+/* ATTR elements are identified by their NAME attribute, and all other
+   elements by their LABEL attribute. Form the key for the element. */
+            attr = !strcmp( astXmlGetName( item ), ATTR );
+            name = astXmlGetAttributeValue( item, attr ? NAME : LABEL );
+            if( IndexKey( attr, astXmlGetAttributeValue( item, DEFINEDBY ),
+                          name, key, status ) ) {
+
+/* Store a pointer to the element, or a NULL pointer if the key is
+   already in use. */
+               if( astMapHasKey( this->index, key ) ) {
+                  astMapPut0P( this->index, key, NULL, NULL );
+               } else {
+                  astMapPut0P( this->index, key, item, NULL );
+               }
+            }
+         }
+      }
+   }
+}
+
+static int IndexFind( AstXmlChan *this, int attr, const char *name,
+                      AstXmlElement **elem, int *status ) {
+/*
+*  Name:
+*     IndexFind
+
+*  Purpose:
+*     Use the index of the current container to find an element.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     int IndexFind( AstXmlChan *this, int attr, const char *name,
+*                    AstXmlElement **elem, int *status )
+
+*  Class Membership:
+*     XmlChan member function.
+
+*  Description:
+*     This function uses the index created by IndexContent to find the
+*     element within the current container that describes a named AST
+*     attribute or Object defined by the class currently being loaded.
+
+*  Parameters:
+*     this
+*        Pointer to the XmlChan.
+*     attr
+*        Non-zero if an ATTR element describing an AST attribute is
+*        required. Zero if an element describing an AST Object is
+*        required.
+*     name
+*        Pointer to a string holding the required AST attribute or Object
+*        name (case-insensitive).
+*     elem
+*        Pointer to a location at which to return a pointer to the
+*        element. NULL is returned if the element was not found. The
+*        supplied value is left unchanged if the index cannot be used.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if the index was used. Zero if the caller should search
+*     the container instead (i.e. if the container has not been
+*     indexed, or if the index holds more than one element with the
+*     required name).
+
+*/
+
+/* Local Variables: */
+   char key[ AST__MXKEYLEN + 1 ]; /* Key for the required element */
+   int result;              /* Returned value */
+   void *ptr;               /* Pointer stored in the index */
+
+/* Initialise */
+   result = 0;
+
+/* Check the global error status and the index. */
+   if ( !astOK || !this->index ) return result;
+
+/* Look for the key in the index. If not found, the container holds no
+   suitable element. */
+   if( IndexKey( attr, this->isa_class, name, key, status ) ) {
+      if( !astMapGet0P( this->index, key, &ptr ) ) {
+         *elem = NULL;
+         result = 1;
+
+/* If found, return the element unless the key is shared by more than
+   one element. */
+      } else if( ptr ) {
+         *elem = (AstXmlElement *) ptr;
+         result = 1;
+      }
+   }
+
+/* Return the result. */
+   return result;
+}
+
+static int IndexKey( int attr, const char *class, const char *name,
+                     char *key, int *status ) {
+/*
+*  Name:
+*     IndexKey
+
+*  Purpose:
+*     Form the key used to index an element.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     int IndexKey( int attr, const char *class, const char *name,
+*                   char *key, int *status )
+
+*  Class Membership:
+*     XmlChan member function.
+
+*  Description:
+*     This function forms the key used to store an element in the index
+*     created by IndexContent. The key is formed from a character that
+*     distinguishes AST attributes from AST Objects, the name of the class
+*     that defines the attribute or Object, and the upper case name of
+*     the attribute or Object.
+
+*  Parameters:
+*     attr
+*        Non-zero if the element describes an AST attribute, and zero if
+*        it describes an AST Object.
+*     class
+*        Pointer to a string holding the name of the class that defines
+*        the attribute or Object. May be NULL.
+*     name
+*        Pointer to a string holding the attribute or Object name. May be
+*        NULL.
+*     key
+*        Pointer to a buffer in which to return the key. It should have
+*        room for at least AST__MXKEYLEN + 1 characters.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     Non-zero if a key was formed. Zero if either string is NULL, or if
+*     the key would be too long.
+
+*/
+
+/* Local Variables: */
+   size_t i;                /* Character index */
+   size_t lc;               /* Length of class name */
+   size_t ln;               /* Length of attribute or Object name */
+
+/* Check the global error status and the supplied strings. */
+   if ( !astOK || !class || !name ) return 0;
+
+/* Check the key will fit in the buffer. */
+   lc = strlen( class );
+   ln = strlen( name );
+   if( lc + ln + 2 > AST__MXKEYLEN ) return 0;
+
+/* Form the key. The name is converted to upper case since names are
+   compared without regard to case (see Ustrcmp). */
+   key[ 0 ] = attr ? 'A' : 'O';
+   memcpy( key + 1, class, lc );
+   key[ lc + 1 ] = '.';
+   for( i = 0; i < ln; i++ ) key[ lc + 2 + i ] = toupper( (int) name[ i ] );
+   key[ lc + ln + 2 ] = 0;
+
+/* Indicate that a key was formed. */
+   return 1;
+}
+
 static int IsUsable( AstXmlElement *elem, int *status ){
 /*
 *  Name:
@@ -5317,6 +5667,7 @@ static AstObject *MakeAstFromXml( AstXmlChan *this, AstXmlElement *elem, int *st
 */
 
 /* Local Variables: */
+   AstKeyMap *old_index;         /* Index of elements in old container */
    AstLoaderType *loader;        /* Pointer to loader for Object */
    AstObject *new;               /* Pointer to returned Object */
    AstXmlParent *old_container;  /* Element from which items are being read */
@@ -5380,6 +5731,11 @@ static AstObject *MakeAstFromXml( AstXmlChan *this, AstXmlElement *elem, int *st
          old_container = this->container;
          this->container = (AstXmlParent *) elem;
 
+/* The new container has not yet been indexed (the index is created by
+   ReadClassData). Save the index of the original container. */
+         old_index = this->index;
+         this->index = NULL;
+
 /* The "isa_class" item in the XmlChan structure contains a pointer to
    the name of the class whose loader is currently being invoked. It is set
    by the loader itself as a side effect of calling the astReadClassData
@@ -5394,7 +5750,13 @@ static AstObject *MakeAstFromXml( AstXmlChan *this, AstXmlElement *elem, int *st
          new = (*loader)( NULL, (size_t) 0, NULL, NULL, (AstChannel *)
                           this, status );
 
-/* Re-instate the original container. */
+/* If the container was indexed, remove the elements that were used by
+   the loader. Then re-instate the original container and its index. */
+         if( this->index ) {
+            PurgeContent( elem, status );
+            this->index = astAnnul( this->index );
+         }
+         this->index = old_index;
          this->container = old_container;
       }
    }
@@ -6976,6 +7338,65 @@ static AstRegion *PositionIntervalReader( AstXmlChan *this, AstXmlElement *elem,
    return new;
 }
 
+static void PurgeContent( AstXmlElement *elem, int *status ) {
+/*
+*  Name:
+*     PurgeContent
+
+*  Purpose:
+*     Remove used elements from an indexed container element.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     void PurgeContent( AstXmlElement *elem, int *status )
+
+*  Class Membership:
+*     XmlChan member function.
+
+*  Description:
+*     This function deletes the elements within the supplied container
+*     element that have been marked as used by the Remove function
+*     (i.e. all elements other than "isa" elements that have no
+*     "definedby" attribute). White space is also deleted. The items are
+*     deleted in reverse order since this is much faster for elements
+*     with many items (see astXmlDelete).
+
+*  Parameters:
+*     elem
+*        Pointer to the container element. This should have been
+*        indexed by IndexContent.
+*     status
+*        Pointer to the inherited status variable.
+
+*/
+
+/* Local Variables: */
+   AstXmlContentItem *item; /* Item no. "i" */
+   int i;                   /* Index of current item */
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Loop backwards round all items in the element. */
+   for( i = astXmlGetNitem( elem ) - 1; i >= 0 && astOK; i-- ) {
+      item = astXmlGetItem( elem, i );
+
+/* Delete used elements and white space. */
+      if( astXmlCheckType( item, AST__XMLELEM ) ) {
+         if( strcmp( astXmlGetName( item ), ISA ) &&
+             !astXmlGetAttributeValue( item, DEFINEDBY ) ) {
+            astXmlDelete( item );
+         }
+
+      } else if( astXmlCheckType( item, AST__XMLWHITE ) ) {
+         astXmlDelete( item );
+      }
+   }
+}
+
 static AstObject *Read( AstChannel *this_channel, int *status ) {
 /*
 *  Name:
@@ -7013,6 +7434,7 @@ static AstObject *Read( AstChannel *this_channel, int *status ) {
    AstXmlChan *this;             /* Pointer to the XmlChan structure */
    AstXmlElement *elem;          /* XML element holding AST Object */
    int def_fmt;                  /* Original default format */
+   int i;                        /* Index of shared Object */
 
 /* Initialise. */
    new = NULL;
@@ -7044,8 +7466,20 @@ static AstObject *Read( AstChannel *this_channel, int *status ) {
       this->container = NULL;
 
 /* Next we create a new AST Object from this in-memory XML representation
-   of the source. */
+   of the source. Record the element so that shared Objects can be
+   found within it. */
+      this->readroot = elem;
       new = MakeAstFromXml( this, elem, status );
+      this->readroot = NULL;
+
+/* Annul the shared Objects created while reading the Object. */
+      for( i = 0; i < this->nshared_read; i++ ) {
+         if( this->shared_read[ i ] ) {
+            this->shared_read[ i ] = astAnnul( this->shared_read[ i ] );
+         }
+      }
+      this->shared_read = astFree( this->shared_read );
+      this->nshared_read = 0;
 
 /* Remove the element. This will cause an error to be reported if
    the element contains any items which have not been used. */
@@ -7137,29 +7571,40 @@ static void ReadClassData( AstChannel *this_channel, const char *class, int *sta
    "definedby" the class noted in the next following "isa" element, or by
    the class being loaded if there is no following "isa" element. */
 
+/* The "definedby" attributes do not depend on the class being loaded,
+   so this only needs to be done the first time data is read from the
+   container. The container is then indexed. Elements that have been
+   used since then have had their "definedby" attribute removed (see
+   Remove), so it must not be re-instated. */
+      if( !this->index ) {
+
 /* Find the first "isa" element and get the value of its "class" attribute.
    If none is found the name of the class being loaded is used. */
-      definedby = FindNextIsA( (AstXmlElement *) this->container, 0, status );
+         definedby = FindNextIsA( (AstXmlElement *) this->container, 0, status );
 
 /* Loop round all elements within the container. */
-      nitem = astXmlGetNitem( this->container );
-      for( i = 0; astOK && i < nitem; i++ ) {
-         item = astXmlGetItem( this->container, i );
-         if( astXmlCheckType( item, AST__XMLELEM ) ) {
+         nitem = astXmlGetNitem( this->container );
+         for( i = 0; astOK && i < nitem; i++ ) {
+            item = astXmlGetItem( this->container, i );
+            if( astXmlCheckType( item, AST__XMLELEM ) ) {
 
 /* If this is an "ISA" element, then we have ended the scope of the
    current "isa" class. All subsequent items will be defined by the class
    mentioned in the next following "ISA" element. Find the next ISA
    element and get its class. */
-            if( astOK && !strcmp( astXmlGetName( item ), ISA ) ) {
-               definedby = FindNextIsA( (AstXmlElement *) this->container, i + 1, status );
+               if( astOK && !strcmp( astXmlGetName( item ), ISA ) ) {
+                  definedby = FindNextIsA( (AstXmlElement *) this->container, i + 1, status );
 
 /* For other element types, add a "definedby" attribute holding the name
    of the class defined by the current ISA element. */
-            } else {
-               astXmlAddAttr( item, DEFINEDBY, definedby, NULL );
+               } else {
+                  astXmlAddAttr( item, DEFINEDBY, definedby, NULL );
+               }
             }
          }
+
+/* Index the container. */
+         IndexContent( this, status );
       }
    }
 }
@@ -7246,12 +7691,17 @@ static double ReadDouble( AstChannel *this_channel, const char *name, double def
    value, checking that the entire string is read (and checking for the
    magic string used to represent bad values). If this fails, then the
    wrong name has probably been given, or the input data are corrupt,
-   so report an error. */
+   so report an error. Most values are simple numbers, which astChr2Double
+   reads quickly, so only use astSscanf if it returns AST__BAD. */
    if( element ) {
       value = astXmlGetAttributeValue( element, VALUE );
       if( value ) {
          nc = 0;
-         if ( ( 0 == astSscanf( value, " " BAD_STRING " %n",
+         result = astChr2Double( value );
+         if( result != AST__BAD ) {
+            element = Remove( this, element, status );
+
+         } else if ( ( 0 == astSscanf( value, " " BAD_STRING " %n",
                                                    &nc ) )
                  && ( nc >= (int) strlen( value ) ) ) {
             result = AST__BAD;
@@ -7567,6 +8017,7 @@ static AstObject *ReadObject( AstChannel *this_channel, const char *name,
    AstXmlChan *this;             /* Pointer to the XmlChan structure */
    AstXmlElement *element;       /* Pointer to element holding required value */
    AstObject *result;            /* Value to be returned */
+   const char *id;               /* Identifier for a shared Object */
    const char *isa_class;        /* Class currently being loaded */
 
 /* Initialise. */
@@ -7587,9 +8038,23 @@ static AstObject *ReadObject( AstChannel *this_channel, const char *name,
 /* If an element was found, make an AST object from it. First remember
    the class currently being loaded so that it can be re-instated. */
    if( element ) {
-      isa_class = this->isa_class;
-      result = MakeAstFromXml( this, element, status );
-      this->isa_class = isa_class;
+
+/* A REF element refers to a shared Object described by another element
+   (see the ShareObjects attribute). An element with an ID attribute
+   describes such a shared Object. In both cases, use the stored Object
+   if it has already been created. */
+      id = astXmlGetAttributeValue( element, ID );
+      if( !strcmp( astXmlGetName( element ), REF ) ) {
+         result = ReadShared( this, NULL, id, status );
+
+      } else if( id ) {
+         result = ReadShared( this, element, id, status );
+
+      } else {
+         isa_class = this->isa_class;
+         result = MakeAstFromXml( this, element, status );
+         this->isa_class = isa_class;
+      }
 
 /* Remove the element from the container. */
       element = Remove( this, element, status );
@@ -7604,6 +8069,118 @@ static AstObject *ReadObject( AstChannel *this_channel, const char *name,
    return result;
 }
 
+static AstObject *ReadShared( AstXmlChan *this, AstXmlElement *elem,
+                              const char *id, int *status ) {
+/*
+*  Name:
+*     ReadShared
+
+*  Purpose:
+*     Read a shared AST Object.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     AstObject *ReadShared( AstXmlChan *this, AstXmlElement *elem,
+*                            const char *id, int *status )
+
+*  Class Membership:
+*     XmlChan member function.
+
+*  Description:
+*     This function returns a pointer to an AST Object that may be
+*     referred to more than once within the document being read (see
+*     the ShareObjects attribute). The Object is created from its XML
+*     element the first time it is needed, and a clone of the same
+*     Object is returned on subsequent calls. The Objects are stored
+*     until the top-level Object has been read.
+
+*  Parameters:
+*     this
+*        Pointer to the XmlChan.
+*     elem
+*        Pointer to the XML element describing the Object, or NULL if
+*        this is not known. If NULL, the element is found by searching
+*        the document being read for an element with the given ID value.
+*     id
+*        Pointer to a string holding the value of the ID attribute that
+*        identifies the Object.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to the Object.
+
+*  Notes:
+*     - A NULL pointer will be returned if this function is invoked
+*     with the global error status set, or if it should fail for any
+*     reason.
+*/
+
+/* Local Variables: */
+   AstObject *result;            /* Value to be returned */
+   const char *isa_class;        /* Class currently being loaded */
+   int i;                        /* Index of stored Object */
+   int j;                        /* Index of unused slot */
+   int nc;                       /* Number of characters read */
+
+/* Initialise. */
+   result = NULL;
+
+/* Check the global error status. */
+   if ( !astOK ) return result;
+
+/* Convert the ID value to an index into the list of shared Objects. */
+   nc = 0;
+   if( !id || 1 != astSscanf( id, " %d %n", &i, &nc ) ||
+       nc < (int) strlen( id ) || i < 0 ) {
+      astError( AST__BADIN, "astRead(XmlChan): Invalid reference to a "
+                "shared Object (\"%s\").", status, id ? id : "" );
+
+/* If the Object has already been created, return a clone of it. */
+   } else if( i < this->nshared_read && this->shared_read[ i ] ) {
+      result = astClone( this->shared_read[ i ] );
+
+/* Otherwise, find the element describing the Object if it was not
+   supplied. */
+   } else {
+      if( !elem ) elem = FindShared( this->readroot, id, status );
+      if( !elem ) {
+         if( astOK ) astError( AST__BADIN, "astRead(XmlChan): Cannot find "
+                               "the shared Object referred to by \"%s\".",
+                               status, id );
+
+/* Create the Object from the element, remembering the class currently
+   being loaded so that it can be re-instated. */
+      } else {
+         isa_class = this->isa_class;
+         result = MakeAstFromXml( this, elem, status );
+         this->isa_class = isa_class;
+
+/* Store a clone of the new Object so that later references can use it. */
+         if( i >= this->nshared_read ) {
+            this->shared_read = astGrow( this->shared_read, i + 1,
+                                       sizeof( AstObject * ) );
+            if( astOK ) {
+               for( j = this->nshared_read; j <= i; j++ ) {
+                  this->shared_read[ j ] = NULL;
+               }
+               this->nshared_read = i + 1;
+            }
+         }
+         if( astOK ) this->shared_read[ i ] = astClone( result );
+      }
+   }
+
+/* If an error occurred, annul the result. */
+   if( !astOK ) result = astAnnul( result );
+
+/* Return the result. */
+   return result;
+}
+
 static char *ReadString( AstChannel *this_channel, const char *name, const char *def, int *status ) {
 /*
 *  Name:
@@ -8857,6 +9434,10 @@ static AstXmlElement *Remove( AstXmlChan *this, AstXmlElement *element, int *sta
 *     reported if the element being removed contains anything other than
 *     comments, "isa" elements and blank character data (all contents should
 *     have been consumed by the process of reading the object).
+*
+*     If the current container has been indexed (see IndexContent), the
+*     element is instead marked as used, and is removed later by
+*     PurgeContent.
 
 *  Parameters:
 *     this
@@ -8873,21 +9454,44 @@ static AstXmlElement *Remove( AstXmlChan *this, AstXmlElement *element, int *sta
 
 /* Local Variables: */
    AstXmlContentItem *item; /* Item */
+   char key[ AST__MXKEYLEN + 1 ]; /* Key for the element in the index */
    const char *def;         /* Pointer to default attribute value */
+   int attr;                /* Does the element describe an AST attribute? */
+   int deferred;            /* Has removal of the element been deferred? */
    int i;                   /* Index of current item */
    int nitem;               /* Number of items still in the element */
+   void *ptr;               /* Pointer stored in the index */
 
 /* Check the global error status, and the supplied element. */
    if ( !astOK || !element ) return NULL;
 
 /* Check we have a container from which to remove the element. If so,
-   check that the container is the elements parent. If so, remove the
-   element from its parent container. */
+   check that the container is the elements parent. */
+   deferred = 0;
    if( this->container ) {
       if( (AstXmlParent *) this->container != astXmlGetParent( element ) ){
          astError( AST__INTER, "Remove(XmlChan): Supplied element is not "
                    "contained within the current container element (internal "
                    "AST programming error)." , status);
+
+/* If the container has been indexed, remove the element from the index
+   (keys shared by more than one element are left unchanged). Removing
+   elements one at a time from a large container is slow, so leave the
+   element in the container but remove its "definedby" attribute. This
+   hides it from FindAttribute and FindObject, and marks it for removal
+   by PurgeContent once the container has been read. */
+      } else if( this->index ) {
+         attr = !strcmp( astXmlGetName( element ), ATTR );
+         if( IndexKey( attr, astXmlGetAttributeValue( element, DEFINEDBY ),
+                       astXmlGetAttributeValue( element, attr ? NAME : LABEL ),
+                       key, status ) &&
+             astMapGet0P( this->index, key, &ptr ) && ptr == element ) {
+            astMapRemove( this->index, key );
+         }
+         astXmlRemoveAttr( element, DEFINEDBY, NULL );
+         deferred = 1;
+
+/* Otherwise, remove the element from its parent container. */
       } else {
          astXmlRemoveItem( element );
       }
@@ -8942,9 +9546,12 @@ static AstXmlElement *Remove( AstXmlChan *this, AstXmlElement *element, int *sta
       }
    }
 
-/* Remove the element from its parent and the annul it. */
-   astXmlRemoveItem( element );
-   astXmlAnnul( element );
+/* Remove the element from its parent and the annul it, unless this has
+   been deferred. */
+   if( !deferred ) {
+      astXmlRemoveItem( element );
+      astXmlAnnul( element );
+   }
 
 /* Return a NULL pointer. */
    return NULL;
@@ -9011,6 +9618,56 @@ static void Report( AstXmlChan *this, AstXmlElement *elem, int severity,
    }
 }
 
+static void ResetSharedObjects( AstChannel *this_channel, int *status ) {
+/*
+*  Name:
+*     ResetSharedObjects
+
+*  Purpose:
+*     Clear the list of Objects that have been written out.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "xmlchan.h"
+*     void ResetSharedObjects( AstChannel *this, int *status )
+
+*  Class Membership:
+*     XmlChan member function (over-rides the protected
+*     astResetSharedObjects method inherited from the Channel class).
+
+*  Description:
+*     This function clears the list of XML elements describing the
+*     Objects that may be referred to by later REF elements, and then
+*     invokes the parent method to clear the list of Objects.
+
+*  Parameters:
+*     this
+*        Pointer to the XmlChan.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Notes:
+*     - This function attempts to execute even if the global error
+*     status is set.
+*/
+
+/* Local Variables: */
+   AstXmlChan *this;             /* Pointer to the XmlChan structure */
+
+/* Obtain a pointer to the XmlChan structure. */
+   this = (AstXmlChan *) this_channel;
+
+/* Free the list of elements. The elements themselves are owned by the
+   XML document. */
+   this->shared_elems = astFree( this->shared_elems );
+   this->nshared_elem = 0;
+
+/* Invoke the parent method. */
+   (*parent_resetsharedobjects)( this_channel, status );
+}
+
 static IVOAScan *ScanIVOAElement( AstXmlChan *this, AstXmlElement *elem, int n,
                                   const char *names[], int min[], int max[], int *status ){
 /*
@@ -12130,6 +12787,7 @@ static void WriteBegin( AstChannel *this_channel, const char *class,
    AstXmlChan *this;         /* A pointer to the XmlChan structure. */
    AstXmlElement *elem;      /* The XML element to hodl the new AST object */
    const char *pref;         /* XML namespace prefix to use */
+   int i;                    /* Index of shared Object */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -12143,6 +12801,7 @@ static void WriteBegin( AstChannel *this_channel, const char *class,
       this->objectname = NULL;
       this->objectset = 1;
       this->objectcomment = NULL;
+      this->objectid = -1;
    }
 
 /* Initialise a flag to indicate that the next "IsA" item should not be
@@ -12172,6 +12831,24 @@ static void WriteBegin( AstChannel *this_channel, const char *class,
    DEFAULT attribute. */
    if( !this->objectset ) astXmlAddAttr( elem, DEFAULT, TRUE, NULL );
 
+/* If the object may be referred to later (see the ShareObjects
+   attribute), store a pointer to the element so that an ID attribute can
+   be added to it if required. */
+   if( this->objectid >= 0 ) {
+      if( this->objectid >= this->nshared_elem ) {
+         this->shared_elems = astGrow( this->shared_elems, this->objectid + 1,
+                                       sizeof( AstXmlElement * ) );
+         if( astOK ) {
+            for( i = this->nshared_elem; i <= this->objectid; i++ ) {
+               this->shared_elems[ i ] = NULL;
+            }
+            this->nshared_elem = this->objectid + 1;
+         }
+      }
+      if( astOK ) this->shared_elems[ this->objectid ] = elem;
+      this->objectid = -1;
+   }
+
 /* Add commments if required. */
    if( astGetComment( this_channel ) ) {
 
@@ -12315,11 +12992,11 @@ static void WriteDouble( AstChannel *this_channel, const char *name,
 /* Add a NAME attribute to this element containing the item name. */
          astXmlAddAttr( elem, NAME, name, NULL );
 
-/* Format the value as a string and store it as the VALUE attribute.
-   Make sure "-0" isn't produced. Use a magic string to represent bad
-   values. */
+/* Format the value as a string and store it as the VALUE attribute,
+   using the fewest digits that will read back exactly. Make sure "-0"
+   isn't produced. Use a magic string to represent bad values. */
          if( value != AST__BAD ) {
-            (void) sprintf( buff, "%.*g", AST__DBL_DIG, value );
+            (void) astDouble2Chr( value, AST__DBL_DIG, buff );
             if ( !strcmp( buff, "-0" ) ) {
                buff[ 0 ] = '0';
                buff[ 1 ] = '\0';
@@ -12965,6 +13642,10 @@ static void WriteObject( AstChannel *this_channel, const char *name,
 
 /* Local Variables: */
    AstXmlChan *this;         /* A pointer to the XmlChan structure. */
+   AstXmlElement *elem;      /* Pointer to new REF element */
+   char buff[ 20 ];          /* Buffer for formatted identifier */
+   int id;                   /* Index of shared Object */
+   int new;                  /* Object not written previously? */
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -12981,25 +13662,52 @@ static void WriteObject( AstChannel *this_channel, const char *name,
    written. */
       if ( Use( this, set, helpful, status ) ) {
 
-/* Save the supplied name associated with the object being written so
-   that it is available for use within the following invocation of the
-   WriteBegin method. The name is stored within the XmlChan structure
-   (NULL is used to indicate "no name supplied"). */
-         this->objectname = ( name && strlen( name ) ) ? name : NULL;
+/* If the Object is set, see if it has already been written out as
+   part of the current top-level Object (this is only checked if the
+   ShareObjects attribute is set). */
+         id = -1;
+         new = 1;
+         if( set ) id = astShareObject( this, value, &new );
+
+/* If so, write a REF element holding the object name and the identifier
+   of the Object, and add the same identifier to the element that
+   describes the Object. */
+         if( !new ) {
+            (void) sprintf( buff, "%d", id );
+            elem = astXmlAddElement( this->container, REF,
+                                     astGetXmlPrefix( this ) );
+            if( name && strlen( name ) ) astXmlAddAttr( elem, LABEL, name,
+                                                        NULL );
+            astXmlAddAttr( elem, ID, buff, NULL );
+            if( id < this->nshared_elem && this->shared_elems[ id ] &&
+                !astXmlGetAttributeValue( this->shared_elems[ id ], ID ) ) {
+               astXmlAddAttr( this->shared_elems[ id ], ID, buff, NULL );
+            }
+
+/* Otherwise, save the supplied name associated with the object being
+   written so that it is available for use within the following
+   invocation of the WriteBegin method. The name is stored within the
+   XmlChan structure (NULL is used to indicate "no name supplied"). */
+         } else {
+            this->objectname = ( name && strlen( name ) ) ? name : NULL;
 
-/* Also save the supplied comment and a flag indicating if the object is
-   set. These will be used by the WriteBegin method. They are stored within
-   the XmlChan structure. */
-         this->objectset = set;
-         this->objectcomment = comment;
+/* Also save the supplied comment, a flag indicating if the object is
+   set and the identifier of the Object if it may be shared. These will be
+   used by the WriteBegin method. They are stored within the XmlChan
+   structure. */
+            this->objectset = set;
+            this->objectcomment = comment;
+            this->objectid = id;
 
 /* Write the object to the XmlChan. */
-         (void) astWrite( this, value );
+            (void) astWrite( this, value );
 
 /* Nullify the components of the XmlChan set above. */
-         this->objectname = NULL;
-         this->objectset = 1;
-         this->objectcomment = NULL;
+            this->objectname = NULL;
+            this->objectset = 1;
+            this->objectcomment = NULL;
+            this->objectid = -1;
+         }
 
 /* Initialise a flag to indicate that the next "IsA" item should be
    written. */
@@ -13455,6 +14163,13 @@ static void Copy( const AstObject *objin, AstObject *objout, int *status ) {
    out->write_isa = 0;       /* Write out the next "IsA" item? */
    out->reset_source = 1;    /* A new line should be read from the source */
    out->isa_class = NULL;    /* Class being loaded */
+   out->objectid = -1;       /* Index of shared Object being written */
+   out->shared_elems = NULL; /* Elements describing shared Objects */
+   out->nshared_elem = 0;    /* Number of elements in shared_elems */
+   out->readroot = NULL;     /* Element holding Object being read */
+   out->shared_read = NULL;  /* Shared Objects read so far */
+   out->nshared_read = 0;    /* Number of elements in shared_read */
+   out->index = NULL;        /* Index of elements in current container */
 
 /* Store a copy of the prefix string.*/
    if ( in->xmlprefix ) out->xmlprefix = astStore( NULL, in->xmlprefix,
@@ -13494,6 +14209,7 @@ static void Delete( AstObject *obj, int *status ) {
 
 /* Local Variables: */
    AstXmlChan *this;             /* Pointer to XmlChan */
+   int i;                        /* Index of shared Object */
 
 /* Obtain a pointer to the XmlChan structure. */
    this = (AstXmlChan *) obj;
@@ -13504,6 +14220,18 @@ static void Delete( AstObject *obj, int *status ) {
 /* Free the memory used for the XmlPrefix string if necessary. */
    this->xmlprefix = astFree( this->xmlprefix );
 
+/* Free the lists used to handle shared Objects. The Channel destructor
+   annuls the Objects themselves. */
+   this->shared_elems = astFree( this->shared_elems );
+   this->nshared_elem = 0;
+   for( i = 0; i < this->nshared_read; i++ ) {
+      if( this->shared_read[ i ] ) {
+         this->shared_read[ i ] = astAnnul( this->shared_read[ i ] );
+      }
+   }
+   this->shared_read = astFree( this->shared_read );
+   if( this->index ) this->index = astAnnul( this->index );
+
 /* Free any memory used to store text read from the source */
    GetNextChar( NULL, status );
 
@@ -14209,6 +14937,13 @@ AstXmlChan *astInitXmlChan_( void *mem, size_t size, int init,
       new->formatdef = NATIVE_FORMAT;  /* Default Xml format */
       new->reset_source = 1;    /* A new line should be read from the source */
       new->isa_class = NULL;    /* Class being loaded */
+      new->objectid = -1;       /* Index of shared Object being written */
+      new->shared_elems = NULL; /* Elements describing shared Objects */
+      new->nshared_elem = 0;    /* Number of elements in shared_elems */
+      new->readroot = NULL;     /* Element holding Object being read */
+      new->shared_read = NULL;  /* Shared Objects read so far */
+      new->nshared_read = 0;    /* Number of elements in shared_read */
+      new->index = NULL;        /* Index of elements in current container */
 
 /* If an error occurred, clean up by deleting the new object. */
       if ( !astOK ) new = astDelete( new );
@@ -14352,6 +15087,13 @@ AstXmlChan *astLoadXmlChan_( void *mem, size_t size,
       new->xmlprefix = NULL;    /* Xml prefix */
       new->reset_source = 1;    /* A new line should be read from the source */
       new->isa_class = NULL;    /* Class being loaded */
+      new->objectid = -1;       /* Index of shared Object being written */
+      new->shared_elems = NULL; /* Elements describing shared Objects */
+      new->nshared_elem = 0;    /* Number of elements in shared_elems */
+      new->readroot = NULL;     /* Element holding Object being read */
+      new->shared_read = NULL;  /* Shared Objects read so far */
+      new->nshared_read = 0;    /* Number of elements in shared_read */
+      new->index = NULL;        /* Index of elements in current container */
       new->formatdef = NATIVE_FORMAT;  /* Default Xml format */
 
 /* Now restore presistent values. */
@@ -111,6 +111,13 @@ typedef struct AstXmlChan {
    char *xmlprefix;            /* Namespace prefix */
    int reset_source;           /* Read a new line from the source ? */
    const char *isa_class;      /* Class being loaded */
+   int objectid;               /* Index of shared Object being written */
+   AstXmlElement **shared_elems;/* Elements describing shared Objects */
+   int nshared_elem;           /* Number of elements in shared_elems */
+   AstXmlElement *readroot;    /* Element holding top-level Object being read */
+   AstObject **shared_read;    /* Shared Objects read so far */
+   int nshared_read;           /* Number of elements in shared_read */
+   AstKeyMap *index;           /* Index of elements in current container */
 } AstXmlChan;
 
 /* Virtual function table. */
@@ -48,6 +48,7 @@ f     encodings and the internal ASCII encoding. If no such routines
 *     In addition to those attributes common to all Channels, every
 *     YamlChan also has the following attributes:
 *
+*     - BlockThreshold: Minimum size of arrays written as binary blocks.
 *     - VerboseRead: Echo YAML text to standard output as it is read?
 *     - PreserveName: Save the ASDF name attributes as AST Ident values?
 *     - YamlEncoding: The external formatting system to use.
@@ -84,12 +85,32 @@ f     The YamlChan class does not define any new routines beyond those
 
 *  Authors:
 *     DSB: David Berry (EAO)
+*     AGT: Agent
 
 *  History:
 *     30-APR-2020 (DSB):
 *        Original version.
 *     5-OCT-2020 (DSB):
 *        Add a NAITVE encoding option (see YamlEncoding attribute).
+*     18-OCT-2026 (AGT):
+*        - Use astDouble2Chr within FmtDouble to avoid formatting each value
+*        two or three times.
+*        - Insert ".0" in front of the exponent, rather than at the end,
+*        for values such as 1e+22, so that they can be read back.
+*        - Support the ShareObjects attribute by writing later uses of a
+*        shared Object as YAML aliases when using the NATIVE encoding.
+*        - Read ASDF ndarrays that are stored in binary blocks following
+*        the YAML tree, and add the BlockThreshold attribute to allow large
+*        arrays to be written in the same way.
+*        - Stop reading YAML at the document-end marker, and do not write
+*        an empty line after it.
+*        - Avoid a segmentation fault in ReadPoly if the coefficients array
+*        cannot be read.
+*     19-OCT-2026 (AGT):
+*        - Fix overflow of the buffer used to hold the magic bytes at the
+*        start of each binary block in ReadBlocks.
+*        - Only omit the empty line at the end of the YAML output if binary
+*        blocks follow it, so that other output is unchanged.
 *class--
 */
 
@@ -130,6 +151,16 @@ f     The YamlChan class does not define any new routines beyond those
 /* The ASDF version header. */
 #define ASDF_HEADER "#ASDF 1.0.0"
 
+/* The magic bytes at the start of each ASDF binary block, and the
+   length of the block header that follows the two byte header size. */
+#define BLOCK_MAGIC "\323BLK"
+#define BLOCK_HEADER_LEN 48
+
+/* Is the supplied line of text a YAML document-end marker? */
+#define IS_DOC_END(text) \
+   ( !strncmp( (text), "...", 3 ) && \
+     ( !(text)[ 3 ] || isspace( (unsigned char) (text)[ 3 ] ) ) )
+
 /* The major version numbers required by this module for the two
    supported STSci schemas (gwcs/ and asdf/transform/). */
 #define TRANSFORM_MAJOR 1
@@ -442,7 +473,7 @@ static AstMapping *ReadTransform( AstYamlChan *, AstKeyMap *, int * );
 static AstObject *YamlToAst( AstYamlChan *, AstKeyMap *, int * );
 static AstSkyFrame *ReadCelestialFrame( AstKeyMap *, AstMapping **, int *status );
 static char *Get1C( AstKeyMap *, const char *, int, int, const char **, int *, int * );
-static const char *FmtDouble( double, size_t, char * );
+static const char *FmtDouble( double, size_t, char *, int * );
 static const char *Get0C( AstKeyMap *, const char *, int, const char *, int * );
 static const char *GetAsdfClass( AstKeyMap *, int * );
 static const char *GetNativeClass( AstKeyMap *, int * );
@@ -450,6 +481,7 @@ static const char *GetName( AstYamlChan *, const char *, AstMapping *, int * );
 static const char *YamlEventType( yaml_event_t );
 static double *GetQuantityV( AstYamlChan *, AstKeyMap *, const char *, const char *, int, int, int *, int *,  int * );
 static double *GetSequence( AstYamlChan *, AstKeyMap *, const char *, int, int, int *, int *, int *status );
+static double *ReadBlockArray( AstYamlChan *, AstKeyMap *, int, int *, int *, int * );
 static double *ReadNDArray( AstYamlChan *, AstKeyMap *, int, int *, int *, int * );
 static double *ReadSequence( AstYamlChan *, AstKeyMap *, const char *, int, int *, int *, int * );
 static double Get0D( AstKeyMap *, const char *, int, double, int * );
@@ -479,11 +511,12 @@ static void ReadStep( AstYamlChan *, AstKeyMap *, int, AstMapping **, AstFrame *
 static void ReadYAMLAlias( AstYamlChan *, AstKeyMap *, const char *, const char *, int * );
 static void ReadYAMLEvent( AstYamlChan *, yaml_parser_t *, yaml_event_t *, AstKeyMap *, const char *, int * );
 static void ReadYAMLItem( AstYamlChan *, yaml_parser_t *, AstKeyMap *, const char *, int * );
+static void ReadBlocks( AstYamlChan *, int * );
 static void ReadYAMLSequence( AstYamlChan *, AstKeyMap *, const char *, yaml_parser_t *, int * );
 static void SetNotAsdf( AstCmpMap *, int * );
 static void EndYamlDoc( AstYamlChan *, yaml_emitter_t *, int * );
 static void StartYamlDoc( AstYamlChan *, yaml_emitter_t *, int * );
-static void StartYamlMapping( AstYamlChan *, const char *, const char *, yaml_emitter_t *, int * );
+static void StartYamlMapping( AstYamlChan *, const char *, const char *, const char *, yaml_emitter_t *, int * );
 static void Store0C( AstYamlChan *, const char *, int, AstKeyMap *, const char *, const char *, int * );
 static void Store0D( AstYamlChan *, const char *, AstKeyMap *, double, int * );
 static void Store0I( AstYamlChan *, const char *, AstKeyMap *, int, int * );
@@ -498,6 +531,7 @@ static void StoreYaml0K( AstYamlChan *, const char *, yaml_emitter_t *, int, int
 static void StoreYaml1C( AstYamlChan *, const char *, int, yaml_emitter_t *, int, const char *[], const char *, int * );
 static void StoreYaml1D( AstYamlChan *, const char *, yaml_emitter_t *, int, const double *, int * );
 static void StoreYaml1I( AstYamlChan *, const char *, yaml_emitter_t *, int, const int *, int * );
+static void WriteBlocks( AstYamlChan *, int * );
 static void WriteValues( AstYamlChan *, const char *key, AstKeyMap *, int * );
 static void WriteYamlEntry( AstYamlChan *, AstKeyMap *, const char *, const char *, const char *, yaml_emitter_t *, int * );
 static void WriteYamlObject( AstYamlChan *, const char *, AstKeyMap *, yaml_emitter_t *, int * );
@@ -617,6 +651,11 @@ static int GetYamlEncoding( AstYamlChan *, int * );
 static int TestYamlEncoding( AstYamlChan *, int * );
 static void SetYamlEncoding( AstYamlChan *, int, int * );
 
+static int GetBlockThreshold( AstYamlChan *, int * );
+static int TestBlockThreshold( AstYamlChan *, int * );
+static void ClearBlockThreshold( AstYamlChan *, int * );
+static void SetBlockThreshold( AstYamlChan *, int, int * );
+
 
 /* Member functions that are available even if libyaml is not available. */
 /* ===================================================================== */
@@ -675,6 +714,9 @@ static void ClearAttrib( AstObject *this_object, const char *attrib, int *status
    } else if ( !strcmp( attrib, "yamlencoding" ) ) {
       astClearYamlEncoding( this );
 
+   } else if ( !strcmp( attrib, "blockthreshold" ) ) {
+      astClearBlockThreshold( this );
+
 /* If the attribute is still not recognised, pass it on to the parent
    method for further interpretation. */
    } else {
@@ -851,6 +893,13 @@ static const char *GetAttrib( AstObject *this_object, const char *attrib, int *s
          result = getattrib_buff;
       }
 
+   } else if ( !strcmp( attrib, "blockthreshold" ) ) {
+      ival = astGetBlockThreshold( this );
+      if ( astOK ) {
+         (void) sprintf( getattrib_buff, "%d", ival );
+         result = getattrib_buff;
+      }
+
    } else if ( !strcmp( attrib, "yamlencoding" ) ) {
       ival = astGetYamlEncoding( this );
       if ( astOK ) {
@@ -1025,6 +1074,11 @@ void astInitYamlChanVtab_(  AstYamlChanVtab *vtab, const char *name, int *status
    vtab->SetYamlEncoding = SetYamlEncoding;
    vtab->TestYamlEncoding = TestYamlEncoding;
 
+   vtab->ClearBlockThreshold = ClearBlockThreshold;
+   vtab->GetBlockThreshold = GetBlockThreshold;
+   vtab->SetBlockThreshold = SetBlockThreshold;
+   vtab->TestBlockThreshold = TestBlockThreshold;
+
 /* Declare the Dump function for this class. There is no destructor or
    copy constructor. */
    astSetDump( vtab, Dump, "YamlChan", "YAML I/O Channel" );
@@ -1102,8 +1156,11 @@ static AstObject *Read( AstChannel *this_channel, int *status ) {
    if( this->anchors ) this->anchors = astAnnul( this->anchors );
    this->anchors = astKeyMap( " ", status );
 
-/* Indicate we have not yet read a complete WCS object. */
+/* Indicate we have not yet read a complete WCS object, or the end of
+   the YAML document, or any ASDF binary blocks. */
    this->gotwcs = 0;
+   this->docend = 0;
+   if( this->blocks ) this->blocks = astAnnul( this->blocks );
 
 /* Indicate we have not yet determined the default yaml encoding. */
    this->defenc = UNKNOWN_ENCODING;
@@ -1134,6 +1191,7 @@ static AstObject *Read( AstChannel *this_channel, int *status ) {
 /* Free resources */
    values = astAnnul( values );
    if( this->anchors ) this->anchors = astAnnul( this->anchors );
+   if( this->blocks ) this->blocks = astAnnul( this->blocks );
 
 /* If an error occurred, clean up by deleting the new Object and
    return a NULL pointer. */
@@ -1218,6 +1276,11 @@ static void SetAttrib( AstObject *this_object, const char *setting, int *status
                && ( nc >= len ) ) {
       astSetPreserveName( this, ival );
 
+   } else if ( nc = 0,
+               ( 1 == astSscanf( setting, "blockthreshold= %d %n", &ival, &nc ) )
+               && ( nc >= len ) ) {
+      astSetBlockThreshold( this, ival );
+
    } else if( nc = 0,
         ( 0 == astSscanf( setting, "yamlencoding=%n%*[^\n]%n", &ival, &nc ) )
         && ( nc >= len ) ) {
@@ -1462,6 +1525,9 @@ static int TestAttrib( AstObject *this_object, const char *attrib, int *status )
    } else if ( !strcmp( attrib, "yamlencoding" ) ) {
       result = astTestYamlEncoding( this );
 
+   } else if ( !strcmp( attrib, "blockthreshold" ) ) {
+      result = astTestBlockThreshold( this );
+
 /* If the attribute is still not recognised, pass it on to the parent
    method for further interpretation. */
    } else {
@@ -1713,15 +1779,18 @@ static int Write( AstChannel *this_channel, AstObject *obj, int *status ) {
 
 /* Start an anonymous yaml mapping to hold a single named item - the top
    level AST object */
-      StartYamlMapping( this, NULL, NULL, &(this->emitter_data), status );
+      StartYamlMapping( this, NULL, NULL, NULL, &(this->emitter_data), status );
 
 /* Indicate that the object has set values and so should always be
    written out (regardless of the value of the YamlChan's "Full" attribute
    value. */
       this->objectset = 1;
 
-/* Write out the supplied object. */
+/* Write out the supplied object, and then clear the list of Objects used
+   to detect shared Objects. */
+      this->anchor_id = -1;
       astDump( obj, this );
+      astResetSharedObjects( this );
       ret = 1;
 
 /* End the anonymous yaml mapping. */
@@ -1743,6 +1812,13 @@ static int Write( AstChannel *this_channel, AstObject *obj, int *status ) {
    of properties in a KeyMap. Check the AST class in order of decreasing
    specialism (for instance, if we tested for Mappings first we would end
    up writing out Frames and FrameSets as the equivalent Mapping). */
+/* If large arrays are to be written as binary blocks following the YAML
+   tree, create a KeyMap to hold the block data until the tree has been
+   written. Binary data can only be written to a SinkFile. */
+         if( astGetBlockThreshold( this ) > 0 && astTestSinkFile( this ) ) {
+            this->blocks = astKeyMap( " ", status );
+         }
+
          if( astIsAFrameSet( obj ) ) {
             key = "wcs";
             km = WriteFrameSet( this, (AstFrameSet *) obj, status );
@@ -1764,6 +1840,12 @@ static int Write( AstChannel *this_channel, AstObject *obj, int *status ) {
             ret = 1;
          }
 
+/* Write out any binary blocks following the YAML tree. */
+         if( this->blocks ) {
+            WriteBlocks( this, status );
+            this->blocks = astAnnul( this->blocks );
+         }
+
       }
 
 /* Unknown encoding */
@@ -2595,7 +2677,8 @@ static int FindRotate3d( int series, int *nmap, AstMapping **map_list,
    return result;
 }
 
-static const char *FmtDouble( double dval, size_t buflen, char *buf ) {
+static const char *FmtDouble( double dval, size_t buflen, char *buf,
+                               int *status ) {
 /*
 *  Name:
 *     FmtDouble
@@ -2608,7 +2691,8 @@ static const char *FmtDouble( double dval, size_t buflen, char *buf ) {
 
 *  Synopsis:
 *     #include "Yamlchan.h"
-*      const char *FmtDouble( double dval, size_t buflen, char *buf )
+*      const char *FmtDouble( double dval, size_t buflen, char *buf,
+*                             int *status )
 
 *  Description:
 *     This function converts a double value into a string.
@@ -2620,6 +2704,8 @@ static const char *FmtDouble( double dval, size_t buflen, char *buf ) {
 *        The length of the "buf" array.
 *     buf
 *        Pointer to an array in which to return the formated string.
+*     status
+*        Pointer to the inherited status variable.
 
 *  Returned Value:
 *     A pointer to "buf".
@@ -2628,6 +2714,8 @@ static const char *FmtDouble( double dval, size_t buflen, char *buf ) {
 #define EXTRA 8
 
 /* Local Variables: */
+   char *p;
+   char tmp[ AST__DBL_DIG + EXTRA ];
    int nc;
    int n1;
    int n2;
@@ -2649,25 +2737,32 @@ static const char *FmtDouble( double dval, size_t buflen, char *buf ) {
       nc = buflen - EXTRA;
       if( nc > AST__DBL_DIG ) nc = AST__DBL_DIG;
 
-/* If reducing the number of sig figs by two produces a saving of 10 or
-   more characters, assume the least significant two characters are
-   rounding error. Also check for "-0" and change to "0". */
-      n1 = sprintf( buf, "%.*g", nc - 2, dval );
+/* Use the fewest sig figs (no more than "nc") that read back exactly.
+   If reducing the number of sig figs to "nc-2" produces a saving of 10 or
+   more characters, assume the least significant characters are rounding
+   error. This can only happen if the exact value is more than 10
+   characters long. Also check for "-0" and change to "0". */
+      n2 = astDouble2Chr( dval, nc, buf );
       if( !strcmp( buf, "-0" ) ) {
          buf[ 0 ] = '0';
          buf[ 1 ] = '\0';
-      } else {
-         n2 = sprintf( buf, "%.*g", nc, dval );
-         if( n2 - n1 > 9 ) {
-            sprintf( buf, "%.*g", nc - 2, dval );
-         }
+      } else if( n2 > 10 ) {
+         n1 = sprintf( tmp, "%.*g", nc - 2, dval );
+         if( n2 - n1 > 9 ) strcpy( buf, tmp );
       }
    }
 
-/* Ensure there is a decimal point in the string. */
+/* Ensure there is a decimal point in the string. If the value has an
+   exponent, the ".0" must go in front of it. */
    if( !strchr( buf, '.' ) ) {
-      n1 = strlen( buf );
-      strcpy( buf + n1, ".0" );
+      p = strchr( buf, 'e' );
+      if( p ) {
+         memmove( p + 2, p, strlen( p ) + 1 );
+         memcpy( p, ".0", 2 );
+      } else {
+         n1 = strlen( buf );
+         strcpy( buf + n1, ".0" );
+      }
    }
 
    return buf;
@@ -3779,9 +3874,11 @@ static void GetNextData( AstChannel *this_channel, int skip, char **name,
 /* Local Variables: */
    AstKeyMap *km;
    AstYamlChan *this;
+   char buff[ 20 ];
    const char *cptr;
    const char *key;
    const char *suf_start;
+   int i;
    int klen;
    void *pv;
 
@@ -3799,7 +3896,20 @@ static void GetNextData( AstChannel *this_channel, int skip, char **name,
    stored in the YamlChan structure (this->obj), together with the index
    of the next entry to read from this KeyMap (this->index). If we are
    about to read the first item, then first  return a "Begin" item. */
-   if( this->index == -1 ){
+
+/* If the previous item was an Object that has already been read (i.e. a
+   YAML alias for a shared Object), return a "Ref" item holding the index
+   of the Object within the list of Objects read so far. */
+   if( this->ref_index >= 0 ){
+      *name = astString( "ref", 3 );
+      (void) sprintf( buff, "%d", this->ref_index );
+      *val = astString( buff, strlen( buff ) );
+      this->ref_index = -1;
+
+/* Increment the index of the next item to read from the object KeyMap. */
+      (this->index)++;
+
+   } else if( this->index == -1 ){
       *name = astString( "begin", 5 );
 
 /* Get the AST class name and return a copy in dynamically allocated memory. */
@@ -3839,7 +3949,8 @@ static void GetNextData( AstChannel *this_channel, int skip, char **name,
 /* If this key holds YamlChan metadata used to describe the contents of the
    KeyMap, skip it. */
       while( !strcmp( key, "PARENT_KM" ) || !strcmp( key, "PARENT_INDEX" ) ||
-             !strcmp( key, "ASDFclass" ) || !strcmp( key, "PREVIOUS_KEY" ) ){
+             !strcmp( key, "ASDFclass" ) || !strcmp( key, "PREVIOUS_KEY" ) ||
+             !strcmp( key, "ANCHOR" ) ){
          if( ++(this->index) < astMapSize( this->obj ) ){
             key = astMapKey( this->obj, this->index );
          } else {
@@ -3902,19 +4013,38 @@ static void GetNextData( AstChannel *this_channel, int skip, char **name,
 /* Get a pointer to the KeyMap holding the object data. */
             astMapGet0A( this->obj, key, &km );
 
+/* If the KeyMap is a copy of an anchored YAML mapping that has already
+   been read (because the YAML used an alias to refer to it), arrange for
+   the next call to return a "Ref" item identifying the Object created
+   from it. */
+            if( astMapGet0C( km, "ANCHOR", &cptr ) &&
+                astMapGet0I( this->shared_km, cptr, &i ) ) {
+               this->ref_index = i;
+               km = astAnnul( km );
+
+/* Otherwise, the KeyMap will create the next Object. The parent Channel
+   class numbers Objects in the order in which they are first read. If
+   the mapping was anchored, record the index of the Object. */
+            } else {
+               if( astMapGet0C( km, "ANCHOR", &cptr ) ) {
+                  astMapPut0I( this->shared_km, cptr, this->nshared_km, NULL );
+               }
+               this->nshared_km++;
+
 /* Store a void pointer to the current KeyMap and the index within the current
    KeyMap so that we can reinstated them when the object has been read.
    Note we cannot store a full Object pointer using astMapPut0A because
    that would result in a circular referecne (km would contain this->obj
    which would contain km). */
-            astMapPut0P( km, "PARENT_KM", this->obj, NULL );
-            astMapPut0I( km, "PARENT_INDEX", this->index, NULL );
+               astMapPut0P( km, "PARENT_KM", this->obj, NULL );
+               astMapPut0I( km, "PARENT_INDEX", this->index, NULL );
 
 /* Store the new pointer in the YamlChan structure, and re-initialise the
    index so that subsequent calls to this function will read data items from
    it. */
-            this->obj = km;
-            this->index = -1;
+               this->obj = km;
+               this->index = -1;
+            }
          }
       }
    }
@@ -5761,6 +5891,11 @@ static int LibYamlReader( void *data, yaml_char_t *buffer, size_t size,
 /* Get a pointer to the YamlChan */
    this = (AstYamlChan *) data;
 
+/* If the YAML document-end marker has already been read, indicate that
+   the end of the YAML has been reached. Anything that follows the marker
+   (for instance, ASDF binary blocks) is not YAML. */
+   if( this->docend ) return 1;
+
 /* Invoke the source function from the parent Channel class until we get
    a non-blank line of text. . */
    text = astGetNextText( this );
@@ -5776,6 +5911,9 @@ static int LibYamlReader( void *data, yaml_char_t *buffer, size_t size,
 /* If there is any text to return... */
       if( text ) {
 
+/* Note if this is the document-end marker. */
+         if( IS_DOC_END( text ) ) this->docend = 1;
+
 /* Check the text will fit in the supplied buffer. Report an error if
    not. Allow room for a newline character to ba appended to the end. */
          *size_read = strlen( text ) + 1;
@@ -5850,6 +5988,7 @@ static int LibYamlWriter( void *data, yaml_char_t *buffer,
    char *pend;
    char *pstart;
    int *status;
+   int blocks;
    int nc;
 
 /* Get the AST status pointer */
@@ -5871,6 +6010,9 @@ static int LibYamlWriter( void *data, yaml_char_t *buffer,
    written out. */
    pstart = pb;
 
+/* Note if any binary blocks are to be written out after the YAML. */
+   blocks = ( this->blocks && astMapSize( this->blocks ) > 0 );
+
 /* Loop round all buffer characters. */
    line = NULL;
    pb--;
@@ -5878,8 +6020,11 @@ static int LibYamlWriter( void *data, yaml_char_t *buffer,
 
 /* If the current buffer character is a newline, or we have reached the
    end of the buffer, get a null terminated copy of the line that ends
-   here, then write it out using astPutNextText. */
-      if( pb == pend || *pb == '\n' ){
+   here, then write it out using astPutNextText. If any binary blocks are
+   to be written out by WriteBlocks, do not write out an empty line at the
+   end of the buffer, so that the blocks start immediately after the YAML
+   document-end marker. */
+      if( pb == pend ? ( pb > pstart || !blocks ) : ( *pb == '\n' ) ){
          nc = pb - pstart;
          line = astStore( line, pstart, nc + 1 );
          if( astOK ) line[ nc ] = 0;
@@ -7757,10 +7902,16 @@ static AstObject *ReadNative( AstYamlChan *this, AstKeyMap *km, int *status ){
    next item from the KeyMap to be read. */
       this->obj = km;
       this->index = -1;
+      this->ref_index = -1;
+      this->shared_km = astKeyMap( " ", status );
+      this->nshared_km = 0;
 
 /* Use the Read method inherited from the parent Channel class to read the
    object. */
       result = (*parent_read)( (AstChannel *) this, status );
+
+/* Free the KeyMap used to identify shared Objects. */
+      this->shared_km = astAnnul( this->shared_km );
    }
 
 /* Ensure there is no object in the YamlChan since the Read method uses
@@ -7777,6 +7928,428 @@ static AstObject *ReadNative( AstYamlChan *this, AstKeyMap *km, int *status ){
    return result;
 }
 
+static double *ReadBlockArray( AstYamlChan *this, AstKeyMap *km, int mxdim,
+                               int *ndim, int *dims, int *status ){
+/*
+*  Name:
+*     ReadBlockArray
+
+*  Purpose:
+*     Read a vectorised array of doubles from an ASDF binary block.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "yamlchan.h"
+*     double *ReadBlockArray( AstYamlChan *this, AstKeyMap *km, int mxdim,
+*                             int *ndim, int *dims, int *status )
+
+*  Class Membership:
+*     YamlChan member function
+
+*  Description:
+*     This function allocates and returns an array of doubles holding
+*     the values of an ASDF ndarray that is stored in a binary block
+*     following the YAML tree (i.e. the ndarray has a "source" property
+*     holding a block index). The values are converted directly from
+*     the binary representation described by the ndarray's "datatype"
+*     and "byteorder" properties. Any NaN values are returned as AST__BAD.
+
+*  Parameters:
+*     this
+*        Pointer to the YamlChan.
+*     km
+*        Pointer to the KeyMap. Its contents must represent an ASDF
+*        ndarray that refers to a binary block.
+*     mxdim
+*        The maximum allowed number of dimensions within the returned
+*        vectorised values array.
+*     ndim
+*        Pointer to an int in which to return the actual number of dimensions
+*        within the returned vectorised values array.
+*     dims
+*        An array with "mxdim" elements in which are returned the dimensions
+*        of the returned vectorised values array, with the first axis
+*        changing fastest.
+*     status
+*        Pointer to the inherited status variable.
+
+*  Returned Value:
+*     A pointer to a newly allocated array holding the vectorised array of
+*     values read from the binary block, or NULL if an error occurs. The
+*     array should be freed using astFree when it is no longer needed.
+
+*  Notes:
+*     - The binary blocks are read from the SourceFile the first time
+*     this function is called within each invocation of astRead.
+*/
+
+/* Local Variables: */
+   char key[ 20 ];
+   char kind;
+   const char *byteorder;
+   const char *datatype;
+   double *result;
+   int i;
+   int iblock;
+   int idim;
+   int nbits;
+   int nbyte;
+   int nblock;
+   int nel;
+   int nshape;
+   int nstride;
+   int offset;
+   int one;
+   int shape[ MXDIM ];
+   int stride;
+   int strides[ MXDIM ];
+   int swap;
+   int64_t ival;
+   uint64_t uval;
+   unsigned char *block;
+   unsigned char *pb;
+   unsigned char buf[ 8 ];
+   union {
+      double d;
+      float f;
+      int8_t i8;
+      int16_t i16;
+      int32_t i32;
+      int64_t i64;
+      uint8_t u8;
+      uint16_t u16;
+      uint32_t u32;
+      uint64_t u64;
+   } value;
+
+/* Initialise */
+   result = NULL;
+   *ndim = 0;
+
+/* Check inherited status */
+   if( !astOK ) return result;
+
+/* Binary blocks can only be read from a SourceFile since source
+   functions return text. */
+   if( !astTestSourceFile( this ) ) {
+      astError( AST__BYAML, "astRead(YamlChan): ndarray is stored in an "
+                "ASDF binary block, which can only be read if the "
+                "SourceFile attribute is set.", status );
+      return result;
+   }
+
+/* Blocks stored in external files are not supported. */
+   if( astMapType( km, "source" ) == AST__STRINGTYPE ) {
+      astError( AST__BYAML, "astRead(YamlChan): ndarray is stored in an "
+                "external file ('%s') - AST can only handle ndarrays that "
+                "are stored in the same file.", status,
+                Get0C( km, "source", 0, "", status ) );
+      return result;
+   }
+
+/* Get the ndarray properties. */
+   iblock = Get0I( km, "source", 0, 0, status );
+   offset = Get0I( km, "offset", 1, 0, status );
+   Get1I( km, "shape", 0, MXDIM, shape, &nshape, status );
+   if( astMapType( km, "datatype" ) == AST__STRINGTYPE ) {
+      datatype = Get0C( km, "datatype", 0, NULL, status );
+   } else {
+      datatype = NULL;
+   }
+   byteorder = Get0C( km, "byteorder", 0, NULL, status );
+   if( !astOK ) return result;
+
+/* Identify the data type, getting the kind of value ('f', 'i' or 'u'),
+   and the number of bytes per value. */
+   kind = 0;
+   nbits = 0;
+   if( datatype ) {
+      if( astSscanf( datatype, "float%d", &nbits ) == 1 ) {
+         if( nbits == 32 || nbits == 64 ) kind = 'f';
+      } else if( astSscanf( datatype, "uint%d", &nbits ) == 1 ) {
+         if( nbits == 8 || nbits == 16 || nbits == 32 || nbits == 64 ) kind = 'u';
+      } else if( astSscanf( datatype, "int%d", &nbits ) == 1 ) {
+         if( nbits == 8 || nbits == 16 || nbits == 32 || nbits == 64 ) kind = 'i';
+      }
+   }
+   nbyte = nbits/8;
+   if( !kind ) {
+      astError( AST__BYAML, "astRead(YamlChan): Unsupported ndarray "
+                "datatype '%s'.", status, datatype ? datatype : "<structured>" );
+
+/* Check the byte order. */
+   } else if( strcmp( byteorder, "big" ) && strcmp( byteorder, "little" ) ) {
+      astError( AST__BYAML, "astRead(YamlChan): Illegal ndarray "
+                "byteorder '%s'.", status, byteorder );
+
+/* Check the number of axes. */
+   } else if( nshape > mxdim ) {
+      astError( AST__BYAML, "astRead(YamlChan): The array has %d axes "
+                "- no more than %d are allowed.", status, nshape, mxdim );
+   }
+
+/* Get the total number of elements, and check any supplied strides
+   describe a contiguous array with the last axis changing fastest. */
+   nel = 1;
+   for( idim = 0; idim < nshape; idim++ ) nel *= shape[ idim ];
+   if( astOK && astMapHasKey( km, "strides" ) ) {
+      Get1I( km, "strides", 0, MXDIM, strides, &nstride, status );
+      stride = nbyte;
+      for( idim = nshape - 1; idim >= 0 && astOK; idim-- ) {
+         if( nstride != nshape || strides[ idim ] != stride ) {
+            astError( AST__BYAML, "astRead(YamlChan): ndarray is not "
+                      "stored contiguously - AST can only handle "
+                      "contiguous ndarrays.", status );
+         }
+         stride *= shape[ idim ];
+      }
+   }
+
+/* If the binary blocks have not yet been read, read them now. */
+   if( astOK && !this->blocks ) ReadBlocks( this, status );
+
+/* Get the data for the requested block. Report an error if it cannot
+   be used. */
+   block = NULL;
+   if( astOK ) {
+      sprintf( key, "Z%d", iblock );
+      if( astMapHasKey( this->blocks, key ) ) {
+         astError( AST__BYAML, "astRead(YamlChan): ndarray is stored in "
+                   "binary block %d, which is compressed using '%s' - AST "
+                   "can only handle uncompressed blocks.", status, iblock,
+                   Get0C( this->blocks, key, 0, "", status ) );
+      } else {
+         sprintf( key, "B%d", iblock );
+         nblock = astMapHasKey( this->blocks, key ) ?
+                  astMapLength( this->blocks, key ) : -1;
+         if( nblock < 0 ) {
+            astError( AST__BYAML, "astRead(YamlChan): Binary block %d "
+                      "referred to by an ndarray does not exist.", status,
+                      iblock );
+         } else if( offset < 0 || (size_t) offset + (size_t) nel*nbyte >
+                    (size_t) nblock ) {
+            astError( AST__BYAML, "astRead(YamlChan): Binary block %d "
+                      "is too small to hold the %d element ndarray.",
+                      status, iblock, nel );
+         } else {
+            block = astMalloc( nblock );
+            astMapGet1B( this->blocks, key, nblock, &nblock, block );
+         }
+      }
+   }
+
+/* Allocate the returned array. */
+   result = astMalloc( nel*sizeof( *result ) );
+   if( astOK && block ) {
+
+/* The bytes within each value need to be reversed if the byte order of
+   the block differs from the native byte order. */
+      one = 1;
+      swap = ( !strcmp( byteorder, "big" ) == ( *( (char *) &one ) != 0 ) );
+
+/* Convert each value. */
+      pb = block + offset;
+      for( i = 0; i < nel; i++ ) {
+         if( swap ) {
+            for( idim = 0; idim < nbyte; idim++ ) {
+               buf[ idim ] = pb[ nbyte - 1 - idim ];
+            }
+         } else {
+            memcpy( buf, pb, nbyte );
+         }
+         memcpy( &value, buf, nbyte );
+         pb += nbyte;
+
+         if( kind == 'f' ) {
+            result[ i ] = ( nbyte == 8 ) ? value.d : (double) value.f;
+            if( astISNAN( result[ i ] ) ) result[ i ] = AST__BAD;
+         } else if( kind == 'i' ) {
+            ival = ( nbyte == 1 ) ? value.i8 : ( nbyte == 2 ) ? value.i16 :
+                   ( nbyte == 4 ) ? value.i32 : value.i64;
+            result[ i ] = (double) ival;
+         } else {
+            uval = ( nbyte == 1 ) ? value.u8 : ( nbyte == 2 ) ? value.u16 :
+                   ( nbyte == 4 ) ? value.u32 : value.u64;
+            result[ i ] = (double) uval;
+         }
+      }
+
+/* Return the dimensions with the first axis changing fastest. */
+      *ndim = nshape;
+      for( idim = 0; idim < nshape; idim++ ) {
+         dims[ idim ] = shape[ nshape - 1 - idim ];
+      }
+   }
+
+/* Free resources. */
+   block = astFree( block );
+   if( !astOK ) result = astFree( result );
+
+/* Return the values. */
+   return result;
+}
+
+static void ReadBlocks( AstYamlChan *this, int *status ){
+/*
+*  Name:
+*     ReadBlocks
+
+*  Purpose:
+*     Read the ASDF binary blocks that follow the YAML tree.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "yamlchan.h"
+*     void ReadBlocks( AstYamlChan *this, int *status )
+
+*  Class Membership:
+*     YamlChan member function
+
+*  Description:
+*     This function reads all the ASDF binary blocks that follow the YAML
+*     tree in the SourceFile, and stores them in a new KeyMap, a pointer
+*     to which is stored in the YamlChan. The used data bytes from block
+*     "i" are stored as a byte vector with key "B<i>". Compressed blocks
+*     cannot be decoded and so are recorded instead by an entry with key
+*     "Z<i>" holding the compression code.
+*
+*     The blocks are read in order, so the optional block index that may
+*     follow the last block is not needed and is ignored (as is anything
+*     else that does not start with the block magic bytes). Any remaining
+*     YAML text (which will be present if reading of the YAML stopped once
+*     a complete WCS had been read) is skipped first.
+
+*  Parameters:
+*     this
+*        Pointer to the YamlChan.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   char *text;
+   char code[ 5 ];
+   char key[ 20 ];
+   int iblock;
+   int i;
+   size_t head_size;
+   size_t nread;
+   uint32_t flags;
+   uint64_t allocated;
+   uint64_t used;
+   unsigned char *data;
+   unsigned char *head;
+   unsigned char c;
+   unsigned char magic[ 5 ];
+
+/* Check inherited status */
+   if( !astOK ) return;
+
+/* Create the KeyMap to hold the blocks. */
+   this->blocks = astKeyMap( " ", status );
+
+/* Skip any YAML that has not yet been read. */
+   while( astOK && !this->docend ) {
+      text = astGetNextText( this );
+      if( !text ) break;
+      if( IS_DOC_END( text ) ) this->docend = 1;
+      text = astFree( text );
+   }
+
+/* Loop round each block. */
+   iblock = 0;
+   while( astOK ) {
+
+/* Skip any white space or null padding before the block, and then check
+   for the block magic bytes. Leave the loop if they are not found. */
+      nread = astGetNextBytes( this, &c, 1 );
+      while( nread == 1 && ( !c || isspace( c ) ) ) {
+         nread = astGetNextBytes( this, &c, 1 );
+      }
+      if( nread < 1 || c != (unsigned char) BLOCK_MAGIC[ 0 ] ) break;
+      nread = astGetNextBytes( this, magic, 5 );
+      if( nread < 5 || memcmp( magic, BLOCK_MAGIC + 1, 3 ) ) break;
+
+/* Read the block header, the size of which is given by the last two
+   (big-endian) bytes read above. */
+      head_size = ( (size_t) magic[ 3 ] << 8 ) | magic[ 4 ];
+      if( head_size < BLOCK_HEADER_LEN ) {
+         astError( AST__BYAML, "astRead(YamlChan): Header for binary "
+                   "block %d is too short (%zu bytes).", status, iblock,
+                   head_size );
+         break;
+      }
+      head = astMalloc( head_size );
+      if( astOK && astGetNextBytes( this, head, head_size ) < head_size &&
+          astOK ) {
+         astError( AST__BYAML, "astRead(YamlChan): Unexpected end of file "
+                   "in the header for binary block %d.", status, iblock );
+      }
+
+/* Extract the flags, compression code, and the allocated and used sizes.
+   All are big-endian. */
+      flags = 0;
+      allocated = 0;
+      used = 0;
+      if( astOK ) {
+         for( i = 0; i < 4; i++ ) flags = ( flags << 8 ) | head[ i ];
+         memcpy( code, head + 4, 4 );
+         code[ 4 ] = 0;
+         for( i = 8; i < 16; i++ ) allocated = ( allocated << 8 ) | head[ i ];
+         for( i = 16; i < 24; i++ ) used = ( used << 8 ) | head[ i ];
+      }
+      head = astFree( head );
+
+/* A streamed block (flag bit 0) extends to the end of the file. */
+      data = NULL;
+      if( astOK && ( flags & 1 ) ) {
+         used = 0;
+         do {
+            data = astGrow( data, used + 65536, 1 );
+            nread = astOK ? astGetNextBytes( this, data + used, 65536 ) : 0;
+            used += nread;
+         } while( nread == 65536 && used < INT_MAX );
+         allocated = used;
+
+/* Otherwise read all the allocated space. */
+      } else if( astOK ) {
+         if( used > allocated || allocated > INT_MAX ) {
+            astError( AST__BYAML, "astRead(YamlChan): Binary block %d has "
+                      "an invalid or unsupported size (%" PRIu64 " bytes).",
+                      status, iblock, allocated );
+         } else {
+            data = astMalloc( allocated );
+            if( astOK && astGetNextBytes( this, data, allocated ) <
+                allocated && astOK ) {
+               astError( AST__BYAML, "astRead(YamlChan): Unexpected end "
+                         "of file in binary block %d.", status, iblock );
+            }
+         }
+      }
+
+/* Store the used bytes, or the compression code if the block is
+   compressed. */
+      if( astOK ) {
+         if( code[ 0 ] || code[ 1 ] || code[ 2 ] || code[ 3 ] ) {
+            sprintf( key, "Z%d", iblock );
+            astMapPut0C( this->blocks, key, code, NULL );
+         } else {
+            sprintf( key, "B%d", iblock );
+            astMapPut1B( this->blocks, key, (int) used, data, NULL );
+         }
+      }
+      data = astFree( data );
+
+/* A streamed block is always the last block. */
+      iblock++;
+      if( flags & 1 ) break;
+   }
+}
+
 static double *ReadNDArray( AstYamlChan *this, AstKeyMap *km, int mxdim,
                             int *ndim, int *dims, int *status ){
 /*
@@ -7849,11 +8422,10 @@ static double *ReadNDArray( AstYamlChan *this, AstKeyMap *km, int mxdim,
 /* Create the returned array. */
    } else {
 
-/* This class can only handle arrays defined inline. */
+/* If the array is not defined inline, read it from the binary block
+   that holds it. */
       if( astMapHasKey( km, "source" ) ){
-         astError( AST__BYAML, "astRead(YamlChan): ndarray is not defined "
-                   "inline - AST can only handle ndarrays that are defined "
-                   "inline.", status );
+         result = ReadBlockArray( this, km, mxdim, ndim, dims, status );
 
 /* If the supplied KeyMap contains a "data" element it may be a KeyMap
    holding a set of vectors (each corresponding to one row of the data
@@ -8176,7 +8748,7 @@ static AstMapping *ReadPoly( AstYamlChan *this, AstKeyMap *km, int isortho,
 
    ncoeff_f = 0;
    pc = cof_ptr;
-   for( j = 0; j < dims[ 1 ]; j++ ) {
+   for( j = 0; j < dims[ 1 ] && astOK; j++ ) {
       for( i = 0; i < dims[ 0 ]; i++ ) {
          if( *(pc++) != 0.0 ) ncoeff_f++;
       }
@@ -10351,6 +10923,14 @@ static void ReadYAMLEvent( AstYamlChan *this, yaml_parser_t *parser,
    to the "Mapping start" event read above. */
       kmval = ReadYAMLMapping( this, parser, status );
 
+/* If an AST NATIVE object has an anchor, store the anchor name in the
+   sub keymap. Any aliases that refer to the anchor will be given a copy of
+   the sub keymap, and so will also hold the anchor name. This allows the
+   Object to be created just once (see the ShareObjects attribute). */
+      if( anchor && class && strstr( class, STARLINK_TAG ) ) {
+         astMapPut0C( kmval, "ANCHOR", anchor, NULL );
+      }
+
 /* Store the YAML class in the sub keymap. If no class is specified a
    fixed string will be used to indicate the object has no type (usuall
    the start of a sequence).  */
@@ -11528,7 +12108,8 @@ static void StartYamlDoc( AstYamlChan *this, yaml_emitter_t *emitter,
 }
 
 static void StartYamlMapping( AstYamlChan *this, const char *key, const char *tag,
-                              yaml_emitter_t *emitter, int *status ) {
+                              const char *anchor, yaml_emitter_t *emitter,
+                              int *status ) {
 /*
 *  Name:
 *     StartYamlMapping
@@ -11542,7 +12123,8 @@ static void StartYamlMapping( AstYamlChan *this, const char *key, const char *ta
 *  Synopsis:
 *     #include "Yamlchan.h"
 *     void StartYamlMapping( AstYamlChan *this, const char *key, const char *tag,
-*                            yaml_emitter_t *emitter, int *status )
+*                            const char *anchor, yaml_emitter_t *emitter,
+*                            int *status )
 
 *  Description:
 *     This function emits yaml events describing a new yaml mapping.
@@ -11559,6 +12141,9 @@ static void StartYamlMapping( AstYamlChan *this, const char *key, const char *ta
 *        if it starts with "tag:", it will be used without change. Otherwise
 *        it will be prefixed by "tag:stsci.edu:". etc (depending on the
 *        encoding).
+*     anchor
+*        The name of a YAML anchor to attach to the mapping, so that it
+*        can be referred to by later YAML aliases. May be NULL.
 *     emitter
 *        Pointer to a libyaml emitter.
 *     status
@@ -11598,7 +12183,8 @@ static void StartYamlMapping( AstYamlChan *this, const char *key, const char *ta
 
 /* Emit the start mapping event. */
    if( astOK ) {
-      yaml_mapping_start_event_initialize( &event, NULL, (yaml_char_t *) fulltag,
+      yaml_mapping_start_event_initialize( &event, (yaml_char_t *) anchor,
+                                           (yaml_char_t *) fulltag,
                                            (tag==NULL), YAML_BLOCK_MAPPING_STYLE );
       EMIT
    }
@@ -12217,7 +12803,7 @@ static void StoreYaml0D( AstYamlChan *this, const char *key,
 
 /* Format and store the value as a YAML scalar. */
    if( astOK ) {
-      FmtDouble( value, sizeof(buff), buff );
+      FmtDouble( value, sizeof(buff), buff, status );
       yaml_scalar_event_initialize( &event, NULL, NULL, (yaml_char_t *) buff,
                                     strlen(buff), 1, 1, YAML_PLAIN_SCALAR_STYLE );
       EMIT
@@ -12518,7 +13104,7 @@ static void StoreYaml1D( AstYamlChan *this, const char *key,
 /* Emit a scalar string holding each value. */
    pv = values;
    for( ival = 0; ival < nval && astOK; ival++,pv++ ) {
-      FmtDouble( *pv, sizeof(buff), buff );
+      FmtDouble( *pv, sizeof(buff), buff, status );
       yaml_scalar_event_initialize( &event, NULL, NULL, (yaml_char_t *) buff,
                                     strlen(buff), 1, 1, YAML_PLAIN_SCALAR_STYLE );
       EMIT
@@ -13600,6 +14186,78 @@ static AstKeyMap *WriteAsdfIdentity( AstYamlChan *this, int ndim, AstObject *map
    return ret;
 }
 
+static void WriteBlocks( AstYamlChan *this, int *status ){
+/*
+*  Name:
+*     WriteBlocks
+
+*  Purpose:
+*     Write ASDF binary blocks following the YAML tree.
+
+*  Type:
+*     Private function.
+
+*  Synopsis:
+*     #include "Yamlchan.h"
+*     void WriteBlocks( AstYamlChan *this, int *status )
+
+*  Description:
+*     This function writes out each array stored in the KeyMap of
+*     binary blocks (see WriteAsdfNdArray) as an uncompressed ASDF binary
+*     block. It should be called after the YAML tree has been written.
+*     The values are written in native byte order without a checksum.
+*     The optional block index is not written.
+
+*  Parameters:
+*     this
+*        Pointer to the YamlChan.
+*     status
+*        Pointer to the inherited status variable.
+*/
+
+/* Local Variables: */
+   char key[ 20 ];
+   double *data;
+   int i;
+   int iblock;
+   int nblock;
+   int nel;
+   uint64_t nbyte;
+   unsigned char head[ 6 + BLOCK_HEADER_LEN ];
+
+/* Check the global error status. */
+   if ( !astOK ) return;
+
+/* Loop round all blocks. */
+   nblock = astMapSize( this->blocks );
+   for( iblock = 0; iblock < nblock && astOK; iblock++ ) {
+      sprintf( key, "B%d", iblock );
+      nel = astMapLength( this->blocks, key );
+      data = astMalloc( nel*sizeof( *data ) );
+      if( astOK ) {
+         astMapGet1D( this->blocks, key, nel, &nel, data );
+         nbyte = (uint64_t) nel*sizeof( *data );
+
+/* Construct the block magic, header size and header. The header holds
+   zero flags, no compression, equal allocated, used and data sizes, and
+   an all-zero (i.e. absent) checksum. All values are big-endian. */
+         memset( head, 0, sizeof( head ) );
+         memcpy( head, BLOCK_MAGIC, 4 );
+         head[ 5 ] = BLOCK_HEADER_LEN;
+         for( i = 0; i < 8; i++ ) {
+            head[ 6 + 15 - i ] = ( nbyte >> ( 8*i ) ) & 0xff;
+            head[ 6 + 23 - i ] = ( nbyte >> ( 8*i ) ) & 0xff;
+            head[ 6 + 31 - i ] = ( nbyte >> ( 8*i ) ) & 0xff;
+         }
+
+/* Write out the header and the data. */
+         astPutNextBytes( this, head, sizeof( head ) );
+         astPutNextBytes( this, data, nbyte );
+      }
+      data = astFree( data );
+   }
+}
+
 static AstKeyMap *WriteAsdfNdArray( AstYamlChan *this, int ndim, const int *dims,
                                     double *vals, int *status ){
 /*
@@ -13619,7 +14277,11 @@ static AstKeyMap *WriteAsdfNdArray( AstYamlChan *this, int ndim, const int *dims
 
 *  Description:
 *     This function writes a 1d or 2d array of floating point values as an
-*     ASDF ndarray to a KeyMap.
+*     ASDF ndarray to a KeyMap. If the BlockThreshold attribute is set and
+*     the array is large enough, the values are stored in a binary block
+*     that will be written out after the YAML tree (see WriteBlocks), and
+*     the ndarray refers to the block. Otherwise, the values are stored
+*     inline.
 
 *  Parameters:
 *     this
@@ -13645,7 +14307,12 @@ static AstKeyMap *WriteAsdfNdArray( AstYamlChan *this, int ndim, const int *dims
    AstKeyMap *km;
    AstKeyMap *ret;
    double *pv;
+   int iblock;
+   int idim;
    int irow;
+   int nel;
+   int one;
+   int shape[ 2 ];
 
 /* Initialise */
    ret = NULL;
@@ -13657,8 +14324,33 @@ static AstKeyMap *WriteAsdfNdArray( AstYamlChan *this, int ndim, const int *dims
    to create a yaml mapping and store the appropriate ASDF tag. */
    ret = StartAsdfKeyMap( this, 0, "asdf/core/ndarray-1.0.0", status );
 
-/* First deal with 2d arrays. */
-   if( ndim == 2 ) {
+/* Get the number of elements in the array. */
+   nel = 1;
+   for( idim = 0; idim < ndim; idim++ ) nel *= dims[ idim ];
+
+/* If binary blocks are being written, and the array is large enough,
+   store a copy of the values in the KeyMap holding the blocks to be
+   written after the YAML tree, using the index of the block as the key.
+   The values are written with native byte order. The ndarray "shape"
+   lists the axes slowest first. */
+   if( this->blocks && ( ndim == 1 || ndim == 2 ) &&
+       nel >= astGetBlockThreshold( this ) ) {
+      iblock = astMapSize( this->blocks );
+      sprintf( rowkey, "B%d", iblock );
+      astMapPut1D( this->blocks, rowkey, nel, vals, NULL );
+
+      one = 1;
+      Store0I( this, "source", ret, iblock, status );
+      Store0C( this, "datatype", 0, ret, "float64", NULL, status );
+      Store0C( this, "byteorder", 0, ret, ( *( (char *) &one ) ) ?
+               "little" : "big", NULL, status );
+      for( idim = 0; idim < ndim; idim++ ) {
+         shape[ idim ] = dims[ ndim - 1 - idim ];
+      }
+      Store1I( this, "shape", ret, ndim, shape, status );
+
+/* Otherwise, first deal with 2d arrays. */
+   } else if( ndim == 2 ) {
 
 /* Create a KeyMap to hold the "data" component. Indicate its contents
    should be written out as a YAML sequence. */
@@ -16472,7 +17164,7 @@ static void WriteYamlObject( AstYamlChan *this, const char *key, AstKeyMap *obj,
    if( isseq ) {
       StartYamlSequence( this, key, tag, emitter, status );
    } else {
-      StartYamlMapping( this, key, tag, emitter, status );
+      StartYamlMapping( this, key, tag, NULL, emitter, status );
    }
 
 /* Loop round all the entries in the KeyMap. */
@@ -16711,6 +17403,7 @@ static void WriteBegin( AstChannel *this_channel, const char *class,
 
 /* Local Variables: */
    AstYamlChan *this;
+   char anchor[ 20 ];
    const char *name;
 
 /* Check the global error status. */
@@ -16735,8 +17428,16 @@ static void WriteBegin( AstChannel *this_channel, const char *class,
       this->objectset = 1;
    }
 
-/* Start a YAML Mapping to hold the object */
-   StartYamlMapping( this, name, class, this->emitter, status );
+/* Start a YAML Mapping to hold the object. If the object may be referred
+   to later (see the ShareObjects attribute), attach an anchor to the
+   mapping. */
+   if( this->anchor_id >= 0 ) {
+      (void) sprintf( anchor, "ast%d", this->anchor_id );
+      this->anchor_id = -1;
+      StartYamlMapping( this, name, class, anchor, this->emitter, status );
+   } else {
+      StartYamlMapping( this, name, class, NULL, this->emitter, status );
+   }
 }
 
 static void WriteDouble( AstChannel *this_channel, const char *name,
@@ -17308,8 +18009,13 @@ static void WriteObject( AstChannel *this_channel, const char *name,
 
 /* Local Variables: */
    AstYamlChan *this;
+   char anchor[ 20 ];
    const char *oldname;
+   int id;
+   int new;
    int oldset;
+   yaml_emitter_t *emitter;
+   yaml_event_t event;
 
 /* Check the global error status. */
    if ( !astOK ) return;
@@ -17326,22 +18032,44 @@ static void WriteObject( AstChannel *this_channel, const char *name,
    written. */
       if ( Use( this, set, helpful, status ) ) {
 
-/* Save information about the parent object. */
-         oldname = this->objectname;
-         oldset = this->objectset;
+/* If the Object is set, see if it has already been written out as
+   part of the current top-level Object (this is only checked if the
+   ShareObjects attribute is set). If so, write the key followed by a
+   YAML alias that refers to the anchor attached to the first
+   description of the Object. */
+         id = -1;
+         new = 1;
+         if( set ) id = astShareObject( this, value, &new );
+         if( !new ) {
+            emitter = this->emitter;
+            (void) sprintf( anchor, "ast%d", id );
+            yaml_scalar_event_initialize( &event, NULL,
+                                          (yaml_char_t *) YAML_STR_TAG,
+                                          (yaml_char_t *) name, strlen(name),
+                                          1, 0, YAML_PLAIN_SCALAR_STYLE );
+            EMIT
+            yaml_alias_event_initialize( &event, (yaml_char_t *) anchor );
+            EMIT
+
+/* Otherwise, save information about the parent object. */
+         } else {
+            oldname = this->objectname;
+            oldset = this->objectset;
 
 /* Store information describing the object to be written. The class item is
    filled in when astWriteBegin is called. */
-         this->objectname = ( name && strlen( name ) ) ? name : NULL;
-         this->objectset = set;
-         this->write_isa = 0;
+            this->objectname = ( name && strlen( name ) ) ? name : NULL;
+            this->objectset = set;
+            this->anchor_id = id;
+            this->write_isa = 0;
 
 /* Write the object to the YamlChan. */
-         (void) astDump( value, this );
+            (void) astDump( value, this );
 
 /* Re-instate the information about the parent object. */
-         this->objectname = oldname;
-         this->objectset = oldset;
+            this->objectname = oldname;
+            this->objectset = oldset;
+         }
 
 /* Since we have now written some output text describing the object
    class, we need to write out the netx "IsA" item to mark the end of the
@@ -17928,6 +18656,49 @@ astMAKE_TEST(YamlChan,YamlEncoding,( this->yamlencoding != UNKNOWN_ENCODING ))
 astMAKE_GET(YamlChan,YamlEncoding,int,0,(this->yamlencoding == UNKNOWN_ENCODING ?
                                 ASDF_ENCODING : this->yamlencoding))
 
+/*
+*att++
+*  Name:
+*     BlockThreshold
+
+*  Purpose:
+*     The minimum size of arrays written as ASDF binary blocks.
+
+*  Type:
+*     Public attribute.
+
+*  Synopsis:
+*     Integer.
+
+*  Description:
+*     This attribute is used when writing Objects using ASDF encoding (see
+*     attribute YamlEncoding). If it is greater than zero, any numerical
+*     array (such as the coefficients of a PolyMap or the table of a LutMap)
+*     that contains at least BlockThreshold elements is written as an
+*     ASDF binary block following the YAML tree, rather than being
+*     included as text within the tree. This makes the output smaller
+*     and faster to read. Binary blocks can only be written to a file
+*     specified by the SinkFile attribute. If no SinkFile is set, all
+*     arrays are written inline within the YAML tree.
+*
+*     The default value of zero causes all arrays to be written inline.
+*
+*     Note, arrays held in binary blocks are always read, regardless of
+*     the value of this attribute, but only if the YamlChan is reading
+*     from a file specified by the SourceFile attribute.
+
+*  Applicability:
+*     All yamlchans have this attribute.
+*att--
+*/
+
+/* This is a non-negative integer with a value of -INT_MAX when undefined
+   but yielding a default of zero. */
+astMAKE_CLEAR(YamlChan,BlockThreshold,blockthreshold,-INT_MAX)
+astMAKE_GET(YamlChan,BlockThreshold,int,0,( this->blockthreshold != -INT_MAX ? this->blockthreshold : 0 ))
+astMAKE_SET(YamlChan,BlockThreshold,int,blockthreshold,( value > 0 ? value : 0 ))
+astMAKE_TEST(YamlChan,BlockThreshold,( this->blockthreshold != -INT_MAX ))
+
 
 /* Copy constructor. */
 /* ----------------- */
@@ -18004,6 +18775,12 @@ static void Dump( AstObject *this_object, AstChannel *channel, int *status ) {
                 ival ? "Store ASDF 'name' as AST 'Ident'" :
                        "Store ASDF 'name' as AST 'Id'" );
 
+   set = TestBlockThreshold( this, status );
+   ival = set ? GetBlockThreshold( this, status ) : astGetBlockThreshold( this );
+   astWriteInt( channel, "BlockThreshold", set, 0, ival,
+                ival ? "Min. size of arrays written as binary blocks" :
+                       "Write all arrays inline" );
+
    set = TestYamlEncoding( this, status );
    ival = set ? GetYamlEncoding( this, status ) : astGetYamlEncoding( this );
    if( ival > UNKNOWN_ENCODING && ival <= MAX_ENCODING ) {
@@ -18640,10 +19417,17 @@ AstYamlChan *astInitYamlChan_( void *mem, size_t size, int init,
       new->verboseread = -INT_MAX;
       new->preservename = -INT_MAX;
       new->yamlencoding = UNKNOWN_ENCODING;
+      new->blockthreshold = -INT_MAX;
       new->anchors = NULL;
       new->gotwcs = 0;
       new->defenc = UNKNOWN_ENCODING;
       new->obj = NULL;
+      new->anchor_id = -1;
+      new->shared_km = NULL;
+      new->nshared_km = 0;
+      new->ref_index = -1;
+      new->blocks = NULL;
+      new->docend = 0;
 
 /* If an error occurred, clean up by deleting the new object. */
       if ( !astOK ) new = astDelete( new );
@@ -18786,6 +19570,9 @@ AstYamlChan *astLoadYamlChan_( void *mem, size_t size,
       new->preservename = astReadInt( channel, "preservename", -INT_MAX );
       if ( TestPreserveName( new, status ) ) SetPreserveName( new, new->preservename, status );
 
+      new->blockthreshold = astReadInt( channel, "blockthreshold", -INT_MAX );
+      if ( TestBlockThreshold( new, status ) ) SetBlockThreshold( new, new->blockthreshold, status );
+
       text = astReadString( channel, "yamlenc", UNKNOWN_STRING );
       if( strcmp( text, UNKNOWN_STRING ) ) {
          new->yamlencoding = FindString( MAX_ENCODING + 1, xencod, text,
@@ -18805,6 +19592,12 @@ AstYamlChan *astLoadYamlChan_( void *mem, size_t size,
       new->gotwcs = 0;
       new->defenc = UNKNOWN_ENCODING;
       new->obj = NULL;
+      new->anchor_id = -1;
+      new->shared_km = NULL;
+      new->nshared_km = 0;
+      new->ref_index = -1;
+      new->blocks = NULL;
+      new->docend = 0;
    }
 
 /* If an error occurred, clean up by deleting the new YamlChan. */
@@ -47,10 +47,13 @@
 
 *  Authors:
 *     DSB: D.S. Berry (EAO)
+*     AGT: Agent
 
 *  History:
 *     30-APR-2020 (DSB):
 *        Original version.
+*     18-OCT-2026 (AGT):
+*        Added the BlockThreshold attribute.
 *-
 */
 
@@ -101,6 +104,7 @@ typedef struct AstYamlChan {
    int preservename;      /* Store ASDF 'name' as Ident? */
    int verboseread;       /* Echo yaml text to stdout as it is read? */
    int yamlencoding;      /* Output format to use when writing */
+   int blockthreshold;    /* Min. ndarray size to write as a binary block */
    int defenc;            /* Default yaml encoding */
    AstKeyMap *anchors;    /* KeyMap holding transient YAML anchor definitions */
    int gotwcs;            /* Has a complete WCS been read yet? */
@@ -109,6 +113,12 @@ typedef struct AstYamlChan {
    int write_isa;         /* Is the next "isA" really needed? */
    AstKeyMap *obj;        /* KeyMap holding the NATIVE object being read */
    int index;             /* Index of next item to read from "obj" */
+   int anchor_id;         /* Index of shared Object being written */
+   AstKeyMap *shared_km;  /* Indices of anchored Objects read so far */
+   int nshared_km;        /* Number of Objects read so far */
+   int ref_index;         /* Index of shared Object to return next */
+   AstKeyMap *blocks;     /* ASDF binary blocks being read or written */
+   int docend;            /* Has the YAML document-end marker been read? */
 
 #if defined( YAML )
    yaml_emitter_t emitter_data; /* The body of a yaml emitter */
@@ -146,6 +156,11 @@ typedef struct AstYamlChanVtab {
    void (* ClearYamlEncoding)( AstYamlChan *, int * );
    void (* SetYamlEncoding)( AstYamlChan *, int, int * );
 
+   int (* GetBlockThreshold)( AstYamlChan *, int * );
+   int (* TestBlockThreshold)( AstYamlChan *, int * );
+   void (* ClearBlockThreshold)( AstYamlChan *, int * );
+   void (* SetBlockThreshold)( AstYamlChan *, int, int * );
+
 } AstYamlChanVtab;
 
 #if defined(THREAD_SAFE)
@@ -229,6 +244,11 @@ int astTestYamlEncoding_( AstYamlChan *, int * );
 void astClearYamlEncoding_( AstYamlChan *, int * );
 void astSetYamlEncoding_( AstYamlChan *, int, int * );
 
+int astGetBlockThreshold_( AstYamlChan *, int * );
+int astTestBlockThreshold_( AstYamlChan *, int * );
+void astClearBlockThreshold_( AstYamlChan *, int * );
+void astSetBlockThreshold_( AstYamlChan *, int, int * );
+
 #endif
 
 /* Function interfaces. */
@@ -303,6 +323,15 @@ astINVOKE(V,astTestPreserveName_(astCheckYamlChan(this),STATUS_PTR))
 #define astSetYamlEncoding(this,yamlencoding) astINVOKE(V,astSetYamlEncoding_(astCheckYamlChan(this),yamlencoding,STATUS_PTR))
 #define astTestYamlEncoding(this) astINVOKE(V,astTestYamlEncoding_(astCheckYamlChan(this),STATUS_PTR))
 
+#define astClearBlockThreshold(this) \
+astINVOKE(V,astClearBlockThreshold_(astCheckYamlChan(this),STATUS_PTR))
+#define astGetBlockThreshold(this) \
+astINVOKE(V,astGetBlockThreshold_(astCheckYamlChan(this),STATUS_PTR))
+#define astSetBlockThreshold(this,value) \
+astINVOKE(V,astSetBlockThreshold_(astCheckYamlChan(this),value,STATUS_PTR))
+#define astTestBlockThreshold(this) \
+astINVOKE(V,astTestBlockThreshold_(astCheckYamlChan(this),STATUS_PTR))
+
 #endif
 #endif
 